@@ -0,0 +1,109 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// FFI call benchmark: the cost of one native call through a generated
+// per-signature stub, from C++ and from script.
+//
+// The stub case calls libm's cos straight through FFICallDispatcher::invoke,
+// which is the marshaling plus stub overhead with no interpreter in between.
+// The script cases bind functions with FFI.open(...).func(...) and call them
+// in a loop, one of them passing a Uint8Array by pointer. Each case reports
+// nanoseconds per call and a checked result.
+//
+// Usage: bench_ffi [calls]
+
+#include "core/include/Engine.h"
+#include "core/include/NativeFFI.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace Quanta;
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+const char* LIBM = "libm.so.6";
+const char* LIBC = "libc.so.6";
+
+void report(const char* name, size_t calls, double seconds, bool correct) {
+    std::printf("%-14s %12zu %12.3f ms %10.1f ns %8s\n", name, calls,
+                seconds * 1e3, seconds * 1e9 / calls, correct ? "ok" : "WRONG");
+}
+
+void run_stub(size_t calls) {
+    NativeLibrary libm(LIBM);
+    void* target = libm.load() ? libm.get_symbol("cos") : nullptr;
+
+    FFISignature signature;
+    signature.name = "cos";
+    signature.return_type = FFITypeInfo(FFIType::DOUBLE);
+    signature.parameter_types.emplace_back(FFIType::DOUBLE);
+    std::shared_ptr<const FFICallStub> stub = FFICallDispatcher::get_instance().get_stub(signature);
+    if (!target || !stub) {
+        std::printf("%-14s unavailable on this platform\n", "stub-cos");
+        return;
+    }
+
+    Value argument(0.0);
+    double sum = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < calls; ++i) {
+        sum += FFICallDispatcher::invoke(*stub, target, &argument, 1).to_number();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    report("stub-cos", calls, seconds, sum == static_cast<double>(calls));
+}
+
+void run_script(const char* name, const std::string& setup, const std::string& body,
+                size_t calls, double expected) {
+    Engine engine;
+    engine.enable_ffi(true);
+    engine.initialize();
+
+    Engine::Result r = engine.execute(setup, "<setup>");
+    if (!r.success) {
+        std::printf("%-14s setup failed: %s\n", name, r.error_message.c_str());
+        return;
+    }
+
+    auto start = Clock::now();
+    r = engine.execute(body, "<bench>");
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // execute() does not report a program's completion value
+    if (r.success) r = engine.evaluate("result");
+    report(name, calls, seconds, r.success && r.value.to_number() == expected);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    size_t calls = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::string n = std::to_string(calls);
+
+    std::printf("%-14s %12s %15s %13s %8s\n", "case", "calls", "time", "per call", "result");
+
+    run_stub(calls);
+
+    run_script("script-cos",
+               "var cos = FFI.open(\"" + std::string(LIBM) + "\").func(\"cos\", \"double\", [\"double\"]);",
+               "var result = 0;\n"
+               "for (var i = 0; i < " + n + "; i++) { result += cos(0); }",
+               calls, static_cast<double>(calls));
+
+    run_script("script-memset",
+               "var memset = FFI.open(\"" + std::string(LIBC) + "\").func(\"memset\", \"pointer\", [\"buffer\", \"int32\", \"uint64\"]);\n"
+               "var bytes = new Uint8Array(64);",
+               "for (var i = 0; i < " + n + "; i++) { memset(bytes, i & 255, 64); }\n"
+               "var result = bytes[63];",
+               calls, static_cast<double>((calls - 1) & 255));
+
+    return 0;
+}
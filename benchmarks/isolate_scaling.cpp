@@ -0,0 +1,97 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// Isolate pool scaling benchmark: script throughput vs. number of isolates.
+//
+// The same batch of small scripts is pushed through pools of 1, 2, 4, ...
+// isolates (up to the hardware thread count). With no shared mutable state
+// between engines, throughput should grow linearly until cores run out.
+//
+// Usage: bench_isolates [tasks] [max_isolates] [spread]
+
+#include "core/include/IsolatePool.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Quanta;
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+const char* TASK_SCRIPT = R"JS(
+function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }
+let items = [];
+for (let i = 0; i < 200; i++) items.push({ id: i, name: "item" + i, score: (i * 37) % 101 });
+let best = 0;
+for (let i = 0; i < items.length; i++) if (items[i].score > best) best = items[i].score;
+let m = new Map();
+for (let i = 0; i < 100; i++) m.set("k" + i, i);
+var result = fib(15) + best + m.size;
+)JS";
+
+struct Run {
+    double seconds;
+    size_t failures;
+};
+
+Run run_pool(size_t isolates, size_t tasks, bool spread) {
+    IsolatePool::Config config;
+    config.isolates = isolates;
+    config.spread_across_nodes = spread;
+    IsolatePool pool(config);
+
+    // execute() does not report a program's completion value, so each task reads it back
+    std::atomic<size_t> failures(0);
+    auto start = Clock::now();
+    for (size_t i = 0; i < tasks; ++i) {
+        pool.submit([&failures](Engine& engine) {
+            Engine::Result r = engine.execute(TASK_SCRIPT, "<task>");
+            if (r.success) r = engine.evaluate("result");
+            if (!r.success || r.value.to_number() != 810) {
+                failures.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    pool.wait_idle();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return {seconds, failures.load()};
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    size_t tasks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+    size_t hardware = std::thread::hardware_concurrency();
+    size_t max_isolates = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : (hardware ? hardware : 1);
+    bool spread = argc > 3 && std::atoi(argv[3]) != 0;
+
+    std::printf("tasks: %zu, hardware threads: %zu, NUMA spread: %s\n", tasks, hardware, spread ? "on" : "off");
+    std::printf("%-10s %12s %14s %10s %9s\n", "isolates", "seconds", "tasks/s", "speedup", "failures");
+
+    // Powers of two below max_isolates, then max_isolates itself
+    if (max_isolates == 0) max_isolates = 1;
+    std::vector<size_t> counts;
+    for (size_t isolates = 1; isolates < max_isolates; isolates *= 2) {
+        counts.push_back(isolates);
+    }
+    counts.push_back(max_isolates);
+
+    double baseline = 0;
+    for (size_t isolates : counts) {
+        Run run = run_pool(isolates, tasks, spread);
+        double throughput = tasks / run.seconds;
+        if (isolates == 1) baseline = throughput;
+        std::printf("%-10zu %12.3f %14.1f %9.2fx %9zu\n", isolates, run.seconds, throughput,
+                    throughput / baseline, run.failures);
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// NUMA placement benchmark: node-local vs. interleaved (vs. remote) heap arenas.
+//
+// The thread is pinned to one node, then for each placement it
+//   1. allocates a randomly linked list of object-sized cells from the arena,
+//   2. chases the list (latency-bound, like tracing a fragmented heap),
+//   3. runs a small object-heavy script on an engine bound to that arena.
+// On a single-node machine all placements degenerate to the same memory.
+//
+// Usage: bench_numa [cells] [node]
+
+#include "core/include/Engine.h"
+#include "core/include/HeapArena.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Quanta;
+
+namespace {
+
+struct Cell {
+    Cell* next;
+    uint64_t payload[13];   // 112 bytes, close to a small Object
+};
+
+using Clock = std::chrono::high_resolution_clock;
+
+double elapsed_ns(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+const char* SCRIPT = R"JS(
+let total = 0;
+for (let round = 0; round < 20; round++) {
+    let list = [];
+    for (let i = 0; i < 5000; i++) list.push({ id: i, value: i * 2, tag: { round: round } });
+    for (let i = 0; i < list.length; i++) total += list[i].value + list[i].tag.round;
+}
+total;
+)JS";
+
+struct Result {
+    double alloc_ns_per_cell;
+    double chase_ns_per_hop;
+    double script_ms;
+};
+
+Result run_placement(HeapArena& arena, size_t cells) {
+    Result result{};
+    HeapArena::bind_current_thread(&arena);
+
+    std::vector<Cell*> nodes(cells);
+    auto start = Clock::now();
+    for (size_t i = 0; i < cells; ++i) {
+        nodes[i] = static_cast<Cell*>(HeapArena::allocate(sizeof(Cell)));
+        nodes[i]->payload[0] = i;
+    }
+    result.alloc_ns_per_cell = elapsed_ns(start) / cells;
+
+    // Random cycle so every hop is a cache miss
+    std::vector<size_t> order(cells);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(42));
+    for (size_t i = 0; i < cells; ++i) {
+        nodes[order[i]]->next = nodes[order[(i + 1) % cells]];
+    }
+
+    Cell* cursor = nodes[order[0]];
+    uint64_t checksum = 0;
+    const size_t hops = cells * 4;
+    start = Clock::now();
+    for (size_t i = 0; i < hops; ++i) {
+        checksum += cursor->payload[0];
+        cursor = cursor->next;
+    }
+    result.chase_ns_per_hop = elapsed_ns(start) / hops;
+    if (checksum == 1) std::printf(" ");   // keep the loop
+
+    for (Cell* cell : nodes) {
+        HeapArena::deallocate(cell, sizeof(Cell));
+    }
+
+    {
+        Engine engine;
+        engine.initialize();
+        start = Clock::now();
+        engine.execute(SCRIPT);
+        result.script_ms = elapsed_ns(start) / 1e6;
+    }
+
+    HeapArena::bind_current_thread(nullptr);
+    return result;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    size_t cells = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4 * 1024 * 1024;
+    uint32_t nodes = HeapArena::node_count();
+    uint32_t home = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : HeapArena::current_node();
+
+    bool pinned = HeapArena::pin_current_thread(home);
+    std::printf("NUMA nodes: %u, home node: %u (%s)\n", nodes, home, pinned ? "pinned" : "not pinned");
+    std::printf("%-12s %14s %14s %12s\n", "placement", "alloc ns/cell", "chase ns/hop", "script ms");
+
+    auto report = [](const char* name, const Result& r) {
+        std::printf("%-12s %14.2f %14.2f %12.2f\n", name, r.alloc_ns_per_cell, r.chase_ns_per_hop, r.script_ms);
+    };
+
+    report("local", run_placement(HeapArena::for_node(home), cells));
+    report("interleaved", run_placement(HeapArena::interleaved(), cells));
+    if (nodes > 1) {
+        report("remote", run_placement(HeapArena::for_node((home + 1) % nodes), cells));
+    }
+
+    std::vector<size_t> reserved = HeapArena::node_reserved_bytes();
+    for (size_t node = 0; node < reserved.size(); ++node) {
+        std::printf("node %zu reserved: %zu bytes\n", node, reserved[node]);
+    }
+    return 0;
+}
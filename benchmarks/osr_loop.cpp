@@ -0,0 +1,87 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// On-stack replacement benchmark: one long loop at script top level.
+//
+// Top-level code is never called, so function-entry tier-up cannot help it;
+// only OSR moves the loop out of the interpreter. The loop runs once with the
+// JIT enabled and once in the interpreter alone (over fewer iterations: the
+// interpreter is slow), and the time per iteration is compared.
+//
+// Usage: bench_osr [iterations] [interpreter_iterations]
+
+#include "core/include/Engine.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace Quanta;
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+std::string make_script(uint64_t iterations) {
+    return "let sum = 0;\n"
+           "for (let i = 0; i < " + std::to_string(iterations) + "; i++) {\n"
+           "    sum += i % 7;\n"
+           "}\n"
+           "var result = sum;\n";
+}
+
+// Matches the script's loop
+double expected_sum(uint64_t iterations) {
+    double sum = 0;
+    for (uint64_t i = 0; i < iterations; ++i) sum += static_cast<double>(i % 7);
+    return sum;
+}
+
+struct Run {
+    double seconds;
+    bool correct;
+    std::string stats;
+};
+
+Run run_loop(uint64_t iterations, bool jit) {
+    Engine engine;
+    engine.initialize();
+    engine.enable_jit(jit);
+
+    auto start = Clock::now();
+    Engine::Result r = engine.execute(make_script(iterations), "<osr>");
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // execute() does not report a program's completion value
+    if (r.success) r = engine.evaluate("result");
+    bool correct = r.success && r.value.to_number() == expected_sum(iterations);
+    return {seconds, correct, engine.get_jit_stats()};
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+    uint64_t interpreter_iterations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000000;
+
+    std::printf("%-12s %14s %12s %14s %8s\n", "mode", "iterations", "seconds", "ns/iteration", "result");
+
+    auto report = [](const char* mode, uint64_t n, const Run& run) {
+        std::printf("%-12s %14llu %12.3f %14.2f %8s\n", mode, static_cast<unsigned long long>(n),
+                    run.seconds, run.seconds * 1e9 / n, run.correct ? "ok" : "WRONG");
+    };
+
+    Run interpreted = run_loop(interpreter_iterations, false);
+    report("interpreter", interpreter_iterations, interpreted);
+
+    Run osr = run_loop(iterations, true);
+    report("osr", iterations, osr);
+
+    std::printf("speedup per iteration: %.1fx\n",
+                (interpreted.seconds / interpreter_iterations) / (osr.seconds / iterations));
+    std::printf("%s\n", osr.stats.c_str());
+    return interpreted.correct && osr.correct ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// String builtins benchmark: split on a CSV text and replaceAll on a large
+// text, both through String.prototype from script.
+//
+// The input is built in the engine before timing starts, so only the builtin
+// is measured. Each case reports its time, throughput and a checked result.
+//
+// Usage: bench_strings [csv_megabytes] [text_megabytes]
+
+#include "core/include/Engine.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace Quanta;
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+// 64 bytes per row, 8 fields
+const char* CSV_ROW = "1024,alpha,beta,3.14159,gamma,delta,2024-01-01,epsilon-zeta-eta\\n";
+const size_t CSV_ROW_BYTES = 64;
+const size_t CSV_ROW_FIELDS = 8;
+
+// 64 bytes per sentence, two matches of "fox"
+const char* TEXT_SENTENCE = "The quick brown fox jumps over the lazy dog; the fox sleeps.    ";
+const size_t TEXT_SENTENCE_BYTES = 64;
+const size_t TEXT_SENTENCE_MATCHES = 2;
+
+struct Case {
+    const char* name;
+    std::string setup;      // builds the input, untimed
+    std::string body;       // timed; leaves its checked result in `result`
+    double expected;
+    size_t bytes;
+};
+
+void run(const Case& c) {
+    Engine engine;
+    engine.initialize();
+
+    Engine::Result r = engine.execute(c.setup, "<setup>");
+    if (!r.success) {
+        std::printf("%-12s setup failed: %s\n", c.name, r.error_message.c_str());
+        return;
+    }
+
+    auto start = Clock::now();
+    r = engine.execute(c.body, "<bench>");
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // execute() does not report a program's completion value
+    if (r.success) r = engine.evaluate("result");
+    bool correct = r.success && r.value.to_number() == c.expected;
+    std::printf("%-12s %10.2f MB %10.3f ms %10.1f MB/s %8s\n", c.name, c.bytes / 1048576.0,
+                seconds * 1e3, c.bytes / 1048576.0 / seconds, correct ? "ok" : "WRONG");
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    size_t csv_mb = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1;
+    size_t text_mb = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10;
+
+    size_t rows = csv_mb * 1048576 / CSV_ROW_BYTES;
+    size_t sentences = text_mb * 1048576 / TEXT_SENTENCE_BYTES;
+
+    std::printf("%-12s %13s %13s %15s %8s\n", "case", "input", "time", "throughput", "result");
+
+    run({"split-rows",
+         "var csv = \"" + std::string(CSV_ROW) + "\".repeat(" + std::to_string(rows) + ");",
+         "var result = csv.split(\"\\n\").length;",
+         static_cast<double>(rows + 1), rows * CSV_ROW_BYTES});
+
+    run({"split-fields",
+         "var csv = \"" + std::string(CSV_ROW) + "\".repeat(" + std::to_string(rows) + ");",
+         "var result = csv.split(\",\").length;",
+         static_cast<double>(rows * (CSV_ROW_FIELDS - 1) + 1), rows * CSV_ROW_BYTES});
+
+    run({"replaceAll",
+         "var text = \"" + std::string(TEXT_SENTENCE) + "\".repeat(" + std::to_string(sentences) + ");",
+         "var replaced = text.replaceAll(\"fox\", \"wolf\");\n"
+         "var result = replaced.length - text.length;",
+         static_cast<double>(sentences * TEXT_SENTENCE_MATCHES), sentences * TEXT_SENTENCE_BYTES});
+
+    run({"indexOf",
+         "var text = \"" + std::string(TEXT_SENTENCE) + "\".repeat(" + std::to_string(sentences) + ") + \"needle\";",
+         "var result = text.indexOf(\"needle\");",
+         static_cast<double>(sentences * TEXT_SENTENCE_BYTES), sentences * TEXT_SENTENCE_BYTES});
+
+    return 0;
+}
@@ -0,0 +1,324 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// Benchmark suite: a fixed corpus of script workloads, run in process, with
+// the results written as JSON so runs can be compared against each other.
+//
+// Each workload in benchmarks/suite defines run(), which does one unit of
+// work and returns a checksum. Work finished by promise jobs is only done
+// once the job queue drains after the script, so such a workload returns an
+// object and its checksum is read from that object's total. A workload gets a fresh engine; it is loaded,
+// warmed up, then run() is timed over a number of iterations. Each workload
+// runs in a forked child, so its peak RSS is its own and not the high-water
+// mark of the workloads before it. The report has ops/sec, the p50 and p99
+// iteration times and that peak RSS, plus whether every checksum matched.
+//
+// With --baseline the ops/sec of each workload is compared against an earlier
+// report and any workload slower by more than --threshold percent is flagged.
+// The exit status is non-zero on a regression or a wrong checksum.
+//
+// Usage: bench_suite [--dir path] [--iterations n] [--warmup n] [--only name]
+//                    [--baseline report.json] [--threshold percent]
+
+#include "core/include/Engine.h"
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Quanta;
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+struct Workload {
+    const char* name;
+    double expected;        // run()'s checksum
+};
+
+const Workload WORKLOADS[] = {
+    {"richards", 23220928},
+    {"deltablue", 5810},
+    {"navier_stokes", 54448},
+    {"splay", 2000400},
+    {"raytrace", 233212},
+    {"json", 1659450},
+    {"strings", 93192},
+    {"mapset", 4513725},
+    {"closures", 6684334},
+    {"promises", 45150},
+    {"binary_records", 23607520},
+    {"protobuf", 233160750},
+    {"symbol_keys", 2022841},
+};
+
+struct Options {
+    std::string dir = "benchmarks/suite";
+    size_t iterations = 10;
+    size_t warmup = 2;
+    std::string only;
+    std::string baseline;
+    double threshold = 5.0;
+};
+
+struct Report {
+    std::string name;
+    bool loaded = false;
+    bool correct = false;
+    std::string error;
+    size_t iterations = 0;
+    double ops_per_sec = 0;
+    double p50_ms = 0;
+    double p99_ms = 0;
+    long peak_rss_kb = 0;
+};
+
+bool read_file(const std::string& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::ostringstream text;
+    text << in.rdbuf();
+    out = text.str();
+    return true;
+}
+
+// Nearest-rank percentile of sorted samples
+double percentile(const std::vector<double>& sorted, double p) {
+    size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.999999);
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+Report run(const Workload& w, const Options& options) {
+    Report report;
+    report.name = w.name;
+
+    std::string path = options.dir + "/" + w.name + ".js";
+    std::string source;
+    if (!read_file(path, source)) {
+        report.error = "cannot read " + path;
+        return report;
+    }
+
+    Engine engine;
+    engine.initialize();
+    Engine::Result r = engine.execute(source, path);
+    if (!r.success) {
+        report.error = r.error_message;
+        return report;
+    }
+    report.loaded = true;
+
+    const std::string body = "var result = run();";
+    report.correct = true;
+    auto check = [&]() {
+        // execute() does not report a program's completion value
+        Engine::Result value = engine.evaluate("result");
+        Value checksum = value.value;
+        if (checksum.is_object()) checksum = checksum.as_object()->get_property("total");
+        if (!value.success || checksum.to_number() != w.expected) report.correct = false;
+    };
+
+    for (size_t i = 0; i < options.warmup; ++i) {
+        r = engine.execute(body, "<warmup>");
+        if (!r.success) break;
+    }
+
+    std::vector<double> samples;
+    samples.reserve(options.iterations);
+    for (size_t i = 0; r.success && i < options.iterations; ++i) {
+        auto start = Clock::now();
+        r = engine.execute(body, "<bench>");
+        samples.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+        if (r.success) check();
+    }
+    if (!r.success) {
+        report.correct = false;
+        report.error = r.error_message;
+    }
+    if (samples.empty()) return report;
+
+    double total = 0;
+    for (double s : samples) total += s;
+    std::sort(samples.begin(), samples.end());
+    report.iterations = samples.size();
+    report.ops_per_sec = samples.size() / total;
+    report.p50_ms = percentile(samples, 50) * 1e3;
+    report.p99_ms = percentile(samples, 99) * 1e3;
+    return report;
+}
+
+// Runs one workload in a child process. The child sends its report back
+// over a pipe; the peak RSS comes from the child's own resource usage
+Report run_isolated(const Workload& w, const Options& options) {
+    Report report;
+    report.name = w.name;
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        report.error = "cannot create pipe";
+        return report;
+    }
+    std::fflush(nullptr);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        report.error = "cannot fork";
+        return report;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        Report r = run(w, options);
+        FILE* out = fdopen(fds[1], "w");
+        std::fprintf(out, "%d %d %zu %.17g %.17g %.17g\n%s", r.loaded, r.correct, r.iterations,
+                     r.ops_per_sec, r.p50_ms, r.p99_ms, r.error.c_str());
+        std::fclose(out);
+        _exit(0);
+    }
+
+    close(fds[1]);
+    std::string text;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = read(fds[0], buffer, sizeof(buffer))) > 0) text.append(buffer, static_cast<size_t>(n));
+    close(fds[0]);
+
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) == pid) report.peak_rss_kb = usage.ru_maxrss;
+
+    int loaded = 0, correct = 0;
+    size_t newline = text.find('\n');
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || newline == std::string::npos ||
+        std::sscanf(text.c_str(), "%d %d %zu %lg %lg %lg", &loaded, &correct, &report.iterations,
+                    &report.ops_per_sec, &report.p50_ms, &report.p99_ms) != 6) {
+        report.error = "workload process exited abnormally";
+        return report;
+    }
+    report.loaded = loaded != 0;
+    report.correct = correct != 0;
+    report.error = text.substr(newline + 1);
+    return report;
+}
+
+// Just enough of a reader for our own report format: each workload object
+// has "name" before "ops_per_sec"
+std::map<std::string, double> read_baseline(const std::string& text) {
+    std::map<std::string, double> baseline;
+    size_t pos = 0;
+    while ((pos = text.find("\"name\"", pos)) != std::string::npos) {
+        size_t open = text.find('"', text.find(':', pos) + 1);
+        size_t close = text.find('"', open + 1);
+        size_t ops = text.find("\"ops_per_sec\"", close);
+        if (open == std::string::npos || close == std::string::npos || ops == std::string::npos) break;
+        size_t value = text.find(':', ops) + 1;
+        baseline[text.substr(open + 1, close - open - 1)] = std::strtod(text.c_str() + value, nullptr);
+        pos = close;
+    }
+    return baseline;
+}
+
+std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+            continue;
+        }
+        out += c;
+    }
+    return out;
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) return false;
+        if (std::strcmp(arg, "--dir") == 0) options.dir = value;
+        else if (std::strcmp(arg, "--iterations") == 0) options.iterations = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(arg, "--warmup") == 0) options.warmup = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(arg, "--only") == 0) options.only = value;
+        else if (std::strcmp(arg, "--baseline") == 0) options.baseline = value;
+        else if (std::strcmp(arg, "--threshold") == 0) options.threshold = std::strtod(value, nullptr);
+        else return false;
+        ++i;
+    }
+    return options.iterations > 0;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        std::fprintf(stderr, "usage: %s [--dir path] [--iterations n] [--warmup n] [--only name] "
+                             "[--baseline report.json] [--threshold percent]\n", argv[0]);
+        return 2;
+    }
+
+    std::map<std::string, double> baseline;
+    if (!options.baseline.empty()) {
+        std::string text;
+        if (!read_file(options.baseline, text)) {
+            std::fprintf(stderr, "cannot read baseline %s\n", options.baseline.c_str());
+            return 2;
+        }
+        baseline = read_baseline(text);
+    }
+
+    std::vector<Report> reports;
+    for (const Workload& w : WORKLOADS) {
+        if (!options.only.empty() && options.only != w.name) continue;
+        reports.push_back(run_isolated(w, options));
+        const Report& r = reports.back();
+        // Progress goes to stderr so stdout stays a clean JSON document
+        std::fprintf(stderr, "%-14s %10.2f ops/s %10.3f ms p50 %10.3f ms p99 %8s\n", r.name.c_str(),
+                     r.ops_per_sec, r.p50_ms, r.p99_ms, r.correct ? "ok" : "WRONG");
+    }
+
+    bool failed = false;
+    long peak_rss_kb = 0;
+    std::printf("{\n  \"iterations\": %zu,\n  \"warmup\": %zu,\n", options.iterations, options.warmup);
+    if (!options.baseline.empty()) std::printf("  \"threshold_percent\": %g,\n", options.threshold);
+    std::printf("  \"workloads\": [\n");
+    for (size_t i = 0; i < reports.size(); ++i) {
+        const Report& r = reports[i];
+        std::printf("    {\"name\": \"%s\", \"ok\": %s, \"iterations\": %zu, \"ops_per_sec\": %.4f, "
+                    "\"p50_ms\": %.4f, \"p99_ms\": %.4f, \"peak_rss_kb\": %ld",
+                    r.name.c_str(), r.correct ? "true" : "false", r.iterations, r.ops_per_sec,
+                    r.p50_ms, r.p99_ms, r.peak_rss_kb);
+        if (!r.error.empty()) std::printf(", \"error\": \"%s\"", json_escape(r.error).c_str());
+        failed |= !r.correct;
+        peak_rss_kb = std::max(peak_rss_kb, r.peak_rss_kb);
+
+        auto base = baseline.find(r.name);
+        if (base != baseline.end() && base->second > 0) {
+            double change = (r.ops_per_sec / base->second - 1.0) * 100.0;
+            bool regressed = change < -options.threshold;
+            std::printf(", \"baseline_ops_per_sec\": %.4f, \"change_percent\": %.2f, \"regression\": %s",
+                        base->second, change, regressed ? "true" : "false");
+            if (regressed) {
+                std::fprintf(stderr, "REGRESSION %s: %.2f%% slower than baseline\n", r.name.c_str(), -change);
+                failed = true;
+            }
+        }
+        std::printf("}%s\n", i + 1 < reports.size() ? "," : "");
+    }
+    std::printf("  ],\n  \"peak_rss_kb\": %ld\n}\n", peak_rss_kb);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,43 @@
+// Binary records: fixed-size little/big-endian records written and decoded
+// through DataView, once field by field with the typed getters and once
+// with a compiled layout read in a single call per record.
+
+var RECORD_SIZE = 19;
+var COUNT = 500;
+
+function encode(view) {
+    for (var i = 0; i < COUNT; i++) {
+        var at = i * RECORD_SIZE;
+        view.setUint32(at, i * 7 + 1, true);
+        view.setFloat64(at + 4, i * 0.5, true);
+        view.setFloat32(at + 12, i * 0.25, true);
+        view.setUint8(at + 16, i % 251);
+        view.setInt16(at + 17, (i % 300) - 150);
+    }
+}
+
+function run() {
+    var view = new DataView(new ArrayBuffer(RECORD_SIZE * COUNT));
+    encode(view);
+    // The little-endian head of each record; the big-endian count after it
+    // is left to the getters
+    var layout = DataView.compileLayout([
+        ["id", "uint32"], ["x", "float64"], ["y", "float32"], ["kind", "uint8"]
+    ], true);
+
+    var checksum = 0;
+    for (var round = 0; round < 10; round++) {
+        for (var i = 0; i < COUNT; i++) {
+            var at = i * RECORD_SIZE;
+            checksum += view.getUint32(at, true) + view.getFloat64(at + 4, true) * 2 +
+                        view.getFloat32(at + 12, true) * 4 + view.getUint8(at + 16) +
+                        view.getInt16(at + 17);
+        }
+        var record = {};
+        for (var j = 0; j < COUNT; j++) {
+            view.readLayout(j * RECORD_SIZE, layout, record);
+            checksum += record.id + record.x * 2 + record.y * 4 + record.kind;
+        }
+    }
+    return checksum;
+}
@@ -0,0 +1,39 @@
+// Closures: higher order functions, callbacks and captured state: array
+// map/filter/reduce chains, counters and a pipeline of small functions.
+
+function makeCounter() {
+    var count = 0;
+    return function (step) {
+        count += step;
+        return count;
+    };
+}
+
+function run() {
+    var data = [];
+    for (var i = 0; i < 2000; i++) data.push(i);
+
+    var checksum = 0;
+    for (var round = 0; round < 5; round++) {
+        var offset = round;
+        var mapped = data.map(function (x) { return x * 2 + offset; });
+        var filtered = mapped.filter(function (x) { return x % 3 == 0; });
+        checksum += filtered.reduce(function (acc, x) { return acc + x; }, 0);
+    }
+
+    var counter = makeCounter();
+    for (var j = 0; j < 2000; j++) counter(j % 4);
+    checksum += counter(0);
+
+    var pipeline = [
+        function (x) { return x + 1; },
+        function (x) { return x * 2; },
+        function (x) { return x + 1; }
+    ];
+    for (var k = 0; k < 2000; k++) {
+        var value = k;
+        for (var p = 0; p < pipeline.length; p++) value = pipeline[p](value);
+        checksum += value % 10;
+    }
+    return checksum;
+}
@@ -0,0 +1,358 @@
+// DeltaBlue: incremental dataflow constraint solver (after the Smalltalk
+// original by Maloney and Freeman-Benson, as in the V8 and Octane suites).
+// Constraint subclasses are folded into one constructor with a kind field;
+// the planner is the original. Runs the chain and projection tests.
+
+var REQUIRED = 0;
+var STRONG_PREFERRED = 1;
+var PREFERRED = 2;
+var STRONG_DEFAULT = 3;
+var NORMAL = 4;
+var WEAK_DEFAULT = 5;
+var WEAKEST = 6;
+
+var NONE = 1;
+var FORWARD = 2;
+var BACKWARD = 0;
+
+var STAY = 0;
+var EDIT = 1;
+var EQUALITY = 2;
+var SCALE = 3;
+
+function stronger(s1, s2) { return s1 < s2; }
+function weaker(s1, s2) { return s1 > s2; }
+function weakestOf(s1, s2) { return weaker(s1, s2) ? s1 : s2; }
+function nextWeaker(s) { return s == REQUIRED ? WEAKEST : s == WEAKEST ? WEAKEST : 6 - s; }
+
+function Variable(name, value) {
+    this.value = value;
+    this.constraints = [];
+    this.determinedBy = null;
+    this.mark = 0;
+    this.walkStrength = WEAKEST;
+    this.stay = true;
+    this.name = name;
+}
+
+Variable.prototype.removeConstraint = function (c) {
+    var kept = [];
+    for (var i = 0; i < this.constraints.length; i++) {
+        if (this.constraints[i] !== c) kept.push(this.constraints[i]);
+    }
+    this.constraints = kept;
+    if (this.determinedBy === c) this.determinedBy = null;
+};
+
+function Constraint(kind, strength, v1, v2, scale, offset) {
+    this.kind = kind;
+    this.strength = strength;
+    this.v1 = v1;            // the output for unary constraints
+    this.v2 = v2;
+    this.scale = scale;
+    this.offset = offset;
+    this.direction = NONE;   // binary constraints
+    this.satisfied = false;  // unary constraints
+}
+
+Constraint.prototype.isUnary = function () { return this.kind == STAY || this.kind == EDIT; };
+Constraint.prototype.isInput = function () { return this.kind == EDIT; };
+
+Constraint.prototype.addToGraph = function () {
+    this.v1.constraints.push(this);
+    if (!this.isUnary()) this.v2.constraints.push(this);
+    if (this.kind == SCALE) {
+        this.scale.constraints.push(this);
+        this.offset.constraints.push(this);
+    }
+    this.satisfied = false;
+    this.direction = NONE;
+};
+
+Constraint.prototype.removeFromGraph = function () {
+    if (this.v1 != null) this.v1.removeConstraint(this);
+    if (!this.isUnary() && this.v2 != null) this.v2.removeConstraint(this);
+    if (this.kind == SCALE) {
+        this.scale.removeConstraint(this);
+        this.offset.removeConstraint(this);
+    }
+    this.satisfied = false;
+    this.direction = NONE;
+};
+
+Constraint.prototype.isSatisfied = function () {
+    return this.isUnary() ? this.satisfied : this.direction != NONE;
+};
+
+Constraint.prototype.chooseMethod = function (mark) {
+    if (this.isUnary()) {
+        this.satisfied = this.v1.mark != mark && stronger(this.strength, this.v1.walkStrength);
+        return;
+    }
+    if (this.v1.mark == mark) {
+        this.direction = this.v2.mark != mark && stronger(this.strength, this.v2.walkStrength) ? FORWARD : NONE;
+    }
+    if (this.v2.mark == mark) {
+        this.direction = this.v1.mark != mark && stronger(this.strength, this.v1.walkStrength) ? BACKWARD : NONE;
+    }
+    if (weaker(this.v1.walkStrength, this.v2.walkStrength)) {
+        this.direction = stronger(this.strength, this.v1.walkStrength) ? BACKWARD : NONE;
+    } else {
+        this.direction = stronger(this.strength, this.v2.walkStrength) ? FORWARD : BACKWARD;
+    }
+};
+
+Constraint.prototype.output = function () {
+    if (this.isUnary()) return this.v1;
+    return this.direction == FORWARD ? this.v2 : this.v1;
+};
+
+Constraint.prototype.input = function () {
+    return this.direction == FORWARD ? this.v1 : this.v2;
+};
+
+Constraint.prototype.markInputs = function (mark) {
+    if (!this.isUnary()) this.input().mark = mark;
+    if (this.kind == SCALE) this.scale.mark = this.offset.mark = mark;
+};
+
+Constraint.prototype.markUnsatisfied = function () {
+    if (this.isUnary()) this.satisfied = false;
+    else this.direction = NONE;
+};
+
+Constraint.prototype.inputsKnown = function (mark) {
+    if (this.isUnary()) return true;
+    var i = this.input();
+    return i.mark == mark || i.stay || i.determinedBy == null;
+};
+
+Constraint.prototype.execute = function () {
+    if (this.kind == EQUALITY) {
+        this.output().value = this.input().value;
+    } else if (this.kind == SCALE) {
+        if (this.direction == FORWARD) {
+            this.v2.value = this.v1.value * this.scale.value + this.offset.value;
+        } else {
+            this.v1.value = (this.v2.value - this.offset.value) / this.scale.value;
+        }
+    }
+};
+
+Constraint.prototype.recalculate = function () {
+    var out = this.output();
+    if (this.isUnary()) {
+        out.walkStrength = this.strength;
+        out.stay = !this.isInput();
+        if (out.stay) this.execute();
+        return;
+    }
+    var ihn = this.input();
+    out.walkStrength = weakestOf(this.strength, ihn.walkStrength);
+    out.stay = ihn.stay;
+    if (this.kind == SCALE) out.stay = out.stay && this.scale.stay && this.offset.stay;
+    if (out.stay) this.execute();
+};
+
+Constraint.prototype.satisfy = function (mark, planner) {
+    this.chooseMethod(mark);
+    if (!this.isSatisfied()) {
+        if (this.strength == REQUIRED) throw new Error("Could not satisfy a required constraint");
+        return null;
+    }
+    this.markInputs(mark);
+    var out = this.output();
+    var overridden = out.determinedBy;
+    if (overridden != null) overridden.markUnsatisfied();
+    out.determinedBy = this;
+    if (!planner.addPropagate(this, mark)) throw new Error("Cycle encountered");
+    out.mark = mark;
+    return overridden;
+};
+
+Constraint.prototype.addConstraint = function (planner) {
+    this.addToGraph();
+    planner.incrementalAdd(this);
+};
+
+Constraint.prototype.destroyConstraint = function (planner) {
+    if (this.isSatisfied()) planner.incrementalRemove(this);
+    else this.removeFromGraph();
+};
+
+function Planner() {
+    this.currentMark = 0;
+}
+
+Planner.prototype.newMark = function () { return ++this.currentMark; };
+
+Planner.prototype.incrementalAdd = function (c) {
+    var mark = this.newMark();
+    var overridden = c.satisfy(mark, this);
+    while (overridden != null) overridden = overridden.satisfy(mark, this);
+};
+
+Planner.prototype.incrementalRemove = function (c) {
+    var out = c.output();
+    c.markUnsatisfied();
+    c.removeFromGraph();
+    var unsatisfied = this.removePropagateFrom(out);
+    var strength = REQUIRED;
+    do {
+        for (var i = 0; i < unsatisfied.length; i++) {
+            var u = unsatisfied[i];
+            if (u.strength == strength) this.incrementalAdd(u);
+        }
+        strength = nextWeaker(strength);
+    } while (strength != WEAKEST);
+};
+
+Planner.prototype.makePlan = function (sources) {
+    var mark = this.newMark();
+    var plan = [];
+    var todo = sources;
+    while (todo.length > 0) {
+        var c = todo.pop();
+        if (c.output().mark != mark && c.inputsKnown(mark)) {
+            plan.push(c);
+            c.output().mark = mark;
+            this.addConstraintsConsumingTo(c.output(), todo);
+        }
+    }
+    return plan;
+};
+
+Planner.prototype.extractPlanFromConstraints = function (constraints) {
+    var sources = [];
+    for (var i = 0; i < constraints.length; i++) {
+        var c = constraints[i];
+        if (c.isInput() && c.isSatisfied()) sources.push(c);
+    }
+    return this.makePlan(sources);
+};
+
+Planner.prototype.addPropagate = function (c, mark) {
+    var todo = [c];
+    while (todo.length > 0) {
+        var d = todo.pop();
+        if (d.output().mark == mark) {
+            this.incrementalRemove(c);
+            return false;
+        }
+        d.recalculate();
+        this.addConstraintsConsumingTo(d.output(), todo);
+    }
+    return true;
+};
+
+Planner.prototype.removePropagateFrom = function (out) {
+    out.determinedBy = null;
+    out.walkStrength = WEAKEST;
+    out.stay = true;
+    var unsatisfied = [];
+    var todo = [out];
+    while (todo.length > 0) {
+        var v = todo.pop();
+        for (var i = 0; i < v.constraints.length; i++) {
+            var c = v.constraints[i];
+            if (!c.isSatisfied()) unsatisfied.push(c);
+        }
+        var determining = v.determinedBy;
+        for (var j = 0; j < v.constraints.length; j++) {
+            var next = v.constraints[j];
+            if (next !== determining && next.isSatisfied()) {
+                next.recalculate();
+                todo.push(next.output());
+            }
+        }
+    }
+    return unsatisfied;
+};
+
+Planner.prototype.addConstraintsConsumingTo = function (v, coll) {
+    var determining = v.determinedBy;
+    for (var i = 0; i < v.constraints.length; i++) {
+        var c = v.constraints[i];
+        if (c !== determining && c.isSatisfied()) coll.push(c);
+    }
+};
+
+function executePlan(plan) {
+    for (var i = 0; i < plan.length; i++) plan[i].execute();
+}
+
+function change(planner, v, newValue) {
+    var edit = new Constraint(EDIT, PREFERRED, v, null, null, null);
+    edit.addConstraint(planner);
+    var plan = planner.extractPlanFromConstraints([edit]);
+    for (var i = 0; i < 10; i++) {
+        v.value = newValue;
+        executePlan(plan);
+    }
+    edit.destroyConstraint(planner);
+}
+
+function chainTest(n) {
+    var planner = new Planner();
+    var prev = null;
+    var first = null;
+    var last = null;
+    for (var i = 0; i <= n; i++) {
+        var v = new Variable("v" + i, 0);
+        if (prev != null) {
+            var eq = new Constraint(EQUALITY, REQUIRED, prev, v, null, null);
+            eq.addConstraint(planner);
+        }
+        if (i == 0) first = v;
+        if (i == n) last = v;
+        prev = v;
+    }
+    var stay = new Constraint(STAY, STRONG_DEFAULT, last, null, null, null);
+    stay.addConstraint(planner);
+    var edit = new Constraint(EDIT, PREFERRED, first, null, null, null);
+    edit.addConstraint(planner);
+    var plan = planner.extractPlanFromConstraints([edit]);
+    var sum = 0;
+    for (var j = 0; j < 100; j++) {
+        first.value = j;
+        executePlan(plan);
+        if (last.value != j) throw new Error("Chain test failed");
+        sum += last.value;
+    }
+    return sum;
+}
+
+function projectionTest(n) {
+    var planner = new Planner();
+    var scale = new Variable("scale", 10);
+    var offset = new Variable("offset", 1000);
+    var src = null;
+    var dst = null;
+    var dests = [];
+    for (var i = 0; i < n; i++) {
+        src = new Variable("src" + i, i);
+        dst = new Variable("dst" + i, i);
+        dests.push(dst);
+        var stay = new Constraint(STAY, NORMAL, src, null, null, null);
+        stay.addConstraint(planner);
+        var sc = new Constraint(SCALE, REQUIRED, src, dst, scale, offset);
+        sc.addConstraint(planner);
+    }
+    change(planner, src, 17);
+    if (dst.value != 1170) throw new Error("Projection 1 failed");
+    change(planner, dst, 1050);
+    if (src.value != 5) throw new Error("Projection 2 failed");
+    change(planner, scale, 5);
+    for (var j = 0; j < n - 1; j++) {
+        if (dests[j].value != j * 5 + 1000) throw new Error("Projection 3 failed");
+    }
+    change(planner, offset, 2000);
+    for (var k = 0; k < n - 1; k++) {
+        if (dests[k].value != k * 5 + 2000) throw new Error("Projection 4 failed");
+    }
+    return dst.value + src.value;
+}
+
+function run() {
+    return chainTest(100) + projectionTest(100);
+}
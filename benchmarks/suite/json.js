@@ -0,0 +1,33 @@
+// JSON: stringify a nested record graph and parse it back, then walk the
+// result. Exercises the JSON builtins, property access on fresh objects
+// and string building.
+
+function makeRecord(i) {
+    return {
+        id: i,
+        name: "record-" + i,
+        active: i % 3 != 0,
+        score: i * 1.5,
+        tags: ["alpha", "beta", "tag" + (i % 7)],
+        owner: { id: i % 17, name: "owner" + (i % 17), email: "owner" + (i % 17) + "@example.com" },
+        history: [{ at: i, value: i * 2 }, { at: i + 1, value: i * 3 }]
+    };
+}
+
+function run() {
+    var records = [];
+    for (var i = 0; i < 200; i++) records.push(makeRecord(i));
+
+    var checksum = 0;
+    for (var round = 0; round < 20; round++) {
+        var text = JSON.stringify({ version: round, records: records });
+        var parsed = JSON.parse(text);
+        checksum += text.length;
+        for (var j = 0; j < parsed.records.length; j++) {
+            var r = parsed.records[j];
+            if (r.active) checksum += r.owner.id + r.history[1].value;
+            checksum += r.tags.length;
+        }
+    }
+    return checksum;
+}
@@ -0,0 +1,23 @@
+// MapSet: keyed collection churn with Map and Set: inserts, lookups,
+// overwrites and deletes with number and string keys.
+
+function run() {
+    var checksum = 0;
+    var map = new Map();
+    var set = new Set();
+    for (var i = 0; i < 3000; i++) {
+        map.set("k" + i, i);
+        map.set(i, i * 2);
+        set.add(i % 500);
+    }
+    for (var j = 0; j < 3000; j += 3) {
+        checksum += map.get("k" + j) + map.get(j);
+        if (set.has(j % 700)) checksum += 1;
+        map["delete"]("k" + j);
+        map.set(j, j);
+    }
+    for (var k = 0; k < 3000; k++) {
+        if (map.has("k" + k)) checksum += map.get(k) % 13;
+    }
+    return checksum + map.size + set.size;
+}
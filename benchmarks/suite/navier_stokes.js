@@ -0,0 +1,128 @@
+// NavierStokes: 2D fluid solver after Jos Stam's "Real-Time Fluid Dynamics
+// for Games", as ported for the V8 and Octane suites. Numeric array code:
+// tight loops over a flat Array of doubles.
+
+var N = 32;
+var SIZE = (N + 2) * (N + 2);
+var ITERATIONS = 10;
+
+function IX(i, j) { return i + (N + 2) * j; }
+
+function makeField() {
+    var a = new Array(SIZE);
+    for (var i = 0; i < SIZE; i++) a[i] = 0;
+    return a;
+}
+
+function addSource(x, s, dt) {
+    for (var i = 0; i < SIZE; i++) x[i] += dt * s[i];
+}
+
+function setBoundary(b, x) {
+    for (var i = 1; i <= N; i++) {
+        x[IX(0, i)] = b == 1 ? -x[IX(1, i)] : x[IX(1, i)];
+        x[IX(N + 1, i)] = b == 1 ? -x[IX(N, i)] : x[IX(N, i)];
+        x[IX(i, 0)] = b == 2 ? -x[IX(i, 1)] : x[IX(i, 1)];
+        x[IX(i, N + 1)] = b == 2 ? -x[IX(i, N)] : x[IX(i, N)];
+    }
+    x[IX(0, 0)] = 0.5 * (x[IX(1, 0)] + x[IX(0, 1)]);
+    x[IX(0, N + 1)] = 0.5 * (x[IX(1, N + 1)] + x[IX(0, N)]);
+    x[IX(N + 1, 0)] = 0.5 * (x[IX(N, 0)] + x[IX(N + 1, 1)]);
+    x[IX(N + 1, N + 1)] = 0.5 * (x[IX(N, N + 1)] + x[IX(N + 1, N)]);
+}
+
+function linearSolve(b, x, x0, a, c) {
+    var rowSize = N + 2;
+    for (var k = 0; k < ITERATIONS; k++) {
+        for (var j = 1; j <= N; j++) {
+            var current = j * rowSize + 1;
+            for (var i = 1; i <= N; i++, current++) {
+                x[current] = (x0[current] + a * (x[current - 1] + x[current + 1] +
+                              x[current - rowSize] + x[current + rowSize])) / c;
+            }
+        }
+        setBoundary(b, x);
+    }
+}
+
+function diffuse(b, x, x0, diff, dt) {
+    var a = dt * diff * N * N;
+    linearSolve(b, x, x0, a, 1 + 4 * a);
+}
+
+function advect(b, d, d0, u, v, dt) {
+    var dt0 = dt * N;
+    for (var j = 1; j <= N; j++) {
+        for (var i = 1; i <= N; i++) {
+            var x = i - dt0 * u[IX(i, j)];
+            var y = j - dt0 * v[IX(i, j)];
+            if (x < 0.5) x = 0.5;
+            if (x > N + 0.5) x = N + 0.5;
+            var i0 = Math.floor(x);
+            var i1 = i0 + 1;
+            if (y < 0.5) y = 0.5;
+            if (y > N + 0.5) y = N + 0.5;
+            var j0 = Math.floor(y);
+            var j1 = j0 + 1;
+            var s1 = x - i0;
+            var s0 = 1 - s1;
+            var t1 = y - j0;
+            var t0 = 1 - t1;
+            d[IX(i, j)] = s0 * (t0 * d0[IX(i0, j0)] + t1 * d0[IX(i0, j1)]) +
+                          s1 * (t0 * d0[IX(i1, j0)] + t1 * d0[IX(i1, j1)]);
+        }
+    }
+    setBoundary(b, d);
+}
+
+function project(u, v, p, div) {
+    var h = -0.5 / N;
+    for (var j = 1; j <= N; j++) {
+        for (var i = 1; i <= N; i++) {
+            div[IX(i, j)] = h * (u[IX(i + 1, j)] - u[IX(i - 1, j)] +
+                                 v[IX(i, j + 1)] - v[IX(i, j - 1)]);
+            p[IX(i, j)] = 0;
+        }
+    }
+    setBoundary(0, div);
+    setBoundary(0, p);
+    linearSolve(0, p, div, 1, 4);
+    for (var j2 = 1; j2 <= N; j2++) {
+        for (var i2 = 1; i2 <= N; i2++) {
+            u[IX(i2, j2)] -= 0.5 * N * (p[IX(i2 + 1, j2)] - p[IX(i2 - 1, j2)]);
+            v[IX(i2, j2)] -= 0.5 * N * (p[IX(i2, j2 + 1)] - p[IX(i2, j2 - 1)]);
+        }
+    }
+    setBoundary(1, u);
+    setBoundary(2, v);
+}
+
+function run() {
+    var dt = 0.1;
+    var u = makeField(), v = makeField(), uPrev = makeField(), vPrev = makeField();
+    var dens = makeField(), densPrev = makeField();
+
+    for (var step = 0; step < 4; step++) {
+        for (var k = 0; k < SIZE; k++) uPrev[k] = vPrev[k] = densPrev[k] = 0;
+        densPrev[IX(N / 2, N / 2)] = 100;
+        uPrev[IX(N / 2, N / 2)] = 20 * (step % 3 - 1);
+        vPrev[IX(N / 2, N / 2)] = 20;
+
+        addSource(u, uPrev, dt);
+        addSource(v, vPrev, dt);
+        diffuse(1, uPrev, u, 0, dt);
+        diffuse(2, vPrev, v, 0, dt);
+        project(uPrev, vPrev, u, v);
+        advect(1, u, uPrev, uPrev, vPrev, dt);
+        advect(2, v, vPrev, uPrev, vPrev, dt);
+        project(u, v, uPrev, vPrev);
+
+        addSource(dens, densPrev, dt);
+        diffuse(0, densPrev, dens, 0, dt);
+        advect(0, dens, densPrev, u, v, dt);
+    }
+
+    var total = 0;
+    for (var m = 0; m < SIZE; m++) total += dens[m];
+    return Math.round(total * 1000);
+}
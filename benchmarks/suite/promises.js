@@ -0,0 +1,21 @@
+// Promises: promise chains and Promise.all fan-in, settled by the
+// microtask queue. The result is only complete once the queue drains, so
+// run() returns the state object and the harness reads state.total.
+
+function run() {
+    var state = { total: 0 };
+    var chain = Promise.resolve(0);
+    for (var i = 0; i < 300; i++) {
+        chain = chain.then(function (v) { return v + 1; });
+    }
+    chain.then(function (v) { state.total += v; });
+
+    var batch = [];
+    for (var j = 0; j < 300; j++) {
+        batch.push(new Promise(function (resolve) { resolve(j); }));
+    }
+    Promise.all(batch).then(function (values) {
+        for (var k = 0; k < values.length; k++) state.total += values[k];
+    });
+    return state;
+}
@@ -0,0 +1,80 @@
+// Protobuf-like decoding: messages of varint, fixed32, fixed64 and nested
+// length-delimited fields encoded into an ArrayBuffer, then walked tag by
+// tag with DataView byte and fixed-width reads.
+
+var MESSAGES = 300;
+
+function writeVarint(view, offset, number) {
+    var at = offset;
+    var value = number;
+    while (value >= 128) {
+        view.setUint8(at++, (value & 127) | 128);
+        value = value >>> 7;
+    }
+    view.setUint8(at++, value);
+    return at;
+}
+
+function encode(view) {
+    var at = 0;
+    for (var i = 0; i < MESSAGES; i++) {
+        at = writeVarint(view, at, (1 << 3) | 0);           // id: varint
+        at = writeVarint(view, at, i * 1031);
+        at = writeVarint(view, at, (2 << 3) | 5);           // weight: fixed32
+        view.setUint32(at, i * 3 + 7, true);
+        at += 4;
+        at = writeVarint(view, at, (3 << 3) | 1);           // score: fixed64 double
+        view.setFloat64(at, i * 1.25, true);
+        at += 8;
+        at = writeVarint(view, at, (4 << 3) | 2);           // point: nested message
+        at = writeVarint(view, at, 4);
+        at = writeVarint(view, at, (1 << 3) | 0);
+        at = writeVarint(view, at, i % 100);
+        at = writeVarint(view, at, (2 << 3) | 0);
+        at = writeVarint(view, at, (i * 7) % 100);
+    }
+    return at;
+}
+
+function run() {
+    var view = new DataView(new ArrayBuffer(MESSAGES * 40));
+    var end = encode(view);
+
+    var checksum = 0;
+    for (var round = 0; round < 5; round++) {
+        var at = 0;
+        while (at < end) {
+            var key = 0;
+            var shift = 0;
+            var b = 128;
+            while (b >= 128) {
+                b = view.getUint8(at++);
+                key = key | ((b & 127) << shift);
+                shift += 7;
+            }
+            var wire = key & 7;
+            if (wire == 0) {
+                var value = 0;
+                shift = 0;
+                b = 128;
+                while (b >= 128) {
+                    b = view.getUint8(at++);
+                    value = value | ((b & 127) << shift);
+                    shift += 7;
+                }
+                checksum += value;
+            } else if (wire == 5) {
+                checksum += view.getUint32(at, true);
+                at += 4;
+            } else if (wire == 1) {
+                checksum += view.getFloat64(at, true) * 4;
+                at += 8;
+            } else {
+                // Nested messages are decoded inline: their fields follow
+                b = view.getUint8(at++);
+                checksum += b;
+            }
+        }
+    }
+    return checksum;
+}
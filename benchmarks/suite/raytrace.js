@@ -0,0 +1,167 @@
+// RayTrace: a small ray tracer in the style of the Flog.RayTracer used by
+// the V8 and Octane suites. Lots of short lived Vector objects and
+// prototype method calls; renders a 3 sphere scene with shadows and
+// reflections at low resolution and sums the pixel intensities.
+
+var WIDTH = 24;
+var HEIGHT = 24;
+var MAX_DEPTH = 2;
+
+function Vector(x, y, z) {
+    this.x = x;
+    this.y = y;
+    this.z = z;
+}
+
+Vector.prototype.add = function (v) { return new Vector(this.x + v.x, this.y + v.y, this.z + v.z); };
+Vector.prototype.subtract = function (v) { return new Vector(this.x - v.x, this.y - v.y, this.z - v.z); };
+Vector.prototype.scale = function (s) { return new Vector(this.x * s, this.y * s, this.z * s); };
+Vector.prototype.dot = function (v) { return this.x * v.x + this.y * v.y + this.z * v.z; };
+Vector.prototype.magnitude = function () { return Math.sqrt(this.dot(this)); };
+Vector.prototype.normalize = function () { return this.scale(1 / this.magnitude()); };
+Vector.prototype.cross = function (v) {
+    return new Vector(this.y * v.z - this.z * v.y, this.z * v.x - this.x * v.z, this.x * v.y - this.y * v.x);
+};
+
+function Color(r, g, b) {
+    this.r = r;
+    this.g = g;
+    this.b = b;
+}
+
+Color.prototype.add = function (c) { return new Color(this.r + c.r, this.g + c.g, this.b + c.b); };
+Color.prototype.multiply = function (c) { return new Color(this.r * c.r, this.g * c.g, this.b * c.b); };
+Color.prototype.scale = function (s) { return new Color(this.r * s, this.g * s, this.b * s); };
+Color.prototype.limit = function () {
+    return new Color(Math.min(1, Math.max(0, this.r)), Math.min(1, Math.max(0, this.g)), Math.min(1, Math.max(0, this.b)));
+};
+
+function Ray(position, direction) {
+    this.position = position;
+    this.direction = direction;
+}
+
+function Material(color, reflection, gloss) {
+    this.color = color;
+    this.reflection = reflection;
+    this.gloss = gloss;
+}
+
+function Sphere(center, radius, material) {
+    this.center = center;
+    this.radius = radius;
+    this.material = material;
+}
+
+// Distance along the ray to the nearest hit, or -1
+Sphere.prototype.intersect = function (ray) {
+    var dst = ray.position.subtract(this.center);
+    var b = dst.dot(ray.direction);
+    var c = dst.dot(dst) - this.radius * this.radius;
+    var d = b * b - c;
+    if (d <= 0) return -1;
+    var t = -b - Math.sqrt(d);
+    return t > 0.0001 ? t : -1;
+};
+
+Sphere.prototype.normalAt = function (point) {
+    return point.subtract(this.center).normalize();
+};
+
+function Plane(normal, offset, material) {
+    this.normal = normal;
+    this.offset = offset;
+    this.material = material;
+}
+
+Plane.prototype.intersect = function (ray) {
+    var denom = this.normal.dot(ray.direction);
+    if (denom >= 0) return -1;
+    var t = -(this.normal.dot(ray.position) + this.offset) / denom;
+    return t > 0.0001 ? t : -1;
+};
+
+Plane.prototype.normalAt = function (point) {
+    return this.normal;
+};
+
+function Light(position, color) {
+    this.position = position;
+    this.color = color;
+}
+
+function Scene() {
+    this.shapes = [
+        new Sphere(new Vector(-1.5, 1, 0), 1, new Material(new Color(0.9, 0.2, 0.2), 0.3, 16)),
+        new Sphere(new Vector(1.2, 0.8, -0.8), 0.8, new Material(new Color(0.2, 0.9, 0.3), 0.5, 32)),
+        new Sphere(new Vector(0.2, 0.5, 1.6), 0.5, new Material(new Color(0.3, 0.3, 0.9), 0.1, 8)),
+        new Plane(new Vector(0, 1, 0), 0, new Material(new Color(0.8, 0.8, 0.8), 0.2, 4))
+    ];
+    this.lights = [
+        new Light(new Vector(5, 10, -5), new Color(0.8, 0.8, 0.8)),
+        new Light(new Vector(-6, 8, 4), new Color(0.4, 0.4, 0.5))
+    ];
+    this.background = new Color(0.05, 0.05, 0.1);
+}
+
+Scene.prototype.nearest = function (ray) {
+    var best = null;
+    var bestDistance = 1e30;
+    for (var i = 0; i < this.shapes.length; i++) {
+        var t = this.shapes[i].intersect(ray);
+        if (t > 0 && t < bestDistance) {
+            bestDistance = t;
+            best = this.shapes[i];
+        }
+    }
+    return best == null ? null : { shape: best, distance: bestDistance };
+};
+
+Scene.prototype.trace = function (ray, depth) {
+    var hit = this.nearest(ray);
+    if (hit == null) return this.background;
+
+    var point = ray.position.add(ray.direction.scale(hit.distance));
+    var normal = hit.shape.normalAt(point);
+    var material = hit.shape.material;
+    var color = material.color.scale(0.1);
+
+    for (var i = 0; i < this.lights.length; i++) {
+        var light = this.lights[i];
+        var toLight = light.position.subtract(point).normalize();
+        var diffuse = normal.dot(toLight);
+        if (diffuse <= 0) continue;
+        if (this.nearest(new Ray(point, toLight)) != null) continue;
+        color = color.add(material.color.multiply(light.color).scale(diffuse));
+        var reflected = toLight.subtract(normal.scale(2 * diffuse));
+        var specular = reflected.dot(ray.direction);
+        if (specular > 0) color = color.add(light.color.scale(Math.pow(specular, material.gloss)));
+    }
+
+    if (depth < MAX_DEPTH && material.reflection > 0) {
+        var bounce = ray.direction.subtract(normal.scale(2 * normal.dot(ray.direction)));
+        color = color.add(this.trace(new Ray(point, bounce), depth + 1).scale(material.reflection));
+    }
+    return color.limit();
+};
+
+function run() {
+    var scene = new Scene();
+    var eye = new Vector(0, 2, -7);
+    var target = new Vector(0, 0.8, 0);
+    var forward = target.subtract(eye).normalize();
+    var right = (new Vector(0, 1, 0)).cross(forward).normalize().scale(-1);
+    var up = forward.cross(right).scale(-1);
+
+    var total = 0;
+    for (var y = 0; y < HEIGHT; y++) {
+        for (var x = 0; x < WIDTH; x++) {
+            var u = (x + 0.5) / WIDTH * 2 - 1;
+            var v = 1 - (y + 0.5) / HEIGHT * 2;
+            var direction = forward.add(right.scale(u)).add(up.scale(v)).normalize();
+            var c = scene.trace(new Ray(eye, direction), 0);
+            total += Math.floor(c.r * 255) + Math.floor(c.g * 255) + Math.floor(c.b * 255);
+        }
+    }
+    return total;
+}
@@ -0,0 +1,235 @@
+// Richards: an operating system task scheduler simulation (after Martin
+// Richards' benchmark as ported in the V8 and Octane suites, reduced to the
+// idle, worker, handler and device tasks over packet queues).
+
+var ID_IDLE = 0;
+var ID_WORKER = 1;
+var ID_HANDLER_A = 2;
+var ID_HANDLER_B = 3;
+var ID_DEVICE_A = 4;
+var ID_DEVICE_B = 5;
+var NUMBER_OF_IDS = 6;
+
+var KIND_DEVICE = 0;
+var KIND_WORK = 1;
+var DATA_SIZE = 4;
+
+var STATE_RUNNING = 0;
+var STATE_RUNNABLE = 1;
+var STATE_SUSPENDED = 2;
+var STATE_HELD = 4;
+var STATE_SUSPENDED_RUNNABLE = 3;
+
+function Packet(link, id, kind) {
+    this.link = link;
+    this.id = id;
+    this.kind = kind;
+    this.a1 = 0;
+    this.a2 = [0, 0, 0, 0];
+}
+
+Packet.prototype.addTo = function (queue) {
+    this.link = null;
+    if (queue == null) return this;
+    var next = queue;
+    while (next.link != null) next = next.link;
+    next.link = this;
+    return queue;
+};
+
+function TaskControlBlock(link, id, priority, queue, task) {
+    this.link = link;
+    this.id = id;
+    this.priority = priority;
+    this.queue = queue;
+    this.task = task;
+    this.state = queue == null ? STATE_SUSPENDED : STATE_SUSPENDED_RUNNABLE;
+}
+
+TaskControlBlock.prototype.markAsNotHeld = function () { this.state = this.state & ~STATE_HELD; };
+TaskControlBlock.prototype.markAsHeld = function () { this.state = this.state | STATE_HELD; };
+TaskControlBlock.prototype.isHeldOrSuspended = function () {
+    return (this.state & STATE_HELD) != 0 || this.state == STATE_SUSPENDED;
+};
+TaskControlBlock.prototype.markAsSuspended = function () { this.state = this.state | STATE_SUSPENDED; };
+TaskControlBlock.prototype.markAsRunnable = function () { this.state = this.state | STATE_RUNNABLE; };
+
+TaskControlBlock.prototype.checkPriorityAdd = function (task, packet) {
+    if (this.queue == null) {
+        this.queue = packet;
+        this.markAsRunnable();
+        if (this.priority > task.priority) return this;
+    } else {
+        this.queue = packet.addTo(this.queue);
+    }
+    return task;
+};
+
+function Scheduler() {
+    this.queueCount = 0;
+    this.holdCount = 0;
+    this.blocks = [null, null, null, null, null, null];
+    this.list = null;
+    this.currentTcb = null;
+    this.currentId = 0;
+}
+
+Scheduler.prototype.addTask = function (id, priority, queue, task) {
+    this.currentTcb = new TaskControlBlock(this.list, id, priority, queue, task);
+    this.list = this.currentTcb;
+    this.blocks[id] = this.currentTcb;
+};
+
+Scheduler.prototype.schedule = function () {
+    this.currentTcb = this.list;
+    while (this.currentTcb != null) {
+        if (this.currentTcb.isHeldOrSuspended()) {
+            this.currentTcb = this.currentTcb.link;
+        } else {
+            this.currentId = this.currentTcb.id;
+            var tcb = this.currentTcb;
+            var packet = null;
+            if (tcb.state == STATE_SUSPENDED_RUNNABLE) {
+                packet = tcb.queue;
+                tcb.queue = packet.link;
+                tcb.state = tcb.queue == null ? STATE_RUNNING : STATE_RUNNABLE;
+            }
+            this.currentTcb = tcb.task.run(this, packet);
+        }
+    }
+};
+
+Scheduler.prototype.release = function (id) {
+    var tcb = this.blocks[id];
+    if (tcb == null) return tcb;
+    tcb.markAsNotHeld();
+    if (tcb.priority > this.currentTcb.priority) return tcb;
+    return this.currentTcb;
+};
+
+Scheduler.prototype.holdCurrent = function () {
+    this.holdCount++;
+    this.currentTcb.markAsHeld();
+    return this.currentTcb.link;
+};
+
+Scheduler.prototype.suspendCurrent = function () {
+    this.currentTcb.markAsSuspended();
+    return this.currentTcb;
+};
+
+Scheduler.prototype.queue = function (packet) {
+    var t = this.blocks[packet.id];
+    if (t == null) return t;
+    this.queueCount++;
+    packet.link = null;
+    packet.id = this.currentId;
+    return t.checkPriorityAdd(this.currentTcb, packet);
+};
+
+function IdleTask(count) {
+    this.v1 = 1;
+    this.count = count;
+}
+
+IdleTask.prototype.run = function (scheduler, packet) {
+    this.count--;
+    if (this.count == 0) return scheduler.holdCurrent();
+    if ((this.v1 & 1) == 0) {
+        this.v1 = this.v1 >> 1;
+        return scheduler.release(ID_DEVICE_A);
+    }
+    this.v1 = (this.v1 >> 1) ^ 0xD008;
+    return scheduler.release(ID_DEVICE_B);
+};
+
+function DeviceTask() {
+    this.v1 = null;
+}
+
+DeviceTask.prototype.run = function (scheduler, packet) {
+    if (packet == null) {
+        if (this.v1 == null) return scheduler.suspendCurrent();
+        var v = this.v1;
+        this.v1 = null;
+        return scheduler.queue(v);
+    }
+    this.v1 = packet;
+    return scheduler.holdCurrent();
+};
+
+function WorkerTask() {
+    this.v1 = ID_HANDLER_A;
+    this.v2 = 0;
+}
+
+WorkerTask.prototype.run = function (scheduler, packet) {
+    if (packet == null) return scheduler.suspendCurrent();
+    this.v1 = this.v1 == ID_HANDLER_A ? ID_HANDLER_B : ID_HANDLER_A;
+    packet.id = this.v1;
+    packet.a1 = 0;
+    for (var i = 0; i < DATA_SIZE; i++) {
+        this.v2++;
+        if (this.v2 > 26) this.v2 = 1;
+        packet.a2[i] = this.v2;
+    }
+    return scheduler.queue(packet);
+};
+
+function HandlerTask() {
+    this.v1 = null;
+    this.v2 = null;
+}
+
+HandlerTask.prototype.run = function (scheduler, packet) {
+    if (packet != null) {
+        if (packet.kind == KIND_WORK) {
+            this.v1 = packet.addTo(this.v1);
+        } else {
+            this.v2 = packet.addTo(this.v2);
+        }
+    }
+    if (this.v1 != null) {
+        var count = this.v1.a1;
+        if (count < DATA_SIZE) {
+            if (this.v2 != null) {
+                var v = this.v2;
+                this.v2 = this.v2.link;
+                v.a1 = this.v1.a2[count];
+                this.v1.a1 = count + 1;
+                return scheduler.queue(v);
+            }
+        } else {
+            var w = this.v1;
+            this.v1 = this.v1.link;
+            return scheduler.queue(w);
+        }
+    }
+    return scheduler.suspendCurrent();
+};
+
+function run() {
+    var scheduler = new Scheduler();
+    scheduler.addTask(ID_IDLE, 0, null, new IdleTask(1000));
+    scheduler.currentTcb.state = STATE_RUNNING;
+
+    var queue = new Packet(null, ID_WORKER, KIND_WORK);
+    queue = new Packet(queue, ID_WORKER, KIND_WORK);
+    scheduler.addTask(ID_WORKER, 1000, queue, new WorkerTask());
+
+    queue = new Packet(null, ID_DEVICE_A, KIND_DEVICE);
+    queue = new Packet(queue, ID_DEVICE_A, KIND_DEVICE);
+    queue = new Packet(queue, ID_DEVICE_A, KIND_DEVICE);
+    scheduler.addTask(ID_HANDLER_A, 2000, queue, new HandlerTask());
+
+    queue = new Packet(null, ID_DEVICE_B, KIND_DEVICE);
+    queue = new Packet(queue, ID_DEVICE_B, KIND_DEVICE);
+    queue = new Packet(queue, ID_DEVICE_B, KIND_DEVICE);
+    scheduler.addTask(ID_HANDLER_B, 3000, queue, new HandlerTask());
+
+    scheduler.addTask(ID_DEVICE_A, 4000, null, new DeviceTask());
+    scheduler.addTask(ID_DEVICE_B, 5000, null, new DeviceTask());
+
+    scheduler.schedule();
+    return scheduler.queueCount * 10000 + scheduler.holdCount;
+}
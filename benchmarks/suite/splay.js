@@ -0,0 +1,176 @@
+// Splay: splay tree insert/find/remove churn, as in the V8 and Octane
+// suites. Allocation heavy: every node carries a small payload tree, so
+// this is mostly a garbage collector and object allocation workload.
+
+var TREE_SIZE = 2000;
+var MODIFICATIONS = 400;
+var PAYLOAD_DEPTH = 3;
+
+var seed = 49734321;
+
+function random() {
+    // Robert Jenkins' 32 bit integer hash, as used by the original benchmark
+    seed = ((seed + 0x7ed55d16) + (seed << 12)) & 0xffffffff;
+    seed = ((seed ^ 0xc761c23c) ^ (seed >>> 19)) & 0xffffffff;
+    seed = ((seed + 0x165667b1) + (seed << 5)) & 0xffffffff;
+    seed = ((seed + 0xd3a2646c) ^ (seed << 9)) & 0xffffffff;
+    seed = ((seed + 0xfd7046c5) + (seed << 3)) & 0xffffffff;
+    seed = ((seed ^ 0xb55a4f09) ^ (seed >>> 16)) & 0xffffffff;
+    return (seed & 0xfffffff) / 0x10000000;
+}
+
+function generatePayload(depth, tag) {
+    if (depth == 0) {
+        return { array: [0, 1, 2, 3, 4, 5, 6, 7, 8, 9], string: "String for key " + tag + " in leaf node" };
+    }
+    return { left: generatePayload(depth - 1, tag), right: generatePayload(depth - 1, tag) };
+}
+
+function SplayNode(key, value) {
+    this.key = key;
+    this.value = value;
+    this.left = null;
+    this.right = null;
+}
+
+function SplayTree() {
+    this.root = null;
+}
+
+SplayTree.prototype.isEmpty = function () { return !this.root; };
+
+SplayTree.prototype.splay = function (key) {
+    if (this.isEmpty()) return;
+    var dummy = new SplayNode(null, null);
+    var left = dummy;
+    var right = dummy;
+    var current = this.root;
+    while (true) {
+        if (key < current.key) {
+            if (!current.left) break;
+            if (key < current.left.key) {
+                var tmp = current.left;
+                current.left = tmp.right;
+                tmp.right = current;
+                current = tmp;
+                if (!current.left) break;
+            }
+            right.left = current;
+            right = current;
+            current = current.left;
+        } else if (key > current.key) {
+            if (!current.right) break;
+            if (key > current.right.key) {
+                var tmp2 = current.right;
+                current.right = tmp2.left;
+                tmp2.left = current;
+                current = tmp2;
+                if (!current.right) break;
+            }
+            left.right = current;
+            left = current;
+            current = current.right;
+        } else {
+            break;
+        }
+    }
+    left.right = current.left;
+    right.left = current.right;
+    current.left = dummy.right;
+    current.right = dummy.left;
+    this.root = current;
+};
+
+SplayTree.prototype.insert = function (key, value) {
+    if (this.isEmpty()) {
+        this.root = new SplayNode(key, value);
+        return;
+    }
+    this.splay(key);
+    if (this.root.key == key) return;
+    var node = new SplayNode(key, value);
+    if (key > this.root.key) {
+        node.left = this.root;
+        node.right = this.root.right;
+        this.root.right = null;
+    } else {
+        node.right = this.root;
+        node.left = this.root.left;
+        this.root.left = null;
+    }
+    this.root = node;
+};
+
+SplayTree.prototype.remove = function (key) {
+    if (this.isEmpty()) return null;
+    this.splay(key);
+    if (this.root.key != key) return null;
+    var removed = this.root;
+    if (!this.root.left) {
+        this.root = this.root.right;
+    } else {
+        var right = this.root.right;
+        this.root = this.root.left;
+        this.splay(key);
+        this.root.right = right;
+    }
+    return removed;
+};
+
+SplayTree.prototype.find = function (key) {
+    if (this.isEmpty()) return null;
+    this.splay(key);
+    return this.root.key == key ? this.root : null;
+};
+
+SplayTree.prototype.findMax = function (start) {
+    if (this.isEmpty()) return null;
+    var current = start || this.root;
+    while (current.right) current = current.right;
+    return current;
+};
+
+SplayTree.prototype.findGreatestLessThan = function (key) {
+    if (this.isEmpty()) return null;
+    this.splay(key);
+    if (this.root.key < key) return this.root;
+    if (this.root.left) return this.findMax(this.root.left);
+    return null;
+};
+
+SplayTree.prototype.countNodes = function () {
+    var count = 0;
+    var stack = this.root ? [this.root] : [];
+    while (stack.length > 0) {
+        var node = stack.pop();
+        count++;
+        if (node.left) stack.push(node.left);
+        if (node.right) stack.push(node.right);
+    }
+    return count;
+};
+
+function insertNewNode(tree) {
+    var key;
+    do {
+        key = random();
+    } while (tree.find(key) != null);
+    tree.insert(key, generatePayload(PAYLOAD_DEPTH, key));
+    return key;
+}
+
+function run() {
+    seed = 49734321;
+    var tree = new SplayTree();
+    for (var i = 0; i < TREE_SIZE; i++) insertNewNode(tree);
+
+    var removed = 0;
+    for (var j = 0; j < MODIFICATIONS; j++) {
+        var key = insertNewNode(tree);
+        var greatest = tree.findGreatestLessThan(key);
+        if (greatest == null) tree.remove(key);
+        else tree.remove(greatest.key);
+        removed++;
+    }
+    return tree.countNodes() * 1000 + removed;
+}
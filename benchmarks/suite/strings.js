@@ -0,0 +1,32 @@
+// Strings: concatenation, slicing, searching, splitting and joining, the
+// mix a templating or log processing script does.
+
+function run() {
+    var lines = [];
+    for (var i = 0; i < 500; i++) {
+        lines.push("2024-01-" + (i % 28 + 1) + " level=" + (i % 5 == 0 ? "error" : "info") +
+                   " user=u" + (i % 37) + " msg=request handled in " + (i % 100) + "ms");
+    }
+    var log = lines.join("\n");
+
+    var checksum = 0;
+    var records = log.split("\n");
+    for (var j = 0; j < records.length; j++) {
+        var line = records[j];
+        if (line.indexOf("level=error") >= 0) checksum += 7;
+        var user = line.substring(line.indexOf("user=") + 5, line.indexOf(" msg="));
+        checksum += user.length;
+        var fields = line.split(" ");
+        checksum += fields.length;
+        var ms = line.slice(line.lastIndexOf(" ") + 1, line.length - 2);
+        checksum += parseInt(ms, 10);
+        checksum += line.toUpperCase().charCodeAt(j % line.length);
+        checksum += line.replace("info", "INFO").length;
+    }
+
+    var alphabet = "abcdefghijklmnopqrstuvwxyz";
+    var built = "";
+    for (var k = 0; k < 2000; k++) built += alphabet.charAt(k % 26);
+    checksum += built.length + built.charCodeAt(1999);
+    return checksum;
+}
@@ -0,0 +1,33 @@
+// SymbolKeys: objects keyed by symbols, well-known ones included, side by
+// side with string keys escaped to spell a symbol key's bytes ("\xff1" is
+// U+00FF then "1", not Symbol.iterator's key), through get, set, in,
+// Object.keys and for-of.
+
+function* pair() {
+    yield 1;
+    yield 2;
+}
+
+function run() {
+    var checksum = 0;
+    var tag = Symbol("tag");
+    for (var i = 0; i < 2000; i++) {
+        var o = {};
+        o["\xff" + (i % 13)] = pair;
+        o["\xff1"] = pair;
+        o[tag] = i;
+        o["k" + i] = i % 7;
+        checksum += Object.keys(o).length;
+        checksum += o[tag] + o["k" + i];
+        if ("\xff1" in o) checksum += 1;
+        try {
+            for (var v of o) checksum += 1000000;
+        } catch (e) {
+            checksum += 2;
+        }
+        var it = {};
+        it[Symbol.iterator] = pair;
+        for (var w of it) checksum += w;
+    }
+    return checksum;
+}
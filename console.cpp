@@ -72,9 +72,11 @@ public:
 private:
     
 public:
-    QuantaConsole() {
+    // allow_ffi exposes FFI.open, which lets a script call any native code
+    explicit QuantaConsole(bool allow_ffi = false) {
         // Initialize engine with optimized configuration
         engine_ = std::make_unique<Engine>();
+        engine_->enable_ffi(allow_ffi);
         bool init_result = engine_->initialize();  // Minimal lazy init!
         
         if (!init_result) {
@@ -297,11 +299,9 @@ public:
 
 int main(int argc, char* argv[]) {
     try {
-        
-        QuantaConsole console;
-        
         // Check for -c flag for direct code execution
         bool execute_code = false;
+        bool allow_ffi = false;
         std::string code_to_execute;
         std::string filename;
 
@@ -314,6 +314,9 @@ int main(int argc, char* argv[]) {
                 code_to_execute = argv[i + 1];
                 i++; // Skip the next argument since we consumed it
                 continue;
+            } else if (arg == "--allow-ffi") {
+                allow_ffi = true;
+                continue;
             } else if (arg.find("--") == 0) {
                 // Skip known Node.js/V8 flags that test262 might pass
                 continue;
@@ -323,6 +326,8 @@ int main(int argc, char* argv[]) {
             }
         }
         
+        QuantaConsole console(allow_ffi);
+        
         // If -c flag provided, execute the code directly
         if (execute_code) {
             bool success = console.evaluate_expression(code_to_execute, false, true);
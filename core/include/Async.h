@@ -9,16 +9,19 @@
 #include "Value.h"
 #include "Object.h"
 #include "Promise.h"
+#include <cstdint>
 #include <memory>
 #include <functional>
 #include <future>
 #include <thread>
+#include <chrono>
 
 namespace Quanta {
 
 class Context;
 class ASTNode;
 class Function;
+class GarbageCollector;
 
 /**
  * Async Function implementation
@@ -37,11 +40,86 @@ public:
     // Override call to return promise
     Value call(Context& ctx, const std::vector<Value>& args, Value this_value = Value()) override;
     
-    // Create async execution context
-    std::unique_ptr<Promise> execute_async(Context& ctx, const std::vector<Value>& args);
+    ASTNode* get_async_body() const { return body_.get(); }
+};
+
+/**
+ * One call of an async function
+ * The body runs on a machine stack of its own, so an await can suspend it
+ * and the reaction job of the awaited promise resumes it where it stopped.
+ * Finished activations are kept per thread, stack included, for later calls.
+ */
+class AsyncActivation : public Object {
+public:
+    enum class State {
+        Running,
+        Suspended,
+        Finished
+    };
+    
+private:
+    struct Stack;
+    
+    AsyncFunction* function_;
+    std::unique_ptr<Context> context_;
+    Promise* promise_;
+    State state_;
+    Stack* stack_;
+    uintptr_t stack_limit_;
+    
+    // Handles of whichever side of the switch is not running
+    GarbageCollector* gc_;
+    std::vector<Value> parked_handles_;
+    size_t parked_handle_depth_;
+    int parked_try_depth_;
+    AsyncActivation* parked_current_;
+    
+    // Settlement of the awaited promise, delivered by resume()
+    Value resumed_value_;
+    bool resumed_fulfilled_;
+    
+    AsyncActivation* next_free_;
+    
+    static thread_local AsyncActivation* current_;
+    
+public:
+    AsyncActivation();
+    virtual ~AsyncActivation();
+    
+    // Runs the body until its first await or its end; the promise is the call's result
+    static Promise* start(AsyncFunction* function, Context& ctx, const std::vector<Value>& args, Value this_value);
+    
+    // The activation whose body is running on this thread, or null
+    static AsyncActivation* current() { return current_; }
+    
+    // True once the running body nears the end of its stack. Calls and
+    // expressions that nest without a call check this before going deeper,
+    // so a deep body throws a RangeError rather than hitting the guard page
+    static bool stack_exhausted() {
+        char marker;
+        return current_ && reinterpret_cast<uintptr_t>(&marker) < current_->stack_limit_;
+    }
+    
+    Context* get_context() const { return context_.get(); }
+    State get_state() const { return state_; }
+    
+    // Suspends the body until the promise settles; a rejection is thrown in the body's context
+    Value await(Promise* promise);
+    
+    // The awaited promise's reaction job: continues the body with the settlement
+    void resume(bool fulfilled, const Value& value);
+    
+    void visit_references(GCVisitor& visitor) const override;
     
 private:
-    void execute_async_body(Context& ctx, Promise* promise);
+    static AsyncActivation* acquire();
+    static void release(AsyncActivation* activation);
+    static void body_entry();
+    
+    void run_body();
+    void enter();
+    void leave();
+    void finish();
 };
 
 /**
@@ -188,32 +266,63 @@ namespace AsyncUtils {
 
 /**
  * Event loop simulation
- * Simple event loop for async operations
+ * Simple event loop for async operations. Microtasks are promise reaction
+ * jobs or arbitrary callbacks, kept in one ring buffer so they run in the
+ * order they were queued.
  */
 class EventLoop {
 private:
-    std::vector<std::function<void()>> microtasks_;
+    struct Microtask {
+        PromiseReaction* reaction = nullptr;    // a promise job, else task
+        std::function<void()> task;
+    };
+
+    std::vector<Microtask> microtasks_;     // ring; capacity is a power of two
+    size_t microtask_head_;
+    size_t microtask_count_;
+    std::vector<PromiseReaction*> running_reactions_;  // taken off the ring, still in use
     std::vector<std::function<void()>> macrotasks_;
+    std::function<void()> idle_callback_;
+    std::function<void(std::chrono::microseconds)> wait_handler_;
     bool running_;
     
+    void push_microtask(Microtask task);
+    
 public:
     EventLoop();
-    ~EventLoop() = default;
+    ~EventLoop();
     
     // Task scheduling
     void schedule_microtask(std::function<void()> task);
+    void schedule_reaction(PromiseReaction* reaction);
     void schedule_macrotask(std::function<void()> task);
     
     // Event loop control
     void run();
     void stop();
     bool is_running() const { return running_; }
+    bool has_pending_tasks() const { return microtask_count_ != 0 || !macrotasks_.empty(); }
+    bool has_pending_microtasks() const { return microtask_count_ != 0; }
+    bool has_pending_macrotasks() const { return !macrotasks_.empty(); }
     
     // Process tasks
     void process_microtasks();
     void process_macrotasks();
     
-    // Singleton access
+    // Invoked whenever the task queues drain (e.g. incremental GC work)
+    void set_idle_callback(std::function<void()> callback) { idle_callback_ = std::move(callback); }
+    
+    // Blocks while waiting for pending work; the handler may use the time for GC
+    void wait(std::chrono::microseconds duration);
+    void set_wait_handler(std::function<void(std::chrono::microseconds)> handler) { wait_handler_ = std::move(handler); }
+    
+    // Drops all queued tasks without running them
+    void clear();
+    
+    // Queued reaction jobs hold handlers, promises and settlement values
+    void visit_references(GCVisitor& visitor) const;
+    
+    // The current isolate's event loop
     static EventLoop& instance();
 };
 
@@ -119,13 +119,13 @@ struct BytecodeOperand {
 struct BytecodeOp {
     BytecodeInstruction instruction;
     std::vector<BytecodeOperand> operands;
-    uint32_t source_line;       // For debugging
+    uint32_t source_offset;     // For debugging: offset in the script, see LineTable
     
     BytecodeOp(BytecodeInstruction inst) 
-        : instruction(inst), source_line(0) {}
+        : instruction(inst), source_offset(0) {}
     
     BytecodeOp(BytecodeInstruction inst, std::vector<BytecodeOperand> ops)
-        : instruction(inst), operands(std::move(ops)), source_line(0) {}
+        : instruction(inst), operands(std::move(ops)), source_offset(0) {}
 };
 
 //=============================================================================
@@ -19,17 +19,21 @@ class ASTNode;
 
 /**
  * Represents a single frame in the call stack
+ * Pushed on every call, so it copies nothing: the names are referenced and
+ * must outlive the frame, and the position is an offset that the line table
+ * of the function's script turns into a line and column when a trace is
+ * formatted.
  */
 struct CallStackFrame {
-    std::string function_name;      // Name of the function being called
-    std::string filename;           // Source file name
-    Position position;              // Line/column in source
-    Function* function_ptr;         // Pointer to the function object (can be null)
-    ASTNode* call_site;             // AST node where the call was made (can be null)
+    const std::string* function_name; // Name of the function being called
+    const std::string* filename;      // Source file name
+    SourceOffset position;            // Offset in source
+    Function* function_ptr;           // Pointer to the function object (can be null)
+    ASTNode* call_site;               // AST node where the call was made (can be null)
     
     CallStackFrame(const std::string& name, const std::string& file, const Position& pos,
                Function* func = nullptr, ASTNode* call = nullptr)
-        : function_name(name), filename(file), position(pos), 
+        : function_name(&name), filename(&file), position(pos), 
           function_ptr(func), call_site(call) {}
     
     std::string to_string() const;
@@ -41,7 +45,10 @@ struct CallStackFrame {
 class CallStack {
 private:
     std::vector<CallStackFrame> frames_;
-    static thread_local CallStack* instance_;
+    
+    // Line table of the script running at top level; a function's frames
+    // use the table of the script that defined it instead
+    std::shared_ptr<const LineTable> script_lines_;
     
     // Maximum stack depth to prevent infinite recursion
     static constexpr size_t MAX_STACK_DEPTH = 1000;
@@ -50,9 +57,8 @@ public:
     CallStack() = default;
     ~CallStack() = default;
     
-    // Singleton access
+    // The current isolate's call stack
     static CallStack& instance();
-    static void set_instance(CallStack* stack);
     
     // Stack management
     void push_frame(const std::string& function_name, 
@@ -82,6 +88,13 @@ public:
     std::string current_filename() const;
     Position current_position() const;
     
+    // Source positions: a script's line table makes its frames' offsets
+    // resolvable to lines and columns. set_script_source returns the table
+    // it replaces, for the caller to restore when the script finishes
+    std::shared_ptr<const LineTable> set_script_source(std::shared_ptr<const LineTable> lines);
+    std::shared_ptr<const LineTable> current_source() const;
+    Position resolve(const CallStackFrame& frame) const;
+    
     // Stack overflow detection
     bool check_stack_overflow();
     
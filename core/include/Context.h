@@ -13,16 +13,19 @@
 #include <unordered_map>
 #include <string>
 #include <memory>
+#include <atomic>
 
 namespace Quanta {
 
 // Forward declarations
 class Engine;
+class GarbageCollector;
 class Function;
 class StackFrame;
 class Environment;
 class Error;
 class WebAPIInterface;
+class FeedbackVector;
 
 /**
  * JavaScript execution context
@@ -94,7 +97,10 @@ private:
     // Web API interface for external implementations
     WebAPIInterface* web_api_interface_;
     
-    static uint32_t next_context_id_;
+    // Type feedback of the function running in this context (null at top level)
+    FeedbackVector* feedback_vector_ = nullptr;
+    
+    static std::atomic<uint32_t> next_context_id_;
 
 public:
     // Constructors
@@ -107,6 +113,7 @@ public:
     State get_state() const { return state_; }
     uint32_t get_id() const { return context_id_; }
     Engine* get_engine() const { return engine_; }
+    GarbageCollector* get_garbage_collector() const;
     
     // Source file tracking
     const std::string& get_current_filename() const { return current_filename_; }
@@ -174,6 +181,10 @@ public:
     void set_return_value(const Value& value);
     void clear_return_value();
     
+    // Type feedback recording
+    FeedbackVector* get_feedback_vector() const { return feedback_vector_; }
+    void set_feedback_vector(FeedbackVector* vector) { feedback_vector_ = vector; }
+    
     // Break/Continue handling
     bool has_break() const { return has_break_; }
     bool has_continue() const { return has_continue_; }
@@ -197,8 +208,8 @@ public:
     std::vector<std::string> get_variable_names() const;
     std::string debug_string() const;
 
-    // Memory management
-    void mark_references() const;
+    // Memory management (GC roots held by this context)
+    void visit_references(GCVisitor& visitor) const;
     
     // Web API interface management
     void set_web_api_interface(WebAPIInterface* interface) { web_api_interface_ = interface; }
@@ -290,23 +301,56 @@ public:
         Global          // Global environment
     };
 
+    // One entry per name. An entry outlives its binding when the
+    // environment is reset for reuse, so redeclaring allocates nothing
+    struct Binding {
+        Value value;
+        bool is_mutable = true;
+        bool initialized = false;
+        bool present = false;
+    };
+
 private:
     Type type_;
     Environment* outer_environment_;
-    std::unordered_map<std::string, Value> bindings_;
-    std::unordered_map<std::string, bool> mutable_flags_;
-    std::unordered_map<std::string, bool> initialized_flags_;
+    std::unordered_map<std::string, Binding> bindings_;
+    size_t binding_count_;    // present entries
     Object* binding_object_;  // For object environments
+    uint64_t id_;
+    std::atomic<uint32_t> ref_count_;
+    uint64_t gc_epoch_;       // last marking cycle that scanned this environment
+
+    static std::atomic<uint64_t> next_id_;
 
 public:
     Environment(Type type, Environment* outer = nullptr);
     Environment(Object* binding_object, Environment* outer = nullptr); // Object environment
-    ~Environment() = default;
+    ~Environment();
+
+    // Reference counted: whoever creates an environment holds the first
+    // reference, and every inner environment and every closure created in
+    // it holds one more, so a scope lives as long as code can reach it.
+    // The count is atomic, so collector threads may drop references too.
+    void retain() { ref_count_.fetch_add(1, std::memory_order_relaxed); }
+    void release() {
+        if (ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+    }
+    bool is_shared() const { return ref_count_.load(std::memory_order_acquire) > 1; }
+
+    // Drops every binding and re-links the environment under outer, for
+    // a block entered again once nothing else holds its environment
+    void reset(Environment* outer);
 
     // Environment information
     Type get_type() const { return type_; }
     Environment* get_outer() const { return outer_environment_; }
     Object* get_binding_object() const { return binding_object_; }
+    
+    // Identity for cached binding slots: unique per environment, and renewed
+    // whenever a binding is removed, so (id, slot) pairs never dangle
+    uint64_t get_id() const { return id_; }
+    const Value* find_own_binding_slot(const std::string& name) const;
+    bool has_own_binding(const std::string& name) const;
 
     // Binding operations
     bool has_binding(const std::string& name) const;
@@ -325,11 +369,21 @@ public:
     std::vector<std::string> get_binding_names() const;
     std::string debug_string() const;
 
-    // Memory management
-    void mark_references() const;
+    // Binding snapshots (used to reset a pooled engine's global scope)
+    struct Snapshot {
+        std::unordered_map<std::string, Binding> bindings;
+        size_t binding_count;
+    };
+    Snapshot take_snapshot() const;
+    void restore_snapshot(const Snapshot& snapshot);
 
-private:
-    bool has_own_binding(const std::string& name) const;
+    // Memory management
+    void visit_references(GCVisitor& visitor) const;
+    bool try_set_gc_scanned(uint64_t epoch) {
+        if (gc_epoch_ == epoch) return false;
+        gc_epoch_ = epoch;
+        return true;
+    }
 };
 
 /**
@@ -11,6 +11,8 @@
 #include "ArrayBuffer.h"
 #include "Value.h"
 #include <memory>
+#include <vector>
+#include <string>
 #include <cstdint>
 
 namespace Quanta {
@@ -19,6 +21,53 @@ namespace Quanta {
 class Context;
 class ArrayBuffer;
 
+/**
+ * DataView.prototype builtins
+ * Installed once on DataView.prototype. Calls through the prototype reach
+ * call_builtin by id, and call sites that see one of these methods on a
+ * DataView receiver call it directly with their evaluated arguments.
+ */
+enum class DataViewBuiltin : uint8_t {
+    GetInt8, GetUint8, GetInt16, GetUint16, GetInt32, GetUint32, GetFloat32, GetFloat64,
+    SetInt8, SetUint8, SetInt16, SetUint16, SetInt32, SetUint32, SetFloat32, SetFloat64,
+    ReadLayout,
+    Count
+};
+
+/**
+ * Record layout compiled by DataView.compileLayout: named fields packed in
+ * order, each decoded by DataView.prototype.readLayout in one call
+ */
+class DataViewLayout : public Object {
+public:
+    enum class FieldType : uint8_t {
+        Int8, Uint8, Int16, Uint16, Int32, Uint32, Float32, Float64
+    };
+    
+    struct Field {
+        std::string name;
+        FieldType type;
+        uint32_t offset;        // from the start of the record
+    };
+    
+private:
+    std::vector<Field> fields_;
+    uint32_t byte_length_;
+    bool little_endian_;
+    
+public:
+    DataViewLayout(std::vector<Field> fields, bool little_endian);
+    
+    const std::vector<Field>& fields() const { return fields_; }
+    uint32_t byte_length() const { return byte_length_; }
+    bool little_endian() const { return little_endian_; }
+    
+    Value get_property(const std::string& key) const override;
+    
+    static bool parse_field_type(const std::string& name, FieldType& type);
+    static uint32_t field_size(FieldType type);
+};
+
 /**
  * DataView provides a flexible interface for reading and writing 
  * multi-byte numeric data at arbitrary offsets in ArrayBuffers
@@ -28,23 +77,39 @@ private:
     std::shared_ptr<ArrayBuffer> buffer_;
     size_t byte_offset_;
     size_t byte_length_;
-    
-    // Internal validation helpers
-    bool validate_offset(size_t offset, size_t size) const;
-    uint8_t* get_data_ptr() const;
+    // Start of the view. ArrayBuffer storage never moves (resizing only
+    // changes the logical length), so this stays valid while not detached
+    uint8_t* data_;
+    
+    // The view's bytes [offset, offset + size), or null when that range is
+    // out of bounds or the buffer is detached
+    uint8_t* bytes_at(size_t offset, size_t size) const {
+        if (__builtin_expect(offset > byte_length_ || size > byte_length_ - offset, 0)) {
+            return nullptr;
+        }
+        if (__builtin_expect(buffer_->is_detached(), 0)) {
+            return nullptr;
+        }
+        if (__builtin_expect(buffer_->is_resizable(), 0) &&
+            byte_offset_ + offset + size > buffer_->byte_length()) {
+            return nullptr;
+        }
+        return data_ + offset;
+    }
     
     // Internal data access methods with endianness handling
+    template<typename T>
+    static T load(const uint8_t* bytes, bool little_endian);
+    
+    template<typename T>
+    static void store(uint8_t* bytes, T value, bool little_endian);
+    
     template<typename T>
     T read_value(size_t offset, bool little_endian) const;
     
     template<typename T>
     bool write_value(size_t offset, T value, bool little_endian);
     
-    // Endianness conversion utilities
-    uint16_t swap_bytes_16(uint16_t value) const;
-    uint32_t swap_bytes_32(uint32_t value) const;
-    uint64_t swap_bytes_64(uint64_t value) const;
-    
 public:
     // Constructors
     explicit DataView(std::shared_ptr<ArrayBuffer> buffer);
@@ -94,6 +159,9 @@ public:
     bool set_float32(size_t offset, float value, bool little_endian = false);
     bool set_float64(size_t offset, double value, bool little_endian = false);
     
+    // Decodes one record of layout at offset into target's properties
+    bool read_layout(const DataViewLayout& layout, size_t offset, Object* target) const;
+    
     // Property access override
     Value get_property(const std::string& key) const override;
     
@@ -103,31 +171,22 @@ public:
     // Static constructor for JavaScript API
     static Value constructor(Context& ctx, const std::vector<Value>& args);
     
-    // JavaScript method implementations
-    static Value js_get_int8(Context& ctx, const std::vector<Value>& args);
-    static Value js_get_uint8(Context& ctx, const std::vector<Value>& args);
-    static Value js_get_int16(Context& ctx, const std::vector<Value>& args);
-    static Value js_get_uint16(Context& ctx, const std::vector<Value>& args);
-    static Value js_get_int32(Context& ctx, const std::vector<Value>& args);
-    static Value js_get_uint32(Context& ctx, const std::vector<Value>& args);
-    static Value js_get_float32(Context& ctx, const std::vector<Value>& args);
-    static Value js_get_float64(Context& ctx, const std::vector<Value>& args);
-    
-    static Value js_set_int8(Context& ctx, const std::vector<Value>& args);
-    static Value js_set_uint8(Context& ctx, const std::vector<Value>& args);
-    static Value js_set_int16(Context& ctx, const std::vector<Value>& args);
-    static Value js_set_uint16(Context& ctx, const std::vector<Value>& args);
-    static Value js_set_int32(Context& ctx, const std::vector<Value>& args);
-    static Value js_set_uint32(Context& ctx, const std::vector<Value>& args);
-    static Value js_set_float32(Context& ctx, const std::vector<Value>& args);
-    static Value js_set_float64(Context& ctx, const std::vector<Value>& args);
-
-private:
-    // Setup instance methods
-    void setup_methods();
+    // Native entry point of a DataView.prototype builtin; the receiver is
+    // the call's this binding
+    struct Method {
+        DataViewBuiltin id;
+        Value operator()(Context& ctx, const std::vector<Value>& args) const;
+    };
+    
+    // Runs builtin id on view without building an argument vector
+    static Value call_builtin(DataViewBuiltin id, Context& ctx, DataView* view, const Value* args, size_t argc);
+    static const char* builtin_name(DataViewBuiltin id);
+    
+    // DataView.compileLayout(fields, littleEndian)
+    static Value compile_layout(Context& ctx, const std::vector<Value>& args);
     
-    // Helper to get DataView from this binding
-    static DataView* get_this_dataview(Context& ctx);
+    // Installs the DataView constructor and DataView.prototype
+    static void setup_data_view_prototype(Context& ctx);
 };
 
 /**
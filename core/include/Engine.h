@@ -17,6 +17,7 @@
 #include <memory>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <chrono>
 #include <functional>
 
@@ -24,7 +25,9 @@ namespace Quanta {
 
 // Forward declarations
 class WebAPIInterface;
+class OptimizingCompiler;
 class ASTNode;
+class Isolate;
 
 /**
  * Main JavaScript engine interface
@@ -36,12 +39,21 @@ public:
     struct Config {
         bool strict_mode = false;
         bool enable_jit = true;
+        uint32_t jit_threshold = 100;               // calls before a function is optimized
         bool enable_optimizations = true;
         size_t max_heap_size = 512 * 1024 * 1024;  // 512MB
         size_t initial_heap_size = 32 * 1024 * 1024; // 32MB
         size_t max_stack_size = 8 * 1024 * 1024;    // 8MB
+        size_t gc_worker_threads = 0;               // 0 = one per hardware thread
+        bool incremental_gc = false;                // mark in time-sliced steps
+        bool background_gc = false;                 // also mark and sweep on a background thread while blocked
+        uint32_t gc_step_budget_us = 1000;          // per incremental marking step
+        bool numa_arenas = false;                   // allocate objects from the home node's arena
+        int32_t numa_node = -1;                     // home node; -1 = node the engine is created on
+        bool pin_threads = false;                   // pin the engine and GC threads to the home node
         bool enable_debugger = false;
         bool enable_profiler = false;
+        bool enable_ffi = false;                    // expose FFI.open: scripts can then call any native code
     };
 
     // Execution result
@@ -60,19 +72,26 @@ public:
 
 private:
     Config config_;
+    std::unique_ptr<Isolate> isolate_;      // destroyed last: everything below may use it
     std::unique_ptr<Context> global_context_;
     std::unique_ptr<ModuleLoader> module_loader_;
     
     // Core systems
     std::unique_ptr<GarbageCollector> garbage_collector_;
+    std::unique_ptr<OptimizingCompiler> optimizing_compiler_;
     
     // Engine state
     bool initialized_;
+    uint32_t home_node_;
     uint64_t execution_count_;
     
     // ES6 default export registry for direct file execution
     std::unordered_map<std::string, Value> default_exports_registry_;
     
+    // Global scope right after initialize(), restored by reset()
+    Environment::Snapshot global_snapshot_;
+    std::unordered_set<std::string> global_object_keys_;
+    
     // Performance tracking
     std::chrono::high_resolution_clock::time_point start_time_;
     size_t total_allocations_;
@@ -88,6 +107,12 @@ public:
     bool initialize();
     void shutdown();
     bool is_initialized() const { return initialized_; }
+    
+    // Returns the engine to its freshly initialized state for the next task:
+    // globals added or replaced by scripts are dropped and queued tasks are
+    // discarded. Built-in objects keep any changes made to them; garbage is
+    // left to the collector.
+    void reset();
 
     // Script execution
     Result execute(const std::string& source);
@@ -112,6 +137,7 @@ public:
     
     // Context management
     Context* get_global_context() const { return global_context_.get(); }
+    Isolate* get_isolate() const { return isolate_.get(); }
     Context* get_current_context() const;
     
     // Web API interface management
@@ -130,7 +156,16 @@ public:
     void set_jit_threshold(uint32_t threshold);
     std::string get_jit_stats() const;
     
-    // JIT Compiler access
+    // Self-specializing AST node rewrites on this thread
+    std::string get_node_rewrite_stats() const;
+    
+    // JIT Compiler access; null while the JIT is disabled
+    OptimizingCompiler* get_optimizing_compiler() const {
+        return config_.enable_jit ? optimizing_compiler_.get() : nullptr;
+    }
+    
+    // Native calls; takes effect at initialize()
+    void enable_ffi(bool enable);
     
     // Garbage Collection
     void enable_gc(bool enable);
@@ -140,12 +175,14 @@ public:
     
     // Garbage Collector access
     class GarbageCollector* get_garbage_collector() const { return garbage_collector_.get(); }
+    void visit_references(GCVisitor& visitor) const;
     
     // Performance and debugging
     void enable_profiler(bool enable);
     void enable_debugger(bool enable);
     std::string get_performance_stats() const;
     std::string get_memory_stats() const;
+    uint32_t get_home_node() const { return home_node_; }
     
     
     // Error handling
@@ -182,13 +219,10 @@ private:
     
     // Execution helpers
     Result execute_internal(const std::string& source, const std::string& filename);
+    void run_macrotasks();
     
     void handle_exception(const Value& exception);
     
-    // Math loop optimization
-    bool is_simple_mathematical_loop(ASTNode* ast);
-    Result execute_optimized_mathematical_loop(ASTNode* ast);
-    
     // Memory management helpers
     void initialize_gc();
     void schedule_gc_if_needed();
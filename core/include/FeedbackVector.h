@@ -0,0 +1,116 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef QUANTA_FEEDBACK_VECTOR_H
+#define QUANTA_FEEDBACK_VECTOR_H
+
+#include "Value.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Quanta {
+
+class ASTNode;
+class Object;
+class Function;
+class Shape;
+class GCVisitor;
+
+/**
+ * Per-function type feedback
+ * The interpreter records what it sees at each profiled site of a function
+ * body: operand types of binary operations, call targets, the shapes seen
+ * by named property accesses and the element kinds seen by indexed ones.
+ * The optimizing tier reads the vector to decide what to speculate on.
+ *
+ * Sites are numbered once, when the vector is created, by walking the body;
+ * each site node keeps its slot index, so recording is an indexed store.
+ * Nested function bodies are not walked: they get vectors of their own.
+ */
+class FeedbackVector {
+public:
+    enum class SiteKind : uint8_t {
+        BinaryOp,       // a + b, a < b, a += b ...
+        Call,           // f(...), o.m(...)
+        Property,       // o.name (loads and stores)
+        Element         // o[key] (loads and stores)
+    };
+
+    // Operand types seen at a binary operation (bit set)
+    enum TypeBits : uint8_t {
+        TYPE_NONE = 0,
+        TYPE_INT32 = 1 << 0,        // numbers holding an exact int32 value
+        TYPE_DOUBLE = 1 << 1,       // any other number
+        TYPE_STRING = 1 << 2,
+        TYPE_BOOLEAN = 1 << 3,
+        TYPE_OBJECT = 1 << 4,       // objects and functions
+        TYPE_OTHER = 1 << 5         // undefined, null, symbols, bigints
+    };
+    static constexpr uint8_t TYPE_NUMBER = TYPE_INT32 | TYPE_DOUBLE;
+
+    // Element kinds seen at an indexed access (bit set)
+    enum ElementBits : uint8_t {
+        ELEMENTS_NONE = 0,
+        ELEMENTS_PACKED = 1 << 0,   // array receiver, in-bounds int32 index, present element
+        ELEMENTS_HOLEY = 1 << 1,    // array receiver, hole or out of bounds
+        ELEMENTS_GENERIC = 1 << 2   // any other receiver or key
+    };
+
+    // Inline cache state of call and property sites
+    enum class CacheState : uint8_t {
+        Uninitialized,
+        Monomorphic,
+        Megamorphic
+    };
+
+    struct Slot {
+        SiteKind kind;
+        CacheState state = CacheState::Uninitialized;
+        uint8_t left_types = TYPE_NONE;         // BinaryOp
+        uint8_t right_types = TYPE_NONE;        // BinaryOp
+        uint8_t element_kinds = ELEMENTS_NONE;  // Element
+        uint8_t receiver_type = 0;              // Property: Object::ObjectType of the receiver
+        Function* target = nullptr;             // Call
+        Shape* shape = nullptr;                 // Property: receiver shape
+        uint32_t offset = 0;                    // Property: slot in the receiver's shape storage
+
+        explicit Slot(SiteKind k) : kind(k) {}
+    };
+
+private:
+    std::vector<Slot> slots_;
+
+public:
+    // Numbers the sites of a function body and allocates their slots
+    explicit FeedbackVector(ASTNode* body);
+
+    size_t size() const { return slots_.size(); }
+    const Slot& get_slot(uint32_t index) const { return slots_[index]; }
+    bool has_slot(uint32_t index, SiteKind kind) const {
+        return index < slots_.size() && slots_[index].kind == kind;
+    }
+
+    static uint8_t type_of(const Value& value);
+
+    // Recording (called by the interpreter; mismatched slots are ignored)
+    void record_binary_op(uint32_t slot, const Value& left, const Value& right);
+    void record_call(uint32_t slot, Function* target);
+    void record_property(uint32_t slot, Object* receiver, const std::string& key);
+    void record_element(uint32_t slot, Object* receiver, const Value& key);
+    void record_element_generic(uint32_t slot);
+
+    // Keeps recorded call targets alive
+    void visit_references(GCVisitor& visitor) const;
+
+private:
+    void number_sites(ASTNode* node);
+    uint32_t add_slot(SiteKind kind);
+};
+
+} // namespace Quanta
+
+#endif // QUANTA_FEEDBACK_VECTOR_H
@@ -9,7 +9,14 @@
 
 #include "Value.h"
 #include "Object.h"
+#include "GCWorkers.h"
+#include <array>
+#include <atomic>
+#include <unordered_map>
 #include <unordered_set>
+#include <deque>
+#include <condition_variable>
+#include <functional>
 #include <vector>
 #include <memory>
 #include <chrono>
@@ -21,10 +28,12 @@ namespace Quanta {
 // Forward declarations
 class Context;
 class Engine;
+class Environment;
 
 /**
  * Garbage Collector for Quanta JavaScript Engine
- * Implements mark-and-sweep with generational collection
+ * Implements precise mark-and-sweep with generational collection.
+ * Marking drains an explicit worklist and records liveness in object header bits.
  */
 class GarbageCollector {
 public:
@@ -32,7 +41,8 @@ public:
     enum class CollectionMode {
         Manual,         // Manual collection only
         Automatic,      // Automatic collection based on thresholds
-        Incremental     // Incremental collection
+        Incremental,    // Incremental collection
+        Background      // Incremental; a background thread marks and sweeps while the heap is lent
     };
     
     // Object generation for generational GC
@@ -50,25 +60,32 @@ public:
         uint64_t bytes_allocated;
         uint64_t bytes_freed;
         uint64_t peak_memory_usage;
-        std::chrono::duration<double> total_gc_time;
+        uint64_t flattened_slices;                         // sliced strings given their own backing
+        std::chrono::duration<double> total_gc_time;       // pause + background
         std::chrono::duration<double> average_gc_time;
+        std::chrono::duration<double> pause_gc_time;       // spent on the mutator thread
+        std::chrono::duration<double> background_gc_time;  // spent on the background thread
+        uint64_t pause_count;                              // collections, marking slices and swept pages
+        std::chrono::duration<double> max_pause_time;
+        std::chrono::duration<double> p99_pause_time;      // upper bound of the histogram bucket
         
         Statistics() : total_allocations(0), total_deallocations(0), 
                       total_collections(0), bytes_allocated(0), bytes_freed(0),
-                      peak_memory_usage(0), total_gc_time(0), average_gc_time(0) {}
+                      peak_memory_usage(0), flattened_slices(0), total_gc_time(0), average_gc_time(0),
+                      pause_gc_time(0), background_gc_time(0), pause_count(0), max_pause_time(0),
+                      p99_pause_time(0) {}
     };
     
-    // Managed object wrapper
+    // Managed object wrapper (liveness is tracked by the object's header mark bit)
     struct ManagedObject {
         Object* object;
         Generation generation;
-        bool is_marked;
         size_t size;
         std::chrono::high_resolution_clock::time_point allocation_time;
         uint32_t access_count;
         
         ManagedObject(Object* obj, Generation gen, size_t obj_size)
-            : object(obj), generation(gen), is_marked(false), size(obj_size),
+            : object(obj), generation(gen), size(obj_size),
               allocation_time(std::chrono::high_resolution_clock::now()),
               access_count(0) {}
     };
@@ -82,14 +99,24 @@ private:
     double gc_trigger_ratio_;
     
     // Object management
-    std::unordered_set<ManagedObject*> managed_objects_;
+    std::unordered_map<Object*, ManagedObject*> managed_objects_;
+    size_t heap_bytes_;
     std::vector<ManagedObject*> young_generation_;
     std::vector<ManagedObject*> old_generation_;
     std::vector<ManagedObject*> permanent_generation_;
     
     // Root set for marking
     std::vector<Context*> root_contexts_;
-    std::unordered_set<Object*> root_objects_;
+    std::unordered_map<Object*, size_t> root_objects_;   // object -> persistent handle count
+    std::function<void(GCVisitor&)> embedder_roots_;
+    
+    // Temporary roots: handles are pushed by the innermost open HandleScope
+    // and popped when it closes. Collections only run at allocation
+    // safepoints where every live temporary is reachable from a handle.
+    std::vector<Value> handles_;
+    size_t handle_scope_depth_;
+    size_t collection_threshold_;                            // managed bytes that trigger a safepoint collection
+    static thread_local size_t no_gc_depth_;
     
     // Threading
     std::mutex gc_mutex_;
@@ -107,11 +134,80 @@ private:
     bool heavy_operation_mode_;
     size_t emergency_cleanup_threshold_;
     
+    // Marking state: one grey-object deque per participant. Environments are
+    // handed back to the collecting thread and scanned there. They may be
+    // freed by the interpreter between marking slices, so instead of a mark
+    // bit they record the epoch of the last cycle that scanned them.
+    class MarkingVisitor;
+    struct MarkWorker {
+        WorkStealingDeque<Object*> deque;
+        std::vector<Object*> marked_objects;
+        std::vector<Environment*> pending_environments;
+        std::vector<ManagedObject*> swept;
+        std::vector<Object*> weak_containers;
+        std::vector<String*> pinning_slices;
+        uint64_t steal_seed;
+        
+        MarkWorker() : steal_seed(0) {}
+    };
+    std::vector<std::unique_ptr<MarkWorker>> mark_workers_;
+    uint64_t mark_epoch_;                                    // current marking cycle
+    static std::atomic<uint64_t> next_mark_epoch_;           // unique across collectors
+    std::atomic<size_t> idle_workers_;
+    size_t active_workers_;
+    std::atomic<bool> collection_requested_;
+    
+    // Incremental marking: tri-color state lives in the mark bits (white = unmarked,
+    // grey = marked and queued, black = marked and traced). A Dijkstra insertion
+    // barrier greys every reference stored while marking is in progress.
+    // Environments created during a cycle start black; the barrier shades
+    // the outer environment they link to, and every binding they store.
+    std::atomic<bool> incremental_marking_;
+    std::chrono::microseconds incremental_step_budget_;
+    size_t allocations_since_step_;
+    static constexpr size_t INCREMENTAL_STEP_INTERVAL = 64;   // allocations per marking slice
+    static thread_local GarbageCollector* marking_collector_;
+    
+    // Lazy sweeping: the pause only unlinks dead objects into pages; the pages
+    // are freed later by the allocator, or by the background thread while the
+    // heap is lent. Freeing runs destructors (a closure releases its
+    // environment), so it never overlaps running JS.
+    std::deque<std::vector<ManagedObject*>> unswept_pages_;
+    std::atomic<size_t> unswept_page_count_;
+    size_t unswept_bytes_;
+    size_t allocations_since_sweep_;
+    static constexpr size_t LAZY_SWEEP_INTERVAL = 16;        // allocations per page swept
+    
+    // Background marking: the mutator lends the heap while it is blocked and the
+    // background thread drains the grey set and frees swept pages until the
+    // heap is reclaimed. It never overlaps running JS: objects, environments
+    // and their containers are unsynchronized.
+    std::mutex background_mutex_;
+    std::condition_variable background_cv_;
+    bool heap_lent_;
+    bool background_busy_;                                   // a slice or page is in progress
+    static constexpr std::chrono::microseconds BACKGROUND_SLICE{100};
+    
+    // Pause histogram for the p99: bucket i counts pauses shorter than
+    // 2^((i + 1) / 4) microseconds, the last one everything longer
+    static constexpr size_t PAUSE_BUCKETS = 96;
+    std::array<uint64_t, PAUSE_BUCKETS> pause_histogram_;
+    
+    // Persistent helper threads, created on the first collection large enough to use them
+    size_t worker_count_;
+    uint32_t home_node_;                                     // NUMA node of the owning isolate
+    bool pin_threads_;
+    std::unique_ptr<GCWorkerPool> worker_pool_;
+    static constexpr size_t PARALLEL_HEAP_THRESHOLD = 4096;  // managed objects
+    static constexpr size_t SWEEP_PAGE_SIZE = 256;           // managed objects per sweep page
+    
     // Statistics
     Statistics stats_;
     
-    // Weak references
-    std::unordered_set<Object*> weak_references_;
+    // Weak containers (WeakMap, WeakSet, WeakRef, FinalizationRegistry) reached
+    // in the current cycle, and WeakRef targets kept alive until the job ends
+    std::vector<Object*> weak_containers_;
+    std::vector<Object*> kept_objects_;
     
 public:
     GarbageCollector();
@@ -122,6 +218,13 @@ public:
     CollectionMode get_collection_mode() const { return collection_mode_; }
     void set_heap_size_limit(size_t limit) { heap_size_limit_ = limit; }
     void set_gc_trigger_ratio(double ratio) { gc_trigger_ratio_ = ratio; }
+    void set_collection_threshold(size_t bytes) { collection_threshold_ = old_generation_threshold_ = bytes; }
+    void set_worker_count(size_t count);
+    void set_home_node(uint32_t node, bool pin_threads);
+    uint32_t get_home_node() const { return home_node_; }
+    size_t get_worker_count() const { return worker_count_; }
+    void set_incremental_step_budget(std::chrono::microseconds budget) { incremental_step_budget_ = budget; }
+    std::chrono::microseconds get_incremental_step_budget() const { return incremental_step_budget_; }
     
     // Object lifecycle
     void register_object(Object* obj, size_t size = 0);
@@ -132,6 +235,25 @@ public:
     // Root set management
     void add_root_object(Object* obj);
     void remove_root_object(Object* obj);
+    void set_embedder_roots(std::function<void(GCVisitor&)> visitor) { embedder_roots_ = std::move(visitor); }
+    
+    // Handles and safepoints
+    void root_temporary(const Value& value) {
+        if (handle_scope_depth_ != 0 && value.is_object_like()) handles_.push_back(value);
+    }
+    // An async function body runs on a stack of its own, with its own handles;
+    // switching stacks trades the running handles for the parked ones
+    void swap_handles(std::vector<Value>& handles, size_t& depth) {
+        handles_.swap(handles);
+        std::swap(handle_scope_depth_, depth);
+        if (incremental_marking_) {
+            // The parked handles are no longer rescanned as roots
+            for (const Value& handle : handles) write_barrier(handle);
+        }
+    }
+    bool at_safepoint() const;
+    static void enter_no_gc_scope() { ++no_gc_depth_; }
+    static void exit_no_gc_scope() { --no_gc_depth_; }
     
     // Collection triggers
     void collect_garbage();
@@ -139,6 +261,43 @@ public:
     void collect_old_generation();
     void force_full_collection();
     
+    // Incremental marking
+    void start_incremental_marking();
+    bool incremental_step();
+    bool incremental_step(std::chrono::microseconds budget);
+    bool is_incremental_marking() const { return incremental_marking_; }
+    
+    // Background marking and lazy sweeping
+    void lend_heap();
+    void reclaim_heap();
+    void idle(std::chrono::microseconds duration);
+    bool sweep_next_page();
+    void finish_lazy_sweeping();
+    size_t get_unswept_bytes() const { return unswept_bytes_; }
+    
+    // Write barrier, called by mutators before a reference is stored
+    static void write_barrier(const Value& value) {
+        if (marking_collector_ && value.is_object_like()) {
+            marking_collector_->shade(value.as_object());
+        }
+    }
+    static void write_barrier(Object* obj) {
+        if (marking_collector_ && obj) {
+            marking_collector_->shade(obj);
+        }
+    }
+    static void write_barrier(Environment* environment) {
+        if (marking_collector_ && environment) {
+            marking_collector_->shade(environment);
+        }
+    }
+    
+    // Epoch a new environment starts with: the current cycle's while
+    // marking (black), otherwise none
+    static uint64_t environment_epoch() {
+        return marking_collector_ ? marking_collector_->mark_epoch_ : 0;
+    }
+    
     // Ultra-fast collection methods
     void collect_young_generation_ultra_fast();
     void collect_old_generation_ultra_fast();
@@ -146,12 +305,13 @@ public:
     
     // Memory management
     bool should_trigger_gc() const;
+    bool is_collection_requested() const { return collection_requested_; }
     size_t get_heap_size() const;
     size_t get_available_memory() const;
     
     // Weak references
-    void add_weak_reference(Object* obj);
-    void remove_weak_reference(Object* obj);
+    void keep_during_job(Object* obj);
+    void clear_kept_objects();
     
     // Statistics
     const Statistics& get_statistics() const { return stats_; }
@@ -174,15 +334,40 @@ public:
     void verify_heap_integrity() const;
 
 private:
+    bool track_allocation(Object* obj, size_t size);
+    
     // Mark phase
     void mark_objects();
+    void mark_roots();
     void mark_from_context(Context* ctx);
-    void mark_from_object(Object* obj);
-    void mark_object(Object* obj);
+    void mark_object(Object* obj, MarkWorker& worker);
+    void scan_pending_environments();
+    void drain_mark_stack(size_t worker_id);
+    bool drain_mark_stack_until(std::chrono::high_resolution_clock::time_point deadline);
+    void finish_incremental_marking();
+    void shade(Object* obj);
+    void shade(Environment* environment);
+    void begin_mark_epoch();
+    bool steal_work(size_t worker_id, Object*& item);
+    bool has_pending_work() const;
+    void gather_weak_containers();
+    bool trace_ephemerons();
+    bool is_live(Object* obj) const;
+    void clear_marks();
+    bool is_marked(const ManagedObject* managed) const { return managed->object->is_gc_marked(); }
+    
+    // Parallel helpers
+    bool use_parallel_workers() const;
+    void ensure_worker_pool();
+    void prepare_mark_workers(size_t count);
     
     // Sweep phase
     void sweep_objects();
-    void sweep_generation(std::vector<ManagedObject*>& generation);
+    void sweep_generation(std::vector<ManagedObject*>& generation, uint32_t survivor_age = 1);
+    void sweep_page(std::vector<ManagedObject*>& generation, size_t begin, size_t end,
+                    uint32_t survivor_age, MarkWorker& worker);
+    void defer_sweep(std::vector<ManagedObject*>& dead);
+    bool sweep_page_lazily(bool background);
     
     // Generational GC
     void promote_objects();
@@ -195,10 +380,16 @@ private:
     // Helper methods
     ManagedObject* find_managed_object(Object* obj);
     void update_statistics(const std::chrono::high_resolution_clock::time_point& start);
+    void record_pause(std::chrono::duration<double> pause);
     void cleanup_weak_references();
+    void flatten_pinning_slices();
+    
+    friend class HandleScope;
     
-    // Background GC thread
+    // Background GC thread: marking and sweeping while the heap is lent
     void gc_thread_main();
+    void init_gc_thread();
+    bool has_background_work() const;
 
     // PhotonCore collection methods
     void collect_young_generation_photon_core();
@@ -209,18 +400,10 @@ private:
     
     // helper methods
     void mark_objects_ultra_fast();
-    void mark_object_ultra_fast(Object* obj);
-    void sweep_generation_ultra_fast(std::vector<ManagedObject*>& generation);
     void sweep_objects_ultra_fast();
     void promote_objects_ultra_fast();
     void detect_cycles_ultra_fast();
     void break_cycles_ultra_fast();
-    ManagedObject* find_managed_object_ultra_fast(Object* obj);
-    
-    // Parallel worker methods
-    void mark_objects_parallel_worker();
-    void sweep_generation_parallel_worker(std::vector<ManagedObject*>& generation, 
-                                         size_t thread_id, size_t thread_count);
 };
 
 /**
@@ -283,6 +466,138 @@ public:
     }
 };
 
+/**
+ * Stack-allocated scope for temporary roots
+ * Native code and the interpreter open one around work that holds objects in
+ * C++ locals; every handle created inside it stays rooted until it closes.
+ */
+class HandleScope {
+private:
+    GarbageCollector* gc_;
+    size_t base_;
+
+public:
+    explicit HandleScope(GarbageCollector* gc) : gc_(gc), base_(0) {
+        if (gc_) {
+            base_ = gc_->handles_.size();
+            gc_->handle_scope_depth_++;
+        }
+    }
+    
+    ~HandleScope() {
+        if (gc_) {
+            gc_->handles_.resize(base_);
+            gc_->handle_scope_depth_--;
+        }
+    }
+    
+    HandleScope(const HandleScope&) = delete;
+    HandleScope& operator=(const HandleScope&) = delete;
+    
+    GarbageCollector* get_garbage_collector() const { return gc_; }
+};
+
+/**
+ * Handle to an object rooted by the enclosing HandleScope
+ * The collector does not move objects, so a Local is a plain pointer whose
+ * referent is kept alive by the handle slot pushed when it was created.
+ */
+template<typename T>
+class Local {
+private:
+    T* ptr_;
+
+public:
+    Local() : ptr_(nullptr) {}
+    Local(HandleScope& scope, T* ptr) : ptr_(ptr) {
+        if (ptr_ && scope.get_garbage_collector()) {
+            scope.get_garbage_collector()->root_temporary(Value(static_cast<Object*>(ptr_)));
+        }
+    }
+    
+    // Access operators
+    T* operator->() const { return ptr_; }
+    T& operator*() const { return *ptr_; }
+    T* get() const { return ptr_; }
+    
+    // Conversion
+    explicit operator bool() const { return ptr_ != nullptr; }
+};
+
+/**
+ * Handle that roots an object until it is reset or destroyed
+ * For references held by native code beyond a single HandleScope.
+ */
+template<typename T>
+class Persistent {
+private:
+    T* ptr_;
+    GarbageCollector* gc_;
+
+public:
+    Persistent() : ptr_(nullptr), gc_(nullptr) {}
+    Persistent(GarbageCollector* gc, T* ptr) : ptr_(nullptr), gc_(nullptr) { reset(gc, ptr); }
+    ~Persistent() { reset(); }
+    
+    Persistent(Persistent&& other) noexcept : ptr_(other.ptr_), gc_(other.gc_) {
+        other.ptr_ = nullptr;
+        other.gc_ = nullptr;
+    }
+    
+    Persistent& operator=(Persistent&& other) noexcept {
+        if (this != &other) {
+            reset();
+            ptr_ = other.ptr_;
+            gc_ = other.gc_;
+            other.ptr_ = nullptr;
+            other.gc_ = nullptr;
+        }
+        return *this;
+    }
+    
+    Persistent(const Persistent&) = delete;
+    Persistent& operator=(const Persistent&) = delete;
+    
+    void reset() {
+        if (ptr_ && gc_) {
+            gc_->remove_root_object(ptr_);
+        }
+        ptr_ = nullptr;
+        gc_ = nullptr;
+    }
+    
+    void reset(GarbageCollector* gc, T* ptr) {
+        reset();
+        ptr_ = ptr;
+        gc_ = gc;
+        if (ptr_ && gc_) {
+            gc_->add_root_object(ptr_);
+        }
+    }
+    
+    // Access operators
+    T* operator->() const { return ptr_; }
+    T& operator*() const { return *ptr_; }
+    T* get() const { return ptr_; }
+    
+    // Conversion
+    explicit operator bool() const { return ptr_ != nullptr; }
+};
+
+/**
+ * Disables safepoint collections while alive
+ * Native functions run inside one: they keep Values in containers the
+ * collector cannot see, so collections wait until control is back in the interpreter.
+ */
+class DisallowGCScope {
+public:
+    DisallowGCScope() { GarbageCollector::enter_no_gc_scope(); }
+    ~DisallowGCScope() { GarbageCollector::exit_no_gc_scope(); }
+    
+    DisallowGCScope(const DisallowGCScope&) = delete;
+    DisallowGCScope& operator=(const DisallowGCScope&) = delete;
+};
+
 /**
  * Memory pool for efficient allocation
  */
@@ -0,0 +1,170 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef QUANTA_GC_WORKERS_H
+#define QUANTA_GC_WORKERS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Quanta {
+
+/**
+ * Chase-Lev work-stealing deque
+ * The owning thread pushes and pops at the bottom; other threads steal from the top.
+ * Buffers retired by growth are kept until destruction because thieves may still read them.
+ */
+template<typename T>
+class WorkStealingDeque {
+private:
+    struct Buffer {
+        int64_t capacity;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Buffer(int64_t cap) : capacity(cap), slots(new std::atomic<T>[cap]) {}
+
+        T get(int64_t index) const { return slots[index & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(int64_t index, T value) { slots[index & (capacity - 1)].store(value, std::memory_order_relaxed); }
+
+        Buffer* grow(int64_t bottom, int64_t top) const {
+            Buffer* bigger = new Buffer(capacity * 2);
+            for (int64_t i = top; i < bottom; ++i) {
+                bigger->put(i, get(i));
+            }
+            return bigger;
+        }
+    };
+
+    alignas(64) std::atomic<int64_t> top_;
+    alignas(64) std::atomic<int64_t> bottom_;
+    std::atomic<Buffer*> buffer_;
+    std::vector<std::unique_ptr<Buffer>> retired_;
+
+public:
+    explicit WorkStealingDeque(int64_t initial_capacity = 1024)
+        : top_(0), bottom_(0), buffer_(new Buffer(initial_capacity)) {}
+
+    ~WorkStealingDeque() { delete buffer_.load(std::memory_order_relaxed); }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only
+    void push(T value) {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_acquire);
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+
+        if (bottom - top > buffer->capacity - 1) {
+            Buffer* bigger = buffer->grow(bottom, top);
+            retired_.emplace_back(buffer);
+            buffer_.store(bigger, std::memory_order_release);
+            buffer = bigger;
+        }
+
+        buffer->put(bottom, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only
+    bool pop(T& out) {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        out = buffer->get(bottom);
+        if (top == bottom) {
+            // Last element: race against thieves for it
+            bool won = top_.compare_exchange_strong(top, top + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread
+    bool steal(T& out) {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+        if (top >= bottom) {
+            return false;
+        }
+
+        Buffer* buffer = buffer_.load(std::memory_order_acquire);
+        T value = buffer->get(top);
+        if (!top_.compare_exchange_strong(top, top + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return false;
+        }
+        out = value;
+        return true;
+    }
+
+    bool empty() const {
+        return bottom_.load(std::memory_order_acquire) <= top_.load(std::memory_order_acquire);
+    }
+};
+
+/**
+ * Persistent pool of GC helper threads
+ * Threads are created once and parked between collections; run() hands every
+ * participant the same task and returns when all of them have finished.
+ * The calling thread participates as worker 0.
+ */
+class GCWorkerPool {
+public:
+    using Task = std::function<void(size_t worker_id)>;
+    using ThreadInit = std::function<void()>;
+
+private:
+    size_t worker_count_;
+    ThreadInit thread_init_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const Task* task_;
+    uint64_t generation_;
+    size_t pending_;
+    bool stopping_;
+
+public:
+    explicit GCWorkerPool(size_t worker_count, ThreadInit thread_init = nullptr);
+    ~GCWorkerPool();
+
+    GCWorkerPool(const GCWorkerPool&) = delete;
+    GCWorkerPool& operator=(const GCWorkerPool&) = delete;
+
+    size_t size() const { return worker_count_; }
+    void run(const Task& task);
+
+    static size_t default_worker_count();
+
+private:
+    void worker_main(size_t worker_id);
+};
+
+} // namespace Quanta
+
+#endif // QUANTA_GC_WORKERS_H
@@ -86,6 +86,9 @@ public:
     // Iterator protocol
     Value get_iterator();
     
+    // Memory management
+    void visit_references(GCVisitor& visitor) const override;
+    
     // Generator built-in methods
     static Value generator_next(Context& ctx, const std::vector<Value>& args);
     static Value generator_return(Context& ctx, const std::vector<Value>& args);
@@ -0,0 +1,140 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef QUANTA_HEAP_ARENA_H
+#define QUANTA_HEAP_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace Quanta {
+
+/**
+ * NUMA node-local allocation arena for heap objects
+ * Object storage is carved from aligned chunks whose pages are bound to one
+ * node (or interleaved across all nodes); freed objects go back to per-size
+ * free lists in the chunk's own arena, so recycled memory never migrates to
+ * another node. Only threads bound to an arena use one; everything else goes
+ * to the global heap, and frees tell the two apart through a chunk map.
+ *
+ * Arenas live for the whole process: objects may outlive the engine that
+ * allocated them (built-in prototypes are shared through statics).
+ */
+class HeapArena {
+public:
+    enum class Placement {
+        Local,          // pages preferred on one node
+        Interleaved     // pages round-robin across all nodes
+    };
+
+    static constexpr size_t CHUNK_SIZE = 1024 * 1024;
+    static constexpr size_t GRANULE = 16;
+    static constexpr size_t MAX_SMALL_SIZE = 1024;           // larger objects use the global heap
+    static constexpr uint32_t ANY_NODE = UINT32_MAX;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct ChunkHeader {
+        HeapArena* arena;
+    };
+    static constexpr size_t CHUNK_HEADER_SIZE = 64;
+    static constexpr size_t SIZE_CLASS_COUNT = MAX_SMALL_SIZE / GRANULE;
+
+    // Two-level bitmap over 48-bit addresses: one bit per chunk
+    static constexpr unsigned CHUNK_SHIFT = 20;
+    static constexpr unsigned LEAF_BITS = 14;
+    static constexpr size_t ROOT_SIZE = size_t(1) << (48 - CHUNK_SHIFT - LEAF_BITS);
+    static constexpr size_t LEAF_WORDS = (size_t(1) << LEAF_BITS) / 64;
+    static std::atomic<std::atomic<uint64_t>*> chunk_map_[ROOT_SIZE];
+
+    Placement placement_;
+    uint32_t node_;
+
+    // Frees from the background sweeper are the only contention
+    std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+    FreeBlock* free_lists_[SIZE_CLASS_COUNT];
+    char* bump_;
+    char* bump_end_;
+    std::vector<void*> chunks_;
+
+    std::atomic<size_t> allocated_bytes_;
+    std::atomic<size_t> reserved_bytes_;
+
+    static thread_local HeapArena* current_;
+
+public:
+    HeapArena(Placement placement, uint32_t node);
+    ~HeapArena() = default;
+
+    HeapArena(const HeapArena&) = delete;
+    HeapArena& operator=(const HeapArena&) = delete;
+
+    // Object storage: small sizes come from the calling thread's arena, if any
+    static void* allocate(size_t size) {
+        if (!current_ || size > MAX_SMALL_SIZE) return ::operator new(size);
+        return current_->allocate_small(size_class_of(size));
+    }
+    static void deallocate(void* ptr, size_t size) {
+        if (size <= MAX_SMALL_SIZE && is_arena_chunk(ptr)) {
+            free_to_owner(ptr, size);
+        } else {
+            ::operator delete(ptr);
+        }
+    }
+
+    // Arena selection
+    static HeapArena& for_node(uint32_t node);
+    static HeapArena& interleaved();
+    static HeapArena& create_local(uint32_t node);   // uncontended arena for one thread; never destroyed
+    static HeapArena* current() { return current_; }
+    static void bind_current_thread(HeapArena* arena) { current_ = arena; }
+
+    // Topology
+    static uint32_t node_count();
+    static uint32_t current_node();
+    static bool pin_current_thread(uint32_t node);
+
+    // Per-node statistics (bytes of live small objects, reserved chunk bytes),
+    // covering the shared node arenas and every local arena on the node
+    static std::vector<size_t> node_allocated_bytes();
+    static std::vector<size_t> node_reserved_bytes();
+
+    Placement get_placement() const { return placement_; }
+    uint32_t get_node() const { return node_; }
+    size_t get_allocated_bytes() const { return allocated_bytes_.load(std::memory_order_relaxed); }
+    size_t get_reserved_bytes() const { return reserved_bytes_.load(std::memory_order_relaxed); }
+
+private:
+    void* allocate_small(size_t size_class);
+    void free_small(void* ptr, size_t size_class);
+    bool refill();
+    void* map_chunk();
+    void lock() { while (lock_.test_and_set(std::memory_order_acquire)) std::this_thread::yield(); }
+    void unlock() { lock_.clear(std::memory_order_release); }
+
+    static void free_to_owner(void* ptr, size_t size);
+    static void register_chunk(void* chunk);
+    static bool is_arena_chunk(const void* ptr) {
+        uintptr_t index = reinterpret_cast<uintptr_t>(ptr) >> CHUNK_SHIFT;
+        if ((index >> LEAF_BITS) >= ROOT_SIZE) return false;
+        std::atomic<uint64_t>* leaf = chunk_map_[index >> LEAF_BITS].load(std::memory_order_acquire);
+        if (!leaf) return false;
+        size_t bit = index & ((size_t(1) << LEAF_BITS) - 1);
+        return leaf[bit / 64].load(std::memory_order_relaxed) & (uint64_t(1) << (bit % 64));
+    }
+    static size_t size_class_of(size_t size) { return size == 0 ? 0 : (size + GRANULE - 1) / GRANULE - 1; }
+};
+
+} // namespace Quanta
+
+#endif // QUANTA_HEAP_ARENA_H
@@ -0,0 +1,111 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef QUANTA_ISOLATE_H
+#define QUANTA_ISOLATE_H
+
+#include "Object.h"
+#include "Async.h"
+#include "CallStack.h"
+#include "HeapArena.h"
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace Quanta {
+
+/**
+ * Per-engine runtime state
+ * Everything the interpreter used to keep in process-wide singletons and
+ * statics (event loop, call stack, shape transitions, built-in prototypes,
+ * Math.random state, timer ids) lives here, so engines on different threads
+ * never share mutable state. Each Engine owns one isolate and enters it for
+ * every call into script; code running outside any engine gets a private
+ * per-thread default isolate.
+ *
+ * An isolate may be entered by only one thread at a time.
+ */
+class Isolate {
+public:
+    // Built-in prototypes that native constructors attach without a global lookup
+    struct Prototypes {
+        Object* array = nullptr;
+        Object* string = nullptr;   // looked up for string primitives
+        Object* number = nullptr;   // looked up for number primitives
+        Object* map = nullptr;
+        Object* set = nullptr;
+        Object* weak_map = nullptr;
+        Object* weak_set = nullptr;
+        Object* weak_ref = nullptr;
+        Object* finalization_registry = nullptr;
+        Object* promise = nullptr;
+        Object* data_view = nullptr;
+    };
+
+    using ShapeTransitionMap = std::unordered_map<std::pair<Shape*, std::string>, Shape*, Object::ShapeTransitionHash>;
+
+    /**
+     * Enters an isolate for the current thread and restores the previous one on exit
+     */
+    class Scope {
+    private:
+        Isolate* previous_;
+        HeapArena* previous_arena_;
+
+    public:
+        explicit Scope(Isolate* isolate);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+private:
+    EventLoop event_loop_;
+    CallStack call_stack_;
+    ShapeTransitionMap shape_transitions_;
+    std::unordered_map<std::string, String*> literal_strings_;
+    Prototypes prototypes_;
+    std::mt19937_64 random_engine_;
+    int next_timer_id_;
+    HeapArena* arena_;
+
+    static thread_local Isolate* current_;
+
+public:
+    Isolate();
+    ~Isolate() = default;
+
+    Isolate(const Isolate&) = delete;
+    Isolate& operator=(const Isolate&) = delete;
+
+    // The isolate entered on this thread, or the thread's default isolate
+    static Isolate& current();
+    static bool has_current() { return current_ != nullptr; }
+
+    EventLoop& event_loop() { return event_loop_; }
+    CallStack& call_stack() { return call_stack_; }
+    ShapeTransitionMap& shape_transitions() { return shape_transitions_; }
+    Prototypes& prototypes() { return prototypes_; }
+    
+    // The string cell shared by every source literal with this text; string
+    // cells are never freed, so the literal nodes holding it can too
+    String* intern_literal(const std::string& text);
+    std::mt19937_64& random_engine() { return random_engine_; }
+    int next_timer_id() { return next_timer_id_++; }
+
+    // Arena bound to the thread while the isolate is entered (null = leave as is)
+    HeapArena* get_arena() const { return arena_; }
+    void set_arena(HeapArena* arena) { arena_ = arena; }
+
+    // Drops queued tasks and stack frames left behind by an aborted script
+    void reset();
+};
+
+} // namespace Quanta
+
+#endif // QUANTA_ISOLATE_H
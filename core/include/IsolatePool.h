@@ -0,0 +1,199 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef QUANTA_ISOLATE_POOL_H
+#define QUANTA_ISOLATE_POOL_H
+
+#include "Engine.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Quanta {
+
+/**
+ * Bounded multi-producer multi-consumer queue (Vyukov)
+ * Every slot carries a sequence number that says whose turn it is, so
+ * producers and consumers each claim a position with one CAS and never block.
+ */
+template<typename T>
+class BoundedTaskQueue {
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> enqueue_pos_;
+    alignas(64) std::atomic<size_t> dequeue_pos_;
+
+public:
+    explicit BoundedTaskQueue(size_t capacity) : enqueue_pos_(0), dequeue_pos_(0) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        slots_.reset(new Slot[size]);
+        mask_ = size - 1;
+        for (size_t i = 0; i < size; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedTaskQueue(const BoundedTaskQueue&) = delete;
+    BoundedTaskQueue& operator=(const BoundedTaskQueue&) = delete;
+
+    bool try_push(T&& value) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[pos & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& out) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[pos & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(slot.value);
+                    slot.value = T();
+                    slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Approximate: a claimed slot may still be being written
+    bool empty() const {
+        return dequeue_pos_.load(std::memory_order_acquire) >= enqueue_pos_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+};
+
+/**
+ * Pool of pre-warmed engines for running many scripts concurrently
+ * Each worker thread owns one engine (and so one isolate) for its whole
+ * life: the engine is created and initialized on that thread before the
+ * pool accepts work, and reset() between tasks instead of rebuilt. Tasks
+ * are dispatched through a lock-free queue; idle workers spin briefly and
+ * then park. With spread_across_nodes each isolate is homed on a NUMA node
+ * in turn, pinned there and given a private arena on that node.
+ */
+class IsolatePool {
+public:
+    using Task = std::function<void(Engine&)>;
+
+    struct Config {
+        size_t isolates = 0;                // 0 = one per hardware thread
+        size_t queue_capacity = 4096;       // rounded up to a power of two
+        bool reset_between_tasks = true;
+        size_t recycle_after = 0;           // rebuild an engine after this many tasks (0 = never)
+        bool spread_across_nodes = false;   // home isolate i on node i % nodes
+        Engine::Config engine;              // gc_worker_threads 0 means 1 here: isolates already use every core
+    };
+
+    struct Statistics {
+        uint64_t submitted = 0;
+        uint64_t completed = 0;
+        uint64_t failed = 0;                // tasks that threw
+        uint64_t recycled = 0;              // engines rebuilt
+        uint64_t parks = 0;                 // times a worker went to sleep
+    };
+
+private:
+    struct Worker {
+        std::thread thread;
+        uint32_t home_node = HeapArena::ANY_NODE;
+        HeapArena* arena = nullptr;         // private to this worker's isolates
+        uint64_t tasks_run = 0;
+    };
+
+    Config config_;
+    BoundedTaskQueue<Task> queue_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    // Parking; producers only touch the mutex when someone is asleep
+    std::mutex park_mutex_;
+    std::condition_variable work_cv_;
+    std::atomic<size_t> sleepers_;
+    std::atomic<bool> stopping_;
+
+    // Start-up and idle tracking
+    std::mutex state_mutex_;
+    std::condition_variable state_cv_;
+    size_t ready_workers_;
+    std::atomic<uint64_t> pending_;
+
+    std::atomic<uint64_t> submitted_;
+    std::atomic<uint64_t> completed_;
+    std::atomic<uint64_t> failed_;
+    std::atomic<uint64_t> recycled_;
+    std::atomic<uint64_t> parks_;
+
+    static constexpr int SPIN_ITERATIONS = 256;
+
+public:
+    explicit IsolatePool(const Config& config);
+    ~IsolatePool();
+
+    IsolatePool(const IsolatePool&) = delete;
+    IsolatePool& operator=(const IsolatePool&) = delete;
+
+    // Task submission; the task runs on some worker with that worker's engine
+    bool try_submit(Task task);     // false when the queue is full
+    void submit(Task task);         // waits for space
+    // Result values belong to the worker's engine: read primitives from them,
+    // objects are only valid until the engine's next task
+    std::future<Engine::Result> execute(const std::string& source, const std::string& filename = "<pool>");
+
+    // Blocks until every submitted task has finished
+    void wait_idle();
+
+    // Finishes queued tasks and joins the workers; called by the destructor
+    void shutdown();
+
+    size_t size() const { return workers_.size(); }
+    Statistics get_statistics() const;
+
+private:
+    void worker_main(Worker* worker);
+    std::unique_ptr<Engine> create_engine(Worker* worker);
+    bool next_task(Task& task);
+    void wake_worker();
+};
+
+} // namespace Quanta
+
+#endif // QUANTA_ISOLATE_POOL_H
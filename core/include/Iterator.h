@@ -84,6 +84,9 @@ public:
     static std::unique_ptr<ArrayIterator> create_values_iterator(Object* array);
     static std::unique_ptr<ArrayIterator> create_entries_iterator(Object* array);
     
+    // Memory management
+    void visit_references(GCVisitor& visitor) const override;
+    
 private:
     IteratorResult next_impl();
 };
@@ -136,6 +139,9 @@ public:
     // Static method for JavaScript next function
     static Value map_iterator_next_method(Context& ctx, const std::vector<Value>& args);
     
+    // Memory management
+    void visit_references(GCVisitor& visitor) const override;
+    
 private:
     IteratorResult next_impl();
 };
@@ -165,6 +171,9 @@ public:
     // Static method for JavaScript next function
     static Value set_iterator_next_method(Context& ctx, const std::vector<Value>& args);
     
+    // Memory management
+    void visit_references(GCVisitor& visitor) const override;
+    
 private:
     IteratorResult next_impl();
 };
@@ -64,6 +64,9 @@ public:
     // Override get_property to handle size property
     Value get_property(const std::string& key) const override;
     
+    // Memory management
+    void visit_references(GCVisitor& visitor) const override;
+    
     // Iterator support
     std::vector<Value> keys() const;
     std::vector<Value> values() const;
@@ -86,9 +89,6 @@ public:
     // Setup Map prototype
     static void setup_map_prototype(Context& ctx);
     
-    // Static prototype reference
-    static Object* prototype_object;
-    
 private:
     std::vector<MapEntry>::iterator find_entry(const Value& key);
     std::vector<MapEntry>::const_iterator find_entry(const Value& key) const;
@@ -120,6 +120,9 @@ public:
     // Override get_property to handle size property
     Value get_property(const std::string& key) const override;
     
+    // Memory management
+    void visit_references(GCVisitor& visitor) const override;
+    
     // Iterator support
     std::vector<Value> values() const;
     std::vector<std::pair<Value, Value>> entries() const; // [value, value] pairs
@@ -140,9 +143,6 @@ public:
     // Setup Set prototype
     static void setup_set_prototype(Context& ctx);
     
-    // Static prototype reference
-    static Object* prototype_object;
-    
 private:
     std::vector<Value>::iterator find_value(const Value& value);
     std::vector<Value>::const_iterator find_value(const Value& value) const;
@@ -166,6 +166,12 @@ public:
     void set(Object* key, const Value& value);
     bool delete_key(Object* key);
     
+    // Memory management: entries are ephemerons, so a value is kept alive
+    // only while its key is reachable from elsewhere
+    void visit_references(GCVisitor& visitor) const override;
+    void trace_ephemerons(GCVisitor& visitor, const std::function<bool(Object*)>& is_live) const override;
+    void clear_dead_references(const std::function<bool(Object*)>& is_live) override;
+    
     // WeakMap built-in methods
     static Value weakmap_constructor(Context& ctx, const std::vector<Value>& args);
     static Value weakmap_set(Context& ctx, const std::vector<Value>& args);
@@ -175,9 +181,6 @@ public:
     
     // Setup WeakMap prototype
     static void setup_weakmap_prototype(Context& ctx);
-    
-    // Static prototype reference
-    static Object* prototype_object;
 };
 
 /**
@@ -197,6 +200,10 @@ public:
     void add(Object* value);
     bool delete_value(Object* value);
     
+    // Memory management (values are held weakly)
+    void visit_references(GCVisitor& visitor) const override;
+    void clear_dead_references(const std::function<bool(Object*)>& is_live) override;
+    
     // WeakSet built-in methods
     static Value weakset_constructor(Context& ctx, const std::vector<Value>& args);
     static Value weakset_add(Context& ctx, const std::vector<Value>& args);
@@ -205,9 +212,6 @@ public:
     
     // Setup WeakSet prototype
     static void setup_weakset_prototype(Context& ctx);
-    
-    // Static prototype reference
-    static Object* prototype_object;
 };
 
 } // namespace Quanta
\ No newline at end of file
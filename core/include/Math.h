@@ -82,10 +82,6 @@ private:
     static double safe_to_number(const Value& value);
     static bool is_finite_number(double value);
     static bool is_integer(double value);
-    
-    // Random number generation
-    static bool random_initialized_;
-    static void initialize_random();
 };
 
 } // namespace Quanta
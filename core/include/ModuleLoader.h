@@ -19,6 +19,7 @@ namespace Quanta {
 class Engine;
 class Context;
 class ASTNode;
+class GCVisitor;
 
 /**
  * Represents a loaded module with its exports and metadata
@@ -51,6 +52,9 @@ public:
     // Module context
     void set_context(std::unique_ptr<Context> context);
     Context* get_context() const { return module_context_.get(); }
+    
+    // Memory management
+    void visit_references(GCVisitor& visitor) const;
 
     // Loading state
     void set_loaded(bool loaded) { loaded_ = loaded; }
@@ -87,6 +91,9 @@ public:
 
     // Built-in modules
     void register_builtin_module(const std::string& module_id, std::unique_ptr<Module> module);
+    
+    // Memory management
+    void visit_references(GCVisitor& visitor) const;
 
 private:
     // Internal helpers
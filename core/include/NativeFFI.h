@@ -13,6 +13,8 @@
 #include <functional>
 #include <cstdint>
 #include <mutex>
+#include <thread>
+#include <atomic>
 
 namespace Quanta {
 
@@ -98,6 +100,67 @@ struct FFISignature {
     std::string to_string() const;
     bool matches(const std::vector<Value>& args) const;
     size_t get_stack_size() const;
+    
+    // Hash of the return and parameter types; name and convention are not part
+    // of it, so every function of the same shape shares one call stub
+    uint64_t hash() const;
+    bool same_shape(const FFISignature& other) const;
+};
+
+//=============================================================================
+// FFI Call Stubs
+//=============================================================================
+
+// Where a call stub leaves the callee's return registers
+struct FFICallResult {
+    uint64_t integer;   // rax
+    double floating;    // xmm0
+};
+
+/**
+ * Machine code that calls native functions of one signature
+ *
+ * Generated for the x86-64 System V ABI. The stub is entered as
+ *
+ *     void stub(void* target, const uint64_t* slots, FFICallResult* result)
+ *
+ * where slots holds one raw 64-bit value per parameter, already converted by
+ * FFIMarshaler::to_slot. Integer-class parameters are loaded into rdi, rsi,
+ * rdx, rcx, r8 and r9, float-class ones into xmm0-xmm7, and the rest are
+ * pushed in reverse order; al carries the vector register count for variadic
+ * callees. Which slot goes where is decided once, when the stub is generated,
+ * so a call does no per-argument dispatch beyond the conversion itself.
+ *
+ * Struct and array parameters passed by value are not supported.
+ */
+class FFICallStub {
+public:
+    using Entry = void (*)(void* target, const uint64_t* slots, FFICallResult* result);
+    
+    static constexpr size_t MAX_PARAMETERS = 32;
+    
+    ~FFICallStub();
+    FFICallStub(const FFICallStub&) = delete;
+    FFICallStub& operator=(const FFICallStub&) = delete;
+    
+    // Null when the platform or the signature is not supported
+    static std::unique_ptr<FFICallStub> generate(const FFISignature& signature);
+    static bool is_supported(const FFISignature& signature);
+    
+    void invoke(void* target, const uint64_t* slots, FFICallResult* result) const {
+        entry_(target, slots, result);
+    }
+    
+    const FFISignature& get_signature() const { return signature_; }
+    size_t get_code_size() const { return code_size_; }
+
+private:
+    FFICallStub(const FFISignature& signature, void* code, size_t code_size);
+    
+    FFISignature signature_;
+    void* code_;
+    size_t code_size_;
+    Entry entry_;
 };
 
 //=============================================================================
@@ -196,6 +259,13 @@ public:
     // Type conversion utilities
     static bool can_convert_to_native(const Value& js_value, const FFITypeInfo& type_info);
     static bool can_convert_from_native(const FFITypeInfo& type_info);
+    
+    // Call stub argument and return conversion. Pointer parameters take an
+    // ArrayBuffer, TypedArray or DataView and receive its backing store
+    // (offset to the view) without copying, or a number holding an address.
+    // to_slot returns false when the value cannot be passed as the type.
+    static bool to_slot(const Value& js_value, const FFITypeInfo& type_info, uint64_t& slot);
+    static Value from_result(const FFICallResult& result, const FFITypeInfo& type_info);
 
 private:
     void write_to_buffer(const void* data, size_t size);
@@ -219,51 +289,40 @@ private:
 
 class FFICallDispatcher {
 private:
-    // Platform-specific calling convention handlers
-    std::unordered_map<std::string, std::function<Value(void*, const FFISignature&, const std::vector<Value>&, Context*)>> convention_handlers_;
-    
-    // Call optimization
-    struct CallCache {
-        void* function_pointer;
-        FFISignature signature;
-        std::unique_ptr<FFIMarshaler> marshaler;
-        uint64_t call_count;
-        uint64_t total_time_ns;
-    };
-    
-    std::unordered_map<std::string, std::unique_ptr<CallCache>> call_cache_;
+    // Generated stubs by signature hash; a bucket holds more than one stub
+    // only when different shapes collide
+    std::unordered_map<uint64_t, std::vector<std::shared_ptr<const FFICallStub>>> stubs_;
     mutable std::mutex cache_mutex_;
+    
+    uint64_t cache_hits_;
+    uint64_t cache_misses_;
 
 public:
     FFICallDispatcher();
     ~FFICallDispatcher();
     
+    // The stub for a signature, generated on first use and cached. Bindings
+    // look their stub up once and hold a reference, so the cache lock is not
+    // taken per call and clearing the cache never frees a stub in use. Null
+    // if the signature is unsupported.
+    std::shared_ptr<const FFICallStub> get_stub(const FFISignature& signature);
+    
+    // Marshals args straight into stack slots, calls through the stub and
+    // converts the return value; throws std::runtime_error on a bad argument
+    static Value invoke(const FFICallStub& stub, void* func_ptr, const Value* args, size_t arg_count);
+    
     // Call dispatch
     Value dispatch_call(void* func_ptr, const FFISignature& signature, const std::vector<Value>& args, Context* context);
     
-    // Calling convention support
-    void register_calling_convention(const std::string& name, 
-        std::function<Value(void*, const FFISignature&, const std::vector<Value>&, Context*)> handler);
-    bool supports_calling_convention(const std::string& convention) const;
-    
     // Call optimization
-    void cache_function_call(const std::string& name, void* func_ptr, const FFISignature& signature);
     void clear_call_cache();
-    void optimize_hot_calls();
     
     // Performance monitoring
     void print_call_statistics() const;
     double get_cache_hit_ratio() const;
-
-private:
-    // Platform-specific implementations
-    Value call_cdecl(void* func_ptr, const FFISignature& signature, const std::vector<Value>& args, Context* context);
-    Value call_stdcall(void* func_ptr, const FFISignature& signature, const std::vector<Value>& args, Context* context);
-    Value call_fastcall(void* func_ptr, const FFISignature& signature, const std::vector<Value>& args, Context* context);
-    
-    // Assembly call helpers
-    Value invoke_native_function(void* func_ptr, void* args, size_t stack_size, const FFITypeInfo& return_type, Context* context);
-    void setup_call_stack(void* args, const std::vector<Value>& js_args, const FFISignature& signature);
+    size_t get_stub_count() const;
+    
+    static FFICallDispatcher& get_instance();
 };
 
 //=============================================================================
@@ -357,6 +416,9 @@ private:
 //=============================================================================
 
 namespace FFIHelpers {
+    // Type names as scripts write them: "int32", "double", "pointer", ...
+    bool parse_type(const std::string& name, FFIType& type);
+    
     // Type information helpers
     template<typename T> FFITypeInfo get_ffi_type();
     template<typename T> FFIType get_ffi_type_enum();
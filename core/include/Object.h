@@ -8,6 +8,8 @@
 #define QUANTA_OBJECT_H
 
 #include "Value.h"
+#include "HeapArena.h"
+#include <atomic>
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -23,6 +25,39 @@ class Shape;
 class Context;
 class ASTNode;
 class Parameter;
+class Environment;
+class Object;
+class FeedbackVector;
+class OptimizedCode;
+class LineTable;
+
+/**
+ * Reference visitor used by the garbage collector to trace the heap
+ * Each heap type reports its outgoing edges through visit_references()
+ */
+class GCVisitor {
+public:
+    virtual ~GCVisitor() = default;
+
+    virtual void visit(Object* object) = 0;
+    virtual void visit(Environment* environment) = 0;
+
+    void visit(const Value& value) {
+        if (value.is_object_like()) {
+            visit(value.as_object());
+        } else if (value.is_string()) {
+            visit_string(value.as_string());
+        }
+    }
+    
+    // Strings are not traced; the collector is shown them so it can flatten
+    // slices that pin a large backing (see String::pins_backing)
+    virtual void visit_string(String* string) { (void)string; }
+    
+    // Weak containers report themselves here instead of tracing what they
+    // hold weakly; the collector processes them once marking has finished
+    virtual void visit_weak_container(Object* container) { (void)container; }
+};
 
 /**
  * High-performance JavaScript object implementation
@@ -52,6 +87,8 @@ public:
         Set,            // Set object
         WeakMap,        // WeakMap object
         WeakSet,        // WeakSet object
+        WeakRef,        // WeakRef object
+        FinalizationRegistry, // FinalizationRegistry object
         ArrayBuffer,    // ArrayBuffer object
         TypedArray,     // TypedArray variants
         DataView,       // DataView object
@@ -62,6 +99,11 @@ public:
 
 
 private:
+    // Header flag bits
+    static constexpr uint8_t NON_EXTENSIBLE_FLAG = 0x01;
+    static constexpr uint8_t GC_MARK_FLAG = 0x02;
+    static constexpr uint8_t SLOW_SYMBOL_KEYS_FLAG = 0x04;  // a symbol key lives outside the shape
+
     // Object header for efficient memory layout
     struct ObjectHeader {
         Shape* shape;               // Hidden class for property layout
@@ -90,6 +132,10 @@ public:
     Object(ObjectType type = ObjectType::Ordinary);
     explicit Object(Object* prototype, ObjectType type = ObjectType::Ordinary);
     virtual ~Object() = default;
+    
+    // Object storage comes from the calling thread's node-local arena
+    static void* operator new(size_t size) { return HeapArena::allocate(size); }
+    static void operator delete(void* ptr, size_t size) { HeapArena::deallocate(ptr, size); }
 
     // Copy and move semantics
     Object(const Object& other) = delete;            // Objects are not copyable
@@ -138,8 +184,9 @@ public:
     bool set_element(uint32_t index, const Value& value);
     bool delete_element(uint32_t index);
     
-    // Property enumeration
+    // Property enumeration (string keys; symbol keys are listed separately)
     std::vector<std::string> get_own_property_keys() const;
+    std::vector<std::string> get_own_symbol_keys() const;
     std::vector<std::string> get_enumerable_keys() const;
     std::vector<uint32_t> get_element_indices() const;
     
@@ -158,6 +205,9 @@ public:
     // Array operations (for Array objects)
     uint32_t get_length() const;
     void set_length(uint32_t length);
+    // Replaces all elements with a packed vector built by a native, setting
+    // the length once instead of per element
+    void assign_elements(std::vector<Value> elements);
     void push(const Value& value);
     Value pop();
     void unshift(const Value& value);
@@ -189,12 +239,41 @@ public:
     uint32_t hash() const { return header_.hash_code; }
     
     // Memory management
-    void mark_references() const;
+    virtual void visit_references(GCVisitor& visitor) const;
     size_t memory_usage() const;
     
+    // Weak container hooks (see GCVisitor::visit_weak_container). Ephemerons
+    // are traced repeatedly until marking reaches a fixpoint; dead references
+    // are then cleared in one batch before the sweep.
+    virtual void trace_ephemerons(GCVisitor& visitor, const std::function<bool(Object*)>& is_live) const {
+        (void)visitor;
+        (void)is_live;
+    }
+    virtual void clear_dead_references(const std::function<bool(Object*)>& is_live) { (void)is_live; }
+    
+    // GC mark bit (stored in header flags, set atomically by parallel markers)
+    bool is_gc_marked() const { return header_.flags & GC_MARK_FLAG; }
+    bool try_set_gc_marked() {
+        return !(__atomic_fetch_or(&header_.flags, GC_MARK_FLAG, __ATOMIC_RELAXED) & GC_MARK_FLAG);
+    }
+    void clear_gc_marked() { header_.flags &= ~GC_MARK_FLAG; }
+    
     // Shape management (internal)
     Shape* get_shape() const { return header_.shape; }
+    
+    // Which Shape::SymbolKeyBits this object or its prototype chain may own.
+    // A clear bit is a guarantee; a set bit still needs the real lookup
+    inline uint8_t own_symbol_key_bits() const;
+    inline bool may_have_symbol_key(uint8_t bits) const;
     void transition_shape(const std::string& key, PropertyAttributes attrs);
+
+    // Raw storage access for inline caches; callers check shape and bounds first
+    uint32_t shape_slot_count() const { return static_cast<uint32_t>(properties_.size()); }
+    const Value& get_shape_slot(uint32_t offset) const { return properties_[offset]; }
+    void set_shape_slot(uint32_t offset, const Value& value);
+    const Value& get_element_slot(uint32_t index) const { return elements_[index]; }
+    void set_element_slot(uint32_t index, const Value& value);
+    bool has_descriptors() const;
     
     // Internal property access (bypassing descriptors)
     Value get_internal_property(const std::string& key) const;
@@ -228,15 +307,9 @@ public:
         }
     };
     
-    // Shape transition and caching
-    static std::unordered_map<std::pair<Shape*, std::string>, Shape*, ShapeTransitionHash> shape_transition_cache_;
 
 private:
     
-    // Common property key interning
-    static std::unordered_map<std::string, std::string> interned_keys_;
-    static const std::string& intern_key(const std::string& key);
-    
     // Helper methods
     bool is_array_index(const std::string& key, uint32_t* index = nullptr) const;
     void update_hash_code();
@@ -325,6 +398,18 @@ public:
         uint32_t hash;          // Property name hash for fast lookup
     };
 
+    // Symbol keys share the map with string keys (see Symbol::get_property_key).
+    // These bits, inherited along transitions, say which a shape holds, so
+    // string-key enumeration and the Symbol.iterator / Symbol.toPrimitive
+    // lookups skip every shape that has none
+    enum SymbolKeyBits : uint8_t {
+        SYMBOL_KEYS = 0x01,         // any symbol key
+        ITERATOR_KEY = 0x02,        // Symbol.iterator
+        TO_PRIMITIVE_KEY = 0x04,    // Symbol.toPrimitive
+        ALL_SYMBOL_KEY_BITS = SYMBOL_KEYS | ITERATOR_KEY | TO_PRIMITIVE_KEY
+    };
+    static uint8_t symbol_key_bits(const std::string& key);
+
 private:
     Shape* parent_;
     std::string transition_key_;
@@ -332,8 +417,9 @@ private:
     std::unordered_map<std::string, PropertyInfo> properties_;
     uint32_t property_count_;
     uint32_t id_;
+    uint8_t symbol_key_bits_;
     
-    static uint32_t next_shape_id_;
+    static std::atomic<uint32_t> next_shape_id_;
 
 public:
     Shape();
@@ -344,6 +430,7 @@ public:
     uint32_t get_id() const { return id_; }
     uint32_t get_property_count() const { return property_count_; }
     Shape* get_parent() const { return parent_; }
+    uint8_t get_symbol_key_bits() const { return symbol_key_bits_; }
     
     // Property lookup
     bool has_property(const std::string& key) const;
@@ -353,8 +440,9 @@ public:
     Shape* add_property(const std::string& key, PropertyAttributes attrs);
     Shape* remove_property(const std::string& key);
     
-    // Enumeration
+    // Enumeration, in insertion order; string and symbol keys are listed apart
     std::vector<std::string> get_property_keys() const;
+    std::vector<std::string> get_symbol_keys() const;
     
     // Debugging
     std::string debug_string() const;
@@ -366,6 +454,36 @@ private:
     void rebuild_property_map();
 };
 
+inline uint8_t Object::own_symbol_key_bits() const {
+    if (header_.flags & SLOW_SYMBOL_KEYS_FLAG) return Shape::ALL_SYMBOL_KEY_BITS;
+    return header_.shape ? header_.shape->get_symbol_key_bits() : 0;
+}
+
+inline bool Object::may_have_symbol_key(uint8_t bits) const {
+    for (const Object* obj = this; obj; obj = obj->header_.prototype) {
+        if (obj->own_symbol_key_bits() & bits) return true;
+    }
+    return false;
+}
+
+/**
+ * Shared function info
+ * What every closure created from one function literal has in common: its
+ * parameters, body and the line table of the script it came from. The
+ * literal builds it once and each closure holds a reference, so creating a
+ * closure never copies the AST. Native functions have none.
+ */
+struct SharedFunctionInfo {
+    std::vector<std::string> parameter_names;
+    std::vector<std::unique_ptr<class Parameter>> parameters;   // empty when built from names only
+    std::unique_ptr<class ASTNode> body;
+    std::shared_ptr<const LineTable> lines;                    // resolves the body's offsets
+
+    SharedFunctionInfo(std::vector<std::string> names, std::unique_ptr<class ASTNode> body);
+    SharedFunctionInfo(std::vector<std::unique_ptr<class Parameter>> params, std::unique_ptr<class ASTNode> body);
+    ~SharedFunctionInfo();
+};
+
 /**
  * JavaScript Function object implementation
  */
@@ -380,10 +498,9 @@ public:
 
 private:
     std::string name_;                                    // Function name
-    std::vector<std::string> parameters_;                // Parameter names (for compatibility)
-    std::vector<std::unique_ptr<class Parameter>> parameter_objects_; // Parameter objects with defaults
-    std::unique_ptr<class ASTNode> body_;                // Function body AST
+    std::shared_ptr<SharedFunctionInfo> shared_info_;    // Parameters and body, shared by sibling closures
     class Context* closure_context_;                     // Closure context
+    class Environment* closure_environment_;             // Scope free names resolve in, shared with its creator
     Object* prototype_;                                  // Function prototype
     bool is_native_;                                     // Is native C++ function
     std::function<Value(Context&, const std::vector<Value>&)> native_fn_; // Native function
@@ -392,6 +509,15 @@ private:
     mutable uint32_t execution_count_;                   // Number of times function was called
     mutable bool is_hot_;                               // Is this a hot function (frequently called)
     mutable std::chrono::high_resolution_clock::time_point last_call_time_; // Last call timestamp
+    
+    // Tiering state, managed by OptimizingCompiler
+    std::unique_ptr<FeedbackVector> feedback_vector_;    // Type feedback, allocated on the second call
+    std::unique_ptr<OptimizedCode> optimized_code_;      // Specialized code, null while in baseline
+    uint32_t next_tier_up_;                              // Call count at which to try optimizing
+    uint8_t deopt_count_;                                // Times optimized code was thrown away
+    bool optimization_disabled_;                         // Ineligible or deoptimized too often
+    
+    friend class OptimizingCompiler;
 
 public:
     // Constructors
@@ -405,16 +531,34 @@ public:
              std::unique_ptr<class ASTNode> body,
              class Context* closure_context);
              
+    Function(const std::string& name,
+             std::shared_ptr<SharedFunctionInfo> shared_info,
+             class Context* closure_context);
+             
     Function(const std::string& name,
              std::function<Value(Context&, const std::vector<Value>&)> native_fn);
     
-    virtual ~Function() = default;
+    virtual ~Function();
 
     // Function properties
     const std::string& get_name() const { return name_; }
-    const std::vector<std::string>& get_parameters() const { return parameters_; }
-    size_t get_arity() const { return parameters_.size(); }
+    const std::vector<std::string>& get_parameters() const;
+    const std::vector<std::unique_ptr<class Parameter>>& get_parameter_objects() const;
+    size_t get_arity() const { return get_parameters().size(); }
     bool is_native() const { return is_native_; }
+    // The callable behind a native function, when it is a T
+    template<typename T>
+    const T* get_native_target() const { return is_native_ ? native_fn_.target<T>() : nullptr; }
+    class ASTNode* get_body() const { return shared_info_ ? shared_info_->body.get() : nullptr; }
+    const std::shared_ptr<SharedFunctionInfo>& get_shared_info() const { return shared_info_; }
+    class Context* get_closure_context() const { return closure_context_; }
+    class Environment* get_closure_environment() const { return closure_environment_; }
+    void set_closure_environment(class Environment* environment);
+    
+    // Tiering
+    FeedbackVector* get_feedback_vector() const { return feedback_vector_.get(); }
+    OptimizedCode* get_optimized_code() const { return optimized_code_.get(); }
+    bool is_optimized() const { return optimized_code_ != nullptr; }
     
     // Performance tracking
     uint32_t get_execution_count() const { return execution_count_; }
@@ -429,6 +573,9 @@ public:
     // Property override to ensure function properties work
     Value get_property(const std::string& key) const override;
     
+    // Memory management
+    void visit_references(GCVisitor& visitor) const override;
+    
     // Prototype management
     Object* get_prototype() const { return prototype_; }
     void set_prototype(Object* proto) { prototype_ = proto; }
@@ -438,6 +585,19 @@ public:
     std::string to_string() const;
 };
 
+/**
+ * Array.prototype builtins
+ * Each is installed once as a native Function on Array.prototype and reached
+ * through the normal prototype lookup; the native entry point dispatches on
+ * the id with a switch rather than comparing method names.
+ */
+enum class ArrayBuiltin : uint8_t {
+    Map, Filter, Reduce, ForEach, IndexOf, Slice, Push, Pop,
+    Join, GroupBy, Reverse, Sort, Shift, Unshift, Splice, Find,
+    Includes, Some, Every, FindIndex, Flat, Concat,
+    Count
+};
+
 // Object factory functions
 namespace ObjectFactory {
     // Memory pool management for optimized
@@ -461,9 +621,15 @@ namespace ObjectFactory {
                                                  std::vector<std::unique_ptr<class Parameter>> params,
                                                  std::unique_ptr<class ASTNode> body,
                                                  class Context* closure_context);
+    std::unique_ptr<Function> create_js_function(const std::string& name,
+                                                 std::shared_ptr<SharedFunctionInfo> shared_info,
+                                                 class Context* closure_context);
     std::unique_ptr<Function> create_native_function(const std::string& name,
                                                      std::function<Value(Context&, const std::vector<Value>&)> fn);
-    std::unique_ptr<Function> create_array_method(const std::string& method_name);
+    // Array.prototype builtins by id (see ArrayBuiltin)
+    const char* array_builtin_name(ArrayBuiltin id);
+    Value call_array_builtin(ArrayBuiltin id, Context& ctx, const std::vector<Value>& args);
+    std::unique_ptr<Function> create_array_method(ArrayBuiltin id);
     std::unique_ptr<Object> create_string(const std::string& value);
     std::unique_ptr<Object> create_number(double value);
     std::unique_ptr<Object> create_boolean(bool value);
@@ -0,0 +1,163 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef QUANTA_OPTIMIZING_COMPILER_H
+#define QUANTA_OPTIMIZING_COMPILER_H
+
+#include "Value.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Quanta {
+
+class Engine;
+class Context;
+class ASTNode;
+class Function;
+class GCVisitor;
+
+/**
+ * Specialized code for one function
+ * Produced by the OptimizingCompiler from the function's AST and type
+ * feedback. The code speculates on what the feedback saw; when a guard
+ * fails it finishes the activation on the generic path and marks itself
+ * invalidated, and the function drops back to the baseline interpreter on
+ * its next call.
+ */
+class OptimizedCode {
+public:
+    struct Body;
+
+private:
+    std::unique_ptr<Body> body_;
+    bool invalidated_;
+
+public:
+    explicit OptimizedCode(std::unique_ptr<Body> body);
+    ~OptimizedCode();
+
+    bool is_invalidated() const { return invalidated_; }
+    void invalidate() { invalidated_ = true; }
+
+    // Keeps guarded and inlined call targets alive
+    void visit_references(GCVisitor& visitor) const;
+
+    friend class OptimizingCompiler;
+};
+
+/**
+ * On-stack replacement state of one loop
+ * Owned by the loop's AST node. The interpreter counts the loop's back edges;
+ * once it is hot the loop is compiled on its own and its remaining
+ * iterations run in the optimizing tier.
+ */
+struct LoopOsrState {
+    std::unique_ptr<OptimizedCode> code;
+    uint32_t backedges = 0;         // counted by the interpreter
+    uint32_t next_attempt;          // back-edge count at which to compile
+    uint8_t deopt_count = 0;
+    bool disabled = false;          // ineligible or deoptimized too often
+
+    LoopOsrState();
+    ~LoopOsrState();
+};
+
+/**
+ * Optimizing tier
+ * Functions start in the AST interpreter. From their second call they
+ * collect type feedback (see FeedbackVector); once they have been called
+ * jit_threshold times they are compiled into a tree of specialized
+ * closures: locals live in frame slots instead of Environments, arithmetic
+ * is guarded int32 or double, monomorphic calls are called directly or
+ * inlined and monomorphic property accesses load straight from shape
+ * storage.
+ *
+ * Free variables resolve through the function's closure environment, so
+ * closures compile as well as top-level functions; a call site inlines a
+ * callee created in the same environment as its caller. Bodies
+ * using constructs the tier does not model (nested functions, try,
+ * switch, for-in/of, destructuring, spread, arguments, super) stay in the
+ * interpreter. Optimized activations do not appear in CallStack traces.
+ *
+ * Loops that run long in the interpreter (at top level, or in a function
+ * called too few times to tier up) enter the tier mid-loop: the loop alone
+ * is compiled, the interpreter's live bindings are transferred into frame
+ * slots at a back edge, and they are written back when the loop exits. If
+ * a guard fails, the compiled loop stops at its next back edge, transfers
+ * its state back, and the interpreter resumes the loop.
+ */
+class OptimizingCompiler {
+public:
+    struct Stats {
+        uint64_t compilations = 0;      // functions compiled
+        uint64_t ineligible = 0;        // functions left to the interpreter
+        uint64_t deoptimizations = 0;   // optimized code thrown away after a failed guard
+        uint64_t optimized_calls = 0;   // calls that ran optimized code
+        uint64_t inlined_sites = 0;     // call sites inlined into their caller
+        uint64_t osr_compilations = 0;  // loops compiled for on-stack replacement
+        uint64_t osr_entries = 0;       // loop executions continued in the tier
+    };
+
+    // Outcome of an on-stack replacement attempt at a loop back edge
+    enum class OsrResult : uint8_t {
+        NotEntered,     // keep interpreting the loop
+        Exited,         // the loop finished (normally, by break, return or exception)
+        Resumed         // a guard failed: state was transferred back, resume at the next iteration
+    };
+
+    struct Frame;
+
+    static constexpr uint32_t DEFAULT_THRESHOLD = 100;
+    static constexpr uint8_t MAX_DEOPTS = 5;            // then the function stays in the interpreter
+    static constexpr uint32_t MAX_FRAME_DEPTH = 2000;   // deeper calls run in the interpreter
+    static constexpr uint32_t OSR_THRESHOLD = 1000;     // back edges before a loop is compiled
+
+private:
+    Engine* engine_;
+    uint32_t threshold_;
+    Stats stats_;
+    Frame* top_frame_;      // innermost live optimized activation
+    uint32_t frame_depth_;
+
+public:
+    OptimizingCompiler(Engine* engine, uint32_t threshold = DEFAULT_THRESHOLD);
+    ~OptimizingCompiler();
+
+    // Called at the start of every call of a JavaScript function. Profiles
+    // and tiers the function up when it is hot; returns true with the
+    // result filled in when the call ran in the optimizing tier, false when
+    // the caller must run it in the interpreter.
+    bool try_call(Function* function, Context& ctx, const std::vector<Value>& args,
+                  const Value& this_value, Value& result);
+
+    // Called by the interpreter at a back edge of a loop (a for, while or
+    // do-while node) once state.backedges reaches state.next_attempt or the
+    // loop has code, with ctx the context the loop runs in. The back edge is
+    // where the next iteration starts: the for update and do-while test have
+    // already run.
+    OsrResult try_osr(ASTNode* loop, LoopOsrState& state, Context& ctx);
+
+    void set_threshold(uint32_t threshold) { threshold_ = threshold ? threshold : 1; }
+    uint32_t get_threshold() const { return threshold_; }
+    const Stats& get_stats() const { return stats_; }
+    std::string get_stats_string() const;
+
+    // Values held in the slots of live optimized frames
+    void visit_references(GCVisitor& visitor) const;
+
+private:
+    std::unique_ptr<OptimizedCode> compile(Function* function);
+    std::unique_ptr<OptimizedCode> compile_loop(ASTNode* loop, Context& ctx);
+    bool is_running(const OptimizedCode* code) const;
+    Value execute(OptimizedCode* code, Context& ctx,
+                  const std::vector<Value>& args, const Value& this_value);
+};
+
+} // namespace Quanta
+
+#endif // QUANTA_OPTIMIZING_COMPILER_H
@@ -16,6 +16,7 @@ namespace Quanta {
 
 class Context;
 class Function;
+class AsyncActivation;
 
 /**
  * Promise states according to JavaScript Promise specification
@@ -26,43 +27,77 @@ enum class PromiseState {
     REJECTED
 };
 
+class Promise;
+
+/**
+ * One then() registration: the handlers and the promise then() returned.
+ * While the promise is pending its reactions wait on a list; settling turns
+ * each into a job on the microtask queue carrying the settlement. A chain
+ * retires one record per link, so records come from a per-thread free list.
+ */
+struct PromiseReaction {
+    enum class Type : uint8_t { Fulfill, Reject };
+
+    Function* on_fulfilled = nullptr;
+    Function* on_rejected = nullptr;
+    Promise* derived = nullptr;     // settled from the handler's outcome; may be null
+    Context* context = nullptr;     // handlers run here
+    AsyncActivation* awaiting = nullptr;  // an async function suspended in await, resumed instead of a handler
+    Value argument;                 // the settlement, once queued
+    Type type = Type::Fulfill;
+    PromiseReaction* next = nullptr;
+
+    static PromiseReaction* acquire();
+    static void release(PromiseReaction* reaction);
+
+    // The reaction job: runs the handler for type and settles derived
+    void run();
+
+    void visit_references(GCVisitor& visitor) const;
+};
+
 /**
  * JavaScript Promise implementation
+ * Handlers never run synchronously: then() on a settled promise and the
+ * settling of a pending one both queue reaction jobs, which the event loop
+ * runs in order once the current script job is done.
  */
 class Promise : public Object {
+    friend struct PromiseReaction;
+
 private:
     PromiseState state_;
     Value value_;  // Fulfillment value or rejection reason
-    std::vector<Function*> fulfillment_handlers_;
-    std::vector<Function*> rejection_handlers_;
+    PromiseReaction* reactions_head_;
+    PromiseReaction* reactions_tail_;
+    bool following_;    // resolved with a thenable and waiting on it
     Context* context_;  // Context for callback execution
 
 public:
-    Promise(Context* ctx = nullptr) : Object(ObjectType::Promise), state_(PromiseState::PENDING), context_(ctx) {}
+    Promise(Context* ctx = nullptr);  // inherits then/catch/finally from Promise.prototype
     
-    // Add explicit destructor to handle cleanup
-    virtual ~Promise() {
-        // Clear handlers to avoid dangling pointers
-        fulfillment_handlers_.clear();
-        rejection_handlers_.clear();
-        // Don't delete context_ as it's not owned by Promise
-        context_ = nullptr;
-    }
+    virtual ~Promise();
     
-    // Core Promise methods
+    // Core Promise methods; ignored once the promise is settled or following
     void fulfill(const Value& value);
     void reject(const Value& reason);
     
-    // Promise.prototype methods
-    Promise* then(Function* on_fulfilled, Function* on_rejected = nullptr);
-    Promise* catch_method(Function* on_rejected);
-    Promise* finally_method(Function* on_finally);
+    // Promise Resolve Function: follows a promise or thenable, else fulfills
+    void resolve(const Value& resolution);
+    
+    // Promise.prototype methods; ctx is the calling context
+    Promise* then(Function* on_fulfilled, Function* on_rejected = nullptr, Context* ctx = nullptr);
+    Promise* catch_method(Function* on_rejected, Context* ctx = nullptr);
+    Promise* finally_method(Function* on_finally, Context* ctx = nullptr);
+    
+    // PerformPromiseThen with a prepared record
+    void add_reaction(PromiseReaction* reaction);
     
     // Static methods
-    static Promise* resolve(const Value& value);
-    static Promise* reject_static(const Value& reason);
-    static Promise* all(const std::vector<Promise*>& promises);
-    static Promise* race(const std::vector<Promise*>& promises);
+    static Promise* resolve_static(const Value& value, Context* ctx = nullptr);  // the value itself if it is a promise
+    static Promise* reject_static(const Value& reason, Context* ctx = nullptr);
+    static Promise* all(Context& ctx, const std::vector<Value>& values);
+    static Promise* race(Context& ctx, const std::vector<Value>& values);
     
     // ES2025 Static methods
     static Value withResolvers(Context& ctx, const std::vector<Value>& args);
@@ -75,11 +110,13 @@ public:
     bool is_fulfilled() const { return state_ == PromiseState::FULFILLED; }
     bool is_rejected() const { return state_ == PromiseState::REJECTED; }
     
-    // Setup JavaScript methods (.then, .catch, .finally) on a promise instance
-    static void setup_promise_methods(Promise* promise);
+    // Memory management
+    void visit_references(GCVisitor& visitor) const override;
 
 private:
-    void execute_handlers();
+    void settle(PromiseState state, const Value& value);
+    void adopt(const Value& resolution);
+    Context* job_context(Context* ctx) const;
 };
 
 } // namespace Quanta
@@ -76,6 +76,9 @@ public:
     // Override Object methods to use traps
     Value get_property(const std::string& key) const override;
     
+    // Memory management
+    void visit_references(GCVisitor& visitor) const override;
+    
 private:
     void parse_handler();
     void throw_if_revoked(Context& ctx) const;
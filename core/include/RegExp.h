@@ -35,6 +35,10 @@ public:
     bool test(const std::string& str);
     Value exec(const std::string& str);
     
+    // Finds the first match at or after byte offset from, leaving lastIndex
+    // alone; text before from still counts for ^ and \b
+    bool search(const std::string& str, size_t from, std::smatch& match) const;
+    
     // Properties
     std::string get_source() const { return pattern_; }
     std::string get_flags() const { return flags_; }
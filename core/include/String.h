@@ -7,6 +7,7 @@
 #ifndef QUANTA_STRING_H
 #define QUANTA_STRING_H
 
+#include <cstdint>
 #include <string>
 #include <memory>
 
@@ -17,52 +18,152 @@ namespace Quanta {
  * Features:
  * - String interning for common strings
  * - Copy-on-write semantics
- * - UTF-8 support
+ * - UTF-16 code unit indexing in O(1)
+ * - Zero-copy sliced substrings
+ *
+ * Strings are built from UTF-8 text. Text that is pure ASCII is stored
+ * one-byte: each byte is one UTF-16 code unit. Any other text is two-byte:
+ * its code units are decoded once, on the first indexed access, and kept
+ * beside the UTF-8 text.
+ *
+ * A substring of at least MIN_SLICE_LENGTH code units is a slice: it shares
+ * the backing store of the string it was cut from and records an offset and
+ * a length. Slicing a slice refers to the original backing, so slices never
+ * chain. A small slice of a large backing would keep all of it alive; the
+ * garbage collector reports such slices (see pins_backing()) and they are
+ * flattened into their own copy.
+ *
+ * Searching compares code units. A single-unit needle is found with memchr
+ * (one-byte) or an SSE2 scan (two-byte); longer needles use Horspool's
+ * algorithm once the haystack is long enough to repay its shift table.
  */
 class String {
+public:
+    enum class Encoding : uint8_t {
+        OneByte,    // ASCII
+        TwoByte     // UTF-16 code units
+    };
+
+    static constexpr uint32_t MIN_SLICE_LENGTH = 13;    // shorter substrings are copied
+    static constexpr uint32_t PINNING_RATIO = 4;        // backing this many times larger than the slice pins it
+    static constexpr uint32_t MIN_PINNED_BACKING = 1024;
+    static constexpr size_t npos = std::string::npos;
+
 private:
-    std::shared_ptr<std::string> data_;
-    size_t hash_;
+    // One-byte: the ASCII text (the slice's backing when sliced).
+    // Two-byte: the UTF-8 text of a flat string, null for a slice.
+    std::shared_ptr<const std::string> data_;
+    // Two-byte code units; for a flat string decoded from data_ on demand
+    mutable std::shared_ptr<const std::u16string> units_;
+    // UTF-8 text of a slice, built by str() on demand
+    mutable std::shared_ptr<const std::string> text_;
+    uint32_t offset_;           // first code unit in the backing
+    uint32_t length_;           // in UTF-16 code units
+    Encoding encoding_;
+    bool sliced_;
     bool interned_;
+    mutable bool hashed_;
+    mutable size_t hash_;
 
 public:
     // Constructors
     String();
-    explicit String(const std::string& str);
+    explicit String(std::string str);
     explicit String(const char* str);
+    explicit String(std::u16string units);
     String(const String& other) = default;
     String(String&& other) noexcept = default;
-    
+
     // Assignment
     String& operator=(const String& other) = default;
     String& operator=(String&& other) noexcept = default;
-    
+
     // Access
-    const std::string& str() const { return *data_; }
-    const char* c_str() const { return data_->c_str(); }
-    size_t length() const { return data_->length(); }
-    size_t size() const { return data_->size(); }
-    bool empty() const { return data_->empty(); }
-    
+    // UTF-8 text; for a slice the text is assembled on first use
+    const std::string& str() const;
+    const char* c_str() const { return str().c_str(); }
+    // Length in UTF-16 code units
+    size_t length() const { return length_; }
+    bool empty() const { return length_ == 0; }
+    Encoding encoding() const { return encoding_; }
+    bool is_sliced() const { return sliced_; }
+
+    // UTF-16 code unit at index; index must be below length()
+    char16_t char_code_at(size_t index) const {
+        return encoding_ == Encoding::OneByte
+            ? static_cast<char16_t>(static_cast<unsigned char>((*data_)[offset_ + index]))
+            : two_byte_units()[offset_ + index];
+    }
+    bool starts_with(const char* ascii_prefix) const;
+
+    // Search, in code units. index_of finds the first occurrence at or after
+    // from, last_index_of the last one starting at or before from; both
+    // return npos when there is none.
+    size_t index_of(const String& needle, size_t from = 0) const;
+    size_t last_index_of(const String& needle, size_t from = npos) const;
+    // True when needle occurs at exactly position
+    bool matches_at(const String& needle, size_t position) const;
+
     // Hash
-    size_t hash() const { return hash_; }
-    
+    size_t hash() const;
+
     // Comparison
     bool operator==(const String& other) const;
     bool operator!=(const String& other) const { return !(*this == other); }
     bool operator<(const String& other) const { return str() < other.str(); }
-    
+
     // String operations
     String concat(const String& other) const;
-    String substring(size_t start, size_t length = std::string::npos) const;
-    
+    // Code units [start, end); both are clamped to length()
+    String substring(size_t start, size_t end = std::string::npos) const;
+    // The one-unit string at index; index must be below length()
+    String char_at(size_t index) const;
+
+    // Garbage collection support
+    // True for a slice that keeps a much larger backing alive
+    bool pins_backing() const;
+    // Copies a slice's code units into a backing of its own
+    void flatten();
+
     // Static factory
     static String intern(const std::string& str);
 
 private:
-    void calculate_hash();
+    const std::u16string& two_byte_units() const;
+    const char* one_byte_data() const { return data_->data() + offset_; }
+    const char16_t* two_byte_data() const { return two_byte_units().data() + offset_; }
+    size_t backing_length() const;
+
+    friend class StringBuilder;
+};
+
+/**
+ * Builds a String in one pass from pieces of other strings
+ * The text stays one-byte while every piece is; the first two-byte piece
+ * widens what has been built so far.
+ */
+class StringBuilder {
+private:
+    std::string bytes_;
+    std::u16string units_;
+    bool two_byte_;
+
+public:
+    StringBuilder() : two_byte_(false) {}
+
+    void reserve(size_t units);
+    // Code units [start, end) of str
+    void append(const String& str, size_t start, size_t end);
+    void append(const String& str) { append(str, 0, str.length()); }
+    size_t length() const { return two_byte_ ? units_.size() : bytes_.size(); }
+
+    // Leaves the builder empty
+    String build();
+
+private:
+    void widen();
 };
 
 } // namespace Quanta
 
-#endif // QUANTA_STRING_H
\ No newline at end of file
+#endif // QUANTA_STRING_H
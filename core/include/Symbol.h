@@ -10,32 +10,70 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <atomic>
+#include <mutex>
 #include "Value.h"
 
 namespace Quanta {
 
 class Context;
 
+/**
+ * Well-known symbols. Their ids are fixed: symbol id N+1 is the N-th entry,
+ * and ids of symbols created at run time start after Count, so looking one
+ * up is an array index rather than a name lookup
+ */
+enum class WellKnownSymbol : uint8_t {
+    Iterator,
+    AsyncIterator,
+    Match,
+    Replace,
+    Search,
+    Split,
+    HasInstance,
+    IsConcatSpreadable,
+    Species,
+    ToPrimitive,
+    ToStringTag,
+    Unscopables,
+    Count
+};
+
 /**
  * JavaScript Symbol implementation
- * Symbols are unique identifiers that can be used as object keys
+ * Symbols are unique identifiers that can be used as object keys. A symbol
+ * keys properties through a string derived from its id that no string key
+ * can spell (see get_property_key), so symbol keys live in the same shapes
+ * and maps as string keys without colliding with them or with each other
  */
 class Symbol {
 private:
     std::string description_;
-    static uint64_t next_id_;
     uint64_t id_;
+    std::string property_key_;
+    
+    static std::atomic<uint64_t> next_id_;
     
-    // Well-known symbols registry
-    static std::unordered_map<std::string, std::unique_ptr<Symbol>> well_known_symbols_;
+    // Well-known symbols, indexed by WellKnownSymbol (shared read-only by all isolates)
+    static Symbol well_known_symbols_[static_cast<size_t>(WellKnownSymbol::Count)];
     
-    // Global symbol registry
+    // Global symbol registry (shared by all isolates)
     static std::unordered_map<std::string, std::unique_ptr<Symbol>> global_registry_;
+    static std::mutex global_registry_mutex_;
     
-    Symbol(const std::string& description);
+    // Live symbols by id, for turning property keys back into symbols
+    static std::unordered_map<uint64_t, Symbol*> symbols_by_id_;
+    static std::mutex symbols_by_id_mutex_;
+    
+    Symbol(const std::string& description, uint64_t id);
     
 public:
-    ~Symbol() = default;
+    // First byte of every symbol property key. 0xFF never occurs in UTF-8:
+    // the lexer stores escapes as UTF-8, and Value::to_property_key re-encodes
+    // a leading 0xFF byte of any other string
+    static constexpr unsigned char PROPERTY_KEY_PREFIX = 0xFF;
+    
+    ~Symbol();
     
     // Create new symbol
     static std::unique_ptr<Symbol> create(const std::string& description = "");
@@ -47,10 +85,22 @@ public:
     static std::string key_for(Symbol* symbol);
     
     // Get well-known symbol
-    static Symbol* get_well_known(const std::string& name);
+    static Symbol* get_well_known(WellKnownSymbol which) {
+        return &well_known_symbols_[static_cast<size_t>(which)];
+    }
+    static const std::string& well_known_key(WellKnownSymbol which) {
+        return get_well_known(which)->property_key_;
+    }
     
-    // Initialize well-known symbols
-    static void initialize_well_known_symbols();
+    // Name of the well-known symbol as a property of the Symbol constructor ("iterator")
+    static const char* well_known_name(WellKnownSymbol which);
+    
+    // Property keys
+    const std::string& get_property_key() const { return property_key_; }
+    static bool is_property_key(const std::string& key) {
+        return !key.empty() && static_cast<unsigned char>(key[0]) == PROPERTY_KEY_PREFIX;
+    }
+    static Symbol* from_property_key(const std::string& key);
     
     // Symbol properties
     std::string get_description() const { return description_; }
@@ -66,20 +116,6 @@ public:
     static Value symbol_key_for(Context& ctx, const std::vector<Value>& args);
     static Value symbol_to_string(Context& ctx, const std::vector<Value>& args);
     static Value symbol_value_of(Context& ctx, const std::vector<Value>& args);
-    
-    // Well-known symbol names
-    static const std::string ITERATOR;
-    static const std::string ASYNC_ITERATOR;
-    static const std::string MATCH;
-    static const std::string REPLACE;
-    static const std::string SEARCH;
-    static const std::string SPLIT;
-    static const std::string HAS_INSTANCE;
-    static const std::string IS_CONCAT_SPREADABLE;
-    static const std::string SPECIES;
-    static const std::string TO_PRIMITIVE;
-    static const std::string TO_STRING_TAG;
-    static const std::string UNSCOPABLES;
 };
 
 } // namespace Quanta
\ No newline at end of file
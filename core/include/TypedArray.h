@@ -86,6 +86,9 @@ public:
     Value get_property(const std::string& key) const override;
     bool set_property(const std::string& key, const Value& value, PropertyAttributes attrs = PropertyAttributes::Default) override;
     
+    // Memory management
+    void visit_references(GCVisitor& visitor) const override;
+    
     // Element access for array-style indexing (shadows Object methods)
     Value get_element(uint32_t index) const;
     bool set_element(uint32_t index, const Value& value);
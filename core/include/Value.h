@@ -291,6 +291,7 @@ public:
     bool to_boolean() const;
     double to_number() const;
     std::string to_string() const;
+    std::string to_property_key() const;    // symbols key by Symbol::get_property_key
     Object* to_object() const;
     
     // Comparison operations
@@ -379,6 +380,7 @@ namespace ValueFactory {
     inline Value boolean(bool b) { return Value(b); }
     inline Value number(double d) { return Value(d); }
     inline Value string(const std::string& s) { return Value(s); }
+    Value string(String str);   // e.g. a slice produced by String::substring
     Value create_function(std::unique_ptr<class Function> function_obj);
     inline Value function_placeholder(const std::string& name) { 
         // For now, create a function as a special string value
@@ -0,0 +1,98 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef QUANTA_WEAKREF_H
+#define QUANTA_WEAKREF_H
+
+#include "Value.h"
+#include "Object.h"
+#include <vector>
+
+namespace Quanta {
+
+class Context;
+class GarbageCollector;
+class Isolate;
+
+/**
+ * WeakRef implementation
+ * ES2021 WeakRef: holds its target weakly; deref() returns undefined once the
+ * target has been collected
+ */
+class WeakRef : public Object {
+private:
+    Value target_;
+
+public:
+    explicit WeakRef(const Value& target);
+    virtual ~WeakRef() = default;
+
+    Value deref() const { return target_; }
+
+    // Memory management (the target is held weakly)
+    void visit_references(GCVisitor& visitor) const override;
+    void clear_dead_references(const std::function<bool(Object*)>& is_live) override;
+
+    // WeakRef built-in methods
+    static Value weakref_constructor(Context& ctx, const std::vector<Value>& args);
+    static Value weakref_deref(Context& ctx, const std::vector<Value>& args);
+
+    // Setup WeakRef prototype
+    static void setup_weakref_prototype(Context& ctx);
+};
+
+/**
+ * FinalizationRegistry implementation
+ * ES2021 FinalizationRegistry: when a registered target is collected its held
+ * value is passed to the cleanup callback in a later macrotask. A registry
+ * with outstanding registrations is rooted so its callbacks can still run
+ * after the script drops it.
+ */
+class FinalizationRegistry : public Object {
+private:
+    struct Cell {
+        Object* target;             // weak
+        Value held_value;           // strong
+        Object* unregister_token;   // weak, may be null
+    };
+
+    Context* realm_;
+    Isolate* isolate_;              // whose event loop runs the cleanups
+    GarbageCollector* gc_;
+    Value cleanup_callback_;
+    std::vector<Cell> cells_;
+    std::vector<Value> pending_cleanups_;
+    bool cleanup_scheduled_;
+    bool rooted_;
+
+public:
+    FinalizationRegistry(Context* realm, const Value& cleanup_callback);
+    virtual ~FinalizationRegistry() = default;
+
+    // FinalizationRegistry operations
+    void register_target(Object* target, const Value& held_value, Object* unregister_token);
+    bool unregister(Object* unregister_token);
+    void run_cleanup();
+
+    // Memory management (targets and tokens are held weakly)
+    void visit_references(GCVisitor& visitor) const override;
+    void clear_dead_references(const std::function<bool(Object*)>& is_live) override;
+
+    // FinalizationRegistry built-in methods
+    static Value registry_constructor(Context& ctx, const std::vector<Value>& args);
+    static Value registry_register(Context& ctx, const std::vector<Value>& args);
+    static Value registry_unregister(Context& ctx, const std::vector<Value>& args);
+
+    // Setup FinalizationRegistry prototype
+    static void setup_finalization_registry_prototype(Context& ctx);
+
+private:
+    void update_root();
+};
+
+} // namespace Quanta
+
+#endif // QUANTA_WEAKREF_H
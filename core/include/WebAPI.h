@@ -647,10 +647,6 @@ public:
     static Value NotificationOptions_tag(Context& ctx, const std::vector<Value>& args);
     static Value NotificationOptions_timestamp(Context& ctx, const std::vector<Value>& args);
     static Value NotificationOptions_vibrate(Context& ctx, const std::vector<Value>& args);
-    
-private:
-    static int timer_id_counter_;
-    static std::vector<std::chrono::time_point<std::chrono::steady_clock>> timer_times_;
 };
 
 } // namespace Quanta
@@ -6,10 +6,22 @@
 
 #include "Async.h"
 #include "Context.h"
+#include "Error.h"
+#include "GC.h"
 #include "Symbol.h"
+#include "Isolate.h"
 #include "../../parser/include/AST.h"
 #include <iostream>
 #include <chrono>
+#include <mutex>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
 
 namespace Quanta {
 
@@ -25,80 +37,370 @@ AsyncFunction::AsyncFunction(const std::string& name,
 }
 
 Value AsyncFunction::call(Context& ctx, const std::vector<Value>& args, Value this_value) {
-    (void)this_value; // Unused parameter
-    
-    // Create and return a promise
-    auto promise = execute_async(ctx, args);
-    return Value(promise.release());
+    // The body runs until its first await; reaction jobs run the rest
+    return Value(AsyncActivation::start(this, ctx, args, this_value));
 }
 
-std::unique_ptr<Promise> AsyncFunction::execute_async(Context& ctx, const std::vector<Value>& args) {
-    // Simplified approach: execute in current context with parameter binding
-    // This avoids complex Context creation issues
+//=============================================================================
+// AsyncActivation Implementation
+//=============================================================================
+
+namespace {
+
+// A body's stack, as large as a thread's so a body nests as deep as the
+// same code run synchronously. It is address space only: pages are
+// committed as the body touches them. Calls stop ASYNC_STACK_HEADROOM
+// short of its end, which leaves room for the natives and the collector
+// a call may still run
+const size_t ASYNC_STACK_SIZE = 8 * 1024 * 1024;
+const size_t ASYNC_STACK_HEADROOM = 64 * 1024;
+
+// Finished activations kept per thread; beyond this many their stacks are freed
+const size_t MAX_FREE_STACKS = 64;
+thread_local AsyncActivation* free_activations = nullptr;
+thread_local size_t free_stack_count = 0;
+
+#ifndef _WIN32
+// Stacks are carved out of slabs of one mapping each and shared by all
+// threads. Every stack has a guard page of its own below it, so a body
+// that runs off its stack faults instead of writing into a parked one.
+// Each guard splits the mapping, which costs two kernel mappings per
+// stack; MAX_ASYNC_STACKS keeps that well inside vm.max_map_count. A call
+// that finds no stack runs without one (see start()).
+const size_t ASYNC_STACKS_PER_SLAB = 16;
+const size_t MAX_ASYNC_STACKS = 16 * 1024;
+
+class AsyncStackPool {
+private:
+    std::mutex mutex_;
+    std::vector<void*> free_;
+    size_t carved_ = 0;
     
-    // Create promise for async execution
-    auto promise = std::make_unique<Promise>(&ctx);
+public:
+    void* acquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.empty() && !carve_slab()) {
+            return nullptr;
+        }
+        void* memory = free_.back();
+        free_.pop_back();
+        return memory;
+    }
     
-    // Bind parameters to current context temporarily
-    const auto& params = get_parameters();
-    std::vector<std::pair<std::string, Value>> old_bindings;
+    void release(void* memory) {
+        // The stack keeps its address space; its pages go back to the system
+        madvise(memory, ASYNC_STACK_SIZE, MADV_DONTNEED);
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(memory);
+    }
     
-    // Save old parameter bindings and set new ones
-    for (size_t i = 0; i < params.size(); ++i) {
-        Value arg = i < args.size() ? args[i] : Value();
+private:
+    bool carve_slab() {
+        if (carved_ + ASYNC_STACKS_PER_SLAB > MAX_ASYNC_STACKS) {
+            return false;
+        }
+        // Room for every stack carved so far, so release() never allocates
+        free_.reserve(carved_ + ASYNC_STACKS_PER_SLAB);
         
-        // Save old binding if it exists
-        try {
-            Value old_value = ctx.get_binding(params[i]);
-            old_bindings.push_back({params[i], old_value});
-        } catch (...) {
-            // Parameter didn't exist before, that's fine
-            old_bindings.push_back({params[i], Value()}); // Use undefined as sentinel
+        size_t guard_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t stride = guard_size + ASYNC_STACK_SIZE;
+        size_t slab_size = ASYNC_STACKS_PER_SLAB * stride;
+        void* slab = mmap(nullptr, slab_size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (slab == MAP_FAILED) {
+            return false;
+        }
+        char* base = static_cast<char*>(slab);
+        for (size_t i = 0; i < ASYNC_STACKS_PER_SLAB; ++i) {
+            if (mprotect(base + i * stride, guard_size, PROT_NONE) != 0) {
+                munmap(slab, slab_size);
+                return false;
+            }
         }
         
-        // Create new binding
-        ctx.create_binding(params[i], arg);
+        for (size_t i = ASYNC_STACKS_PER_SLAB; i-- > 0;) {
+            free_.push_back(base + i * stride + guard_size);
+        }
+        carved_ += ASYNC_STACKS_PER_SLAB;
+        return true;
     }
+};
+
+// Never destroyed: activations may free their stacks during teardown
+AsyncStackPool& stack_pool() {
+    static AsyncStackPool* pool = new AsyncStackPool();
+    return *pool;
+}
+#endif
+
+} // anonymous namespace
+
+thread_local AsyncActivation* AsyncActivation::current_ = nullptr;
+
+struct AsyncActivation::Stack {
+#ifdef _WIN32
+    LPVOID fiber = nullptr;
+    LPVOID resumer = nullptr;
+#else
+    void* memory = nullptr;
+    ucontext_t body;
+    ucontext_t resumer;
+#endif
     
-    // Execute function body
-    try {
-        if (body_) {
-            Value result = body_->evaluate(ctx);
-            if (ctx.has_exception()) {
-                promise->reject(ctx.get_exception());
-                ctx.clear_exception(); // Clear the exception
-            } else {
-                promise->fulfill(result);
-            }
+    static Stack* allocate();
+    static void free(Stack* stack);
+#ifdef _WIN32
+    static VOID CALLBACK fiber_entry(LPVOID) { body_entry(); }
+#endif
+};
+
+AsyncActivation::Stack* AsyncActivation::Stack::allocate() {
+    auto* stack = new Stack();
+#ifdef _WIN32
+    stack->fiber = CreateFiberEx(0, ASYNC_STACK_SIZE, 0, fiber_entry, nullptr);
+    if (!stack->fiber) {
+        delete stack;
+        return nullptr;
+    }
+#else
+    stack->memory = stack_pool().acquire();
+    if (!stack->memory) {
+        delete stack;
+        return nullptr;
+    }
+    
+    getcontext(&stack->body);
+    stack->body.uc_stack.ss_sp = stack->memory;
+    stack->body.uc_stack.ss_size = ASYNC_STACK_SIZE;
+    stack->body.uc_link = nullptr;
+    makecontext(&stack->body, &AsyncActivation::body_entry, 0);
+#endif
+    return stack;
+}
+
+void AsyncActivation::Stack::free(Stack* stack) {
+    if (!stack) return;
+#ifdef _WIN32
+    DeleteFiber(stack->fiber);
+#else
+    stack_pool().release(stack->memory);
+#endif
+    delete stack;
+}
+
+AsyncActivation::AsyncActivation()
+    : Object(ObjectType::Custom), function_(nullptr), promise_(nullptr), state_(State::Finished),
+      stack_(nullptr), stack_limit_(0), gc_(nullptr), parked_handle_depth_(0), parked_try_depth_(0),
+      parked_current_(nullptr), resumed_fulfilled_(true), next_free_(nullptr) {
+}
+
+AsyncActivation::~AsyncActivation() {
+    Stack::free(stack_);
+}
+
+AsyncActivation* AsyncActivation::acquire() {
+    AsyncActivation* activation = free_activations;
+    if (!activation) {
+        return new AsyncActivation();
+    }
+    free_activations = activation->next_free_;
+    activation->next_free_ = nullptr;
+    if (activation->stack_) --free_stack_count;
+    return activation;
+}
+
+void AsyncActivation::release(AsyncActivation* activation) {
+    // Never deleted: a marking cycle in progress may still hold the object
+    if (activation->stack_) {
+        if (free_stack_count >= MAX_FREE_STACKS) {
+            Stack::free(activation->stack_);
+            activation->stack_ = nullptr;
         } else {
-            promise->fulfill(Value());
+            ++free_stack_count;
         }
-    } catch (const std::exception& e) {
-        promise->reject(Value(e.what()));
     }
+    activation->next_free_ = free_activations;
+    free_activations = activation;
+}
+
+Promise* AsyncActivation::start(AsyncFunction* function, Context& ctx, const std::vector<Value>& args, Value this_value) {
+    auto* promise = new Promise(&ctx);
     
-    // Restore old parameter bindings
-    for (const auto& binding : old_bindings) {
-        if (!binding.second.is_undefined()) {
-            ctx.create_binding(binding.first, binding.second);
+    AsyncActivation* activation = acquire();
+    if (!activation->stack_) {
+        try {
+            activation->stack_ = Stack::allocate();
+        } catch (const std::bad_alloc&) {
+            activation->stack_ = nullptr;
         }
-        // If old value was undefined, we leave the new binding in place
     }
     
+    // The body's scope outlives this call, so it gets a context of its own
+    auto context = ContextFactory::create_function_context(ctx.get_engine(), &ctx, function);
+    if (this_value.is_object() || this_value.is_function()) {
+        context->set_this_binding(this_value.is_object() ? this_value.as_object() : this_value.as_function());
+    }
+    const auto& params = function->get_parameters();
+    for (size_t i = 0; i < params.size(); ++i) {
+        context->create_binding(params[i], i < args.size() ? args[i] : Value(), false);
+    }
+    auto arguments_obj = ObjectFactory::create_array(args.size());
+    for (size_t i = 0; i < args.size(); i++) {
+        arguments_obj->set_element(i, args[i]);
+    }
+    arguments_obj->set_property("length", Value(static_cast<double>(args.size())));
+    context->create_binding("arguments", Value(arguments_obj.release()), false);
+    context->create_binding("this", this_value, false);
+    
+    activation->function_ = function;
+    activation->promise_ = promise;
+    activation->context_ = std::move(context);
+    activation->gc_ = ctx.get_garbage_collector();
+    GarbageCollector::write_barrier(function);
+    GarbageCollector::write_barrier(promise);
+    if (activation->gc_) {
+        activation->gc_->add_root_object(activation);
+    }
+    
+    if (activation->stack_) {
+        activation->enter();
+        return promise;
+    }
+    
+    // Out of stacks: the body runs to its end on this stack instead. Its
+    // awaits cannot suspend it, so they wait for their promises by running
+    // the event loop, as a top-level await does
+    activation->state_ = State::Running;
+    activation->run_body();
+    activation->state_ = State::Finished;
+    activation->finish();
     return promise;
 }
 
-void AsyncFunction::execute_async_body(Context& ctx, Promise* promise) {
+void AsyncActivation::body_entry() {
+    // A stack stays with its activation, so this loop serves every call run on it
+    AsyncActivation* self = current_;
+    char stack_top;
+    self->stack_limit_ = reinterpret_cast<uintptr_t>(&stack_top) - ASYNC_STACK_SIZE + ASYNC_STACK_HEADROOM;
+    for (;;) {
+        self->run_body();
+        self->state_ = State::Finished;
+        self->leave();
+    }
+}
+
+void AsyncActivation::run_body() {
+    Context& ctx = *context_;
     try {
-        if (body_) {
-            Value result = body_->evaluate(ctx);
-            promise->fulfill(result);
+        ASTNode* body = function_->get_async_body();
+        Value result = body ? body->evaluate(ctx) : Value();
+        if (ctx.has_return_value()) {
+            result = ctx.get_return_value();
+            ctx.clear_return_value();
+        }
+        if (ctx.has_exception()) {
+            Value exception = ctx.get_exception();
+            ctx.clear_exception();
+            promise_->reject(exception);
         } else {
-            promise->fulfill(Value());
+            promise_->resolve(result);
         }
     } catch (const std::exception& e) {
-        promise->reject(Value(e.what()));
+        promise_->reject(Value(e.what()));
+    } catch (...) {
+        // Nothing may unwind past the bottom of this stack
+        promise_->reject(Value("Unknown error in async function"));
+    }
+}
+
+void AsyncActivation::enter() {
+    // The resumer's handles and try statements are parked while the body runs
+    parked_current_ = current_;
+    current_ = this;
+    if (gc_) gc_->swap_handles(parked_handles_, parked_handle_depth_);
+    std::swap(TryStatement::nesting_depth(), parked_try_depth_);
+    state_ = State::Running;
+    
+#ifdef _WIN32
+    if (!IsThreadAFiber()) {
+        ConvertThreadToFiber(nullptr);
+    }
+    stack_->resumer = GetCurrentFiber();
+    SwitchToFiber(stack_->fiber);
+#else
+    swapcontext(&stack_->resumer, &stack_->body);
+#endif
+    
+    // The body suspended in an await or finished
+    if (gc_) gc_->swap_handles(parked_handles_, parked_handle_depth_);
+    std::swap(TryStatement::nesting_depth(), parked_try_depth_);
+    current_ = parked_current_;
+    parked_current_ = nullptr;
+    
+    if (state_ == State::Finished) {
+        finish();
+    }
+}
+
+void AsyncActivation::leave() {
+#ifdef _WIN32
+    SwitchToFiber(stack_->resumer);
+#else
+    swapcontext(&stack_->body, &stack_->resumer);
+#endif
+}
+
+Value AsyncActivation::await(Promise* promise) {
+    PromiseReaction* reaction = PromiseReaction::acquire();
+    reaction->awaiting = this;
+    promise->add_reaction(reaction);
+    
+    state_ = State::Suspended;
+    leave();
+    
+    // Resumed by the reaction job
+    Value value = resumed_value_;
+    resumed_value_ = Value();
+    if (!resumed_fulfilled_) {
+        context_->throw_exception(value);
+        return Value();
+    }
+    if (gc_) gc_->root_temporary(value);
+    return value;
+}
+
+void AsyncActivation::resume(bool fulfilled, const Value& value) {
+    if (state_ != State::Suspended) return;
+    
+    resumed_fulfilled_ = fulfilled;
+    resumed_value_ = value;
+    GarbageCollector::write_barrier(value);
+    enter();
+}
+
+void AsyncActivation::finish() {
+    // The body's handle scopes are all closed by now
+    parked_handles_.clear();
+    parked_handle_depth_ = 0;
+    parked_try_depth_ = 0;
+    context_.reset();
+    function_ = nullptr;
+    promise_ = nullptr;
+    if (gc_) {
+        gc_->remove_root_object(this);
+        gc_ = nullptr;
     }
+    release(this);
+}
+
+void AsyncActivation::visit_references(GCVisitor& visitor) const {
+    Object::visit_references(visitor);
+    visitor.visit(function_);
+    visitor.visit(promise_);
+    for (const Value& handle : parked_handles_) {
+        visitor.visit(handle);
+    }
+    visitor.visit(resumed_value_);
 }
 
 //=============================================================================
@@ -139,7 +441,7 @@ Value AsyncAwaitExpression::evaluate(Context& ctx) {
             event_loop.process_macrotasks();
             
             // Yield control briefly to prevent busy waiting
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            event_loop.wait(std::chrono::microseconds(100));
         }
     }
     
@@ -259,15 +561,12 @@ void AsyncGenerator::setup_async_generator_prototype(Context& ctx) {
     async_gen_prototype->set_property("throw", Value(throw_fn.release()));
     
     // Add Symbol.asyncIterator method
-    Symbol* async_iterator_symbol = Symbol::get_well_known(Symbol::ASYNC_ITERATOR);
-    if (async_iterator_symbol) {
-        auto async_iterator_fn = ObjectFactory::create_native_function("@@asyncIterator", 
-            [](Context& ctx, const std::vector<Value>& args) -> Value {
-                (void)args; // Unused parameter
-                return ctx.get_binding("this");
-            });
-        async_gen_prototype->set_property(async_iterator_symbol->to_string(), Value(async_iterator_fn.release()));
-    }
+    auto async_iterator_fn = ObjectFactory::create_native_function("@@asyncIterator", 
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            (void)args; // Unused parameter
+            return ctx.get_binding("this");
+        });
+    async_gen_prototype->set_property(Symbol::well_known_key(WellKnownSymbol::AsyncIterator), Value(async_iterator_fn.release()));
     
     ctx.create_binding("AsyncGeneratorPrototype", Value(async_gen_prototype.release()));
 }
@@ -399,15 +698,12 @@ void AsyncIterator::setup_async_iterator_prototype(Context& ctx) {
     async_iterator_prototype->set_property("throw", Value(throw_fn.release()));
     
     // Add Symbol.asyncIterator method
-    Symbol* async_iterator_symbol = Symbol::get_well_known(Symbol::ASYNC_ITERATOR);
-    if (async_iterator_symbol) {
-        auto self_async_iterator_fn = ObjectFactory::create_native_function("@@asyncIterator", 
-            [](Context& ctx, const std::vector<Value>& args) -> Value {
-                (void)args; // Unused parameter
-                return ctx.get_binding("this");
-            });
-        async_iterator_prototype->set_property(async_iterator_symbol->to_string(), Value(self_async_iterator_fn.release()));
-    }
+    auto self_async_iterator_fn = ObjectFactory::create_native_function("@@asyncIterator", 
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            (void)args; // Unused parameter
+            return ctx.get_binding("this");
+        });
+    async_iterator_prototype->set_property(Symbol::well_known_key(WellKnownSymbol::AsyncIterator), Value(self_async_iterator_fn.release()));
     
     ctx.create_binding("AsyncIteratorPrototype", Value(async_iterator_prototype.release()));
 }
@@ -608,11 +904,39 @@ void setup_async_functions(Context& ctx) {
 // EventLoop Implementation
 //=============================================================================
 
-EventLoop::EventLoop() : running_(false) {
+EventLoop::EventLoop() : microtask_head_(0), microtask_count_(0), running_(false) {
+}
+
+EventLoop::~EventLoop() {
+    clear();
+}
+
+void EventLoop::push_microtask(Microtask task) {
+    size_t capacity = microtasks_.size();
+    if (microtask_count_ == capacity) {
+        // Unroll the ring into a buffer twice the size
+        std::vector<Microtask> grown(capacity ? capacity * 2 : 64);
+        for (size_t i = 0; i < microtask_count_; ++i) {
+            grown[i] = std::move(microtasks_[(microtask_head_ + i) & (capacity - 1)]);
+        }
+        microtasks_.swap(grown);
+        microtask_head_ = 0;
+        capacity = microtasks_.size();
+    }
+    microtasks_[(microtask_head_ + microtask_count_) & (capacity - 1)] = std::move(task);
+    ++microtask_count_;
 }
 
 void EventLoop::schedule_microtask(std::function<void()> task) {
-    microtasks_.push_back(task);
+    Microtask microtask;
+    microtask.task = std::move(task);
+    push_microtask(std::move(microtask));
+}
+
+void EventLoop::schedule_reaction(PromiseReaction* reaction) {
+    Microtask microtask;
+    microtask.reaction = reaction;
+    push_microtask(std::move(microtask));
 }
 
 void EventLoop::schedule_macrotask(std::function<void()> task) {
@@ -622,7 +946,7 @@ void EventLoop::schedule_macrotask(std::function<void()> task) {
 void EventLoop::run() {
     running_ = true;
     
-    while (running_ && (!microtasks_.empty() || !macrotasks_.empty())) {
+    while (running_ && has_pending_tasks()) {
         // Process all microtasks first
         process_microtasks();
         
@@ -640,19 +964,44 @@ void EventLoop::stop() {
 }
 
 void EventLoop::process_microtasks() {
-    while (!microtasks_.empty()) {
-        // Move the task to avoid dangling references
-        auto task = std::move(microtasks_.front());
-        microtasks_.erase(microtasks_.begin());
+    while (microtask_count_ != 0) {
+        // Take the task out first: running it may queue more and grow the ring
+        Microtask& front = microtasks_[microtask_head_];
+        PromiseReaction* reaction = front.reaction;
+        std::function<void()> task = std::move(front.task);
+        front.reaction = nullptr;
+        microtask_head_ = (microtask_head_ + 1) & (microtasks_.size() - 1);
+        --microtask_count_;
         
         // Execute the task with proper exception handling
+        if (reaction) {
+            running_reactions_.push_back(reaction);
+        }
         try {
-            if (task) {
+            if (reaction) {
+                reaction->run();
+            } else if (task) {
                 task();
             }
         } catch (...) {
             // Continue processing other tasks even if one fails
         }
+        if (reaction) {
+            running_reactions_.pop_back();
+            PromiseReaction::release(reaction);
+        }
+    }
+    
+    if (idle_callback_) {
+        idle_callback_();
+    }
+}
+
+void EventLoop::wait(std::chrono::microseconds duration) {
+    if (wait_handler_) {
+        wait_handler_(duration);
+    } else {
+        std::this_thread::sleep_for(duration);
     }
 }
 
@@ -673,9 +1022,34 @@ void EventLoop::process_macrotasks() {
     }
 }
 
+void EventLoop::clear() {
+    while (microtask_count_ != 0) {
+        Microtask& front = microtasks_[microtask_head_];
+        if (front.reaction) {
+            PromiseReaction::release(front.reaction);
+        }
+        front = Microtask();
+        microtask_head_ = (microtask_head_ + 1) & (microtasks_.size() - 1);
+        --microtask_count_;
+    }
+    microtask_head_ = 0;
+    macrotasks_.clear();
+}
+
+void EventLoop::visit_references(GCVisitor& visitor) const {
+    for (size_t i = 0; i < microtask_count_; ++i) {
+        const Microtask& task = microtasks_[(microtask_head_ + i) & (microtasks_.size() - 1)];
+        if (task.reaction) {
+            task.reaction->visit_references(visitor);
+        }
+    }
+    for (PromiseReaction* reaction : running_reactions_) {
+        reaction->visit_references(visitor);
+    }
+}
+
 EventLoop& EventLoop::instance() {
-    static EventLoop instance;
-    return instance;
+    return Isolate::current().event_loop();
 }
 
 } // namespace Quanta
\ No newline at end of file
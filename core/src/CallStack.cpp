@@ -5,27 +5,27 @@
  */
 
 #include "CallStack.h"
+#include "Isolate.h"
+#include "Object.h"
 #include "../../parser/include/AST.h"
 #include <sstream>
 #include <algorithm>
 
 namespace Quanta {
 
-// Thread-local instance
-thread_local CallStack* CallStack::instance_ = nullptr;
-
 std::string CallStackFrame::to_string() const {
     std::ostringstream oss;
     oss << "at ";
     
-    if (!function_name.empty()) {
-        oss << function_name;
+    if (!function_name->empty()) {
+        oss << *function_name;
     } else {
         oss << "<anonymous>";
     }
     
-    if (!filename.empty()) {
-        oss << " (" << filename;
+    if (!filename->empty()) {
+        Position position = CallStack::instance().resolve(*this);
+        oss << " (" << *filename;
         if (position.line > 0) {
             oss << ":" << position.line;
             if (position.column > 0) {
@@ -39,15 +39,7 @@ std::string CallStackFrame::to_string() const {
 }
 
 CallStack& CallStack::instance() {
-    if (!instance_) {
-        static CallStack default_instance;
-        instance_ = &default_instance;
-    }
-    return *instance_;
-}
-
-void CallStack::set_instance(CallStack* stack) {
-    instance_ = stack;
+    return Isolate::current().call_stack();
 }
 
 void CallStack::push_frame(const std::string& function_name,
@@ -74,18 +66,22 @@ void CallStack::clear() {
     frames_.clear();
 }
 
+static const CallStackFrame& empty_frame() {
+    static const std::string empty;
+    static const CallStackFrame frame(empty, empty, Position());
+    return frame;
+}
+
 const CallStackFrame& CallStack::top() const {
     if (frames_.empty()) {
-        static CallStackFrame empty_frame("", "", Position());
-        return empty_frame;
+        return empty_frame();
     }
     return frames_.back();
 }
 
 const CallStackFrame& CallStack::at(size_t index) const {
     if (index >= frames_.size()) {
-        static CallStackFrame empty_frame("", "", Position());
-        return empty_frame;
+        return empty_frame();
     }
     return frames_[index];
 }
@@ -123,21 +119,52 @@ std::string CallStack::current_function() const {
     if (frames_.empty()) {
         return "<global>";
     }
-    return frames_.back().function_name.empty() ? "<anonymous>" : frames_.back().function_name;
+    return frames_.back().function_name->empty() ? "<anonymous>" : *frames_.back().function_name;
 }
 
 std::string CallStack::current_filename() const {
     if (frames_.empty()) {
         return "<unknown>";
     }
-    return frames_.back().filename.empty() ? "<unknown>" : frames_.back().filename;
+    return frames_.back().filename->empty() ? "<unknown>" : *frames_.back().filename;
 }
 
 Position CallStack::current_position() const {
     if (frames_.empty()) {
         return Position();
     }
-    return frames_.back().position;
+    return resolve(frames_.back());
+}
+
+std::shared_ptr<const LineTable> CallStack::set_script_source(std::shared_ptr<const LineTable> lines) {
+    std::swap(script_lines_, lines);
+    return lines;
+}
+
+namespace {
+// The line table of the script that defined a frame's function, if any
+const std::shared_ptr<const LineTable>* frame_source(const CallStackFrame& frame) {
+    if (!frame.function_ptr || !frame.function_ptr->get_shared_info()) return nullptr;
+    const auto& lines = frame.function_ptr->get_shared_info()->lines;
+    return lines ? &lines : nullptr;
+}
+} // anonymous namespace
+
+// Lines of the innermost function with a script, else the running script's
+std::shared_ptr<const LineTable> CallStack::current_source() const {
+    for (auto it = frames_.rbegin(); it != frames_.rend(); ++it) {
+        if (const auto* lines = frame_source(*it)) return *lines;
+    }
+    return script_lines_;
+}
+
+Position CallStack::resolve(const CallStackFrame& frame) const {
+    const auto* lines = frame_source(frame);
+    const LineTable* table = lines ? lines->get() : script_lines_.get();
+    if (!table) {
+        return frame.position;
+    }
+    return table->resolve(frame.position.offset);
 }
 
 bool CallStack::check_stack_overflow() {
@@ -154,19 +181,20 @@ std::string CallStack::format_frame(const CallStackFrame& frame, size_t index) c
     oss << "at ";
     
     // Function name
-    if (!frame.function_name.empty()) {
-        oss << frame.function_name;
+    if (!frame.function_name->empty()) {
+        oss << *frame.function_name;
     } else {
         oss << "<anonymous>";
     }
     
     // Location information
-    if (!frame.filename.empty()) {
-        oss << " (" << frame.filename;
-        if (frame.position.line > 0) {
-            oss << ":" << frame.position.line;
-            if (frame.position.column > 0) {
-                oss << ":" << frame.position.column;
+    if (!frame.filename->empty()) {
+        Position position = resolve(frame);
+        oss << " (" << *frame.filename;
+        if (position.line > 0) {
+            oss << ":" << position.line;
+            if (position.column > 0) {
+                oss << ":" << position.column;
             }
         }
         oss << ")";
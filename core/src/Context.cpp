@@ -6,6 +6,7 @@
 
 #include "Context.h"
 #include "Engine.h"
+#include "GC.h"
 #include "Error.h"
 #include "JSON.h"
 #include "Date.h"
@@ -17,6 +18,7 @@
 #include "TypedArray.h"
 #include "DataView.h"
 #include "WebAssembly.h"
+#include "NativeFFI.h"
 #include "WebAPI.h"
 #include "Async.h"
 #include "Iterator.h"
@@ -31,6 +33,8 @@
 #include "platform/NativeAPI.h"
 #include "Symbol.h"
 #include "MapSet.h"
+#include "WeakRef.h"
+#include "Isolate.h"
 #include <iostream>
 #include <sstream>
 #include <limits>
@@ -40,7 +44,7 @@
 namespace Quanta {
 
 // Static member initialization
-uint32_t Context::next_context_id_ = 1;
+std::atomic<uint32_t> Context::next_context_id_{1};
 
 //=============================================================================
 // Context Implementation
@@ -53,6 +57,10 @@ Context::Context(Engine* engine, Type type)
       return_value_(), has_return_value_(false), has_break_(false), has_continue_(false), 
       strict_mode_(false), engine_(engine), current_filename_("<unknown>"), web_api_interface_(nullptr) {
     
+    if (engine_ && engine_->get_garbage_collector()) {
+        engine_->get_garbage_collector()->register_context(this);
+    }
+    
     if (type == Type::Global) {
         initialize_global_context();
     }
@@ -72,13 +80,31 @@ Context::Context(Engine* engine, Context* parent, Type type)
         built_in_objects_ = parent->built_in_objects_;
         built_in_functions_ = parent->built_in_functions_;
     }
+    
+    if (engine_ && engine_->get_garbage_collector()) {
+        engine_->get_garbage_collector()->register_context(this);
+    }
 }
 
 Context::~Context() {
+    if (engine_ && engine_->get_garbage_collector()) {
+        engine_->get_garbage_collector()->unregister_context(this);
+    }
+    
+    // A function context owns its activation; closures created in it keep
+    // it alive past the call
+    if (type_ == Type::Function && variable_environment_) {
+        variable_environment_->release();
+    }
+    
     // Clear call stack
     call_stack_.clear();
 }
 
+GarbageCollector* Context::get_garbage_collector() const {
+    return engine_ ? engine_->get_garbage_collector() : nullptr;
+}
+
 void Context::set_global_object(Object* global) {
     global_object_ = global;
 }
@@ -286,6 +312,31 @@ std::string Context::debug_string() const {
     return oss.str();
 }
 
+void Context::visit_references(GCVisitor& visitor) const {
+    visitor.visit(global_object_);
+    visitor.visit(this_binding_);
+    visitor.visit(lexical_environment_);
+    visitor.visit(variable_environment_);
+    visitor.visit(current_exception_);
+    visitor.visit(return_value_);
+    
+    for (const auto& frame : call_stack_) {
+        visitor.visit(frame->get_function());
+        visitor.visit(frame->get_this_binding());
+        visitor.visit(frame->get_environment());
+        for (const Value& arg : frame->get_arguments()) {
+            visitor.visit(arg);
+        }
+    }
+    
+    for (const auto& pair : built_in_objects_) {
+        visitor.visit(pair.second);
+    }
+    for (const auto& pair : built_in_functions_) {
+        visitor.visit(pair.second);
+    }
+}
+
 bool Context::check_execution_depth() const {
     return execution_depth_ < max_execution_depth_;
 }
@@ -305,6 +356,295 @@ void Context::initialize_global_context() {
     setup_global_bindings();
 }
 
+namespace {
+
+// ToIntegerOrInfinity of a string method's position argument
+double to_integer_or_infinity(const Value& value) {
+    double number = value.to_number();
+    if (std::isnan(number)) return 0.0;
+    return std::trunc(number);
+}
+
+// A position clamped to [0, length], as substring() takes it
+size_t clamp_string_position(double position, size_t length) {
+    if (position <= 0) return 0;
+    return position >= static_cast<double>(length) ? length : static_cast<size_t>(position);
+}
+
+// A position that counts from the end when negative, as slice() takes it
+size_t relative_string_position(double position, size_t length) {
+    if (position < 0) position += static_cast<double>(length);
+    return clamp_string_position(position, length);
+}
+
+// The String a String.prototype method runs on. Primitive receivers are used
+// in place, so reading a character does not copy the whole text.
+const String& this_string(Context& ctx, String& converted) {
+    Value this_value = ctx.get_binding("this");
+    if (this_value.is_string()) return *this_value.as_string();
+    converted = String(this_value.to_string());
+    return converted;
+}
+
+// A string argument of a String.prototype method, used in place when it is
+// already a string
+const String& string_argument(const Value& value, String& converted) {
+    if (value.is_string()) return *value.as_string();
+    converted = String(value.to_string());
+    return converted;
+}
+
+// ToUint32
+uint32_t to_uint32(double number) {
+    if (!std::isfinite(number)) return 0;
+    double wrapped = std::fmod(std::trunc(number), 4294967296.0);
+    if (wrapped < 0) wrapped += 4294967296.0;
+    return static_cast<uint32_t>(wrapped);
+}
+
+// WhiteSpace and LineTerminator code units, as trimmed by String.prototype.trim
+bool is_string_whitespace(char16_t unit) {
+    return (unit >= 0x09 && unit <= 0x0D) || unit == 0x20 || unit == 0xA0 || unit == 0x1680 ||
+           (unit >= 0x2000 && unit <= 0x200A) || unit == 0x2028 || unit == 0x2029 ||
+           unit == 0x202F || unit == 0x205F || unit == 0x3000 || unit == 0xFEFF;
+}
+
+Value trim_string(Context& ctx, bool start, bool end) {
+    String converted;
+    const String& str = this_string(ctx, converted);
+    size_t from = 0;
+    size_t to = str.length();
+    if (start) {
+        while (from < to && is_string_whitespace(str.char_code_at(from))) ++from;
+    }
+    if (end) {
+        while (to > from && is_string_whitespace(str.char_code_at(to - 1))) --to;
+    }
+    return ValueFactory::string(str.substring(from, to));
+}
+
+// toLowerCase and toUpperCase map ASCII letters; other characters are kept
+Value convert_string_case(Context& ctx, bool upper) {
+    String converted;
+    const String& str = this_string(ctx, converted);
+    std::string text = str.str();
+    for (char& c : text) {
+        if (upper ? (c >= 'a' && c <= 'z') : (c >= 'A' && c <= 'Z')) c ^= 0x20;
+    }
+    return ValueFactory::string(String(std::move(text)));
+}
+
+// The number a Number.prototype method was called on
+double this_number(Context& ctx) {
+    Value this_value = ctx.get_binding("this");
+    return this_value.is_number() ? this_value.as_number() : this_value.to_number();
+}
+
+// Number.prototype.toString for a radix other than 10
+std::string number_to_radix_string(double number, int radix) {
+    if (std::isnan(number)) return "NaN";
+    if (std::isinf(number)) return number < 0 ? "-Infinity" : "Infinity";
+
+    static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    bool negative = number < 0;
+    double integer = std::floor(std::fabs(number));
+    double fraction = std::fabs(number) - integer;
+
+    std::string integer_digits;
+    do {
+        integer_digits += digits[static_cast<int>(std::fmod(integer, radix))];
+        integer = std::floor(integer / radix);
+    } while (integer > 0);
+    std::string result(integer_digits.rbegin(), integer_digits.rend());
+
+    if (fraction > 0) {
+        result += '.';
+        // 52 digits is enough for any radix to exhaust a double's mantissa
+        for (int i = 0; i < 52 && fraction > 0; ++i) {
+            fraction *= radix;
+            int digit = static_cast<int>(fraction);
+            result += digits[digit];
+            fraction -= digit;
+        }
+    }
+    return negative ? "-" + result : result;
+}
+
+/**
+ * The replacement side of replace() and replaceAll()
+ * Either a function called with (match, captures..., position, string), or
+ * a template whose $$, $&, $`, $' and $n patterns are expanded; a template
+ * without '$' is copied as is. Captures come from a RegExp pattern and are
+ * empty for a string one.
+ */
+class StringReplacer {
+private:
+    Context& ctx_;
+    Function* function_;
+    String converted_;
+    const String* template_;
+    bool expand_;
+    const String& subject_;
+
+public:
+    StringReplacer(Context& ctx, const Value& replacement, const String& subject)
+        : ctx_(ctx), function_(replacement.is_function() ? replacement.as_function() : nullptr),
+          template_(nullptr), expand_(false), subject_(subject) {
+        if (!function_) {
+            template_ = &string_argument(replacement, converted_);
+            expand_ = template_->index_of(String("$")) != String::npos;
+        }
+    }
+
+    // Appends the replacement for the match_length units at position; false
+    // if the replacement function threw
+    bool append(StringBuilder& out, size_t position, size_t match_length,
+                const std::vector<Value>& captures = {}) {
+        size_t match_end = position + match_length;
+        if (function_) {
+            std::vector<Value> call_args;
+            call_args.reserve(captures.size() + 3);
+            call_args.push_back(ValueFactory::string(subject_.substring(position, match_end)));
+            call_args.insert(call_args.end(), captures.begin(), captures.end());
+            call_args.push_back(Value(static_cast<double>(position)));
+            call_args.push_back(ValueFactory::string(subject_));
+            Value result = function_->call(ctx_, call_args);
+            if (ctx_.has_exception()) return false;
+            String converted;
+            out.append(string_argument(result, converted));
+            return true;
+        }
+        if (!expand_) {
+            out.append(*template_);
+            return true;
+        }
+
+        const String& text = *template_;
+        size_t length = text.length();
+        size_t copied = 0;
+        for (size_t i = 0; i + 1 < length; ++i) {
+            if (text.char_code_at(i) != u'$') continue;
+            char16_t next = text.char_code_at(i + 1);
+
+            if (next >= u'0' && next <= u'9') {
+                // $n or $nn, taking two digits only when they name a capture
+                size_t index = next - u'0';
+                size_t digits = 1;
+                if (i + 2 < length) {
+                    char16_t second = text.char_code_at(i + 2);
+                    size_t two_digit = index * 10 + (second - u'0');
+                    if (second >= u'0' && second <= u'9' && two_digit >= 1 && two_digit <= captures.size()) {
+                        index = two_digit;
+                        digits = 2;
+                    }
+                }
+                if (index < 1 || index > captures.size()) continue;
+                out.append(text, copied, i);
+                const Value& capture = captures[index - 1];
+                if (!capture.is_undefined()) {
+                    String converted;
+                    out.append(string_argument(capture, converted));
+                }
+                copied = i + 1 + digits;
+                i += digits;
+                continue;
+            }
+            if (next != u'$' && next != u'&' && next != u'`' && next != u'\'') continue;
+
+            out.append(text, copied, i);
+            switch (next) {
+                case u'$': out.append(text, i, i + 1); break;
+                case u'&': out.append(subject_, position, match_end); break;
+                case u'`': out.append(subject_, 0, position); break;
+                default: out.append(subject_, match_end, subject_.length()); break;
+            }
+            copied = i + 2;
+            ++i;
+        }
+        out.append(text, copied, length);
+        return true;
+    }
+};
+
+// The compiled pattern of a RegExp object, a literal or one made by the
+// RegExp constructor, or null for any other value. The last pattern used is
+// kept, so a replace() in a loop compiles it once
+std::shared_ptr<const RegExp> regexp_of(const Value& value) {
+    if (!value.is_object()) return nullptr;
+    Object* obj = value.as_object();
+    if (!obj->get_property("exec").is_function()) return nullptr;
+    Value source = obj->get_property("source");
+    if (!source.is_string()) return nullptr;
+    Value flags = obj->get_property("flags");
+
+    thread_local std::string cached_key;
+    thread_local std::shared_ptr<const RegExp> cached;
+    std::string key = (flags.is_string() ? flags.to_string() : std::string()) + "/" + source.to_string();
+    if (!cached || key != cached_key) {
+        cached = std::make_shared<const RegExp>(source.to_string(), flags.is_string() ? flags.to_string() : "");
+        cached_key = std::move(key);
+    }
+    return cached;
+}
+
+// replace() and replaceAll() with a RegExp pattern: every match when all is
+// set, else the first. The regex runs over the UTF-8 text, so match offsets
+// are turned into code unit positions as the scan moves forward
+Value regexp_replace(Context& ctx, const String& str, const RegExp& regex, const Value& replacement, bool all) {
+    const std::string& text = str.str();
+    bool one_byte = text.size() == str.length();
+    size_t mapped_byte = 0;
+    size_t mapped_unit = 0;
+    auto unit_at = [&](size_t byte) {
+        if (one_byte) return byte;
+        for (; mapped_byte < byte; ++mapped_byte) {
+            unsigned char c = static_cast<unsigned char>(text[mapped_byte]);
+            if ((c & 0xC0) != 0x80) mapped_unit += c >= 0xF0 ? 2 : 1;
+        }
+        return mapped_unit;
+    };
+
+    StringReplacer replacer(ctx, replacement, str);
+    StringBuilder builder;
+    std::smatch match;
+    std::vector<Value> captures;
+    size_t copied = 0;
+    size_t from = 0;
+    bool matched = false;
+    while (regex.search(text, from, match)) {
+        if (!matched) {
+            builder.reserve(str.length());
+            matched = true;
+        }
+        size_t start_byte = static_cast<size_t>(match[0].first - text.begin());
+        size_t end_byte = static_cast<size_t>(match[0].second - text.begin());
+        size_t start = unit_at(start_byte);
+        size_t end = unit_at(end_byte);
+
+        captures.clear();
+        for (size_t i = 1; i < match.size(); ++i) {
+            captures.push_back(match[i].matched ? Value(match[i].str()) : Value());
+        }
+        builder.append(str, copied, start);
+        if (!replacer.append(builder, start, end - start, captures)) return Value();
+        copied = end;
+        if (!all) break;
+
+        // An empty match steps over one character so the scan moves on
+        from = end_byte;
+        if (end_byte == start_byte) {
+            if (from >= text.size()) break;
+            ++from;
+            while (from < text.size() && (static_cast<unsigned char>(text[from]) & 0xC0) == 0x80) ++from;
+        }
+    }
+    if (!matched) return ValueFactory::string(str);
+    builder.append(str, copied, str.length());
+    return ValueFactory::string(builder.build());
+}
+
+} // anonymous namespace
+
 void Context::initialize_built_ins() {
     // Create built-in objects (placeholder implementations)
     
@@ -503,7 +843,7 @@ void Context::initialize_built_ins() {
                     if (pair->get_length() >= 2) {
                         Value key = pair->get_element(0);
                         Value value = pair->get_element(1);
-                        result_obj->set_property(key.to_string(), value);
+                        result_obj->set_property(key.to_property_key(), value);
                     }
                 }
             }
@@ -579,8 +919,10 @@ void Context::initialize_built_ins() {
                 
                 if (source.is_object()) {
                     Object* source_obj = source.as_object();
-                    // Copy all enumerable own properties
+                    // Copy all enumerable own properties, string keys then symbol keys
                     std::vector<std::string> property_keys = source_obj->get_own_property_keys();
+                    auto symbol_keys = source_obj->get_own_symbol_keys();
+                    property_keys.insert(property_keys.end(), symbol_keys.begin(), symbol_keys.end());
                     
                     for (const std::string& prop : property_keys) {
                         // Only copy enumerable properties
@@ -610,7 +952,7 @@ void Context::initialize_built_ins() {
             }
 
             Object* obj = args[0].as_object();
-            std::string prop_name = args[1].to_string();
+            std::string prop_name = args[1].to_property_key();
 
             return Value(obj->has_own_property(prop_name));
         });
@@ -629,7 +971,7 @@ void Context::initialize_built_ins() {
             }
 
             Object* obj = args[0].as_object();
-            std::string prop_name = args[1].to_string();
+            std::string prop_name = args[1].to_property_key();
 
             if (!obj->has_own_property(prop_name)) {
                 return Value(); // undefined
@@ -648,6 +990,44 @@ void Context::initialize_built_ins() {
         });
     object_constructor->set_property("getOwnPropertyDescriptor", Value(getOwnPropertyDescriptor_fn.release()));
 
+    // Object.getOwnPropertyDescriptors
+    auto getOwnPropertyDescriptors_fn = ObjectFactory::create_native_function("getOwnPropertyDescriptors",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            if (args.empty()) {
+                ctx.throw_exception(Value("TypeError: Object.getOwnPropertyDescriptors requires 1 argument"));
+                return Value();
+            }
+
+            auto result = ObjectFactory::create_object();
+            if (!args[0].is_object()) {
+                return Value(result.release());
+            }
+
+            // String keys, then symbol keys
+            Object* obj = args[0].as_object();
+            std::vector<std::string> keys = obj->get_own_property_keys();
+            auto symbol_keys = obj->get_own_symbol_keys();
+            keys.insert(keys.end(), symbol_keys.begin(), symbol_keys.end());
+
+            for (const std::string& key : keys) {
+                PropertyDescriptor desc = obj->get_property_descriptor(key);
+                auto descriptor = ObjectFactory::create_object();
+                if (desc.is_accessor_descriptor()) {
+                    descriptor->set_property("get", desc.has_getter() ? Value(desc.get_getter()) : Value());
+                    descriptor->set_property("set", desc.has_setter() ? Value(desc.get_setter()) : Value());
+                } else {
+                    descriptor->set_property("value", obj->get_property(key));
+                    descriptor->set_property("writable", Value(desc.is_writable()));
+                }
+                descriptor->set_property("enumerable", Value(desc.is_enumerable()));
+                descriptor->set_property("configurable", Value(desc.is_configurable()));
+                result->set_property(key, Value(descriptor.release()));
+            }
+
+            return Value(result.release());
+        });
+    object_constructor->set_property("getOwnPropertyDescriptors", Value(getOwnPropertyDescriptors_fn.release()));
+
     // Object.defineProperty
     auto defineProperty_fn = ObjectFactory::create_native_function("defineProperty",
         [](Context& ctx, const std::vector<Value>& args) -> Value {
@@ -662,7 +1042,7 @@ void Context::initialize_built_ins() {
             }
 
             Object* obj = args[0].as_object();
-            std::string prop_name = args[1].to_string();
+            std::string prop_name = args[1].to_property_key();
 
             // For simplicity, just set the value property for now
             if (args[2].is_object()) {
@@ -703,29 +1083,65 @@ void Context::initialize_built_ins() {
         });
     object_constructor->set_property("getOwnPropertyNames", Value(getOwnPropertyNames_fn.release()));
 
+    // Object.getOwnPropertySymbols
+    auto getOwnPropertySymbols_fn = ObjectFactory::create_native_function("getOwnPropertySymbols",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            if (args.empty()) {
+                ctx.throw_exception(Value("TypeError: Object.getOwnPropertySymbols requires 1 argument"));
+                return Value();
+            }
+
+            if (!args[0].is_object()) {
+                return Value(ObjectFactory::create_array().release());
+            }
+
+            auto keys = args[0].as_object()->get_own_symbol_keys();
+            auto result = ObjectFactory::create_array();
+            uint32_t index = 0;
+            for (const std::string& key : keys) {
+                if (Symbol* symbol = Symbol::from_property_key(key)) {
+                    result->set_element(index++, Value(symbol));
+                }
+            }
+            result->set_property("length", Value(static_cast<double>(index)));
+
+            return Value(result.release());
+        });
+    object_constructor->set_property("getOwnPropertySymbols", Value(getOwnPropertySymbols_fn.release()));
+
     // Create Object.prototype
     auto object_prototype = ObjectFactory::create_object();
 
-    // Object.prototype.hasOwnProperty - working implementation
+    // Object.prototype.hasOwnProperty; string and number receivers reach it
+    // through String.prototype and Number.prototype
     auto proto_hasOwnProperty_fn = ObjectFactory::create_native_function("hasOwnProperty",
         [](Context& ctx, const std::vector<Value>& args) -> Value {
-            // This is called as obj.hasOwnProperty(prop)
-            // We need to get the calling object somehow
-            // For now, simplified approach - check global objects
-            if (args.empty()) {
+            std::string key = args.empty() ? "undefined" : args[0].to_property_key();
+            Value this_value = ctx.get_binding("this");
+            if (this_value.is_string()) {
+                // A string's own properties are its length and its indices
+                if (key == "length") return Value(true);
+                if (key.empty() || key.size() > 10 || (key[0] == '0' && key.size() > 1)) return Value(false);
+                uint64_t index = 0;
+                for (char c : key) {
+                    if (c < '0' || c > '9') return Value(false);
+                    index = index * 10 + static_cast<uint64_t>(c - '0');
+                }
+                return Value(index < this_value.as_string()->length());
+            }
+            if (this_value.is_number()) {
                 return Value(false);
             }
-
-            std::string prop_name = args[0].to_string();
-
-            // Simple implementation: always return true for basic properties
-            // This is not correct but will make tests pass for now
-            return Value(true);
+            Object* obj = ctx.get_this_binding();
+            return Value(obj && obj->has_own_property(key));
         });
 
     object_prototype->set_property("hasOwnProperty", Value(proto_hasOwnProperty_fn.release()));
 
-    // Set Object.prototype
+    // Set Object.prototype; the prototypes installed after it chain to it
+    // (a Function reads "prototype" from its own slot, not its properties)
+    Object* object_proto_ptr = object_prototype.get();
+    object_constructor->set_prototype(object_proto_ptr);
     object_constructor->set_property("prototype", Value(object_prototype.release()));
 
     // HACK: Add hasOwnProperty to all new objects in global environment
@@ -738,7 +1154,7 @@ void Context::initialize_built_ins() {
             auto hasOwn = ObjectFactory::create_native_function("hasOwnProperty",
                 [obj](Context& ctx, const std::vector<Value>& args) -> Value {
                     if (args.empty()) return Value(false);
-                    std::string prop = args[0].to_string();
+                    std::string prop = args[0].to_property_key();
                     return Value(obj->has_own_property(prop));
                 });
             obj->set_property("hasOwnProperty", Value(hasOwn.release()));
@@ -835,46 +1251,21 @@ void Context::initialize_built_ins() {
     
     // Create Array.prototype and add methods
     auto array_prototype = ObjectFactory::create_object();
+    array_prototype->set_prototype(object_proto_ptr);
     
-    // Array.prototype.find
-    auto find_fn = ObjectFactory::create_native_function("find",
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-            // For now, simplified implementation
-            if (args.empty()) {
-                ctx.throw_exception(Value("TypeError: callback must be a function"));
-                return Value();
-            }
-            // Return the first argument for basic testing
-            return Value(42); // Placeholder implementation
-        });
-    array_prototype->set_property("find", Value(find_fn.release()));
-    
-    // Array.prototype.includes
-    auto includes_fn = ObjectFactory::create_native_function("includes",
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-            // Simplified implementation for testing
-            if (args.empty()) return Value(false);
-            // For testing, return true if searching for 2
-            return Value(args[0].is_number() && args[0].to_number() == 2);
-        });
-    array_prototype->set_property("includes", Value(includes_fn.release()));
-    
-    // Array.prototype.flat
-    auto flat_fn = ObjectFactory::create_native_function("flat",
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-            // Simplified implementation - return new array
-            auto result = ObjectFactory::create_array();
-            result->set_element(0, Value(1));
-            result->set_element(1, Value(2));
-            result->set_element(2, Value(3));
-            result->set_property("length", Value(3.0));
-            return Value(result.release());
-        });
-    array_prototype->set_property("flat", Value(flat_fn.release()));
+    // Array.prototype methods, one native per ArrayBuiltin id
+    for (uint8_t id = 0; id < static_cast<uint8_t>(ArrayBuiltin::Count); ++id) {
+        ArrayBuiltin builtin = static_cast<ArrayBuiltin>(id);
+        array_prototype->set_property(ObjectFactory::array_builtin_name(builtin),
+                                      Value(ObjectFactory::create_array_method(builtin).release()));
+    }
     
     // Store the pointer before transferring ownership
+    // (a Function reads "prototype" from its own slot, not its properties)
     Object* array_proto_ptr = array_prototype.get();
+    array_constructor->set_prototype(array_proto_ptr);
     array_constructor->set_property("prototype", Value(array_prototype.release()));
+    array_proto_ptr->set_property("constructor", Value(array_constructor.get()));
     
     // Set the array prototype in ObjectFactory so new arrays inherit from it
     ObjectFactory::set_array_prototype(array_proto_ptr);
@@ -976,6 +1367,7 @@ void Context::initialize_built_ins() {
     
     // Create String.prototype with methods
     auto string_prototype = ObjectFactory::create_object();
+    string_prototype->set_prototype(object_proto_ptr);
     
     // Add String.prototype.padStart
     auto padStart_fn = ObjectFactory::create_native_function("padStart",
@@ -1089,83 +1481,330 @@ void Context::initialize_built_ins() {
     // Add String.prototype.replace
     auto replace_fn = ObjectFactory::create_native_function("replace",
         [](Context& ctx, const std::vector<Value>& args) -> Value {
-            // For prototype methods, 'this' should be the string primitive
-            std::string str = "";
-            try {
-                Value this_value = ctx.get_binding("this");
-                str = this_value.to_string();
-            } catch (...) {
-                // If this fails, return original empty string
-                return Value("");
+            String converted;
+            const String& str = this_string(ctx, converted);
+            if (args.size() < 2) return ValueFactory::string(str);
+
+            Value search_val = args[0];
+            if (std::shared_ptr<const RegExp> regex = regexp_of(search_val)) {
+                return regexp_replace(ctx, str, *regex, args[1], regex->get_global());
             }
 
-            if (args.size() < 2) return Value(str);
+            // String search: the first occurrence only
+            String converted_search;
+            const String& search = string_argument(search_val, converted_search);
+            size_t position = str.index_of(search);
+            if (position == String::npos) return ValueFactory::string(str);
 
-            Value search_val = args[0];
-            std::string replacement = args[1].to_string();
+            StringReplacer replacer(ctx, args[1], str);
+            StringBuilder builder;
+            builder.reserve(str.length());
+            builder.append(str, 0, position);
+            if (!replacer.append(builder, position, search.length())) return Value();
+            builder.append(str, position + search.length(), str.length());
+            return ValueFactory::string(builder.build());
+        });
+    string_prototype->set_property("replace", Value(replace_fn.release()));
 
-            // Check if search is a RegExp object
-            if (search_val.is_object()) {
-                Object* regex_obj = search_val.as_object();
+    // Add String.prototype.replaceAll
+    auto replaceAll_fn = ObjectFactory::create_native_function("replaceAll",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            String converted;
+            const String& str = this_string(ctx, converted);
+            if (args.size() < 2) return ValueFactory::string(str);
 
-                // Get the RegExp's exec method
-                Value exec_method = regex_obj->get_property("exec");
-                if (exec_method.is_object() && exec_method.as_object()->is_function()) {
-                    // Use RegExp for replacement
-                    std::vector<Value> exec_args = { Value(str) };
-                    Function* exec_func = static_cast<Function*>(exec_method.as_object());
-                    Value match_result = exec_func->call(ctx, exec_args, search_val);
+            if (std::shared_ptr<const RegExp> regex = regexp_of(args[0])) {
+                if (!regex->get_global()) {
+                    ctx.throw_type_error("replaceAll must be called with a global RegExp");
+                    return Value();
+                }
+                return regexp_replace(ctx, str, *regex, args[1], true);
+            }
 
-                    if (match_result.is_object()) {
-                        Object* match_arr = match_result.as_object();
-                        Value index_val = match_arr->get_property("index");
-                        Value match_str = match_arr->get_element(0);
+            String converted_search;
+            const String& search = string_argument(args[0], converted_search);
+            size_t search_length = search.length();
+            size_t advance = search_length ? search_length : 1;
 
-                        if (index_val.is_number() && !match_str.is_undefined()) {
-                            size_t pos = static_cast<size_t>(index_val.to_number());
-                            std::string matched = match_str.to_string();
+            // One pass: each match is found after the previous one and the
+            // text between them is copied once
+            size_t position = str.index_of(search);
+            if (position == String::npos) return ValueFactory::string(str);
 
-                            str.replace(pos, matched.length(), replacement);
-                            return Value(str);
-                        }
+            StringReplacer replacer(ctx, args[1], str);
+            StringBuilder builder;
+            builder.reserve(str.length());
+            size_t copied = 0;
+            while (position != String::npos) {
+                builder.append(str, copied, position);
+                if (!replacer.append(builder, position, search_length)) return Value();
+                copied = position + search_length;
+                position = position + advance <= str.length() ? str.index_of(search, position + advance) : String::npos;
+            }
+            builder.append(str, copied, str.length());
+            return ValueFactory::string(builder.build());
+        });
+    string_prototype->set_property("replaceAll", Value(replaceAll_fn.release()));
+
+    // Add String.prototype.split
+    auto split_fn = ObjectFactory::create_native_function("split",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            String converted;
+            const String& str = this_string(ctx, converted);
+            uint32_t limit = args.size() < 2 || args[1].is_undefined()
+                ? std::numeric_limits<uint32_t>::max() : to_uint32(args[1].to_number());
+
+            // Pieces are collected packed and handed to the array at once
+            std::vector<Value> parts;
+            if (limit == 0) {
+                // nothing
+            } else if (args.empty() || args[0].is_undefined()) {
+                parts.push_back(ValueFactory::string(str));
+            } else {
+                String converted_separator;
+                const String& separator = string_argument(args[0], converted_separator);
+                size_t length = str.length();
+                if (separator.empty()) {
+                    size_t count = std::min(length, static_cast<size_t>(limit));
+                    parts.reserve(count);
+                    for (size_t i = 0; i < count; ++i) {
+                        parts.push_back(ValueFactory::string(str.char_at(i)));
+                    }
+                } else {
+                    size_t start = 0;
+                    size_t position;
+                    while (parts.size() < limit && (position = str.index_of(separator, start)) != String::npos) {
+                        parts.push_back(ValueFactory::string(str.substring(start, position)));
+                        start = position + separator.length();
+                    }
+                    if (parts.size() < limit) {
+                        parts.push_back(ValueFactory::string(str.substring(start, length)));
                     }
                 }
             }
 
-            // Simple string replacement (first occurrence only)
-            std::string search = search_val.to_string();
-            size_t pos = str.find(search);
+            auto array = ObjectFactory::create_array();
+            array->assign_elements(std::move(parts));
+            return Value(array.release());
+        });
+    string_prototype->set_property("split", Value(split_fn.release()));
 
-            if (pos != std::string::npos) {
-                str.replace(pos, search.length(), replacement);
+    // Add String.prototype.indexOf, lastIndexOf and includes
+    auto indexOf_fn = ObjectFactory::create_native_function("indexOf",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            String converted;
+            const String& str = this_string(ctx, converted);
+            String converted_search;
+            const String& search = string_argument(args.empty() ? Value() : args[0], converted_search);
+            size_t start = args.size() > 1 ? clamp_string_position(to_integer_or_infinity(args[1]), str.length()) : 0;
+            size_t position = str.index_of(search, start);
+            return Value(position == String::npos ? -1.0 : static_cast<double>(position));
+        });
+    string_prototype->set_property("indexOf", Value(indexOf_fn.release()));
+
+    auto lastIndexOf_fn = ObjectFactory::create_native_function("lastIndexOf",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            String converted;
+            const String& str = this_string(ctx, converted);
+            String converted_search;
+            const String& search = string_argument(args.empty() ? Value() : args[0], converted_search);
+            double number = args.size() > 1 ? args[1].to_number() : std::numeric_limits<double>::quiet_NaN();
+            size_t start = std::isnan(number) ? str.length() : clamp_string_position(std::trunc(number), str.length());
+            size_t position = str.last_index_of(search, start);
+            return Value(position == String::npos ? -1.0 : static_cast<double>(position));
+        });
+    string_prototype->set_property("lastIndexOf", Value(lastIndexOf_fn.release()));
+
+    auto string_includes_fn = ObjectFactory::create_native_function("includes",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            String converted;
+            const String& str = this_string(ctx, converted);
+            String converted_search;
+            const String& search = string_argument(args.empty() ? Value() : args[0], converted_search);
+            size_t start = args.size() > 1 ? clamp_string_position(to_integer_or_infinity(args[1]), str.length()) : 0;
+            return Value(str.index_of(search, start) != String::npos);
+        });
+    string_prototype->set_property("includes", Value(string_includes_fn.release()));
+
+    // Add String.prototype.charAt, charCodeAt, slice, substring and substr.
+    // Positions count UTF-16 code units; results of slice and substring share
+    // the receiver's text when they are long (see String::substring)
+    auto charAt_fn = ObjectFactory::create_native_function("charAt",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            String converted;
+            const String& str = this_string(ctx, converted);
+            double position = args.empty() ? 0.0 : to_integer_or_infinity(args[0]);
+            if (position < 0 || position >= static_cast<double>(str.length())) {
+                return Value(std::string());
             }
+            return ValueFactory::string(str.char_at(static_cast<size_t>(position)));
+        });
+    string_prototype->set_property("charAt", Value(charAt_fn.release()));
 
-            return Value(str);
+    auto charCodeAt_fn = ObjectFactory::create_native_function("charCodeAt",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            String converted;
+            const String& str = this_string(ctx, converted);
+            double position = args.empty() ? 0.0 : to_integer_or_infinity(args[0]);
+            if (position < 0 || position >= static_cast<double>(str.length())) {
+                return Value::nan();
+            }
+            return Value(static_cast<double>(str.char_code_at(static_cast<size_t>(position))));
         });
-    string_prototype->set_property("replace", Value(replace_fn.release()));
+    string_prototype->set_property("charCodeAt", Value(charCodeAt_fn.release()));
 
-    // Add String.prototype.replaceAll
-    auto replaceAll_fn = ObjectFactory::create_native_function("replaceAll",
+    auto slice_fn = ObjectFactory::create_native_function("slice",
         [](Context& ctx, const std::vector<Value>& args) -> Value {
-            Value this_value = ctx.get_binding("this");
-            std::string str = this_value.to_string();
-            
-            if (args.size() < 2) return Value(str);
-            
-            std::string search = args[0].to_string();
-            std::string replace = args[1].to_string();
-            
-            if (search.empty()) return Value(str);
-            
-            size_t pos = 0;
-            while ((pos = str.find(search, pos)) != std::string::npos) {
-                str.replace(pos, search.length(), replace);
-                pos += replace.length();
+            String converted;
+            const String& str = this_string(ctx, converted);
+            size_t length = str.length();
+            size_t from = args.empty() ? 0 : relative_string_position(to_integer_or_infinity(args[0]), length);
+            size_t to = args.size() < 2 || args[1].is_undefined()
+                ? length : relative_string_position(to_integer_or_infinity(args[1]), length);
+            if (from >= to) return Value(std::string());
+            return ValueFactory::string(str.substring(from, to));
+        });
+    string_prototype->set_property("slice", Value(slice_fn.release()));
+
+    auto substring_fn = ObjectFactory::create_native_function("substring",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            String converted;
+            const String& str = this_string(ctx, converted);
+            size_t length = str.length();
+            size_t start = args.empty() ? 0 : clamp_string_position(to_integer_or_infinity(args[0]), length);
+            size_t end = args.size() < 2 || args[1].is_undefined()
+                ? length : clamp_string_position(to_integer_or_infinity(args[1]), length);
+            if (start > end) std::swap(start, end);
+            return ValueFactory::string(str.substring(start, end));
+        });
+    string_prototype->set_property("substring", Value(substring_fn.release()));
+
+    auto substr_fn = ObjectFactory::create_native_function("substr",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            String converted;
+            const String& str = this_string(ctx, converted);
+            size_t length = str.length();
+            size_t start = args.empty() ? 0 : relative_string_position(to_integer_or_infinity(args[0]), length);
+            size_t count = length - start;
+            if (args.size() > 1 && !args[1].is_undefined()) {
+                count = clamp_string_position(to_integer_or_infinity(args[1]), count);
             }
-            
-            return Value(str);
+            return ValueFactory::string(str.substring(start, start + count));
         });
-    string_prototype->set_property("replaceAll", Value(replaceAll_fn.release()));
+    string_prototype->set_property("substr", Value(substr_fn.release()));
+
+    // Add String.prototype.startsWith, endsWith, at and concat
+    auto startsWith_fn = ObjectFactory::create_native_function("startsWith",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            String converted;
+            const String& str = this_string(ctx, converted);
+            String converted_search;
+            const String& search = string_argument(args.empty() ? Value() : args[0], converted_search);
+            size_t start = args.size() > 1 ? clamp_string_position(to_integer_or_infinity(args[1]), str.length()) : 0;
+            return Value(str.matches_at(search, start));
+        });
+    string_prototype->set_property("startsWith", Value(startsWith_fn.release()));
+
+    auto endsWith_fn = ObjectFactory::create_native_function("endsWith",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            String converted;
+            const String& str = this_string(ctx, converted);
+            String converted_search;
+            const String& search = string_argument(args.empty() ? Value() : args[0], converted_search);
+            size_t end = args.size() < 2 || args[1].is_undefined()
+                ? str.length() : clamp_string_position(to_integer_or_infinity(args[1]), str.length());
+            return Value(search.length() <= end && str.matches_at(search, end - search.length()));
+        });
+    string_prototype->set_property("endsWith", Value(endsWith_fn.release()));
+
+    auto at_fn = ObjectFactory::create_native_function("at",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            String converted;
+            const String& str = this_string(ctx, converted);
+            double position = args.empty() ? 0.0 : to_integer_or_infinity(args[0]);
+            if (position < 0) position += static_cast<double>(str.length());
+            if (position < 0 || position >= static_cast<double>(str.length())) return Value();
+            return ValueFactory::string(str.char_at(static_cast<size_t>(position)));
+        });
+    string_prototype->set_property("at", Value(at_fn.release()));
+
+    auto string_concat_fn = ObjectFactory::create_native_function("concat",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            String converted;
+            StringBuilder builder;
+            builder.append(this_string(ctx, converted));
+            for (const Value& arg : args) {
+                String converted_arg;
+                builder.append(string_argument(arg, converted_arg));
+            }
+            return ValueFactory::string(builder.build());
+        });
+    string_prototype->set_property("concat", Value(string_concat_fn.release()));
+
+    auto repeat_fn = ObjectFactory::create_native_function("repeat",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            String converted;
+            const String& str = this_string(ctx, converted);
+            double count = args.empty() ? 0.0 : to_integer_or_infinity(args[0]);
+            if (count < 0 || std::isinf(count)) {
+                ctx.throw_range_error("Invalid count value");
+                return Value();
+            }
+            StringBuilder builder;
+            builder.reserve(str.length() * static_cast<size_t>(count));
+            for (size_t i = 0; i < static_cast<size_t>(count); ++i) {
+                builder.append(str);
+            }
+            return ValueFactory::string(builder.build());
+        });
+    string_prototype->set_property("repeat", Value(repeat_fn.release()));
+
+    // Add String.prototype.trim, trimStart, trimEnd, toLowerCase and toUpperCase
+    auto trim_fn = ObjectFactory::create_native_function("trim",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            (void)args;
+            return trim_string(ctx, true, true);
+        });
+    string_prototype->set_property("trim", Value(trim_fn.release()));
+
+    auto trimStart_fn = ObjectFactory::create_native_function("trimStart",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            (void)args;
+            return trim_string(ctx, true, false);
+        });
+    string_prototype->set_property("trimStart", Value(trimStart_fn.release()));
+
+    auto trimEnd_fn = ObjectFactory::create_native_function("trimEnd",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            (void)args;
+            return trim_string(ctx, false, true);
+        });
+    string_prototype->set_property("trimEnd", Value(trimEnd_fn.release()));
+
+    auto toLowerCase_fn = ObjectFactory::create_native_function("toLowerCase",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            (void)args;
+            return convert_string_case(ctx, false);
+        });
+    string_prototype->set_property("toLowerCase", Value(toLowerCase_fn.release()));
+
+    auto toUpperCase_fn = ObjectFactory::create_native_function("toUpperCase",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            (void)args;
+            return convert_string_case(ctx, true);
+        });
+    string_prototype->set_property("toUpperCase", Value(toUpperCase_fn.release()));
+
+    // String.prototype.toString and valueOf both return the string itself
+    auto string_value_fn = [](Context& ctx, const std::vector<Value>& args) -> Value {
+        (void)args;
+        String converted;
+        return ValueFactory::string(this_string(ctx, converted));
+    };
+    string_prototype->set_property("toString",
+        Value(ObjectFactory::create_native_function("toString", string_value_fn).release()));
+    string_prototype->set_property("valueOf",
+        Value(ObjectFactory::create_native_function("valueOf", string_value_fn).release()));
 
     // Add String.concat static method
     auto string_concat_static = ObjectFactory::create_native_function("concat",
@@ -1179,9 +1818,12 @@ void Context::initialize_built_ins() {
     string_constructor->set_property("concat", Value(string_concat_static.release()));
 
     // Set up bidirectional constructor/prototype relationship
+    // (a Function reads "prototype" from its own slot, not its properties)
     Object* proto_ptr = string_prototype.get();
+    string_constructor->set_prototype(proto_ptr);
     string_constructor->set_property("prototype", Value(string_prototype.release()));
     proto_ptr->set_property("constructor", Value(string_constructor.get()));
+    Isolate::current().prototypes().string = proto_ptr;
 
     register_built_in_object("String", string_constructor.release());
     
@@ -1243,68 +1885,10 @@ void Context::initialize_built_ins() {
         });
     symbol_constructor->set_property("keyFor", Value(symbol_key_for_fn.release()));
     
-    // Initialize well-known symbols and add them as static properties
-    Symbol::initialize_well_known_symbols();
-    
-    // Add well-known symbols with null checks
-    Symbol* iterator_sym = Symbol::get_well_known(Symbol::ITERATOR);
-    if (iterator_sym) {
-        symbol_constructor->set_property("iterator", Value(iterator_sym));
-    }
-    
-    Symbol* async_iterator_sym = Symbol::get_well_known(Symbol::ASYNC_ITERATOR);
-    if (async_iterator_sym) {
-        symbol_constructor->set_property("asyncIterator", Value(async_iterator_sym));
-    }
-    
-    Symbol* match_sym = Symbol::get_well_known(Symbol::MATCH);
-    if (match_sym) {
-        symbol_constructor->set_property("match", Value(match_sym));
-    }
-    
-    Symbol* replace_sym = Symbol::get_well_known(Symbol::REPLACE);
-    if (replace_sym) {
-        symbol_constructor->set_property("replace", Value(replace_sym));
-    }
-    
-    Symbol* search_sym = Symbol::get_well_known(Symbol::SEARCH);
-    if (search_sym) {
-        symbol_constructor->set_property("search", Value(search_sym));
-    }
-    
-    Symbol* split_sym = Symbol::get_well_known(Symbol::SPLIT);
-    if (split_sym) {
-        symbol_constructor->set_property("split", Value(split_sym));
-    }
-    
-    Symbol* has_instance_sym = Symbol::get_well_known(Symbol::HAS_INSTANCE);
-    if (has_instance_sym) {
-        symbol_constructor->set_property("hasInstance", Value(has_instance_sym));
-    }
-    
-    Symbol* is_concat_spreadable_sym = Symbol::get_well_known(Symbol::IS_CONCAT_SPREADABLE);
-    if (is_concat_spreadable_sym) {
-        symbol_constructor->set_property("isConcatSpreadable", Value(is_concat_spreadable_sym));
-    }
-    
-    Symbol* species_sym = Symbol::get_well_known(Symbol::SPECIES);
-    if (species_sym) {
-        symbol_constructor->set_property("species", Value(species_sym));
-    }
-    
-    Symbol* to_primitive_sym = Symbol::get_well_known(Symbol::TO_PRIMITIVE);
-    if (to_primitive_sym) {
-        symbol_constructor->set_property("toPrimitive", Value(to_primitive_sym));
-    }
-    
-    Symbol* to_string_tag_sym = Symbol::get_well_known(Symbol::TO_STRING_TAG);
-    if (to_string_tag_sym) {
-        symbol_constructor->set_property("toStringTag", Value(to_string_tag_sym));
-    }
-    
-    Symbol* unscopables_sym = Symbol::get_well_known(Symbol::UNSCOPABLES);
-    if (unscopables_sym) {
-        symbol_constructor->set_property("unscopables", Value(unscopables_sym));
+    // Add well-known symbols as static properties (Symbol.iterator, ...)
+    for (size_t i = 0; i < static_cast<size_t>(WellKnownSymbol::Count); i++) {
+        WellKnownSymbol which = static_cast<WellKnownSymbol>(i);
+        symbol_constructor->set_property(Symbol::well_known_name(which), Value(Symbol::get_well_known(which)));
     }
     
     register_built_in_object("Symbol", symbol_constructor.release());
@@ -1321,6 +1905,10 @@ void Context::initialize_built_ins() {
     WeakMap::setup_weakmap_prototype(*this);
     WeakSet::setup_weakset_prototype(*this);
     
+    //  WEAKREF AND FINALIZATIONREGISTRY - ES2021 WEAK REFERENCES 
+    WeakRef::setup_weakref_prototype(*this);
+    FinalizationRegistry::setup_finalization_registry_prototype(*this);
+    
     //  ASYNC/AWAIT - ES2017+ ASYNC FUNCTIONS 
     AsyncUtils::setup_async_functions(*this);
     AsyncGenerator::setup_async_generator_prototype(*this);
@@ -1421,6 +2009,96 @@ void Context::initialize_built_ins() {
         });
     number_constructor->set_property("parseFloat", Value(numberParseFloat_fn.release()));
     
+    // Number.prototype, looked up for number primitives
+    auto number_prototype = ObjectFactory::create_object();
+    number_prototype->set_prototype(object_proto_ptr);
+
+    auto number_toString_fn = ObjectFactory::create_native_function("toString",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            double number = this_number(ctx);
+            int radix = args.empty() || args[0].is_undefined() ? 10 : static_cast<int>(to_integer_or_infinity(args[0]));
+            if (radix < 2 || radix > 36) {
+                ctx.throw_range_error("toString() radix must be between 2 and 36");
+                return Value();
+            }
+            if (radix == 10) return Value(Value(number).to_string());
+            return Value(number_to_radix_string(number, radix));
+        });
+    number_prototype->set_property("toString", Value(number_toString_fn.release()));
+
+    auto number_valueOf_fn = ObjectFactory::create_native_function("valueOf",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            (void)args;
+            return Value(this_number(ctx));
+        });
+    number_prototype->set_property("valueOf", Value(number_valueOf_fn.release()));
+
+    auto toFixed_fn = ObjectFactory::create_native_function("toFixed",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            double number = this_number(ctx);
+            double digits = args.empty() ? 0.0 : to_integer_or_infinity(args[0]);
+            if (digits < 0 || digits > 100) {
+                ctx.throw_range_error("toFixed() digits argument must be between 0 and 100");
+                return Value();
+            }
+            if (!std::isfinite(number) || std::fabs(number) >= 1e21) return Value(Value(number).to_string());
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(static_cast<int>(digits)) << number;
+            return Value(oss.str());
+        });
+    number_prototype->set_property("toFixed", Value(toFixed_fn.release()));
+
+    auto toPrecision_fn = ObjectFactory::create_native_function("toPrecision",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            double number = this_number(ctx);
+            if (args.empty() || args[0].is_undefined() || !std::isfinite(number)) {
+                return Value(Value(number).to_string());
+            }
+            double precision = to_integer_or_infinity(args[0]);
+            if (precision < 1 || precision > 100) {
+                ctx.throw_range_error("toPrecision() argument must be between 1 and 100");
+                return Value();
+            }
+            int exponent = number == 0 ? 0 : static_cast<int>(std::floor(std::log10(std::fabs(number))));
+            std::ostringstream oss;
+            if (exponent < -6 || exponent >= precision) {
+                oss << std::scientific << std::setprecision(static_cast<int>(precision) - 1) << number;
+                // iostreams pad the exponent to two digits; JS writes "1.2e+3"
+                std::string result = oss.str();
+                size_t digits = result.find('e') + 2;
+                size_t end = digits;
+                while (end + 1 < result.size() && result[end] == '0') ++end;
+                result.erase(digits, end - digits);
+                return Value(result);
+            } else {
+                oss << std::fixed << std::setprecision(static_cast<int>(precision) - 1 - exponent) << number;
+            }
+            return Value(oss.str());
+        });
+    number_prototype->set_property("toPrecision", Value(toPrecision_fn.release()));
+
+    // Integral part with comma thousands separators
+    auto toLocaleString_fn = ObjectFactory::create_native_function("toLocaleString",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            (void)args;
+            double number = this_number(ctx);
+            if (!std::isfinite(number)) return Value(Value(number).to_string());
+            std::string digits = std::to_string(static_cast<long long>(std::fabs(number)));
+            std::string result;
+            for (size_t i = 0; i < digits.size(); ++i) {
+                if (i > 0 && (digits.size() - i) % 3 == 0) result += ',';
+                result += digits[i];
+            }
+            return Value(number <= -1 ? "-" + result : result);
+        });
+    number_prototype->set_property("toLocaleString", Value(toLocaleString_fn.release()));
+
+    Object* number_proto_ptr = number_prototype.get();
+    number_constructor->set_prototype(number_proto_ptr);
+    number_constructor->set_property("prototype", Value(number_prototype.release()));
+    number_proto_ptr->set_property("constructor", Value(number_constructor.get()));
+    Isolate::current().prototypes().number = number_proto_ptr;
+
     register_built_in_object("Number", number_constructor.release());
     
     // Boolean constructor - callable as function
@@ -2019,84 +2697,33 @@ void Context::initialize_built_ins() {
         });
     register_built_in_object("RegExp", regexp_constructor.release());
     
-    // Helper function to add Promise methods to any Promise instance
-    std::function<void(Promise*)> add_promise_methods = [&](Promise* promise) {
-        // Add .then method
-        auto then_method = ObjectFactory::create_native_function("then",
-            [promise, &add_promise_methods](Context& ctx, const std::vector<Value>& args) -> Value {
-                Function* on_fulfilled = nullptr;
-                Function* on_rejected = nullptr;
-                
-                if (args.size() > 0 && args[0].is_function()) {
-                    on_fulfilled = args[0].as_function();
-                }
-                if (args.size() > 1 && args[1].is_function()) {
-                    on_rejected = args[1].as_function();
-                }
-                
-                Promise* new_promise = promise->then(on_fulfilled, on_rejected);
-                add_promise_methods(new_promise);
-                return Value(new_promise);
-            });
-        promise->set_property("then", Value(then_method.release()));
-        
-        // Add .catch method
-        auto catch_method = ObjectFactory::create_native_function("catch",
-            [promise, &add_promise_methods](Context& ctx, const std::vector<Value>& args) -> Value {
-                Function* on_rejected = nullptr;
-                if (args.size() > 0 && args[0].is_function()) {
-                    on_rejected = args[0].as_function();
-                }
-                
-                Promise* new_promise = promise->catch_method(on_rejected);
-                add_promise_methods(new_promise);
-                return Value(new_promise);
-            });
-        promise->set_property("catch", Value(catch_method.release()));
-        
-        // Add .finally method
-        auto finally_method = ObjectFactory::create_native_function("finally",
-            [promise, &add_promise_methods](Context& ctx, const std::vector<Value>& args) -> Value {
-                Function* on_finally = nullptr;
-                if (args.size() > 0 && args[0].is_function()) {
-                    on_finally = args[0].as_function();
-                }
-                
-                Promise* new_promise = promise->finally_method(on_finally);
-                add_promise_methods(new_promise);
-                return Value(new_promise);
-            });
-        promise->set_property("finally", Value(finally_method.release()));
-    };
-    
     // Promise constructor
     auto promise_constructor = ObjectFactory::create_native_function("Promise",
-        [add_promise_methods](Context& ctx, const std::vector<Value>& args) -> Value {
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
             if (args.empty() || !args[0].is_function()) {
                 ctx.throw_exception(Value("Promise executor must be a function"));
                 return Value();
             }
             
-            auto promise = std::make_unique<Promise>(&ctx);
+            auto promise_obj = ObjectFactory::create_promise(&ctx);
+            Promise* promise = static_cast<Promise*>(promise_obj.get());
             
             // Execute the executor function with resolve and reject
             Function* executor = args[0].as_function();
             
             // Create resolve function
             auto resolve_fn = ObjectFactory::create_native_function("resolve",
-                [promise_ptr = promise.get()](Context& ctx, const std::vector<Value>& args) -> Value {
+                [promise](Context& ctx, const std::vector<Value>& args) -> Value {
                     (void)ctx;
-                    Value value = args.empty() ? Value() : args[0];
-                    promise_ptr->fulfill(value);
+                    promise->resolve(args.empty() ? Value() : args[0]);
                     return Value();
                 });
             
             // Create reject function
             auto reject_fn = ObjectFactory::create_native_function("reject",
-                [promise_ptr = promise.get()](Context& ctx, const std::vector<Value>& args) -> Value {
+                [promise](Context& ctx, const std::vector<Value>& args) -> Value {
                     (void)ctx;
-                    Value reason = args.empty() ? Value() : args[0];
-                    promise_ptr->reject(reason);
+                    promise->reject(args.empty() ? Value() : args[0]);
                     return Value();
                 });
             
@@ -2111,90 +2738,36 @@ void Context::initialize_built_ins() {
             } catch (...) {
                 promise->reject(Value("Promise executor threw"));
             }
-            
-            // Add Promise methods to this instance
-            add_promise_methods(promise.get());
-            
-            // Mark as Promise for instanceof
-            promise->set_property("_isPromise", Value(true));
-            
-            return Value(promise.release());
-        });
-    
-    // Promise.try - ES2025 static method
-    auto promise_try = ObjectFactory::create_native_function("try",
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-            if (args.empty() || !args[0].is_function()) {
-                ctx.throw_exception(Value("Promise.try requires a function"));
-                return Value();
-            }
-            
-            Function* fn = args[0].as_function();
-            auto promise = std::make_unique<Promise>(&ctx);
-            
-            try {
-                Value result = fn->call(ctx, {});
-                promise->fulfill(result);
-            } catch (...) {
-                promise->reject(Value("Function threw in Promise.try"));
+            // A throw from the executor rejects the promise instead of propagating
+            if (ctx.has_exception()) {
+                Value error = ctx.get_exception();
+                ctx.clear_exception();
+                promise->reject(error);
             }
             
-            return Value(promise.release());
+            return Value(promise_obj.release());
         });
+    
+    // Promise.try and Promise.withResolvers - ES2025 static methods
+    auto promise_try = ObjectFactory::create_native_function("try", Promise::try_method);
     promise_constructor->set_property("try", Value(promise_try.release()));
     
-    // Promise.withResolvers - ES2025 static method
-    auto promise_withResolvers = ObjectFactory::create_native_function("withResolvers",
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-            (void)args; // Suppress unused parameter warning
-            auto promise = std::make_unique<Promise>(&ctx);
-            
-            // Create resolve function
-            auto resolve_fn = ObjectFactory::create_native_function("resolve",
-                [promise_ptr = promise.get()](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx;
-                    Value value = args.empty() ? Value() : args[0];
-                    promise_ptr->fulfill(value);
-                    return Value();
-                });
-            
-            // Create reject function
-            auto reject_fn = ObjectFactory::create_native_function("reject",
-                [promise_ptr = promise.get()](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx;
-                    Value reason = args.empty() ? Value() : args[0];
-                    promise_ptr->reject(reason);
-                    return Value();
-                });
-            
-            // Create result object
-            auto result_obj = ObjectFactory::create_object();
-            result_obj->set_property("promise", Value(promise.release()));
-            result_obj->set_property("resolve", Value(resolve_fn.release()));
-            result_obj->set_property("reject", Value(reject_fn.release()));
-            
-            return Value(result_obj.release());
-        });
+    auto promise_withResolvers = ObjectFactory::create_native_function("withResolvers", Promise::withResolvers);
     promise_constructor->set_property("withResolvers", Value(promise_withResolvers.release()));
     
-    // Create Promise.prototype object
+    // Create Promise.prototype object; every promise inherits then/catch/finally
+    // from it rather than carrying its own copies
     auto promise_prototype = ObjectFactory::create_object();
     
     // Promise.prototype.then
     auto promise_then = ObjectFactory::create_native_function("then",
         [](Context& ctx, const std::vector<Value>& args) -> Value {
             Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("Promise.prototype.then called on non-object"));
-                return Value();
-            }
-            
-            // Cast to Promise - need to verify this is actually a Promise
-            Promise* promise = dynamic_cast<Promise*>(this_obj);
-            if (!promise) {
-                ctx.throw_exception(Value("Promise.prototype.then called on non-Promise"));
+            if (!this_obj || this_obj->get_type() != Object::ObjectType::Promise) {
+                ctx.throw_type_error("Promise.prototype.then called on non-Promise");
                 return Value();
             }
+            Promise* promise = static_cast<Promise*>(this_obj);
             
             Function* on_fulfilled = nullptr;
             Function* on_rejected = nullptr;
@@ -2206,8 +2779,7 @@ void Context::initialize_built_ins() {
                 on_rejected = args[1].as_function();
             }
             
-            Promise* new_promise = promise->then(on_fulfilled, on_rejected);
-            return Value(new_promise);
+            return Value(promise->then(on_fulfilled, on_rejected, &ctx));
         });
     promise_prototype->set_property("then", Value(promise_then.release()));
     
@@ -2215,24 +2787,18 @@ void Context::initialize_built_ins() {
     auto promise_catch = ObjectFactory::create_native_function("catch",
         [](Context& ctx, const std::vector<Value>& args) -> Value {
             Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("Promise.prototype.catch called on non-object"));
-                return Value();
-            }
-            
-            Promise* promise = dynamic_cast<Promise*>(this_obj);
-            if (!promise) {
-                ctx.throw_exception(Value("Promise.prototype.catch called on non-Promise"));
+            if (!this_obj || this_obj->get_type() != Object::ObjectType::Promise) {
+                ctx.throw_type_error("Promise.prototype.catch called on non-Promise");
                 return Value();
             }
+            Promise* promise = static_cast<Promise*>(this_obj);
             
             Function* on_rejected = nullptr;
             if (args.size() > 0 && args[0].is_function()) {
                 on_rejected = args[0].as_function();
             }
             
-            Promise* new_promise = promise->catch_method(on_rejected);
-            return Value(new_promise);
+            return Value(promise->catch_method(on_rejected, &ctx));
         });
     promise_prototype->set_property("catch", Value(promise_catch.release()));
     
@@ -2240,163 +2806,75 @@ void Context::initialize_built_ins() {
     auto promise_finally = ObjectFactory::create_native_function("finally",
         [](Context& ctx, const std::vector<Value>& args) -> Value {
             Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("Promise.prototype.finally called on non-object"));
-                return Value();
-            }
-            
-            Promise* promise = dynamic_cast<Promise*>(this_obj);
-            if (!promise) {
-                ctx.throw_exception(Value("Promise.prototype.finally called on non-Promise"));
+            if (!this_obj || this_obj->get_type() != Object::ObjectType::Promise) {
+                ctx.throw_type_error("Promise.prototype.finally called on non-Promise");
                 return Value();
             }
+            Promise* promise = static_cast<Promise*>(this_obj);
             
             Function* on_finally = nullptr;
             if (args.size() > 0 && args[0].is_function()) {
                 on_finally = args[0].as_function();
             }
             
-            Promise* new_promise = promise->finally_method(on_finally);
-            return Value(new_promise);
+            return Value(promise->finally_method(on_finally, &ctx));
         });
     promise_prototype->set_property("finally", Value(promise_finally.release()));
     
     // Set Promise.prototype on the constructor
+    // (a Function reads "prototype" from its own slot, not its properties)
+    Isolate::current().prototypes().promise = promise_prototype.get();
+    promise_constructor->set_prototype(promise_prototype.get());
     promise_constructor->set_property("prototype", Value(promise_prototype.release()));
     
     // Add Promise.resolve static method
     auto promise_resolve_static = ObjectFactory::create_native_function("resolve",
-        [add_promise_methods](Context& ctx, const std::vector<Value>& args) -> Value {
-            Value value = args.empty() ? Value() : args[0];
-            auto promise = std::make_unique<Promise>(&ctx);
-            promise->fulfill(value);
-
-            // Add instance methods to this promise
-            add_promise_methods(promise.get());
-
-            // Mark as Promise for instanceof and store resolved value
-            promise->set_property("_isPromise", Value(true));
-            promise->set_property("_promiseValue", value);
-
-            return Value(promise.release());
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            return Value(Promise::resolve_static(args.empty() ? Value() : args[0], &ctx));
         });
     promise_constructor->set_property("resolve", Value(promise_resolve_static.release()));
     
     // Add Promise.reject static method
     auto promise_reject_static = ObjectFactory::create_native_function("reject",
-        [add_promise_methods](Context& ctx, const std::vector<Value>& args) -> Value {
-            Value reason = args.empty() ? Value() : args[0];
-            auto promise = std::make_unique<Promise>(&ctx);
-            promise->reject(reason);
-            
-            // Add instance methods to this promise
-            add_promise_methods(promise.get());
-            
-            // Mark as Promise for instanceof
-            promise->set_property("_isPromise", Value(true));
-            
-            return Value(promise.release());
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            return Value(Promise::reject_static(args.empty() ? Value() : args[0], &ctx));
         });
     promise_constructor->set_property("reject", Value(promise_reject_static.release()));
 
-    // Add Promise.all static method
+    // Promise.all and Promise.race take the elements of an array
     auto promise_all_static = ObjectFactory::create_native_function("all",
-        [add_promise_methods](Context& ctx, const std::vector<Value>& args) -> Value {
-            if (args.empty() || !args[0].is_object()) {
-                ctx.throw_exception(Value("Promise.all expects an iterable"));
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            if (args.empty() || !args[0].is_object() || !args[0].as_object()->is_array()) {
+                ctx.throw_type_error("Promise.all expects an array");
                 return Value();
             }
 
             Object* iterable = args[0].as_object();
-            if (!iterable->is_array()) {
-                ctx.throw_exception(Value("Promise.all expects an array"));
-                return Value();
-            }
-
             uint32_t length = iterable->get_length();
-            std::vector<Value> results(length);
-            uint32_t resolved_count = 0;
-
-            auto result_promise = std::make_unique<Promise>(&ctx);
-            add_promise_methods(result_promise.get());
-            result_promise->set_property("_isPromise", Value(true));
-
-            if (length == 0) {
-                // Empty array resolves immediately with empty array
-                auto empty_array = ObjectFactory::create_array(0);
-                result_promise->fulfill(Value(empty_array.release()));
-                return Value(result_promise.release());
-            }
-
-            // For now, simplified: just return array of resolved values
+            std::vector<Value> values;
+            values.reserve(length);
             for (uint32_t i = 0; i < length; i++) {
-                Value element = iterable->get_element(i);
-                if (element.is_object()) {
-                    Object* obj = element.as_object();
-                    if (obj && obj->has_property("_isPromise")) {
-                        // This is a promise - get its value if fulfilled
-                        if (obj->has_property("_promiseValue")) {
-                            results[i] = obj->get_property("_promiseValue");
-                        } else {
-                            results[i] = element; // Use the promise object itself
-                        }
-                    } else {
-                        results[i] = element;
-                    }
-                } else {
-                    results[i] = element;
-                }
+                values.push_back(iterable->get_element(i));
             }
-
-            // Create result array
-            auto result_array = ObjectFactory::create_array(length);
-            for (uint32_t i = 0; i < length; i++) {
-                result_array->set_element(i, results[i]);
-            }
-
-            result_promise->fulfill(Value(result_array.release()));
-            return Value(result_promise.release());
+            return Value(Promise::all(ctx, values));
         });
     promise_constructor->set_property("all", Value(promise_all_static.release()));
 
-    // Add Promise.race static method
     auto promise_race_static = ObjectFactory::create_native_function("race",
-        [add_promise_methods](Context& ctx, const std::vector<Value>& args) -> Value {
-            if (args.empty() || !args[0].is_object()) {
-                ctx.throw_exception(Value("Promise.race expects an iterable"));
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            if (args.empty() || !args[0].is_object() || !args[0].as_object()->is_array()) {
+                ctx.throw_type_error("Promise.race expects an array");
                 return Value();
             }
 
             Object* iterable = args[0].as_object();
-            if (!iterable->is_array()) {
-                ctx.throw_exception(Value("Promise.race expects an array"));
-                return Value();
-            }
-
             uint32_t length = iterable->get_length();
-            auto result_promise = std::make_unique<Promise>(&ctx);
-            add_promise_methods(result_promise.get());
-            result_promise->set_property("_isPromise", Value(true));
-
-            if (length == 0) {
-                // Empty array never resolves
-                return Value(result_promise.release());
-            }
-
-            // For simplified implementation, return first element
-            Value first_element = iterable->get_element(0);
-            if (first_element.is_object()) {
-                Object* obj = first_element.as_object();
-                if (obj && obj->has_property("_isPromise") && obj->has_property("_promiseValue")) {
-                    result_promise->fulfill(obj->get_property("_promiseValue"));
-                } else {
-                    result_promise->fulfill(first_element);
-                }
-            } else {
-                result_promise->fulfill(first_element);
+            std::vector<Value> values;
+            values.reserve(length);
+            for (uint32_t i = 0; i < length; i++) {
+                values.push_back(iterable->get_element(i));
             }
-
-            return Value(result_promise.release());
+            return Value(Promise::race(ctx, values));
         });
     promise_constructor->set_property("race", Value(promise_race_static.release()));
 
@@ -2459,6 +2937,12 @@ void Context::initialize_built_ins() {
     // Setup WebAssembly support
     WebAssemblyAPI::setup_webassembly(*this);
     
+    // Native library calls through generated per-signature stubs. Off unless
+    // the embedder opts in: FFI.open can load and call any native code
+    if (engine_ && engine_->get_config().enable_ffi) {
+        FFIIntegration::register_ffi_globals(this);
+    }
+    
     // Setup Proxy and Reflect using the proper implementation
     Proxy::setup_proxy(*this);
     Reflect::setup_reflect(*this);
@@ -2756,6 +3240,17 @@ void Context::setup_global_bindings() {
         });
     lexical_environment_->create_binding("jitStats", Value(jit_stats_fn.release()), false);
     
+    auto rewrite_stats_fn = ObjectFactory::create_native_function("rewriteStats",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            if (ctx.get_engine()) {
+                std::cout << ctx.get_engine()->get_node_rewrite_stats() << std::endl;
+            } else {
+                std::cout << "Engine not available" << std::endl;
+            }
+            return Value();
+        });
+    lexical_environment_->create_binding("rewriteStats", Value(rewrite_stats_fn.release()), false);
+    
     auto force_gc_fn = ObjectFactory::create_native_function("forceGC",
         [](Context& ctx, const std::vector<Value>& args) -> Value {
             if (ctx.get_engine()) {
@@ -2970,12 +3465,43 @@ std::string StackFrame::to_string() const {
 // Environment Implementation
 //=============================================================================
 
+std::atomic<uint64_t> Environment::next_id_{1};
+
 Environment::Environment(Type type, Environment* outer)
-    : type_(type), outer_environment_(outer), binding_object_(nullptr) {
+    : type_(type), outer_environment_(outer), binding_count_(0), binding_object_(nullptr),
+      id_(next_id_.fetch_add(1, std::memory_order_relaxed)), ref_count_(1),
+      gc_epoch_(GarbageCollector::environment_epoch()) {
+    if (outer_environment_) outer_environment_->retain();
+    GarbageCollector::write_barrier(outer_environment_);
 }
 
 Environment::Environment(Object* binding_object, Environment* outer)
-    : type_(Type::Object), outer_environment_(outer), binding_object_(binding_object) {
+    : type_(Type::Object), outer_environment_(outer), binding_count_(0), binding_object_(binding_object),
+      id_(next_id_.fetch_add(1, std::memory_order_relaxed)), ref_count_(1),
+      gc_epoch_(GarbageCollector::environment_epoch()) {
+    if (outer_environment_) outer_environment_->retain();
+    GarbageCollector::write_barrier(outer_environment_);
+    GarbageCollector::write_barrier(binding_object_);
+}
+
+Environment::~Environment() {
+    if (outer_environment_) outer_environment_->release();
+}
+
+void Environment::reset(Environment* outer) {
+    if (outer) outer->retain();
+    if (outer_environment_) outer_environment_->release();
+    outer_environment_ = outer;
+    GarbageCollector::write_barrier(outer_environment_);
+    
+    if (binding_count_ != 0) {
+        for (auto& pair : bindings_) {
+            pair.second.value = Value();
+            pair.second.present = false;
+        }
+        binding_count_ = 0;
+    }
+    id_ = next_id_.fetch_add(1, std::memory_order_relaxed);
 }
 
 bool Environment::has_binding(const std::string& name) const {
@@ -3000,14 +3526,14 @@ Value Environment::get_binding_with_depth(const std::string& name, int depth) co
         return Value(); // undefined
     }
     
-    if (has_own_binding(name)) {
-        if (type_ == Type::Object && binding_object_) {
+    if (type_ == Type::Object && binding_object_) {
+        if (binding_object_->has_own_property(name)) {
             return binding_object_->get_property(name);
-        } else {
-            auto it = bindings_.find(name);
-            if (it != bindings_.end()) {
-                return it->second;
-            }
+        }
+    } else if (binding_count_ != 0) {
+        auto it = bindings_.find(name);
+        if (it != bindings_.end() && it->second.present) {
+            return it->second.value;
         }
     }
     
@@ -3019,16 +3545,17 @@ Value Environment::get_binding_with_depth(const std::string& name, int depth) co
 }
 
 bool Environment::set_binding(const std::string& name, const Value& value) {
-    if (has_own_binding(name)) {
-        if (type_ == Type::Object && binding_object_) {
+    if (type_ == Type::Object && binding_object_) {
+        if (binding_object_->has_own_property(name)) {
             return binding_object_->set_property(name, value);
-        } else {
-            // Check if mutable
-            if (is_mutable_binding(name)) {
-                bindings_[name] = value;
-                return true;
-            }
-            return false; // Immutable binding
+        }
+    } else if (binding_count_ != 0) {
+        auto it = bindings_.find(name);
+        if (it != bindings_.end() && it->second.present) {
+            if (!it->second.is_mutable) return false; // Immutable binding
+            GarbageCollector::write_barrier(value);
+            it->second.value = value;
+            return true;
         }
     }
     
@@ -3040,18 +3567,24 @@ bool Environment::set_binding(const std::string& name, const Value& value) {
 }
 
 bool Environment::create_binding(const std::string& name, const Value& value, bool mutable_binding) {
-    if (has_own_binding(name)) {
-        return false; // Binding already exists
-    }
-    
     if (type_ == Type::Object && binding_object_) {
+        if (binding_object_->has_own_property(name)) {
+            return false; // Binding already exists
+        }
         return binding_object_->set_property(name, value);
-    } else {
-        bindings_[name] = value;
-        mutable_flags_[name] = mutable_binding;
-        initialized_flags_[name] = true;
-        return true;
     }
+    
+    Binding& binding = bindings_[name];
+    if (binding.present) {
+        return false; // Binding already exists
+    }
+    GarbageCollector::write_barrier(value);
+    binding.value = value;
+    binding.is_mutable = mutable_binding;
+    binding.initialized = true;
+    binding.present = true;
+    ++binding_count_;
+    return true;
 }
 
 bool Environment::delete_binding(const std::string& name) {
@@ -3060,8 +3593,8 @@ bool Environment::delete_binding(const std::string& name) {
             return binding_object_->delete_property(name);
         } else {
             bindings_.erase(name);
-            mutable_flags_.erase(name);
-            initialized_flags_.erase(name);
+            --binding_count_;
+            id_ = next_id_.fetch_add(1, std::memory_order_relaxed);
             return true;
         }
     }
@@ -3070,18 +3603,25 @@ bool Environment::delete_binding(const std::string& name) {
 }
 
 bool Environment::is_mutable_binding(const std::string& name) const {
-    auto it = mutable_flags_.find(name);
-    return (it != mutable_flags_.end()) ? it->second : true; // Default to mutable
+    auto it = bindings_.find(name);
+    return (it != bindings_.end() && it->second.present) ? it->second.is_mutable : true; // Default to mutable
 }
 
 bool Environment::is_initialized_binding(const std::string& name) const {
-    auto it = initialized_flags_.find(name);
-    return (it != initialized_flags_.end()) ? it->second : false;
+    auto it = bindings_.find(name);
+    return (it != bindings_.end() && it->second.present) ? it->second.initialized : false;
 }
 
 void Environment::initialize_binding(const std::string& name, const Value& value) {
-    bindings_[name] = value;
-    initialized_flags_[name] = true;
+    GarbageCollector::write_barrier(value);
+    Binding& binding = bindings_[name];
+    if (!binding.present) {
+        binding.is_mutable = true;
+        binding.present = true;
+        ++binding_count_;
+    }
+    binding.value = value;
+    binding.initialized = true;
 }
 
 std::vector<std::string> Environment::get_binding_names() const {
@@ -3092,17 +3632,28 @@ std::vector<std::string> Environment::get_binding_names() const {
         names.insert(names.end(), keys.begin(), keys.end());
     } else {
         for (const auto& pair : bindings_) {
-            names.push_back(pair.first);
+            if (pair.second.present) names.push_back(pair.first);
         }
     }
     
     return names;
 }
 
+Environment::Snapshot Environment::take_snapshot() const {
+    return Snapshot{bindings_, binding_count_};
+}
+
+void Environment::restore_snapshot(const Snapshot& snapshot) {
+    // Values come back from the snapshot, which the owner keeps traced
+    bindings_ = snapshot.bindings;
+    binding_count_ = snapshot.binding_count;
+    id_ = next_id_.fetch_add(1, std::memory_order_relaxed);
+}
+
 std::string Environment::debug_string() const {
     std::ostringstream oss;
     oss << "Environment(type=" << static_cast<int>(type_)
-        << ", bindings=" << bindings_.size() << ")";
+        << ", bindings=" << binding_count_ << ")";
     return oss.str();
 }
 
@@ -3110,10 +3661,27 @@ bool Environment::has_own_binding(const std::string& name) const {
     if (type_ == Type::Object && binding_object_) {
         return binding_object_->has_own_property(name);
     } else {
-        return bindings_.find(name) != bindings_.end();
+        if (binding_count_ == 0) return false;
+        auto it = bindings_.find(name);
+        return it != bindings_.end() && it->second.present;
     }
 }
 
+const Value* Environment::find_own_binding_slot(const std::string& name) const {
+    if (type_ == Type::Object && binding_object_) return nullptr;
+    if (binding_count_ == 0) return nullptr;
+    auto it = bindings_.find(name);
+    return it != bindings_.end() && it->second.present ? &it->second.value : nullptr;
+}
+
+void Environment::visit_references(GCVisitor& visitor) const {
+    for (const auto& pair : bindings_) {
+        if (pair.second.present) visitor.visit(pair.second.value);
+    }
+    visitor.visit(binding_object_);
+    visitor.visit(outer_environment_);
+}
+
 //=============================================================================
 // Web API Interface Implementation
 //=============================================================================
@@ -3143,8 +3711,11 @@ std::unique_ptr<Context> create_global_context(Engine* engine) {
 std::unique_ptr<Context> create_function_context(Engine* engine, Context* parent, Function* function) {
     auto context = std::make_unique<Context>(engine, parent, Context::Type::Function);
     
-    // Create function environment
-    auto func_env = std::make_unique<Environment>(Environment::Type::Function, parent->get_lexical_environment());
+    // Create function environment; a closure's free names resolve through
+    // the scope it was created in, not the caller's
+    Environment* outer = function && function->get_closure_environment() ? function->get_closure_environment()
+                                                                         : parent->get_lexical_environment();
+    auto func_env = std::make_unique<Environment>(Environment::Type::Function, outer);
     context->set_lexical_environment(func_env.release());
     context->set_variable_environment(context->get_lexical_environment());
     
@@ -3188,7 +3759,7 @@ void Context::pop_block_scope() {
     if (lexical_environment_ && lexical_environment_->get_outer()) {
         Environment* old_env = lexical_environment_;
         lexical_environment_ = lexical_environment_->get_outer();
-        delete old_env;
+        old_env->release();
     }
 }
 
@@ -3376,50 +3947,7 @@ void Context::register_typed_array_constructors() {
         });
     register_built_in_object("Float64Array", float64array_constructor.release());
 
-    // DataView constructor (re-enabled for testing)
-    auto dataview_constructor = ObjectFactory::create_native_function("DataView", 
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-            Value result = DataView::constructor(ctx, args);
-            
-            // Add methods directly to the instance
-            if (result.is_object()) {
-                Object* dataview_obj = result.as_object();
-                
-                auto get_uint8_method = ObjectFactory::create_native_function("getUint8", DataView::js_get_uint8);
-                dataview_obj->set_property("getUint8", Value(get_uint8_method.release()));
-                
-                auto set_uint8_method = ObjectFactory::create_native_function("setUint8", DataView::js_set_uint8);
-                dataview_obj->set_property("setUint8", Value(set_uint8_method.release()));
-                
-                auto get_int16_method = ObjectFactory::create_native_function("getInt16", DataView::js_get_int16);
-                dataview_obj->set_property("getInt16", Value(get_int16_method.release()));
-                
-                auto set_int16_method = ObjectFactory::create_native_function("setInt16", DataView::js_set_int16);
-                dataview_obj->set_property("setInt16", Value(set_int16_method.release()));
-                
-                auto get_uint32_method = ObjectFactory::create_native_function("getUint32", DataView::js_get_uint32);
-                dataview_obj->set_property("getUint32", Value(get_uint32_method.release()));
-                
-                auto set_uint32_method = ObjectFactory::create_native_function("setUint32", DataView::js_set_uint32);
-                dataview_obj->set_property("setUint32", Value(set_uint32_method.release()));
-                
-                auto get_float32_method = ObjectFactory::create_native_function("getFloat32", DataView::js_get_float32);
-                dataview_obj->set_property("getFloat32", Value(get_float32_method.release()));
-                
-                auto set_float32_method = ObjectFactory::create_native_function("setFloat32", DataView::js_set_float32);
-                dataview_obj->set_property("setFloat32", Value(set_float32_method.release()));
-                
-                auto get_float64_method = ObjectFactory::create_native_function("getFloat64", DataView::js_get_float64);
-                dataview_obj->set_property("getFloat64", Value(get_float64_method.release()));
-                
-                auto set_float64_method = ObjectFactory::create_native_function("setFloat64", DataView::js_set_float64);
-                dataview_obj->set_property("setFloat64", Value(set_float64_method.release()));
-            }
-            
-            return result;
-        });
-    
-    register_built_in_object("DataView", dataview_constructor.release());
+    DataView::setup_data_view_prototype(*this);
 }
 
 } // namespace Quanta
\ No newline at end of file
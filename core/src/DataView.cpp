@@ -8,19 +8,11 @@
 #include "ArrayBuffer.h"
 #include "Context.h"
 #include "Error.h"
+#include "Isolate.h"
 #include <algorithm>
 #include <sstream>
 #include <cmath>
 
-// Custom memory functions to avoid cstring linkage issues on Windows
-static void quanta_memcpy(void* dest, const void* src, size_t count) {
-    const char* s = static_cast<const char*>(src);
-    char* d = static_cast<char*>(dest);
-    for (size_t i = 0; i < count; ++i) {
-        d[i] = s[i];
-    }
-}
-
 namespace Quanta {
 
 //=============================================================================
@@ -38,9 +30,11 @@ DataView::DataView(std::shared_ptr<ArrayBuffer> buffer)
     
     byte_offset_ = 0;
     byte_length_ = buffer_->byte_length();
+    data_ = buffer_->data();
     
-    // Add methods directly to this instance - DISABLED due to compilation issues
-    // setup_methods();
+    if (Object* prototype = Isolate::current().prototypes().data_view) {
+        set_prototype(prototype);
+    }
 }
 
 DataView::DataView(std::shared_ptr<ArrayBuffer> buffer, size_t byte_offset)
@@ -56,7 +50,11 @@ DataView::DataView(std::shared_ptr<ArrayBuffer> buffer, size_t byte_offset)
     }
     
     byte_length_ = buffer_->byte_length() - byte_offset_;
-    // setup_methods();
+    data_ = buffer_->data() + byte_offset_;
+    
+    if (Object* prototype = Isolate::current().prototypes().data_view) {
+        set_prototype(prototype);
+    }
 }
 
 DataView::DataView(std::shared_ptr<ArrayBuffer> buffer, size_t byte_offset, size_t byte_length)
@@ -70,112 +68,79 @@ DataView::DataView(std::shared_ptr<ArrayBuffer> buffer, size_t byte_offset, size
     if (byte_offset + byte_length > buffer_->byte_length()) {
         throw std::range_error("DataView extends beyond ArrayBuffer bounds");
     }
-    // setup_methods();
-}
-
-bool DataView::validate_offset(size_t offset, size_t size) const {
-    if (buffer_->is_detached()) {
-        return false;
+    data_ = buffer_->data() + byte_offset_;
+    
+    if (Object* prototype = Isolate::current().prototypes().data_view) {
+        set_prototype(prototype);
     }
-    return offset + size <= byte_length_;
 }
 
-uint8_t* DataView::get_data_ptr() const {
-    if (!buffer_ || buffer_->is_detached()) {
-        return nullptr;
+// Byte order conversion compiles to a single bswap (or nothing, when the
+// requested order is the host's)
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+static constexpr bool HOST_LITTLE_ENDIAN = false;
+#else
+static constexpr bool HOST_LITTLE_ENDIAN = true;
+#endif
+
+template<typename Bits>
+static inline Bits swap_bytes(Bits bits) {
+    if constexpr (sizeof(Bits) == 2) {
+        return __builtin_bswap16(bits);
+    } else if constexpr (sizeof(Bits) == 4) {
+        return __builtin_bswap32(bits);
+    } else if constexpr (sizeof(Bits) == 8) {
+        return __builtin_bswap64(bits);
+    } else {
+        return bits;
     }
-    return buffer_->data() + byte_offset_;
 }
 
-// Endianness conversion utilities
-uint16_t DataView::swap_bytes_16(uint16_t value) const {
-    return ((value >> 8) & 0xFF) | ((value & 0xFF) << 8);
-}
+// Unsigned integer type of T's width, used to move T's bytes around
+template<size_t Size> struct BitsOfSize;
+template<> struct BitsOfSize<1> { using type = uint8_t; };
+template<> struct BitsOfSize<2> { using type = uint16_t; };
+template<> struct BitsOfSize<4> { using type = uint32_t; };
+template<> struct BitsOfSize<8> { using type = uint64_t; };
 
-uint32_t DataView::swap_bytes_32(uint32_t value) const {
-    return ((value >> 24) & 0xFF) |
-           ((value >> 8) & 0xFF00) |
-           ((value & 0xFF00) << 8) |
-           ((value & 0xFF) << 24);
+template<typename T>
+T DataView::load(const uint8_t* bytes, bool little_endian) {
+    using Bits = typename BitsOfSize<sizeof(T)>::type;
+    Bits bits;
+    __builtin_memcpy(&bits, bytes, sizeof(T));
+    if (sizeof(T) > 1 && little_endian != HOST_LITTLE_ENDIAN) {
+        bits = swap_bytes(bits);
+    }
+    T result;
+    __builtin_memcpy(&result, &bits, sizeof(T));
+    return result;
 }
 
-uint64_t DataView::swap_bytes_64(uint64_t value) const {
-    return ((value >> 56) & 0xFF) |
-           ((value >> 40) & 0xFF00) |
-           ((value >> 24) & 0xFF0000) |
-           ((value >> 8) & 0xFF000000) |
-           ((value & 0xFF000000) << 8) |
-           ((value & 0xFF0000) << 24) |
-           ((value & 0xFF00) << 40) |
-           ((value & 0xFF) << 56);
+template<typename T>
+void DataView::store(uint8_t* bytes, T value, bool little_endian) {
+    using Bits = typename BitsOfSize<sizeof(T)>::type;
+    Bits bits;
+    __builtin_memcpy(&bits, &value, sizeof(T));
+    if (sizeof(T) > 1 && little_endian != HOST_LITTLE_ENDIAN) {
+        bits = swap_bytes(bits);
+    }
+    __builtin_memcpy(bytes, &bits, sizeof(T));
 }
 
 // Template implementation for reading values
 template<typename T>
 T DataView::read_value(size_t offset, bool little_endian) const {
-    if (!validate_offset(offset, sizeof(T))) {
-        return T{};
-    }
-    
-    uint8_t* data = get_data_ptr();
-    if (!data) {
-        return T{};
-    }
-    
-    T result;
-    quanta_memcpy(&result, data + offset, sizeof(T));
-    
-    // Handle endianness conversion for multi-byte types
-    if constexpr (sizeof(T) > 1) {
-        bool is_big_endian = false; // Assume little-endian host for now
-        if (little_endian != is_big_endian) {
-            // Need to swap bytes
-            if constexpr (sizeof(T) == 2) {
-                uint16_t* ptr = reinterpret_cast<uint16_t*>(&result);
-                *ptr = swap_bytes_16(*ptr);
-            } else if constexpr (sizeof(T) == 4) {
-                uint32_t* ptr = reinterpret_cast<uint32_t*>(&result);
-                *ptr = swap_bytes_32(*ptr);
-            } else if constexpr (sizeof(T) == 8) {
-                uint64_t* ptr = reinterpret_cast<uint64_t*>(&result);
-                *ptr = swap_bytes_64(*ptr);
-            }
-        }
-    }
-    
-    return result;
+    const uint8_t* bytes = bytes_at(offset, sizeof(T));
+    return bytes ? load<T>(bytes, little_endian) : T{};
 }
 
 template<typename T>
 bool DataView::write_value(size_t offset, T value, bool little_endian) {
-    if (!validate_offset(offset, sizeof(T))) {
+    uint8_t* bytes = bytes_at(offset, sizeof(T));
+    if (!bytes) {
         return false;
     }
-    
-    uint8_t* data = get_data_ptr();
-    if (!data) {
-        return false;
-    }
-    
-    // Handle endianness conversion for multi-byte types
-    if constexpr (sizeof(T) > 1) {
-        bool is_big_endian = false; // Assume little-endian host for now
-        if (little_endian != is_big_endian) {
-            // Need to swap bytes
-            if constexpr (sizeof(T) == 2) {
-                uint16_t* ptr = reinterpret_cast<uint16_t*>(&value);
-                *ptr = swap_bytes_16(*ptr);
-            } else if constexpr (sizeof(T) == 4) {
-                uint32_t* ptr = reinterpret_cast<uint32_t*>(&value);
-                *ptr = swap_bytes_32(*ptr);
-            } else if constexpr (sizeof(T) == 8) {
-                uint64_t* ptr = reinterpret_cast<uint64_t*>(&value);
-                *ptr = swap_bytes_64(*ptr);
-            }
-        }
-    }
-    
-    quanta_memcpy(data + offset, &value, sizeof(T));
+    store<T>(bytes, value, little_endian);
     return true;
 }
 
@@ -348,468 +313,284 @@ const DataView* as_data_view(const Object* obj) {
 } // namespace DataViewFactory
 
 //=============================================================================
-// DataView Instance Setup
+// DataViewLayout Implementation
 //=============================================================================
 
-void DataView::setup_methods() {
-    // DISABLED - methods are now registered in Context.cpp prototype
-    /*
-    // Helper lambda to get DataView from this binding
-    auto get_dataview = [](Context& ctx) -> DataView* {
-        Object* this_obj = ctx.get_this_binding();
-        if (!this_obj || !this_obj->is_data_view()) {
-            return nullptr;
-        }
-        return static_cast<DataView*>(this_obj);
-    };
-    
-    // Create bound methods for this instance
-    auto get_int8_fn = ObjectFactory::create_native_function("getInt8", 
-        [get_dataview](Context& ctx, const std::vector<Value>& args) -> Value {
-            if (args.empty()) {
-                ctx.throw_type_error("getInt8 requires offset argument");
-                return Value();
-            }
-            
-            DataView* dataview = get_dataview(ctx);
-            if (!dataview) {
-                ctx.throw_type_error("getInt8 called on non-DataView object");
-                return Value();
-            }
-            
-            size_t offset = static_cast<size_t>(args[0].to_number());
-            return dataview->get_int8(offset);
-        });
-    set_property("getInt8", Value(get_int8_fn.release()));
-    
-    auto get_uint8_fn = ObjectFactory::create_native_function("getUint8",
-        [get_dataview](Context& ctx, const std::vector<Value>& args) -> Value {
-            if (args.empty()) {
-                ctx.throw_type_error("getUint8 requires offset argument");
-                return Value();
-            }
-            
-            DataView* dataview = get_dataview(ctx);
-            if (!dataview) {
-                ctx.throw_type_error("getUint8 called on non-DataView object");
-                return Value();
-            }
-            
-            size_t offset = static_cast<size_t>(args[0].to_number());
-            return dataview->get_uint8(offset);
-        });
-    set_property("getUint8", Value(get_uint8_fn.release()));
-    
-    auto get_int32_fn = ObjectFactory::create_native_function("getInt32",
-        [get_dataview](Context& ctx, const std::vector<Value>& args) -> Value {
-            if (args.empty()) {
-                ctx.throw_type_error("getInt32 requires offset argument");
-                return Value();
-            }
-            
-            DataView* dataview = get_dataview(ctx);
-            if (!dataview) {
-                ctx.throw_type_error("getInt32 called on non-DataView object");
-                return Value();
-            }
-            
-            size_t offset = static_cast<size_t>(args[0].to_number());
-            bool little_endian = (args.size() > 1) ? args[1].to_boolean() : false;
-            return dataview->get_int32(offset, little_endian);
-        });
-    set_property("getInt32", Value(get_int32_fn.release()));
-    
-    auto get_float32_fn = ObjectFactory::create_native_function("getFloat32",
-        [get_dataview](Context& ctx, const std::vector<Value>& args) -> Value {
-            if (args.empty()) {
-                ctx.throw_type_error("getFloat32 requires offset argument");
-                return Value();
-            }
-            
-            DataView* dataview = get_dataview(ctx);
-            if (!dataview) {
-                ctx.throw_type_error("getFloat32 called on non-DataView object");
-                return Value();
-            }
-            
-            size_t offset = static_cast<size_t>(args[0].to_number());
-            bool little_endian = (args.size() > 1) ? args[1].to_boolean() : false;
-            return dataview->get_float32(offset, little_endian);
-        });
-    set_property("getFloat32", Value(get_float32_fn.release()));
-    
-    auto get_float64_fn = ObjectFactory::create_native_function("getFloat64",
-        [get_dataview](Context& ctx, const std::vector<Value>& args) -> Value {
-            if (args.empty()) {
-                ctx.throw_type_error("getFloat64 requires offset argument");
-                return Value();
-            }
-            
-            DataView* dataview = get_dataview(ctx);
-            if (!dataview) {
-                ctx.throw_type_error("getFloat64 called on non-DataView object");
-                return Value();
-            }
-            
-            size_t offset = static_cast<size_t>(args[0].to_number());
-            bool little_endian = (args.size() > 1) ? args[1].to_boolean() : false;
-            return dataview->get_float64(offset, little_endian);
-        });
-    set_property("getFloat64", Value(get_float64_fn.release()));
-    
-    auto set_int8_fn = ObjectFactory::create_native_function("setInt8",
-        [get_dataview](Context& ctx, const std::vector<Value>& args) -> Value {
-            if (args.size() < 2) {
-                ctx.throw_type_error("setInt8 requires offset and value arguments");
-                return Value();
-            }
-            
-            DataView* dataview = get_dataview(ctx);
-            if (!dataview) {
-                ctx.throw_type_error("setInt8 called on non-DataView object");
-                return Value();
-            }
-            
-            size_t offset = static_cast<size_t>(args[0].to_number());
-            int8_t value = static_cast<int8_t>(args[1].to_number());
-            dataview->set_int8(offset, value);
-            return Value();
-        });
-    set_property("setInt8", Value(set_int8_fn.release()));
-    
-    auto set_uint8_fn = ObjectFactory::create_native_function("setUint8",
-        [get_dataview](Context& ctx, const std::vector<Value>& args) -> Value {
-            if (args.size() < 2) {
-                ctx.throw_type_error("setUint8 requires offset and value arguments");
-                return Value();
-            }
-            
-            DataView* dataview = get_dataview(ctx);
-            if (!dataview) {
-                ctx.throw_type_error("setUint8 called on non-DataView object");
-                return Value();
-            }
-            
-            size_t offset = static_cast<size_t>(args[0].to_number());
-            uint8_t value = static_cast<uint8_t>(args[1].to_number());
-            dataview->set_uint8(offset, value);
-            return Value();
-        });
-    set_property("setUint8", Value(set_uint8_fn.release()));
-    
-    auto set_int32_fn = ObjectFactory::create_native_function("setInt32",
-        [get_dataview](Context& ctx, const std::vector<Value>& args) -> Value {
-            if (args.size() < 2) {
-                ctx.throw_type_error("setInt32 requires offset and value arguments");
-                return Value();
-            }
-            
-            DataView* dataview = get_dataview(ctx);
-            if (!dataview) {
-                ctx.throw_type_error("setInt32 called on non-DataView object");
-                return Value();
-            }
-            
-            size_t offset = static_cast<size_t>(args[0].to_number());
-            int32_t value = static_cast<int32_t>(args[1].to_number());
-            bool little_endian = (args.size() > 2) ? args[2].to_boolean() : false;
-            dataview->set_int32(offset, value, little_endian);
-            return Value();
-        });
-    set_property("setInt32", Value(set_int32_fn.release()));
-    
-    auto set_float32_fn = ObjectFactory::create_native_function("setFloat32",
-        [get_dataview](Context& ctx, const std::vector<Value>& args) -> Value {
-            if (args.size() < 2) {
-                ctx.throw_type_error("setFloat32 requires offset and value arguments");
-                return Value();
-            }
-            
-            DataView* dataview = get_dataview(ctx);
-            if (!dataview) {
-                ctx.throw_type_error("setFloat32 called on non-DataView object");
-                return Value();
-            }
-            
-            size_t offset = static_cast<size_t>(args[0].to_number());
-            float value = static_cast<float>(args[1].to_number());
-            bool little_endian = (args.size() > 2) ? args[2].to_boolean() : false;
-            dataview->set_float32(offset, value, little_endian);
-            return Value();
-        });
-    set_property("setFloat32", Value(set_float32_fn.release()));
-    
-    auto set_float64_fn = ObjectFactory::create_native_function("setFloat64",
-        [get_dataview](Context& ctx, const std::vector<Value>& args) -> Value {
-            if (args.size() < 2) {
-                ctx.throw_type_error("setFloat64 requires offset and value arguments");
-                return Value();
-            }
-            
-            DataView* dataview = get_dataview(ctx);
-            if (!dataview) {
-                ctx.throw_type_error("setFloat64 called on non-DataView object");
-                return Value();
-            }
-            
-            size_t offset = static_cast<size_t>(args[0].to_number());
-            double value = args[1].to_number();
-            bool little_endian = (args.size() > 2) ? args[2].to_boolean() : false;
-            dataview->set_float64(offset, value, little_endian);
-            return Value();
-        });
-    set_property("setFloat64", Value(set_float64_fn.release()));
-    */
-}
-
-//=============================================================================
-// DataView JavaScript Method Implementations
-//=============================================================================
-
-DataView* DataView::get_this_dataview(Context& ctx) {
-    // In a real implementation, we'd get 'this' from the context
-    // For now, this is a placeholder
-    return nullptr;
-}
-
-Value DataView::js_get_int8(Context& ctx, const std::vector<Value>& args) {
-    if (args.empty()) {
-        ctx.throw_type_error("DataView.getInt8 requires offset argument");
-        return Value();
-    }
-    
-    // This would normally get 'this' from context binding
-    // For now, return placeholder
-    return Value(0.0);
-}
-
-Value DataView::js_get_uint8(Context& ctx, const std::vector<Value>& args) {
-    if (args.empty()) {
-        ctx.throw_type_error("DataView.getUint8 requires offset argument");
-        return Value();
+DataViewLayout::DataViewLayout(std::vector<Field> fields, bool little_endian)
+    : Object(ObjectType::Custom), fields_(std::move(fields)), byte_length_(0), little_endian_(little_endian) {
+    for (const Field& field : fields_) {
+        byte_length_ = std::max(byte_length_, field.offset + field_size(field.type));
     }
-    
-    // Get 'this' binding (the DataView object)
-    Object* this_obj = ctx.get_this_binding();
-    if (!this_obj || !this_obj->is_data_view()) {
-        ctx.throw_type_error("getUint8 called on non-DataView object");
-        return Value();
-    }
-    
-    DataView* dataview = static_cast<DataView*>(this_obj);
-    size_t offset = static_cast<size_t>(args[0].to_number());
-    return dataview->get_uint8(offset);
 }
 
-Value DataView::js_get_int16(Context& ctx, const std::vector<Value>& args) {
-    if (args.empty()) {
-        ctx.throw_type_error("DataView.getInt16 requires offset argument");
-        return Value();
-    }
-    
-    Object* this_obj = ctx.get_this_binding();
-    if (!this_obj || !this_obj->is_data_view()) {
-        ctx.throw_type_error("getInt16 called on non-DataView object");
-        return Value();
+Value DataViewLayout::get_property(const std::string& key) const {
+    if (key == "byteLength") {
+        return Value(static_cast<double>(byte_length_));
     }
-    
-    DataView* dataview = static_cast<DataView*>(this_obj);
-    size_t offset = static_cast<size_t>(args[0].to_number());
-    bool little_endian = (args.size() > 1) ? args[1].to_boolean() : false;
-    return dataview->get_int16(offset, little_endian);
+    return Object::get_property(key);
 }
 
-Value DataView::js_get_uint16(Context& ctx, const std::vector<Value>& args) {
-    if (args.empty()) {
-        ctx.throw_type_error("DataView.getUint16 requires offset argument");
-        return Value();
+bool DataViewLayout::parse_field_type(const std::string& name, FieldType& type) {
+    static const struct { const char* name; FieldType type; } types[] = {
+        {"int8", FieldType::Int8}, {"uint8", FieldType::Uint8},
+        {"int16", FieldType::Int16}, {"uint16", FieldType::Uint16},
+        {"int32", FieldType::Int32}, {"uint32", FieldType::Uint32},
+        {"float32", FieldType::Float32}, {"float64", FieldType::Float64}
+    };
+    for (const auto& entry : types) {
+        if (name == entry.name) {
+            type = entry.type;
+            return true;
+        }
     }
-    return Value(0.0);
+    return false;
 }
 
-Value DataView::js_get_int32(Context& ctx, const std::vector<Value>& args) {
-    if (args.empty()) {
-        ctx.throw_type_error("DataView.getInt32 requires offset argument");
-        return Value();
+uint32_t DataViewLayout::field_size(FieldType type) {
+    switch (type) {
+        case FieldType::Int8:
+        case FieldType::Uint8:
+            return 1;
+        case FieldType::Int16:
+        case FieldType::Uint16:
+            return 2;
+        case FieldType::Int32:
+        case FieldType::Uint32:
+        case FieldType::Float32:
+            return 4;
+        case FieldType::Float64:
+            return 8;
     }
-    return Value(0.0);
+    return 0;
 }
 
-Value DataView::js_get_uint32(Context& ctx, const std::vector<Value>& args) {
-    if (args.empty()) {
-        ctx.throw_type_error("DataView.getUint32 requires offset argument");
-        return Value();
+bool DataView::read_layout(const DataViewLayout& layout, size_t offset, Object* target) const {
+    // One bounds check covers the whole record
+    const uint8_t* record = bytes_at(offset, layout.byte_length());
+    if (!record) {
+        return false;
     }
     
-    Object* this_obj = ctx.get_this_binding();
-    if (!this_obj || !this_obj->is_data_view()) {
-        ctx.throw_type_error("getUint32 called on non-DataView object");
-        return Value();
+    bool little_endian = layout.little_endian();
+    for (const DataViewLayout::Field& field : layout.fields()) {
+        const uint8_t* bytes = record + field.offset;
+        double value = 0;
+        switch (field.type) {
+            case DataViewLayout::FieldType::Int8:    value = load<int8_t>(bytes, little_endian); break;
+            case DataViewLayout::FieldType::Uint8:   value = load<uint8_t>(bytes, little_endian); break;
+            case DataViewLayout::FieldType::Int16:   value = load<int16_t>(bytes, little_endian); break;
+            case DataViewLayout::FieldType::Uint16:  value = load<uint16_t>(bytes, little_endian); break;
+            case DataViewLayout::FieldType::Int32:   value = load<int32_t>(bytes, little_endian); break;
+            case DataViewLayout::FieldType::Uint32:  value = load<uint32_t>(bytes, little_endian); break;
+            case DataViewLayout::FieldType::Float32: value = load<float>(bytes, little_endian); break;
+            case DataViewLayout::FieldType::Float64: value = load<double>(bytes, little_endian); break;
+        }
+        target->set_property(field.name, Value(value));
     }
-    
-    DataView* dataview = static_cast<DataView*>(this_obj);
-    size_t offset = static_cast<size_t>(args[0].to_number());
-    bool little_endian = (args.size() > 1) ? args[1].to_boolean() : false;
-    return dataview->get_uint32(offset, little_endian);
+    return true;
 }
 
-Value DataView::js_get_float32(Context& ctx, const std::vector<Value>& args) {
-    if (args.empty()) {
-        ctx.throw_type_error("DataView.getFloat32 requires offset argument");
-        return Value();
+//=============================================================================
+// DataView.prototype builtins
+//=============================================================================
+
+// ToIndex for byte offsets; false (with a RangeError thrown) when negative
+static bool to_byte_index(Context& ctx, const Value* args, size_t argc, size_t& index) {
+    double number = 0;
+    if (argc > 0) {
+        number = args[0].is_number() ? args[0].as_number() : args[0].to_number();
     }
-    
-    Object* this_obj = ctx.get_this_binding();
-    if (!this_obj || !this_obj->is_data_view()) {
-        ctx.throw_type_error("getFloat32 called on non-DataView object");
-        return Value();
+    if (std::isnan(number)) {
+        number = 0;
     }
-    
-    DataView* dataview = static_cast<DataView*>(this_obj);
-    size_t offset = static_cast<size_t>(args[0].to_number());
-    bool little_endian = (args.size() > 1) ? args[1].to_boolean() : false;
-    return dataview->get_float32(offset, little_endian);
+    number = std::trunc(number);
+    if (number < 0 || number > 9007199254740991.0) {
+        ctx.throw_range_error("Offset is outside the bounds of the DataView");
+        return false;
+    }
+    index = static_cast<size_t>(number);
+    return true;
 }
 
-Value DataView::js_get_float64(Context& ctx, const std::vector<Value>& args) {
-    if (args.empty()) {
-        ctx.throw_type_error("DataView.getFloat64 requires offset argument");
-        return Value();
+// ToUint32: the value's low 32 bits, which narrower stores truncate further
+static uint32_t to_uint32_bits(const Value& value) {
+    double number = value.is_number() ? value.as_number() : value.to_number();
+    if (!std::isfinite(number)) {
+        return 0;
     }
-    
-    Object* this_obj = ctx.get_this_binding();
-    if (!this_obj || !this_obj->is_data_view()) {
-        ctx.throw_type_error("getFloat64 called on non-DataView object");
-        return Value();
+    double wrapped = std::fmod(std::trunc(number), 4294967296.0);
+    if (wrapped < 0) {
+        wrapped += 4294967296.0;
     }
-    
-    DataView* dataview = static_cast<DataView*>(this_obj);
-    size_t offset = static_cast<size_t>(args[0].to_number());
-    bool little_endian = (args.size() > 1) ? args[1].to_boolean() : false;
-    return dataview->get_float64(offset, little_endian);
+    return static_cast<uint32_t>(wrapped);
 }
 
-Value DataView::js_set_int8(Context& ctx, const std::vector<Value>& args) {
-    if (args.size() < 2) {
-        ctx.throw_type_error("DataView.setInt8 requires offset and value arguments");
-        return Value();
-    }
-    return Value();
+const char* DataView::builtin_name(DataViewBuiltin id) {
+    static const char* const names[] = {
+        "getInt8", "getUint8", "getInt16", "getUint16", "getInt32", "getUint32", "getFloat32", "getFloat64",
+        "setInt8", "setUint8", "setInt16", "setUint16", "setInt32", "setUint32", "setFloat32", "setFloat64",
+        "readLayout"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(DataViewBuiltin::Count),
+                  "every DataViewBuiltin needs a name");
+    return names[static_cast<size_t>(id)];
 }
 
-Value DataView::js_set_uint8(Context& ctx, const std::vector<Value>& args) {
-    if (args.size() < 2) {
-        ctx.throw_type_error("DataView.setUint8 requires offset and value arguments");
-        return Value();
-    }
-    
+Value DataView::Method::operator()(Context& ctx, const std::vector<Value>& args) const {
     Object* this_obj = ctx.get_this_binding();
     if (!this_obj || !this_obj->is_data_view()) {
-        ctx.throw_type_error("setUint8 called on non-DataView object");
+        ctx.throw_type_error(std::string(builtin_name(id)) + " called on non-DataView object");
         return Value();
     }
-    
-    DataView* dataview = static_cast<DataView*>(this_obj);
-    size_t offset = static_cast<size_t>(args[0].to_number());
-    uint8_t value = static_cast<uint8_t>(args[1].to_number());
-    dataview->set_uint8(offset, value);
-    return Value();
+    return call_builtin(id, ctx, static_cast<DataView*>(this_obj), args.data(), args.size());
 }
 
-Value DataView::js_set_int16(Context& ctx, const std::vector<Value>& args) {
-    if (args.size() < 2) {
-        ctx.throw_type_error("DataView.setInt16 requires offset and value arguments");
+Value DataView::call_builtin(DataViewBuiltin id, Context& ctx, DataView* view, const Value* args, size_t argc) {
+    size_t offset = 0;
+    if (!to_byte_index(ctx, args, argc, offset)) {
         return Value();
     }
     
-    Object* this_obj = ctx.get_this_binding();
-    if (!this_obj || !this_obj->is_data_view()) {
-        ctx.throw_type_error("setInt16 called on non-DataView object");
+    if (id == DataViewBuiltin::ReadLayout) {
+        Object* layout_obj = argc > 1 && args[1].is_object() ? args[1].as_object() : nullptr;
+        const DataViewLayout* layout = dynamic_cast<const DataViewLayout*>(layout_obj);
+        if (!layout) {
+            ctx.throw_type_error("readLayout requires a layout from DataView.compileLayout");
+            return Value();
+        }
+        Object* target = argc > 2 && args[2].is_object() ? args[2].as_object() : nullptr;
+        std::unique_ptr<Object> created;
+        if (!target) {
+            created = ObjectFactory::create_object();
+            target = created.get();
+        }
+        if (!view->read_layout(*layout, offset, target)) {
+            ctx.throw_range_error("Offset is outside the bounds of the DataView");
+            return Value();
+        }
+        return created ? Value(created.release()) : args[2];
+    }
+    
+    if (id < DataViewBuiltin::SetInt8) {
+        // Getters: (byteOffset, littleEndian)
+        bool little_endian = argc > 1 && args[1].to_boolean();
+        const uint8_t* bytes = nullptr;
+        switch (id) {
+            case DataViewBuiltin::GetInt8:
+                if ((bytes = view->bytes_at(offset, 1))) return Value(static_cast<int32_t>(load<int8_t>(bytes, false)));
+                break;
+            case DataViewBuiltin::GetUint8:
+                if ((bytes = view->bytes_at(offset, 1))) return Value(static_cast<int32_t>(load<uint8_t>(bytes, false)));
+                break;
+            case DataViewBuiltin::GetInt16:
+                if ((bytes = view->bytes_at(offset, 2))) return Value(static_cast<int32_t>(load<int16_t>(bytes, little_endian)));
+                break;
+            case DataViewBuiltin::GetUint16:
+                if ((bytes = view->bytes_at(offset, 2))) return Value(static_cast<int32_t>(load<uint16_t>(bytes, little_endian)));
+                break;
+            case DataViewBuiltin::GetInt32:
+                if ((bytes = view->bytes_at(offset, 4))) return Value(load<int32_t>(bytes, little_endian));
+                break;
+            case DataViewBuiltin::GetUint32:
+                if ((bytes = view->bytes_at(offset, 4))) return Value(load<uint32_t>(bytes, little_endian));
+                break;
+            case DataViewBuiltin::GetFloat32:
+                if ((bytes = view->bytes_at(offset, 4))) return Value(static_cast<double>(load<float>(bytes, little_endian)));
+                break;
+            case DataViewBuiltin::GetFloat64:
+                if ((bytes = view->bytes_at(offset, 8))) return Value(load<double>(bytes, little_endian));
+                break;
+            default:
+                break;
+        }
+        ctx.throw_range_error("Offset is outside the bounds of the DataView");
         return Value();
     }
     
-    DataView* dataview = static_cast<DataView*>(this_obj);
-    size_t offset = static_cast<size_t>(args[0].to_number());
-    int16_t value = static_cast<int16_t>(args[1].to_number());
-    bool little_endian = (args.size() > 2) ? args[2].to_boolean() : false;
-    dataview->set_int16(offset, value, little_endian);
-    return Value();
-}
-
-Value DataView::js_set_uint16(Context& ctx, const std::vector<Value>& args) {
-    if (args.size() < 2) {
-        ctx.throw_type_error("DataView.setUint16 requires offset and value arguments");
-        return Value();
-    }
-    return Value();
-}
-
-Value DataView::js_set_int32(Context& ctx, const std::vector<Value>& args) {
-    if (args.size() < 2) {
-        ctx.throw_type_error("DataView.setInt32 requires offset and value arguments");
-        return Value();
+    // Setters: (byteOffset, value, littleEndian)
+    Value value = argc > 1 ? args[1] : Value();
+    bool little_endian = argc > 2 && args[2].to_boolean();
+    bool stored = false;
+    switch (id) {
+        case DataViewBuiltin::SetInt8:
+        case DataViewBuiltin::SetUint8:
+            stored = view->write_value<uint8_t>(offset, static_cast<uint8_t>(to_uint32_bits(value)), false);
+            break;
+        case DataViewBuiltin::SetInt16:
+        case DataViewBuiltin::SetUint16:
+            stored = view->write_value<uint16_t>(offset, static_cast<uint16_t>(to_uint32_bits(value)), little_endian);
+            break;
+        case DataViewBuiltin::SetInt32:
+        case DataViewBuiltin::SetUint32:
+            stored = view->write_value<uint32_t>(offset, to_uint32_bits(value), little_endian);
+            break;
+        case DataViewBuiltin::SetFloat32:
+            stored = view->write_value<float>(offset, static_cast<float>(value.to_number()), little_endian);
+            break;
+        case DataViewBuiltin::SetFloat64:
+            stored = view->write_value<double>(offset, value.to_number(), little_endian);
+            break;
+        default:
+            break;
+    }
+    if (!stored) {
+        ctx.throw_range_error("Offset is outside the bounds of the DataView");
     }
     return Value();
 }
 
-Value DataView::js_set_uint32(Context& ctx, const std::vector<Value>& args) {
-    if (args.size() < 2) {
-        ctx.throw_type_error("DataView.setUint32 requires offset and value arguments");
+Value DataView::compile_layout(Context& ctx, const std::vector<Value>& args) {
+    if (args.empty() || !args[0].is_object() || !args[0].as_object()->is_array()) {
+        ctx.throw_type_error("DataView.compileLayout requires an array of [name, type] fields");
         return Value();
     }
     
-    Object* this_obj = ctx.get_this_binding();
-    if (!this_obj || !this_obj->is_data_view()) {
-        ctx.throw_type_error("setUint32 called on non-DataView object");
-        return Value();
+    Object* list = args[0].as_object();
+    std::vector<DataViewLayout::Field> fields;
+    uint32_t offset = 0;
+    uint32_t length = list->get_length();
+    fields.reserve(length);
+    for (uint32_t i = 0; i < length; ++i) {
+        Value entry = list->get_element(i);
+        if (!entry.is_object() || !entry.as_object()->is_array() || entry.as_object()->get_length() < 2) {
+            ctx.throw_type_error("DataView.compileLayout: each field must be [name, type]");
+            return Value();
+        }
+        Object* pair = entry.as_object();
+        DataViewLayout::FieldType type;
+        std::string type_name = pair->get_element(1).to_string();
+        if (!DataViewLayout::parse_field_type(type_name, type)) {
+            ctx.throw_type_error("DataView.compileLayout: unknown field type '" + type_name + "'");
+            return Value();
+        }
+        fields.push_back({pair->get_element(0).to_string(), type, offset});
+        offset += DataViewLayout::field_size(type);
     }
     
-    DataView* dataview = static_cast<DataView*>(this_obj);
-    size_t offset = static_cast<size_t>(args[0].to_number());
-    uint32_t value = static_cast<uint32_t>(args[1].to_number());
-    bool little_endian = (args.size() > 2) ? args[2].to_boolean() : false;
-    dataview->set_uint32(offset, value, little_endian);
-    return Value();
+    bool little_endian = args.size() > 1 && args[1].to_boolean();
+    return Value(std::make_unique<DataViewLayout>(std::move(fields), little_endian).release());
 }
 
-Value DataView::js_set_float32(Context& ctx, const std::vector<Value>& args) {
-    if (args.size() < 2) {
-        ctx.throw_type_error("DataView.setFloat32 requires offset and value arguments");
-        return Value();
-    }
+void DataView::setup_data_view_prototype(Context& ctx) {
+    auto dataview_constructor = ObjectFactory::create_native_function("DataView", DataView::constructor);
     
-    Object* this_obj = ctx.get_this_binding();
-    if (!this_obj || !this_obj->is_data_view()) {
-        ctx.throw_type_error("setFloat32 called on non-DataView object");
-        return Value();
+    auto dataview_prototype = ObjectFactory::create_object();
+    for (uint8_t i = 0; i < static_cast<uint8_t>(DataViewBuiltin::Count); ++i) {
+        DataViewBuiltin id = static_cast<DataViewBuiltin>(i);
+        auto method = ObjectFactory::create_native_function(builtin_name(id), Method{id});
+        dataview_prototype->set_property(builtin_name(id), Value(method.release()));
     }
     
-    DataView* dataview = static_cast<DataView*>(this_obj);
-    size_t offset = static_cast<size_t>(args[0].to_number());
-    float value = static_cast<float>(args[1].to_number());
-    bool little_endian = (args.size() > 2) ? args[2].to_boolean() : false;
-    dataview->set_float32(offset, value, little_endian);
-    return Value();
-}
-
-Value DataView::js_set_float64(Context& ctx, const std::vector<Value>& args) {
-    if (args.size() < 2) {
-        ctx.throw_type_error("DataView.setFloat64 requires offset and value arguments");
-        return Value();
-    }
+    auto compile_layout_fn = ObjectFactory::create_native_function("compileLayout", DataView::compile_layout);
+    dataview_constructor->set_property("compileLayout", Value(compile_layout_fn.release()));
     
-    Object* this_obj = ctx.get_this_binding();
-    if (!this_obj || !this_obj->is_data_view()) {
-        ctx.throw_type_error("setFloat64 called on non-DataView object");
-        return Value();
-    }
+    // Store reference for constructor use
+    Isolate::current().prototypes().data_view = dataview_prototype.get();
     
-    DataView* dataview = static_cast<DataView*>(this_obj);
-    size_t offset = static_cast<size_t>(args[0].to_number());
-    double value = args[1].to_number();
-    bool little_endian = (args.size() > 2) ? args[2].to_boolean() : false;
-    dataview->set_float64(offset, value, little_endian);
-    return Value();
+    // A Function reads "prototype" from its own slot, not its properties
+    dataview_constructor->set_prototype(dataview_prototype.get());
+    dataview_constructor->set_property("prototype", Value(dataview_prototype.release()));
+    ctx.register_built_in_object("DataView", dataview_constructor.release());
 }
 
-} // namespace Quanta
\ No newline at end of file
+} // namespace Quanta
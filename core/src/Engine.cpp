@@ -19,10 +19,11 @@
 #include "Iterator.h"
 #include "Async.h"
 #include "ProxyReflect.h"
+#include "Isolate.h"
+#include "OptimizingCompiler.h"
 #include "../../parser/include/AST.h"
 #include "../../parser/include/Parser.h"
 #include "../../lexer/include/Lexer.h"
-#include "FastBytecode.h"
 #include <fstream>
 #include <sstream>
 #include <chrono>
@@ -36,28 +37,51 @@ namespace Quanta {
 // Engine Implementation
 //=============================================================================
 
-Engine::Engine() : initialized_(false), execution_count_(0),
-      total_allocations_(0), total_gc_runs_(0) {
-    // Initialize JIT compiler
-    // JIT compiler removed (was simulation)
-    
+Engine::Engine() : isolate_(std::make_unique<Isolate>()), initialized_(false), home_node_(HeapArena::ANY_NODE),
+      execution_count_(0), total_allocations_(0), total_gc_runs_(0) {
     // Initialize garbage collector
     garbage_collector_ = std::make_unique<GarbageCollector>();
     
     config_.strict_mode = false;
     config_.enable_jit = true;
+    config_.jit_threshold = OptimizingCompiler::DEFAULT_THRESHOLD;
     config_.enable_optimizations = true;
     config_.max_heap_size = 512 * 1024 * 1024;
     config_.initial_heap_size = 32 * 1024 * 1024;
     config_.max_stack_size = 8 * 1024 * 1024;
     config_.enable_debugger = false;
     config_.enable_profiler = false;
+    config_.enable_ffi = false;
+    config_.gc_worker_threads = 0;
+    garbage_collector_->set_worker_count(config_.gc_worker_threads);
     start_time_ = std::chrono::high_resolution_clock::now();
 }
 
 Engine::Engine(const Config& config) 
-    : config_(config), initialized_(false), execution_count_(0),
-      total_allocations_(0), total_gc_runs_(0) {
+    : config_(config), isolate_(std::make_unique<Isolate>()), initialized_(false),
+      home_node_(HeapArena::ANY_NODE), execution_count_(0), total_allocations_(0), total_gc_runs_(0) {
+    garbage_collector_ = std::make_unique<GarbageCollector>();
+    garbage_collector_->set_worker_count(config_.gc_worker_threads);
+    
+    // The creating thread runs the engine: pin it first so the home node
+    // found below is where it will keep running
+    if (config_.numa_arenas || config_.pin_threads) {
+        home_node_ = config_.numa_node >= 0 ? static_cast<uint32_t>(config_.numa_node) : HeapArena::current_node();
+        if (config_.pin_threads) {
+            HeapArena::pin_current_thread(home_node_);
+        }
+        if (config_.numa_arenas) {
+            isolate_->set_arena(&HeapArena::for_node(home_node_));
+        }
+        garbage_collector_->set_home_node(home_node_, config_.pin_threads);
+    }
+    garbage_collector_->set_incremental_step_budget(std::chrono::microseconds(config_.gc_step_budget_us));
+    if (config_.background_gc) {
+        garbage_collector_->set_collection_mode(GarbageCollector::CollectionMode::Background);
+        garbage_collector_->start_gc_thread();
+    } else if (config_.incremental_gc) {
+        garbage_collector_->set_collection_mode(GarbageCollector::CollectionMode::Incremental);
+    }
     start_time_ = std::chrono::high_resolution_clock::now();
 }
 
@@ -70,6 +94,7 @@ bool Engine::initialize() {
         return true;
     }
     
+    Isolate::Scope isolate_scope(isolate_.get());
     try {
         // Starting initialization
         
@@ -83,6 +108,11 @@ bool Engine::initialize() {
         module_loader_ = std::make_unique<ModuleLoader>(this);
         // Module loader initialized
         
+        optimizing_compiler_ = std::make_unique<OptimizingCompiler>(this, config_.jit_threshold);
+        
+        // Module exports and default exports live outside any context
+        garbage_collector_->set_embedder_roots([this](GCVisitor& visitor) { visit_references(visitor); });
+        
         // Initialize memory pools for object allocation
         ObjectFactory::initialize_memory_pools();
         
@@ -91,6 +121,23 @@ bool Engine::initialize() {
         setup_built_in_objects();
         setup_error_types();
         
+        // Idle time in the event loop is spent on marking slices; marking
+        // frees nothing, so it is safe between any two tasks
+        GarbageCollector* gc = garbage_collector_.get();
+        if (config_.incremental_gc || config_.background_gc) {
+            isolate_->event_loop().set_idle_callback([gc]() { gc->incremental_step(); });
+        }
+        
+        // Time the event loop spends blocked goes to marking or lazy sweeping
+        isolate_->event_loop().set_wait_handler([gc](std::chrono::microseconds duration) { gc->idle(duration); });
+        
+        // Baseline for reset()
+        global_snapshot_ = global_context_->get_variable_environment()->take_snapshot();
+        if (Object* global_obj = global_context_->get_global_object()) {
+            auto keys = global_obj->get_own_property_keys();
+            global_object_keys_.insert(keys.begin(), keys.end());
+        }
+        
         initialized_ = true;
         // Engine initialization complete
         return true;
@@ -106,11 +153,39 @@ void Engine::shutdown() {
     }
     
     // Clean up resources
+    Isolate::Scope isolate_scope(isolate_.get());
+    isolate_->event_loop().set_idle_callback(nullptr);
+    isolate_->event_loop().set_wait_handler(nullptr);
+    garbage_collector_->set_embedder_roots(nullptr);
+    optimizing_compiler_.reset();
     global_context_.reset();
     
     initialized_ = false;
 }
 
+void Engine::reset() {
+    if (!initialized_) {
+        return;
+    }
+    
+    Isolate::Scope isolate_scope(isolate_.get());
+    
+    // Work queued by the previous task must not run during the next one
+    isolate_->reset();
+    garbage_collector_->clear_kept_objects();
+    global_context_->clear_exception();
+    default_exports_registry_.clear();
+    
+    global_context_->get_variable_environment()->restore_snapshot(global_snapshot_);
+    if (Object* global_obj = global_context_->get_global_object()) {
+        for (const std::string& key : global_obj->get_own_property_keys()) {
+            if (global_object_keys_.find(key) == global_object_keys_.end()) {
+                global_obj->delete_property(key);
+            }
+        }
+    }
+}
+
 Engine::Result Engine::execute(const std::string& source) {
     return execute(source, "<anonymous>");
 }
@@ -120,6 +195,7 @@ Engine::Result Engine::execute(const std::string& source, const std::string& fil
         return Result("Engine not initialized");
     }
     
+    Isolate::Scope isolate_scope(isolate_.get());
     return execute_internal(source, filename);
 }
 
@@ -139,6 +215,7 @@ Engine::Result Engine::evaluate(const std::string& expression) {
         return Result("Engine not initialized");
     }
     
+    Isolate::Scope isolate_scope(isolate_.get());
     try {
         // Create lexer and parser for expression evaluation
         Lexer lexer(expression);
@@ -234,8 +311,22 @@ WebAPIInterface* Engine::get_web_api_interface() const {
     return nullptr;
 }
 
+void Engine::run_macrotasks() {
+    EventLoop& event_loop = isolate_->event_loop();
+    // Promise jobs queued by the script run before any macrotask, and the
+    // jobs each macrotask queues run before the next one
+    event_loop.process_microtasks();
+    garbage_collector_->clear_kept_objects();
+    while (event_loop.has_pending_macrotasks()) {
+        event_loop.process_macrotasks();
+        event_loop.process_microtasks();
+        garbage_collector_->clear_kept_objects();
+    }
+}
+
 void Engine::collect_garbage() {
     if (garbage_collector_) {
+        Isolate::Scope isolate_scope(isolate_.get());
         garbage_collector_->collect_garbage();
         total_gc_runs_++;
     }
@@ -291,6 +382,13 @@ std::string Engine::get_memory_stats() const {
     oss << "  Heap Size: " << get_heap_size() << " bytes\n";
     oss << "  Heap Usage: " << get_heap_usage() << " bytes\n";
     oss << "  Total Allocations: " << total_allocations_ << "\n";
+    if (home_node_ != HeapArena::ANY_NODE) {
+        oss << "  Home Node: " << home_node_ << "\n";
+    }
+    std::vector<size_t> node_bytes = HeapArena::node_allocated_bytes();
+    for (size_t node = 0; node < node_bytes.size(); ++node) {
+        oss << "  Node " << node << " Arena Bytes: " << node_bytes[node] << "\n";
+    }
     return oss.str();
 }
 
@@ -624,16 +722,6 @@ Engine::Result Engine::execute_internal(const std::string& source, const std::st
     try {
         execution_count_++;
         
-        // Try bytecode VM first if available
-        FastBytecodeVM vm;
-        bool compiled = vm.compile_direct(source);
-        
-        if (compiled) {
-            Value result = vm.execute_fast();
-            return Result(result);
-        }
-        
-        // Fallback: Traditional AST approach
         Lexer lexer(source);
         auto tokens = lexer.tokenize();
         
@@ -658,21 +746,34 @@ Engine::Result Engine::execute_internal(const std::string& source, const std::st
             return Result("Parse error in " + filename);
         }
         
-        // Check for simple patterns that can be optimized
-        if (is_simple_mathematical_loop(program.get())) {
-            return execute_optimized_mathematical_loop(program.get());
-        }
+        // Nodes keep offsets only; stack traces resolve them through the
+        // table of the script they came from, which its functions keep
         
         // Standard AST evaluation
         if (global_context_) {
             // Set the current filename for stack traces
             global_context_->set_current_filename(filename);
             
+            CallStack& stack = CallStack::instance();
+            auto outer_lines = stack.set_script_source(std::make_shared<const LineTable>(source));
             Value result = program->evaluate(*global_context_);
+            stack.set_script_source(std::move(outer_lines));
             
-            if (global_context_->has_exception()) {
-                Value exception = global_context_->get_exception();
-                global_context_->clear_exception();
+            bool threw = global_context_->has_exception();
+            Value exception = threw ? global_context_->get_exception() : Value();
+            global_context_->clear_exception();
+            
+            // The script's job is complete: run its promise jobs, release WeakRef
+            // targets kept alive for it, then run queued macrotasks
+            // (FinalizationRegistry cleanups)
+            {
+                HandleScope scope(garbage_collector_.get());
+                garbage_collector_->root_temporary(result);
+                garbage_collector_->root_temporary(exception);
+                run_macrotasks();
+            }
+            
+            if (threw) {
                 return Result(exception.to_string());
             }
             
@@ -688,69 +789,6 @@ Engine::Result Engine::execute_internal(const std::string& source, const std::st
     }
 }
 
-//=============================================================================
-// HIGH PERFORMANCE Mathematical Loop Optimization
-//=============================================================================
-
-bool Engine::is_simple_mathematical_loop(ASTNode* ast) {
-    if (!ast) return false;
-    
-    // Check if this is a program with a single for-loop containing simple math
-    if (ast->get_type() == ASTNode::Type::PROGRAM) {
-        // Check if program has exactly one statement that's a for-loop
-        auto program = static_cast<Program*>(ast);
-        if (program && program->get_statements().size() == 1) {
-            auto stmt = program->get_statements()[0].get();
-            if (stmt && stmt->get_type() == ASTNode::Type::FOR_STATEMENT) {
-                // This is a simple for-loop program - optimize it!
-                return true;
-            }
-        }
-    }
-    
-    return false;
-}
-
-Engine::Result Engine::execute_optimized_mathematical_loop(ASTNode* ast) {
-    // DIRECT C++ EXECUTION - Bypass all JavaScript interpretation
-    // This gives us 1000x performance boost for simple mathematical loops
-    
-    std::cout << "OPTIMIZED C++ CALCULATION: Executing mathematical loop directly" << std::endl;
-    
-    // For now, implement a hardcoded optimization for the most common pattern:
-    // for (var i = 0; i < N; i++) { result += i + 1; }
-    
-    // Extract loop bounds (simplified pattern matching)
-    // In a real implementation, this would analyze the AST structure
-    
-    // Hardcoded for our test case: 100M iterations
-    int64_t n = 100000000; // 100 million
-    int64_t result = 0;
-    
-    // OPTIMIZED C++ loop - no JavaScript overhead
-    auto start = std::chrono::high_resolution_clock::now();
-    
-    // Optimized mathematical computation using Gauss formula
-    // Sum of 1 to N = N*(N+1)/2, but our loop does i+1, so sum of 1 to N+1 - 1 = (N+1)*(N+2)/2 - 1
-    // Actually our loop: sum(i+1) for i=0 to N-1 = sum(j) for j=1 to N = N*(N+1)/2
-    result = ((int64_t)n * ((int64_t)n + 1)) / 2;
-    
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-    
-    std::cout << "MATHEMATICAL OPTIMIZATION: Completed " << n << " operations in " 
-              << duration.count() << "ms" << std::endl;
-    std::cout << "PERFORMANCE: " << (n / (duration.count() + 1) * 1000) << " ops/sec" << std::endl;
-    
-    // Update global variables to match JavaScript behavior
-    if (global_context_) {
-        global_context_->set_binding("result", Value(static_cast<double>(result)));
-        global_context_->set_binding("i", Value(static_cast<double>(n)));
-    }
-    
-    return Engine::Result(Value(static_cast<double>(result)));
-}
-
 // High-performance minimal setup - Optimized startup
 void Engine::setup_minimal_globals() {
     // Only setup absolute minimum for INSTANT startup!
@@ -786,10 +824,30 @@ bool Engine::has_default_export(const std::string& filename) {
 // Debug/Stats Methods
 void Engine::force_gc() {
     if (garbage_collector_) {
+        Isolate::Scope isolate_scope(isolate_.get());
         garbage_collector_->collect_garbage();
     }
 }
 
+void Engine::visit_references(GCVisitor& visitor) const {
+    for (const auto& pair : default_exports_registry_) {
+        visitor.visit(pair.second);
+    }
+    for (const auto& pair : global_snapshot_.bindings) {
+        visitor.visit(pair.second.value);
+    }
+    if (module_loader_) {
+        module_loader_->visit_references(visitor);
+    }
+    if (optimizing_compiler_) {
+        optimizing_compiler_->visit_references(visitor);
+    }
+    if (isolate_) {
+        // Queued promise jobs hold their handlers and derived promises
+        isolate_->event_loop().visit_references(visitor);
+    }
+}
+
 std::string Engine::get_gc_stats() const {
     if (garbage_collector_) {
         return "GC Stats: Memory managed by garbage collector";
@@ -797,8 +855,34 @@ std::string Engine::get_gc_stats() const {
     return "GC Stats: Not available";
 }
 
+void Engine::enable_jit(bool enable) {
+    config_.enable_jit = enable;
+}
+
+bool Engine::is_jit_enabled() const {
+    return config_.enable_jit;
+}
+
+void Engine::enable_ffi(bool enable) {
+    config_.enable_ffi = enable;
+}
+
+void Engine::set_jit_threshold(uint32_t threshold) {
+    config_.jit_threshold = threshold;
+    if (optimizing_compiler_) {
+        optimizing_compiler_->set_threshold(threshold);
+    }
+}
+
 std::string Engine::get_jit_stats() const {
-    return "JIT Stats: Simulation code removed";
+    if (optimizing_compiler_) {
+        return optimizing_compiler_->get_stats_string();
+    }
+    return "JIT Stats: Not available";
+}
+
+std::string Engine::get_node_rewrite_stats() const {
+    return NodeRewriteStats::current().to_string();
 }
 
 } // namespace Quanta
\ No newline at end of file
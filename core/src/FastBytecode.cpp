@@ -1,197 +0,0 @@
-/*
- * This Source Code Form is subject to the terms of the Mozilla Public
- * License, v. 2.0. If a copy of the MPL was not distributed with this
- * file, You can obtain one at http://mozilla.org/MPL/2.0/.
- */
-
-#include "../include/FastBytecode.h"
-#include <iostream>
-#include <regex>
-#include <chrono>
-#include <sstream>
-
-namespace Quanta {
-
-//=============================================================================
-// Optimized Bytecode VM Implementation
-//=============================================================================
-
-FastBytecodeVM::FastBytecodeVM() : pc_(0) {
-    registers_.resize(256); // Pre-allocate registers
-    // Optimized bytecode VM initialized
-}
-
-FastBytecodeVM::~FastBytecodeVM() {
-    // Cleanup
-}
-
-bool FastBytecodeVM::compile_direct(const std::string& source) {
-    // Direct compilation: bypassing AST
-    
-    // Clear previous code
-    code_.clear();
-    pc_ = 0;
-    
-    // Try optimized pattern compilation first
-    if (DirectPatternCompiler::try_compile_math_loop(source, *this)) {
-        return true;
-    }
-    
-    // NO PATTERN DETECTED - Don't compile, let it fall back to AST!
-    // No simple pattern detected: using AST interpretation
-    return false; // This will force fallback to AST execution
-}
-
-void FastBytecodeVM::emit(FastOp op, uint32_t a, uint32_t b, uint32_t c, double imm) {
-    code_.emplace_back(op, a, b, c, imm);
-}
-
-Value FastBytecodeVM::execute_fast() {
-    
-    auto start = std::chrono::high_resolution_clock::now();
-    
-    pc_ = 0;
-    Value result;
-    
-    // OPTIMIZED VM LOOP
-    while (pc_ < code_.size()) {
-        const FastInstruction& instr = code_[pc_];
-        
-        switch (instr.op) {
-            case FastOp::LOAD_NUMBER:
-                registers_[instr.a] = instr.immediate;
-                break;
-                
-            case FastOp::FAST_ADD:
-                registers_[instr.a] = registers_[instr.b] + registers_[instr.c];
-                break;
-                
-            case FastOp::FAST_SUB:
-                registers_[instr.a] = registers_[instr.b] - registers_[instr.c];
-                break;
-                
-            case FastOp::FAST_MUL:
-                registers_[instr.a] = registers_[instr.b] * registers_[instr.c];
-                break;
-                
-            case FastOp::FAST_DIV:
-                registers_[instr.a] = registers_[instr.b] / registers_[instr.c];
-                break;
-                
-            case FastOp::MATH_LOOP_SUM: {
-                // Real optimization: Gauss formula for arithmetic series
-                int64_t n = static_cast<int64_t>(instr.immediate);
-                int64_t sum = n * (n + 1) / 2;
-                registers_[instr.a] = static_cast<double>(sum);
-                break;
-            }
-                
-            case FastOp::NATIVE_EXEC: {
-                // Execute native C++ code for maximum performance
-                int64_t n = static_cast<int64_t>(instr.immediate);
-                int64_t result_val = 0;
-                
-                // Optimized C++ loop (still much faster than JS interpretation)
-                for (int64_t i = 0; i < n; ++i) {
-                    result_val += i + 1;
-                }
-                
-                registers_[instr.a] = static_cast<double>(result_val);
-                break;
-            }
-                
-            case FastOp::FAST_RETURN:
-                result = Value(registers_[instr.a]);
-                goto vm_exit;
-                
-            default:
-                break;
-        }
-        
-        ++pc_;
-    }
-    
-vm_exit:
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-    
-    std::cout << "BYTECODE EXECUTION COMPLETED in " << duration.count() << " microseconds" << std::endl;
-    
-    return result;
-}
-
-//=============================================================================
-// Direct Pattern Compiler - Optimized Pattern Recognition
-//=============================================================================
-
-bool DirectPatternCompiler::try_compile_math_loop(const std::string& source, FastBytecodeVM& vm) {
-    // Extract loop parameters using regex (much faster than full parsing)
-    LoopParams params = extract_loop_params(source);
-    
-    if (!params.valid) {
-        return false;
-    }
-    
-    // Math loop pattern detected
-    
-    // Determine the best optimization strategy
-    int64_t iterations = params.end_val - params.start_val;
-    
-    if (params.operation.find("+=") != std::string::npos && 
-        (params.operation.find("+ 1") != std::string::npos || 
-         params.operation.find("+1") != std::string::npos ||
-         params.operation.find("i +") != std::string::npos)) {
-        
-        // This is a summation loop - use Gauss formula
-        vm.emit(FastOp::MATH_LOOP_SUM, 0, 0, 0, static_cast<double>(iterations));
-        
-    } else {
-        // Use native C++ execution for other patterns
-        vm.emit(FastOp::NATIVE_EXEC, 0, 0, 0, static_cast<double>(iterations));
-    }
-    
-    vm.emit(FastOp::FAST_RETURN, 0);
-    return true;
-}
-
-DirectPatternCompiler::LoopParams DirectPatternCompiler::extract_loop_params(const std::string& source) {
-    LoopParams params;
-    params.valid = false;
-    
-    // Analyzing source for patterns
-    
-    // PRECISE regex patterns - Only catch SIMPLE summation loops!
-    std::vector<std::regex> patterns = {
-        // Pattern 1: EXACT simple summation: for (var i = 0; i < N; i++) { result += i + 1; }
-        std::regex(R"(for\s*\(\s*var\s+(\w+)\s*=\s*(\d+)\s*;\s*\w+\s*<\s*(\d+)\s*;\s*\w+\+\+\s*\)\s*\{\s*\w+\s*\+=\s*\w+\s*\+\s*1\s*;\s*\})"),
-        
-        // Pattern 2: Simple variable increment: for (var i = 0; i < N; i++) { result += i; }
-        std::regex(R"(for\s*\(\s*var\s+(\w+)\s*=\s*(\d+)\s*;\s*\w+\s*<\s*(\d+)\s*;\s*\w+\+\+\s*\)\s*\{\s*\w+\s*\+=\s*\w+\s*;\s*\})")
-        
-        // REMOVED overly broad patterns that catch everything!
-    };
-    
-    for (size_t i = 0; i < patterns.size(); ++i) {
-        std::smatch match;
-        if (std::regex_search(source, match, patterns[i])) {
-            params.var_name = match[1].str();
-            params.start_val = std::stoll(match[2].str());
-            params.end_val = std::stoll(match[3].str());
-            params.operation = "summation"; // Assume summation for now
-            params.valid = true;
-            
-            std::cout << "PATTERN " << (i+1) << " MATCHED: Loop from " << params.start_val 
-                      << " to " << params.end_val << std::endl;
-            std::cout << "DETECTED MATHEMATICAL SUMMATION LOOP!" << std::endl;
-            break;
-        }
-    }
-    
-    if (!params.valid) {
-        // No mathematical pattern detected
-    }
-    
-    return params;
-}
-
-} // namespace Quanta
\ No newline at end of file
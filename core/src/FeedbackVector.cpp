@@ -0,0 +1,245 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "../include/FeedbackVector.h"
+#include "../include/Object.h"
+#include "../include/GC.h"
+#include "../../parser/include/AST.h"
+#include <cmath>
+
+namespace Quanta {
+
+//=============================================================================
+// FeedbackVector Implementation
+//=============================================================================
+
+FeedbackVector::FeedbackVector(ASTNode* body) {
+    if (body) {
+        number_sites(body);
+    }
+}
+
+uint32_t FeedbackVector::add_slot(SiteKind kind) {
+    slots_.emplace_back(kind);
+    return static_cast<uint32_t>(slots_.size() - 1);
+}
+
+void FeedbackVector::number_sites(ASTNode* node) {
+    if (!node) return;
+
+    switch (node->get_type()) {
+        case ASTNode::Type::BINARY_EXPRESSION: {
+            auto* binary = static_cast<BinaryExpression*>(node);
+            binary->set_feedback_slot(add_slot(SiteKind::BinaryOp));
+            number_sites(binary->get_left());
+            number_sites(binary->get_right());
+            break;
+        }
+        case ASTNode::Type::CALL_EXPRESSION: {
+            auto* call = static_cast<CallExpression*>(node);
+            call->set_feedback_slot(add_slot(SiteKind::Call));
+            number_sites(call->get_callee());
+            for (const auto& arg : call->get_arguments()) {
+                number_sites(arg.get());
+            }
+            break;
+        }
+        case ASTNode::Type::MEMBER_EXPRESSION: {
+            auto* member = static_cast<MemberExpression*>(node);
+            member->set_feedback_slot(add_slot(member->is_computed() ? SiteKind::Element : SiteKind::Property));
+            number_sites(member->get_object());
+            if (member->is_computed()) {
+                number_sites(member->get_property());
+            }
+            break;
+        }
+        case ASTNode::Type::UNARY_EXPRESSION:
+            number_sites(static_cast<UnaryExpression*>(node)->get_operand());
+            break;
+        case ASTNode::Type::CONDITIONAL_EXPRESSION: {
+            auto* conditional = static_cast<ConditionalExpression*>(node);
+            number_sites(conditional->get_test());
+            number_sites(conditional->get_consequent());
+            number_sites(conditional->get_alternate());
+            break;
+        }
+        case ASTNode::Type::NEW_EXPRESSION: {
+            auto* new_expr = static_cast<NewExpression*>(node);
+            number_sites(new_expr->get_constructor());
+            for (const auto& arg : new_expr->get_arguments()) {
+                number_sites(arg.get());
+            }
+            break;
+        }
+        case ASTNode::Type::ARRAY_LITERAL:
+            for (const auto& element : static_cast<ArrayLiteral*>(node)->get_elements()) {
+                number_sites(element.get());
+            }
+            break;
+        case ASTNode::Type::OBJECT_LITERAL:
+            for (const auto& prop : static_cast<ObjectLiteral*>(node)->get_properties()) {
+                if (prop->computed) number_sites(prop->key.get());
+                if (!prop->method) number_sites(prop->value.get());
+            }
+            break;
+        case ASTNode::Type::SPREAD_ELEMENT:
+            number_sites(static_cast<SpreadElement*>(node)->get_argument());
+            break;
+        case ASTNode::Type::EXPRESSION_STATEMENT:
+            number_sites(static_cast<ExpressionStatement*>(node)->get_expression());
+            break;
+        case ASTNode::Type::VARIABLE_DECLARATION:
+            for (const auto& declarator : static_cast<VariableDeclaration*>(node)->get_declarations()) {
+                number_sites(declarator->get_init());
+            }
+            break;
+        case ASTNode::Type::BLOCK_STATEMENT:
+            for (const auto& statement : static_cast<BlockStatement*>(node)->get_statements()) {
+                number_sites(statement.get());
+            }
+            break;
+        case ASTNode::Type::IF_STATEMENT: {
+            auto* if_stmt = static_cast<IfStatement*>(node);
+            number_sites(if_stmt->get_test());
+            number_sites(if_stmt->get_consequent());
+            number_sites(if_stmt->get_alternate());
+            break;
+        }
+        case ASTNode::Type::FOR_STATEMENT: {
+            auto* for_stmt = static_cast<ForStatement*>(node);
+            number_sites(for_stmt->get_init());
+            number_sites(for_stmt->get_test());
+            number_sites(for_stmt->get_update());
+            number_sites(for_stmt->get_body());
+            break;
+        }
+        case ASTNode::Type::FOR_IN_STATEMENT:
+            number_sites(static_cast<ForInStatement*>(node)->get_right());
+            number_sites(static_cast<ForInStatement*>(node)->get_body());
+            break;
+        case ASTNode::Type::FOR_OF_STATEMENT:
+            number_sites(static_cast<ForOfStatement*>(node)->get_right());
+            number_sites(static_cast<ForOfStatement*>(node)->get_body());
+            break;
+        case ASTNode::Type::WHILE_STATEMENT:
+            number_sites(static_cast<WhileStatement*>(node)->get_test());
+            number_sites(static_cast<WhileStatement*>(node)->get_body());
+            break;
+        case ASTNode::Type::DO_WHILE_STATEMENT:
+            number_sites(static_cast<DoWhileStatement*>(node)->get_body());
+            number_sites(static_cast<DoWhileStatement*>(node)->get_test());
+            break;
+        case ASTNode::Type::RETURN_STATEMENT:
+            number_sites(static_cast<ReturnStatement*>(node)->get_argument());
+            break;
+        case ASTNode::Type::THROW_STATEMENT:
+            number_sites(static_cast<ThrowStatement*>(node)->get_expression());
+            break;
+        default:
+            // Literals, identifiers, nested functions and statements the
+            // optimizing tier does not compile carry no feedback
+            break;
+    }
+}
+
+uint8_t FeedbackVector::type_of(const Value& value) {
+    if (value.is_number()) {
+        double number = value.as_number();
+        if (number >= -2147483648.0 && number <= 2147483647.0 &&
+            number == static_cast<double>(static_cast<int32_t>(number)) &&
+            !(number == 0.0 && std::signbit(number))) {
+            return TYPE_INT32;
+        }
+        return TYPE_DOUBLE;
+    }
+    if (value.is_string()) return TYPE_STRING;
+    if (value.is_boolean()) return TYPE_BOOLEAN;
+    if (value.is_object_like()) return TYPE_OBJECT;
+    return TYPE_OTHER;
+}
+
+void FeedbackVector::record_binary_op(uint32_t slot, const Value& left, const Value& right) {
+    if (!has_slot(slot, SiteKind::BinaryOp)) return;
+    Slot& s = slots_[slot];
+    s.left_types |= type_of(left);
+    s.right_types |= type_of(right);
+}
+
+void FeedbackVector::record_call(uint32_t slot, Function* target) {
+    if (!has_slot(slot, SiteKind::Call)) return;
+    Slot& s = slots_[slot];
+    if (s.state == CacheState::Uninitialized) {
+        GarbageCollector::write_barrier(static_cast<Object*>(target));
+        s.target = target;
+        s.state = CacheState::Monomorphic;
+    } else if (s.state == CacheState::Monomorphic && s.target != target) {
+        s.target = nullptr;
+        s.state = CacheState::Megamorphic;
+    }
+}
+
+void FeedbackVector::record_property(uint32_t slot, Object* receiver, const std::string& key) {
+    if (!has_slot(slot, SiteKind::Property)) return;
+    Slot& s = slots_[slot];
+    if (s.state == CacheState::Megamorphic) return;
+
+    // Only writable data properties held in shape storage are cacheable;
+    // arrays keep methods outside their shape, so only their length is
+    Shape* shape = receiver->get_shape();
+    Object::ObjectType type = receiver->get_type();
+    bool cacheable = shape && !receiver->has_descriptors() &&
+                     (type == Object::ObjectType::Ordinary ||
+                      (type == Object::ObjectType::Array && key == "length")) &&
+                     shape->has_property(key);
+    if (cacheable) {
+        Shape::PropertyInfo info = shape->get_property_info(key);
+        cacheable = info.offset < receiver->shape_slot_count() &&
+                    (info.attributes & PropertyAttributes::Writable);
+        if (cacheable && s.state == CacheState::Uninitialized) {
+            s.shape = shape;
+            s.offset = info.offset;
+            s.receiver_type = static_cast<uint8_t>(type);
+            s.state = CacheState::Monomorphic;
+            return;
+        }
+        if (cacheable && s.shape == shape && s.receiver_type == static_cast<uint8_t>(type)) {
+            return;
+        }
+    }
+    s.shape = nullptr;
+    s.state = CacheState::Megamorphic;
+}
+
+void FeedbackVector::record_element(uint32_t slot, Object* receiver, const Value& key) {
+    if (!has_slot(slot, SiteKind::Element)) return;
+    Slot& s = slots_[slot];
+    if (receiver->get_type() != Object::ObjectType::Array || !(type_of(key) & TYPE_INT32) ||
+        key.as_number() < 0) {
+        s.element_kinds |= ELEMENTS_GENERIC;
+        return;
+    }
+    uint32_t index = static_cast<uint32_t>(key.as_number());
+    if (index < receiver->element_count() && !receiver->get_element(index).is_undefined()) {
+        s.element_kinds |= ELEMENTS_PACKED;
+    } else {
+        s.element_kinds |= ELEMENTS_HOLEY;
+    }
+}
+
+void FeedbackVector::record_element_generic(uint32_t slot) {
+    if (!has_slot(slot, SiteKind::Element)) return;
+    slots_[slot].element_kinds |= ELEMENTS_GENERIC;
+}
+
+void FeedbackVector::visit_references(GCVisitor& visitor) const {
+    for (const Slot& slot : slots_) {
+        if (slot.target) {
+            visitor.visit(static_cast<Object*>(slot.target));
+        }
+    }
+}
+
+} // namespace Quanta
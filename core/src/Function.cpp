@@ -6,8 +6,12 @@
 
 #include "../include/Object.h"
 #include "../include/Context.h"
+#include "../include/Async.h"
 #include "../include/Engine.h"
+#include "../include/GC.h"
 #include "../include/CallStack.h"
+#include "../include/FeedbackVector.h"
+#include "../include/OptimizingCompiler.h"
 #include "../../parser/include/AST.h"
 #include <sstream>
 #include <iostream>
@@ -25,13 +29,33 @@ namespace Quanta {
 // Function Implementation
 //=============================================================================
 
+// A literal is first evaluated while its own script's code runs, so the
+// current source is the script the body was parsed from
+SharedFunctionInfo::SharedFunctionInfo(std::vector<std::string> names, std::unique_ptr<ASTNode> body)
+    : parameter_names(std::move(names)), body(std::move(body)),
+      lines(CallStack::instance().current_source()) {}
+
+SharedFunctionInfo::SharedFunctionInfo(std::vector<std::unique_ptr<Parameter>> params, std::unique_ptr<ASTNode> body)
+    : parameters(std::move(params)), body(std::move(body)),
+      lines(CallStack::instance().current_source()) {
+    // Extract parameter names for compatibility
+    for (const auto& param : parameters) {
+        parameter_names.push_back(param->get_name()->get_name());
+    }
+}
+
+SharedFunctionInfo::~SharedFunctionInfo() = default;
+
 Function::Function(const std::string& name, 
                    const std::vector<std::string>& params,
                    std::unique_ptr<ASTNode> body,
                    Context* closure_context)
-    : Object(ObjectType::Function), name_(name), parameters_(params), 
-      body_(std::move(body)), closure_context_(closure_context), 
-      prototype_(nullptr), is_native_(false), execution_count_(0), is_hot_(false) {
+    : Object(ObjectType::Function), name_(name),
+      shared_info_(std::make_shared<SharedFunctionInfo>(params, std::move(body))), closure_context_(closure_context), 
+      closure_environment_(nullptr), prototype_(nullptr), is_native_(false), execution_count_(0), is_hot_(false),
+      next_tier_up_(0), deopt_count_(0), optimization_disabled_(false) {
+    set_closure_environment(closure_context ? closure_context->get_lexical_environment() : nullptr);
+    
     // Create default prototype object
     auto proto = ObjectFactory::create_object();
     prototype_ = proto.release();
@@ -41,7 +65,7 @@ Function::Function(const std::string& name,
     
     // Add standard function properties
     this->set_property("name", Value(name_));
-    this->set_property("length", Value(static_cast<double>(parameters_.size())));
+    this->set_property("length", Value(static_cast<double>(get_arity())));
     
 }
 
@@ -49,13 +73,16 @@ Function::Function(const std::string& name,
                    std::vector<std::unique_ptr<Parameter>> params,
                    std::unique_ptr<ASTNode> body,
                    Context* closure_context)
-    : Object(ObjectType::Function), name_(name), parameter_objects_(std::move(params)),
-      body_(std::move(body)), closure_context_(closure_context), 
-      prototype_(nullptr), is_native_(false), execution_count_(0), is_hot_(false) {
-    // Extract parameter names for compatibility
-    for (const auto& param : parameter_objects_) {
-        parameters_.push_back(param->get_name()->get_name());
-    }
+    : Function(name, std::make_shared<SharedFunctionInfo>(std::move(params), std::move(body)), closure_context) {}
+
+Function::Function(const std::string& name,
+                   std::shared_ptr<SharedFunctionInfo> shared_info,
+                   Context* closure_context)
+    : Object(ObjectType::Function), name_(name), shared_info_(std::move(shared_info)),
+      closure_context_(closure_context), 
+      closure_environment_(nullptr), prototype_(nullptr), is_native_(false), execution_count_(0), is_hot_(false),
+      next_tier_up_(0), deopt_count_(0), optimization_disabled_(false) {
+    set_closure_environment(closure_context ? closure_context->get_lexical_environment() : nullptr);
     
     // Create default prototype object
     auto proto = ObjectFactory::create_object();
@@ -66,18 +93,19 @@ Function::Function(const std::string& name,
     
     // Add standard function properties
     this->set_property("name", Value(name_));
-    this->set_property("length", Value(static_cast<double>(parameters_.size())));
+    this->set_property("length", Value(static_cast<double>(get_arity())));
     
     // Set standard function properties
     Object::set_property("name", Value(name_), PropertyAttributes::Default);
-    Object::set_property("length", Value(static_cast<double>(parameters_.size())), PropertyAttributes::Default);
+    Object::set_property("length", Value(static_cast<double>(get_arity())), PropertyAttributes::Default);
     Object::set_property("prototype", Value(prototype_), PropertyAttributes::Default);
 }
 
 Function::Function(const std::string& name,
                    std::function<Value(Context&, const std::vector<Value>&)> native_fn)
-    : Object(ObjectType::Function), name_(name), closure_context_(nullptr), 
-      prototype_(nullptr), is_native_(true), native_fn_(native_fn), execution_count_(0), is_hot_(false) {
+    : Object(ObjectType::Function), name_(name), closure_context_(nullptr), closure_environment_(nullptr),
+      prototype_(nullptr), is_native_(true), native_fn_(native_fn), execution_count_(0), is_hot_(false),
+      next_tier_up_(0), deopt_count_(0), optimization_disabled_(false) {
     // Create default prototype object for native functions too
     auto proto = ObjectFactory::create_object();
     prototype_ = proto.release();
@@ -91,11 +119,50 @@ Function::Function(const std::string& name,
     
 }
 
+Function::~Function() {
+    if (closure_environment_) closure_environment_->release();
+}
+
+void Function::set_closure_environment(Environment* environment) {
+    if (environment) environment->retain();
+    if (closure_environment_) closure_environment_->release();
+    closure_environment_ = environment;
+    GarbageCollector::write_barrier(environment);
+}
+
+const std::vector<std::string>& Function::get_parameters() const {
+    static const std::vector<std::string> none;
+    return shared_info_ ? shared_info_->parameter_names : none;
+}
+
+const std::vector<std::unique_ptr<Parameter>>& Function::get_parameter_objects() const {
+    static const std::vector<std::unique_ptr<Parameter>> none;
+    return shared_info_ ? shared_info_->parameters : none;
+}
+
 Value Function::call(Context& ctx, const std::vector<Value>& args, Value this_value) {
+    // An async body runs on a fiber stack of its own
+    if (AsyncActivation::stack_exhausted()) {
+        ctx.throw_range_error("Maximum call stack size exceeded");
+        return Value();
+    }
+
+    // Hot functions run in the optimizing tier when it can take the call
+    if (!is_native_ && ctx.get_engine()) {
+        if (OptimizingCompiler* compiler = ctx.get_engine()->get_optimizing_compiler()) {
+            Value result;
+            if (compiler->try_call(this, ctx, args, this_value, result)) {
+                return result;
+            }
+        }
+    }
+
     // Push function call onto stack trace
     CallStack& stack = CallStack::instance();
-    Position call_position(1, 1, 0); // TODO: Get actual position from call site
-    CallStackFrameGuard frame_guard(stack, get_name(), ctx.get_current_filename(), call_position, this);
+    // The call site is not known here; the frame points at the function itself
+    ASTNode* body = get_body();
+    CallStackFrameGuard frame_guard(stack, get_name(), ctx.get_current_filename(),
+                                    body ? body->get_start() : Position(0, 0, 0), this);
     
     // optimized: Track function execution for hot function detection
     execution_count_++;
@@ -105,7 +172,7 @@ Value Function::call(Context& ctx, const std::vector<Value>& args, Value this_va
     if (execution_count_ >= 3) {
         // Enable maximum inlining and loop unrolling hints
         __builtin_prefetch(this, 0, 3); // Prefetch function object
-        __builtin_prefetch(body_.get(), 0, 3); // Prefetch AST body
+        __builtin_prefetch(get_body(), 0, 3); // Prefetch AST body
         __builtin_prefetch(&args, 0, 2); // Prefetch arguments
         __builtin_prefetch(&ctx, 0, 2); // Prefetch context
     }
@@ -130,54 +197,45 @@ Value Function::call(Context& ctx, const std::vector<Value>& args, Value this_va
             ctx.set_this_binding(this_obj);
         }
 
-        // PRIMITIVE WRAPPER: Also bind 'this' for primitive values in context
-        Value old_this_value = Value();
-        bool had_this_binding = false;
-        try {
-            old_this_value = ctx.get_binding("this");
-            had_this_binding = true;
-        } catch (...) {
-            // No existing 'this' binding
-        }
-
-        // Set 'this' binding for primitive values (especially strings)
-        if (!this_value.is_undefined() && !this_value.is_null()) {
-            ctx.set_binding("this", this_value);
+        // PRIMITIVE WRAPPER: natives read a primitive receiver (a string,
+        // especially) through the 'this' binding. The caller's 'this' is
+        // immutable, so the receiver is bound in a scope of its own.
+        bool primitive_this = !this_value.is_undefined() && !this_value.is_null() && !this_value.is_object_like();
+        if (primitive_this) {
+            ctx.push_block_scope();
+            ctx.get_lexical_environment()->create_binding("this", this_value, false);
         }
         
-        // Call native C++ function
-        Value result = native_fn_(ctx, args);
+        // Call native C++ function; natives hold Values the collector cannot see
+        Value result;
+        {
+            DisallowGCScope no_gc;
+            result = native_fn_(ctx, args);
+        }
+        if (GarbageCollector* gc = ctx.get_garbage_collector()) {
+            gc->root_temporary(result);
+        }
 
         // Restore old 'this' binding
         ctx.set_this_binding(old_this);
 
-        // Restore old primitive 'this' binding
-        if (had_this_binding) {
-            ctx.set_binding("this", old_this_value);
-        } else {
-            // Remove the 'this' binding if it didn't exist before
-            try {
-                ctx.delete_binding("this");
-            } catch (...) {
-                // Ignore if deletion fails
-            }
+        if (primitive_this) {
+            ctx.pop_block_scope();
         }
 
         return result;
     }
     
-    // Create new execution context for function with proper closure context management
-    Context* parent_context = nullptr;
-    
-    // CLOSURE FIX: Always prefer closure_context_ if it exists for proper closure behavior
-    if (closure_context_ && closure_context_->get_engine() == ctx.get_engine()) {
+    // Free names resolve through the closure environment; the caller only
+    // supplies the global object and built-ins. The defining context may be
+    // gone by now, so it is only used by functions created without a scope.
+    Context* parent_context = &ctx;
+    if (!closure_environment_ && closure_context_ && closure_context_->get_engine() == ctx.get_engine()) {
         parent_context = closure_context_;
-    } else {
-        // Closure context is invalid, null, or from different engine - use current context
-        parent_context = &ctx;
     }
     auto function_context_ptr = ContextFactory::create_function_context(ctx.get_engine(), parent_context, this);
     Context& function_context = *function_context_ptr;
+    function_context.set_feedback_vector(feedback_vector_.get());
 
     // Set up 'this' binding for JavaScript function
     if (this_value.is_object() || this_value.is_function()) {
@@ -185,33 +243,25 @@ Value Function::call(Context& ctx, const std::vector<Value>& args, Value this_va
         function_context.set_this_binding(this_obj);
     }
 
-    // CLOSURE FIX: Restore captured closure variables to function context
-    auto prop_keys = this->get_own_property_keys();
-    for (const auto& key : prop_keys) {
-        if (key.length() > 10 && key.substr(0, 10) == "__closure_") {
-            std::string var_name = key.substr(10); // Remove "__closure_" prefix
-            Value closure_value = this->get_property(key);
-            function_context.create_binding(var_name, closure_value, true);
-        }
-    }
-
     // GLOBAL VARIABLE ACCESS FIX: Function context should now inherit from global context
     
     // Bind parameters to arguments with default value support
-    if (!parameter_objects_.empty()) {
+    const auto& parameter_objects = get_parameter_objects();
+    const auto& parameter_names = get_parameters();
+    if (!parameter_objects.empty()) {
         // Use parameter objects with default values and rest parameters
         size_t regular_param_count = 0;
         
         // First pass: count regular parameters and find rest parameter
-        for (const auto& param : parameter_objects_) {
+        for (const auto& param : parameter_objects) {
             if (!param->is_rest()) {
                 regular_param_count++;
             }
         }
         
         // Second pass: bind parameters
-        for (size_t i = 0; i < parameter_objects_.size(); ++i) {
-            const auto& param = parameter_objects_[i];
+        for (size_t i = 0; i < parameter_objects.size(); ++i) {
+            const auto& param = parameter_objects[i];
             
             if (param->is_rest()) {
                 // Rest parameter - create array with remaining arguments
@@ -244,9 +294,9 @@ Value Function::call(Context& ctx, const std::vector<Value>& args, Value this_va
         }
     } else {
         // Fallback to old parameter binding for compatibility
-        for (size_t i = 0; i < parameters_.size(); ++i) {
+        for (size_t i = 0; i < parameter_names.size(); ++i) {
             Value arg_value = (i < args.size()) ? args[i] : Value(); // undefined if not provided
-            function_context.create_binding(parameters_[i], arg_value, false);
+            function_context.create_binding(parameter_names[i], arg_value, false);
         }
     }
     
@@ -270,52 +320,17 @@ Value Function::call(Context& ctx, const std::vector<Value>& args, Value this_va
     }
     
     // Execute function body
-    if (body_) {
-        Value result = body_->evaluate(function_context);
-
-        // CLOSURE WRITE-BACK: Update captured closure variables that were modified
-        auto prop_keys = this->get_own_property_keys();
-        for (const auto& key : prop_keys) {
-            if (key.length() > 10 && key.substr(0, 10) == "__closure_") {
-                std::string var_name = key.substr(10); // Remove "__closure_" prefix
-
-                // Check if the closure variable was modified in the function context
-                if (function_context.has_binding(var_name)) {
-                    Value current_value = function_context.get_binding(var_name);
-                    Value original_value = this->get_property(key);
-
-                    // If the value changed, update the captured property
-                    // Use simple comparison - if values are different types or values, update
-                    bool values_different = false;
-                    if (current_value.get_type() != original_value.get_type()) {
-                        values_different = true;
-                    } else if (current_value.is_number() && original_value.is_number()) {
-                        values_different = (current_value.as_number() != original_value.as_number());
-                    } else if (current_value.is_string() && original_value.is_string()) {
-                        values_different = (current_value.as_string() != original_value.as_string());
-                    } else if (current_value.is_boolean() && original_value.is_boolean()) {
-                        values_different = (current_value.as_boolean() != original_value.as_boolean());
-                    } else {
-                        // For other types, assume they're different if we got here
-                        values_different = true;
-                    }
-
-                    if (values_different) {
-                        this->set_property(key, current_value);
-
-                        // CRITICAL FIX: Also update the original closure context
-                        if (closure_context_) {
-                            closure_context_->set_binding(var_name, current_value);
-                        }
-                    }
-                }
-            }
-        }
+    if (ASTNode* body = get_body()) {
+        Value result = body->evaluate(function_context);
 
         // Handle return statements or exceptions
         
+        // The body's handle scopes are closed, so the result is rooted in the caller's
+        GarbageCollector* gc = ctx.get_garbage_collector();
         if (function_context.has_return_value()) {
-            return function_context.get_return_value();
+            Value return_value = function_context.get_return_value();
+            if (gc) gc->root_temporary(return_value);
+            return return_value;
         }
         
         if (function_context.has_exception()) {
@@ -323,6 +338,7 @@ Value Function::call(Context& ctx, const std::vector<Value>& args, Value this_va
             return Value();
         }
         
+        if (gc) gc->root_temporary(result);
         return result.is_undefined() ? Value() : result; // Default return undefined
     }
     
@@ -335,7 +351,7 @@ Value Function::get_property(const std::string& key) const {
         return Value(name_);
     }
     if (key == "length") {
-        return Value(static_cast<double>(parameters_.size()));
+        return Value(static_cast<double>(get_arity()));
     }
     if (key == "prototype") {
         return Value(prototype_);
@@ -504,14 +520,23 @@ std::string Function::to_string() const {
     
     std::ostringstream oss;
     oss << "function " << name_ << "(";
-    for (size_t i = 0; i < parameters_.size(); ++i) {
+    const auto& parameter_names = get_parameters();
+    for (size_t i = 0; i < parameter_names.size(); ++i) {
         if (i > 0) oss << ", ";
-        oss << parameters_[i];
+        oss << parameter_names[i];
     }
     oss << ") { [native code] }";
     return oss.str();
 }
 
+void Function::visit_references(GCVisitor& visitor) const {
+    Object::visit_references(visitor);
+    visitor.visit(prototype_);
+    if (feedback_vector_) feedback_vector_->visit_references(visitor);
+    if (optimized_code_) optimized_code_->visit_references(visitor);
+    visitor.visit(closure_environment_);
+}
+
 //=============================================================================
 // ObjectFactory Function Creation
 //=============================================================================
@@ -532,6 +557,12 @@ std::unique_ptr<Function> create_js_function(const std::string& name,
     return std::make_unique<Function>(name, std::move(params), std::move(body), closure_context);
 }
 
+std::unique_ptr<Function> create_js_function(const std::string& name,
+                                             std::shared_ptr<SharedFunctionInfo> shared_info,
+                                             Context* closure_context) {
+    return std::make_unique<Function>(name, std::move(shared_info), closure_context);
+}
+
 std::unique_ptr<Function> create_native_function(const std::string& name,
                                                  std::function<Value(Context&, const std::vector<Value>&)> fn) {
     return std::make_unique<Function>(name, fn);
@@ -6,8 +6,11 @@
 
 #include "../include/GC.h"
 #include "Context.h"
+#include "Async.h"
+#include "String.h"
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 #include <string.h>
 #include <atomic>
 
@@ -23,6 +26,9 @@ GarbageCollector::GarbageCollector()
       old_generation_threshold_(4 * 1024 * 1024),    // 4MB - Reduced for SPEED
       heap_size_limit_(512 * 1024 * 1024),           // 512MB - More memory for heavy operations
       gc_trigger_ratio_(0.3),                        // Advanced threshold - 30%
+      heap_bytes_(0),
+      handle_scope_depth_(0),
+      collection_threshold_(4 * 1024 * 1024),
       gc_running_(false),
       stop_gc_thread_(false),
       collection_cycles_(0),
@@ -30,15 +36,33 @@ GarbageCollector::GarbageCollector()
       parallel_collection_(true),                    // Multi-threaded collection
       zero_copy_optimization_(true),                 // Zero-copy memory optimization
       heavy_operation_mode_(false),                  // Heavy operation optimization mode
-      emergency_cleanup_threshold_(400 * 1024 * 1024) {  // 400MB emergency threshold
+      emergency_cleanup_threshold_(400 * 1024 * 1024),   // 400MB emergency threshold
+      mark_epoch_(0),
+      idle_workers_(0),
+      active_workers_(1),
+      collection_requested_(false),
+      incremental_marking_(false),
+      incremental_step_budget_(1000),                // 1ms per marking slice
+      allocations_since_step_(0),
+      unswept_page_count_(0),
+      unswept_bytes_(0),
+      allocations_since_sweep_(0),
+      heap_lent_(false),
+      background_busy_(false),
+      pause_histogram_{},
+      worker_count_(GCWorkerPool::default_worker_count()),
+      home_node_(HeapArena::ANY_NODE),
+      pin_threads_(false) {
 }
 
 GarbageCollector::~GarbageCollector() {
     stop_gc_thread();
+    worker_pool_.reset();
+    finish_lazy_sweeping();
     
     // Clean up all managed objects
-    for (auto* managed : managed_objects_) {
-        delete managed;
+    for (auto& pair : managed_objects_) {
+        delete pair.second;
     }
     managed_objects_.clear();
 }
@@ -46,61 +70,75 @@ GarbageCollector::~GarbageCollector() {
 void GarbageCollector::register_object(Object* obj, size_t size) {
     if (!obj) return;
     
+    // Allocation pays for lazy sweeping: one page of dead objects every few allocations
+    if (unswept_page_count_.load(std::memory_order_relaxed) != 0 &&
+        ++allocations_since_sweep_ >= LAZY_SWEEP_INTERVAL) {
+        allocations_since_sweep_ = 0;
+        sweep_page_lazily(false);
+    }
+    
+    if (!track_allocation(obj, size)) return;
+    
+    // Allocation is the safepoint: the new object and every other temporary
+    // of the running statement are held by handles
+    if (collection_requested_ && at_safepoint()) {
+        collect_garbage();
+    }
+}
+
+bool GarbageCollector::track_allocation(Object* obj, size_t size) {
     std::lock_guard<std::mutex> lock(gc_mutex_);
     
+    if (managed_objects_.find(obj) != managed_objects_.end()) {
+        return false;
+    }
+    
     // Estimate size if not provided
     if (size == 0) {
         size = sizeof(Object) + obj->property_count() * sizeof(Value);
     }
     
     auto* managed = new ManagedObject(obj, Generation::Young, size);
-    managed_objects_.insert(managed);
+    managed_objects_.emplace(obj, managed);
     young_generation_.push_back(managed);
+    heap_bytes_ += size;
     
     stats_.total_allocations++;
     stats_.bytes_allocated += size;
     
     // Update peak memory usage
-    size_t current_heap_size = get_heap_size();
-    if (current_heap_size > stats_.peak_memory_usage) {
-        stats_.peak_memory_usage = current_heap_size;
+    if (heap_bytes_ > stats_.peak_memory_usage) {
+        stats_.peak_memory_usage = heap_bytes_;
     }
     
-    // High-performance GC triggering with aggressive thresholds
-    if (collection_mode_ == CollectionMode::Automatic && should_trigger_gc()) {
-        static auto last_gc_time = std::chrono::high_resolution_clock::now();
-        auto now = std::chrono::high_resolution_clock::now();
-        auto time_since_last = std::chrono::duration_cast<std::chrono::microseconds>(now - last_gc_time);
-        
-        if (ultra_fast_gc_) {
-            // High-performance GC with microsecond precision
-            if (time_since_last.count() > 500) { // 0.5ms minimum between GCs for high performance
-                if (young_generation_.size() > 50) { // Aggressive threshold
-                    if (parallel_collection_) {
-                        // Launch parallel young generation collection
-                        std::thread([this]() { collect_young_generation_parallel(); }).detach();
-                    } else {
-                        collect_young_generation_ultra_fast();
-                    }
-                    last_gc_time = now;
-                } else if (young_generation_.size() > 150) { // Emergency ultra-fast collection
-                    force_ultra_fast_collection();
-                    last_gc_time = now;
-                }
-            }
-        } else {
-            // Standard fast collection
-            if (time_since_last.count() > 5000) { // 5ms between GCs
-                if (young_generation_.size() > 75) {
-                    collect_young_generation();
-                    last_gc_time = now;
-                } else if (young_generation_.size() > 200) {
-                    collect_garbage();
-                    last_gc_time = now;
-                }
-            }
+    root_temporary(Value(obj));
+    
+    if (incremental_marking_) {
+        // Allocate grey so the object survives the cycle in progress, and
+        // pay for the allocation with a bounded slice of marking work
+        mark_object(obj, *mark_workers_[0]);
+        if (++allocations_since_step_ >= INCREMENTAL_STEP_INTERVAL) {
+            allocations_since_step_ = 0;
+            incremental_step();
         }
+        return true;
     }
+    
+    if (heap_bytes_ < collection_threshold_) return true;
+    if (collection_mode_ == CollectionMode::Incremental ||
+        collection_mode_ == CollectionMode::Background) {
+        start_incremental_marking();
+    } else if (collection_mode_ == CollectionMode::Automatic) {
+        collection_requested_ = true;
+    }
+    return true;
+}
+
+bool GarbageCollector::at_safepoint() const {
+    // Values queued in event loop tasks are invisible to the collector, as
+    // are those held by native frames (see DisallowGCScope)
+    return handle_scope_depth_ != 0 && no_gc_depth_ == 0 && !gc_running_ &&
+           !EventLoop::instance().has_pending_tasks();
 }
 
 void GarbageCollector::unregister_object(Object* obj) {
@@ -110,7 +148,8 @@ void GarbageCollector::unregister_object(Object* obj) {
     
     auto* managed = find_managed_object(obj);
     if (managed) {
-        managed_objects_.erase(managed);
+        managed_objects_.erase(obj);
+        heap_bytes_ -= managed->size;
         
         // Remove from generation vectors
         auto remove_from_vector = [managed](std::vector<ManagedObject*>& vec) {
@@ -147,14 +186,17 @@ void GarbageCollector::add_root_object(Object* obj) {
     if (!obj) return;
     
     std::lock_guard<std::mutex> lock(gc_mutex_);
-    root_objects_.insert(obj);
+    root_objects_[obj]++;
 }
 
 void GarbageCollector::remove_root_object(Object* obj) {
     if (!obj) return;
     
     std::lock_guard<std::mutex> lock(gc_mutex_);
-    root_objects_.erase(obj);
+    auto it = root_objects_.find(obj);
+    if (it != root_objects_.end() && --it->second == 0) {
+        root_objects_.erase(it);
+    }
 }
 
 void GarbageCollector::collect_garbage() {
@@ -165,7 +207,7 @@ void GarbageCollector::collect_garbage() {
     
     std::lock_guard<std::mutex> lock(gc_mutex_);
     
-    // Mark phase
+    // Mark phase (weak containers are cleared at its end)
     mark_objects();
     
     // Sweep phase
@@ -174,10 +216,12 @@ void GarbageCollector::collect_garbage() {
     // Promote objects between generations
     promote_objects();
     
-    // Clean up weak references
-    cleanup_weak_references();
-    
+    clear_marks();
+    collection_requested_ = false;
     gc_running_ = false;
+    
+    // The next safepoint collection waits for the heap to double
+    collection_threshold_ = std::max(old_generation_threshold_, heap_bytes_ * 2);
     update_statistics(start);
 }
 
@@ -198,6 +242,7 @@ void GarbageCollector::collect_young_generation() {
     // Promote surviving objects
     promote_objects();
     
+    clear_marks();
     gc_running_ = false;
     update_statistics(start);
 }
@@ -216,6 +261,7 @@ void GarbageCollector::collect_old_generation() {
     // Sweep old generation
     sweep_generation(old_generation_);
     
+    clear_marks();
     gc_running_ = false;
     update_statistics(start);
 }
@@ -236,6 +282,8 @@ void GarbageCollector::force_full_collection() {
     detect_cycles();
     break_cycles();
     
+    clear_marks();
+    collection_requested_ = false;
     gc_running_ = false;
     update_statistics(start);
 }
@@ -294,34 +342,29 @@ bool GarbageCollector::should_trigger_gc() const {
 }
 
 size_t GarbageCollector::get_heap_size() const {
-    size_t total = 0;
-    for (const auto* managed : managed_objects_) {
-        total += managed->size;
-    }
-    return total;
+    return heap_bytes_;
 }
 
 size_t GarbageCollector::get_available_memory() const {
     return heap_size_limit_ - get_heap_size();
 }
 
-void GarbageCollector::add_weak_reference(Object* obj) {
+void GarbageCollector::keep_during_job(Object* obj) {
     if (!obj) return;
     
     std::lock_guard<std::mutex> lock(gc_mutex_);
-    weak_references_.insert(obj);
+    kept_objects_.push_back(obj);
 }
 
-void GarbageCollector::remove_weak_reference(Object* obj) {
-    if (!obj) return;
-    
+void GarbageCollector::clear_kept_objects() {
     std::lock_guard<std::mutex> lock(gc_mutex_);
-    weak_references_.erase(obj);
+    kept_objects_.clear();
 }
 
 void GarbageCollector::reset_statistics() {
     std::lock_guard<std::mutex> lock(gc_mutex_);
     stats_ = Statistics();
+    pause_histogram_.fill(0);
 }
 
 void GarbageCollector::print_statistics() const {
@@ -334,22 +377,38 @@ void GarbageCollector::print_statistics() const {
     std::cout << "Bytes Allocated: " << stats_.bytes_allocated << std::endl;
     std::cout << "Bytes Freed: " << stats_.bytes_freed << std::endl;
     std::cout << "Peak Memory Usage: " << stats_.peak_memory_usage << " bytes" << std::endl;
+    std::cout << "Flattened Slices: " << stats_.flattened_slices << std::endl;
     std::cout << "Current Heap Size: " << get_heap_size() << " bytes" << std::endl;
     std::cout << "Average GC Time: " << stats_.average_gc_time.count() << "ms" << std::endl;
+    std::cout << "Pause GC Time: " << stats_.pause_gc_time.count() << "s" << std::endl;
+    std::cout << "Background GC Time: " << stats_.background_gc_time.count() << "s" << std::endl;
+    std::cout << "Max Pause: " << stats_.max_pause_time.count() * 1e3 << "ms" << std::endl;
+    std::cout << "P99 Pause: " << stats_.p99_pause_time.count() * 1e3 << "ms" << std::endl;
+    std::cout << "Unswept Bytes: " << unswept_bytes_ << std::endl;
+    std::vector<size_t> node_bytes = HeapArena::node_allocated_bytes();
+    for (size_t node = 0; node < node_bytes.size(); ++node) {
+        std::cout << "Node " << node << " Arena Bytes: " << node_bytes[node] << std::endl;
+    }
+    std::cout << "Interleaved Arena Bytes: " << HeapArena::interleaved().get_allocated_bytes() << std::endl;
     std::cout << "Young Generation Objects: " << young_generation_.size() << std::endl;
     std::cout << "Old Generation Objects: " << old_generation_.size() << std::endl;
     std::cout << "Permanent Generation Objects: " << permanent_generation_.size() << std::endl;
 }
 
 void GarbageCollector::start_gc_thread() {
-    if (collection_mode_ != CollectionMode::Automatic) return;
+    if (gc_thread_.joinable()) return;
     
     stop_gc_thread_ = false;
     gc_thread_ = std::thread(&GarbageCollector::gc_thread_main, this);
 }
 
 void GarbageCollector::stop_gc_thread() {
-    stop_gc_thread_ = true;
+    {
+        std::lock_guard<std::mutex> lock(background_mutex_);
+        stop_gc_thread_ = true;
+    }
+    background_cv_.notify_all();
+    
     if (gc_thread_.joinable()) {
         gc_thread_.join();
     }
@@ -364,7 +423,7 @@ void GarbageCollector::print_heap_info() const {
     std::cout << "Old Generation: " << old_generation_.size() << std::endl;
     std::cout << "Permanent Generation: " << permanent_generation_.size() << std::endl;
     std::cout << "Root Objects: " << root_objects_.size() << std::endl;
-    std::cout << "Weak References: " << weak_references_.size() << std::endl;
+    std::cout << "Kept Objects: " << kept_objects_.size() << std::endl;
     std::cout << "Heap Size: " << get_heap_size() << " bytes" << std::endl;
     std::cout << "Heap Limit: " << heap_size_limit_ << " bytes" << std::endl;
 }
@@ -375,7 +434,8 @@ void GarbageCollector::verify_heap_integrity() const {
     // Verify all objects in generations are in managed_objects_
     auto verify_generation = [this](const std::vector<ManagedObject*>& gen, const std::string& name) {
         for (const auto* managed : gen) {
-            if (managed_objects_.find(const_cast<ManagedObject*>(managed)) == managed_objects_.end()) {
+            auto it = managed_objects_.find(managed->object);
+            if (it == managed_objects_.end() || it->second != managed) {
                 std::cerr << "ERROR: " << name << " object not in managed_objects_" << std::endl;
             }
         }
@@ -390,107 +450,470 @@ void GarbageCollector::verify_heap_integrity() const {
 
 // Private methods
 
+thread_local GarbageCollector* GarbageCollector::marking_collector_ = nullptr;
+std::atomic<uint64_t> GarbageCollector::next_mark_epoch_{1};
+thread_local size_t GarbageCollector::no_gc_depth_ = 0;
+
+/**
+ * Visitor that greys every reference it is shown
+ * Tracing never recurses: objects are pushed on the worker's grey deque and
+ * environments are queued for the collecting thread
+ */
+class GarbageCollector::MarkingVisitor : public GCVisitor {
+public:
+    MarkingVisitor(GarbageCollector& gc, MarkWorker& worker) : gc_(gc), worker_(worker) {}
+    
+    using GCVisitor::visit;
+    void visit(Object* object) override { gc_.mark_object(object, worker_); }
+    void visit(Environment* environment) override {
+        if (environment) worker_.pending_environments.push_back(environment);
+    }
+    void visit_weak_container(Object* container) override {
+        worker_.weak_containers.push_back(container);
+    }
+    void visit_string(String* string) override {
+        if (string && string->pins_backing()) worker_.pinning_slices.push_back(string);
+    }
+
+private:
+    GarbageCollector& gc_;
+    MarkWorker& worker_;
+};
+
+void GarbageCollector::set_worker_count(size_t count) {
+    std::lock_guard<std::mutex> lock(gc_mutex_);
+    
+    size_t resolved = count == 0 ? GCWorkerPool::default_worker_count() : count;
+    if (resolved != worker_count_) {
+        worker_count_ = resolved;
+        worker_pool_.reset();
+    }
+}
+
+void GarbageCollector::set_home_node(uint32_t node, bool pin_threads) {
+    std::lock_guard<std::mutex> lock(gc_mutex_);
+    
+    home_node_ = node;
+    pin_threads_ = pin_threads;
+    worker_pool_.reset();   // helpers are pinned when they start
+}
+
+void GarbageCollector::init_gc_thread() {
+    // Helpers trace the isolate's heap, so they run next to it
+    if (pin_threads_ && home_node_ != HeapArena::ANY_NODE) {
+        HeapArena::pin_current_thread(home_node_);
+    }
+}
+
+bool GarbageCollector::use_parallel_workers() const {
+    return worker_count_ > 1 && managed_objects_.size() >= PARALLEL_HEAP_THRESHOLD;
+}
+
+void GarbageCollector::ensure_worker_pool() {
+    if (!worker_pool_) {
+        worker_pool_ = std::make_unique<GCWorkerPool>(worker_count_, [this]() { init_gc_thread(); });
+    }
+}
+
+void GarbageCollector::prepare_mark_workers(size_t count) {
+    while (mark_workers_.size() < count) {
+        mark_workers_.push_back(std::make_unique<MarkWorker>());
+        mark_workers_.back()->steal_seed = mark_workers_.size() * 0x9E3779B97F4A7C15ULL;
+    }
+    active_workers_ = count;
+}
+
 void GarbageCollector::mark_objects() {
-    // Clear all marks
-    for (auto* managed : managed_objects_) {
-        managed->is_marked = false;
+    // An incremental cycle in progress is finished rather than restarted
+    if (incremental_marking_) {
+        finish_incremental_marking();
+        cleanup_weak_references();
+        flatten_pinning_slices();
+        return;
     }
     
-    // Mark from root contexts
+    bool parallel = use_parallel_workers();
+    if (parallel) {
+        ensure_worker_pool();
+    }
+    prepare_mark_workers(parallel ? worker_pool_->size() : 1);
+    
+    begin_mark_epoch();
+    mark_roots();
+    
+    // Workers may discover environments and ephemerons; those are processed
+    // here and can grey more objects, so alternate until nothing changes
+    do {
+        if (parallel) {
+            idle_workers_.store(0);
+            worker_pool_->run([this](size_t worker_id) { drain_mark_stack(worker_id); });
+        } else {
+            drain_mark_stack(0);
+        }
+        scan_pending_environments();
+    } while (has_pending_work() || trace_ephemerons());
+    
+    cleanup_weak_references();
+    flatten_pinning_slices();
+}
+
+void GarbageCollector::mark_roots() {
+    // Roots are greyed on the calling thread; helpers steal from worker 0
     for (Context* ctx : root_contexts_) {
         mark_from_context(ctx);
     }
-    
-    // Mark from root objects
-    for (Object* obj : root_objects_) {
-        mark_object(obj);
+    MarkingVisitor visitor(*this, *mark_workers_[0]);
+    for (const auto& root : root_objects_) {
+        visitor.visit(root.first);
     }
+    for (const Value& handle : handles_) {
+        visitor.visit(handle);
+    }
+    for (Object* kept : kept_objects_) {
+        visitor.visit(kept);
+    }
+    if (embedder_roots_) {
+        embedder_roots_(visitor);
+    }
+    scan_pending_environments();
 }
 
 void GarbageCollector::mark_from_context(Context* ctx) {
     if (!ctx) return;
     
-    // Mark global object
-    if (ctx->get_global_object()) {
-        mark_object(ctx->get_global_object());
+    MarkingVisitor visitor(*this, *mark_workers_[0]);
+    ctx->visit_references(visitor);
+}
+
+void GarbageCollector::mark_object(Object* obj, MarkWorker& worker) {
+    if (!obj || !obj->try_set_gc_marked()) return;
+    
+    // Unmanaged objects (built-ins, prototypes) are marked too so that
+    // managed objects reachable only through them are found
+    worker.marked_objects.push_back(obj);
+    worker.deque.push(obj);
+}
+
+void GarbageCollector::scan_pending_environments() {
+    MarkWorker& main_worker = *mark_workers_[0];
+    MarkingVisitor visitor(*this, main_worker);
+    
+    for (size_t i = 0; i < active_workers_; ++i) {
+        auto& pending = mark_workers_[i]->pending_environments;
+        if (i != 0) {
+            main_worker.pending_environments.insert(main_worker.pending_environments.end(),
+                                                    pending.begin(), pending.end());
+            pending.clear();
+        }
     }
     
-    // Mark all bindings in the context
-    // This would require access to context's internal state
-    // For now, we'll mark the global object
+    auto& pending = main_worker.pending_environments;
+    while (!pending.empty()) {
+        Environment* env = pending.back();
+        pending.pop_back();
+        if (env->try_set_gc_scanned(mark_epoch_)) {
+            env->visit_references(visitor);
+        }
+    }
 }
 
-void GarbageCollector::mark_from_object(Object* obj) {
-    if (!obj) return;
+void GarbageCollector::drain_mark_stack(size_t worker_id) {
+    MarkWorker& worker = *mark_workers_[worker_id];
+    MarkingVisitor visitor(*this, worker);
     
-    mark_object(obj);
+    Object* obj;
+    while (true) {
+        while (worker.deque.pop(obj)) {
+            obj->visit_references(visitor);
+        }
+        
+        if (active_workers_ == 1) return;
+        
+        if (steal_work(worker_id, obj)) {
+            obj->visit_references(visitor);
+            continue;
+        }
+        
+        // Termination: marking is complete once every worker is idle with
+        // nothing left to steal. An idle worker that sees work rejoins.
+        idle_workers_.fetch_add(1, std::memory_order_acq_rel);
+        while (true) {
+            if (idle_workers_.load(std::memory_order_acquire) == active_workers_) {
+                return;
+            }
+            if (has_pending_work()) {
+                idle_workers_.fetch_sub(1, std::memory_order_acq_rel);
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool GarbageCollector::steal_work(size_t worker_id, Object*& item) {
+    MarkWorker& worker = *mark_workers_[worker_id];
     
-    // Mark all referenced objects
-    std::vector<std::string> keys = obj->get_enumerable_keys();
-    for (const std::string& key : keys) {
-        Value prop = obj->get_property(key);
-        if (prop.is_object()) {
-            mark_object(prop.as_object());
+    // xorshift victim selection, then one full sweep over all other deques
+    uint64_t x = worker.steal_seed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    worker.steal_seed = x;
+    
+    size_t start = static_cast<size_t>(x % active_workers_);
+    for (size_t i = 0; i < active_workers_; ++i) {
+        size_t victim = (start + i) % active_workers_;
+        if (victim == worker_id) continue;
+        if (mark_workers_[victim]->deque.steal(item)) {
+            return true;
         }
     }
+    return false;
 }
 
-void GarbageCollector::mark_object(Object* obj) {
-    if (!obj) return;
+bool GarbageCollector::has_pending_work() const {
+    for (size_t i = 0; i < active_workers_; ++i) {
+        if (!mark_workers_[i]->deque.empty() || !mark_workers_[i]->pending_environments.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void GarbageCollector::clear_marks() {
+    for (auto& worker : mark_workers_) {
+        for (Object* obj : worker->marked_objects) {
+            obj->clear_gc_marked();
+        }
+        worker->marked_objects.clear();
+    }
+}
+
+//=============================================================================
+// Incremental Marking
+//=============================================================================
+
+void GarbageCollector::start_incremental_marking() {
+    if (incremental_marking_ || gc_running_) return;
     
-    auto* managed = find_managed_object(obj);
-    if (managed && !managed->is_marked) {
-        managed->is_marked = true;
-        managed->access_count++;
+    prepare_mark_workers(1);
+    begin_mark_epoch();
+    mark_roots();
+    
+    incremental_marking_ = true;
+    allocations_since_step_ = 0;
+    marking_collector_ = this;
+}
+
+bool GarbageCollector::incremental_step() {
+    return incremental_step(incremental_step_budget_);
+}
+
+bool GarbageCollector::incremental_step(std::chrono::microseconds budget) {
+    if (!incremental_marking_) return false;
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    bool done = drain_mark_stack_until(start + budget);
+    record_pause(std::chrono::high_resolution_clock::now() - start);
+    
+    if (done) {
+        // The grey set is empty; the final pause re-scans roots and sweeps
+        collection_requested_ = true;
+    }
+    return done;
+}
+
+bool GarbageCollector::drain_mark_stack_until(std::chrono::high_resolution_clock::time_point deadline) {
+    MarkWorker& worker = *mark_workers_[0];
+    MarkingVisitor visitor(*this, worker);
+    
+    // Check the clock every few objects; reading it per object costs more than tracing
+    constexpr size_t CLOCK_CHECK_INTERVAL = 32;
+    size_t traced = 0;
+    
+    Object* obj;
+    while (true) {
+        if (!worker.deque.pop(obj)) {
+            if (worker.pending_environments.empty()) {
+                return true;
+            }
+            scan_pending_environments();
+            continue;
+        }
+        
+        obj->visit_references(visitor);
         
-        // Prevent infinite recursion with depth limit
-        static thread_local int recursion_depth = 0;
-        if (recursion_depth < 50) { // Maximum recursion depth
-            recursion_depth++;
-            mark_from_object(obj);
-            recursion_depth--;
+        if (++traced % CLOCK_CHECK_INTERVAL == 0 &&
+            std::chrono::high_resolution_clock::now() >= deadline) {
+            // Environments found through objects may die before the next
+            // slice, so none are carried across a slice boundary
+            scan_pending_environments();
+            return false;
         }
     }
 }
 
+void GarbageCollector::finish_incremental_marking() {
+    // Roots are not barriered, so they are re-scanned in the final pause.
+    // Environments scanned earlier in the cycle, or created during it, are
+    // black and skipped: the barrier covered every store into them since.
+    prepare_mark_workers(1);
+    mark_roots();
+    do {
+        drain_mark_stack(0);
+        scan_pending_environments();
+    } while (has_pending_work() || trace_ephemerons());
+    
+    incremental_marking_ = false;
+    marking_collector_ = nullptr;
+}
+
+void GarbageCollector::shade(Object* obj) {
+    if (!obj->is_gc_marked()) {
+        mark_object(obj, *mark_workers_[0]);
+    }
+}
+
+void GarbageCollector::shade(Environment* environment) {
+    // Scanned now rather than queued: the interpreter may free it before
+    // the next slice
+    if (environment->try_set_gc_scanned(mark_epoch_)) {
+        MarkingVisitor visitor(*this, *mark_workers_[0]);
+        environment->visit_references(visitor);
+        scan_pending_environments();
+    }
+}
+
+void GarbageCollector::begin_mark_epoch() {
+    mark_epoch_ = next_mark_epoch_.fetch_add(1, std::memory_order_relaxed);
+}
+
 void GarbageCollector::sweep_objects() {
     sweep_generation(young_generation_);
     sweep_generation(old_generation_);
     // Don't sweep permanent generation
 }
 
-void GarbageCollector::sweep_generation(std::vector<ManagedObject*>& generation) {
-    auto it = generation.begin();
-    while (it != generation.end()) {
-        auto* managed = *it;
-        if (!managed->is_marked) {
-            // Object is not reachable, delete it
-            managed_objects_.erase(managed);
-            stats_.total_deallocations++;
-            stats_.bytes_freed += managed->size;
-            
-            delete managed->object;
-            delete managed;
-            it = generation.erase(it);
+void GarbageCollector::sweep_generation(std::vector<ManagedObject*>& generation, uint32_t survivor_age) {
+    size_t page_count = (generation.size() + SWEEP_PAGE_SIZE - 1) / SWEEP_PAGE_SIZE;
+    
+    if (page_count > 1 && use_parallel_workers()) {
+        // Pages are claimed dynamically so uneven pages balance across workers
+        ensure_worker_pool();
+        prepare_mark_workers(worker_pool_->size());
+        std::atomic<size_t> next_page{0};
+        
+        worker_pool_->run([&](size_t worker_id) {
+            MarkWorker& worker = *mark_workers_[worker_id];
+            size_t page;
+            while ((page = next_page.fetch_add(1, std::memory_order_relaxed)) < page_count) {
+                size_t begin = page * SWEEP_PAGE_SIZE;
+                size_t end = std::min(begin + SWEEP_PAGE_SIZE, generation.size());
+                sweep_page(generation, begin, end, survivor_age, worker);
+            }
+        });
+    } else {
+        prepare_mark_workers(1);
+        sweep_page(generation, 0, generation.size(), survivor_age, *mark_workers_[0]);
+    }
+    
+    // Bookkeeping shared across pages is done on this thread
+    for (auto& worker : mark_workers_) {
+        defer_sweep(worker->swept);
+    }
+    
+    generation.erase(std::remove(generation.begin(), generation.end(), nullptr), generation.end());
+}
+
+void GarbageCollector::defer_sweep(std::vector<ManagedObject*>& dead) {
+    if (dead.empty()) return;
+    
+    // Dead objects leave the managed set now so their addresses can be reused
+    // as soon as they are freed; the memory is released page by page later
+    for (size_t begin = 0; begin < dead.size(); begin += SWEEP_PAGE_SIZE) {
+        size_t end = std::min(begin + SWEEP_PAGE_SIZE, dead.size());
+        std::vector<ManagedObject*> page(dead.begin() + begin, dead.begin() + end);
+        for (ManagedObject* managed : page) {
+            managed_objects_.erase(managed->object);
+            heap_bytes_ -= managed->size;
+            unswept_bytes_ += managed->size;
+        }
+        unswept_pages_.push_back(std::move(page));
+    }
+    dead.clear();
+    
+    {
+        std::lock_guard<std::mutex> lock(background_mutex_);
+        unswept_page_count_.store(unswept_pages_.size(), std::memory_order_relaxed);
+    }
+    background_cv_.notify_one();
+}
+
+bool GarbageCollector::sweep_page_lazily(bool background) {
+    std::vector<ManagedObject*> page;
+    {
+        std::lock_guard<std::mutex> lock(gc_mutex_);
+        if (unswept_pages_.empty()) return false;
+        page = std::move(unswept_pages_.front());
+        unswept_pages_.pop_front();
+        unswept_page_count_.store(unswept_pages_.size(), std::memory_order_relaxed);
+    }
+    
+    // Unreachable objects are freed without the lock; nothing else can reach them
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t freed = 0;
+    for (ManagedObject* managed : page) {
+        freed += managed->size;
+        delete managed->object;
+        delete managed;
+    }
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+    
+    std::lock_guard<std::mutex> lock(gc_mutex_);
+    unswept_bytes_ -= freed;
+    stats_.total_deallocations += page.size();
+    stats_.bytes_freed += freed;
+    if (background) {
+        stats_.total_gc_time += elapsed;
+        stats_.background_gc_time += elapsed;
+    } else {
+        record_pause(elapsed);
+    }
+    return true;
+}
+
+bool GarbageCollector::sweep_next_page() {
+    return sweep_page_lazily(false);
+}
+
+void GarbageCollector::finish_lazy_sweeping() {
+    while (sweep_page_lazily(false)) {
+    }
+}
+
+void GarbageCollector::sweep_page(std::vector<ManagedObject*>& generation, size_t begin, size_t end,
+                                  uint32_t survivor_age, MarkWorker& worker) {
+    for (size_t i = begin; i < end; ++i) {
+        ManagedObject* managed = generation[i];
+        if (!is_marked(managed)) {
+            // Object is not reachable; it is freed later by the lazy sweeper
+            worker.swept.push_back(managed);
+            generation[i] = nullptr;
         } else {
-            ++it;
+            managed->access_count += survivor_age;
         }
     }
 }
 
 void GarbageCollector::promote_objects() {
     // Promote young objects that have survived enough collections
-    auto it = young_generation_.begin();
-    while (it != young_generation_.end()) {
-        auto* managed = *it;
-        if (managed->access_count > 3) { // Arbitrary threshold
-            managed->generation = Generation::Old;
-            old_generation_.push_back(managed);
-            it = young_generation_.erase(it);
-        } else {
-            ++it;
-        }
+    auto promoted = std::stable_partition(young_generation_.begin(), young_generation_.end(),
+        [](const ManagedObject* managed) { return managed->access_count <= 3; }); // Arbitrary threshold
+    for (auto it = promoted; it != young_generation_.end(); ++it) {
+        (*it)->generation = Generation::Old;
+        old_generation_.push_back(*it);
     }
+    young_generation_.erase(promoted, young_generation_.end());
 }
 
 void GarbageCollector::age_objects() {
@@ -503,8 +926,8 @@ void GarbageCollector::age_objects() {
 void GarbageCollector::detect_cycles() {
     // Simple cycle detection algorithm
     // In a production system, this would be more sophisticated
-    for (auto* managed : managed_objects_) {
-        if (managed->is_marked) {
+    for (auto& pair : managed_objects_) {
+        if (pair.first->is_gc_marked()) {
             // Check for cycles using DFS
             std::unordered_set<Object*> visited;
             std::unordered_set<Object*> stack;
@@ -519,12 +942,8 @@ void GarbageCollector::break_cycles() {
 }
 
 GarbageCollector::ManagedObject* GarbageCollector::find_managed_object(Object* obj) {
-    for (auto* managed : managed_objects_) {
-        if (managed->object == obj) {
-            return managed;
-        }
-    }
-    return nullptr;
+    auto it = managed_objects_.find(obj);
+    return it != managed_objects_.end() ? it->second : nullptr;
 }
 
 void GarbageCollector::update_statistics(const std::chrono::high_resolution_clock::time_point& start) {
@@ -533,74 +952,167 @@ void GarbageCollector::update_statistics(const std::chrono::high_resolution_cloc
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
     
-    stats_.total_gc_time += duration;
+    record_pause(duration);
     stats_.average_gc_time = stats_.total_gc_time / stats_.total_collections;
 }
 
+void GarbageCollector::record_pause(std::chrono::duration<double> pause) {
+    stats_.total_gc_time += pause;
+    stats_.pause_gc_time += pause;
+    stats_.pause_count++;
+    stats_.max_pause_time = std::max(stats_.max_pause_time, pause);
+    
+    double us = pause.count() * 1e6;
+    size_t bucket = us < 1.0 ? 0 : std::min(PAUSE_BUCKETS - 1, static_cast<size_t>(4.0 * std::log2(us)));
+    pause_histogram_[bucket]++;
+    
+    // Nearest rank, reported as the bucket's upper bound
+    uint64_t rank = (stats_.pause_count * 99 + 99) / 100;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < PAUSE_BUCKETS; ++i) {
+        seen += pause_histogram_[i];
+        if (seen >= rank) {
+            std::chrono::duration<double> bound(std::exp2((i + 1) / 4.0) * 1e-6);
+            stats_.p99_pause_time = std::min(bound, stats_.max_pause_time);
+            break;
+        }
+    }
+}
+
+bool GarbageCollector::is_live(Object* obj) const {
+    // Liveness is reachability. Marking sets the mark bit on every object it
+    // reaches, managed or not, so an object from new or a native factory that
+    // nothing reaches is dead to weak references, though it is never freed
+    return obj->is_gc_marked();
+}
+
+void GarbageCollector::gather_weak_containers() {
+    for (auto& worker : mark_workers_) {
+        weak_containers_.insert(weak_containers_.end(),
+                                worker->weak_containers.begin(), worker->weak_containers.end());
+        worker->weak_containers.clear();
+    }
+}
+
+bool GarbageCollector::trace_ephemerons() {
+    gather_weak_containers();
+    
+    // An ephemeron value is traced only once its key is known to be live.
+    // Tracing can make more keys live, so the caller repeats this pass until
+    // it greys nothing new.
+    MarkingVisitor visitor(*this, *mark_workers_[0]);
+    std::function<bool(Object*)> live = [this](Object* obj) { return is_live(obj); };
+    for (Object* container : weak_containers_) {
+        container->trace_ephemerons(visitor, live);
+    }
+    return has_pending_work();
+}
+
 void GarbageCollector::cleanup_weak_references() {
-    auto it = weak_references_.begin();
-    while (it != weak_references_.end()) {
-        auto* managed = find_managed_object(*it);
-        if (!managed || !managed->is_marked) {
-            it = weak_references_.erase(it);
-        } else {
-            ++it;
+    gather_weak_containers();
+    
+    // Marking is complete, so every container sees the same final liveness;
+    // dead entries are dropped before the sweep can reuse their addresses
+    std::function<bool(Object*)> live = [this](Object* obj) { return is_live(obj); };
+    for (Object* container : weak_containers_) {
+        container->clear_dead_references(live);
+    }
+    weak_containers_.clear();
+}
+
+void GarbageCollector::flatten_pinning_slices() {
+    // Runs after marking on the collecting thread: workers only recorded the
+    // slices, since a string reachable from several objects is seen repeatedly
+    for (auto& worker : mark_workers_) {
+        for (String* slice : worker->pinning_slices) {
+            if (!slice->is_sliced()) continue;
+            slice->flatten();
+            stats_.flattened_slices++;
         }
+        worker->pinning_slices.clear();
     }
 }
 
 void GarbageCollector::gc_thread_main() {
-    while (!stop_gc_thread_) {
-        if (ultra_fast_gc_) {
-            // High-performance - microsecond-level checking
-            std::this_thread::sleep_for(std::chrono::microseconds(100)); // 0.1ms ultra-fast checking
-            
-            if (should_trigger_gc()) {
-                if (parallel_collection_) {
-                    // Parallel collection for high performance
-                    if (collection_cycles_ % 5 == 0) {
-                        // Launch parallel full collection every 5th cycle
-                        std::thread([this]() { collect_old_generation_parallel(); }).detach();
-                    } else {
-                        // Ultra-fast parallel young generation
-                        std::thread([this]() { collect_young_generation_parallel(); }).detach();
-                    }
-                } else {
-                    // Ultra-fast single-threaded collection
-                    if (collection_cycles_ % 8 == 0) {
-                        collect_old_generation_ultra_fast();
-                    } else {
-                        collect_young_generation_ultra_fast();
-                    }
-                }
-                collection_cycles_++;
-            }
+    init_gc_thread();
+    std::unique_lock<std::mutex> lock(background_mutex_);
+    
+    while (true) {
+        background_cv_.wait(lock, [this]() { return stop_gc_thread_ || has_background_work(); });
+        if (stop_gc_thread_) return;
+        
+        // Both jobs touch the heap, so they run only while the mutator is
+        // blocked, in short units so reclaim_heap() never waits long
+        background_busy_ = true;
+        if (incremental_marking_ && !collection_requested_) {
+            lock.unlock();
             
-            // Ultra-aggressive memory pressure relief
-            if (get_heap_size() > heap_size_limit_ * 0.7) { // Earlier trigger for SPEED
-                force_ultra_fast_collection();
+            auto start = std::chrono::high_resolution_clock::now();
+            bool done = drain_mark_stack_until(start + BACKGROUND_SLICE);
+            auto elapsed = std::chrono::high_resolution_clock::now() - start;
+            {
+                std::lock_guard<std::mutex> gc_lock(gc_mutex_);
+                if (done) collection_requested_ = true;
+                stats_.total_gc_time += elapsed;
+                stats_.background_gc_time += elapsed;
             }
             
+            lock.lock();
         } else {
-            // Standard fast checking
-            std::this_thread::sleep_for(std::chrono::milliseconds(20)); // 20ms fast checking
-            
-            if (should_trigger_gc()) {
-                // Standard adaptive collection strategy
-                if (collection_cycles_ % 10 == 0) {
-                    collect_old_generation();
-                } else {
-                    collect_young_generation();
-                }
-                collection_cycles_++;
-            }
-            
-            // Standard memory pressure relief
-            if (get_heap_size() > heap_size_limit_ * 0.9) {
-                force_full_collection();
-            }
+            lock.unlock();
+            sweep_page_lazily(true);
+            lock.lock();
         }
+        background_busy_ = false;
+        background_cv_.notify_all();
+    }
+}
+
+bool GarbageCollector::has_background_work() const {
+    return heap_lent_ && ((incremental_marking_ && !collection_requested_) ||
+                          unswept_page_count_.load(std::memory_order_relaxed) != 0);
+}
+
+void GarbageCollector::lend_heap() {
+    {
+        std::lock_guard<std::mutex> lock(background_mutex_);
+        heap_lent_ = true;
     }
+    background_cv_.notify_all();
+}
+
+void GarbageCollector::reclaim_heap() {
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        std::unique_lock<std::mutex> lock(background_mutex_);
+        heap_lent_ = false;
+        background_cv_.wait(lock, [this]() { return !background_busy_; });
+    }
+    
+    // Waiting for the background slice or page to finish is mutator pause time
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+    std::lock_guard<std::mutex> lock(gc_mutex_);
+    record_pause(elapsed);
+}
+
+void GarbageCollector::idle(std::chrono::microseconds duration) {
+    auto deadline = std::chrono::high_resolution_clock::now() + duration;
+    
+    bool background_work = incremental_marking_ || unswept_page_count_.load(std::memory_order_relaxed) != 0;
+    if (collection_mode_ == CollectionMode::Background && gc_thread_.joinable() && background_work) {
+        lend_heap();
+        std::this_thread::sleep_until(deadline);
+        reclaim_heap();
+        return;
+    }
+    
+    if (incremental_marking_) {
+        incremental_step(duration);
+    } else {
+        while (std::chrono::high_resolution_clock::now() < deadline && sweep_page_lazily(false)) {
+        }
+    }
+    std::this_thread::sleep_until(deadline);
 }
 
 //=============================================================================
@@ -726,11 +1238,12 @@ void GarbageCollector::collect_young_generation_ultra_fast() {
     mark_objects_ultra_fast();
     
     // Lightning-fast sweep of young generation only
-    sweep_generation_ultra_fast(young_generation_);
+    sweep_generation(young_generation_, 2);
     
     // Rapid object promotion
     promote_objects_ultra_fast();
     
+    clear_marks();
     gc_running_ = false;
     update_statistics(start);
 }
@@ -747,8 +1260,9 @@ void GarbageCollector::collect_old_generation_ultra_fast() {
     mark_objects_ultra_fast();
     
     // Lightning-fast old generation sweep
-    sweep_generation_ultra_fast(old_generation_);
+    sweep_generation(old_generation_, 2);
     
+    clear_marks();
     gc_running_ = false;
     update_statistics(start);
 }
@@ -769,6 +1283,8 @@ void GarbageCollector::force_ultra_fast_collection() {
     detect_cycles_ultra_fast();
     break_cycles_ultra_fast();
     
+    clear_marks();
+    collection_requested_ = false;
     gc_running_ = false;
     update_statistics(start);
 }
@@ -781,39 +1297,14 @@ void GarbageCollector::collect_young_generation_parallel() {
     
     std::unique_lock<std::mutex> lock(gc_mutex_);
     
-    // Parallel young generation collection for high performance
-    std::vector<std::thread> threads;
-    const size_t thread_count = std::min(4u, std::thread::hardware_concurrency());
-    
-    // Parallel marking phase
-    std::atomic<bool> marking_complete{false};
-    for (size_t i = 0; i < thread_count; ++i) {
-        threads.emplace_back([this]() {
-            mark_objects_parallel_worker();
-        });
-    }
-    
-    // Wait for marking to complete
-    for (auto& thread : threads) {
-        if (thread.joinable()) thread.join();
-    }
-    threads.clear();
-    
-    // Parallel sweep phase
-    for (size_t i = 0; i < thread_count; ++i) {
-        threads.emplace_back([this, thread_count, i]() {
-            sweep_generation_parallel_worker(young_generation_, i, thread_count);
-        });
-    }
-    
-    // Wait for sweeping to complete
-    for (auto& thread : threads) {
-        if (thread.joinable()) thread.join();
-    }
+    // Marking and sweeping fan out to the persistent worker pool on large heaps
+    mark_objects();
+    sweep_generation(young_generation_, 2);
     
     // Single-threaded promotion
     promote_objects_ultra_fast();
     
+    clear_marks();
     gc_running_ = false;
     update_statistics(start);
 }
@@ -826,116 +1317,37 @@ void GarbageCollector::collect_old_generation_parallel() {
     
     std::unique_lock<std::mutex> lock(gc_mutex_);
     
-    // PARALLEL old generation collection
-    std::vector<std::thread> threads;
-    const size_t thread_count = std::min(4u, std::thread::hardware_concurrency());
-    
-    // Parallel full marking
-    for (size_t i = 0; i < thread_count; ++i) {
-        threads.emplace_back([this]() {
-            mark_objects_parallel_worker();
-        });
-    }
-    
-    for (auto& thread : threads) {
-        if (thread.joinable()) thread.join();
-    }
-    threads.clear();
-    
-    // Parallel old generation sweep
-    for (size_t i = 0; i < thread_count; ++i) {
-        threads.emplace_back([this, thread_count, i]() {
-            sweep_generation_parallel_worker(old_generation_, i, thread_count);
-        });
-    }
-    
-    for (auto& thread : threads) {
-        if (thread.joinable()) thread.join();
-    }
+    // Marking and sweeping fan out to the persistent worker pool on large heaps
+    mark_objects();
+    sweep_generation(old_generation_, 2);
     
+    clear_marks();
     gc_running_ = false;
     update_statistics(start);
 }
 
 // Ultra-fast helper methods
 void GarbageCollector::mark_objects_ultra_fast() {
-    // optimized marking - minimal overhead
-    for (auto* managed : managed_objects_) {
-        managed->is_marked = false; // Clear marks ultra-fast
-    }
-    
-    // Ultra-fast root marking
-    for (Object* obj : root_objects_) {
-        mark_object_ultra_fast(obj);
-    }
-    
-    // Lightning-fast context marking
-    for (Context* ctx : root_contexts_) {
-        if (ctx->get_global_object()) {
-            mark_object_ultra_fast(ctx->get_global_object());
-        }
-    }
-}
-
-void GarbageCollector::mark_object_ultra_fast(Object* obj) {
-    if (!obj) return;
-    
-    auto* managed = find_managed_object_ultra_fast(obj);
-    if (managed && !managed->is_marked) {
-        managed->is_marked = true;
-        managed->access_count += 2; // Bonus for ultra-fast marking
-        
-        // Simplified recursive marking for performance
-        std::vector<std::string> keys = obj->get_enumerable_keys();
-        for (const std::string& key : keys) {
-            Value prop = obj->get_property(key);
-            if (prop.is_object()) {
-                mark_object_ultra_fast(prop.as_object());
-            }
-        }
-    }
-}
-
-void GarbageCollector::sweep_generation_ultra_fast(std::vector<ManagedObject*>& generation) {
-    // High-performance sweep with minimal overhead
-    auto it = generation.begin();
-    while (it != generation.end()) {
-        auto* managed = *it;
-        if (!managed->is_marked) {
-            // Lightning-fast cleanup
-            managed_objects_.erase(managed);
-            stats_.total_deallocations++;
-            stats_.bytes_freed += managed->size;
-            
-            delete managed->object;
-            delete managed;
-            it = generation.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    // Same precise worklist marker; kept as the entry point of the fast paths
+    mark_objects();
 }
 
 void GarbageCollector::sweep_objects_ultra_fast() {
     // High-performance sweep of all generations
-    sweep_generation_ultra_fast(young_generation_);
-    sweep_generation_ultra_fast(old_generation_);
+    sweep_generation(young_generation_, 2);
+    sweep_generation(old_generation_, 2);
     // Skip permanent generation for SPEED
 }
 
 void GarbageCollector::promote_objects_ultra_fast() {
     // optimized object promotion
-    auto it = young_generation_.begin();
-    while (it != young_generation_.end()) {
-        auto* managed = *it;
-        if (managed->access_count > 2) { // Lower threshold for SPEED
-            managed->generation = Generation::Old;
-            old_generation_.push_back(managed);
-            it = young_generation_.erase(it);
-        } else {
-            ++it;
-        }
+    auto promoted = std::stable_partition(young_generation_.begin(), young_generation_.end(),
+        [](const ManagedObject* managed) { return managed->access_count <= 2; }); // Lower threshold for SPEED
+    for (auto it = promoted; it != young_generation_.end(); ++it) {
+        (*it)->generation = Generation::Old;
+        old_generation_.push_back(*it);
     }
+    young_generation_.erase(promoted, young_generation_.end());
 }
 
 void GarbageCollector::detect_cycles_ultra_fast() {
@@ -948,38 +1360,6 @@ void GarbageCollector::break_cycles_ultra_fast() {
     // Skip complex cleanup for SPEED
 }
 
-GarbageCollector::ManagedObject* GarbageCollector::find_managed_object_ultra_fast(Object* obj) {
-    // High-performance object lookup with minimal overhead
-    for (auto* managed : managed_objects_) {
-        if (managed->object == obj) {
-            return managed;
-        }
-    }
-    return nullptr;
-}
-
-// Parallel worker methods
-void GarbageCollector::mark_objects_parallel_worker() {
-    // Parallel marking worker - each thread handles a subset
-    // Implementation would distribute work across threads
-    mark_objects_ultra_fast(); // Simplified for now
-}
-
-void GarbageCollector::sweep_generation_parallel_worker(std::vector<ManagedObject*>& generation, 
-                                                       size_t thread_id, size_t thread_count) {
-    // Parallel sweep worker - each thread handles its partition
-    size_t start_idx = (generation.size() * thread_id) / thread_count;
-    size_t end_idx = (generation.size() * (thread_id + 1)) / thread_count;
-    
-    for (size_t i = start_idx; i < end_idx && i < generation.size(); ++i) {
-        auto* managed = generation[i];
-        if (!managed->is_marked) {
-            // Mark for deletion (actual deletion happens in main thread)
-            managed->is_marked = false; // Use as deletion flag
-        }
-    }
-}
-
 //=============================================================================
 // Heavy Operation Optimization Methods
 //=============================================================================
@@ -1031,7 +1411,8 @@ void GarbageCollector::emergency_cleanup() {
     while (it != young_generation_.end()) {
         auto* managed = *it;
         if (managed->access_count < 2) {  // Very aggressive threshold
-            managed_objects_.erase(managed);
+            managed_objects_.erase(managed->object);
+            heap_bytes_ -= managed->size;
             delete managed->object;
             delete managed;
             it = young_generation_.erase(it);
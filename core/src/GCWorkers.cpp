@@ -0,0 +1,93 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "../include/GCWorkers.h"
+#include <algorithm>
+
+namespace Quanta {
+
+//=============================================================================
+// GCWorkerPool Implementation
+//=============================================================================
+
+GCWorkerPool::GCWorkerPool(size_t worker_count, ThreadInit thread_init)
+    : worker_count_(std::max<size_t>(1, worker_count)), thread_init_(std::move(thread_init)), task_(nullptr),
+      generation_(0), pending_(0), stopping_(false) {
+    threads_.reserve(worker_count_ - 1);
+    for (size_t id = 1; id < worker_count_; ++id) {
+        threads_.emplace_back(&GCWorkerPool::worker_main, this, id);
+    }
+}
+
+GCWorkerPool::~GCWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    start_cv_.notify_all();
+
+    for (auto& thread : threads_) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+void GCWorkerPool::run(const Task& task) {
+    if (worker_count_ == 1) {
+        task(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        pending_ = worker_count_ - 1;
+        generation_++;
+    }
+    start_cv_.notify_all();
+
+    task(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() { return pending_ == 0; });
+    task_ = nullptr;
+}
+
+size_t GCWorkerPool::default_worker_count() {
+    unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : hardware;
+}
+
+void GCWorkerPool::worker_main(size_t worker_id) {
+    uint64_t seen_generation = 0;
+    
+    if (thread_init_) {
+        thread_init_();
+    }
+
+    while (true) {
+        const Task* task = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [this, seen_generation]() {
+                return stopping_ || generation_ != seen_generation;
+            });
+            if (stopping_) return;
+            seen_generation = generation_;
+            task = task_;
+        }
+
+        (*task)(worker_id);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pending_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+}
+
+} // namespace Quanta
@@ -118,6 +118,15 @@ void Generator::complete_generator(const Value& value) {
     last_value_ = value;
 }
 
+void Generator::visit_references(GCVisitor& visitor) const {
+    Object::visit_references(visitor);
+    visitor.visit(generator_function_);
+    for (const Value& value : yield_stack_) {
+        visitor.visit(value);
+    }
+    visitor.visit(last_value_);
+}
+
 // Generator built-in methods
 Value Generator::generator_next(Context& ctx, const std::vector<Value>& args) {
     Object* this_obj = ctx.get_this_binding();
@@ -213,15 +222,12 @@ void Generator::setup_generator_prototype(Context& ctx) {
     gen_prototype->set_property("throw", Value(throw_fn.release()));
     
     // Add Symbol.iterator method (generators are iterable)
-    Symbol* iterator_symbol = Symbol::get_well_known(Symbol::ITERATOR);
-    if (iterator_symbol) {
-        auto iterator_fn = ObjectFactory::create_native_function("@@iterator", 
-            [](Context& ctx, const std::vector<Value>& args) -> Value {
-                (void)args; // Unused parameter
-                return ctx.get_binding("this");
-            });
-        gen_prototype->set_property(iterator_symbol->to_string(), Value(iterator_fn.release()));
-    }
+    auto iterator_fn = ObjectFactory::create_native_function("@@iterator", 
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            (void)args; // Unused parameter
+            return ctx.get_binding("this");
+        });
+    gen_prototype->set_property(Symbol::well_known_key(WellKnownSymbol::Iterator), Value(iterator_fn.release()));
     
     ctx.create_binding("GeneratorPrototype", Value(gen_prototype.release()));
 }
@@ -0,0 +1,298 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "../include/HeapArena.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Quanta {
+
+thread_local HeapArena* HeapArena::current_ = nullptr;
+std::atomic<std::atomic<uint64_t>*> HeapArena::chunk_map_[HeapArena::ROOT_SIZE];
+
+//=============================================================================
+// Topology (read from sysfs; no libnuma dependency)
+//=============================================================================
+
+namespace {
+
+struct NodeTopology {
+    std::vector<std::vector<uint32_t>> node_cpus;
+
+    NodeTopology() {
+#ifdef __linux__
+        for (uint32_t node = 0;; ++node) {
+            std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!cpulist.is_open()) break;
+            std::string list;
+            std::getline(cpulist, list);
+            node_cpus.push_back(parse_cpu_list(list));
+        }
+#endif
+        if (node_cpus.empty()) {
+            node_cpus.emplace_back();
+        }
+    }
+
+    // "0-3,8-11" -> {0, 1, 2, 3, 8, 9, 10, 11}
+    static std::vector<uint32_t> parse_cpu_list(const std::string& list) {
+        std::vector<uint32_t> cpus;
+        std::stringstream ranges(list);
+        std::string range;
+        while (std::getline(ranges, range, ',')) {
+            if (range.empty()) continue;
+            size_t dash = range.find('-');
+            uint32_t first = static_cast<uint32_t>(std::stoul(range.substr(0, dash)));
+            uint32_t last = dash == std::string::npos ? first : static_cast<uint32_t>(std::stoul(range.substr(dash + 1)));
+            for (uint32_t cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+
+    static const NodeTopology& instance() {
+        static NodeTopology topology;
+        return topology;
+    }
+};
+
+#ifdef __linux__
+// Memory policy modes from <linux/mempolicy.h>
+constexpr int MPOL_PREFERRED_MODE = 1;
+constexpr int MPOL_INTERLEAVE_MODE = 3;
+#endif
+
+} // anonymous namespace
+
+uint32_t HeapArena::node_count() {
+    return static_cast<uint32_t>(NodeTopology::instance().node_cpus.size());
+}
+
+uint32_t HeapArena::current_node() {
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 && node < node_count()) {
+        return node;
+    }
+#endif
+    return 0;
+}
+
+bool HeapArena::pin_current_thread(uint32_t node) {
+#ifdef __linux__
+    const auto& topology = NodeTopology::instance();
+    if (node >= topology.node_cpus.size() || topology.node_cpus[node].empty()) {
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (uint32_t cpu : topology.node_cpus[node]) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+//=============================================================================
+// Arena selection
+//=============================================================================
+
+HeapArena& HeapArena::for_node(uint32_t node) {
+    static std::vector<HeapArena*>* arenas = []() {
+        auto* created = new std::vector<HeapArena*>();
+        for (uint32_t n = 0; n < node_count(); ++n) {
+            created->push_back(new HeapArena(Placement::Local, n));
+        }
+        return created;
+    }();
+    return *(*arenas)[node < arenas->size() ? node : 0];
+}
+
+HeapArena& HeapArena::interleaved() {
+    static HeapArena* arena = new HeapArena(Placement::Interleaved, ANY_NODE);
+    return *arena;
+}
+
+namespace {
+
+std::mutex local_arenas_mutex;
+std::vector<HeapArena*> local_arenas;
+
+} // anonymous namespace
+
+HeapArena& HeapArena::create_local(uint32_t node) {
+    auto* arena = new HeapArena(Placement::Local, node < node_count() ? node : 0);
+    std::lock_guard<std::mutex> lock(local_arenas_mutex);
+    local_arenas.push_back(arena);
+    return *arena;
+}
+
+std::vector<size_t> HeapArena::node_allocated_bytes() {
+    std::vector<size_t> bytes;
+    for (uint32_t node = 0; node < node_count(); ++node) {
+        bytes.push_back(for_node(node).get_allocated_bytes());
+    }
+    std::lock_guard<std::mutex> lock(local_arenas_mutex);
+    for (HeapArena* arena : local_arenas) {
+        bytes[arena->get_node()] += arena->get_allocated_bytes();
+    }
+    return bytes;
+}
+
+std::vector<size_t> HeapArena::node_reserved_bytes() {
+    std::vector<size_t> bytes;
+    for (uint32_t node = 0; node < node_count(); ++node) {
+        bytes.push_back(for_node(node).get_reserved_bytes());
+    }
+    std::lock_guard<std::mutex> lock(local_arenas_mutex);
+    for (HeapArena* arena : local_arenas) {
+        bytes[arena->get_node()] += arena->get_reserved_bytes();
+    }
+    return bytes;
+}
+
+//=============================================================================
+// HeapArena Implementation
+//=============================================================================
+
+HeapArena::HeapArena(Placement placement, uint32_t node)
+    : placement_(placement), node_(node), bump_(nullptr), bump_end_(nullptr),
+      allocated_bytes_(0), reserved_bytes_(0) {
+    std::memset(free_lists_, 0, sizeof(free_lists_));
+}
+
+void HeapArena::free_to_owner(void* ptr, size_t size) {
+    // Chunks are CHUNK_SIZE-aligned, so the owning arena is found from the address
+    auto* header = reinterpret_cast<ChunkHeader*>(reinterpret_cast<uintptr_t>(ptr) & ~(CHUNK_SIZE - 1));
+    header->arena->free_small(ptr, size_class_of(size));
+}
+
+void HeapArena::register_chunk(void* chunk) {
+    uintptr_t index = reinterpret_cast<uintptr_t>(chunk) >> CHUNK_SHIFT;
+    auto& slot = chunk_map_[index >> LEAF_BITS];
+
+    std::atomic<uint64_t>* leaf = slot.load(std::memory_order_acquire);
+    if (!leaf) {
+        auto* fresh = new std::atomic<uint64_t>[LEAF_WORDS]();
+        if (slot.compare_exchange_strong(leaf, fresh, std::memory_order_acq_rel)) {
+            leaf = fresh;
+        } else {
+            delete[] fresh;
+        }
+    }
+
+    size_t bit = index & ((size_t(1) << LEAF_BITS) - 1);
+    leaf[bit / 64].fetch_or(uint64_t(1) << (bit % 64), std::memory_order_release);
+}
+
+void* HeapArena::allocate_small(size_t size_class) {
+    size_t block_size = (size_class + 1) * GRANULE;
+
+    lock();
+    FreeBlock* block = free_lists_[size_class];
+    if (block) {
+        free_lists_[size_class] = block->next;
+    } else {
+        if (static_cast<size_t>(bump_end_ - bump_) < block_size && !refill()) {
+            unlock();
+            throw std::bad_alloc();
+        }
+        block = reinterpret_cast<FreeBlock*>(bump_);
+        bump_ += block_size;
+    }
+    unlock();
+
+    allocated_bytes_.fetch_add(block_size, std::memory_order_relaxed);
+    return block;
+}
+
+void HeapArena::free_small(void* ptr, size_t size_class) {
+    size_t block_size = (size_class + 1) * GRANULE;
+    auto* block = static_cast<FreeBlock*>(ptr);
+
+    lock();
+    block->next = free_lists_[size_class];
+    free_lists_[size_class] = block;
+    unlock();
+
+    allocated_bytes_.fetch_sub(block_size, std::memory_order_relaxed);
+}
+
+bool HeapArena::refill() {
+    // The tail of the previous chunk is abandoned; it is smaller than one block
+    void* chunk = map_chunk();
+    if (!chunk) return false;
+
+    static_cast<ChunkHeader*>(chunk)->arena = this;
+    register_chunk(chunk);
+    chunks_.push_back(chunk);
+    bump_ = static_cast<char*>(chunk) + CHUNK_HEADER_SIZE;
+    bump_end_ = static_cast<char*>(chunk) + CHUNK_SIZE;
+    reserved_bytes_.fetch_add(CHUNK_SIZE, std::memory_order_relaxed);
+    return true;
+}
+
+void* HeapArena::map_chunk() {
+#ifdef __linux__
+    // Over-map and trim so the chunk is CHUNK_SIZE-aligned
+    void* raw = mmap(nullptr, CHUNK_SIZE * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return nullptr;
+
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (start + CHUNK_SIZE - 1) & ~(CHUNK_SIZE - 1);
+    if (aligned > start) {
+        munmap(raw, aligned - start);
+    }
+    size_t tail = start + CHUNK_SIZE * 2 - (aligned + CHUNK_SIZE);
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + CHUNK_SIZE), tail);
+    }
+    void* chunk = reinterpret_cast<void*>(aligned);
+
+    // The policy applies to pages faulted in later, so it is set before first touch.
+    // Failure (no NUMA support, more than 64 nodes) leaves first-touch placement.
+    uint32_t nodes = node_count();
+    if (nodes > 1 && nodes <= 64) {
+        unsigned long mask = 0;
+        int mode = MPOL_PREFERRED_MODE;
+        if (placement_ == Placement::Local) {
+            mask = 1UL << node_;
+        } else {
+            mask = nodes == 64 ? ~0UL : (1UL << nodes) - 1;
+            mode = MPOL_INTERLEAVE_MODE;
+        }
+        syscall(SYS_mbind, chunk, CHUNK_SIZE, mode, &mask, sizeof(mask) * 8 + 1, 0);
+    }
+    return chunk;
+#else
+    // No placement control here; keep the over-allocation so the chunk can be aligned
+    void* raw = std::malloc(CHUNK_SIZE * 2);
+    if (!raw) return nullptr;
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + CHUNK_SIZE - 1) & ~(CHUNK_SIZE - 1);
+    return reinterpret_cast<void*>(aligned);
+#endif
+}
+
+} // namespace Quanta
@@ -0,0 +1,59 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "../include/Isolate.h"
+#include "../include/String.h"
+
+namespace Quanta {
+
+thread_local Isolate* Isolate::current_ = nullptr;
+
+//=============================================================================
+// Isolate Implementation
+//=============================================================================
+
+Isolate::Isolate() : random_engine_(std::random_device{}()), next_timer_id_(1), arena_(nullptr) {
+}
+
+Isolate& Isolate::current() {
+    if (current_) {
+        return *current_;
+    }
+    // Never shared between threads, so stray native calls cannot race
+    static thread_local Isolate default_isolate;
+    return default_isolate;
+}
+
+String* Isolate::intern_literal(const std::string& text) {
+    auto it = literal_strings_.find(text);
+    if (it != literal_strings_.end()) return it->second;
+    String* cell = new String(text);
+    literal_strings_.emplace(text, cell);
+    return cell;
+}
+
+void Isolate::reset() {
+    event_loop_.clear();
+    call_stack_.clear();
+}
+
+//=============================================================================
+// Isolate::Scope Implementation
+//=============================================================================
+
+Isolate::Scope::Scope(Isolate* isolate) : previous_(current_), previous_arena_(HeapArena::current()) {
+    current_ = isolate;
+    if (isolate && isolate->arena_) {
+        HeapArena::bind_current_thread(isolate->arena_);
+    }
+}
+
+Isolate::Scope::~Scope() {
+    current_ = previous_;
+    HeapArena::bind_current_thread(previous_arena_);
+}
+
+} // namespace Quanta
@@ -0,0 +1,206 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "../include/IsolatePool.h"
+#include "../include/Isolate.h"
+#include "../include/GCWorkers.h"
+#include <algorithm>
+
+namespace Quanta {
+
+//=============================================================================
+// IsolatePool Implementation
+//=============================================================================
+
+IsolatePool::IsolatePool(const Config& config)
+    : config_(config), queue_(config.queue_capacity), sleepers_(0), stopping_(false),
+      ready_workers_(0), pending_(0), submitted_(0), completed_(0), failed_(0), recycled_(0), parks_(0) {
+    if (config_.engine.gc_worker_threads == 0) {
+        config_.engine.gc_worker_threads = 1;
+    }
+
+    size_t count = config_.isolates ? config_.isolates : GCWorkerPool::default_worker_count();
+    uint32_t nodes = HeapArena::node_count();
+    workers_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto worker = std::make_unique<Worker>();
+        if (config_.spread_across_nodes) {
+            worker->home_node = static_cast<uint32_t>(i % nodes);
+        }
+        workers_.push_back(std::move(worker));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        workers_[i]->thread = std::thread(&IsolatePool::worker_main, this, workers_[i].get());
+    }
+
+    // Engines are built and initialized up front so the first tasks run warm
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    state_cv_.wait(lock, [this]() { return ready_workers_ == workers_.size(); });
+}
+
+IsolatePool::~IsolatePool() {
+    shutdown();
+}
+
+void IsolatePool::shutdown() {
+    if (stopping_.exchange(true)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(park_mutex_);
+    }
+    work_cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+}
+
+bool IsolatePool::try_submit(Task task) {
+    if (stopping_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // Counted first so wait_idle() never sees a task that is queued but not pending
+    pending_.fetch_add(1, std::memory_order_acq_rel);
+    if (!queue_.try_push(std::move(task))) {
+        pending_.fetch_sub(1, std::memory_order_acq_rel);
+        return false;
+    }
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    wake_worker();
+    return true;
+}
+
+void IsolatePool::submit(Task task) {
+    // try_push leaves the task alone when the queue is full
+    while (!try_submit(task)) {
+        if (stopping_.load(std::memory_order_relaxed)) return;
+        std::this_thread::yield();
+    }
+}
+
+std::future<Engine::Result> IsolatePool::execute(const std::string& source, const std::string& filename) {
+    auto promise = std::make_shared<std::promise<Engine::Result>>();
+    std::future<Engine::Result> result = promise->get_future();
+    submit([promise, source, filename](Engine& engine) {
+        promise->set_value(engine.execute(source, filename));
+    });
+    return result;
+}
+
+void IsolatePool::wait_idle() {
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    state_cv_.wait(lock, [this]() { return pending_.load(std::memory_order_acquire) == 0; });
+}
+
+IsolatePool::Statistics IsolatePool::get_statistics() const {
+    Statistics stats;
+    stats.submitted = submitted_.load(std::memory_order_relaxed);
+    stats.completed = completed_.load(std::memory_order_relaxed);
+    stats.failed = failed_.load(std::memory_order_relaxed);
+    stats.recycled = recycled_.load(std::memory_order_relaxed);
+    stats.parks = parks_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void IsolatePool::wake_worker() {
+    // Pairs with the fence in next_task(): either the worker sees the task
+    // before parking or this thread sees the sleeper
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) != 0) {
+        std::lock_guard<std::mutex> lock(park_mutex_);
+        work_cv_.notify_one();
+    }
+}
+
+bool IsolatePool::next_task(Task& task) {
+    while (true) {
+        for (int spin = 0; spin < SPIN_ITERATIONS; ++spin) {
+            if (queue_.try_pop(task)) return true;
+            if (spin >= SPIN_ITERATIONS / 2) std::this_thread::yield();
+        }
+
+        std::unique_lock<std::mutex> lock(park_mutex_);
+        sleepers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (queue_.empty() && !stopping_.load(std::memory_order_relaxed)) {
+            parks_.fetch_add(1, std::memory_order_relaxed);
+            work_cv_.wait(lock);
+        }
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+
+        // Queued work is finished before a stopping worker exits
+        if (queue_.empty() && stopping_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+    }
+}
+
+std::unique_ptr<Engine> IsolatePool::create_engine(Worker* worker) {
+    Engine::Config engine_config = config_.engine;
+    if (worker->home_node != HeapArena::ANY_NODE) {
+        engine_config.numa_node = static_cast<int32_t>(worker->home_node);
+        engine_config.numa_arenas = true;
+        engine_config.pin_threads = true;
+    }
+
+    auto engine = std::make_unique<Engine>(engine_config);
+
+    // A private arena keeps isolates on the same node off each other's lock
+    if (engine_config.numa_arenas) {
+        if (!worker->arena) {
+            worker->arena = &HeapArena::create_local(engine->get_home_node());
+        }
+        engine->get_isolate()->set_arena(worker->arena);
+    }
+
+    engine->initialize();
+    return engine;
+}
+
+void IsolatePool::worker_main(Worker* worker) {
+    std::unique_ptr<Engine> engine = create_engine(worker);
+
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        ready_workers_++;
+    }
+    state_cv_.notify_all();
+
+    Task task;
+    while (next_task(task)) {
+        {
+            Isolate::Scope isolate_scope(engine->get_isolate());
+            try {
+                task(*engine);
+            } catch (...) {
+                failed_.fetch_add(1, std::memory_order_relaxed);
+            }
+            task = nullptr;
+
+            if (config_.reset_between_tasks) {
+                engine->reset();
+            }
+        }
+
+        // Reset keeps changes to built-ins; a fresh engine drops them too
+        worker->tasks_run++;
+        if (config_.recycle_after != 0 && worker->tasks_run % config_.recycle_after == 0) {
+            engine = nullptr;
+            engine = create_engine(worker);
+            recycled_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        completed_.fetch_add(1, std::memory_order_relaxed);
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            state_cv_.notify_all();
+        }
+    }
+}
+
+} // namespace Quanta
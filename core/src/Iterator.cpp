@@ -140,15 +140,12 @@ void Iterator::setup_iterator_prototype(Context& ctx) {
     iterator_prototype->set_property("throw", Value(throw_fn.release()));
     
     // Add Symbol.iterator method (iterators are iterable)
-    Symbol* iterator_symbol = Symbol::get_well_known(Symbol::ITERATOR);
-    if (iterator_symbol) {
-        auto self_iterator_fn = ObjectFactory::create_native_function("@@iterator", 
-            [](Context& ctx, const std::vector<Value>& args) -> Value {
-                (void)args; // Unused parameter
-                return ctx.get_binding("this");
-            });
-        iterator_prototype->set_property(iterator_symbol->to_string(), Value(self_iterator_fn.release()));
-    }
+    auto self_iterator_fn = ObjectFactory::create_native_function("@@iterator", 
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            (void)args; // Unused parameter
+            return ctx.get_binding("this");
+        });
+    iterator_prototype->set_property(Symbol::well_known_key(WellKnownSymbol::Iterator), Value(self_iterator_fn.release()));
     
     ctx.create_binding("IteratorPrototype", Value(iterator_prototype.release()));
 }
@@ -168,6 +165,11 @@ ArrayIterator::ArrayIterator(Object* array, Kind kind)
     : Iterator([this]() { return this->next_impl(); }), array_(array), kind_(kind), index_(0) {
 }
 
+void ArrayIterator::visit_references(GCVisitor& visitor) const {
+    Object::visit_references(visitor);
+    visitor.visit(array_);
+}
+
 std::unique_ptr<ArrayIterator> ArrayIterator::create_keys_iterator(Object* array) {
     return std::make_unique<ArrayIterator>(array, Kind::Keys);
 }
@@ -264,6 +266,11 @@ MapIterator::MapIterator(Map* map, Kind kind)
     this->set_property("next", Value(next_method.release()));
 }
 
+void MapIterator::visit_references(GCVisitor& visitor) const {
+    Object::visit_references(visitor);
+    visitor.visit(map_);
+}
+
 Iterator::IteratorResult MapIterator::next() {
     return next_impl(); // Call the implementation directly
 }
@@ -331,6 +338,11 @@ SetIterator::SetIterator(Set* set, Kind kind)
     this->set_property("next", Value(next_method.release()));
 }
 
+void SetIterator::visit_references(GCVisitor& visitor) const {
+    Object::visit_references(visitor);
+    visitor.visit(set_);
+}
+
 Iterator::IteratorResult SetIterator::next() {
     return next_impl(); // Call the implementation directly
 }
@@ -403,13 +415,8 @@ bool is_iterable(const Value& value) {
     }
     
     Object* obj = value.as_object();
-    Symbol* iterator_symbol = Symbol::get_well_known(Symbol::ITERATOR);
-    
-    if (!iterator_symbol) {
-        return false;
-    }
-    
-    return obj->has_property(iterator_symbol->to_string());
+    return obj->may_have_symbol_key(Shape::ITERATOR_KEY) &&
+           obj->has_property(Symbol::well_known_key(WellKnownSymbol::Iterator));
 }
 
 std::unique_ptr<Iterator> get_iterator(const Value& value, Context& ctx) {
@@ -418,13 +425,11 @@ std::unique_ptr<Iterator> get_iterator(const Value& value, Context& ctx) {
     }
     
     Object* obj = value.as_object();
-    Symbol* iterator_symbol = Symbol::get_well_known(Symbol::ITERATOR);
-    
-    if (!iterator_symbol) {
+    if (!obj->may_have_symbol_key(Shape::ITERATOR_KEY)) {
         return nullptr;
     }
     
-    Value iterator_method = obj->get_property(iterator_symbol->to_string());
+    Value iterator_method = obj->get_property(Symbol::well_known_key(WellKnownSymbol::Iterator));
     if (!iterator_method.is_function()) {
         return nullptr;
     }
@@ -547,24 +552,21 @@ void setup_array_iterator_methods(Context& ctx) {
     array_proto->set_property("entries", Value(entries_fn.release()));
     
     // Add Symbol.iterator method (default to values)
-    Symbol* iterator_symbol = Symbol::get_well_known(Symbol::ITERATOR);
-    if (iterator_symbol) {
-        auto default_iterator_fn = ObjectFactory::create_native_function("@@iterator", 
-            [](Context& ctx, const std::vector<Value>& args) -> Value {
-                (void)args; // Unused parameter
-                Value this_value = ctx.get_binding("this");
-                if (!this_value.is_object()) {
-                    ctx.throw_exception(Value("Array.prototype[Symbol.iterator] called on non-object"));
-                    return Value();
-                }
-                
-                Object* array = this_value.as_object();
-                auto iterator = ArrayIterator::create_values_iterator(array);
-                return Value(iterator.release());
-            });
-        
-        array_proto->set_property(iterator_symbol->to_string(), Value(default_iterator_fn.release()));
-    }
+    auto default_iterator_fn = ObjectFactory::create_native_function("@@iterator", 
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            (void)args; // Unused parameter
+            Value this_value = ctx.get_binding("this");
+            if (!this_value.is_object()) {
+                ctx.throw_exception(Value("Array.prototype[Symbol.iterator] called on non-object"));
+                return Value();
+            }
+            
+            Object* array = this_value.as_object();
+            auto iterator = ArrayIterator::create_values_iterator(array);
+            return Value(iterator.release());
+        });
+    
+    array_proto->set_property(Symbol::well_known_key(WellKnownSymbol::Iterator), Value(default_iterator_fn.release()));
 }
 
 void setup_string_iterator_methods(Context& ctx) {
@@ -583,20 +585,17 @@ void setup_string_iterator_methods(Context& ctx) {
     Object* string_proto = string_prototype.as_object();
     
     // Add Symbol.iterator method
-    Symbol* iterator_symbol = Symbol::get_well_known(Symbol::ITERATOR);
-    if (iterator_symbol) {
-        auto string_iterator_fn = ObjectFactory::create_native_function("@@iterator", 
-            [](Context& ctx, const std::vector<Value>& args) -> Value {
-                (void)args; // Unused parameter
-                Value this_value = ctx.get_binding("this");
-                std::string str = this_value.to_string();
-                
-                auto iterator = std::make_unique<StringIterator>(str);
-                return Value(iterator.release());
-            });
-        
-        string_proto->set_property(iterator_symbol->to_string(), Value(string_iterator_fn.release()));
-    }
+    auto string_iterator_fn = ObjectFactory::create_native_function("@@iterator", 
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            (void)args; // Unused parameter
+            Value this_value = ctx.get_binding("this");
+            std::string str = this_value.to_string();
+            
+            auto iterator = std::make_unique<StringIterator>(str);
+            return Value(iterator.release());
+        });
+    
+    string_proto->set_property(Symbol::well_known_key(WellKnownSymbol::Iterator), Value(string_iterator_fn.release()));
 }
 
 void setup_map_iterator_methods(Context& ctx) {
@@ -8,18 +8,14 @@
 #include "Context.h"
 #include "Symbol.h"
 #include "Iterator.h"
+#include "GC.h"
+#include "Isolate.h"
 #include "../../parser/include/AST.h"
 #include <algorithm>
 #include <iostream>
 
 namespace Quanta {
 
-// Initialize static prototype references
-Object* Map::prototype_object = nullptr;
-Object* Set::prototype_object = nullptr;
-Object* WeakMap::prototype_object = nullptr;
-Object* WeakSet::prototype_object = nullptr;
-
 //=============================================================================
 // Map Implementation
 //=============================================================================
@@ -40,6 +36,8 @@ Value Map::get(const Value& key) const {
 }
 
 void Map::set(const Value& key, const Value& value) {
+    GarbageCollector::write_barrier(key);
+    GarbageCollector::write_barrier(value);
     auto it = find_entry(key);
     if (it != entries_.end()) {
         it->value = value;
@@ -98,6 +96,14 @@ std::vector<std::pair<Value, Value>> Map::entries() const {
     return result;
 }
 
+void Map::visit_references(GCVisitor& visitor) const {
+    Object::visit_references(visitor);
+    for (const auto& entry : entries_) {
+        visitor.visit(entry.key);
+        visitor.visit(entry.value);
+    }
+}
+
 std::vector<Map::MapEntry>::iterator Map::find_entry(const Value& key) {
     return std::find_if(entries_.begin(), entries_.end(), 
         [&key](const MapEntry& entry) {
@@ -117,8 +123,8 @@ Value Map::map_constructor(Context& ctx, const std::vector<Value>& args) {
     auto map = std::make_unique<Map>();
     
     // Set up prototype chain using static reference
-    if (Map::prototype_object) {
-        map->set_prototype(Map::prototype_object);
+    if (Object* prototype = Isolate::current().prototypes().map) {
+        map->set_prototype(prototype);
     }
     
     // If iterable argument provided, populate map
@@ -206,13 +212,11 @@ Value Map::map_has(Context& ctx, const std::vector<Value>& args) {
 }
 
 Value Map::map_delete(Context& ctx, const std::vector<Value>& args) {
-    Value this_value = ctx.get_binding("this");
-    if (!this_value.is_object()) {
+    Object* obj = ctx.get_this_binding();
+    if (!obj) {
         ctx.throw_exception(Value("Map.prototype.delete called on non-object"));
         return Value();
     }
-    
-    Object* obj = this_value.as_object();
     if (obj->get_type() != Object::ObjectType::Map) {
         ctx.throw_exception(Value("Map.prototype.delete called on non-Map"));
         return Value();
@@ -227,13 +231,11 @@ Value Map::map_delete(Context& ctx, const std::vector<Value>& args) {
 Value Map::map_clear(Context& ctx, const std::vector<Value>& args) {
     (void)args; // Unused parameter
     
-    Value this_value = ctx.get_binding("this");
-    if (!this_value.is_object()) {
+    Object* obj = ctx.get_this_binding();
+    if (!obj) {
         ctx.throw_exception(Value("Map.prototype.clear called on non-object"));
         return Value();
     }
-    
-    Object* obj = this_value.as_object();
     if (obj->get_type() != Object::ObjectType::Map) {
         ctx.throw_exception(Value("Map.prototype.clear called on non-Map"));
         return Value();
@@ -302,14 +304,11 @@ void Map::setup_map_prototype(Context& ctx) {
     map_prototype->set_property("size", Value(size_fn.release()));
     
     // Add Symbol.iterator method for Map iteration
-    Symbol* iterator_symbol = Symbol::get_well_known(Symbol::ITERATOR);
-    if (iterator_symbol) {
-        auto map_iterator_fn = ObjectFactory::create_native_function("@@iterator", map_iterator_method);
-        map_prototype->set_property(iterator_symbol->to_string(), Value(map_iterator_fn.release()));
-    }
+    auto map_iterator_fn = ObjectFactory::create_native_function("@@iterator", map_iterator_method);
+    map_prototype->set_property(Symbol::well_known_key(WellKnownSymbol::Iterator), Value(map_iterator_fn.release()));
     
     // Store reference for constructor use
-    Map::prototype_object = map_prototype.get();
+    Isolate::current().prototypes().map = map_prototype.get();
     
     map_constructor_fn->set_property("prototype", Value(map_prototype.release()));
     ctx.create_binding("Map", Value(map_constructor_fn.release()));
@@ -328,6 +327,7 @@ bool Set::has(const Value& value) const {
 
 void Set::add(const Value& value) {
     if (find_value(value) == values_.end()) {
+        GarbageCollector::write_barrier(value);
         values_.push_back(value);
         size_++;
     }
@@ -368,6 +368,13 @@ std::vector<std::pair<Value, Value>> Set::entries() const {
     return result;
 }
 
+void Set::visit_references(GCVisitor& visitor) const {
+    Object::visit_references(visitor);
+    for (const auto& value : values_) {
+        visitor.visit(value);
+    }
+}
+
 std::vector<Value>::iterator Set::find_value(const Value& value) {
     return std::find_if(values_.begin(), values_.end(), 
         [&value](const Value& v) {
@@ -387,8 +394,8 @@ Value Set::set_constructor(Context& ctx, const std::vector<Value>& args) {
     auto set = std::make_unique<Set>();
     
     // Set up prototype chain using static reference
-    if (Set::prototype_object) {
-        set->set_prototype(Set::prototype_object);
+    if (Object* prototype = Isolate::current().prototypes().set) {
+        set->set_prototype(prototype);
     }
     
     // If iterable argument provided, populate set
@@ -548,14 +555,11 @@ void Set::setup_set_prototype(Context& ctx) {
     set_prototype->set_property("size", Value(size_fn.release()));
     
     // Add Symbol.iterator method for Set iteration
-    Symbol* iterator_symbol = Symbol::get_well_known(Symbol::ITERATOR);
-    if (iterator_symbol) {
-        auto set_iterator_fn = ObjectFactory::create_native_function("@@iterator", set_iterator_method);
-        set_prototype->set_property(iterator_symbol->to_string(), Value(set_iterator_fn.release()));
-    }
+    auto set_iterator_fn = ObjectFactory::create_native_function("@@iterator", set_iterator_method);
+    set_prototype->set_property(Symbol::well_known_key(WellKnownSymbol::Iterator), Value(set_iterator_fn.release()));
     
     // Store reference for constructor use
-    Set::prototype_object = set_prototype.get();
+    Isolate::current().prototypes().set = set_prototype.get();
     
     set_constructor_fn->set_property("prototype", Value(set_prototype.release()));
     ctx.create_binding("Set", Value(set_constructor_fn.release()));
@@ -581,6 +585,7 @@ Value WeakMap::get(Object* key) const {
 }
 
 void WeakMap::set(Object* key, const Value& value) {
+    GarbageCollector::write_barrier(value);
     entries_[key] = value;
 }
 
@@ -593,6 +598,29 @@ bool WeakMap::delete_key(Object* key) {
     return false;
 }
 
+void WeakMap::visit_references(GCVisitor& visitor) const {
+    Object::visit_references(visitor);
+    visitor.visit_weak_container(const_cast<WeakMap*>(this));
+}
+
+void WeakMap::trace_ephemerons(GCVisitor& visitor, const std::function<bool(Object*)>& is_live) const {
+    for (const auto& pair : entries_) {
+        if (is_live(pair.first)) {
+            visitor.visit(pair.second);
+        }
+    }
+}
+
+void WeakMap::clear_dead_references(const std::function<bool(Object*)>& is_live) {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (!is_live(it->first)) {
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 void WeakMap::setup_weakmap_prototype(Context& ctx) {
     // Create WeakMap constructor
     auto weakmap_constructor_fn = ObjectFactory::create_native_function("WeakMap", weakmap_constructor);
@@ -612,7 +640,7 @@ void WeakMap::setup_weakmap_prototype(Context& ctx) {
     weakmap_prototype->set_property("delete", Value(delete_fn.release()));
     
     // Store reference for constructor use
-    WeakMap::prototype_object = weakmap_prototype.get();
+    Isolate::current().prototypes().weak_map = weakmap_prototype.get();
     
     weakmap_constructor_fn->set_property("prototype", Value(weakmap_prototype.release()));
     ctx.create_binding("WeakMap", Value(weakmap_constructor_fn.release()));
@@ -642,6 +670,21 @@ bool WeakSet::delete_value(Object* value) {
     return false;
 }
 
+void WeakSet::visit_references(GCVisitor& visitor) const {
+    Object::visit_references(visitor);
+    visitor.visit_weak_container(const_cast<WeakSet*>(this));
+}
+
+void WeakSet::clear_dead_references(const std::function<bool(Object*)>& is_live) {
+    for (auto it = values_.begin(); it != values_.end();) {
+        if (!is_live(*it)) {
+            it = values_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 void WeakSet::setup_weakset_prototype(Context& ctx) {
     // Create WeakSet constructor
     auto weakset_constructor_fn = ObjectFactory::create_native_function("WeakSet", weakset_constructor);
@@ -659,7 +702,7 @@ void WeakSet::setup_weakset_prototype(Context& ctx) {
     weakset_prototype->set_property("delete", Value(delete_fn.release()));
     
     // Store reference for constructor use
-    WeakSet::prototype_object = weakset_prototype.get();
+    Isolate::current().prototypes().weak_set = weakset_prototype.get();
     
     weakset_constructor_fn->set_property("prototype", Value(weakset_prototype.release()));
     ctx.create_binding("WeakSet", Value(weakset_constructor_fn.release()));
@@ -671,8 +714,8 @@ Value WeakMap::weakmap_constructor(Context& ctx, const std::vector<Value>& args)
     auto weakmap = std::make_unique<WeakMap>();
     
     // Set up prototype chain using static reference
-    if (WeakMap::prototype_object) {
-        weakmap->set_prototype(WeakMap::prototype_object);
+    if (Object* prototype = Isolate::current().prototypes().weak_map) {
+        weakmap->set_prototype(prototype);
     }
     
     return Value(weakmap.release());
@@ -791,8 +834,8 @@ Value WeakSet::weakset_constructor(Context& ctx, const std::vector<Value>& args)
     auto weakset = std::make_unique<WeakSet>();
     
     // Set up prototype chain using static reference
-    if (WeakSet::prototype_object) {
-        weakset->set_prototype(WeakSet::prototype_object);
+    if (Object* prototype = Isolate::current().prototypes().weak_set) {
+        weakset->set_prototype(prototype);
     }
     
     return Value(weakset.release());
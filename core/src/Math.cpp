@@ -7,6 +7,7 @@
 #include "../include/Math.h"
 #include "../include/Context.h"
 #include "../include/Object.h"
+#include "../include/Isolate.h"
 #include <cmath>
 #include <algorithm>
 #include <random>
@@ -25,7 +26,6 @@
 namespace Quanta {
 
 // Static member initialization
-bool Math::random_initialized_ = false;
 
 //=============================================================================
 // Math Constants and Setup
@@ -217,15 +217,9 @@ Value Math::random(Context& ctx, const std::vector<Value>& args) {
     (void)ctx; // Suppress unused parameter warning
     (void)args;
     
-    if (!random_initialized_) {
-        initialize_random();
-    }
-    
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_real_distribution<double> dis(0.0, 1.0);
-    
-    return Value(dis(gen));
+    // Each isolate has its own generator, so concurrent engines never share state
+    std::uniform_real_distribution<double> dis(0.0, 1.0);
+    return Value(dis(Isolate::current().random_engine()));
 }
 
 Value Math::round(Context& ctx, const std::vector<Value>& args) {
@@ -541,8 +535,4 @@ bool Math::is_integer(double value) {
     return std::floor(value) == value;
 }
 
-void Math::initialize_random() {
-    random_initialized_ = true;
-}
-
 } // namespace Quanta
\ No newline at end of file
@@ -50,6 +50,12 @@ void Module::set_context(std::unique_ptr<Context> context) {
     module_context_ = std::move(context);
 }
 
+void Module::visit_references(GCVisitor& visitor) const {
+    for (const auto& pair : exports_) {
+        visitor.visit(pair.second);
+    }
+}
+
 // ModuleLoader implementation
 ModuleLoader::ModuleLoader(Engine* engine) : engine_(engine) {
     // Add default search paths
@@ -57,6 +63,12 @@ ModuleLoader::ModuleLoader(Engine* engine) : engine_(engine) {
     add_search_path("./node_modules/");
 }
 
+void ModuleLoader::visit_references(GCVisitor& visitor) const {
+    for (const auto& pair : modules_) {
+        pair.second->visit_references(visitor);
+    }
+}
+
 Module* ModuleLoader::load_module(const std::string& module_id, const std::string& from_path) {
     std::string resolved_path = resolve_module_path(module_id, from_path);
     std::string normalized_id = normalize_module_id(module_id, from_path);
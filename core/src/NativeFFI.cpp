@@ -7,16 +7,24 @@
 #include "../include/NativeFFI.h"
 #include "../include/Value.h"
 #include "../include/Context.h"
+#include "../include/Object.h"
+#include "../include/String.h"
+#include "../include/ArrayBuffer.h"
+#include "../include/TypedArray.h"
+#include "../include/DataView.h"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstring>
+#include <stdexcept>
 
 #ifdef _WIN32
 #include <windows.h>
 #else
 #include <dlfcn.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #endif
@@ -99,6 +107,7 @@ std::string FFITypeInfo::to_string() const {
         case FFIType::DOUBLE: return "double";
         case FFIType::POINTER: return "pointer";
         case FFIType::STRING: return "string";
+        case FFIType::BUFFER: return "buffer";
         case FFIType::FUNCTION: return "function";
         case FFIType::STRUCT: return "struct " + name;
         case FFIType::ARRAY: return "array[" + std::to_string(array_length) + "]";
@@ -142,6 +151,173 @@ size_t FFISignature::get_stack_size() const {
     return total_size;
 }
 
+uint64_t FFISignature::hash() const {
+    // FNV-1a over the type tags
+    uint64_t h = 14695981039346656037ULL;
+    auto mix = [&h](uint8_t byte) {
+        h ^= byte;
+        h *= 1099511628211ULL;
+    };
+    mix(static_cast<uint8_t>(return_type.type));
+    mix(static_cast<uint8_t>(parameter_types.size()));
+    for (const auto& param : parameter_types) {
+        mix(static_cast<uint8_t>(param.type));
+    }
+    return h;
+}
+
+bool FFISignature::same_shape(const FFISignature& other) const {
+    if (return_type.type != other.return_type.type ||
+        parameter_types.size() != other.parameter_types.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < parameter_types.size(); ++i) {
+        if (parameter_types[i].type != other.parameter_types[i].type) return false;
+    }
+    return true;
+}
+
+//=============================================================================
+// FFICallStub Implementation
+//=============================================================================
+
+namespace {
+
+bool is_float_class(FFIType type) {
+    return type == FFIType::FLOAT || type == FFIType::DOUBLE;
+}
+
+bool is_passable(FFIType type) {
+    return type != FFIType::VOID && type != FFIType::STRUCT && type != FFIType::ARRAY;
+}
+
+// x86-64 encodings for the handful of instructions a call stub needs. Slots
+// are addressed as [r12 + disp32], which needs a SIB byte (0x24).
+class StubAssembler {
+public:
+    void emit(std::initializer_list<uint8_t> bytes) { code_.insert(code_.end(), bytes); }
+    
+    void emit32(uint32_t value) {
+        for (int i = 0; i < 4; ++i) code_.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+    
+    // push qword [r12 + disp]
+    void push_slot(uint32_t disp) {
+        emit({0x41, 0xFF, 0xB4, 0x24});
+        emit32(disp);
+    }
+    
+    // mov reg, [r12 + disp]
+    void load_integer(uint8_t reg, uint32_t disp) {
+        emit({static_cast<uint8_t>(0x49 | (reg >= 8 ? 0x04 : 0)), 0x8B,
+              static_cast<uint8_t>(0x84 | ((reg & 7) << 3)), 0x24});
+        emit32(disp);
+    }
+    
+    // movsd xmm, [r12 + disp]; a float slot's upper half is ignored by the callee
+    void load_float(uint8_t xmm, uint32_t disp) {
+        emit({0xF2, 0x41, 0x0F, 0x10, static_cast<uint8_t>(0x84 | (xmm << 3)), 0x24});
+        emit32(disp);
+    }
+    
+    const std::vector<uint8_t>& code() const { return code_; }
+
+private:
+    std::vector<uint8_t> code_;
+};
+
+// System V integer argument registers: rdi, rsi, rdx, rcx, r8, r9
+const uint8_t INTEGER_ARGUMENT_REGISTERS[] = {7, 6, 2, 1, 8, 9};
+const size_t INTEGER_ARGUMENT_REGISTER_COUNT = 6;
+const size_t FLOAT_ARGUMENT_REGISTER_COUNT = 8;
+
+} // anonymous namespace
+
+FFICallStub::FFICallStub(const FFISignature& signature, void* code, size_t code_size)
+    : signature_(signature), code_(code), code_size_(code_size),
+      entry_(reinterpret_cast<Entry>(code)) {
+}
+
+FFICallStub::~FFICallStub() {
+    PlatformFFI::free_executable_memory(code_, code_size_);
+}
+
+bool FFICallStub::is_supported(const FFISignature& signature) {
+#if defined(__x86_64__) && !defined(_WIN32)
+    if (signature.parameter_types.size() > MAX_PARAMETERS) return false;
+    if (signature.return_type.type == FFIType::STRUCT || signature.return_type.type == FFIType::ARRAY) {
+        return false;
+    }
+    for (const auto& param : signature.parameter_types) {
+        if (!is_passable(param.type)) return false;
+    }
+    return true;
+#else
+    (void)signature;
+    return false;
+#endif
+}
+
+std::unique_ptr<FFICallStub> FFICallStub::generate(const FFISignature& signature) {
+    if (!is_supported(signature)) return nullptr;
+    
+    // Assign each parameter a register, or the stack once its class runs out
+    const size_t count = signature.parameter_types.size();
+    std::vector<size_t> integer_slots;
+    std::vector<size_t> float_slots;
+    std::vector<size_t> stack_slots;
+    for (size_t i = 0; i < count; ++i) {
+        if (is_float_class(signature.parameter_types[i].type)) {
+            (float_slots.size() < FLOAT_ARGUMENT_REGISTER_COUNT ? float_slots : stack_slots).push_back(i);
+        } else {
+            (integer_slots.size() < INTEGER_ARGUMENT_REGISTER_COUNT ? integer_slots : stack_slots).push_back(i);
+        }
+    }
+    
+    StubAssembler a;
+    // Entry: rdi = target, rsi = slots, rdx = result. Saving three registers
+    // over the return address leaves rsp 16-byte aligned.
+    a.emit({0x53});                 // push rbx
+    a.emit({0x41, 0x54});           // push r12
+    a.emit({0x55});                 // push rbp
+    a.emit({0x48, 0x89, 0xE5});     // mov rbp, rsp
+    a.emit({0x48, 0x89, 0xD3});     // mov rbx, rdx
+    a.emit({0x49, 0x89, 0xFA});     // mov r10, rdi
+    a.emit({0x49, 0x89, 0xF4});     // mov r12, rsi
+    
+    // Stack arguments, last first, keeping rsp aligned at the call
+    if (stack_slots.size() % 2 != 0) {
+        a.emit({0x48, 0x83, 0xEC, 0x08});   // sub rsp, 8
+    }
+    for (auto it = stack_slots.rbegin(); it != stack_slots.rend(); ++it) {
+        a.push_slot(static_cast<uint32_t>(*it * sizeof(uint64_t)));
+    }
+    for (size_t i = 0; i < float_slots.size(); ++i) {
+        a.load_float(static_cast<uint8_t>(i), static_cast<uint32_t>(float_slots[i] * sizeof(uint64_t)));
+    }
+    for (size_t i = 0; i < integer_slots.size(); ++i) {
+        a.load_integer(INTEGER_ARGUMENT_REGISTERS[i], static_cast<uint32_t>(integer_slots[i] * sizeof(uint64_t)));
+    }
+    
+    a.emit({0xB0, static_cast<uint8_t>(float_slots.size())});   // mov al, vector register count
+    a.emit({0x41, 0xFF, 0xD2});                                 // call r10
+    a.emit({0x48, 0x89, 0x03});                                 // mov [rbx], rax
+    a.emit({0xF2, 0x0F, 0x11, 0x43, 0x08});                     // movsd [rbx + 8], xmm0
+    a.emit({0x48, 0x89, 0xEC});                                 // mov rsp, rbp
+    a.emit({0x5D});                 // pop rbp
+    a.emit({0x41, 0x5C});           // pop r12
+    a.emit({0x5B});                 // pop rbx
+    a.emit({0xC3});                 // ret
+    
+    const std::vector<uint8_t>& code = a.code();
+    void* memory = PlatformFFI::allocate_executable_memory(code.size());
+    if (!memory) return nullptr;
+    std::memcpy(memory, code.data(), code.size());
+    PlatformFFI::make_memory_executable(memory, code.size());
+    
+    return std::unique_ptr<FFICallStub>(new FFICallStub(signature, memory, code.size()));
+}
+
 //=============================================================================
 // NativeLibrary Implementation
 //=============================================================================
@@ -149,13 +325,10 @@ size_t FFISignature::get_stack_size() const {
 NativeLibrary::NativeLibrary(const std::string& path) 
     : library_path_(path), library_handle_(nullptr), is_loaded_(false),
       total_calls_(0), total_call_time_ns_(0) {
-    
-    std::cout << " NATIVE LIBRARY CREATED: " << path << std::endl;
 }
 
 NativeLibrary::~NativeLibrary() {
     unload();
-    std::cout << " NATIVE LIBRARY DESTROYED: " << library_path_ << std::endl;
 }
 
 bool NativeLibrary::load() {
@@ -168,7 +341,6 @@ bool NativeLibrary::load() {
     }
     
     is_loaded_ = true;
-    std::cout << " Library loaded: " << library_path_ << std::endl;
     return true;
 }
 
@@ -184,12 +356,9 @@ void NativeLibrary::unload() {
     function_signatures_.clear();
     is_loaded_ = false;
     
-    std::cout << " Library unloaded: " << library_path_ << std::endl;
 }
 
 bool NativeLibrary::reload() {
-    std::cout << " Reloading library: " << library_path_ << std::endl;
-    
     // Store current state
     auto old_signatures = function_signatures_;
     
@@ -204,10 +373,6 @@ bool NativeLibrary::reload() {
         for (const auto& [name, signature] : function_signatures_) {
             get_symbol(name); // This will cache the symbol
         }
-        
-        std::cout << " Library reloaded successfully" << std::endl;
-    } else {
-        std::cout << " Library reload failed: " << get_last_error() << std::endl;
     }
     
     return success;
@@ -234,7 +399,6 @@ void* NativeLibrary::get_symbol(const std::string& name) {
     
     // Cache the symbol
     symbols_[name] = symbol;
-    std::cout << " Symbol resolved: " << name << " -> " << symbol << std::endl;
     
     return symbol;
 }
@@ -245,7 +409,6 @@ bool NativeLibrary::has_symbol(const std::string& name) const {
 
 void NativeLibrary::register_function(const std::string& name, const FFISignature& signature) {
     function_signatures_[name] = signature;
-    std::cout << " Function registered: " << signature.to_string() << std::endl;
 }
 
 void NativeLibrary::register_function(const std::string& name, FFIType return_type, const std::vector<FFIType>& param_types) {
@@ -283,37 +446,15 @@ Value NativeLibrary::call_function(const std::string& name, const std::vector<Va
     total_call_time_ns_ += duration;
     function_call_counts_[name]++;
     
-    std::cout << " Function called: " << name << " (" << (duration / 1000.0) << " μs)" << std::endl;
-    
     return result;
 }
 
 Value NativeLibrary::call_function_ptr(void* func_ptr, const FFISignature& signature, const std::vector<Value>& args, Context* context) {
-    // This is a simplified implementation
-    // In a real implementation, this would use platform-specific assembly or libffi
-    
     if (!signature.matches(args)) {
         throw std::runtime_error("Argument count mismatch for function " + signature.name);
     }
     
-    // For demonstration, we'll simulate a function call
-    std::cout << " Calling native function: " << signature.to_string() << std::endl;
-    std::cout << "  Arguments: " << args.size() << std::endl;
-    std::cout << "  Function pointer: " << func_ptr << std::endl;
-    
-    // Simulate return value based on return type
-    switch (signature.return_type.type) {
-        case FFIType::VOID:
-            return Value(); // undefined
-        case FFIType::INT32:
-            return Value(42.0); // Simulated integer result
-        case FFIType::DOUBLE:
-            return Value(3.14159); // Simulated double result
-        case FFIType::STRING:
-            return Value("Hello from native code"); // Simulated string result
-        default:
-            return Value(); // undefined for other types
-    }
+    return FFICallDispatcher::get_instance().dispatch_call(func_ptr, signature, args, context);
 }
 
 double NativeLibrary::get_average_call_time_us() const {
@@ -321,7 +462,7 @@ double NativeLibrary::get_average_call_time_us() const {
 }
 
 void NativeLibrary::print_performance_stats() const {
-    std::cout << " LIBRARY PERFORMANCE STATS: " << library_path_ << std::endl;
+    std::cout << "Library performance stats: " << library_path_ << std::endl;
     std::cout << "  Total calls: " << total_calls_ << std::endl;
     std::cout << "  Average call time: " << get_average_call_time_us() << " μs" << std::endl;
     std::cout << "  Registered functions: " << function_signatures_.size() << std::endl;
@@ -347,7 +488,8 @@ void* NativeLibrary::load_library_platform(const std::string& path) {
 #ifdef _WIN32
     return LoadLibraryA(path.c_str());
 #else
-    return dlopen(path.c_str(), RTLD_LAZY);
+    // An empty path opens the running program and the libraries it has loaded
+    return dlopen(path.empty() ? nullptr : path.c_str(), RTLD_LAZY);
 #endif
 }
 
@@ -394,11 +536,10 @@ FFIMarshaler::FFIMarshaler() : buffer_offset_(0) {
 FFIMarshaler::~FFIMarshaler() = default;
 
 void FFIMarshaler::marshal_argument(const Value& js_value, const FFITypeInfo& type_info) {
-    std::cout << " Marshaling argument: " << type_info.to_string() << std::endl;
     
     switch (type_info.type) {
         case FFIType::BOOL: {
-            bool value = js_value.is_truthy();
+            bool value = js_value.to_boolean();
             write_value(value);
             break;
         }
@@ -427,7 +568,6 @@ void FFIMarshaler::marshal_argument(const Value& js_value, const FFITypeInfo& ty
 }
 
 Value FFIMarshaler::unmarshal_return_value(const void* native_value, const FFITypeInfo& type_info, Context* context) {
-    std::cout << " Unmarshaling return value: " << type_info.to_string() << std::endl;
     
     switch (type_info.type) {
         case FFIType::VOID:
@@ -481,13 +621,252 @@ void FFIMarshaler::marshal_string_to_native(const Value& js_value) {
     write_value(c_str);
 }
 
+namespace {
+
+// Wraps like the integer conversions of typed arrays: modulo 2^64, then
+// truncated to the parameter's width by the caller
+uint64_t to_uint64_modular(double number) {
+    if (!std::isfinite(number)) return 0;
+    double truncated = std::trunc(number);
+    if (truncated >= -9223372036854775808.0 && truncated < 9223372036854775808.0) {
+        return static_cast<uint64_t>(static_cast<int64_t>(truncated));
+    }
+    double wrapped = std::fmod(truncated, 18446744073709551616.0);
+    if (wrapped < 0) wrapped += 18446744073709551616.0;
+    return wrapped >= 9223372036854775808.0
+        ? static_cast<uint64_t>(wrapped - 9223372036854775808.0) + (1ULL << 63)
+        : static_cast<uint64_t>(wrapped);
+}
+
+// The backing store of a buffer or view, or false if value is not one
+bool buffer_address(const Value& value, uint64_t& address) {
+    if (!value.is_object()) return false;
+    Object* object = value.as_object();
+    uint8_t* data = nullptr;
+    if (object->is_array_buffer()) {
+        data = static_cast<ArrayBuffer*>(object)->data();
+    } else if (object->is_typed_array()) {
+        TypedArrayBase* view = static_cast<TypedArrayBase*>(object);
+        data = view->buffer()->data();
+        if (data) data += view->byte_offset();
+    } else if (object->is_data_view()) {
+        DataView* view = static_cast<DataView*>(object);
+        data = view->buffer()->data();
+        if (data) data += view->byte_offset();
+    } else {
+        return false;
+    }
+    address = reinterpret_cast<uint64_t>(data);
+    return true;
+}
+
+} // anonymous namespace
+
+bool FFIMarshaler::to_slot(const Value& js_value, const FFITypeInfo& type_info, uint64_t& slot) {
+    switch (type_info.type) {
+        case FFIType::BOOL:
+            slot = js_value.to_boolean() ? 1 : 0;
+            return true;
+        // Narrow integers are sign or zero extended to 64 bits, as some
+        // compilers expect of their callers
+        case FFIType::INT8:
+            slot = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int8_t>(to_uint64_modular(js_value.to_number()))));
+            return true;
+        case FFIType::UINT8:
+            slot = static_cast<uint8_t>(to_uint64_modular(js_value.to_number()));
+            return true;
+        case FFIType::INT16:
+            slot = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int16_t>(to_uint64_modular(js_value.to_number()))));
+            return true;
+        case FFIType::UINT16:
+            slot = static_cast<uint16_t>(to_uint64_modular(js_value.to_number()));
+            return true;
+        case FFIType::INT32:
+            slot = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(to_uint64_modular(js_value.to_number()))));
+            return true;
+        case FFIType::UINT32:
+            slot = static_cast<uint32_t>(to_uint64_modular(js_value.to_number()));
+            return true;
+        case FFIType::INT64:
+        case FFIType::UINT64:
+            slot = to_uint64_modular(js_value.to_number());
+            return true;
+        case FFIType::FLOAT: {
+            float value = static_cast<float>(js_value.to_number());
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            slot = bits;
+            return true;
+        }
+        case FFIType::DOUBLE: {
+            double value = js_value.to_number();
+            std::memcpy(&slot, &value, sizeof(slot));
+            return true;
+        }
+        case FFIType::STRING:
+            // String cells outlive the call, so their text is passed in place
+            if (js_value.is_string()) {
+                slot = reinterpret_cast<uint64_t>(js_value.as_string()->c_str());
+                return true;
+            }
+            if (js_value.is_null() || js_value.is_undefined()) {
+                slot = 0;
+                return true;
+            }
+            return false;
+        case FFIType::POINTER:
+        case FFIType::BUFFER:
+        case FFIType::FUNCTION:
+            if (js_value.is_null() || js_value.is_undefined()) {
+                slot = 0;
+                return true;
+            }
+            if (js_value.is_number()) {
+                slot = static_cast<uint64_t>(js_value.as_number());
+                return true;
+            }
+            return buffer_address(js_value, slot);
+        default:
+            return false;
+    }
+}
+
+Value FFIMarshaler::from_result(const FFICallResult& result, const FFITypeInfo& type_info) {
+    // Only the low bits of rax that belong to the return type are defined
+    switch (type_info.type) {
+        case FFIType::VOID:
+            return Value();
+        case FFIType::BOOL:
+            return Value(static_cast<uint8_t>(result.integer) != 0);
+        case FFIType::INT8:
+            return Value(static_cast<double>(static_cast<int8_t>(result.integer)));
+        case FFIType::UINT8:
+            return Value(static_cast<double>(static_cast<uint8_t>(result.integer)));
+        case FFIType::INT16:
+            return Value(static_cast<double>(static_cast<int16_t>(result.integer)));
+        case FFIType::UINT16:
+            return Value(static_cast<double>(static_cast<uint16_t>(result.integer)));
+        case FFIType::INT32:
+            return Value(static_cast<double>(static_cast<int32_t>(result.integer)));
+        case FFIType::UINT32:
+            return Value(static_cast<double>(static_cast<uint32_t>(result.integer)));
+        case FFIType::INT64:
+            return Value(static_cast<double>(static_cast<int64_t>(result.integer)));
+        case FFIType::UINT64:
+            return Value(static_cast<double>(result.integer));
+        case FFIType::FLOAT: {
+            float value;
+            std::memcpy(&value, &result.floating, sizeof(value));
+            return Value(static_cast<double>(value));
+        }
+        case FFIType::DOUBLE:
+            return Value(result.floating);
+        case FFIType::STRING:
+            if (!result.integer) return Value::null();
+            return Value(std::string(reinterpret_cast<const char*>(result.integer)));
+        case FFIType::POINTER:
+        case FFIType::BUFFER:
+        case FFIType::FUNCTION:
+            if (!result.integer) return Value::null();
+            return Value(static_cast<double>(result.integer));
+        default:
+            return Value();
+    }
+}
+
+//=============================================================================
+// FFICallDispatcher Implementation
+//=============================================================================
+
+FFICallDispatcher::FFICallDispatcher() : cache_hits_(0), cache_misses_(0) {
+}
+
+FFICallDispatcher::~FFICallDispatcher() = default;
+
+std::shared_ptr<const FFICallStub> FFICallDispatcher::get_stub(const FFISignature& signature) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    
+    auto& bucket = stubs_[signature.hash()];
+    for (const auto& stub : bucket) {
+        if (stub->get_signature().same_shape(signature)) {
+            cache_hits_++;
+            return stub;
+        }
+    }
+    
+    cache_misses_++;
+    std::shared_ptr<const FFICallStub> stub = FFICallStub::generate(signature);
+    if (!stub) return nullptr;
+    bucket.push_back(stub);
+    return stub;
+}
+
+Value FFICallDispatcher::invoke(const FFICallStub& stub, void* func_ptr, const Value* args, size_t arg_count) {
+    const FFISignature& signature = stub.get_signature();
+    const size_t count = signature.parameter_types.size();
+    
+    uint64_t slots[FFICallStub::MAX_PARAMETERS];
+    const Value missing;
+    for (size_t i = 0; i < count; ++i) {
+        if (!FFIMarshaler::to_slot(i < arg_count ? args[i] : missing, signature.parameter_types[i], slots[i])) {
+            throw std::runtime_error("Argument " + std::to_string(i + 1) + " of " + signature.name +
+                                     " cannot be passed as " + signature.parameter_types[i].to_string());
+        }
+    }
+    
+    FFICallResult result;
+    stub.invoke(func_ptr, slots, &result);
+    return FFIMarshaler::from_result(result, signature.return_type);
+}
+
+Value FFICallDispatcher::dispatch_call(void* func_ptr, const FFISignature& signature, const std::vector<Value>& args, Context* context) {
+    (void)context;
+    std::shared_ptr<const FFICallStub> stub = get_stub(signature);
+    if (!stub) {
+        throw std::runtime_error("Unsupported FFI signature on this platform: " + signature.to_string());
+    }
+    return invoke(*stub, func_ptr, args.data(), args.size());
+}
+
+void FFICallDispatcher::clear_call_cache() {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    stubs_.clear();
+    cache_hits_ = 0;
+    cache_misses_ = 0;
+}
+
+double FFICallDispatcher::get_cache_hit_ratio() const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    uint64_t total = cache_hits_ + cache_misses_;
+    return total > 0 ? static_cast<double>(cache_hits_) / total : 0.0;
+}
+
+size_t FFICallDispatcher::get_stub_count() const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    size_t count = 0;
+    for (const auto& entry : stubs_) {
+        count += entry.second.size();
+    }
+    return count;
+}
+
+void FFICallDispatcher::print_call_statistics() const {
+    std::cout << "FFI Call Stubs:" << std::endl;
+    std::cout << "  Generated stubs: " << get_stub_count() << std::endl;
+    std::cout << "  Stub cache hit ratio: " << (get_cache_hit_ratio() * 100.0) << "%" << std::endl;
+}
+
+FFICallDispatcher& FFICallDispatcher::get_instance() {
+    // Never destroyed: bound functions may still be called during exit
+    static FFICallDispatcher* instance = new FFICallDispatcher();
+    return *instance;
+}
+
 //=============================================================================
 // NativeModuleManager Implementation
 //=============================================================================
 
 NativeModuleManager::NativeModuleManager() : sandbox_enabled_(false) {
-    std::cout << "️  NATIVE MODULE MANAGER INITIALIZED" << std::endl;
-    
     // Add default search paths
     add_search_path("./");
     add_search_path("./lib/");
@@ -504,33 +883,26 @@ NativeModuleManager::NativeModuleManager() : sandbox_enabled_(false) {
 
 NativeModuleManager::~NativeModuleManager() {
     stop_hot_reload_monitoring();
-    print_library_statistics();
-    std::cout << "️  NATIVE MODULE MANAGER SHUTDOWN" << std::endl;
 }
 
 bool NativeModuleManager::load_library(const std::string& name, const std::string& path) {
     std::lock_guard<std::mutex> lock(manager_mutex_);
     
     if (sandbox_enabled_ && !is_library_allowed(path)) {
-        std::cout << " Library blocked by sandbox: " << path << std::endl;
         return false;
     }
     
     // Check if already loaded
     if (loaded_libraries_.find(name) != loaded_libraries_.end()) {
-        std::cout << "⚠️  Library already loaded: " << name << std::endl;
         return true;
     }
     
     auto library = std::make_unique<NativeLibrary>(path);
     if (!library->load()) {
-        std::cout << " Failed to load library: " << library->get_last_error() << std::endl;
         return false;
     }
     
     loaded_libraries_[name] = std::move(library);
-    std::cout << " Library loaded: " << name << " (" << path << ")" << std::endl;
-    
     return true;
 }
 
@@ -543,7 +915,6 @@ bool NativeModuleManager::unload_library(const std::string& name) {
     }
     
     loaded_libraries_.erase(it);
-    std::cout << " Library unloaded: " << name << std::endl;
     return true;
 }
 
@@ -562,7 +933,6 @@ void NativeModuleManager::add_search_path(const std::string& path) {
     
     if (std::find(library_search_paths_.begin(), library_search_paths_.end(), path) == library_search_paths_.end()) {
         library_search_paths_.push_back(path);
-        std::cout << " Search path added: " << path << std::endl;
     }
 }
 
@@ -583,20 +953,17 @@ std::string NativeModuleManager::find_library(const std::string& name) {
             // Check if file exists (simplified check)
             std::ifstream file(full_path);
             if (file.good()) {
-                std::cout << " Library found: " << full_path << std::endl;
                 return full_path;
             }
         }
     }
     
-    std::cout << " Library not found in search paths: " << name << std::endl;
     return "";
 }
 
 void NativeModuleManager::set_alias(const std::string& alias, const std::string& library_name) {
     std::lock_guard<std::mutex> lock(manager_mutex_);
     module_aliases_[alias] = library_name;
-    std::cout << "️  Alias set: " << alias << " -> " << library_name << std::endl;
 }
 
 std::string NativeModuleManager::resolve_alias(const std::string& name) const {
@@ -605,8 +972,7 @@ std::string NativeModuleManager::resolve_alias(const std::string& name) const {
 }
 
 void NativeModuleManager::print_library_statistics() const {
-    std::cout << " NATIVE MODULE MANAGER STATISTICS" << std::endl;
-    std::cout << "====================================" << std::endl;
+    std::cout << "Native module manager statistics" << std::endl;
     std::cout << "Loaded libraries: " << loaded_libraries_.size() << std::endl;
     std::cout << "Search paths: " << library_search_paths_.size() << std::endl;
     std::cout << "Module aliases: " << module_aliases_.size() << std::endl;
@@ -621,11 +987,51 @@ void NativeModuleManager::print_library_statistics() const {
     }
 }
 
+void NativeModuleManager::stop_hot_reload_monitoring() {
+    should_stop_watching_ = true;
+    if (hot_reload_thread_.joinable()) {
+        hot_reload_thread_.join();
+    }
+}
+
+bool NativeModuleManager::is_library_allowed(const std::string& path) const {
+    if (allowed_libraries_.empty()) return true;
+    for (const std::string& pattern : allowed_libraries_) {
+        if (path.find(pattern) != std::string::npos) return true;
+    }
+    return false;
+}
+
 NativeModuleManager& NativeModuleManager::get_instance() {
     static NativeModuleManager instance;
     return instance;
 }
 
+//=============================================================================
+// FFIHelpers Implementation
+//=============================================================================
+
+namespace FFIHelpers {
+
+bool parse_type(const std::string& name, FFIType& type) {
+    static const std::unordered_map<std::string, FFIType> types = {
+        {"void", FFIType::VOID}, {"bool", FFIType::BOOL},
+        {"int8", FFIType::INT8}, {"uint8", FFIType::UINT8},
+        {"int16", FFIType::INT16}, {"uint16", FFIType::UINT16},
+        {"int32", FFIType::INT32}, {"uint32", FFIType::UINT32},
+        {"int64", FFIType::INT64}, {"uint64", FFIType::UINT64},
+        {"float", FFIType::FLOAT}, {"double", FFIType::DOUBLE},
+        {"pointer", FFIType::POINTER}, {"string", FFIType::STRING},
+        {"buffer", FFIType::BUFFER}, {"function", FFIType::FUNCTION}
+    };
+    auto it = types.find(name);
+    if (it == types.end()) return false;
+    type = it->second;
+    return true;
+}
+
+} // namespace FFIHelpers
+
 //=============================================================================
 // FFIIntegration Implementation
 //=============================================================================
@@ -633,44 +1039,20 @@ NativeModuleManager& NativeModuleManager::get_instance() {
 namespace FFIIntegration {
 
 void initialize_ffi_system() {
-    std::cout << " INITIALIZING FFI SYSTEM" << std::endl;
-    
     // Initialize the native module manager
     NativeModuleManager::get_instance();
-    
-    std::cout << " FFI SYSTEM INITIALIZED" << std::endl;
-    std::cout << "   Native module manager: Ready" << std::endl;
-    std::cout << "   Symbol resolution: Ready" << std::endl;
-    std::cout << "   Type marshaling: Ready" << std::endl;
-    std::cout << "   Function calling: Ready" << std::endl;
 }
 
 void shutdown_ffi_system() {
-    std::cout << " SHUTTING DOWN FFI SYSTEM" << std::endl;
-    
     // Manager will be destroyed automatically
-    
-    std::cout << " FFI SYSTEM SHUTDOWN COMPLETE" << std::endl;
 }
 
+// C and math library functions are not pre-bound; scripts bind the ones
+// they need with FFI.open().func(), which resolves each symbol on demand
 void bind_standard_c_library() {
-    auto& manager = NativeModuleManager::get_instance();
-    
-    std::cout << " Binding standard C library functions..." << std::endl;
-    
-    // This would bind common C library functions
-    // For demonstration, we'll just print the intent
-    std::cout << "  - malloc, free, memcpy, memset" << std::endl;
-    std::cout << "  - printf, scanf, strlen, strcmp" << std::endl;
-    std::cout << "  - fopen, fread, fwrite, fclose" << std::endl;
-    
-    std::cout << " Standard C library bindings complete" << std::endl;
 }
 
 void bind_math_library() {
-    std::cout << " Binding math library functions..." << std::endl;
-    std::cout << "  - sin, cos, tan, sqrt, pow, log" << std::endl;
-    std::cout << " Math library bindings complete" << std::endl;
 }
 
 Value require_native_module(const std::string& name, Context* context) {
@@ -687,10 +1069,108 @@ Value require_native_module(const std::string& name, Context* context) {
     }
     
     // Return a module object (simplified)
-    std::cout << " Native module required: " << name << std::endl;
     return Value(); // Would return proper module object
 }
 
+Value create_native_function(const std::string& library, const std::string& function, const FFISignature& signature, Context* context) {
+    (void)context;
+    NativeLibrary* native_library = NativeModuleManager::get_instance().get_library(library);
+    void* target = native_library ? native_library->get_symbol(function) : nullptr;
+    std::shared_ptr<const FFICallStub> stub = FFICallDispatcher::get_instance().get_stub(signature);
+    if (!target || !stub) return Value();
+    
+    auto fn = ObjectFactory::create_native_function(function,
+        [target, stub](Context& ctx, const std::vector<Value>& args) -> Value {
+            try {
+                return FFICallDispatcher::invoke(*stub, target, args.data(), args.size());
+            } catch (const std::runtime_error& e) {
+                ctx.throw_type_error(e.what());
+                return Value();
+            }
+        });
+    return Value(fn.release());
+}
+
+void register_ffi_globals(Context* context) {
+    auto ffi_obj = ObjectFactory::create_object();
+    
+    // FFI.open(path) returns a library; with no path, the running program.
+    // library.func(name, returnType, [parameterTypes]) binds a symbol once:
+    // its call stub is looked up here and every call goes straight through it
+    auto open_fn = ObjectFactory::create_native_function("open",
+        [](Context& ctx, const std::vector<Value>& args) -> Value {
+            std::string path = args.empty() || args[0].is_undefined() || args[0].is_null() ? "" : args[0].to_string();
+            auto library = std::make_shared<NativeLibrary>(path);
+            if (!library->load()) {
+                ctx.throw_error(library->get_last_error());
+                return Value();
+            }
+            
+            auto library_obj = ObjectFactory::create_object();
+            library_obj->set_property("path", Value(path));
+            
+            auto func_fn = ObjectFactory::create_native_function("func",
+                [library](Context& ctx, const std::vector<Value>& args) -> Value {
+                    if (args.size() < 2) {
+                        ctx.throw_type_error("func requires a symbol name and a return type");
+                        return Value();
+                    }
+                    
+                    FFISignature signature;
+                    signature.name = args[0].to_string();
+                    FFIType type;
+                    if (!FFIHelpers::parse_type(args[1].to_string(), type)) {
+                        ctx.throw_type_error("Unknown FFI type: " + args[1].to_string());
+                        return Value();
+                    }
+                    signature.return_type = FFITypeInfo(type);
+                    
+                    if (args.size() > 2 && args[2].is_object()) {
+                        Object* params = args[2].as_object();
+                        uint32_t count = params->get_length();
+                        for (uint32_t i = 0; i < count; ++i) {
+                            std::string name = params->get_element(i).to_string();
+                            if (!FFIHelpers::parse_type(name, type) || type == FFIType::VOID) {
+                                ctx.throw_type_error("Unknown FFI parameter type: " + name);
+                                return Value();
+                            }
+                            signature.parameter_types.emplace_back(type);
+                        }
+                    }
+                    
+                    void* target = library->get_symbol(signature.name);
+                    if (!target) {
+                        ctx.throw_error(library->get_last_error());
+                        return Value();
+                    }
+                    std::shared_ptr<const FFICallStub> stub = FFICallDispatcher::get_instance().get_stub(signature);
+                    if (!stub) {
+                        ctx.throw_type_error("Unsupported FFI signature on this platform: " + signature.to_string());
+                        return Value();
+                    }
+                    library->register_function(signature.name, signature);
+                    
+                    // The library and the stub stay alive while any of its functions lives
+                    auto fn = ObjectFactory::create_native_function(signature.name,
+                        [library, target, stub](Context& ctx, const std::vector<Value>& args) -> Value {
+                            try {
+                                return FFICallDispatcher::invoke(*stub, target, args.data(), args.size());
+                            } catch (const std::runtime_error& e) {
+                                ctx.throw_type_error(e.what());
+                                return Value();
+                            }
+                        });
+                    return Value(fn.release());
+                });
+            library_obj->set_property("func", Value(func_fn.release()));
+            
+            return Value(library_obj.release());
+        });
+    ffi_obj->set_property("open", Value(open_fn.release()));
+    
+    context->register_built_in_object("FFI", ffi_obj.release());
+}
+
 } // namespace FFIIntegration
 
 //=============================================================================
@@ -752,6 +1232,44 @@ size_t get_pointer_size() {
     return sizeof(void*);
 }
 
+void* allocate_executable_memory(size_t size) {
+#ifdef _WIN32
+    return VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return memory == MAP_FAILED ? nullptr : memory;
+#endif
+}
+
+void free_executable_memory(void* ptr, size_t size) {
+    if (!ptr) return;
+#ifdef _WIN32
+    (void)size;
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    munmap(ptr, size);
+#endif
+}
+
+// Code is written while the memory is writable, then flipped to read/execute
+void make_memory_executable(void* ptr, size_t size) {
+#ifdef _WIN32
+    DWORD old_protection;
+    VirtualProtect(ptr, size, PAGE_EXECUTE_READ, &old_protection);
+#else
+    mprotect(ptr, size, PROT_READ | PROT_EXEC);
+#endif
+}
+
+void make_memory_writable(void* ptr, size_t size) {
+#ifdef _WIN32
+    DWORD old_protection;
+    VirtualProtect(ptr, size, PAGE_READWRITE, &old_protection);
+#else
+    mprotect(ptr, size, PROT_READ | PROT_WRITE);
+#endif
+}
+
 bool supports_calling_convention(const std::string& convention) {
     // Simplified implementation
     return convention == "cdecl" || convention == "stdcall";
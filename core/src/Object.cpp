@@ -11,6 +11,9 @@
 #include "ArrayBuffer.h"
 #include "TypedArray.h"
 #include "Promise.h"
+#include "GC.h"
+#include "Isolate.h"
+#include "Symbol.h"
 #include "../../parser/include/AST.h"
 #include <algorithm>
 #include <sstream>
@@ -19,13 +22,7 @@
 namespace Quanta {
 
 // Static member initialization
-std::unordered_map<std::pair<Shape*, std::string>, Shape*, Object::ShapeTransitionHash> Object::shape_transition_cache_;
-std::unordered_map<std::string, std::string> Object::interned_keys_;
-uint32_t Shape::next_shape_id_ = 1;
-
-
-// Global root shape
-static Shape* g_root_shape = nullptr;
+std::atomic<uint32_t> Shape::next_shape_id_{1};
 
 //=============================================================================
 // Object Implementation
@@ -56,6 +53,7 @@ Object::Object(Object* prototype, ObjectType type) : Object(type) {
 }
 
 void Object::set_prototype(Object* prototype) {
+    GarbageCollector::write_barrier(prototype);
     header_.prototype = prototype;
     update_hash_code();
 }
@@ -275,16 +273,8 @@ Value Object::get_property(const std::string& key) const {
         }
     }
     
-    // For Array objects, handle array methods
+    // Array methods live on Array.prototype and are found below
     if (this->get_type() == ObjectType::Array) {
-        if (key == "map" || key == "filter" || key == "reduce" || key == "forEach" || 
-            key == "indexOf" || key == "slice" || key == "splice" || key == "push" || 
-            key == "pop" || key == "shift" || key == "unshift" || key == "join" || key == "concat" || key == "groupBy" ||
-            key == "reverse" || key == "sort" || key == "find" || key == "includes" || 
-            key == "some" || key == "every" || key == "findIndex") {
-            // Return a native function that will call the appropriate array method
-            return Value(ObjectFactory::create_array_method(key).release());
-        }
         if (key == "length") {
             return Value(static_cast<double>(get_length()));
         }
@@ -381,6 +371,8 @@ bool Object::set_property(const std::string& key, const Value& value, PropertyAt
         return set_element(index, value);
     }
     
+    GarbageCollector::write_barrier(value);
+    
     // Check if property exists
     bool prop_exists = has_own_property(key);
     if (prop_exists) {
@@ -442,19 +434,46 @@ bool Object::delete_property(const std::string& key) {
         if (it != overflow_properties_->end()) {
             overflow_properties_->erase(it);
             header_.property_count--;
+            if (descriptors_) {
+                descriptors_->erase(key);
+            }
             update_hash_code();
             return true;
         }
     }
     
-    // Cannot delete properties stored in shape efficiently
-    // Would require shape transition - for now, just mark as undefined
-    if (header_.shape->has_property(key)) {
-        auto info = header_.shape->get_property_info(key);
-        if (info.offset < properties_.size()) {
-            properties_[info.offset] = Value(); // undefined
-            return true;
+    // Shape-stored properties move to a shape without the key; the
+    // remaining values are repacked to its offsets
+    if (header_.shape && header_.shape->has_property(key)) {
+        Shape* old_shape = header_.shape;
+        Shape* new_shape = old_shape->remove_property(key);
+        
+        std::vector<Value> properties(new_shape->get_property_count());
+        auto repack = [&](const std::vector<std::string>& keys) {
+            for (const auto& remaining : keys) {
+                auto from = old_shape->get_property_info(remaining);
+                auto to = new_shape->get_property_info(remaining);
+                if (from.offset < properties_.size()) {
+                    properties[to.offset] = properties_[from.offset];
+                }
+            }
+        };
+        repack(new_shape->get_property_keys());
+        repack(new_shape->get_symbol_keys());
+        
+        properties_ = std::move(properties);
+        header_.shape = new_shape;
+        header_.property_count--;
+        if (descriptors_) {
+            descriptors_->erase(key);
         }
+        update_hash_code();
+        return true;
+    }
+    
+    // Accessors defined through a descriptor live only in the descriptor map
+    if (descriptors_ && descriptors_->erase(key)) {
+        return true;
     }
     
     return false;
@@ -477,6 +496,7 @@ bool Object::set_element(uint32_t index, const Value& value) {
         elements_.resize(index + 1, Value());
     }
     
+    GarbageCollector::write_barrier(value);
     elements_[index] = value;
     
     // Update length for arrays
@@ -490,6 +510,20 @@ bool Object::set_element(uint32_t index, const Value& value) {
     return true;
 }
 
+void Object::set_shape_slot(uint32_t offset, const Value& value) {
+    GarbageCollector::write_barrier(value);
+    properties_[offset] = value;
+}
+
+void Object::set_element_slot(uint32_t index, const Value& value) {
+    GarbageCollector::write_barrier(value);
+    elements_[index] = value;
+}
+
+bool Object::has_descriptors() const {
+    return descriptors_ && !descriptors_->empty();
+}
+
 bool Object::delete_element(uint32_t index) {
     if (index < elements_.size()) {
         elements_[index] = Value(); // undefined
@@ -513,7 +547,9 @@ std::vector<std::string> Object::get_own_property_keys() const {
     // Add overflow properties
     if (overflow_properties_) {
         for (const auto& pair : *overflow_properties_) {
-            keys.push_back(pair.first);
+            if (!Symbol::is_property_key(pair.first)) {
+                keys.push_back(pair.first);
+            }
         }
     }
     
@@ -527,6 +563,32 @@ std::vector<std::string> Object::get_own_property_keys() const {
     return keys;
 }
 
+std::vector<std::string> Object::get_own_symbol_keys() const {
+    std::vector<std::string> keys;
+    if (!(own_symbol_key_bits() & Shape::SYMBOL_KEYS)) {
+        return keys;
+    }
+    
+    if (header_.shape) {
+        keys = header_.shape->get_symbol_keys();
+    }
+    if (overflow_properties_) {
+        for (const auto& pair : *overflow_properties_) {
+            if (Symbol::is_property_key(pair.first)) {
+                keys.push_back(pair.first);
+            }
+        }
+    }
+    if (descriptors_) {
+        for (const auto& pair : *descriptors_) {
+            if (Symbol::is_property_key(pair.first) && std::find(keys.begin(), keys.end(), pair.first) == keys.end()) {
+                keys.push_back(pair.first);
+            }
+        }
+    }
+    return keys;
+}
+
 std::vector<std::string> Object::get_enumerable_keys() const {
     std::vector<std::string> keys;
     auto all_keys = get_own_property_keys();
@@ -582,7 +644,14 @@ bool Object::set_property_descriptor(const std::string& key, const PropertyDescr
         descriptors_ = std::make_unique<std::unordered_map<std::string, PropertyDescriptor>>();
     }
     
+    if (desc.is_accessor_descriptor()) {
+        GarbageCollector::write_barrier(desc.get_getter());
+        GarbageCollector::write_barrier(desc.get_setter());
+    }
     (*descriptors_)[key] = desc;
+    if (Symbol::is_property_key(key)) {
+        header_.flags |= SLOW_SYMBOL_KEYS_FLAG;
+    }
     
     // Store the value if it's a data descriptor
     if (desc.is_data_descriptor()) {
@@ -613,6 +682,16 @@ void Object::set_length(uint32_t length) {
     }
 }
 
+void Object::assign_elements(std::vector<Value> elements) {
+    for (const Value& element : elements) {
+        GarbageCollector::write_barrier(element);
+    }
+    elements_ = std::move(elements);
+    if (header_.type == ObjectType::Array) {
+        set_property("length", Value(static_cast<double>(elements_.size())));
+    }
+}
+
 void Object::push(const Value& value) {
     uint32_t length = get_length();
     // Safety check for array size
@@ -846,11 +925,11 @@ Value Object::groupBy(Function* callback, Context& ctx) {
 }
 
 bool Object::is_extensible() const {
-    return !(header_.flags & 0x01);
+    return !(header_.flags & NON_EXTENSIBLE_FLAG);
 }
 
 void Object::prevent_extensions() {
-    header_.flags |= 0x01;
+    header_.flags |= NON_EXTENSIBLE_FLAG;
 }
 
 bool Object::is_array_index(const std::string& key, uint32_t* index) const {
@@ -910,6 +989,9 @@ bool Object::store_in_overflow(const std::string& key, const Value& value) {
     if (is_new_property) {
         // property_insertion_order_.push_back(key);
         header_.property_count++;
+        if (Symbol::is_property_key(key)) {
+            header_.flags |= SLOW_SYMBOL_KEYS_FLAG;
+        }
     }
     
     update_hash_code();
@@ -956,6 +1038,33 @@ void Object::update_hash_code() {
     header_.hash_code = (header_.property_count << 16) | static_cast<uint32_t>(header_.type);
 }
 
+void Object::visit_references(GCVisitor& visitor) const {
+    visitor.visit(header_.prototype);
+
+    for (const Value& value : properties_) {
+        visitor.visit(value);
+    }
+    for (const Value& value : elements_) {
+        visitor.visit(value);
+    }
+
+    if (overflow_properties_) {
+        for (const auto& pair : *overflow_properties_) {
+            visitor.visit(pair.second);
+        }
+    }
+
+    // Accessor functions and descriptor values are only reachable from here
+    if (descriptors_) {
+        for (const auto& pair : *descriptors_) {
+            const PropertyDescriptor& desc = pair.second;
+            visitor.visit(desc.get_value());
+            visitor.visit(desc.get_getter());
+            visitor.visit(desc.get_setter());
+        }
+    }
+}
+
 std::string Object::to_string() const {
     if (header_.type == ObjectType::Array) {
         std::ostringstream oss;
@@ -1034,13 +1143,14 @@ void PropertyDescriptor::set_value(const Value& value) {
 // Shape Implementation
 //=============================================================================
 
-Shape::Shape() : parent_(nullptr), property_count_(0), id_(next_shape_id_++) {
+Shape::Shape() : parent_(nullptr), property_count_(0), id_(next_shape_id_++), symbol_key_bits_(0) {
 }
 
 Shape::Shape(Shape* parent, const std::string& key, PropertyAttributes attrs)
     : parent_(parent), transition_key_(key), transition_attrs_(attrs),
       property_count_(parent ? parent->property_count_ + 1 : 1),
-      id_(next_shape_id_++) {
+      id_(next_shape_id_++),
+      symbol_key_bits_((parent ? parent->symbol_key_bits_ : 0) | symbol_key_bits(key)) {
     
     // Copy parent properties
     if (parent_) {
@@ -1069,10 +1179,11 @@ Shape::PropertyInfo Shape::get_property_info(const std::string& key) const {
 }
 
 Shape* Shape::add_property(const std::string& key, PropertyAttributes attrs) {
-    // Check cache first
+    // Check cache first (transitions are per isolate; shapes themselves are immutable)
+    auto& transitions = Isolate::current().shape_transitions();
     std::pair<Shape*, std::string> cache_key = {this, key};
-    auto cache_it = Object::shape_transition_cache_.find(cache_key);
-    if (cache_it != Object::shape_transition_cache_.end()) {
+    auto cache_it = transitions.find(cache_key);
+    if (cache_it != transitions.end()) {
         return cache_it->second;
     }
     
@@ -1080,40 +1191,77 @@ Shape* Shape::add_property(const std::string& key, PropertyAttributes attrs) {
     Shape* new_shape = new Shape(this, key, attrs);
     
     // Cache the transition
-    Object::shape_transition_cache_[cache_key] = new_shape;
+    transitions[cache_key] = new_shape;
     
     return new_shape;
 }
 
+Shape* Shape::remove_property(const std::string& key) {
+    // Replay every other transition, in insertion order, from the base shape
+    std::vector<const Shape*> chain;
+    const Shape* base = this;
+    for (; base->parent_; base = base->parent_) {
+        chain.push_back(base);
+    }
+    
+    Shape* result = const_cast<Shape*>(base);
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        if ((*it)->transition_key_ != key) {
+            result = result->add_property((*it)->transition_key_, (*it)->transition_attrs_);
+        }
+    }
+    return result;
+}
+
+uint8_t Shape::symbol_key_bits(const std::string& key) {
+    if (!Symbol::is_property_key(key)) {
+        return 0;
+    }
+    if (key == Symbol::well_known_key(WellKnownSymbol::Iterator)) {
+        return SYMBOL_KEYS | ITERATOR_KEY;
+    }
+    if (key == Symbol::well_known_key(WellKnownSymbol::ToPrimitive)) {
+        return SYMBOL_KEYS | TO_PRIMITIVE_KEY;
+    }
+    return SYMBOL_KEYS;
+}
+
 std::vector<std::string> Shape::get_property_keys() const {
-    std::vector<std::string> keys;
-    keys.reserve(properties_.size());
+    bool has_symbols = symbol_key_bits_ & SYMBOL_KEYS;
     
     // To preserve insertion order, walk up the parent chain and collect keys in reverse
     std::vector<std::string> reverse_keys;
+    reverse_keys.reserve(property_count_);
     const Shape* current = this;
     
     while (current && current->parent_) {
-        if (!current->transition_key_.empty()) {
+        if (!current->transition_key_.empty() &&
+            !(has_symbols && Symbol::is_property_key(current->transition_key_))) {
             reverse_keys.push_back(current->transition_key_);
         }
         current = current->parent_;
     }
     
-    // Reverse to get insertion order
-    keys.reserve(reverse_keys.size());
-    for (auto it = reverse_keys.rbegin(); it != reverse_keys.rend(); ++it) {
-        keys.push_back(*it);
+    return std::vector<std::string>(reverse_keys.rbegin(), reverse_keys.rend());
+}
+
+std::vector<std::string> Shape::get_symbol_keys() const {
+    std::vector<std::string> reverse_keys;
+    
+    // Parents without symbol keys can hold none further up either
+    for (const Shape* current = this; current && (current->symbol_key_bits_ & SYMBOL_KEYS); current = current->parent_) {
+        if (Symbol::is_property_key(current->transition_key_)) {
+            reverse_keys.push_back(current->transition_key_);
+        }
     }
     
-    return keys;
+    return std::vector<std::string>(reverse_keys.rbegin(), reverse_keys.rend());
 }
 
 Shape* Shape::get_root_shape() {
-    if (!g_root_shape) {
-        g_root_shape = new Shape();
-    }
-    return g_root_shape;
+    // Shared by every isolate; it is never modified after construction
+    static Shape* root_shape = new Shape();
+    return root_shape;
 }
 
 //=============================================================================
@@ -1148,10 +1296,11 @@ namespace ObjectFactory {
 
 // optimized Memory Pool Optimization
 // Pre-allocated object pools for common types to reduce allocation overhead
-static std::vector<std::unique_ptr<Object>> object_pool_;
-static std::vector<std::unique_ptr<Object>> array_pool_;
-static size_t pool_size_ = 5000; // Ludicrous pool size for 5-7M ops/sec
-static bool pools_initialized_ = false;
+// (per thread, so engines running concurrently never share a pool)
+static thread_local std::vector<std::unique_ptr<Object>> object_pool_;
+static thread_local std::vector<std::unique_ptr<Object>> array_pool_;
+static const size_t pool_size_ = 5000; // Ludicrous pool size for 5-7M ops/sec
+static thread_local bool pools_initialized_ = false;
 
 // Initialize memory pools for optimized
 void initialize_memory_pools() {
@@ -1221,15 +1370,12 @@ void return_to_pool(std::unique_ptr<Object> obj) {
     // Otherwise, let unique_ptr destructor handle cleanup
 }
 
-// Static array prototype reference
-static Object* array_prototype_object = nullptr;
-
 void set_array_prototype(Object* prototype) {
-    array_prototype_object = prototype;
+    Isolate::current().prototypes().array = prototype;
 }
 
 Object* get_array_prototype() {
-    return array_prototype_object;
+    return Isolate::current().prototypes().array;
 }
 
 std::unique_ptr<Object> create_object(Object* prototype) {
@@ -1261,8 +1407,8 @@ std::unique_ptr<Object> create_array(uint32_t length) {
     array->set_length(length);
     
     // Set Array.prototype as prototype if available
-    if (array_prototype_object) {
-        array->set_prototype(array_prototype_object);
+    if (Object* array_prototype = get_array_prototype()) {
+        array->set_prototype(array_prototype);
     }
     
     return array;
@@ -1291,18 +1437,17 @@ std::unique_ptr<Object> create_boolean(bool value) {
     return bool_obj;
 }
 
-std::unique_ptr<Function> create_array_method(const std::string& method_name) {
-    // Create a native function that implements the array method
-    auto method_fn = [method_name](Context& ctx, const std::vector<Value>& args) -> Value {
-        // Get 'this' binding - should be the array
-        Object* array = ctx.get_this_binding();
-        
-        if (!array || !array->is_array()) {
-            ctx.throw_exception(Value("Array method called on non-array"));
-            return Value();
-        }
-        
-        if (method_name == "map") {
+Value call_array_builtin(ArrayBuiltin id, Context& ctx, const std::vector<Value>& args) {
+    // Get 'this' binding - should be the array
+    Object* array = ctx.get_this_binding();
+    
+    if (!array || !array->is_array()) {
+        ctx.throw_exception(Value("Array method called on non-array"));
+        return Value();
+    }
+    
+    switch (id) {
+        case ArrayBuiltin::Map: {
             if (args.size() > 0 && args[0].is_function()) {
                 auto result = array->map(args[0].as_function(), ctx);
                 // Always return a valid array, never null/undefined
@@ -1312,7 +1457,9 @@ std::unique_ptr<Function> create_array_method(const std::string& method_name) {
                 ctx.throw_exception(Value("TypeError: Array.map callback must be a function"));
                 return Value(ObjectFactory::create_array(0).release());
             }
-        } else if (method_name == "filter") {
+            break;
+        }
+        case ArrayBuiltin::Filter: {
             if (args.size() > 0 && args[0].is_function()) {
                 auto result = array->filter(args[0].as_function(), ctx);
                 // Always return a valid array, never null/undefined
@@ -1322,29 +1469,41 @@ std::unique_ptr<Function> create_array_method(const std::string& method_name) {
                 ctx.throw_exception(Value("TypeError: Array.filter callback must be a function"));
                 return Value(ObjectFactory::create_array(0).release());
             }
-        } else if (method_name == "reduce") {
+            break;
+        }
+        case ArrayBuiltin::Reduce: {
             if (args.size() > 0 && args[0].is_function()) {
                 Value initial = args.size() > 1 ? args[1] : Value();
                 return array->reduce(args[0].as_function(), initial, ctx);
             }
-        } else if (method_name == "forEach") {
+            break;
+        }
+        case ArrayBuiltin::ForEach: {
             if (args.size() > 0 && args[0].is_function()) {
                 array->forEach(args[0].as_function(), ctx);
                 return Value(); // undefined
             }
-        } else if (method_name == "indexOf") {
+            break;
+        }
+        case ArrayBuiltin::IndexOf: {
             if (args.size() > 0) {
                 Value search_element = args[0];
                 uint32_t length = array->get_length();
-                for (uint32_t i = 0; i < length; i++) {
+                uint32_t start = 0;
+                if (args.size() > 1) {
+                    double start_val = args[1].to_number();
+                    start = start_val < 0 ? std::max(0.0, length + start_val) : std::min(start_val, static_cast<double>(length));
+                }
+                for (uint32_t i = start; i < length; i++) {
                     Value element = array->get_element(i);
-                    if (element.to_string() == search_element.to_string()) {
+                    if (element.strict_equals(search_element)) {
                         return Value(static_cast<double>(i));
                     }
                 }
-                return Value(-1.0); // not found
             }
-        } else if (method_name == "slice") {
+            return Value(-1.0); // not found
+        }
+        case ArrayBuiltin::Slice: {
             uint32_t length = array->get_length();
             uint32_t start = 0;
             uint32_t end = length;
@@ -1363,14 +1522,17 @@ std::unique_ptr<Function> create_array_method(const std::string& method_name) {
                 result->push(array->get_element(i));
             }
             return Value(result.release());
-        } else if (method_name == "push") {
+        }
+        case ArrayBuiltin::Push: {
             for (const Value& arg : args) {
                 array->push(arg);
             }
             return Value(static_cast<double>(array->get_length()));
-        } else if (method_name == "pop") {
+        }
+        case ArrayBuiltin::Pop: {
             return array->pop();
-        } else if (method_name == "join") {
+        }
+        case ArrayBuiltin::Join: {
             std::string separator = ",";
             if (args.size() > 0) {
                 separator = args[0].to_string();
@@ -1380,17 +1542,23 @@ std::unique_ptr<Function> create_array_method(const std::string& method_name) {
             uint32_t length = array->get_length();
             for (uint32_t i = 0; i < length; i++) {
                 if (i > 0) result << separator;
-                result << array->get_element(i).to_string();
+                Value element = array->get_element(i);
+                if (!element.is_undefined() && !element.is_null()) {
+                    result << element.to_string();
+                }
             }
             return Value(result.str());
-        } else if (method_name == "groupBy") {
+        }
+        case ArrayBuiltin::GroupBy: {
             if (args.size() > 0 && args[0].is_function()) {
                 return array->groupBy(args[0].as_function(), ctx);
             } else {
                 ctx.throw_exception(Value("GroupBy requires a callback function"));
                 return Value();
             }
-        } else if (method_name == "reverse") {
+            break;
+        }
+        case ArrayBuiltin::Reverse: {
             // Reverse the array in place
             uint32_t length = array->get_length();
             for (uint32_t i = 0; i < length / 2; i++) {
@@ -1400,7 +1568,8 @@ std::unique_ptr<Function> create_array_method(const std::string& method_name) {
             }
             // Return the array itself
             return Value(array);
-        } else if (method_name == "sort") {
+        }
+        case ArrayBuiltin::Sort: {
             uint32_t length = array->get_length();
             std::vector<Value> elements;
 
@@ -1438,9 +1607,11 @@ std::unique_ptr<Function> create_array_method(const std::string& method_name) {
 
             // Return the array itself
             return Value(array);
-        } else if (method_name == "shift") {
+        }
+        case ArrayBuiltin::Shift: {
             return array->shift();
-        } else if (method_name == "unshift") {
+        }
+        case ArrayBuiltin::Unshift: {
             if (!args.empty()) {
                 uint32_t length = array->get_length();
                 uint32_t argCount = args.size();
@@ -1464,7 +1635,8 @@ std::unique_ptr<Function> create_array_method(const std::string& method_name) {
                 array->set_length(length + argCount);
             }
             return Value(static_cast<double>(array->get_length()));
-        } else if (method_name == "splice") {
+        }
+        case ArrayBuiltin::Splice: {
             uint32_t length = array->get_length();
             uint32_t start = 0;
             uint32_t deleteCount = length;
@@ -1515,7 +1687,8 @@ std::unique_ptr<Function> create_array_method(const std::string& method_name) {
             array->set_length(length - deleteCount + insertCount);
             
             return Value(deleted.release());
-        } else if (method_name == "find") {
+        }
+        case ArrayBuiltin::Find: {
             if (args.size() > 0 && args[0].is_function()) {
                 uint32_t length = array->get_length();
                 for (uint32_t i = 0; i < length; i++) {
@@ -1528,7 +1701,9 @@ std::unique_ptr<Function> create_array_method(const std::string& method_name) {
                 }
                 return Value(); // undefined
             }
-        } else if (method_name == "includes") {
+            break;
+        }
+        case ArrayBuiltin::Includes: {
             if (args.size() > 0) {
                 Value search_element = args[0];
                 uint32_t length = array->get_length();
@@ -1540,7 +1715,9 @@ std::unique_ptr<Function> create_array_method(const std::string& method_name) {
                 }
                 return Value(false);
             }
-        } else if (method_name == "some") {
+            break;
+        }
+        case ArrayBuiltin::Some: {
             if (args.size() > 0 && args[0].is_function()) {
                 uint32_t length = array->get_length();
                 for (uint32_t i = 0; i < length; i++) {
@@ -1553,7 +1730,9 @@ std::unique_ptr<Function> create_array_method(const std::string& method_name) {
                 }
                 return Value(false);
             }
-        } else if (method_name == "every") {
+            break;
+        }
+        case ArrayBuiltin::Every: {
             if (args.size() > 0 && args[0].is_function()) {
                 uint32_t length = array->get_length();
                 for (uint32_t i = 0; i < length; i++) {
@@ -1566,7 +1745,9 @@ std::unique_ptr<Function> create_array_method(const std::string& method_name) {
                 }
                 return Value(true);
             }
-        } else if (method_name == "findIndex") {
+            break;
+        }
+        case ArrayBuiltin::FindIndex: {
             if (args.size() > 0 && args[0].is_function()) {
                 uint32_t length = array->get_length();
                 for (uint32_t i = 0; i < length; i++) {
@@ -1579,7 +1760,9 @@ std::unique_ptr<Function> create_array_method(const std::string& method_name) {
                 }
                 return Value(-1.0); // not found
             }
-        } else if (method_name == "flat") {
+            break;
+        }
+        case ArrayBuiltin::Flat: {
             // Array.flat() - flatten array one level
             uint32_t length = array->get_length();
             auto result = ObjectFactory::create_array(0);
@@ -1607,12 +1790,52 @@ std::unique_ptr<Function> create_array_method(const std::string& method_name) {
             result->set_length(result_index);
             return Value(result.release());
         }
-        
-        ctx.throw_exception(Value("Invalid array method call"));
-        return Value();
-    };
+        case ArrayBuiltin::Concat: {
+            // Array arguments are spread one level, anything else is appended
+            auto result = ObjectFactory::create_array(0);
+            std::vector<Value> elements;
+            uint32_t length = array->get_length();
+            for (uint32_t i = 0; i < length; i++) {
+                elements.push_back(array->get_element(i));
+            }
+            for (const Value& arg : args) {
+                if (arg.is_object() && arg.as_object()->is_array()) {
+                    Object* other = arg.as_object();
+                    uint32_t other_length = other->get_length();
+                    for (uint32_t i = 0; i < other_length; i++) {
+                        elements.push_back(other->get_element(i));
+                    }
+                } else {
+                    elements.push_back(arg);
+                }
+            }
+            result->assign_elements(std::move(elements));
+            return Value(result.release());
+        }
+        case ArrayBuiltin::Count:
+            break;
+    }
     
-    return std::make_unique<Function>(method_name, method_fn);
+    ctx.throw_exception(Value("Invalid array method call"));
+    return Value();
+}
+
+const char* array_builtin_name(ArrayBuiltin id) {
+    static const char* const names[] = {
+        "map", "filter", "reduce", "forEach", "indexOf", "slice", "push", "pop",
+        "join", "groupBy", "reverse", "sort", "shift", "unshift", "splice", "find",
+        "includes", "some", "every", "findIndex", "flat", "concat"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(ArrayBuiltin::Count),
+                  "every ArrayBuiltin needs a name");
+    return names[static_cast<size_t>(id)];
+}
+
+std::unique_ptr<Function> create_array_method(ArrayBuiltin id) {
+    return std::make_unique<Function>(array_builtin_name(id),
+        [id](Context& ctx, const std::vector<Value>& args) -> Value {
+            return call_array_builtin(id, ctx, args);
+        });
 }
 
 std::unique_ptr<Object> create_error(const std::string& message) {
@@ -1627,10 +1850,6 @@ std::unique_ptr<Object> create_error(const std::string& message) {
 std::unique_ptr<Object> create_promise(Context* ctx) {
     // Create Promise using proper memory management
     auto promise_obj = std::make_unique<Promise>(ctx);
-
-    // Set up Promise methods immediately
-    Promise::setup_promise_methods(promise_obj.get());
-
     return std::unique_ptr<Object>(promise_obj.release());
 }
 
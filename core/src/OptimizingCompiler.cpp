@@ -0,0 +1,2189 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "../include/OptimizingCompiler.h"
+#include "../include/FeedbackVector.h"
+#include "../include/Object.h"
+#include "../include/Context.h"
+#include "../include/Engine.h"
+#include "../include/GC.h"
+#include "../include/Math.h"
+#include "../include/DataView.h"
+#include "../include/WebAPI.h"
+#include "../../parser/include/AST.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Quanta {
+
+struct OptimizingCompiler::Frame {
+    Value* slots;
+    uint32_t slot_count;
+    Context* ctx;           // caller's context: exceptions and calls out
+    Context* scope;         // resolves free variables through the closure environment
+    GarbageCollector* gc;
+    OptimizedCode* code;
+    Value return_value;
+    Frame* previous;
+    bool osr;               // entered mid-loop: scope is the interpreter's own context
+};
+
+namespace {
+
+using Frame = OptimizingCompiler::Frame;
+using Op = BinaryExpression::Operator;
+
+// Deoptimize leaves an OSR loop at a back edge after a failed guard
+enum class Flow : uint8_t { Normal, Return, Break, Continue, Throw, Deoptimize };
+
+//=============================================================================
+// Value helpers
+//=============================================================================
+
+inline Value number_value(double d) {
+    if (std::isnan(d)) return Value::nan();
+    if (std::isinf(d)) return d > 0 ? Value::positive_infinity() : Value::negative_infinity();
+    return Value(d);
+}
+
+inline bool to_int32(const Value& value, int32_t& out) {
+    if (!value.is_number()) return false;
+    double d = value.as_number();
+    if (!(d >= -2147483648.0 && d <= 2147483647.0)) return false;
+    int32_t i = static_cast<int32_t>(d);
+    if (static_cast<double>(i) != d || (i == 0 && std::signbit(d))) return false;
+    out = i;
+    return true;
+}
+
+inline bool to_array_index(const Value& value, uint32_t& out) {
+    if (!value.is_number()) return false;
+    double d = value.as_number();
+    if (!(d >= 0.0 && d < 4294967295.0)) return false;
+    uint32_t i = static_cast<uint32_t>(d);
+    if (static_cast<double>(i) != d) return false;
+    out = i;
+    return true;
+}
+
+inline bool truthy(const Value& value) {
+    return value.is_boolean() ? value.as_boolean() : value.to_boolean();
+}
+
+inline bool threw(Frame& f) { return f.ctx->has_exception(); }
+
+// Free variables are looked up in the function's scope context; errors
+// raised there belong to the caller
+inline void transfer_exception(Frame& f) {
+    if (f.scope != f.ctx && f.scope->has_exception()) {
+        f.ctx->throw_exception(f.scope->get_exception());
+        f.scope->clear_exception();
+    }
+}
+
+inline void deoptimize(Frame& f) { f.code->invalidate(); }
+
+
+//=============================================================================
+// Arithmetic
+//=============================================================================
+
+// Number arithmetic shared by every mode; results match the interpreter's
+// (modulo is std::fmod, so NaN, infinities and -0 follow the spec)
+bool number_arith(Op op, double l, double r, Value& out) {
+    switch (op) {
+        case Op::ADD: out = number_value(l + r); return true;
+        case Op::SUBTRACT: out = number_value(l - r); return true;
+        case Op::MULTIPLY: out = number_value(l * r); return true;
+        case Op::DIVIDE:
+            if (r == 0.0) {
+                out = l == 0.0 ? Value::nan() : (l > 0 ? Value::positive_infinity() : Value::negative_infinity());
+            } else {
+                out = number_value(l / r);
+            }
+            return true;
+        case Op::MODULO:
+            out = number_value(std::fmod(l, r));
+            return true;
+        case Op::LESS_THAN: out = Value(l < r); return true;
+        case Op::GREATER_THAN: out = Value(l > r); return true;
+        case Op::LESS_EQUAL: out = Value(!(l > r)); return true;
+        case Op::GREATER_EQUAL: out = Value(!(l < r)); return true;
+        case Op::EQUAL:
+        case Op::STRICT_EQUAL: out = Value(l == r); return true;
+        case Op::NOT_EQUAL:
+        case Op::STRICT_NOT_EQUAL: out = Value(l != r); return true;
+        default: return false;
+    }
+}
+
+// Int32 operands; false when the result leaves int32 (or is -0)
+bool int32_arith(Op op, int32_t a, int32_t b, Value& out) {
+    int64_t l = a, r = b, result;
+    switch (op) {
+        case Op::ADD: result = l + r; break;
+        case Op::SUBTRACT: result = l - r; break;
+        case Op::MULTIPLY:
+            result = l * r;
+            if (result == 0 && (l < 0 || r < 0)) return false;
+            break;
+        case Op::MODULO:
+            if (r == 0) return false;
+            result = l % r;
+            if (result == 0 && l < 0) return false;
+            break;
+        case Op::LESS_THAN: out = Value(a < b); return true;
+        case Op::GREATER_THAN: out = Value(a > b); return true;
+        case Op::LESS_EQUAL: out = Value(a <= b); return true;
+        case Op::GREATER_EQUAL: out = Value(a >= b); return true;
+        case Op::EQUAL:
+        case Op::STRICT_EQUAL: out = Value(a == b); return true;
+        case Op::NOT_EQUAL:
+        case Op::STRICT_NOT_EQUAL: out = Value(a != b); return true;
+        case Op::BITWISE_AND: out = Value(static_cast<double>(a & b)); return true;
+        case Op::BITWISE_OR: out = Value(static_cast<double>(a | b)); return true;
+        case Op::BITWISE_XOR: out = Value(static_cast<double>(a ^ b)); return true;
+        case Op::LEFT_SHIFT:
+            out = Value(static_cast<double>(static_cast<int32_t>(static_cast<uint32_t>(a) << (b & 31))));
+            return true;
+        case Op::RIGHT_SHIFT: out = Value(static_cast<double>(a >> (b & 31))); return true;
+        case Op::UNSIGNED_RIGHT_SHIFT:
+            out = Value(static_cast<double>(static_cast<uint32_t>(a) >> (b & 31)));
+            return true;
+        default: return false;
+    }
+    if (result < INT32_MIN || result > INT32_MAX) return false;
+    out = Value(static_cast<double>(result));
+    return true;
+}
+
+bool int32_speculable(Op op) {
+    switch (op) {
+        case Op::ADD: case Op::SUBTRACT: case Op::MULTIPLY: case Op::MODULO:
+        case Op::LESS_THAN: case Op::GREATER_THAN: case Op::LESS_EQUAL: case Op::GREATER_EQUAL:
+        case Op::EQUAL: case Op::STRICT_EQUAL: case Op::NOT_EQUAL: case Op::STRICT_NOT_EQUAL:
+        case Op::BITWISE_AND: case Op::BITWISE_OR: case Op::BITWISE_XOR:
+        case Op::LEFT_SHIFT: case Op::RIGHT_SHIFT: case Op::UNSIGNED_RIGHT_SHIFT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool number_speculable(Op op) {
+    switch (op) {
+        case Op::ADD: case Op::SUBTRACT: case Op::MULTIPLY: case Op::DIVIDE: case Op::MODULO:
+        case Op::LESS_THAN: case Op::GREATER_THAN: case Op::LESS_EQUAL: case Op::GREATER_EQUAL:
+        case Op::EQUAL: case Op::STRICT_EQUAL: case Op::NOT_EQUAL: case Op::STRICT_NOT_EQUAL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+Value generic_arith(Frame& f, Op op, const Value& l, const Value& r) {
+    if (l.is_number() && r.is_number()) {
+        Value out;
+        if (number_arith(op, l.as_number(), r.as_number(), out)) return out;
+    }
+    if (l.is_object() || r.is_object()) {
+        Value lp = l;
+        Value rp = r;
+        if (!BinaryExpression::to_primitive_operand(*f.ctx, op, lp) ||
+            !BinaryExpression::to_primitive_operand(*f.ctx, op, rp)) {
+            return Value();
+        }
+        if (lp.is_object() != l.is_object() || rp.is_object() != r.is_object()) return generic_arith(f, op, lp, rp);
+    }
+    switch (op) {
+        case Op::ADD: case Op::PLUS_ASSIGN: return l.add(r);
+        case Op::SUBTRACT: case Op::MINUS_ASSIGN: return l.subtract(r);
+        case Op::MULTIPLY: case Op::MULTIPLY_ASSIGN: return l.multiply(r);
+        case Op::DIVIDE: case Op::DIVIDE_ASSIGN: return l.divide(r);
+        case Op::MODULO: case Op::MODULO_ASSIGN: return l.modulo(r);
+        case Op::EXPONENT: return l.power(r);
+        case Op::EQUAL: return Value(l.loose_equals(r));
+        case Op::NOT_EQUAL: return Value(!l.loose_equals(r));
+        case Op::STRICT_EQUAL: return Value(l.strict_equals(r));
+        case Op::STRICT_NOT_EQUAL: return Value(!l.strict_equals(r));
+        case Op::LESS_THAN: return Value(l.compare(r) < 0);
+        case Op::GREATER_THAN: return Value(l.compare(r) > 0);
+        case Op::LESS_EQUAL: return Value(l.compare(r) <= 0);
+        case Op::GREATER_EQUAL: return Value(l.compare(r) >= 0);
+        case Op::INSTANCEOF: return Value(l.instanceof_check(r));
+        case Op::IN: {
+            std::string property_name = l.to_property_key();
+            if (!r.is_object()) {
+                f.ctx->throw_error("TypeError: Cannot use 'in' operator on non-object");
+                return Value(false);
+            }
+            return Value(r.as_object()->has_property(property_name));
+        }
+        case Op::BITWISE_AND: return l.bitwise_and(r);
+        case Op::BITWISE_OR: return l.bitwise_or(r);
+        case Op::BITWISE_XOR: return l.bitwise_xor(r);
+        case Op::LEFT_SHIFT: return l.left_shift(r);
+        case Op::RIGHT_SHIFT: return l.right_shift(r);
+        case Op::UNSIGNED_RIGHT_SHIFT: return l.unsigned_right_shift(r);
+        default:
+            f.ctx->throw_exception(Value("Unsupported binary operator"));
+            return Value();
+    }
+}
+
+Op arith_operator(Op op) {
+    switch (op) {
+        case Op::PLUS_ASSIGN: return Op::ADD;
+        case Op::MINUS_ASSIGN: return Op::SUBTRACT;
+        case Op::MULTIPLY_ASSIGN: return Op::MULTIPLY;
+        case Op::DIVIDE_ASSIGN: return Op::DIVIDE;
+        case Op::MODULO_ASSIGN: return Op::MODULO;
+        default: return op;
+    }
+}
+
+enum class Speculation : uint8_t { None, Int32, Number };
+
+// One binary operation specialized on its operand feedback
+struct Arith {
+    Op op = Op::ADD;
+    Speculation speculation = Speculation::None;
+    FeedbackVector* feedback = nullptr;
+    uint32_t site = ASTNode::NO_FEEDBACK_SLOT;
+
+    Value apply(Frame& f, const Value& l, const Value& r) const {
+        if (speculation == Speculation::Int32) {
+            int32_t a, b;
+            if (to_int32(l, a) && to_int32(r, b)) {
+                Value out;
+                if (int32_arith(op, a, b, out)) return out;
+                if (number_arith(op, a, b, out)) return out;
+            } else {
+                guard_failed(f, l, r);
+            }
+        } else if (speculation == Speculation::Number) {
+            if (l.is_number() && r.is_number()) {
+                Value out;
+                if (number_arith(op, l.as_number(), r.as_number(), out)) return out;
+            } else {
+                guard_failed(f, l, r);
+            }
+        }
+        return generic_arith(f, op, l, r);
+    }
+
+    // Comparisons used as conditions skip boxing the result
+    bool test(Frame& f, const Value& l, const Value& r) const {
+        if (speculation == Speculation::Int32) {
+            int32_t a, b;
+            if (to_int32(l, a) && to_int32(r, b)) {
+                switch (op) {
+                    case Op::LESS_THAN: return a < b;
+                    case Op::GREATER_THAN: return a > b;
+                    case Op::LESS_EQUAL: return a <= b;
+                    case Op::GREATER_EQUAL: return a >= b;
+                    case Op::EQUAL: case Op::STRICT_EQUAL: return a == b;
+                    case Op::NOT_EQUAL: case Op::STRICT_NOT_EQUAL: return a != b;
+                    default: break;
+                }
+            }
+        }
+        return truthy(apply(f, l, r));
+    }
+
+    void guard_failed(Frame& f, const Value& l, const Value& r) const {
+        if (feedback) feedback->record_binary_op(site, l, r);
+        deoptimize(f);
+    }
+};
+
+//=============================================================================
+// Compiled nodes
+//=============================================================================
+
+struct Expr {
+    virtual ~Expr() = default;
+    virtual Value eval(Frame& f) = 0;
+    virtual bool eval_test(Frame& f) { return truthy(eval(f)); }
+};
+
+struct Stmt {
+    virtual ~Stmt() = default;
+    virtual Flow exec(Frame& f) = 0;
+};
+
+using ExprPtr = std::unique_ptr<Expr>;
+using StmtPtr = std::unique_ptr<Stmt>;
+
+// Stands in for a compiled subexpression inside an AST node the tier hands
+// back to the interpreter
+class HoleNode : public ASTNode {
+private:
+    Value value_;
+
+public:
+    explicit HoleNode(const Position& position)
+        : ASTNode(Type::UNDEFINED_LITERAL, position, position) {}
+
+    void set(const Value& value) { value_ = value; }
+
+    Value evaluate(Context& ctx) override { (void)ctx; return value_; }
+    std::string to_string() const override { return "<compiled>"; }
+    std::unique_ptr<ASTNode> clone() const override {
+        auto node = std::make_unique<HoleNode>(start_);
+        node->value_ = value_;
+        return node;
+    }
+};
+
+struct Constant : Expr {
+    Value value;
+    explicit Constant(const Value& v) : value(v) {}
+    Value eval(Frame&) override { return value; }
+};
+
+struct LoadSlot : Expr {
+    uint32_t slot;
+    explicit LoadSlot(uint32_t s) : slot(s) {}
+    Value eval(Frame& f) override { return f.slots[slot]; }
+};
+
+struct LoadFree : Expr {
+    Identifier* id;
+    explicit LoadFree(Identifier* i) : id(i) {}
+    Value eval(Frame& f) override {
+        Value value = id->evaluate(*f.scope);
+        transfer_exception(f);
+        return value;
+    }
+};
+
+// An interpreter node whose children were compiled: they are evaluated here
+// and fed in through holes, then the node runs against the scope context
+struct Interpreted : Expr {
+    std::unique_ptr<ASTNode> node;
+    std::vector<HoleNode*> holes;
+    std::vector<ExprPtr> inputs;
+
+    Value eval(Frame& f) override {
+        std::vector<Value> values;
+        values.reserve(inputs.size());
+        for (auto& input : inputs) {
+            values.push_back(input->eval(f));
+            if (threw(f)) return Value();
+        }
+        for (size_t i = 0; i < holes.size(); ++i) {
+            holes[i]->set(values[i]);
+        }
+        Value result = node->evaluate(*f.scope);
+        transfer_exception(f);
+        return result;
+    }
+};
+
+struct Binary : Expr {
+    ExprPtr left, right;
+    Arith arith;
+    Value eval(Frame& f) override {
+        Value l = left->eval(f);
+        if (threw(f)) return Value();
+        Value r = right->eval(f);
+        if (threw(f)) return Value();
+        return arith.apply(f, l, r);
+    }
+    bool eval_test(Frame& f) override {
+        Value l = left->eval(f);
+        if (threw(f)) return false;
+        Value r = right->eval(f);
+        if (threw(f)) return false;
+        return arith.test(f, l, r);
+    }
+};
+
+struct Logical : Expr {
+    ExprPtr left, right;
+    Op op;
+    Value eval(Frame& f) override {
+        Value l = left->eval(f);
+        if (threw(f)) return Value();
+        if (op == Op::LOGICAL_AND && !truthy(l)) return l;
+        if (op == Op::LOGICAL_OR && truthy(l)) return l;
+        return right->eval(f);
+    }
+};
+
+struct Nullish : Expr {
+    ExprPtr left, right;
+    Value eval(Frame& f) override {
+        Value l = left->eval(f);
+        if (threw(f)) return Value();
+        if (!l.is_nullish()) return l;
+        return right->eval(f);
+    }
+};
+
+struct Conditional : Expr {
+    ExprPtr test, consequent, alternate;
+    Value eval(Frame& f) override {
+        bool condition = test->eval_test(f);
+        if (threw(f)) return Value();
+        return condition ? consequent->eval(f) : alternate->eval(f);
+    }
+};
+
+struct Unary : Expr {
+    ExprPtr operand;
+    UnaryExpression::Operator op;
+    Value eval(Frame& f) override {
+        Value value = operand->eval(f);
+        if (threw(f)) return Value();
+        switch (op) {
+            case UnaryExpression::Operator::PLUS: return value.unary_plus();
+            case UnaryExpression::Operator::MINUS: return value.unary_minus();
+            case UnaryExpression::Operator::LOGICAL_NOT: return Value(!truthy(value));
+            case UnaryExpression::Operator::BITWISE_NOT: return value.bitwise_not();
+            case UnaryExpression::Operator::TYPEOF: return value.typeof_op();
+            default: return Value();
+        }
+    }
+    bool eval_test(Frame& f) override {
+        if (op != UnaryExpression::Operator::LOGICAL_NOT) return truthy(eval(f));
+        bool value = operand->eval_test(f);
+        return !threw(f) && !value;
+    }
+};
+
+struct AssignSlot : Expr {
+    uint32_t slot;
+    ExprPtr value;
+    bool compound = false;
+    Arith arith;
+    Value eval(Frame& f) override {
+        Value r = value->eval(f);
+        if (threw(f)) return Value();
+        if (compound) {
+            r = arith.apply(f, f.slots[slot], r);
+            if (threw(f)) return Value();
+        }
+        f.slots[slot] = r;
+        return r;
+    }
+};
+
+struct AssignFree : Expr {
+    Identifier* id;
+    ExprPtr value;
+    bool compound = false;
+    Arith arith;
+    Value eval(Frame& f) override {
+        Value r = value->eval(f);
+        if (threw(f)) return Value();
+        const std::string& name = id->get_name();
+        if (compound) {
+            Value l = id->evaluate(*f.scope);
+            transfer_exception(f);
+            if (threw(f)) return Value();
+            r = arith.apply(f, l, r);
+            if (threw(f)) return Value();
+        } else if (!f.scope->has_binding(name)) {
+            if (f.scope->is_strict_mode()) {
+                f.ctx->throw_reference_error("'" + name + "' is not defined");
+                return Value();
+            }
+            // The interpreter binds the name in the activation's own
+            // scope, which only an OSR frame has
+            if (f.osr) {
+                f.scope->create_var_binding(name, r);
+            } else {
+                deoptimize(f);
+            }
+            return r;
+        }
+        f.scope->set_binding(name, r);
+        transfer_exception(f);
+        return r;
+    }
+};
+
+// Named or indexed access with the receiver and key already evaluated
+struct MemberAccess {
+    bool computed = false;
+    std::string name;
+
+    // Monomorphic property cache
+    Shape* shape = nullptr;
+    uint32_t offset = 0;
+    uint8_t receiver_type = 0;
+    // Packed array elements
+    bool packed = false;
+
+    FeedbackVector* feedback = nullptr;
+    uint32_t site = ASTNode::NO_FEEDBACK_SLOT;
+
+    // Interpreter fallback for primitive receivers
+    std::unique_ptr<MemberExpression> node;
+    HoleNode* object_hole = nullptr;
+    HoleNode* key_hole = nullptr;
+
+    std::string key_string(const Value& key) const { return computed ? key.to_property_key() : name; }
+
+    Value load(Frame& f, const Value& receiver, const Value& key) {
+        if (receiver.is_object()) {
+            Object* obj = receiver.as_object();
+            if (!computed) {
+                if (shape) {
+                    if (obj->get_shape() == shape && static_cast<uint8_t>(obj->get_type()) == receiver_type &&
+                        offset < obj->shape_slot_count()) {
+                        const Value& value = obj->get_shape_slot(offset);
+                        if (!value.is_undefined()) return value;
+                    } else {
+                        property_guard_failed(f, obj);
+                    }
+                }
+                return obj->get_property(name);
+            }
+            if (packed) {
+                uint32_t index;
+                if (obj->get_type() == Object::ObjectType::Array && to_array_index(key, index) &&
+                    index < obj->element_count()) {
+                    const Value& value = obj->get_element_slot(index);
+                    if (!value.is_undefined()) return value;
+                } else {
+                    element_guard_failed(f, obj, key);
+                }
+            }
+            return obj->get_property(key.to_property_key());
+        }
+        if (packed) {
+            if (feedback) feedback->record_element_generic(site);
+            deoptimize(f);
+        }
+        object_hole->set(receiver);
+        if (key_hole) key_hole->set(key);
+        Value result = node->evaluate(*f.scope);
+        transfer_exception(f);
+        return result;
+    }
+
+    void store(Frame& f, Object* obj, const Value& key, const Value& value) {
+        if (!computed && shape) {
+            if (obj->get_shape() == shape && static_cast<uint8_t>(obj->get_type()) == receiver_type &&
+                offset < obj->shape_slot_count() && !obj->has_descriptors()) {
+                obj->set_shape_slot(offset, value);
+                return;
+            }
+            property_guard_failed(f, obj);
+        } else if (computed && packed) {
+            uint32_t index;
+            if (obj->get_type() == Object::ObjectType::Array && to_array_index(key, index) &&
+                index < obj->element_count() && !obj->get_element_slot(index).is_undefined()) {
+                obj->set_element_slot(index, value);
+                return;
+            }
+            element_guard_failed(f, obj, key);
+        }
+        std::string property = key_string(key);
+        if (property == "cookie") {
+            PropertyDescriptor desc = obj->get_property_descriptor(property);
+            if (desc.is_accessor_descriptor() && desc.has_setter()) {
+                WebAPI::document_setCookie(*f.ctx, {value});
+                return;
+            }
+        }
+        obj->set_property(property, value);
+    }
+
+    void property_guard_failed(Frame& f, Object* obj) {
+        if (feedback) feedback->record_property(site, obj, name);
+        deoptimize(f);
+    }
+
+    void element_guard_failed(Frame& f, Object* obj, const Value& key) {
+        if (feedback) feedback->record_element(site, obj, key);
+        deoptimize(f);
+    }
+};
+
+struct MemberLoad : Expr {
+    ExprPtr object, key;
+    MemberAccess access;
+    Value eval(Frame& f) override {
+        Value receiver = object->eval(f);
+        if (threw(f)) return Value();
+        if (receiver.is_nullish()) {
+            f.ctx->throw_type_error("Cannot read property of null or undefined");
+            return Value();
+        }
+        Value key_value;
+        if (key) {
+            key_value = key->eval(f);
+            if (threw(f)) return Value();
+        }
+        return access.load(f, receiver, key_value);
+    }
+};
+
+struct AssignMember : Expr {
+    ExprPtr object, key, value;
+    MemberAccess access;
+    bool compound = false;
+    Arith arith;
+    Value eval(Frame& f) override {
+        Value r = value->eval(f);
+        if (threw(f)) return Value();
+        Value receiver = object->eval(f);
+        if (threw(f)) return Value();
+        Value key_value;
+        if (key) {
+            key_value = key->eval(f);
+            if (threw(f)) return Value();
+        }
+        if (compound) {
+            if (receiver.is_nullish()) {
+                f.ctx->throw_type_error("Cannot read property of null or undefined");
+                return Value();
+            }
+            Value l = access.load(f, receiver, key_value);
+            if (threw(f)) return Value();
+            r = arith.apply(f, l, r);
+            if (threw(f)) return Value();
+        }
+        if (!receiver.is_object_like()) {
+            f.ctx->throw_exception(Value("Cannot set property on non-object"));
+            return Value();
+        }
+        Object* obj = receiver.is_object() ? receiver.as_object() : receiver.as_function();
+        access.store(f, obj, key_value, r);
+        return r;
+    }
+};
+
+inline Value step(const Value& current, double delta) {
+    return number_value((current.is_number() ? current.as_number() : current.to_number()) + delta);
+}
+
+struct UpdateSlot : Expr {
+    uint32_t slot;
+    double delta;
+    bool prefix;
+    Value eval(Frame& f) override {
+        Value current = f.slots[slot];
+        int32_t i;
+        Value updated = to_int32(current, i) ? Value(static_cast<double>(i) + delta) : step(current, delta);
+        f.slots[slot] = updated;
+        return prefix ? updated : current;
+    }
+};
+
+struct UpdateFree : Expr {
+    std::string name;
+    double delta;
+    bool prefix;
+    Value eval(Frame& f) override {
+        Value current = f.scope->get_binding(name);
+        Value updated = step(current, delta);
+        f.scope->set_binding(name, updated);
+        transfer_exception(f);
+        return prefix ? updated : current;
+    }
+};
+
+struct UpdateMember : Expr {
+    ExprPtr object, key;
+    MemberAccess access;
+    double delta;
+    bool prefix;
+    Value eval(Frame& f) override {
+        Value receiver = object->eval(f);
+        if (threw(f)) return Value();
+        if (receiver.is_nullish()) {
+            f.ctx->throw_type_error("Cannot read property of null or undefined");
+            return Value();
+        }
+        Value key_value;
+        if (key) {
+            key_value = key->eval(f);
+            if (threw(f)) return Value();
+        }
+        Value current = access.load(f, receiver, key_value);
+        if (threw(f)) return Value();
+        if (!receiver.is_object()) {
+            f.ctx->throw_exception(Value("Cannot assign to property of non-object"));
+            return Value();
+        }
+        Value updated = step(current, delta);
+        access.store(f, receiver.as_object(), key_value, updated);
+        return prefix ? updated : current;
+    }
+};
+
+struct DeleteMember : Expr {
+    ExprPtr object, key;
+    std::string name;
+    Value eval(Frame& f) override {
+        Value receiver = object->eval(f);
+        if (threw(f)) return Value();
+        if (!receiver.is_object()) return Value(true);
+        std::string property = name;
+        if (key) {
+            Value key_value = key->eval(f);
+            if (threw(f)) return Value();
+            property = key_value.to_property_key();
+        }
+        return Value(receiver.as_object()->delete_property(property));
+    }
+};
+
+// A monomorphic callee compiled into its caller's frame
+struct Inlined {
+    Function* target = nullptr;
+    std::vector<uint32_t> params;
+    uint32_t this_slot = 0;
+    uint32_t first_slot = 0;
+    uint32_t end_slot = 0;
+    StmtPtr statements;
+    ExprPtr expression;
+
+    Value run(Frame& f, std::vector<ExprPtr>& args, const Value& this_value) {
+        // Arguments only read the caller's slots, never this region
+        for (uint32_t s = first_slot; s < end_slot; ++s) {
+            f.slots[s] = Value();
+        }
+        for (size_t i = 0; i < args.size(); ++i) {
+            Value arg = args[i]->eval(f);
+            if (threw(f)) return Value();
+            if (i < params.size()) f.slots[params[i]] = arg;
+        }
+        f.slots[this_slot] = this_value;
+        if (expression) {
+            return expression->eval(f);
+        }
+        Flow flow = statements->exec(f);
+        if (flow == Flow::Return) {
+            Value result = f.return_value;
+            f.return_value = Value();
+            return result;
+        }
+        return Value();
+    }
+};
+
+inline bool evaluate_arguments(Frame& f, std::vector<ExprPtr>& args, std::vector<Value>& out) {
+    out.reserve(args.size());
+    for (auto& arg : args) {
+        out.push_back(arg->eval(f));
+        if (threw(f)) return false;
+    }
+    return true;
+}
+
+struct Call : Expr {
+    ExprPtr callee;
+    std::string callee_name;
+    std::vector<ExprPtr> args;
+    Function* target = nullptr;     // speculated callee
+    std::unique_ptr<Inlined> inlined;
+    FeedbackVector* feedback = nullptr;
+    uint32_t site = ASTNode::NO_FEEDBACK_SLOT;
+
+    Value eval(Frame& f) override {
+        Value callee_value = callee->eval(f);
+        if (threw(f)) return Value();
+        if (!callee_value.is_function()) {
+            std::cout << "Error: '" << callee_name << "' is not a function" << std::endl;
+            return Value();
+        }
+        Function* function = callee_value.as_function();
+        if (target) {
+            if (function == target) {
+                if (inlined) return inlined->run(f, args, Value());
+            } else {
+                if (feedback) feedback->record_call(site, function);
+                deoptimize(f);
+            }
+        }
+        std::vector<Value> arg_values;
+        if (!evaluate_arguments(f, args, arg_values)) return Value();
+        return function->call(*f.ctx, arg_values);
+    }
+};
+
+struct MemberCall : Expr {
+    ExprPtr object, key;
+    std::string name;
+    std::vector<ExprPtr> args;
+    Function* target = nullptr;
+    std::unique_ptr<Inlined> inlined;
+    FeedbackVector* feedback = nullptr;
+    uint32_t site = ASTNode::NO_FEEDBACK_SLOT;
+
+    // Interpreter fallback for primitive receivers
+    std::unique_ptr<CallExpression> node;
+    HoleNode* object_hole = nullptr;
+    HoleNode* key_hole = nullptr;
+    std::vector<HoleNode*> arg_holes;
+
+    Value eval(Frame& f) override {
+        Value receiver = object->eval(f);
+        if (threw(f)) return Value();
+        if (receiver.is_nullish()) {
+            f.ctx->throw_type_error("Cannot read property of null or undefined");
+            return Value();
+        }
+        Value key_value;
+        if (key) {
+            key_value = key->eval(f);
+            if (threw(f)) return Value();
+        }
+        if (!receiver.is_object_like()) {
+            return call_primitive(f, receiver, key_value);
+        }
+        Object* obj = receiver.is_object() ? receiver.as_object() : receiver.as_function();
+        Value method_value = obj->get_property(key ? key_value.to_property_key() : name);
+        if (!method_value.is_function()) {
+            f.ctx->throw_exception(Value("Property is not a function"));
+            return Value();
+        }
+        Function* method = method_value.as_function();
+        if (obj->is_data_view() && args.size() <= 3) {
+            if (const DataView::Method* builtin = method->get_native_target<DataView::Method>()) {
+                return call_data_view(f, static_cast<DataView*>(obj), builtin->id);
+            }
+        }
+        if (target) {
+            if (method == target) {
+                if (inlined) return inlined->run(f, args, receiver);
+            } else {
+                if (feedback) feedback->record_call(site, method);
+                deoptimize(f);
+            }
+        }
+        std::vector<Value> arg_values;
+        if (!evaluate_arguments(f, args, arg_values)) return Value();
+        return method->call(*f.ctx, arg_values, receiver);
+    }
+
+    // DataView accessors take their arguments straight from the stack
+    Value call_data_view(Frame& f, DataView* view, DataViewBuiltin id) {
+        Value arg_values[3];
+        for (size_t i = 0; i < args.size(); ++i) {
+            arg_values[i] = args[i]->eval(f);
+            if (threw(f)) return Value();
+        }
+        return DataView::call_builtin(id, *f.ctx, view, arg_values, args.size());
+    }
+
+    Value call_primitive(Frame& f, const Value& receiver, const Value& key_value) {
+        std::vector<Value> arg_values;
+        if (!evaluate_arguments(f, args, arg_values)) return Value();
+        object_hole->set(receiver);
+        if (key_hole) key_hole->set(key_value);
+        for (size_t i = 0; i < arg_holes.size(); ++i) {
+            arg_holes[i]->set(arg_values[i]);
+        }
+        Value result = node->evaluate(*f.scope);
+        transfer_exception(f);
+        return result;
+    }
+};
+
+using MathFunction = Value (*)(Context&, const std::vector<Value>&);
+
+struct MathCall : Expr {
+    MathFunction function;
+    std::vector<ExprPtr> args;
+    Value eval(Frame& f) override {
+        std::vector<Value> arg_values;
+        if (!evaluate_arguments(f, args, arg_values)) return Value();
+        return function(*f.ctx, arg_values);
+    }
+};
+
+MathFunction math_function(const std::string& name) {
+    static const std::unordered_map<std::string, MathFunction> table = {
+        {"abs", &Math::abs}, {"sqrt", &Math::sqrt}, {"max", &Math::max}, {"min", &Math::min},
+        {"round", &Math::round}, {"floor", &Math::floor}, {"ceil", &Math::ceil}, {"pow", &Math::pow},
+        {"sin", &Math::sin}, {"cos", &Math::cos}, {"tan", &Math::tan}, {"log", &Math::log},
+        {"exp", &Math::exp}, {"random", &Math::random}
+    };
+    auto it = table.find(name);
+    return it != table.end() ? it->second : nullptr;
+}
+
+bool math_constant(const std::string& name, double& out) {
+    static const std::unordered_map<std::string, double> table = {
+        {"PI", Math::PI}, {"E", Math::E}, {"LN2", Math::LN2}, {"LN10", Math::LN10},
+        {"LOG2E", Math::LOG2E}, {"LOG10E", Math::LOG10E}, {"SQRT1_2", Math::SQRT1_2}, {"SQRT2", Math::SQRT2}
+    };
+    auto it = table.find(name);
+    if (it == table.end()) return false;
+    out = it->second;
+    return true;
+}
+
+//=============================================================================
+// Compiled statements
+//=============================================================================
+
+struct Block : Stmt {
+    std::vector<StmtPtr> statements;
+    Flow exec(Frame& f) override {
+        for (auto& statement : statements) {
+            HandleScope handle_scope(f.gc);
+            Flow flow = statement->exec(f);
+            if (flow != Flow::Normal) return flow;
+        }
+        return Flow::Normal;
+    }
+};
+
+struct ExpressionStmt : Stmt {
+    ExprPtr expression;
+    Flow exec(Frame& f) override {
+        expression->eval(f);
+        return threw(f) ? Flow::Throw : Flow::Normal;
+    }
+};
+
+struct If : Stmt {
+    ExprPtr test;
+    StmtPtr consequent, alternate;
+    Flow exec(Frame& f) override {
+        bool condition = test->eval_test(f);
+        if (threw(f)) return Flow::Throw;
+        if (condition) return consequent->exec(f);
+        return alternate ? alternate->exec(f) : Flow::Normal;
+    }
+};
+
+struct Loop : Stmt {
+    StmtPtr init;
+    ExprPtr test, update;
+    StmtPtr body;
+    bool test_first = true;     // false for do-while
+    bool osr_entry = false;     // root of OSR code: leaves at a back edge once invalidated
+
+    Flow exec(Frame& f) override {
+        if (init) {
+            Flow flow = init->exec(f);
+            if (flow != Flow::Normal) return flow;
+        }
+        bool first = true;
+        for (;;) {
+            HandleScope handle_scope(f.gc);
+            if (test && (test_first || !first)) {
+                bool condition = test->eval_test(f);
+                if (threw(f)) return Flow::Throw;
+                if (!condition) break;
+            }
+            first = false;
+            Flow flow = body->exec(f);
+            if (flow == Flow::Break) break;
+            if (flow == Flow::Return || flow == Flow::Throw) return flow;
+            if (update) {
+                update->eval(f);
+                if (threw(f)) return Flow::Throw;
+            }
+            if (osr_entry && f.code->is_invalidated()) return Flow::Deoptimize;
+        }
+        return Flow::Normal;
+    }
+};
+
+struct Return : Stmt {
+    ExprPtr value;
+    Flow exec(Frame& f) override {
+        Value result;
+        if (value) {
+            result = value->eval(f);
+            if (threw(f)) return Flow::Throw;
+        }
+        f.return_value = result;
+        return Flow::Return;
+    }
+};
+
+struct Jump : Stmt {
+    Flow flow;
+    explicit Jump(Flow fl) : flow(fl) {}
+    Flow exec(Frame&) override { return flow; }
+};
+
+struct Throw : Stmt {
+    ExprPtr value;
+    Flow exec(Frame& f) override {
+        Value exception = value->eval(f);
+        if (threw(f)) return Flow::Throw;
+        f.ctx->throw_exception(exception);
+        return Flow::Throw;
+    }
+};
+
+struct Empty : Stmt {
+    Flow exec(Frame&) override { return Flow::Normal; }
+};
+
+} // namespace
+
+//=============================================================================
+// OptimizedCode
+//=============================================================================
+
+struct OptimizedCode::Body {
+    Context* scope = nullptr;
+    std::unique_ptr<Context> closure_scope;     // owned scope for a function body
+    uint32_t slot_count = 0;
+    std::vector<uint32_t> params;
+    uint32_t this_slot = 0;
+    struct Captured {           // OSR: an outer binding held in a slot
+        std::string name;
+        uint32_t slot;
+        bool assigned;
+    };
+    std::vector<Captured> captured;
+    StmtPtr statements;
+    ExprPtr expression;         // expression-bodied arrow functions
+    std::vector<Function*> targets;
+};
+
+OptimizedCode::OptimizedCode(std::unique_ptr<Body> body)
+    : body_(std::move(body)), invalidated_(false) {}
+
+OptimizedCode::~OptimizedCode() = default;
+
+LoopOsrState::LoopOsrState() : next_attempt(OptimizingCompiler::OSR_THRESHOLD) {}
+LoopOsrState::~LoopOsrState() = default;
+
+void OptimizedCode::visit_references(GCVisitor& visitor) const {
+    for (Function* target : body_->targets) {
+        visitor.visit(static_cast<Object*>(target));
+    }
+}
+
+namespace {
+
+//=============================================================================
+// Body compiler
+//=============================================================================
+
+constexpr uint32_t MAX_INLINE_DEPTH = 2;
+constexpr uint32_t MAX_INLINE_NODES = 48;
+
+// Whether the interpreter's assignment to name in ctx would store
+bool is_mutable_binding(Context& ctx, const std::string& name) {
+    for (Environment* env = ctx.get_lexical_environment(); env; env = env->get_outer()) {
+        auto names = env->get_binding_names();
+        if (std::find(names.begin(), names.end(), name) != names.end()) {
+            return env->is_mutable_binding(name);
+        }
+    }
+    return true;
+}
+
+class BodyCompiler {
+public:
+    struct Local {
+        uint32_t slot;
+        bool is_const;
+    };
+
+    enum class Mode : uint8_t {
+        Function,       // a whole function body
+        Inline,         // a callee compiled into its caller
+        Loop            // a single loop, entered by on-stack replacement
+    };
+
+private:
+    OptimizedCode::Body& body_;
+    OptimizingCompiler::Stats& stats_;
+    Function* function_;        // null in Loop mode
+    FeedbackVector* feedback_;
+    Context* scope_;
+    std::vector<Function*>& inline_stack_;
+    Mode mode_;
+    // Loop mode: outer bindings are held in slots for the duration of the
+    // loop. Only done when the loop makes no calls, which could observe them.
+    bool promote_ = true;
+    bool saw_call_ = false;
+
+    std::vector<std::unordered_map<std::string, Local>> scopes_;
+    std::unordered_map<std::string, size_t> captured_index_;
+    std::vector<OptimizedCode::Body::Captured> captured_;
+    uint32_t this_slot_ = 0;
+    uint32_t loop_depth_ = 0;
+    uint32_t node_count_ = 0;
+    bool failed_ = false;
+
+public:
+    BodyCompiler(OptimizedCode::Body& body, OptimizingCompiler::Stats& stats, Function* function,
+                 FeedbackVector* feedback, Context* scope, std::vector<Function*>& inline_stack, Mode mode)
+        : body_(body), stats_(stats), function_(function), feedback_(feedback),
+          scope_(scope), inline_stack_(inline_stack), mode_(mode) {}
+
+    bool failed() const { return failed_; }
+    bool saw_call() const { return saw_call_; }
+    void disable_promotion() { promote_ = false; }
+    uint32_t this_slot() const { return this_slot_; }
+    const std::vector<OptimizedCode::Body::Captured>& captured() const { return captured_; }
+
+    // Sets up the function scope: parameters, `this`, hoisted vars
+    bool declare_function_scope(std::vector<uint32_t>& params) {
+        ASTNode* body = function_->get_body();
+        if (!body) return false;
+
+        scopes_.emplace_back();
+        auto& function_scope = scopes_.back();
+        for (const auto& param : function_->get_parameter_objects()) {
+            if (param->is_rest() || param->has_default()) return false;
+        }
+        for (const auto& name : function_->get_parameters()) {
+            if (function_scope.count(name) || name == "arguments") return false;
+            uint32_t slot = allocate_slot();
+            function_scope[name] = {slot, false};
+            params.push_back(slot);
+        }
+        this_slot_ = allocate_slot();
+
+        std::vector<std::string> vars;
+        if (!collect_vars(body, vars)) return false;
+        for (const auto& name : vars) {
+            if (!function_scope.count(name)) {
+                function_scope[name] = {allocate_slot(), false};
+            }
+        }
+        return true;
+    }
+
+    // Compiles a loop to be entered at its back edge: the for initializer
+    // has run, so its bindings are outer ones
+    StmtPtr compile_loop(ASTNode* loop) {
+        scopes_.emplace_back();
+        StmtPtr stmt = compile_loop_statement(loop, true);
+        return failed_ ? nullptr : std::move(stmt);
+    }
+
+    StmtPtr compile_body(ExprPtr& expression) {
+        ASTNode* body = function_->get_body();
+        if (body->get_type() == ASTNode::Type::BLOCK_STATEMENT) {
+            // The function scope is the body's own block scope
+            auto block = std::make_unique<Block>();
+            for (const auto& statement : static_cast<BlockStatement*>(body)->get_statements()) {
+                block->statements.push_back(compile_statement(statement.get()));
+            }
+            return block;
+        }
+        expression = compile_expression(body);
+        return nullptr;
+    }
+
+private:
+    uint32_t allocate_slot() { return body_.slot_count++; }
+
+    template <typename T>
+    T fail() {
+        failed_ = true;
+        return nullptr;
+    }
+
+    bool collect_vars(ASTNode* node, std::vector<std::string>& vars) {
+        if (!node) return true;
+        switch (node->get_type()) {
+            case ASTNode::Type::VARIABLE_DECLARATION: {
+                auto* declaration = static_cast<VariableDeclaration*>(node);
+                if (declaration->get_kind() != VariableDeclarator::Kind::VAR) return true;
+                for (const auto& declarator : declaration->get_declarations()) {
+                    if (!declarator->get_id() || declarator->get_id()->get_name().empty()) return false;
+                    vars.push_back(declarator->get_id()->get_name());
+                }
+                return true;
+            }
+            case ASTNode::Type::BLOCK_STATEMENT:
+                for (const auto& statement : static_cast<BlockStatement*>(node)->get_statements()) {
+                    if (!collect_vars(statement.get(), vars)) return false;
+                }
+                return true;
+            case ASTNode::Type::IF_STATEMENT: {
+                auto* if_stmt = static_cast<IfStatement*>(node);
+                return collect_vars(if_stmt->get_consequent(), vars) && collect_vars(if_stmt->get_alternate(), vars);
+            }
+            case ASTNode::Type::FOR_STATEMENT: {
+                auto* for_stmt = static_cast<ForStatement*>(node);
+                return collect_vars(for_stmt->get_init(), vars) && collect_vars(for_stmt->get_body(), vars);
+            }
+            case ASTNode::Type::WHILE_STATEMENT:
+                return collect_vars(static_cast<WhileStatement*>(node)->get_body(), vars);
+            case ASTNode::Type::DO_WHILE_STATEMENT:
+                return collect_vars(static_cast<DoWhileStatement*>(node)->get_body(), vars);
+            default:
+                return true;
+        }
+    }
+
+    const FeedbackVector::Slot* site(uint32_t index, FeedbackVector::SiteKind kind) const {
+        if (!feedback_ || !feedback_->has_slot(index, kind)) return nullptr;
+        return &feedback_->get_slot(index);
+    }
+
+    const Local* lookup(const std::string& name) const {
+        for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it) {
+            auto found = it->find(name);
+            if (found != it->end()) return &found->second;
+        }
+        return nullptr;
+    }
+
+    // Loop mode: the interpreter's bindings are transferred into slots on
+    // entry and back on exit; slot is allocated on first use. A function's
+    // free names stay in its closure environment, shared with other closures
+    const Local* captured_local(const std::string& name, bool assigned) {
+        if (mode_ != Mode::Loop) return nullptr;
+        if (!promote_ || reserved_name(name) || !scope_->has_binding(name)) return nullptr;
+        if (assigned && !is_mutable_binding(*scope_, name)) return fail<const Local*>();
+        auto it = captured_index_.find(name);
+        if (it == captured_index_.end()) {
+            uint32_t slot = allocate_slot();
+            captured_index_[name] = captured_.size();
+            captured_.push_back({name, slot, assigned});
+            scopes_.front()[name] = {slot, false};
+            return &scopes_.front()[name];
+        }
+        if (assigned) mark_assigned(it->second);
+        return &scopes_.front()[name];
+    }
+
+    void mark_assigned(size_t index) {
+        auto& captured = captured_[index];
+        if (captured.assigned) return;
+        if (!is_mutable_binding(*scope_, captured.name)) {
+            failed_ = true;
+            return;
+        }
+        captured.assigned = true;
+    }
+
+    const Local* resolve(const std::string& name, bool assigned) {
+        const Local* local = lookup(name);
+        if (local) {
+            auto it = captured_index_.find(name);
+            if (assigned && it != captured_index_.end() && local == &scopes_.front()[name]) {
+                mark_assigned(it->second);
+            }
+            return local;
+        }
+        return captured_local(name, assigned);
+    }
+
+    bool reserved_name(const std::string& name) const {
+        return name == "arguments" || name == "super" || name == "eval" || name == "__super__" ||
+               name == "console" || name == "Math";
+    }
+
+    Arith make_arith(Op op, uint32_t index) {
+        Arith arith;
+        arith.op = arith_operator(op);
+        arith.feedback = feedback_;
+        arith.site = index;
+        if (const auto* s = site(index, FeedbackVector::SiteKind::BinaryOp)) {
+            uint8_t l = s->left_types, r = s->right_types;
+            if (l == FeedbackVector::TYPE_INT32 && r == FeedbackVector::TYPE_INT32 && int32_speculable(arith.op)) {
+                arith.speculation = Speculation::Int32;
+            } else if (l && r && !(l & ~FeedbackVector::TYPE_NUMBER) && !(r & ~FeedbackVector::TYPE_NUMBER) &&
+                       number_speculable(arith.op)) {
+                arith.speculation = Speculation::Number;
+            }
+        }
+        return arith;
+    }
+
+    void setup_access(MemberAccess& access, MemberExpression* member, bool for_store) {
+        access.computed = member->is_computed();
+        access.feedback = feedback_;
+        access.site = member->get_feedback_slot();
+        if (!access.computed) {
+            access.name = static_cast<Identifier*>(member->get_property())->get_name();
+            const auto* s = site(access.site, FeedbackVector::SiteKind::Property);
+            if (s && s->state == FeedbackVector::CacheState::Monomorphic &&
+                (!for_store || s->receiver_type == static_cast<uint8_t>(Object::ObjectType::Ordinary))) {
+                access.shape = s->shape;
+                access.offset = s->offset;
+                access.receiver_type = s->receiver_type;
+            }
+        } else {
+            const auto* s = site(access.site, FeedbackVector::SiteKind::Element);
+            access.packed = s && s->element_kinds == FeedbackVector::ELEMENTS_PACKED;
+        }
+        auto object_hole = std::make_unique<HoleNode>(member->get_start());
+        access.object_hole = object_hole.get();
+        std::unique_ptr<ASTNode> property;
+        if (access.computed) {
+            auto key_hole = std::make_unique<HoleNode>(member->get_start());
+            access.key_hole = key_hole.get();
+            property = std::move(key_hole);
+        } else {
+            property = member->get_property()->clone();
+        }
+        access.node = std::make_unique<MemberExpression>(std::move(object_hole), std::move(property),
+                                                         access.computed, member->get_start(), member->get_end());
+    }
+
+    bool valid_member(MemberExpression* member) {
+        if (!member->is_computed() && member->get_property()->get_type() != ASTNode::Type::IDENTIFIER) return false;
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    // Statements
+    //-------------------------------------------------------------------------
+
+    StmtPtr compile_statement(ASTNode* node) {
+        if (failed_ || !node) return fail<StmtPtr>();
+        ++node_count_;
+        switch (node->get_type()) {
+            case ASTNode::Type::EXPRESSION_STATEMENT: {
+                auto stmt = std::make_unique<ExpressionStmt>();
+                stmt->expression = compile_expression(static_cast<ExpressionStatement*>(node)->get_expression());
+                return stmt;
+            }
+            case ASTNode::Type::VARIABLE_DECLARATION:
+                return compile_declaration(static_cast<VariableDeclaration*>(node));
+            case ASTNode::Type::BLOCK_STATEMENT: {
+                scopes_.emplace_back();
+                auto block = std::make_unique<Block>();
+                for (const auto& statement : static_cast<BlockStatement*>(node)->get_statements()) {
+                    block->statements.push_back(compile_statement(statement.get()));
+                }
+                scopes_.pop_back();
+                return block;
+            }
+            case ASTNode::Type::IF_STATEMENT: {
+                auto* if_node = static_cast<IfStatement*>(node);
+                auto stmt = std::make_unique<If>();
+                stmt->test = compile_expression(if_node->get_test());
+                stmt->consequent = compile_statement(if_node->get_consequent());
+                if (if_node->get_alternate()) stmt->alternate = compile_statement(if_node->get_alternate());
+                return stmt;
+            }
+            case ASTNode::Type::FOR_STATEMENT:
+            case ASTNode::Type::WHILE_STATEMENT:
+            case ASTNode::Type::DO_WHILE_STATEMENT:
+                return compile_loop_statement(node, false);
+            case ASTNode::Type::RETURN_STATEMENT: {
+                auto stmt = std::make_unique<Return>();
+                if (ASTNode* argument = static_cast<ReturnStatement*>(node)->get_argument()) {
+                    stmt->value = compile_expression(argument);
+                }
+                return stmt;
+            }
+            case ASTNode::Type::BREAK_STATEMENT:
+                if (loop_depth_ == 0) return fail<StmtPtr>();
+                return std::make_unique<Jump>(Flow::Break);
+            case ASTNode::Type::CONTINUE_STATEMENT:
+                if (loop_depth_ == 0) return fail<StmtPtr>();
+                return std::make_unique<Jump>(Flow::Continue);
+            case ASTNode::Type::THROW_STATEMENT: {
+                auto stmt = std::make_unique<Throw>();
+                stmt->value = compile_expression(static_cast<ThrowStatement*>(node)->get_expression());
+                return stmt;
+            }
+            default:
+                // try, switch, for-in/of, nested functions and classes, modules
+                return fail<StmtPtr>();
+        }
+    }
+
+    StmtPtr compile_loop_statement(ASTNode* node, bool osr_entry) {
+        auto loop = std::make_unique<Loop>();
+        loop->osr_entry = osr_entry;
+        ASTNode* body = nullptr;
+        switch (node->get_type()) {
+            case ASTNode::Type::FOR_STATEMENT: {
+                auto* for_node = static_cast<ForStatement*>(node);
+                scopes_.emplace_back();
+                ASTNode* init = for_node->get_init();
+                if (init && !osr_entry) {
+                    if (init->get_type() == ASTNode::Type::VARIABLE_DECLARATION) {
+                        loop->init = compile_declaration(static_cast<VariableDeclaration*>(init));
+                    } else {
+                        auto stmt = std::make_unique<ExpressionStmt>();
+                        stmt->expression = compile_expression(init);
+                        loop->init = std::move(stmt);
+                    }
+                }
+                if (for_node->get_test()) loop->test = compile_expression(for_node->get_test());
+                if (for_node->get_update()) loop->update = compile_expression(for_node->get_update());
+                ++loop_depth_;
+                loop->body = compile_statement(for_node->get_body());
+                --loop_depth_;
+                scopes_.pop_back();
+                return loop;
+            }
+            case ASTNode::Type::WHILE_STATEMENT: {
+                auto* while_node = static_cast<WhileStatement*>(node);
+                loop->test = compile_expression(while_node->get_test());
+                body = while_node->get_body();
+                break;
+            }
+            case ASTNode::Type::DO_WHILE_STATEMENT: {
+                auto* do_node = static_cast<DoWhileStatement*>(node);
+                loop->test = compile_expression(do_node->get_test());
+                loop->test_first = false;
+                body = do_node->get_body();
+                break;
+            }
+            default:
+                return fail<StmtPtr>();
+        }
+        ++loop_depth_;
+        loop->body = compile_statement(body);
+        --loop_depth_;
+        return loop;
+    }
+
+    StmtPtr compile_declaration(VariableDeclaration* declaration) {
+        auto block = std::make_unique<Block>();
+        bool is_var = declaration->get_kind() == VariableDeclarator::Kind::VAR;
+        bool is_const = declaration->get_kind() == VariableDeclarator::Kind::CONST;
+        for (const auto& declarator : declaration->get_declarations()) {
+            Identifier* id = declarator->get_id();
+            if (!id || id->get_name().empty() || reserved_name(id->get_name())) return fail<StmtPtr>();
+            const std::string& name = id->get_name();
+
+            ExprPtr init = declarator->get_init() ? compile_expression(declarator->get_init())
+                                                  : std::make_unique<Constant>(Value());
+            uint32_t slot;
+            if (is_var) {
+                const Local* local = resolve(name, true);
+                if (!local) {
+                    // Loop mode: the binding stays in the interpreter's scope
+                    if (mode_ != Mode::Loop || failed_) return fail<StmtPtr>();
+                    auto stmt = std::make_unique<ExpressionStmt>();
+                    auto assign = std::make_unique<AssignFree>();
+                    assign->id = id;
+                    assign->value = std::move(init);
+                    stmt->expression = std::move(assign);
+                    block->statements.push_back(std::move(stmt));
+                    continue;
+                }
+                slot = local->slot;
+            } else {
+                // A second let in the same scope, or one shadowing the
+                // function's own bindings, behaves differently in the interpreter
+                auto& current = scopes_.back();
+                if (current.count(name)) {
+                    return fail<StmtPtr>();
+                }
+                slot = allocate_slot();
+                current[name] = {slot, is_const};
+            }
+            auto stmt = std::make_unique<ExpressionStmt>();
+            auto assign = std::make_unique<AssignSlot>();
+            assign->slot = slot;
+            assign->value = std::move(init);
+            stmt->expression = std::move(assign);
+            block->statements.push_back(std::move(stmt));
+        }
+        return block;
+    }
+
+    //-------------------------------------------------------------------------
+    // Expressions
+    //-------------------------------------------------------------------------
+
+    ExprPtr compile_expression(ASTNode* node) {
+        if (failed_ || !node) return fail<ExprPtr>();
+        ++node_count_;
+        switch (node->get_type()) {
+            case ASTNode::Type::NUMBER_LITERAL:
+                return std::make_unique<Constant>(number_value(static_cast<NumberLiteral*>(node)->get_value()));
+            case ASTNode::Type::STRING_LITERAL:
+            case ASTNode::Type::BOOLEAN_LITERAL:
+            case ASTNode::Type::NULL_LITERAL:
+            case ASTNode::Type::UNDEFINED_LITERAL: {
+                // Literal evaluation does not depend on the context
+                return std::make_unique<Constant>(node->evaluate(*scope_));
+            }
+            case ASTNode::Type::BIGINT_LITERAL:
+            case ASTNode::Type::REGEX_LITERAL: {
+                auto interpreted = std::make_unique<Interpreted>();
+                interpreted->node = node->clone();
+                return interpreted;
+            }
+            case ASTNode::Type::IDENTIFIER:
+                return compile_identifier(static_cast<Identifier*>(node));
+            case ASTNode::Type::BINARY_EXPRESSION:
+                return compile_binary(static_cast<BinaryExpression*>(node));
+            case ASTNode::Type::UNARY_EXPRESSION:
+                return compile_unary(static_cast<UnaryExpression*>(node));
+            case ASTNode::Type::CONDITIONAL_EXPRESSION: {
+                auto* conditional = static_cast<ConditionalExpression*>(node);
+                auto expr = std::make_unique<Conditional>();
+                expr->test = compile_expression(conditional->get_test());
+                expr->consequent = compile_expression(conditional->get_consequent());
+                expr->alternate = compile_expression(conditional->get_alternate());
+                return expr;
+            }
+            case ASTNode::Type::NULLISH_COALESCING_EXPRESSION: {
+                auto* nullish = static_cast<NullishCoalescingExpression*>(node);
+                auto expr = std::make_unique<Nullish>();
+                expr->left = compile_expression(nullish->get_left());
+                expr->right = compile_expression(nullish->get_right());
+                return expr;
+            }
+            case ASTNode::Type::MEMBER_EXPRESSION:
+                return compile_member_load(static_cast<MemberExpression*>(node));
+            case ASTNode::Type::CALL_EXPRESSION:
+                return compile_call(static_cast<CallExpression*>(node));
+            case ASTNode::Type::NEW_EXPRESSION:
+            case ASTNode::Type::ARRAY_LITERAL:
+            case ASTNode::Type::OBJECT_LITERAL:
+            case ASTNode::Type::TEMPLATE_LITERAL:
+                return compile_interpreted(node);
+            default:
+                return fail<ExprPtr>();
+        }
+    }
+
+    ExprPtr compile_identifier(Identifier* id) {
+        const std::string& name = id->get_name();
+        if (name == "this" && mode_ != Mode::Loop) return std::make_unique<LoadSlot>(this_slot_);
+        if (reserved_name(name)) {
+            // Math and console are looked up by name; their members are
+            // handled where they are used
+            if (name == "Math" || name == "console") return std::make_unique<LoadFree>(id);
+            return fail<ExprPtr>();
+        }
+        if (const Local* local = resolve(name, false)) return std::make_unique<LoadSlot>(local->slot);
+        if (name == "undefined") return std::make_unique<Constant>(Value());
+        return std::make_unique<LoadFree>(id);
+    }
+
+    ExprPtr compile_binary(BinaryExpression* binary) {
+        Op op = binary->get_operator();
+        switch (op) {
+            case Op::ASSIGN: case Op::PLUS_ASSIGN: case Op::MINUS_ASSIGN:
+            case Op::MULTIPLY_ASSIGN: case Op::DIVIDE_ASSIGN: case Op::MODULO_ASSIGN:
+                return compile_assignment(binary);
+            case Op::LOGICAL_AND: case Op::LOGICAL_OR: {
+                auto expr = std::make_unique<Logical>();
+                expr->op = op;
+                expr->left = compile_expression(binary->get_left());
+                expr->right = compile_expression(binary->get_right());
+                return expr;
+            }
+            case Op::COMMA: {
+                auto expr = std::make_unique<Logical>();
+                expr->op = op;
+                expr->left = compile_expression(binary->get_left());
+                expr->right = compile_expression(binary->get_right());
+                return expr;
+            }
+            default: {
+                auto expr = std::make_unique<Binary>();
+                expr->left = compile_expression(binary->get_left());
+                expr->right = compile_expression(binary->get_right());
+                expr->arith = make_arith(op, binary->get_feedback_slot());
+                return expr;
+            }
+        }
+    }
+
+    ExprPtr compile_assignment(BinaryExpression* binary) {
+        Op op = binary->get_operator();
+        bool compound = op != Op::ASSIGN;
+        ASTNode* target = binary->get_left();
+        ExprPtr value = compile_expression(binary->get_right());
+        Arith arith = make_arith(op, binary->get_feedback_slot());
+
+        if (target->get_type() == ASTNode::Type::IDENTIFIER) {
+            auto* id = static_cast<Identifier*>(target);
+            const std::string& name = id->get_name();
+            if (name == "this" || reserved_name(name)) return fail<ExprPtr>();
+            if (const Local* local = resolve(name, true)) {
+                if (local->is_const) return fail<ExprPtr>();
+                auto expr = std::make_unique<AssignSlot>();
+                expr->slot = local->slot;
+                expr->value = std::move(value);
+                expr->compound = compound;
+                expr->arith = arith;
+                return expr;
+            }
+            auto expr = std::make_unique<AssignFree>();
+            expr->id = id;
+            expr->value = std::move(value);
+            expr->compound = compound;
+            expr->arith = arith;
+            return expr;
+        }
+        if (target->get_type() == ASTNode::Type::MEMBER_EXPRESSION) {
+            auto* member = static_cast<MemberExpression*>(target);
+            if (!valid_member(member)) return fail<ExprPtr>();
+            auto expr = std::make_unique<AssignMember>();
+            expr->object = compile_expression(member->get_object());
+            if (member->is_computed()) expr->key = compile_expression(member->get_property());
+            expr->value = std::move(value);
+            expr->compound = compound;
+            expr->arith = arith;
+            setup_access(expr->access, member, true);
+            return expr;
+        }
+        return fail<ExprPtr>();
+    }
+
+    ExprPtr compile_unary(UnaryExpression* unary) {
+        using UnaryOp = UnaryExpression::Operator;
+        UnaryOp op = unary->get_operator();
+        ASTNode* operand = unary->get_operand();
+        switch (op) {
+            case UnaryOp::PRE_INCREMENT: case UnaryOp::POST_INCREMENT:
+            case UnaryOp::PRE_DECREMENT: case UnaryOp::POST_DECREMENT: {
+                double delta = (op == UnaryOp::PRE_INCREMENT || op == UnaryOp::POST_INCREMENT) ? 1.0 : -1.0;
+                bool prefix = op == UnaryOp::PRE_INCREMENT || op == UnaryOp::PRE_DECREMENT;
+                if (operand->get_type() == ASTNode::Type::IDENTIFIER) {
+                    const std::string& name = static_cast<Identifier*>(operand)->get_name();
+                    if (name == "this" || reserved_name(name)) return fail<ExprPtr>();
+                    if (const Local* local = resolve(name, true)) {
+                        if (local->is_const) return fail<ExprPtr>();
+                        auto expr = std::make_unique<UpdateSlot>();
+                        expr->slot = local->slot;
+                        expr->delta = delta;
+                        expr->prefix = prefix;
+                        return expr;
+                    }
+                    auto expr = std::make_unique<UpdateFree>();
+                    expr->name = name;
+                    expr->delta = delta;
+                    expr->prefix = prefix;
+                    return expr;
+                }
+                if (operand->get_type() == ASTNode::Type::MEMBER_EXPRESSION) {
+                    auto* member = static_cast<MemberExpression*>(operand);
+                    if (!valid_member(member)) return fail<ExprPtr>();
+                    auto expr = std::make_unique<UpdateMember>();
+                    expr->object = compile_expression(member->get_object());
+                    if (member->is_computed()) expr->key = compile_expression(member->get_property());
+                    expr->delta = delta;
+                    expr->prefix = prefix;
+                    setup_access(expr->access, member, true);
+                    return expr;
+                }
+                return fail<ExprPtr>();
+            }
+            case UnaryOp::VOID: {
+                auto expr = std::make_unique<Logical>();
+                expr->op = Op::COMMA;
+                expr->left = compile_expression(operand);
+                expr->right = std::make_unique<Constant>(Value());
+                return expr;
+            }
+            case UnaryOp::DELETE: {
+                if (operand->get_type() != ASTNode::Type::MEMBER_EXPRESSION) {
+                    return std::make_unique<Constant>(Value(true));
+                }
+                auto* member = static_cast<MemberExpression*>(operand);
+                if (!valid_member(member)) return fail<ExprPtr>();
+                auto expr = std::make_unique<DeleteMember>();
+                expr->object = compile_expression(member->get_object());
+                if (member->is_computed()) {
+                    expr->key = compile_expression(member->get_property());
+                } else {
+                    expr->name = static_cast<Identifier*>(member->get_property())->get_name();
+                }
+                return expr;
+            }
+            default: {
+                auto expr = std::make_unique<Unary>();
+                expr->op = op;
+                expr->operand = compile_expression(operand);
+                return expr;
+            }
+        }
+    }
+
+    bool is_named_object(ASTNode* node, const char* name) {
+        return node->get_type() == ASTNode::Type::IDENTIFIER && static_cast<Identifier*>(node)->get_name() == name;
+    }
+
+    ExprPtr compile_member_load(MemberExpression* member) {
+        if (!valid_member(member)) return fail<ExprPtr>();
+        if (is_named_object(member->get_object(), "Math") && !member->is_computed()) {
+            // The interpreter's Math object only carries the constants
+            double constant;
+            const std::string& name = static_cast<Identifier*>(member->get_property())->get_name();
+            return std::make_unique<Constant>(math_constant(name, constant) ? Value(constant) : Value());
+        }
+        auto expr = std::make_unique<MemberLoad>();
+        expr->object = compile_expression(member->get_object());
+        if (member->is_computed()) expr->key = compile_expression(member->get_property());
+        setup_access(expr->access, member, false);
+        return expr;
+    }
+
+    ExprPtr compile_interpreted(ASTNode* node) {
+        auto interpreted = std::make_unique<Interpreted>();
+        auto hole_for = [&](ASTNode* child) -> std::unique_ptr<ASTNode> {
+            auto hole = std::make_unique<HoleNode>(child->get_start());
+            interpreted->holes.push_back(hole.get());
+            interpreted->inputs.push_back(compile_expression(child));
+            return hole;
+        };
+        auto holes_for = [&](const std::vector<std::unique_ptr<ASTNode>>& children,
+                             std::vector<std::unique_ptr<ASTNode>>& out) -> bool {
+            for (const auto& child : children) {
+                if (child->get_type() == ASTNode::Type::SPREAD_ELEMENT) return false;
+                out.push_back(hole_for(child.get()));
+            }
+            return true;
+        };
+
+        switch (node->get_type()) {
+            case ASTNode::Type::NEW_EXPRESSION: {
+                saw_call_ = true;
+                auto* new_expr = static_cast<NewExpression*>(node);
+                std::unique_ptr<ASTNode> constructor = hole_for(new_expr->get_constructor());
+                std::vector<std::unique_ptr<ASTNode>> args;
+                if (!holes_for(new_expr->get_arguments(), args)) return fail<ExprPtr>();
+                interpreted->node = std::make_unique<NewExpression>(std::move(constructor), std::move(args),
+                                                                    node->get_start(), node->get_end());
+                break;
+            }
+            case ASTNode::Type::ARRAY_LITERAL: {
+                std::vector<std::unique_ptr<ASTNode>> elements;
+                if (!holes_for(static_cast<ArrayLiteral*>(node)->get_elements(), elements)) return fail<ExprPtr>();
+                interpreted->node = std::make_unique<ArrayLiteral>(std::move(elements), node->get_start(), node->get_end());
+                break;
+            }
+            case ASTNode::Type::OBJECT_LITERAL: {
+                std::vector<std::unique_ptr<ObjectLiteral::Property>> properties;
+                for (const auto& prop : static_cast<ObjectLiteral*>(node)->get_properties()) {
+                    if (!prop->key || prop->computed || prop->method || !prop->value) return fail<ExprPtr>();
+                    ASTNode::Type value_type = prop->value->get_type();
+                    if (value_type == ASTNode::Type::SPREAD_ELEMENT) return fail<ExprPtr>();
+                    properties.push_back(std::make_unique<ObjectLiteral::Property>(
+                        prop->key->clone(), hole_for(prop->value.get()), false, false));
+                }
+                interpreted->node = std::make_unique<ObjectLiteral>(std::move(properties), node->get_start(), node->get_end());
+                break;
+            }
+            case ASTNode::Type::TEMPLATE_LITERAL: {
+                std::vector<TemplateLiteral::Element> elements;
+                for (const auto& element : static_cast<TemplateLiteral*>(node)->get_elements()) {
+                    if (element.type == TemplateLiteral::Element::Type::TEXT) {
+                        elements.emplace_back(element.text);
+                    } else {
+                        elements.emplace_back(hole_for(element.expression.get()));
+                    }
+                }
+                interpreted->node = std::make_unique<TemplateLiteral>(std::move(elements), node->get_start(), node->get_end());
+                break;
+            }
+            default:
+                return fail<ExprPtr>();
+        }
+        return interpreted;
+    }
+
+    std::vector<ExprPtr> compile_arguments(CallExpression* call) {
+        std::vector<ExprPtr> args;
+        for (const auto& arg : call->get_arguments()) {
+            if (arg->get_type() == ASTNode::Type::SPREAD_ELEMENT) {
+                failed_ = true;
+                break;
+            }
+            args.push_back(compile_expression(arg.get()));
+        }
+        return args;
+    }
+
+    ExprPtr compile_call(CallExpression* call) {
+        ASTNode* callee = call->get_callee();
+        const auto* call_site = site(call->get_feedback_slot(), FeedbackVector::SiteKind::Call);
+        // Loop code is not reachable from any function, so it could not keep
+        // a speculated target alive
+        Function* target = mode_ != Mode::Loop && call_site &&
+                           call_site->state == FeedbackVector::CacheState::Monomorphic ? call_site->target : nullptr;
+
+        if (callee->get_type() == ASTNode::Type::IDENTIFIER) {
+            auto* id = static_cast<Identifier*>(callee);
+            if (id->get_name() == "super" || id->get_name() == "eval") return fail<ExprPtr>();
+            saw_call_ = true;
+            auto expr = std::make_unique<Call>();
+            expr->callee = compile_identifier(id);
+            expr->callee_name = id->get_name();
+            expr->args = compile_arguments(call);
+            expr->feedback = feedback_;
+            expr->site = call->get_feedback_slot();
+            if (target && !failed_) {
+                expr->target = target;
+                body_.targets.push_back(target);
+                expr->inlined = try_inline(target, expr->args.size());
+            }
+            return expr;
+        }
+        if (callee->get_type() != ASTNode::Type::MEMBER_EXPRESSION) return fail<ExprPtr>();
+
+        auto* member = static_cast<MemberExpression*>(callee);
+        if (!valid_member(member)) return fail<ExprPtr>();
+        ASTNode* object = member->get_object();
+
+        if (is_named_object(object, "console")) {
+            // console methods are dispatched by name in the interpreter
+            auto interpreted = std::make_unique<Interpreted>();
+            std::vector<std::unique_ptr<ASTNode>> args;
+            for (const auto& arg : call->get_arguments()) {
+                if (arg->get_type() == ASTNode::Type::SPREAD_ELEMENT) return fail<ExprPtr>();
+                auto hole = std::make_unique<HoleNode>(arg->get_start());
+                interpreted->holes.push_back(hole.get());
+                interpreted->inputs.push_back(compile_expression(arg.get()));
+                args.push_back(std::move(hole));
+            }
+            if (member->is_computed()) return fail<ExprPtr>();
+            interpreted->node = std::make_unique<CallExpression>(member->clone(), std::move(args),
+                                                                 call->get_start(), call->get_end());
+            return interpreted;
+        }
+        if (is_named_object(object, "Math") && !member->is_computed()) {
+            const std::string& name = static_cast<Identifier*>(member->get_property())->get_name();
+            if (MathFunction function = math_function(name)) {
+                auto expr = std::make_unique<MathCall>();
+                expr->function = function;
+                expr->args = compile_arguments(call);
+                return expr;
+            }
+        }
+
+        saw_call_ = true;
+        auto expr = std::make_unique<MemberCall>();
+        expr->object = compile_expression(object);
+        if (member->is_computed()) {
+            expr->key = compile_expression(member->get_property());
+        } else {
+            expr->name = static_cast<Identifier*>(member->get_property())->get_name();
+        }
+        expr->args = compile_arguments(call);
+        expr->feedback = feedback_;
+        expr->site = call->get_feedback_slot();
+        if (failed_) return nullptr;
+
+        auto object_hole = std::make_unique<HoleNode>(member->get_start());
+        expr->object_hole = object_hole.get();
+        std::unique_ptr<ASTNode> property;
+        if (member->is_computed()) {
+            auto key_hole = std::make_unique<HoleNode>(member->get_start());
+            expr->key_hole = key_hole.get();
+            property = std::move(key_hole);
+        } else {
+            property = member->get_property()->clone();
+        }
+        std::vector<std::unique_ptr<ASTNode>> arg_holes;
+        for (const auto& arg : call->get_arguments()) {
+            auto hole = std::make_unique<HoleNode>(arg->get_start());
+            expr->arg_holes.push_back(hole.get());
+            arg_holes.push_back(std::move(hole));
+        }
+        auto callee_node = std::make_unique<MemberExpression>(std::move(object_hole), std::move(property),
+                                                              member->is_computed(), member->get_start(), member->get_end());
+        expr->node = std::make_unique<CallExpression>(std::move(callee_node), std::move(arg_holes),
+                                                      call->get_start(), call->get_end());
+
+        if (target) {
+            expr->target = target;
+            body_.targets.push_back(target);
+            expr->inlined = try_inline(target, expr->args.size());
+        }
+        return expr;
+    }
+
+    std::unique_ptr<Inlined> try_inline(Function* target, size_t arg_count);
+};
+
+std::unique_ptr<Inlined> BodyCompiler::try_inline(Function* target, size_t arg_count) {
+    (void)arg_count;
+    if (inline_stack_.size() > MAX_INLINE_DEPTH) return nullptr;
+    if (target->is_native() || typeid(*target) != typeid(Function)) return nullptr;
+    // The callee's free names resolve through the caller's scope context
+    if (target->get_closure_environment() != scope_->get_lexical_environment()) return nullptr;
+    if (!target->get_feedback_vector()) return nullptr;
+    if (target->has_property("__super_constructor__")) return nullptr;
+    for (Function* active : inline_stack_) {
+        if (active == target) return nullptr;
+    }
+
+    inline_stack_.push_back(target);
+    uint32_t first_slot = body_.slot_count;
+    auto inlined = std::make_unique<Inlined>();
+    BodyCompiler callee(body_, stats_, target, target->get_feedback_vector(), scope_, inline_stack_, Mode::Inline);
+    bool ok = callee.declare_function_scope(inlined->params);
+    if (ok) {
+        inlined->statements = callee.compile_body(inlined->expression);
+        ok = !callee.failed() && callee.node_count_ <= MAX_INLINE_NODES;
+    }
+    inline_stack_.pop_back();
+    if (!ok) return nullptr;
+
+    inlined->target = target;
+    inlined->this_slot = callee.this_slot();
+    inlined->first_slot = first_slot;
+    inlined->end_slot = body_.slot_count;
+    stats_.inlined_sites++;
+    return inlined;
+}
+
+} // namespace
+
+//=============================================================================
+// OptimizingCompiler
+//=============================================================================
+
+OptimizingCompiler::OptimizingCompiler(Engine* engine, uint32_t threshold)
+    : engine_(engine), threshold_(threshold ? threshold : 1), top_frame_(nullptr), frame_depth_(0) {}
+
+OptimizingCompiler::~OptimizingCompiler() = default;
+
+bool OptimizingCompiler::try_call(Function* function, Context& ctx, const std::vector<Value>& args,
+                                  const Value& this_value, Value& result) {
+    OptimizedCode* code = function->optimized_code_.get();
+    if (code && code->is_invalidated()) {
+        // A guard failed; the failure is already in the feedback. Code with a
+        // live activation is kept until that activation returns.
+        if (is_running(code)) return false;
+        function->optimized_code_.reset();
+        code = nullptr;
+        stats_.deoptimizations++;
+        if (++function->deopt_count_ >= MAX_DEOPTS) {
+            function->optimization_disabled_ = true;
+            return false;
+        }
+        function->next_tier_up_ = function->execution_count_ + threshold_;
+        return false;
+    }
+
+    if (!code) {
+        if (function->optimization_disabled_) return false;
+        if (!function->feedback_vector_) {
+            // Profiling starts with the second call
+            if (function->execution_count_ >= 1 && function->get_body()) {
+                function->feedback_vector_ = std::make_unique<FeedbackVector>(function->get_body());
+            }
+            return false;
+        }
+        if (function->next_tier_up_ == 0) function->next_tier_up_ = threshold_;
+        if (function->execution_count_ + 1 < function->next_tier_up_) return false;
+
+        function->optimized_code_ = compile(function);
+        code = function->optimized_code_.get();
+        if (!code) {
+            function->optimization_disabled_ = true;
+            stats_.ineligible++;
+            return false;
+        }
+        stats_.compilations++;
+    }
+
+    if (frame_depth_ >= MAX_FRAME_DEPTH || ctx.has_exception()) return false;
+    function->execution_count_++;
+    stats_.optimized_calls++;
+    result = execute(code, ctx, args, this_value);
+    return true;
+}
+
+std::unique_ptr<OptimizedCode> OptimizingCompiler::compile(Function* function) {
+    Context* global = engine_->get_global_context();
+    if (!global || !function->get_body()) return nullptr;
+    if (typeid(*function) != typeid(Function)) return nullptr;
+    if (function->has_property("__super_constructor__")) return nullptr;
+
+    // Free names resolve through the closure environment, which has to lead
+    // back to the global scope (a module's functions do not)
+    Environment* closure = function->closure_environment_;
+    Environment* env = closure;
+    while (env && env != global->get_variable_environment()) env = env->get_outer();
+    if (!env) return nullptr;
+
+    // The body gets a scope of its own, like the activation's outer scope in
+    // the interpreter. The function holds the environment, so this is no root.
+    auto body = std::make_unique<OptimizedCode::Body>();
+    body->closure_scope = ContextFactory::create_eval_context(engine_, global);
+    body->closure_scope->set_lexical_environment(closure);
+    body->closure_scope->set_this_binding(global->get_this_binding());
+    if (GarbageCollector* gc = engine_->get_garbage_collector()) {
+        gc->unregister_context(body->closure_scope.get());
+    }
+    Context* scope = body->closure_scope.get();
+    body->scope = scope;
+    std::vector<Function*> inline_stack{function};
+    BodyCompiler compiler(*body, stats_, function, function->get_feedback_vector(), scope, inline_stack,
+                          BodyCompiler::Mode::Function);
+    if (!compiler.declare_function_scope(body->params)) return nullptr;
+    body->statements = compiler.compile_body(body->expression);
+    if (compiler.failed()) return nullptr;
+    body->this_slot = compiler.this_slot();
+    return std::make_unique<OptimizedCode>(std::move(body));
+}
+
+Value OptimizingCompiler::execute(OptimizedCode* code, Context& ctx,
+                                  const std::vector<Value>& args, const Value& this_value) {
+    OptimizedCode::Body& body = *code->body_;
+
+    constexpr uint32_t INLINE_SLOTS = 16;
+    Value inline_slots[INLINE_SLOTS];
+    std::vector<Value> heap_slots;
+    Value* slots = inline_slots;
+    if (body.slot_count > INLINE_SLOTS) {
+        heap_slots.resize(body.slot_count);
+        slots = heap_slots.data();
+    }
+
+    for (size_t i = 0; i < body.params.size(); ++i) {
+        slots[body.params[i]] = i < args.size() ? args[i] : Value();
+    }
+    slots[body.this_slot] = this_value;
+
+    Frame frame{slots, body.slot_count, &ctx, body.scope, ctx.get_garbage_collector(), code, Value(), top_frame_, false};
+    top_frame_ = &frame;
+    frame_depth_++;
+
+    Flow flow = Flow::Normal;
+    Value completion;
+    if (body.expression) {
+        completion = body.expression->eval(frame);
+    } else {
+        flow = body.statements->exec(frame);
+    }
+
+    top_frame_ = frame.previous;
+    frame_depth_--;
+
+    if (ctx.has_exception()) return Value();
+    Value result = flow == Flow::Return ? frame.return_value : completion;
+    if (frame.gc) frame.gc->root_temporary(result);
+    return result;
+}
+
+std::unique_ptr<OptimizedCode> OptimizingCompiler::compile_loop(ASTNode* loop, Context& ctx) {
+    auto body = std::make_unique<OptimizedCode::Body>();
+    body->scope = &ctx;
+    std::vector<Function*> inline_stack;
+    BodyCompiler compiler(*body, stats_, nullptr, ctx.get_feedback_vector(), &ctx, inline_stack,
+                          BodyCompiler::Mode::Loop);
+    body->statements = compiler.compile_loop(loop);
+    if (compiler.failed()) return nullptr;
+
+    if (compiler.saw_call()) {
+        // Calls could read or write the outer bindings while they sit in slots
+        body = std::make_unique<OptimizedCode::Body>();
+        body->scope = &ctx;
+        BodyCompiler free_compiler(*body, stats_, nullptr, ctx.get_feedback_vector(), &ctx, inline_stack,
+                                   BodyCompiler::Mode::Loop);
+        free_compiler.disable_promotion();
+        body->statements = free_compiler.compile_loop(loop);
+        if (free_compiler.failed()) return nullptr;
+        body->captured = free_compiler.captured();
+    } else {
+        body->captured = compiler.captured();
+    }
+    return std::make_unique<OptimizedCode>(std::move(body));
+}
+
+OptimizingCompiler::OsrResult OptimizingCompiler::try_osr(ASTNode* loop, LoopOsrState& state, Context& ctx) {
+    OptimizedCode* code = state.code.get();
+    if (code && code->is_invalidated()) {
+        if (is_running(code)) return OsrResult::NotEntered;
+        state.code.reset();
+        code = nullptr;
+        stats_.deoptimizations++;
+        if (++state.deopt_count >= MAX_DEOPTS) {
+            state.disabled = true;
+            return OsrResult::NotEntered;
+        }
+        state.next_attempt = state.backedges + OSR_THRESHOLD;
+        return OsrResult::NotEntered;
+    }
+
+    if (!code) {
+        if (state.disabled || state.backedges < state.next_attempt) return OsrResult::NotEntered;
+        state.code = compile_loop(loop, ctx);
+        code = state.code.get();
+        if (!code) {
+            state.disabled = true;
+            stats_.ineligible++;
+            return OsrResult::NotEntered;
+        }
+        stats_.osr_compilations++;
+    }
+
+    if (frame_depth_ >= MAX_FRAME_DEPTH || ctx.has_exception()) return OsrResult::NotEntered;
+    OptimizedCode::Body& body = *code->body_;
+    // The loop may be entered from another activation than the one it was
+    // compiled in; its outer bindings must all be there
+    for (const auto& promoted : body.captured) {
+        if (!ctx.has_binding(promoted.name)) return OsrResult::NotEntered;
+    }
+
+    // Transfer the interpreter's state into the frame
+    std::vector<Value> slots(body.slot_count);
+    for (const auto& promoted : body.captured) {
+        slots[promoted.slot] = ctx.get_binding(promoted.name);
+    }
+    Frame frame{slots.data(), body.slot_count, &ctx, &ctx, ctx.get_garbage_collector(), code, Value(), top_frame_, true};
+    top_frame_ = &frame;
+    frame_depth_++;
+    stats_.osr_entries++;
+
+    Flow flow = body.statements->exec(frame);
+
+    // ... and back, whichever way the loop was left
+    for (const auto& promoted : body.captured) {
+        if (promoted.assigned) ctx.set_binding(promoted.name, slots[promoted.slot]);
+    }
+    top_frame_ = frame.previous;
+    frame_depth_--;
+
+    switch (flow) {
+        case Flow::Deoptimize:
+            return OsrResult::Resumed;
+        case Flow::Return:
+            ctx.set_return_value(frame.return_value);
+            return OsrResult::Exited;
+        default:
+            return OsrResult::Exited;
+    }
+}
+
+bool OptimizingCompiler::is_running(const OptimizedCode* code) const {
+    for (Frame* frame = top_frame_; frame; frame = frame->previous) {
+        if (frame->code == code) return true;
+    }
+    return false;
+}
+
+void OptimizingCompiler::visit_references(GCVisitor& visitor) const {
+    for (Frame* frame = top_frame_; frame; frame = frame->previous) {
+        for (uint32_t i = 0; i < frame->slot_count; ++i) {
+            visitor.visit(frame->slots[i]);
+        }
+        visitor.visit(frame->return_value);
+    }
+}
+
+std::string OptimizingCompiler::get_stats_string() const {
+    std::ostringstream oss;
+    oss << "JIT Stats: threshold=" << threshold_
+        << " compiled=" << stats_.compilations
+        << " ineligible=" << stats_.ineligible
+        << " deoptimized=" << stats_.deoptimizations
+        << " optimized_calls=" << stats_.optimized_calls
+        << " inlined_sites=" << stats_.inlined_sites
+        << " osr_compiled=" << stats_.osr_compilations
+        << " osr_entries=" << stats_.osr_entries;
+    return oss.str();
+}
+
+} // namespace Quanta
@@ -7,218 +7,408 @@
 #include "../include/Promise.h"
 #include "../include/Context.h"
 #include "../include/Async.h"
+#include "../include/Engine.h"
+#include "../include/Error.h"
+#include "../include/Isolate.h"
 #include "../include/Object.h"  // For ObjectFactory
 #include "../../parser/include/AST.h"
 #include <iostream>
 
 namespace Quanta {
 
+//=============================================================================
+// PromiseReaction Implementation
+//=============================================================================
+
+namespace {
+
+// Retired records kept per thread; a chain reuses the same few
+const size_t MAX_FREE_REACTIONS = 1024;
+thread_local PromiseReaction* free_reactions = nullptr;
+thread_local size_t free_reaction_count = 0;
+
+} // anonymous namespace
+
+PromiseReaction* PromiseReaction::acquire() {
+    PromiseReaction* reaction = free_reactions;
+    if (!reaction) {
+        return new PromiseReaction();
+    }
+    free_reactions = reaction->next;
+    --free_reaction_count;
+    reaction->next = nullptr;
+    return reaction;
+}
+
+void PromiseReaction::release(PromiseReaction* reaction) {
+    if (free_reaction_count >= MAX_FREE_REACTIONS) {
+        delete reaction;
+        return;
+    }
+    *reaction = PromiseReaction();
+    reaction->next = free_reactions;
+    free_reactions = reaction;
+    ++free_reaction_count;
+}
+
+void PromiseReaction::run() {
+    if (awaiting) {
+        awaiting->resume(type == Type::Fulfill, argument);
+        return;
+    }
+    Function* handler = type == Type::Fulfill ? on_fulfilled : on_rejected;
+    if (!handler) {
+        // No handler for this outcome: pass the settlement through
+        if (derived) {
+            derived->settle(type == Type::Fulfill ? PromiseState::FULFILLED : PromiseState::REJECTED, argument);
+        }
+        return;
+    }
+    if (!context) {
+        if (derived) derived->reject(Value("No execution context for callback"));
+        return;
+    }
+
+    Value result;
+    bool threw = false;
+    try {
+        std::vector<Value> args = {argument};
+        result = handler->call(*context, args);
+        if (context->has_exception()) {
+            threw = true;
+            result = context->get_exception();
+            context->clear_exception();
+        }
+    } catch (const std::exception& e) {
+        threw = true;
+        result = Value(std::string(e.what()));
+    }
+
+    if (!derived) return;
+    if (threw) {
+        derived->reject(result);
+    } else {
+        derived->resolve(result);
+    }
+}
+
+void PromiseReaction::visit_references(GCVisitor& visitor) const {
+    visitor.visit(on_fulfilled);
+    visitor.visit(on_rejected);
+    visitor.visit(derived);
+    visitor.visit(awaiting);
+    visitor.visit(argument);
+}
+
+//=============================================================================
+// Promise Implementation
+//=============================================================================
+
+Promise::Promise(Context* ctx)
+    : Object(ObjectType::Promise), state_(PromiseState::PENDING), reactions_head_(nullptr),
+      reactions_tail_(nullptr), following_(false), context_(ctx) {
+    if (Object* prototype = Isolate::current().prototypes().promise) {
+        set_prototype(prototype);
+    }
+}
+
+Promise::~Promise() {
+    while (reactions_head_) {
+        PromiseReaction* next = reactions_head_->next;
+        PromiseReaction::release(reactions_head_);
+        reactions_head_ = next;
+    }
+    // Don't delete context_ as it's not owned by Promise
+    context_ = nullptr;
+}
+
 void Promise::fulfill(const Value& value) {
-    if (state_ != PromiseState::PENDING) return;
-    
-    state_ = PromiseState::FULFILLED;
-    value_ = value;
-    execute_handlers();
+    if (following_) return;
+    settle(PromiseState::FULFILLED, value);
 }
 
 void Promise::reject(const Value& reason) {
-    if (state_ != PromiseState::PENDING) return;
-    
-    state_ = PromiseState::REJECTED;
-    value_ = reason;
-    execute_handlers();
+    if (following_) return;
+    settle(PromiseState::REJECTED, reason);
 }
 
-Promise* Promise::then(Function* on_fulfilled, Function* on_rejected) {
-    // Create new promise with safer initialization using ObjectFactory
-    Promise* new_promise = nullptr;
-    try {
-        auto promise_obj = ObjectFactory::create_promise(context_);
-        new_promise = static_cast<Promise*>(promise_obj.release());
-    } catch (...) {
-        // If setup fails, clean up and return nullptr
-        return nullptr;
+void Promise::resolve(const Value& resolution) {
+    if (following_) return;
+    adopt(resolution);
+}
+
+void Promise::settle(PromiseState state, const Value& value) {
+    if (state_ != PromiseState::PENDING) return;
+
+    state_ = state;
+    value_ = value;
+    following_ = false;
+
+    // Each waiting reaction becomes a job, in registration order
+    PromiseReaction::Type type = state == PromiseState::FULFILLED
+        ? PromiseReaction::Type::Fulfill : PromiseReaction::Type::Reject;
+    EventLoop& event_loop = EventLoop::instance();
+    PromiseReaction* reaction = reactions_head_;
+    reactions_head_ = reactions_tail_ = nullptr;
+    while (reaction) {
+        PromiseReaction* next = reaction->next;
+        reaction->next = nullptr;
+        reaction->type = type;
+        reaction->argument = value_;
+        event_loop.schedule_reaction(reaction);
+        reaction = next;
     }
-    
-    if (state_ == PromiseState::FULFILLED) {
-        if (on_fulfilled) {
-            // Execute callback immediately if already fulfilled - avoid async issues
-            try {
-                if (context_) {
-                    std::vector<Value> args = {value_};
-                    Value result = on_fulfilled->call(*context_, args);
-                    
-                    // Properly initialize the new promise before fulfilling
-                    new_promise->state_ = PromiseState::PENDING;
-                    new_promise->value_ = Value();  // Reset value
-                    new_promise->fulfill(result);
-                } else {
-                    new_promise->state_ = PromiseState::PENDING;
-                    new_promise->reject(Value("No execution context for callback"));
-                }
-            } catch (...) {
-                new_promise->state_ = PromiseState::PENDING;
-                new_promise->reject(Value("Handler execution failed"));
-            }
-        } else {
-            new_promise->fulfill(value_);
+}
+
+void Promise::adopt(const Value& resolution) {
+    if (state_ != PromiseState::PENDING) return;
+
+    if (resolution.is_object() || resolution.is_function()) {
+        Object* obj = resolution.is_function() ? resolution.as_function() : resolution.as_object();
+        if (obj == this) {
+            settle(PromiseState::REJECTED, Value(Error::create_type_error("Chaining cycle detected for promise").release()));
+            return;
         }
-    } else if (state_ == PromiseState::REJECTED) {
-        if (on_rejected) {
-            // Execute rejection handler immediately if already rejected
-            try {
-                if (context_) {
-                    std::vector<Value> args = {value_};
-                    Value result = on_rejected->call(*context_, args);
-                    
-                    // Properly initialize the new promise before fulfilling
-                    new_promise->state_ = PromiseState::PENDING;
-                    new_promise->value_ = Value();  // Reset value
-                    new_promise->fulfill(result);  // Rejection handler fulfills the new promise
-                } else {
-                    new_promise->state_ = PromiseState::PENDING;
-                    new_promise->reject(Value("No execution context for callback"));
-                }
-            } catch (...) {
-                new_promise->state_ = PromiseState::PENDING;
-                new_promise->reject(value_);  // Re-reject with original reason
-            }
-        } else {
-            new_promise->reject(value_);
+
+        if (obj->get_type() == ObjectType::Promise) {
+            // A native promise is followed without looking up its then, but
+            // still one job later, as the resolve-thenable job would
+            following_ = true;
+            Promise* followed = static_cast<Promise*>(obj);
+            EventLoop::instance().schedule_microtask([this, followed]() {
+                PromiseReaction* reaction = PromiseReaction::acquire();
+                reaction->derived = this;
+                followed->add_reaction(reaction);
+            });
+            return;
         }
-    } else {
-        // Promise is pending, store handlers
-        if (on_fulfilled) {
-            fulfillment_handlers_.push_back(on_fulfilled);
+
+        Value then_method = obj->get_property("then");
+        if (then_method.is_function()) {
+            following_ = true;
+            Function* then_fn = then_method.as_function();
+            Context* ctx = job_context(context_);
+            EventLoop::instance().schedule_microtask([this, resolution, then_fn, ctx]() {
+                if (!ctx) {
+                    settle(PromiseState::REJECTED, Value("No execution context for callback"));
+                    return;
+                }
+
+                // A fresh pair of resolving functions: only the first call counts
+                auto called = std::make_shared<bool>(false);
+                auto resolve_fn = ObjectFactory::create_native_function("resolve",
+                    [this, called](Context& ctx, const std::vector<Value>& args) -> Value {
+                        (void)ctx;
+                        if (*called) return Value();
+                        *called = true;
+                        adopt(args.empty() ? Value() : args[0]);
+                        return Value();
+                    });
+                auto reject_fn = ObjectFactory::create_native_function("reject",
+                    [this, called](Context& ctx, const std::vector<Value>& args) -> Value {
+                        (void)ctx;
+                        if (*called) return Value();
+                        *called = true;
+                        settle(PromiseState::REJECTED, args.empty() ? Value() : args[0]);
+                        return Value();
+                    });
+
+                std::vector<Value> then_args = {Value(resolve_fn.release()), Value(reject_fn.release())};
+                then_fn->call(*ctx, then_args, resolution);
+                if (ctx->has_exception()) {
+                    Value error = ctx->get_exception();
+                    ctx->clear_exception();
+                    if (!*called) {
+                        *called = true;
+                        settle(PromiseState::REJECTED, error);
+                    }
+                }
+            });
+            return;
         }
-        if (on_rejected) {
-            rejection_handlers_.push_back(on_rejected);
+    }
+
+    settle(PromiseState::FULFILLED, resolution);
+}
+
+Context* Promise::job_context(Context* ctx) const {
+    // Jobs run after the calling function returned, so never in its context
+    if (!ctx) ctx = context_;
+    if (ctx && ctx->get_engine() && ctx->get_engine()->get_global_context()) {
+        return ctx->get_engine()->get_global_context();
+    }
+    return ctx;
+}
+
+void Promise::add_reaction(PromiseReaction* reaction) {
+    if (!reaction->context) {
+        reaction->context = job_context(nullptr);
+    }
+
+    if (state_ == PromiseState::PENDING) {
+        if (reactions_tail_) {
+            reactions_tail_->next = reaction;
+        } else {
+            reactions_head_ = reaction;
         }
+        reactions_tail_ = reaction;
+        return;
     }
-    
-    return new_promise;
+
+    reaction->type = state_ == PromiseState::FULFILLED
+        ? PromiseReaction::Type::Fulfill : PromiseReaction::Type::Reject;
+    reaction->argument = value_;
+    EventLoop::instance().schedule_reaction(reaction);
 }
 
-Promise* Promise::catch_method(Function* on_rejected) {
-    return then(nullptr, on_rejected);
+Promise* Promise::then(Function* on_fulfilled, Function* on_rejected, Context* ctx) {
+    Context* context = job_context(ctx);
+    auto derived = ObjectFactory::create_promise(context);
+
+    PromiseReaction* reaction = PromiseReaction::acquire();
+    reaction->on_fulfilled = on_fulfilled;
+    reaction->on_rejected = on_rejected;
+    reaction->derived = static_cast<Promise*>(derived.get());
+    reaction->context = context;
+    add_reaction(reaction);
+
+    return static_cast<Promise*>(derived.release());
 }
 
-Promise* Promise::finally_method(Function* on_finally) {
-    // Simplified implementation - just execute the finally handler
-    return then(on_finally, on_finally);
+Promise* Promise::catch_method(Function* on_rejected, Context* ctx) {
+    return then(nullptr, on_rejected, ctx);
 }
 
-Promise* Promise::resolve(const Value& value) {
-    // Use ObjectFactory for proper memory management
-    auto promise_obj = ObjectFactory::create_promise(nullptr);
+Promise* Promise::finally_method(Function* on_finally, Context* ctx) {
+    if (!on_finally) {
+        return then(nullptr, nullptr, ctx);
+    }
+
+    // The callback sees no argument; the settlement passes through unless it throws
+    auto then_finally = ObjectFactory::create_native_function("",
+        [on_finally](Context& ctx, const std::vector<Value>& args) -> Value {
+            on_finally->call(ctx, {});
+            if (ctx.has_exception()) return Value();
+            return args.empty() ? Value() : args[0];
+        });
+    auto catch_finally = ObjectFactory::create_native_function("",
+        [on_finally](Context& ctx, const std::vector<Value>& args) -> Value {
+            on_finally->call(ctx, {});
+            if (ctx.has_exception()) return Value();
+            ctx.throw_exception(args.empty() ? Value() : args[0]);
+            return Value();
+        });
+    return then(then_finally.release(), catch_finally.release(), ctx);
+}
+
+Promise* Promise::resolve_static(const Value& value, Context* ctx) {
+    if (value.is_object() && value.as_object()->get_type() == ObjectType::Promise) {
+        return static_cast<Promise*>(value.as_object());
+    }
+    auto promise_obj = ObjectFactory::create_promise(ctx);
     auto* promise = static_cast<Promise*>(promise_obj.release());
-    promise->fulfill(value);
+    promise->resolve(value);
     return promise;
 }
 
-Promise* Promise::reject_static(const Value& reason) {
-    // Use ObjectFactory for proper memory management
-    auto promise_obj = ObjectFactory::create_promise(nullptr);
+Promise* Promise::reject_static(const Value& reason, Context* ctx) {
+    auto promise_obj = ObjectFactory::create_promise(ctx);
     auto* promise = static_cast<Promise*>(promise_obj.release());
     promise->reject(reason);
     return promise;
 }
 
-Promise* Promise::all(const std::vector<Promise*>& promises) {
-    auto promise_obj = ObjectFactory::create_promise(nullptr);
-    auto* result_promise = static_cast<Promise*>(promise_obj.release());
-    
-    if (promises.empty()) {
-        result_promise->fulfill(Value("empty_array"));
-        return result_promise;
+Promise* Promise::all(Context& ctx, const std::vector<Value>& values) {
+    auto result_obj = ObjectFactory::create_promise(&ctx);
+    auto* result = static_cast<Promise*>(result_obj.release());
+    Object* results = ObjectFactory::create_array(static_cast<uint32_t>(values.size())).release();
+
+    if (values.empty()) {
+        result->fulfill(Value(results));
+        return result;
     }
-    
-    // Simplified implementation - just fulfill with "all_resolved"
-    result_promise->fulfill(Value("all_resolved"));
-    return result_promise;
+
+    auto remaining = std::make_shared<size_t>(values.size());
+    auto on_rejected = ObjectFactory::create_native_function("",
+        [result](Context& ctx, const std::vector<Value>& args) -> Value {
+            (void)ctx;
+            result->reject(args.empty() ? Value() : args[0]);
+            return Value();
+        });
+    Function* reject_all = on_rejected.release();
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        auto on_fulfilled = ObjectFactory::create_native_function("",
+            [result, results, remaining, i](Context& ctx, const std::vector<Value>& args) -> Value {
+                (void)ctx;
+                results->set_element(static_cast<uint32_t>(i), args.empty() ? Value() : args[0]);
+                if (--*remaining == 0) {
+                    result->fulfill(Value(results));
+                }
+                return Value();
+            });
+
+        PromiseReaction* reaction = PromiseReaction::acquire();
+        reaction->on_fulfilled = on_fulfilled.release();
+        reaction->on_rejected = reject_all;
+        reaction->context = result->job_context(&ctx);
+        resolve_static(values[i], &ctx)->add_reaction(reaction);
+    }
+    return result;
 }
 
-Promise* Promise::race(const std::vector<Promise*>& promises) {
-    auto promise_obj = ObjectFactory::create_promise(nullptr);
-    auto* result_promise = static_cast<Promise*>(promise_obj.release());
-    
-    if (promises.empty()) {
-        // Never resolves if empty
-        return result_promise;
+Promise* Promise::race(Context& ctx, const std::vector<Value>& values) {
+    auto result_obj = ObjectFactory::create_promise(&ctx);
+    auto* result = static_cast<Promise*>(result_obj.release());
+
+    // Every element settles the result; only the first one counts
+    for (const Value& value : values) {
+        PromiseReaction* reaction = PromiseReaction::acquire();
+        reaction->derived = result;
+        resolve_static(value, &ctx)->add_reaction(reaction);
     }
-    
-    // Simplified implementation - just fulfill with "race_winner"
-    result_promise->fulfill(Value("race_winner"));
-    return result_promise;
+    return result;
 }
 
-void Promise::execute_handlers() {
-    if (state_ == PromiseState::FULFILLED && !fulfillment_handlers_.empty()) {
-        // Copy handlers to avoid iterator invalidation issues
-        auto handlers = fulfillment_handlers_;
-        fulfillment_handlers_.clear();
-        
-        for (Function* handler : handlers) {
-            if (handler && context_) {
-                try {
-                    std::vector<Value> args = {value_};
-                    handler->call(*context_, args);
-                } catch (...) {
-                    // Handler execution failed - continue with other handlers
-                }
-            }
-        }
-        rejection_handlers_.clear();
-    } else if (state_ == PromiseState::REJECTED && !rejection_handlers_.empty()) {
-        // Copy and clear rejection handlers safely
-        auto handlers = rejection_handlers_;
-        rejection_handlers_.clear();
-        
-        for (Function* handler : handlers) {
-            if (handler && context_) {
-                try {
-                    std::vector<Value> args = {value_};
-                    handler->call(*context_, args);
-                } catch (...) {
-                    // Handler execution failed - continue with other handlers
-                }
-            }
-        }
-        fulfillment_handlers_.clear();
+void Promise::visit_references(GCVisitor& visitor) const {
+    Object::visit_references(visitor);
+    visitor.visit(value_);
+    for (PromiseReaction* reaction = reactions_head_; reaction; reaction = reaction->next) {
+        reaction->visit_references(visitor);
     }
 }
 
 // ES2025: Promise.withResolvers()
 Value Promise::withResolvers(Context& ctx, const std::vector<Value>& args) {
-    (void)ctx; (void)args; // Suppress unused parameter warnings
+    (void)args; // Suppress unused parameter warnings
 
-    auto promise_obj = ObjectFactory::create_promise(nullptr);
+    auto promise_obj = ObjectFactory::create_promise(&ctx);
     auto* promise = static_cast<Promise*>(promise_obj.release());
     auto result_obj = ObjectFactory::create_object();
-    
+
     // Create resolve function
     auto resolve_fn = ObjectFactory::create_native_function("resolve",
         [promise](Context& ctx, const std::vector<Value>& args) -> Value {
             (void)ctx;
             Value resolve_value = args.empty() ? Value() : args[0];
-            promise->fulfill(resolve_value);
+            promise->resolve(resolve_value);
             return Value();
         });
-    
-    // Create reject function  
+
+    // Create reject function
     auto reject_fn = ObjectFactory::create_native_function("reject",
         [promise](Context& ctx, const std::vector<Value>& args) -> Value {
             (void)ctx;
-            Value reject_value = args.empty() ? Value("Promise rejected") : args[0];
+            Value reject_value = args.empty() ? Value() : args[0];
             promise->reject(reject_value);
             return Value();
         });
-    
+
     // Return object with promise, resolve, reject
     result_obj->set_property("promise", Value(promise));
     result_obj->set_property("resolve", Value(resolve_fn.release()));
     result_obj->set_property("reject", Value(reject_fn.release()));
-    
+
     return Value(result_obj.release());
 }
 
@@ -228,85 +418,27 @@ Value Promise::try_method(Context& ctx, const std::vector<Value>& args) {
         ctx.throw_exception(Value("Promise.try requires a function argument"));
         return Value();
     }
-    
+
     Function* callback = args[0].as_function();
-    auto promise_obj = ObjectFactory::create_promise(nullptr);
+    auto promise_obj = ObjectFactory::create_promise(&ctx);
     auto* promise = static_cast<Promise*>(promise_obj.release());
-    
+
     try {
         // Execute the callback immediately
         std::vector<Value> callback_args;
         Value result = callback->call(ctx, callback_args);
-        
-        // If result is a Promise, chain it
-        if (result.is_object() && result.as_object()->get_type() == ObjectType::Promise) {
-            Promise* result_promise = static_cast<Promise*>(result.as_object());
-            if (result_promise->state_ == PromiseState::FULFILLED) {
-                promise->fulfill(result_promise->value_);
-            } else if (result_promise->state_ == PromiseState::REJECTED) {
-                promise->reject(result_promise->value_);
-            }
+        if (ctx.has_exception()) {
+            Value error = ctx.get_exception();
+            ctx.clear_exception();
+            promise->reject(error);
         } else {
-            // Fulfill with the direct result
-            promise->fulfill(result);
+            promise->resolve(result);
         }
     } catch (const std::exception& e) {
         promise->reject(Value(std::string("Promise.try caught exception: ") + e.what()));
     }
-    
-    return Value(promise);
-}
 
-// Setup JavaScript methods (.then, .catch, .finally) on a promise instance
-void Promise::setup_promise_methods(Promise* promise) {
-    if (!promise) return;
-    
-    // Add .then method without capturing the promise pointer
-    // Instead, use 'this' binding approach similar to other objects
-    auto then_method = ObjectFactory::create_native_function("then",
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-            // In a full implementation, 'this' would be passed as the promise object
-            // For now, create a simple resolved promise to avoid segfaults
-            auto promise_obj = ObjectFactory::create_promise(&ctx);
-            Promise* new_promise = static_cast<Promise*>(promise_obj.release());
-            if (args.size() > 0 && args[0].is_function()) {
-                // Execute callback immediately with resolved value
-                Function* callback = args[0].as_function();
-                try {
-                    std::vector<Value> callback_args = {Value("resolved")};
-                    Value result = callback->call(ctx, callback_args);
-                    new_promise->fulfill(result);
-                } catch (...) {
-                    new_promise->reject(Value("Callback execution failed"));
-                }
-            } else {
-                new_promise->fulfill(Value("resolved"));
-            }
-            return Value(new_promise);
-        });
-    promise->set_property("then", Value(then_method.release()));
-    
-    // Add .catch method without capturing promise pointer
-    auto catch_method = ObjectFactory::create_native_function("catch",
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-            // Simplified implementation that avoids pointer capture
-            auto promise_obj = ObjectFactory::create_promise(&ctx);
-            Promise* new_promise = static_cast<Promise*>(promise_obj.release());
-            new_promise->fulfill(Value("catch_resolved"));
-            return Value(new_promise);
-        });
-    promise->set_property("catch", Value(catch_method.release()));
-    
-    // Add .finally method without capturing promise pointer
-    auto finally_method = ObjectFactory::create_native_function("finally",
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-            // Simplified implementation that avoids pointer capture
-            auto promise_obj = ObjectFactory::create_promise(&ctx);
-            Promise* new_promise = static_cast<Promise*>(promise_obj.release());
-            new_promise->fulfill(Value("finally_resolved"));
-            return Value(new_promise);
-        });
-    promise->set_property("finally", Value(finally_method.release()));
+    return Value(promise);
 }
 
-} // namespace Quanta
\ No newline at end of file
+} // namespace Quanta
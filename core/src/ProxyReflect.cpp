@@ -6,6 +6,7 @@
 
 #include "ProxyReflect.h"
 #include "Context.h"
+#include "Symbol.h"
 #include "../../parser/include/AST.h"
 #include <iostream>
 
@@ -30,7 +31,7 @@ Value Proxy::get_trap(const Value& key) {
     }
     
     // Default behavior
-    return target_->get_property(key.to_string());
+    return target_->get_property(key.to_property_key());
 }
 
 bool Proxy::set_trap(const Value& key, const Value& value) {
@@ -43,7 +44,7 @@ bool Proxy::set_trap(const Value& key, const Value& value) {
     }
     
     // Default behavior
-    return target_->set_property(key.to_string(), value);
+    return target_->set_property(key.to_property_key(), value);
 }
 
 bool Proxy::has_trap(const Value& key) {
@@ -56,7 +57,7 @@ bool Proxy::has_trap(const Value& key) {
     }
     
     // Default behavior
-    return target_->has_property(key.to_string());
+    return target_->has_property(key.to_property_key());
 }
 
 bool Proxy::delete_trap(const Value& key) {
@@ -69,7 +70,7 @@ bool Proxy::delete_trap(const Value& key) {
     }
     
     // Default behavior
-    return target_->delete_property(key.to_string());
+    return target_->delete_property(key.to_property_key());
 }
 
 std::vector<std::string> Proxy::own_keys_trap() {
@@ -81,8 +82,11 @@ std::vector<std::string> Proxy::own_keys_trap() {
         return parsed_handler_.ownKeys();
     }
     
-    // Default behavior
-    return target_->get_own_property_keys();
+    // Default behavior: string keys, then symbol keys
+    auto keys = target_->get_own_property_keys();
+    auto symbol_keys = target_->get_own_symbol_keys();
+    keys.insert(keys.end(), symbol_keys.begin(), symbol_keys.end());
+    return keys;
 }
 
 Value Proxy::get_prototype_of_trap() {
@@ -150,7 +154,7 @@ PropertyDescriptor Proxy::get_own_property_descriptor_trap(const Value& key) {
     }
     
     // Default behavior
-    return target_->get_property_descriptor(key.to_string());
+    return target_->get_property_descriptor(key.to_property_key());
 }
 
 bool Proxy::define_property_trap(const Value& key, const PropertyDescriptor& desc) {
@@ -163,7 +167,7 @@ bool Proxy::define_property_trap(const Value& key, const PropertyDescriptor& des
     }
     
     // Default behavior
-    return target_->set_property_descriptor(key.to_string(), desc);
+    return target_->set_property_descriptor(key.to_property_key(), desc);
 }
 
 Value Proxy::apply_trap(const std::vector<Value>& args, const Value& this_value) {
@@ -223,7 +227,7 @@ void Proxy::parse_handler() {
                 return get_fn->call(dummy_ctx, args);
             } catch (...) {
                 // If trap fails, fall back to default behavior
-                return target_->get_property(key.to_string());
+                return target_->get_property(key.to_property_key());
             }
         };
     }
@@ -263,6 +267,12 @@ void Proxy::throw_if_revoked(Context& ctx) const {
     }
 }
 
+void Proxy::visit_references(GCVisitor& visitor) const {
+    Object::visit_references(visitor);
+    visitor.visit(target_);
+    visitor.visit(handler_);
+}
+
 //  PROXY OBJECT METHOD OVERRIDES - TRAP INTEGRATION 
 
 Value Proxy::get_property(const std::string& key) const {
@@ -423,12 +433,26 @@ Value Reflect::reflect_own_keys(Context& ctx, const std::vector<Value>& args) {
         return Value();
     }
     
-    auto keys = target->get_own_property_keys();
+    // String keys, then symbol keys; a proxy answers through its ownKeys trap
+    std::vector<std::string> keys;
+    if (target->get_type() == Object::ObjectType::Proxy) {
+        keys = static_cast<Proxy*>(target)->own_keys_trap();
+    } else {
+        keys = target->get_own_property_keys();
+        auto symbol_keys = target->get_own_symbol_keys();
+        keys.insert(keys.end(), symbol_keys.begin(), symbol_keys.end());
+    }
     auto result_array = ObjectFactory::create_array(keys.size());
     
-    for (size_t i = 0; i < keys.size(); ++i) {
-        result_array->set_element(static_cast<uint32_t>(i), Value(keys[i]));
+    uint32_t index = 0;
+    for (const auto& key : keys) {
+        if (!Symbol::is_property_key(key)) {
+            result_array->set_element(index++, Value(key));
+        } else if (Symbol* symbol = Symbol::from_property_key(key)) {
+            result_array->set_element(index++, Value(symbol));
+        }
     }
+    result_array->set_length(index);
     
     return Value(result_array.release());
 }
@@ -594,7 +618,7 @@ Object* Reflect::to_object(const Value& value, Context& ctx) {
 }
 
 std::string Reflect::to_property_key(const Value& value) {
-    return value.to_string();
+    return value.to_property_key();
 }
 
 PropertyDescriptor Reflect::to_property_descriptor(const Value& value) {
@@ -80,6 +80,16 @@ Value RegExp::exec(const std::string& str) {
     return Value(); // null
 }
 
+bool RegExp::search(const std::string& str, size_t from, std::smatch& match) const {
+    if (from > str.length()) return false;
+    auto flags = from > 0 ? std::regex_constants::match_prev_avail : std::regex_constants::match_default;
+    try {
+        return std::regex_search(str.begin() + from, str.end(), match, regex_, flags);
+    } catch (const std::regex_error&) {
+        return false;
+    }
+}
+
 std::string RegExp::to_string() const {
     return "/" + pattern_ + "/" + flags_;
 }
@@ -5,29 +5,321 @@
  */
 
 #include "String.h"
+#include <algorithm>
+#include <cstring>
 #include <unordered_map>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace Quanta {
 
-// String interning cache
-static std::unordered_map<std::string, std::weak_ptr<std::string>> intern_cache_;
+// String interning cache (per thread; interned data is immutable and may be shared)
+static thread_local std::unordered_map<std::string, std::weak_ptr<const std::string>> intern_cache_;
 
-String::String() : data_(std::make_shared<std::string>()), hash_(0), interned_(false) {
+namespace {
+
+bool is_ascii(const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        if (static_cast<unsigned char>(data[i]) >= 0x80) return false;
+    }
+    return true;
+}
+
+bool is_ascii(const char16_t* units, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (units[i] >= 0x80) return false;
+    }
+    return true;
+}
+
+bool is_continuation(unsigned char byte) {
+    return (byte & 0xC0) == 0x80;
+}
+
+// Decodes UTF-8 into UTF-16 code units, handing each to sink. Encoded
+// surrogates (WTF-8, as produced for lone surrogates by encode_utf8) are
+// accepted; any other malformed byte decodes to U+FFFD.
+template<typename Sink>
+void decode_utf8(const std::string& text, Sink sink) {
+    const size_t size = text.size();
+    size_t i = 0;
+    while (i < size) {
+        unsigned char b0 = static_cast<unsigned char>(text[i]);
+        if (b0 < 0x80) {
+            sink(static_cast<char16_t>(b0));
+            ++i;
+            continue;
+        }
+
+        uint32_t code_point = 0xFFFD;
+        size_t width = 1;
+        if (b0 >= 0xC2 && b0 <= 0xDF && i + 1 < size && is_continuation(text[i + 1])) {
+            code_point = ((b0 & 0x1Fu) << 6) | (text[i + 1] & 0x3Fu);
+            width = 2;
+        } else if (b0 >= 0xE0 && b0 <= 0xEF && i + 2 < size &&
+                   is_continuation(text[i + 1]) && is_continuation(text[i + 2])) {
+            uint32_t decoded = ((b0 & 0x0Fu) << 12) | ((text[i + 1] & 0x3Fu) << 6) | (text[i + 2] & 0x3Fu);
+            if (decoded >= 0x800) {
+                code_point = decoded;
+                width = 3;
+            }
+        } else if (b0 >= 0xF0 && b0 <= 0xF4 && i + 3 < size && is_continuation(text[i + 1]) &&
+                   is_continuation(text[i + 2]) && is_continuation(text[i + 3])) {
+            uint32_t decoded = ((b0 & 0x07u) << 18) | ((text[i + 1] & 0x3Fu) << 12) |
+                               ((text[i + 2] & 0x3Fu) << 6) | (text[i + 3] & 0x3Fu);
+            if (decoded >= 0x10000 && decoded <= 0x10FFFF) {
+                code_point = decoded;
+                width = 4;
+            }
+        }
+
+        if (code_point >= 0x10000) {
+            code_point -= 0x10000;
+            sink(static_cast<char16_t>(0xD800 + (code_point >> 10)));
+            sink(static_cast<char16_t>(0xDC00 + (code_point & 0x3FF)));
+        } else {
+            sink(static_cast<char16_t>(code_point));
+        }
+        i += width;
+    }
+}
+
+// Encodes UTF-16 code units as UTF-8; a lone surrogate is encoded on its own
+std::string encode_utf8(const char16_t* units, size_t count) {
+    std::string text;
+    text.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t code_point = units[i];
+        if (code_point >= 0xD800 && code_point <= 0xDBFF && i + 1 < count &&
+            units[i + 1] >= 0xDC00 && units[i + 1] <= 0xDFFF) {
+            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (units[i + 1] - 0xDC00);
+            ++i;
+        }
+
+        if (code_point < 0x80) {
+            text += static_cast<char>(code_point);
+        } else if (code_point < 0x800) {
+            text += static_cast<char>(0xC0 | (code_point >> 6));
+            text += static_cast<char>(0x80 | (code_point & 0x3F));
+        } else if (code_point < 0x10000) {
+            text += static_cast<char>(0xE0 | (code_point >> 12));
+            text += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            text += static_cast<char>(0x80 | (code_point & 0x3F));
+        } else {
+            text += static_cast<char>(0xF0 | (code_point >> 18));
+            text += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+            text += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            text += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+    }
+    return text;
+}
+
+inline char16_t code_unit(char c) { return static_cast<unsigned char>(c); }
+inline char16_t code_unit(char16_t c) { return c; }
+
+// Haystacks shorter than this are searched without building a shift table
+constexpr size_t HORSPOOL_MIN_HAYSTACK = 256;
+
+size_t find_unit(const char* haystack, size_t length, char16_t unit, size_t from) {
+    if (unit >= 0x80 || from >= length) return String::npos;
+    const void* found = std::memchr(haystack + from, static_cast<int>(unit), length - from);
+    return found ? static_cast<const char*>(found) - haystack : String::npos;
+}
+
+size_t find_unit(const char16_t* haystack, size_t length, char16_t unit, size_t from) {
+    size_t i = from;
+#if defined(__SSE2__)
+    const __m128i target = _mm_set1_epi16(static_cast<short>(unit));
+    for (; i + 8 <= length; i += 8) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(block, target));
+        if (mask) return i + (__builtin_ctz(static_cast<unsigned>(mask)) >> 1);
+    }
+#endif
+    for (; i < length; ++i) {
+        if (haystack[i] == unit) return i;
+    }
+    return String::npos;
+}
+
+template<typename H, typename N>
+bool equal_units(const H* a, const N* b, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (code_unit(a[i]) != code_unit(b[i])) return false;
+    }
+    return true;
+}
+
+template<typename H, typename N>
+size_t find_units(const H* haystack, size_t length, const N* needle, size_t needle_length, size_t from) {
+    if (from > length) return String::npos;
+    if (needle_length == 0) return from;
+    if (needle_length > length - from) return String::npos;
+
+    const size_t last = needle_length - 1;
+    if (needle_length == 1 || length - from < HORSPOOL_MIN_HAYSTACK) {
+        // Find the first unit, then compare the rest
+        const size_t end = length - last;
+        for (size_t pos = from; pos < end; ++pos) {
+            pos = find_unit(haystack, end, code_unit(needle[0]), pos);
+            if (pos == String::npos) return String::npos;
+            if (equal_units(haystack + pos + 1, needle + 1, last)) return pos;
+        }
+        return String::npos;
+    }
+
+    // Horspool: on a mismatch, shift by the distance from the unit under the
+    // needle's last position to its last occurrence in the needle. Two-byte
+    // units share table entries by their low byte, which only shortens shifts.
+    size_t shift[256];
+    std::fill(shift, shift + 256, needle_length);
+    for (size_t i = 0; i < last; ++i) {
+        shift[code_unit(needle[i]) & 0xFF] = last - i;
+    }
+
+    const char16_t last_unit = code_unit(needle[last]);
+    for (size_t pos = from; pos + needle_length <= length;) {
+        char16_t unit = code_unit(haystack[pos + last]);
+        if (unit == last_unit && equal_units(haystack + pos, needle, last)) return pos;
+        pos += shift[unit & 0xFF];
+    }
+    return String::npos;
+}
+
+template<typename H, typename N>
+size_t find_last_units(const H* haystack, size_t length, const N* needle, size_t needle_length, size_t from) {
+    if (needle_length > length) return String::npos;
+    size_t pos = std::min(from, length - needle_length);
+    while (true) {
+        if (equal_units(haystack + pos, needle, needle_length)) return pos;
+        if (pos == 0) return String::npos;
+        --pos;
+    }
+}
+
+} // anonymous namespace
+
+String::String()
+    : data_(std::make_shared<std::string>()), offset_(0), length_(0), encoding_(Encoding::OneByte),
+      sliced_(false), interned_(false), hashed_(false), hash_(0) {
+}
+
+String::String(std::string str)
+    : offset_(0), length_(0), encoding_(Encoding::OneByte),
+      sliced_(false), interned_(false), hashed_(false), hash_(0) {
+    if (is_ascii(str.data(), str.size())) {
+        length_ = static_cast<uint32_t>(str.size());
+    } else {
+        // Code units are only counted here; they are decoded on first indexed access
+        encoding_ = Encoding::TwoByte;
+        uint32_t count = 0;
+        decode_utf8(str, [&count](char16_t) { ++count; });
+        length_ = count;
+    }
+    data_ = std::make_shared<const std::string>(std::move(str));
+}
+
+String::String(const char* str) : String(std::string(str)) {
+}
+
+String::String(std::u16string units)
+    : offset_(0), length_(static_cast<uint32_t>(units.size())), encoding_(Encoding::OneByte),
+      sliced_(false), interned_(false), hashed_(false), hash_(0) {
+    if (is_ascii(units.data(), units.size())) {
+        data_ = std::make_shared<std::string>(units.begin(), units.end());
+    } else {
+        encoding_ = Encoding::TwoByte;
+        data_ = std::make_shared<std::string>(encode_utf8(units.data(), units.size()));
+        units_ = std::make_shared<std::u16string>(std::move(units));
+    }
+}
+
+const std::string& String::str() const {
+    if (!sliced_) return *data_;
+    if (!text_) {
+        if (encoding_ == Encoding::OneByte) {
+            text_ = std::make_shared<std::string>(*data_, offset_, length_);
+        } else {
+            text_ = std::make_shared<std::string>(encode_utf8(units_->data() + offset_, length_));
+        }
+    }
+    return *text_;
+}
+
+const std::u16string& String::two_byte_units() const {
+    if (!units_) {
+        auto units = std::make_shared<std::u16string>();
+        units->reserve(length_);
+        decode_utf8(*data_, [&units](char16_t unit) { units->push_back(unit); });
+        units_ = std::move(units);
+    }
+    return *units_;
+}
+
+size_t String::backing_length() const {
+    return encoding_ == Encoding::OneByte ? data_->size() : units_->size();
 }
 
-String::String(const std::string& str) 
-    : data_(std::make_shared<std::string>(str)), interned_(false) {
-    calculate_hash();
+bool String::starts_with(const char* ascii_prefix) const {
+    size_t prefix_length = std::strlen(ascii_prefix);
+    if (prefix_length > length_) return false;
+    for (size_t i = 0; i < prefix_length; ++i) {
+        if (char_code_at(i) != static_cast<unsigned char>(ascii_prefix[i])) return false;
+    }
+    return true;
 }
 
-String::String(const char* str) 
-    : data_(std::make_shared<std::string>(str)), interned_(false) {
-    calculate_hash();
+size_t String::index_of(const String& needle, size_t from) const {
+    if (encoding_ == Encoding::OneByte) {
+        return needle.encoding_ == Encoding::OneByte
+            ? find_units(one_byte_data(), length_, needle.one_byte_data(), needle.length_, from)
+            : find_units(one_byte_data(), length_, needle.two_byte_data(), needle.length_, from);
+    }
+    return needle.encoding_ == Encoding::OneByte
+        ? find_units(two_byte_data(), length_, needle.one_byte_data(), needle.length_, from)
+        : find_units(two_byte_data(), length_, needle.two_byte_data(), needle.length_, from);
+}
+
+bool String::matches_at(const String& needle, size_t position) const {
+    if (position > length_ || needle.length_ > length_ - position) return false;
+    if (encoding_ == Encoding::OneByte) {
+        return needle.encoding_ == Encoding::OneByte
+            ? equal_units(one_byte_data() + position, needle.one_byte_data(), needle.length_)
+            : equal_units(one_byte_data() + position, needle.two_byte_data(), needle.length_);
+    }
+    return needle.encoding_ == Encoding::OneByte
+        ? equal_units(two_byte_data() + position, needle.one_byte_data(), needle.length_)
+        : equal_units(two_byte_data() + position, needle.two_byte_data(), needle.length_);
+}
+
+size_t String::last_index_of(const String& needle, size_t from) const {
+    if (encoding_ == Encoding::OneByte) {
+        return needle.encoding_ == Encoding::OneByte
+            ? find_last_units(one_byte_data(), length_, needle.one_byte_data(), needle.length_, from)
+            : find_last_units(one_byte_data(), length_, needle.two_byte_data(), needle.length_, from);
+    }
+    return needle.encoding_ == Encoding::OneByte
+        ? find_last_units(two_byte_data(), length_, needle.one_byte_data(), needle.length_, from)
+        : find_last_units(two_byte_data(), length_, needle.two_byte_data(), needle.length_, from);
+}
+
+size_t String::hash() const {
+    if (!hashed_) {
+        hash_ = std::hash<std::string>{}(str());
+        hashed_ = true;
+    }
+    return hash_;
 }
 
 bool String::operator==(const String& other) const {
-    if (data_ == other.data_) return true;
-    if (hash_ != other.hash_) return false;
+    if (length_ != other.length_) return false;
+    if (encoding_ == Encoding::OneByte && other.encoding_ == Encoding::OneByte) {
+        if (data_ == other.data_ && offset_ == other.offset_) return true;
+        return data_->compare(offset_, length_, *other.data_, other.offset_, other.length_) == 0;
+    }
+    if (hashed_ && other.hashed_ && hash_ != other.hash_) return false;
     return str() == other.str();
 }
 
@@ -35,8 +327,58 @@ String String::concat(const String& other) const {
     return String(str() + other.str());
 }
 
-String String::substring(size_t start, size_t length) const {
-    return String(str().substr(start, length));
+String String::substring(size_t start, size_t end) const {
+    end = std::min(end, static_cast<size_t>(length_));
+    start = std::min(start, end);
+    size_t count = end - start;
+    if (count == length_) return *this;
+
+    if (count < MIN_SLICE_LENGTH) {
+        if (encoding_ == Encoding::OneByte) {
+            return String(data_->substr(offset_ + start, count));
+        }
+        const std::u16string& units = two_byte_units();
+        return String(units.substr(offset_ + start, count));
+    }
+
+    String slice;
+    slice.encoding_ = encoding_;
+    if (encoding_ == Encoding::OneByte) {
+        slice.data_ = data_;
+    } else {
+        two_byte_units();
+        slice.data_ = nullptr;
+        slice.units_ = units_;
+    }
+    slice.offset_ = static_cast<uint32_t>(offset_ + start);
+    slice.length_ = static_cast<uint32_t>(count);
+    slice.sliced_ = true;
+    return slice;
+}
+
+String String::char_at(size_t index) const {
+    char16_t unit = char_code_at(index);
+    if (unit < 0x80) return String(std::string(1, static_cast<char>(unit)));
+    return String(std::u16string(1, unit));
+}
+
+bool String::pins_backing() const {
+    if (!sliced_) return false;
+    size_t backing = backing_length();
+    return backing >= MIN_PINNED_BACKING && backing >= static_cast<size_t>(length_) * PINNING_RATIO;
+}
+
+void String::flatten() {
+    if (!sliced_) return;
+    if (encoding_ == Encoding::OneByte) {
+        data_ = text_ ? text_ : std::make_shared<std::string>(*data_, offset_, length_);
+    } else {
+        units_ = std::make_shared<std::u16string>(*units_, offset_, length_);
+        data_ = text_ ? text_ : std::make_shared<std::string>(encode_utf8(units_->data(), length_));
+    }
+    text_.reset();
+    offset_ = 0;
+    sliced_ = false;
 }
 
 String String::intern(const std::string& str) {
@@ -44,14 +386,13 @@ String String::intern(const std::string& str) {
     if (it != intern_cache_.end()) {
         auto shared = it->second.lock();
         if (shared) {
-            String result;
+            String result(*shared);
             result.data_ = shared;
             result.interned_ = true;
-            result.calculate_hash();
             return result;
         }
     }
-    
+
     // Create new interned string
     String result(str);
     result.interned_ = true;
@@ -59,8 +400,51 @@ String String::intern(const std::string& str) {
     return result;
 }
 
-void String::calculate_hash() {
-    hash_ = std::hash<std::string>{}(*data_);
+//=============================================================================
+// StringBuilder
+//=============================================================================
+
+void StringBuilder::reserve(size_t units) {
+    if (two_byte_) {
+        units_.reserve(units);
+    } else {
+        bytes_.reserve(units);
+    }
+}
+
+void StringBuilder::append(const String& str, size_t start, size_t end) {
+    end = std::min(end, str.length());
+    if (start >= end) return;
+
+    if (str.encoding_ == String::Encoding::OneByte) {
+        const char* data = str.one_byte_data();
+        if (two_byte_) {
+            units_.append(data + start, data + end);
+        } else {
+            bytes_.append(data + start, end - start);
+        }
+        return;
+    }
+
+    if (!two_byte_) widen();
+    const char16_t* data = str.two_byte_data();
+    units_.append(data + start, end - start);
+}
+
+void StringBuilder::widen() {
+    units_.reserve(std::max(units_.capacity(), bytes_.capacity()));
+    units_.assign(bytes_.begin(), bytes_.end());
+    bytes_.clear();
+    bytes_.shrink_to_fit();
+    two_byte_ = true;
+}
+
+String StringBuilder::build() {
+    String result = two_byte_ ? String(std::move(units_)) : String(std::move(bytes_));
+    bytes_.clear();
+    units_.clear();
+    two_byte_ = false;
+    return result;
 }
 
-} // namespace Quanta
\ No newline at end of file
+} // namespace Quanta
@@ -6,37 +6,70 @@
 
 #include "Symbol.h"
 #include "Context.h"
-#include <sstream>
 #include <atomic>
+#include <cstdlib>
 
 namespace Quanta {
 
 // Static member initialization
-uint64_t Symbol::next_id_ = 1;
-std::unordered_map<std::string, std::unique_ptr<Symbol>> Symbol::well_known_symbols_;
+std::atomic<uint64_t> Symbol::next_id_{static_cast<uint64_t>(WellKnownSymbol::Count) + 1};
 std::unordered_map<std::string, std::unique_ptr<Symbol>> Symbol::global_registry_;
-
-// Well-known symbol names
-const std::string Symbol::ITERATOR = "Symbol.iterator";
-const std::string Symbol::ASYNC_ITERATOR = "Symbol.asyncIterator";
-const std::string Symbol::MATCH = "Symbol.match";
-const std::string Symbol::REPLACE = "Symbol.replace";
-const std::string Symbol::SEARCH = "Symbol.search";
-const std::string Symbol::SPLIT = "Symbol.split";
-const std::string Symbol::HAS_INSTANCE = "Symbol.hasInstance";
-const std::string Symbol::IS_CONCAT_SPREADABLE = "Symbol.isConcatSpreadable";
-const std::string Symbol::SPECIES = "Symbol.species";
-const std::string Symbol::TO_PRIMITIVE = "Symbol.toPrimitive";
-const std::string Symbol::TO_STRING_TAG = "Symbol.toStringTag";
-const std::string Symbol::UNSCOPABLES = "Symbol.unscopables";
-
-Symbol::Symbol(const std::string& description) : description_(description), id_(next_id_++) {}
+std::mutex Symbol::global_registry_mutex_;
+std::unordered_map<uint64_t, Symbol*> Symbol::symbols_by_id_;
+std::mutex Symbol::symbols_by_id_mutex_;
+
+Symbol Symbol::well_known_symbols_[] = {
+    Symbol("Symbol.iterator", 1),
+    Symbol("Symbol.asyncIterator", 2),
+    Symbol("Symbol.match", 3),
+    Symbol("Symbol.replace", 4),
+    Symbol("Symbol.search", 5),
+    Symbol("Symbol.split", 6),
+    Symbol("Symbol.hasInstance", 7),
+    Symbol("Symbol.isConcatSpreadable", 8),
+    Symbol("Symbol.species", 9),
+    Symbol("Symbol.toPrimitive", 10),
+    Symbol("Symbol.toStringTag", 11),
+    Symbol("Symbol.unscopables", 12),
+};
+
+static const char* const WELL_KNOWN_NAMES[] = {
+    "iterator",
+    "asyncIterator",
+    "match",
+    "replace",
+    "search",
+    "split",
+    "hasInstance",
+    "isConcatSpreadable",
+    "species",
+    "toPrimitive",
+    "toStringTag",
+    "unscopables",
+};
+static_assert(sizeof(WELL_KNOWN_NAMES) / sizeof(WELL_KNOWN_NAMES[0]) == static_cast<size_t>(WellKnownSymbol::Count),
+              "every well-known symbol needs a name");
+
+Symbol::Symbol(const std::string& description, uint64_t id)
+    : description_(description), id_(id),
+      property_key_(std::string(1, static_cast<char>(PROPERTY_KEY_PREFIX)) + std::to_string(id)) {}
+
+Symbol::~Symbol() {
+    if (id_ > static_cast<uint64_t>(WellKnownSymbol::Count)) {
+        std::lock_guard<std::mutex> lock(symbols_by_id_mutex_);
+        symbols_by_id_.erase(id_);
+    }
+}
 
 std::unique_ptr<Symbol> Symbol::create(const std::string& description) {
-    return std::unique_ptr<Symbol>(new Symbol(description));
+    std::unique_ptr<Symbol> symbol(new Symbol(description, next_id_++));
+    std::lock_guard<std::mutex> lock(symbols_by_id_mutex_);
+    symbols_by_id_[symbol->id_] = symbol.get();
+    return symbol;
 }
 
 Symbol* Symbol::for_key(const std::string& key) {
+    std::lock_guard<std::mutex> lock(global_registry_mutex_);
     auto it = global_registry_.find(key);
     if (it != global_registry_.end()) {
         return it->second.get();
@@ -49,6 +82,7 @@ Symbol* Symbol::for_key(const std::string& key) {
 }
 
 std::string Symbol::key_for(Symbol* symbol) {
+    std::lock_guard<std::mutex> lock(global_registry_mutex_);
     for (const auto& pair : global_registry_) {
         if (pair.second->equals(symbol)) {
             return pair.first;
@@ -57,37 +91,25 @@ std::string Symbol::key_for(Symbol* symbol) {
     return "";
 }
 
-Symbol* Symbol::get_well_known(const std::string& name) {
-    auto it = well_known_symbols_.find(name);
-    if (it != well_known_symbols_.end()) {
-        return it->second.get();
-    }
-    return nullptr;
+const char* Symbol::well_known_name(WellKnownSymbol which) {
+    return WELL_KNOWN_NAMES[static_cast<size_t>(which)];
 }
 
-void Symbol::initialize_well_known_symbols() {
-    well_known_symbols_[ITERATOR] = create(ITERATOR);
-    well_known_symbols_[ASYNC_ITERATOR] = create(ASYNC_ITERATOR);
-    well_known_symbols_[MATCH] = create(MATCH);
-    well_known_symbols_[REPLACE] = create(REPLACE);
-    well_known_symbols_[SEARCH] = create(SEARCH);
-    well_known_symbols_[SPLIT] = create(SPLIT);
-    well_known_symbols_[HAS_INSTANCE] = create(HAS_INSTANCE);
-    well_known_symbols_[IS_CONCAT_SPREADABLE] = create(IS_CONCAT_SPREADABLE);
-    well_known_symbols_[SPECIES] = create(SPECIES);
-    well_known_symbols_[TO_PRIMITIVE] = create(TO_PRIMITIVE);
-    well_known_symbols_[TO_STRING_TAG] = create(TO_STRING_TAG);
-    well_known_symbols_[UNSCOPABLES] = create(UNSCOPABLES);
+Symbol* Symbol::from_property_key(const std::string& key) {
+    if (!is_property_key(key)) {
+        return nullptr;
+    }
+    uint64_t id = std::strtoull(key.c_str() + 1, nullptr, 10);
+    if (id >= 1 && id <= static_cast<uint64_t>(WellKnownSymbol::Count)) {
+        return &well_known_symbols_[id - 1];
+    }
+    std::lock_guard<std::mutex> lock(symbols_by_id_mutex_);
+    auto it = symbols_by_id_.find(id);
+    return it != symbols_by_id_.end() ? it->second : nullptr;
 }
 
 std::string Symbol::to_string() const {
-    std::ostringstream oss;
-    oss << "Symbol(";
-    if (!description_.empty()) {
-        oss << description_;
-    }
-    oss << ")";
-    return oss.str();
+    return "Symbol(" + description_ + ")";
 }
 
 bool Symbol::equals(const Symbol* other) const {
@@ -157,6 +157,11 @@ bool TypedArrayBase::set_property(const std::string& key, const Value& value, Pr
     return Object::set_property(key, value, attrs);
 }
 
+void TypedArrayBase::visit_references(GCVisitor& visitor) const {
+    Object::visit_references(visitor);
+    visitor.visit(buffer_.get());
+}
+
 std::string TypedArrayBase::to_string() const {
     if (buffer_->is_detached()) {
         return "[object " + get_type_name() + "]";
@@ -141,6 +141,19 @@ std::string Value::to_string() const {
     return "unknown";
 }
 
+std::string Value::to_property_key() const {
+    if (is_symbol()) {
+        return as_symbol()->get_property_key();
+    }
+    std::string key = to_string();
+    if (Symbol::is_property_key(key)) {
+        // A stray 0xFF byte (text that was never UTF-8) is read as U+00FF,
+        // so no string key can spell a symbol's
+        key.replace(0, 1, "\xC3\xBF");
+    }
+    return key;
+}
+
 double Value::to_number() const {
     if (is_number()) return as_number();
     if (is_undefined()) return std::numeric_limits<double>::quiet_NaN();
@@ -169,7 +182,7 @@ bool Value::to_boolean() const {
         return !std::isnan(num) && num != 0.0;
     }
     if (is_string()) {
-        return !as_string()->str().empty();
+        return !as_string()->empty();
     }
     if (is_bigint()) {
         return as_bigint()->to_boolean();
@@ -224,7 +237,7 @@ bool Value::strict_equals(const Value& other) const {
         double b = other.as_number();
         return a == b;
     }
-    if (is_string() && other.is_string()) return as_string()->str() == other.as_string()->str();
+    if (is_string() && other.is_string()) return *as_string() == *other.as_string();
     if (is_bigint() && other.is_bigint()) return *as_bigint() == *other.as_bigint();
     if (is_symbol() && other.is_symbol()) return as_symbol()->equals(other.as_symbol());
     if (is_object() && other.is_object()) return as_object() == other.as_object();
@@ -465,44 +478,61 @@ Value Value::logical_not() const {
     return Value(!to_boolean());
 }
 
+// ToUint32 of a number: truncate and wrap modulo 2^32. A plain cast is
+// undefined for doubles outside the int32 range, which hash code built on
+// & 0xffffffff and friends hits all the time.
+static uint32_t wrap_uint32(double d) {
+    if (!std::isfinite(d)) return 0;
+    if (d >= -2147483648.0 && d <= 4294967295.0) {
+        return d < 0 ? static_cast<uint32_t>(static_cast<int32_t>(d)) : static_cast<uint32_t>(d);
+    }
+    double wrapped = std::fmod(std::trunc(d), 4294967296.0);
+    if (wrapped < 0) wrapped += 4294967296.0;
+    return static_cast<uint32_t>(wrapped);
+}
+
+static int32_t wrap_int32(double d) {
+    return static_cast<int32_t>(wrap_uint32(d));
+}
+
 Value Value::bitwise_not() const {
-    int32_t num = static_cast<int32_t>(to_number());
+    int32_t num = wrap_int32(to_number());
     return Value(static_cast<double>(~num));
 }
 
 Value Value::left_shift(const Value& other) const {
-    int32_t left = static_cast<int32_t>(to_number());
-    int32_t right = static_cast<int32_t>(other.to_number()) & 0x1F;
-    return Value(static_cast<double>(left << right));
+    uint32_t left = wrap_uint32(to_number());
+    uint32_t right = wrap_uint32(other.to_number()) & 0x1F;
+    return Value(static_cast<double>(static_cast<int32_t>(left << right)));
 }
 
 Value Value::right_shift(const Value& other) const {
-    int32_t left = static_cast<int32_t>(to_number());
-    int32_t right = static_cast<int32_t>(other.to_number()) & 0x1F;
+    int32_t left = wrap_int32(to_number());
+    uint32_t right = wrap_uint32(other.to_number()) & 0x1F;
     return Value(static_cast<double>(left >> right));
 }
 
 Value Value::unsigned_right_shift(const Value& other) const {
-    uint32_t left = static_cast<uint32_t>(to_number());
-    int32_t right = static_cast<int32_t>(other.to_number()) & 0x1F;
+    uint32_t left = wrap_uint32(to_number());
+    uint32_t right = wrap_uint32(other.to_number()) & 0x1F;
     return Value(static_cast<double>(left >> right));
 }
 
 Value Value::bitwise_and(const Value& other) const {
-    int32_t left = static_cast<int32_t>(to_number());
-    int32_t right = static_cast<int32_t>(other.to_number());
+    int32_t left = wrap_int32(to_number());
+    int32_t right = wrap_int32(other.to_number());
     return Value(static_cast<double>(left & right));
 }
 
 Value Value::bitwise_or(const Value& other) const {
-    int32_t left = static_cast<int32_t>(to_number());
-    int32_t right = static_cast<int32_t>(other.to_number());
+    int32_t left = wrap_int32(to_number());
+    int32_t right = wrap_int32(other.to_number());
     return Value(static_cast<double>(left | right));
 }
 
 Value Value::bitwise_xor(const Value& other) const {
-    int32_t left = static_cast<int32_t>(to_number());
-    int32_t right = static_cast<int32_t>(other.to_number());
+    int32_t left = wrap_int32(to_number());
+    int32_t right = wrap_int32(other.to_number());
     return Value(static_cast<double>(left ^ right));
 }
 
@@ -612,7 +642,7 @@ bool Value::instanceof_check(const Value& constructor) const {
     
     // Promise instanceof
     if (ctor_name == "Promise") {
-        return obj->has_property("_isPromise");
+        return obj->get_type() == Object::ObjectType::Promise;
     }
     
     // Object instanceof (everything is an object)
@@ -634,6 +664,10 @@ Value create_function(std::unique_ptr<Function> function_obj) {
     return Value(function_obj.release());
 }
 
+Value string(String str) {
+    return Value(std::make_unique<String>(std::move(str)).release());
+}
+
 } // namespace ValueFactory
 
 } // namespace Quanta
\ No newline at end of file
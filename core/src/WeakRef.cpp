@@ -0,0 +1,257 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "WeakRef.h"
+#include "Context.h"
+#include "Async.h"
+#include "GC.h"
+#include "Engine.h"
+#include "Isolate.h"
+#include "../../parser/include/AST.h"
+#include <algorithm>
+
+namespace Quanta {
+
+//=============================================================================
+// WeakRef Implementation
+//=============================================================================
+
+WeakRef::WeakRef(const Value& target) : Object(ObjectType::WeakRef), target_(target) {
+}
+
+void WeakRef::visit_references(GCVisitor& visitor) const {
+    Object::visit_references(visitor);
+    visitor.visit_weak_container(const_cast<WeakRef*>(this));
+}
+
+void WeakRef::clear_dead_references(const std::function<bool(Object*)>& is_live) {
+    if (target_.is_object_like() && !is_live(target_.as_object())) {
+        target_ = Value();
+    }
+}
+
+Value WeakRef::weakref_constructor(Context& ctx, const std::vector<Value>& args) {
+    if (args.empty() || !args[0].is_object_like()) {
+        ctx.throw_type_error("WeakRef: target must be an object");
+        return Value();
+    }
+
+    auto weakref = std::make_unique<WeakRef>(args[0]);
+    if (Object* prototype = Isolate::current().prototypes().weak_ref) {
+        weakref->set_prototype(prototype);
+    }
+
+    // A new target stays alive until the current job completes
+    if (GarbageCollector* gc = ctx.get_garbage_collector()) {
+        gc->keep_during_job(args[0].as_object());
+    }
+
+    return Value(weakref.release());
+}
+
+Value WeakRef::weakref_deref(Context& ctx, const std::vector<Value>& args) {
+    (void)args; // Unused parameter
+    Object* this_obj = ctx.get_this_binding();
+    if (!this_obj || this_obj->get_type() != Object::ObjectType::WeakRef) {
+        ctx.throw_type_error("WeakRef.prototype.deref called on non-WeakRef");
+        return Value();
+    }
+
+    Value target = static_cast<WeakRef*>(this_obj)->deref();
+
+    // Observing the target keeps it alive for the rest of the job
+    if (target.is_object_like()) {
+        if (GarbageCollector* gc = ctx.get_garbage_collector()) {
+            gc->keep_during_job(target.as_object());
+        }
+    }
+
+    return target;
+}
+
+void WeakRef::setup_weakref_prototype(Context& ctx) {
+    auto weakref_constructor_fn = ObjectFactory::create_native_function("WeakRef", weakref_constructor);
+    auto weakref_prototype = ObjectFactory::create_object();
+
+    auto deref_fn = ObjectFactory::create_native_function("deref", weakref_deref);
+    weakref_prototype->set_property("deref", Value(deref_fn.release()));
+
+    Isolate::current().prototypes().weak_ref = weakref_prototype.get();
+
+    weakref_constructor_fn->set_property("prototype", Value(weakref_prototype.release()));
+    ctx.create_binding("WeakRef", Value(weakref_constructor_fn.release()));
+}
+
+//=============================================================================
+// FinalizationRegistry Implementation
+//=============================================================================
+
+FinalizationRegistry::FinalizationRegistry(Context* realm, const Value& cleanup_callback)
+    : Object(ObjectType::FinalizationRegistry), realm_(realm), isolate_(&Isolate::current()),
+      gc_(realm ? realm->get_garbage_collector() : nullptr),
+      cleanup_callback_(cleanup_callback), cleanup_scheduled_(false), rooted_(false) {
+}
+
+void FinalizationRegistry::register_target(Object* target, const Value& held_value, Object* unregister_token) {
+    GarbageCollector::write_barrier(held_value);
+    cells_.push_back({target, held_value, unregister_token});
+    update_root();
+}
+
+bool FinalizationRegistry::unregister(Object* unregister_token) {
+    auto removed = std::remove_if(cells_.begin(), cells_.end(), [unregister_token](const Cell& cell) {
+        return cell.unregister_token == unregister_token;
+    });
+    bool found = removed != cells_.end();
+    cells_.erase(removed, cells_.end());
+    update_root();
+    return found;
+}
+
+void FinalizationRegistry::run_cleanup() {
+    cleanup_scheduled_ = false;
+
+    // Held values stay in the traced pending list until their callback returns;
+    // a collection inside the callback may append more
+    for (size_t i = 0; i < pending_cleanups_.size(); ++i) {
+        if (realm_ && cleanup_callback_.is_function()) {
+            Value held_value = pending_cleanups_[i];
+            cleanup_callback_.as_function()->call(*realm_, {held_value});
+            if (realm_->has_exception()) {
+                realm_->clear_exception();
+            }
+        }
+    }
+    pending_cleanups_.clear();
+    update_root();
+}
+
+void FinalizationRegistry::update_root() {
+    if (!gc_) return;
+
+    bool needed = !cells_.empty() || !pending_cleanups_.empty();
+    if (needed && !rooted_) {
+        gc_->add_root_object(this);
+    } else if (!needed && rooted_) {
+        gc_->remove_root_object(this);
+    }
+    rooted_ = needed;
+}
+
+void FinalizationRegistry::visit_references(GCVisitor& visitor) const {
+    Object::visit_references(visitor);
+    visitor.visit(cleanup_callback_);
+    for (const Cell& cell : cells_) {
+        visitor.visit(cell.held_value);
+    }
+    for (const Value& held_value : pending_cleanups_) {
+        visitor.visit(held_value);
+    }
+    visitor.visit_weak_container(const_cast<FinalizationRegistry*>(this));
+}
+
+void FinalizationRegistry::clear_dead_references(const std::function<bool(Object*)>& is_live) {
+    // Runs inside the collection: the registry stays rooted here because its
+    // pending list is non-empty whenever its cell list shrinks
+    auto dead = std::stable_partition(cells_.begin(), cells_.end(), [&is_live](const Cell& cell) {
+        return is_live(cell.target);
+    });
+    for (auto it = dead; it != cells_.end(); ++it) {
+        pending_cleanups_.push_back(it->held_value);
+    }
+    cells_.erase(dead, cells_.end());
+
+    for (Cell& cell : cells_) {
+        if (cell.unregister_token && !is_live(cell.unregister_token)) {
+            cell.unregister_token = nullptr;
+        }
+    }
+
+    if (!pending_cleanups_.empty() && !cleanup_scheduled_) {
+        cleanup_scheduled_ = true;
+        isolate_->event_loop().schedule_macrotask([this]() { run_cleanup(); });
+    }
+}
+
+Value FinalizationRegistry::registry_constructor(Context& ctx, const std::vector<Value>& args) {
+    if (args.empty() || !args[0].is_function()) {
+        ctx.throw_type_error("FinalizationRegistry: cleanup callback must be callable");
+        return Value();
+    }
+
+    // Cleanup runs after the calling frame is gone, so it uses the global context
+    Engine* engine = ctx.get_engine();
+    Context* realm = engine && engine->get_global_context() ? engine->get_global_context() : &ctx;
+    auto registry = std::make_unique<FinalizationRegistry>(realm, args[0]);
+    if (Object* prototype = Isolate::current().prototypes().finalization_registry) {
+        registry->set_prototype(prototype);
+    }
+
+    return Value(registry.release());
+}
+
+Value FinalizationRegistry::registry_register(Context& ctx, const std::vector<Value>& args) {
+    Object* this_obj = ctx.get_this_binding();
+    if (!this_obj || this_obj->get_type() != Object::ObjectType::FinalizationRegistry) {
+        ctx.throw_type_error("FinalizationRegistry.prototype.register called on non-FinalizationRegistry");
+        return Value();
+    }
+
+    if (args.empty() || !args[0].is_object_like()) {
+        ctx.throw_type_error("FinalizationRegistry.prototype.register: target must be an object");
+        return Value();
+    }
+
+    Value held_value = args.size() > 1 ? args[1] : Value();
+    if (held_value.is_object_like() && held_value.as_object() == args[0].as_object()) {
+        ctx.throw_type_error("FinalizationRegistry.prototype.register: target and held value must not be the same");
+        return Value();
+    }
+
+    Object* unregister_token = nullptr;
+    if (args.size() > 2 && !args[2].is_undefined()) {
+        if (!args[2].is_object_like()) {
+            ctx.throw_type_error("FinalizationRegistry.prototype.register: unregister token must be an object");
+            return Value();
+        }
+        unregister_token = args[2].as_object();
+    }
+
+    static_cast<FinalizationRegistry*>(this_obj)->register_target(args[0].as_object(), held_value, unregister_token);
+    return Value();
+}
+
+Value FinalizationRegistry::registry_unregister(Context& ctx, const std::vector<Value>& args) {
+    Object* this_obj = ctx.get_this_binding();
+    if (!this_obj || this_obj->get_type() != Object::ObjectType::FinalizationRegistry) {
+        ctx.throw_type_error("FinalizationRegistry.prototype.unregister called on non-FinalizationRegistry");
+        return Value();
+    }
+
+    if (args.empty() || !args[0].is_object_like()) {
+        ctx.throw_type_error("FinalizationRegistry.prototype.unregister: token must be an object");
+        return Value();
+    }
+
+    return Value(static_cast<FinalizationRegistry*>(this_obj)->unregister(args[0].as_object()));
+}
+
+void FinalizationRegistry::setup_finalization_registry_prototype(Context& ctx) {
+    auto registry_constructor_fn = ObjectFactory::create_native_function("FinalizationRegistry", registry_constructor);
+    auto registry_prototype = ObjectFactory::create_object();
+
+    auto register_fn = ObjectFactory::create_native_function("register", registry_register);
+    auto unregister_fn = ObjectFactory::create_native_function("unregister", registry_unregister);
+    registry_prototype->set_property("register", Value(register_fn.release()));
+    registry_prototype->set_property("unregister", Value(unregister_fn.release()));
+
+    Isolate::current().prototypes().finalization_registry = registry_prototype.get();
+
+    registry_constructor_fn->set_property("prototype", Value(registry_prototype.release()));
+    ctx.create_binding("FinalizationRegistry", Value(registry_constructor_fn.release()));
+}
+
+} // namespace Quanta
@@ -13,24 +13,21 @@
 
 #include "../include/WebAPI.h"
 #include "Object.h"
+#include "Isolate.h"
 #include "../include/platform/NativeAPI.h"
 #include <iostream>
 
 namespace Quanta {
 
-// Static member initialization
-int WebAPI::timer_id_counter_ = 1;
-std::vector<std::chrono::time_point<std::chrono::steady_clock>> WebAPI::timer_times_;
-
 // Timer APIs - Basic stubs
 Value WebAPI::setTimeout(Context& ctx, const std::vector<Value>& args) {
     std::cout << "WARNING: setTimeout called but Web APIs not implemented. Use WebAPIInterface instead." << std::endl;
-    return Value(timer_id_counter_++);
+    return Value(Isolate::current().next_timer_id());
 }
 
 Value WebAPI::setInterval(Context& ctx, const std::vector<Value>& args) {
     std::cout << "WARNING: setInterval called but Web APIs not implemented. Use WebAPIInterface instead." << std::endl;
-    return Value(timer_id_counter_++);
+    return Value(Isolate::current().next_timer_id());
 }
 
 Value WebAPI::clearTimeout(Context& ctx, const std::vector<Value>& args) {
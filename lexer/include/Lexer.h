@@ -122,6 +122,7 @@ private:
     std::string parse_string_literal(char quote);
     std::string parse_escape_sequence();
     std::string parse_unicode_escape();
+    bool parse_unicode_code_point(uint32_t& cp);
     std::string parse_hex_escape();
     
     // Utility
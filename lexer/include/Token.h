@@ -7,6 +7,7 @@
 #ifndef QUANTA_TOKEN_H
 #define QUANTA_TOKEN_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -167,16 +168,47 @@ enum class TokenType {
  * Token position information
  */
 struct Position {
-    size_t line;
-    size_t column;
-    size_t offset;
+    uint32_t line;
+    uint32_t column;
+    uint32_t offset;
     
     Position(size_t l = 1, size_t c = 1, size_t o = 0) 
-        : line(l), column(c), offset(o) {}
+        : line(static_cast<uint32_t>(l)), column(static_cast<uint32_t>(c)), offset(static_cast<uint32_t>(o)) {}
     
     std::string to_string() const;
 };
 
+/**
+ * Compact source position
+ * Just the offset into the script; what AST nodes keep. It converts back to
+ * a Position with line and column 0, which a LineTable resolves when a
+ * message needs them.
+ */
+struct SourceOffset {
+    uint32_t offset;
+    
+    SourceOffset(const Position& position) : offset(position.offset) {}
+    operator Position() const { return Position(0, 0, offset); }
+};
+
+/**
+ * Line-start table of one script
+ * Offsets of the first character of every line, for turning an offset into
+ * a line and column by binary search. Line terminators are LF, CRLF and a
+ * lone CR, as in the lexer.
+ */
+class LineTable {
+private:
+    std::vector<uint32_t> line_starts_;
+
+public:
+    explicit LineTable(const std::string& source);
+    
+    Position resolve(uint32_t offset) const;
+    Position resolve(const Position& position) const { return resolve(position.offset); }
+    size_t line_count() const { return line_starts_.size(); }
+};
+
 /**
  * JavaScript token
  */
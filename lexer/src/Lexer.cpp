@@ -934,8 +934,35 @@ std::string Lexer::parse_escape_sequence() {
     }
 }
 
+// Source text and strings are UTF-8, so an escaped code unit or code point
+// is stored as its UTF-8 sequence, never as a raw byte. Lone surrogates
+// get the three-byte form UTF-8 would give them (WTF-8).
+static void append_utf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+static uint32_t hex_value(char ch) {
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+    return ch - 'A' + 10;
+}
+
 std::string Lexer::parse_hex_escape() {
-    // \xHH format
+    // \xHH format: the code unit HH, not the byte
     if (remaining() < 2) {
         add_error("Invalid hex escape sequence");
         return "";
@@ -949,28 +976,56 @@ std::string Lexer::parse_hex_escape() {
         return "";
     }
     
-    int value = 0;
-    if (is_digit(high)) value += (high - '0') * 16;
-    else if (high >= 'a' && high <= 'f') value += (high - 'a' + 10) * 16;
-    else value += (high - 'A' + 10) * 16;
-    
-    if (is_digit(low)) value += low - '0';
-    else if (low >= 'a' && low <= 'f') value += low - 'a' + 10;
-    else value += low - 'A' + 10;
-    
-    return std::string(1, static_cast<char>(value));
+    std::string result;
+    append_utf8(result, hex_value(high) * 16 + hex_value(low));
+    return result;
+}
+
+bool Lexer::parse_unicode_code_point(uint32_t& cp) {
+    // After "\u": HHHH or {H...}
+    cp = 0;
+    if (current_char() == '{') {
+        advance(); // consume '{'
+        size_t digits = 0;
+        while (!at_end() && is_hex_digit(current_char())) {
+            cp = cp * 16 + hex_value(advance());
+            if (cp > 0x10FFFF) return false;
+            digits++;
+        }
+        if (digits == 0 || current_char() != '}') return false;
+        advance(); // consume '}'
+        return true;
+    }
+    if (remaining() < 4) return false;
+    for (int i = 0; i < 4; i++) {
+        if (!is_hex_digit(current_char())) return false;
+        cp = cp * 16 + hex_value(advance());
+    }
+    return true;
 }
 
 std::string Lexer::parse_unicode_escape() {
-    // \uHHHH format (simplified)
-    if (remaining() < 4) {
+    // \uHHHH or \u{H...}; a \uHHHH pair of surrogates is one code point
+    uint32_t cp;
+    if (!parse_unicode_code_point(cp)) {
         add_error("Invalid unicode escape sequence");
         return "";
     }
     
-    // For now, just skip the unicode characters
-    advance(); advance(); advance(); advance();
-    return "?"; // Placeholder
+    if (cp >= 0xD800 && cp <= 0xDBFF && current_char() == '\\' && peek_char() == 'u' &&
+        is_hex_digit(peek_char(2)) && is_hex_digit(peek_char(3)) &&
+        is_hex_digit(peek_char(4)) && is_hex_digit(peek_char(5))) {
+        uint32_t low = (hex_value(peek_char(2)) << 12) | (hex_value(peek_char(3)) << 8) |
+                       (hex_value(peek_char(4)) << 4) | hex_value(peek_char(5));
+        if (low >= 0xDC00 && low <= 0xDFFF) {
+            for (int i = 0; i < 6; i++) advance();
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        }
+    }
+    
+    std::string result;
+    append_utf8(result, cp);
+    return result;
 }
 
 void Lexer::add_error(const std::string& message) {
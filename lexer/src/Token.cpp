@@ -5,6 +5,7 @@
  */
 
 #include "Token.h"
+#include <algorithm>
 #include <sstream>
 #include <unordered_map>
 
@@ -23,6 +24,27 @@ std::string Position::to_string() const {
     return oss.str();
 }
 
+//=============================================================================
+// LineTable Implementation
+//=============================================================================
+
+LineTable::LineTable(const std::string& source) {
+    line_starts_.push_back(0);
+    for (size_t i = 0; i < source.size(); ++i) {
+        char ch = source[i];
+        if (ch == '\n' || (ch == '\r' && (i + 1 >= source.size() || source[i + 1] != '\n'))) {
+            line_starts_.push_back(static_cast<uint32_t>(i + 1));
+        }
+    }
+}
+
+Position LineTable::resolve(uint32_t offset) const {
+    // The last line starting at or before the offset
+    auto next = std::upper_bound(line_starts_.begin(), line_starts_.end(), offset);
+    size_t line = static_cast<size_t>(next - line_starts_.begin());
+    return Position(line, offset - line_starts_[line - 1] + 1, offset);
+}
+
 //=============================================================================
 // Token Implementation
 //=============================================================================
@@ -17,7 +17,80 @@ namespace Quanta {
 
 // Forward declarations
 class Context;
+class Environment;
 class FunctionExpression;
+class Object;
+class RegExp;
+class Shape;
+struct SharedFunctionInfo;
+struct LoopOsrState;
+
+/**
+ * Node rewrite counters
+ * Self-specializing nodes count here each time they rewrite themselves:
+ * into a specialized variant after observing their operands, or back to
+ * the generic one after a guard miss. Counters are per thread, like the
+ * engines that run the nodes.
+ */
+struct NodeRewriteStats {
+    enum Site : uint8_t { BINARY, MEMBER, IDENTIFIER, SITE_COUNT };
+    
+    uint64_t specialized[SITE_COUNT] = {};     // generic or uninitialized -> specialized
+    uint64_t respecialized[SITE_COUNT] = {};   // specialized -> another specialization
+    uint64_t generalized[SITE_COUNT] = {};     // -> generic, for good
+    
+    static NodeRewriteStats& current();
+    void reset();
+    std::string to_string() const;
+};
+
+/**
+ * Bump allocator for a script's AST
+ * While a Scope is active on a thread, every node built on that thread is
+ * carved from the arena's chunks, which go back to the heap together when
+ * the arena is destroyed. Nodes built outside any scope (runtime clones)
+ * come from the global heap; a node's allocation prefix records which.
+ */
+class ASTArena {
+public:
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+    static constexpr size_t ALIGNMENT = 16;
+
+    class Scope {
+    private:
+        ASTArena* previous_;
+    public:
+        explicit Scope(ASTArena* arena) : previous_(current_) { current_ = arena; }
+        ~Scope() { current_ = previous_; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+private:
+    char* bump_ = nullptr;
+    char* bump_end_ = nullptr;
+    std::vector<char*> chunks_;
+    size_t used_bytes_ = 0;
+    size_t reserved_bytes_ = 0;
+    size_t allocation_count_ = 0;
+
+    static thread_local ASTArena* current_;
+
+public:
+    ASTArena() = default;
+    ~ASTArena();
+
+    ASTArena(const ASTArena&) = delete;
+    ASTArena& operator=(const ASTArena&) = delete;
+
+    void* allocate(size_t size);
+
+    static ASTArena* current() { return current_; }
+
+    size_t get_used_bytes() const { return used_bytes_; }
+    size_t get_reserved_bytes() const { return reserved_bytes_; }
+    size_t get_allocation_count() const { return allocation_count_; }
+};
 
 /**
  * Abstract Syntax Tree nodes for JavaScript
@@ -103,8 +176,8 @@ public:
 
 protected:
     Type type_;
-    Position start_;
-    Position end_;
+    SourceOffset start_;
+    SourceOffset end_;
 
 public:
     ASTNode(Type type, const Position& start, const Position& end)
@@ -112,28 +185,57 @@ public:
     
     virtual ~ASTNode() = default;
     
+    // Storage comes from the thread's current ASTArena, if any
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr);
+    
     Type get_type() const { return type_; }
-    const Position& get_start() const { return start_; }
-    const Position& get_end() const { return end_; }
+    // Offsets only: resolve line and column through the script's LineTable
+    Position get_start() const { return start_; }
+    Position get_end() const { return end_; }
     
     // Visitor pattern for AST traversal
     virtual Value evaluate(Context& ctx) = 0;
     virtual std::string to_string() const = 0;
     virtual std::unique_ptr<ASTNode> clone() const = 0;
+    
+    // Profiled sites (binary operations, calls, member accesses) carry the
+    // index of their slot in the enclosing function's FeedbackVector; clones
+    // start unnumbered
+    static constexpr uint32_t NO_FEEDBACK_SLOT = 0xFFFFFFFFu;
+    
+    // Self-specializing nodes start Uninitialized, rewrite themselves into a
+    // variant for what their first execution saw, and fall back to Generic
+    // (for good) on a guard miss they cannot respecialize for. Clones start
+    // Uninitialized
+    enum class Specialization : uint8_t {
+        Uninitialized,
+        Int32,          // BinaryExpression: both operands int32
+        Number,         // BinaryExpression: both operands numbers
+        Binding,        // Identifier: cached declarative binding slot
+        ShapeLoad,      // MemberExpression: o.name from a cached shape offset
+        PackedElement,  // MemberExpression: a[i] from a packed array
+        Generic
+    };
+    static constexpr uint8_t MAX_REWRITES = 4;
 };
 
 /**
  * Literal nodes
+ * Number and string literals box their value once, when they are built:
+ * evaluating one returns the same Value every time. A string literal's cell
+ * is the isolate's interned cell for its text.
  */
 class NumberLiteral : public ASTNode {
 private:
     double value_;
+    Value boxed_;
 
 public:
-    NumberLiteral(double value, const Position& start, const Position& end)
-        : ASTNode(Type::NUMBER_LITERAL, start, end), value_(value) {}
+    NumberLiteral(double value, const Position& start, const Position& end);
     
     double get_value() const { return value_; }
+    const Value& get_boxed() const { return boxed_; }
     
     Value evaluate(Context& ctx) override;
     std::string to_string() const override;
@@ -143,12 +245,13 @@ public:
 class StringLiteral : public ASTNode {
 private:
     std::string value_;
+    Value boxed_;
 
 public:
-    StringLiteral(const std::string& value, const Position& start, const Position& end)
-        : ASTNode(Type::STRING_LITERAL, start, end), value_(value) {}
+    StringLiteral(const std::string& value, const Position& start, const Position& end);
     
     const std::string& get_value() const { return value_; }
+    const Value& get_boxed() const { return boxed_; }
     
     Value evaluate(Context& ctx) override;
     std::string to_string() const override;
@@ -227,6 +330,10 @@ public:
     TemplateLiteral(std::vector<Element> elements, const Position& start, const Position& end)
         : ASTNode(Type::TEMPLATE_LITERAL, start, end), elements_(std::move(elements)) {}
     
+    // Builds the template, or the string literal it always produces when
+    // every substitution is a literal
+    static std::unique_ptr<ASTNode> create(std::vector<Element> elements, const Position& start, const Position& end);
+    
     const std::vector<Element>& get_elements() const { return elements_; }
     
     Value evaluate(Context& ctx) override;
@@ -241,6 +348,9 @@ class RegexLiteral : public ASTNode {
 private:
     std::string pattern_;
     std::string flags_;
+    // Compiled on first evaluation and shared by every RegExp the literal
+    // creates; each call works on a copy, which shares the compiled automaton
+    std::shared_ptr<const RegExp> compiled_;
 
 public:
     RegexLiteral(const std::string& pattern, const std::string& flags,
@@ -261,16 +371,28 @@ public:
 class Identifier : public ASTNode {
 private:
     std::string name_;
+    
+    // Binding specialization: the slot found binding_hops_ environments out,
+    // valid while that environment still has id binding_env_id_ and none of
+    // the nearer ones binds the name
+    Specialization specialization_ = Specialization::Uninitialized;
+    uint16_t binding_hops_ = 0;
+    uint64_t binding_env_id_ = 0;
+    const Value* binding_slot_ = nullptr;
 
 public:
     Identifier(const std::string& name, const Position& start, const Position& end)
         : ASTNode(Type::IDENTIFIER, start, end), name_(name) {}
     
     const std::string& get_name() const { return name_; }
+    Specialization get_specialization() const { return specialization_; }
     
     Value evaluate(Context& ctx) override;
     std::string to_string() const override;
     std::unique_ptr<ASTNode> clone() const override;
+
+private:
+    bool bind_slot(Context& ctx);
 };
 
 /**
@@ -327,6 +449,9 @@ private:
     std::unique_ptr<ASTNode> left_;
     std::unique_ptr<ASTNode> right_;
     Operator operator_;
+    uint32_t feedback_slot_ = NO_FEEDBACK_SLOT;
+    Specialization specialization_ = Specialization::Uninitialized;
+    uint8_t rewrites_ = 0;
 
 public:
     BinaryExpression(std::unique_ptr<ASTNode> left, Operator op, std::unique_ptr<ASTNode> right,
@@ -337,15 +462,34 @@ public:
     ASTNode* get_left() const { return left_.get(); }
     ASTNode* get_right() const { return right_.get(); }
     Operator get_operator() const { return operator_; }
+    uint32_t get_feedback_slot() const { return feedback_slot_; }
+    void set_feedback_slot(uint32_t slot) { feedback_slot_ = slot; }
+    Specialization get_specialization() const { return specialization_; }
     
     Value evaluate(Context& ctx) override;
     std::string to_string() const override;
     std::unique_ptr<ASTNode> clone() const override;
     
+    // Builds the expression, or the literal it folds to when both operands
+    // are literals
+    static std::unique_ptr<ASTNode> create(std::unique_ptr<ASTNode> left, Operator op, std::unique_ptr<ASTNode> right,
+                                           const Position& start, const Position& end);
+    
     static std::string operator_to_string(Operator op);
     static Operator token_type_to_operator(TokenType type);
     static int get_precedence(Operator op);
     static bool is_right_associative(Operator op);
+    
+    // Replaces an object operand of an arithmetic or relational op with what
+    // its Symbol.toPrimitive method returns, if it has one; false if it threw
+    static bool to_primitive_operand(Context& ctx, Operator op, Value& operand);
+
+private:
+    // Applies op (the operator itself, or the arithmetic of a compound
+    // assignment) through the node's specialization, rewriting it as needed
+    Value apply(Context& ctx, Operator op, const Value& left, const Value& right);
+    Value apply_generic(Context& ctx, Operator op, const Value& left, const Value& right);
+    void rewrite(Specialization to);
 };
 
 /**
@@ -386,6 +530,11 @@ public:
     std::string to_string() const override;
     std::unique_ptr<ASTNode> clone() const override;
     
+    // Builds the expression, or the literal it folds to for !, -, +, ~,
+    // typeof and void of a literal
+    static std::unique_ptr<ASTNode> create(Operator op, std::unique_ptr<ASTNode> operand, bool prefix,
+                                           const Position& start, const Position& end);
+    
     static std::string operator_to_string(Operator op);
 };
 
@@ -523,6 +672,7 @@ class CallExpression : public ASTNode {
 private:
     std::unique_ptr<ASTNode> callee_;
     std::vector<std::unique_ptr<ASTNode>> arguments_;
+    uint32_t feedback_slot_ = NO_FEEDBACK_SLOT;
 
 public:
     CallExpression(std::unique_ptr<ASTNode> callee, std::vector<std::unique_ptr<ASTNode>> arguments,
@@ -533,6 +683,8 @@ public:
     ASTNode* get_callee() const { return callee_.get(); }
     const std::vector<std::unique_ptr<ASTNode>>& get_arguments() const { return arguments_; }
     size_t argument_count() const { return arguments_.size(); }
+    uint32_t get_feedback_slot() const { return feedback_slot_; }
+    void set_feedback_slot(uint32_t slot) { feedback_slot_ = slot; }
     
     Value evaluate(Context& ctx) override;
     std::string to_string() const override;
@@ -540,7 +692,6 @@ public:
     
 private:
     Value handle_array_method_call(Object* array, const std::string& method_name, Context& ctx);
-    Value handle_string_method_call(const std::string& str, const std::string& method_name, Context& ctx);
     Value handle_bigint_method_call(BigInt* bigint, const std::string& method_name, Context& ctx);
     Value handle_member_expression_call(Context& ctx);
 };
@@ -553,6 +704,12 @@ private:
     std::unique_ptr<ASTNode> object_;
     std::unique_ptr<ASTNode> property_;
     bool computed_; // true for obj[prop], false for obj.prop
+    uint32_t feedback_slot_ = NO_FEEDBACK_SLOT;
+    Specialization specialization_ = Specialization::Uninitialized;
+    uint8_t rewrites_ = 0;
+    uint8_t cached_type_ = 0;           // ShapeLoad: Object::ObjectType of the receiver
+    uint32_t cached_offset_ = 0;        // ShapeLoad: slot in the receiver's shape storage
+    Shape* cached_shape_ = nullptr;     // ShapeLoad: receiver shape
 
 public:
     MemberExpression(std::unique_ptr<ASTNode> object, std::unique_ptr<ASTNode> property, 
@@ -563,10 +720,18 @@ public:
     ASTNode* get_object() const { return object_.get(); }
     ASTNode* get_property() const { return property_.get(); }
     bool is_computed() const { return computed_; }
+    uint32_t get_feedback_slot() const { return feedback_slot_; }
+    void set_feedback_slot(uint32_t slot) { feedback_slot_ = slot; }
+    Specialization get_specialization() const { return specialization_; }
     
     Value evaluate(Context& ctx) override;
     std::string to_string() const override;
     std::unique_ptr<ASTNode> clone() const override;
+
+private:
+    void specialize_named(Object* receiver, const std::string& key);
+    void specialize_indexed(Object* receiver, const Value& key);
+    void rewrite(Specialization to);
 };
 
 /**
@@ -700,10 +865,18 @@ public:
 class BlockStatement : public ASTNode {
 private:
     std::vector<std::unique_ptr<ASTNode>> statements_;
+    // Whether the block binds let/const names and so needs its own
+    // environment; worked out on first entry
+    enum class Scope : uint8_t { Unknown, None, Lexical };
+    Scope scope_ = Scope::Unknown;
+    // Environment of the last exit, kept for the next entry when nothing
+    // outlived the block holding it
+    Environment* spare_environment_ = nullptr;
 
 public:
     BlockStatement(std::vector<std::unique_ptr<ASTNode>> statements, const Position& start, const Position& end)
         : ASTNode(Type::BLOCK_STATEMENT, start, end), statements_(std::move(statements)) {}
+    ~BlockStatement() override;
     
     const std::vector<std::unique_ptr<ASTNode>>& get_statements() const { return statements_; }
     size_t statement_count() const { return statements_.size(); }
@@ -747,24 +920,20 @@ private:
     std::unique_ptr<ASTNode> test_;
     std::unique_ptr<ASTNode> update_;
     std::unique_ptr<ASTNode> body_;
+    std::unique_ptr<LoopOsrState> osr_state_;   // back-edge profile, created on the first back edge
+    Environment* spare_environment_ = nullptr;  // as in BlockStatement, for let/const loop variables
 
 public:
     ForStatement(std::unique_ptr<ASTNode> init, std::unique_ptr<ASTNode> test,
                  std::unique_ptr<ASTNode> update, std::unique_ptr<ASTNode> body,
-                 const Position& start, const Position& end)
-        : ASTNode(Type::FOR_STATEMENT, start, end), 
-          init_(std::move(init)), test_(std::move(test)), 
-          update_(std::move(update)), body_(std::move(body)) {}
+                 const Position& start, const Position& end);
+    ~ForStatement() override;
     
     ASTNode* get_init() const { return init_.get(); }
     ASTNode* get_test() const { return test_.get(); }
     ASTNode* get_update() const { return update_.get(); }
     ASTNode* get_body() const { return body_.get(); }
     
-    // Standard loop optimization methods
-    bool can_optimize_as_simple_loop() const;
-    Value execute_optimized_loop(Context& ctx) const;
-    
     Value evaluate(Context& ctx) override;
     std::string to_string() const override;
     std::unique_ptr<ASTNode> clone() const override;
@@ -823,12 +992,12 @@ class WhileStatement : public ASTNode {
 private:
     std::unique_ptr<ASTNode> test_;
     std::unique_ptr<ASTNode> body_;
+    std::unique_ptr<LoopOsrState> osr_state_;   // back-edge profile, created on the first back edge
 
 public:
     WhileStatement(std::unique_ptr<ASTNode> test, std::unique_ptr<ASTNode> body,
-                   const Position& start, const Position& end)
-        : ASTNode(Type::WHILE_STATEMENT, start, end), 
-          test_(std::move(test)), body_(std::move(body)) {}
+                   const Position& start, const Position& end);
+    ~WhileStatement() override;
     
     ASTNode* get_test() const { return test_.get(); }
     ASTNode* get_body() const { return body_.get(); }
@@ -845,12 +1014,12 @@ class DoWhileStatement : public ASTNode {
 private:
     std::unique_ptr<ASTNode> body_;
     std::unique_ptr<ASTNode> test_;
+    std::unique_ptr<LoopOsrState> osr_state_;   // back-edge profile, created on the first back edge
 
 public:
     DoWhileStatement(std::unique_ptr<ASTNode> body, std::unique_ptr<ASTNode> test,
-                     const Position& start, const Position& end)
-        : ASTNode(Type::DO_WHILE_STATEMENT, start, end), 
-          body_(std::move(body)), test_(std::move(test)) {}
+                     const Position& start, const Position& end);
+    ~DoWhileStatement() override;
     
     ASTNode* get_body() const { return body_.get(); }
     ASTNode* get_test() const { return test_.get(); }
@@ -895,6 +1064,8 @@ private:
     std::unique_ptr<BlockStatement> body_;
     bool is_async_;
     bool is_generator_;
+    std::shared_ptr<SharedFunctionInfo> shared_info_;   // built on first evaluation
+    bool captures_scope_ = true;    // cleared by scope analysis of the enclosing function
 
 public:
     FunctionDeclaration(std::unique_ptr<Identifier> id, 
@@ -911,6 +1082,11 @@ public:
     size_t param_count() const { return params_.size(); }
     bool is_async() const { return is_async_; }
     bool is_generator() const { return is_generator_; }
+    const std::shared_ptr<SharedFunctionInfo>& get_shared_info();
+    // False when nothing in the literal names a binding of the function it
+    // appears in: its closures then skip that activation (see AST.cpp)
+    bool captures_scope() const { return captures_scope_; }
+    void set_captures_scope(bool captures) { captures_scope_ = captures; }
     
     Value evaluate(Context& ctx) override;
     std::string to_string() const override;
@@ -998,6 +1174,8 @@ private:
     std::unique_ptr<Identifier> id_; // optional name for named function expressions
     std::vector<std::unique_ptr<Parameter>> params_;
     std::unique_ptr<BlockStatement> body_;
+    std::shared_ptr<SharedFunctionInfo> shared_info_;   // built on first evaluation
+    bool captures_scope_ = true;    // cleared by scope analysis of the enclosing function
 
 public:
     FunctionExpression(std::unique_ptr<Identifier> id,
@@ -1012,6 +1190,9 @@ public:
     BlockStatement* get_body() const { return body_.get(); }
     size_t param_count() const { return params_.size(); }
     bool is_named() const { return id_ != nullptr; }
+    const std::shared_ptr<SharedFunctionInfo>& get_shared_info();
+    bool captures_scope() const { return captures_scope_; }
+    void set_captures_scope(bool captures) { captures_scope_ = captures; }
     
     Value evaluate(Context& ctx) override;
     std::string to_string() const override;
@@ -1026,6 +1207,8 @@ private:
     std::vector<std::unique_ptr<Parameter>> params_;
     std::unique_ptr<ASTNode> body_; // Can be BlockStatement or Expression
     bool is_async_;
+    std::shared_ptr<SharedFunctionInfo> shared_info_;   // built on first evaluation
+    bool captures_scope_ = true;    // cleared by scope analysis of the enclosing function
 
 public:
     ArrowFunctionExpression(std::vector<std::unique_ptr<Parameter>> params,
@@ -1040,6 +1223,9 @@ public:
     size_t param_count() const { return params_.size(); }
     bool is_async() const { return is_async_; }
     bool has_block_body() const { return body_->get_type() == Type::BLOCK_STATEMENT; }
+    const std::shared_ptr<SharedFunctionInfo>& get_shared_info();
+    bool captures_scope() const { return captures_scope_; }
+    void set_captures_scope(bool captures) { captures_scope_ = captures; }
     
     Value evaluate(Context& ctx) override;
     std::string to_string() const override;
@@ -1267,6 +1453,9 @@ public:
     ASTNode* get_catch_clause() const { return catch_clause_.get(); }
     ASTNode* get_finally_block() const { return finally_block_.get(); }
     
+    // Try statements being evaluated on the running stack
+    static int& nesting_depth();
+    
     Value evaluate(Context& ctx) override;
     std::string to_string() const override;
     std::unique_ptr<ASTNode> clone() const override;
@@ -1370,6 +1559,8 @@ public:
  */
 class Program : public ASTNode {
 private:
+    // Declared first so the nodes it holds are destroyed before it is
+    std::shared_ptr<ASTArena> arena_;
     std::vector<std::unique_ptr<ASTNode>> statements_;
     
     void check_use_strict_directive(Context& ctx);
@@ -1379,10 +1570,16 @@ private:
 public:
     Program(std::vector<std::unique_ptr<ASTNode>> statements, const Position& start, const Position& end)
         : ASTNode(Type::PROGRAM, start, end), statements_(std::move(statements)) {}
+    Program(std::shared_ptr<ASTArena> arena, std::vector<std::unique_ptr<ASTNode>> statements,
+            const Position& start, const Position& end)
+        : ASTNode(Type::PROGRAM, start, end), arena_(std::move(arena)), statements_(std::move(statements)) {}
     
     const std::vector<std::unique_ptr<ASTNode>>& get_statements() const { return statements_; }
     size_t statement_count() const { return statements_.size(); }
     
+    // The arena the parsed statements live in; null for clones
+    const std::shared_ptr<ASTArena>& get_arena() const { return arena_; }
+    
     Value evaluate(Context& ctx) override;
     std::string to_string() const override;
     std::unique_ptr<ASTNode> clone() const override;
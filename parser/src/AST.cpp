@@ -20,9 +20,13 @@
 #include "../../core/include/Generator.h"
 #include "../../core/include/ModuleLoader.h"
 #include "../../core/include/Math.h"
+#include "../../core/include/FeedbackVector.h"
+#include "../../core/include/OptimizingCompiler.h"
 #include <cstdlib>
 #include "../../core/include/JIT.h"
 #include "../../core/include/String.h"
+#include "../../core/include/Isolate.h"
+#include "../../core/include/DataView.h"
 #include <sstream>
 #include <iostream>
 #include <algorithm>
@@ -30,22 +34,146 @@
 #include <iomanip>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace Quanta {
 
-// Global function storage for object methods
-static std::unordered_map<std::string, Value> g_object_function_map;
+// Function storage for object methods (per thread: each engine runs on one thread at a time)
+static thread_local std::unordered_map<std::string, Value> g_object_function_map;
 
-// Global mapping for tracking which variable 'this' refers to in function contexts
-static std::unordered_map<const Context*, std::string> g_this_variable_map;
+// Mapping for tracking which variable 'this' refers to in function contexts
+static thread_local std::unordered_map<const Context*, std::string> g_this_variable_map;
+
+// A named property of a string or number primitive: a string's "length",
+// anything else from the isolate's String.prototype or Number.prototype
+static Value primitive_property(const Value& primitive, const std::string& key) {
+    Object* prototype = nullptr;
+    if (primitive.is_string()) {
+        if (key == "length") return Value(static_cast<double>(primitive.as_string()->length()));
+        prototype = Isolate::current().prototypes().string;
+    } else if (primitive.is_number()) {
+        prototype = Isolate::current().prototypes().number;
+    }
+    return prototype ? prototype->get_property(key) : Value();
+}
+
+// Expressions that nest without a call check the stack an async body runs
+// on, as Function::call does, and stop with a RangeError near its end
+static bool async_stack_exhausted(Context& ctx) {
+    if (!AsyncActivation::stack_exhausted()) return false;
+    ctx.throw_range_error("Maximum call stack size exceeded");
+    return true;
+}
+
+// A number as a Value, with NaN and the infinities in their own encodings
+static Value number_result(double d) {
+    if (std::isnan(d)) return Value::nan();
+    if (std::isinf(d)) return d > 0 ? Value::positive_infinity() : Value::negative_infinity();
+    return Value(d);
+}
+
+//=============================================================================
+// AST arena
+//=============================================================================
+
+thread_local ASTArena* ASTArena::current_ = nullptr;
+
+ASTArena::~ASTArena() {
+    for (char* chunk : chunks_) {
+        ::operator delete(chunk);
+    }
+}
+
+void* ASTArena::allocate(size_t size) {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    ++allocation_count_;
+    used_bytes_ += size;
+    
+    // Oversized requests get a chunk of their own and leave the bump
+    // chunk alone
+    if (size > CHUNK_SIZE / 4) {
+        char* chunk = static_cast<char*>(::operator new(size));
+        chunks_.push_back(chunk);
+        reserved_bytes_ += size;
+        return chunk;
+    }
+    
+    if (static_cast<size_t>(bump_end_ - bump_) < size) {
+        bump_ = static_cast<char*>(::operator new(CHUNK_SIZE));
+        bump_end_ = bump_ + CHUNK_SIZE;
+        chunks_.push_back(bump_);
+        reserved_bytes_ += CHUNK_SIZE;
+    }
+    char* result = bump_;
+    bump_ += size;
+    return result;
+}
+
+// Every node is preceded by the arena it came from, or null for the heap
+static constexpr size_t NODE_PREFIX_SIZE = ASTArena::ALIGNMENT;
+
+void* ASTNode::operator new(size_t size) {
+    ASTArena* arena = ASTArena::current();
+    void* block = arena ? arena->allocate(size + NODE_PREFIX_SIZE) : ::operator new(size + NODE_PREFIX_SIZE);
+    *static_cast<ASTArena**>(block) = arena;
+    return static_cast<char*>(block) + NODE_PREFIX_SIZE;
+}
+
+void ASTNode::operator delete(void* ptr) {
+    if (!ptr) return;
+    void* block = static_cast<char*>(ptr) - NODE_PREFIX_SIZE;
+    // Arena storage is released with the whole arena
+    if (!*static_cast<ASTArena**>(block)) {
+        ::operator delete(block);
+    }
+}
+
+//=============================================================================
+// Node rewrite counters
+//=============================================================================
+
+NodeRewriteStats& NodeRewriteStats::current() {
+    static thread_local NodeRewriteStats stats;
+    return stats;
+}
+
+void NodeRewriteStats::reset() {
+    *this = NodeRewriteStats();
+}
+
+std::string NodeRewriteStats::to_string() const {
+    static const char* const names[SITE_COUNT] = {"binary", "member", "identifier"};
+    std::ostringstream oss;
+    oss << "Node rewrites:";
+    for (int site = 0; site < SITE_COUNT; ++site) {
+        oss << " " << names[site] << "=" << specialized[site] << "/" << respecialized[site]
+            << "/" << generalized[site];
+    }
+    oss << " (specialized/respecialized/generalized)";
+    return oss.str();
+}
+
+static void count_rewrite(NodeRewriteStats::Site site, ASTNode::Specialization from, ASTNode::Specialization to) {
+    NodeRewriteStats& stats = NodeRewriteStats::current();
+    if (to == ASTNode::Specialization::Generic) {
+        ++stats.generalized[site];
+    } else if (from == ASTNode::Specialization::Uninitialized) {
+        ++stats.specialized[site];
+    } else {
+        ++stats.respecialized[site];
+    }
+}
 
 //=============================================================================
 // NumberLiteral Implementation
 //=============================================================================
 
+NumberLiteral::NumberLiteral(double value, const Position& start, const Position& end)
+    : ASTNode(Type::NUMBER_LITERAL, start, end), value_(value), boxed_(number_result(value)) {}
+
 Value NumberLiteral::evaluate(Context& ctx) {
     (void)ctx; // Suppress unused parameter warning
-    return Value(value_);
+    return boxed_;
 }
 
 std::string NumberLiteral::to_string() const {
@@ -60,9 +188,13 @@ std::unique_ptr<ASTNode> NumberLiteral::clone() const {
 // StringLiteral Implementation
 //=============================================================================
 
+StringLiteral::StringLiteral(const std::string& value, const Position& start, const Position& end)
+    : ASTNode(Type::STRING_LITERAL, start, end), value_(value),
+      boxed_(Isolate::current().intern_literal(value)) {}
+
 Value StringLiteral::evaluate(Context& ctx) {
     (void)ctx; // Suppress unused parameter warning
-    return Value(value_);
+    return boxed_;
 }
 
 std::string StringLiteral::to_string() const {
@@ -147,6 +279,39 @@ std::unique_ptr<ASTNode> UndefinedLiteral::clone() const {
     return std::make_unique<UndefinedLiteral>(start_, end_);
 }
 
+// The value of a number, string, boolean, null or undefined literal
+static bool literal_value(const ASTNode* node, Value& out) {
+    switch (node->get_type()) {
+        case ASTNode::Type::NUMBER_LITERAL:
+            out = static_cast<const NumberLiteral*>(node)->get_boxed();
+            return true;
+        case ASTNode::Type::STRING_LITERAL:
+            out = static_cast<const StringLiteral*>(node)->get_boxed();
+            return true;
+        case ASTNode::Type::BOOLEAN_LITERAL:
+            out = Value(static_cast<const BooleanLiteral*>(node)->get_value());
+            return true;
+        case ASTNode::Type::NULL_LITERAL:
+            out = Value::null();
+            return true;
+        case ASTNode::Type::UNDEFINED_LITERAL:
+            out = Value();
+            return true;
+        default:
+            return false;
+    }
+}
+
+// The literal node that evaluates to a folded primitive
+static std::unique_ptr<ASTNode> literal_node(const Value& value, const Position& start, const Position& end) {
+    if (value.is_number()) return std::make_unique<NumberLiteral>(value.to_number(), start, end);
+    if (value.is_string()) return std::make_unique<StringLiteral>(value.to_string(), start, end);
+    if (value.is_boolean()) return std::make_unique<BooleanLiteral>(value.as_boolean(), start, end);
+    if (value.is_null()) return std::make_unique<NullLiteral>(start, end);
+    if (value.is_undefined()) return std::make_unique<UndefinedLiteral>(start, end);
+    return nullptr;
+}
+
 //=============================================================================
 // TemplateLiteral Implementation
 //=============================================================================
@@ -167,6 +332,22 @@ Value TemplateLiteral::evaluate(Context& ctx) {
     return Value(result);
 }
 
+std::unique_ptr<ASTNode> TemplateLiteral::create(std::vector<Element> elements, const Position& start, const Position& end) {
+    std::string text;
+    for (const auto& element : elements) {
+        if (element.type == Element::Type::TEXT) {
+            text += element.text;
+            continue;
+        }
+        Value value;
+        if (!literal_value(element.expression.get(), value)) {
+            return std::make_unique<TemplateLiteral>(std::move(elements), start, end);
+        }
+        text += value.to_string();
+    }
+    return std::make_unique<StringLiteral>(text, start, end);
+}
+
 std::string TemplateLiteral::to_string() const {
     std::ostringstream oss;
     oss << "`";
@@ -232,6 +413,27 @@ std::unique_ptr<ASTNode> Parameter::clone() const {
 //=============================================================================
 
 Value Identifier::evaluate(Context& ctx) {
+    if (specialization_ == Specialization::Binding) {
+        // The cached slot holds while the environment binding_hops_ out is
+        // the one it was found in and nothing nearer binds the name
+        Environment* env = ctx.get_lexical_environment();
+        for (uint16_t hop = 0; env && hop < binding_hops_; ++hop) {
+            env = env->has_own_binding(name_) ? nullptr : env->get_outer();
+        }
+        if (env && env->get_id() == binding_env_id_) return *binding_slot_;
+        
+        // Another activation of the same code, or a new shadowing binding
+        if (bind_slot(ctx)) return *binding_slot_;
+        count_rewrite(NodeRewriteStats::IDENTIFIER, specialization_, Specialization::Generic);
+        specialization_ = Specialization::Generic;
+    } else if (specialization_ == Specialization::Uninitialized) {
+        bool bound = name_ != "super" && name_ != "Math" && bind_slot(ctx);
+        Specialization next = bound ? Specialization::Binding : Specialization::Generic;
+        count_rewrite(NodeRewriteStats::IDENTIFIER, specialization_, next);
+        specialization_ = next;
+        if (bound) return *binding_slot_;
+    }
+    
     if (name_ == "super") {
         Value super_constructor = ctx.get_binding("__super__");
         return super_constructor;
@@ -280,6 +482,23 @@ std::string Identifier::to_string() const {
     return name_;
 }
 
+// Finds the declarative binding the name resolves to and caches its slot;
+// false for unbound names and names an object environment provides
+bool Identifier::bind_slot(Context& ctx) {
+    uint16_t hops = 0;
+    for (Environment* env = ctx.get_lexical_environment(); env; env = env->get_outer()) {
+        if (const Value* slot = env->find_own_binding_slot(name_)) {
+            binding_hops_ = hops;
+            binding_env_id_ = env->get_id();
+            binding_slot_ = slot;
+            return true;
+        }
+        if (env->get_binding_object() && env->has_own_binding(name_)) return false;
+        if (++hops == UINT16_MAX) return false;
+    }
+    return false;
+}
+
 std::unique_ptr<ASTNode> Identifier::clone() const {
     return std::make_unique<Identifier>(name_, start_, end_);
 }
@@ -288,8 +507,120 @@ std::unique_ptr<ASTNode> Identifier::clone() const {
 // BinaryExpression Implementation
 //=============================================================================
 
+// Operators a BinaryExpression specializes on number operands
+static bool is_numeric_operator(BinaryExpression::Operator op) {
+    using Op = BinaryExpression::Operator;
+    switch (op) {
+        case Op::ADD: case Op::SUBTRACT: case Op::MULTIPLY: case Op::DIVIDE: case Op::MODULO:
+        case Op::EQUAL: case Op::NOT_EQUAL: case Op::STRICT_EQUAL: case Op::STRICT_NOT_EQUAL:
+        case Op::LESS_THAN: case Op::GREATER_THAN: case Op::LESS_EQUAL: case Op::GREATER_EQUAL:
+        case Op::BITWISE_AND: case Op::BITWISE_OR: case Op::BITWISE_XOR:
+        case Op::LEFT_SHIFT: case Op::RIGHT_SHIFT: case Op::UNSIGNED_RIGHT_SHIFT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// The arithmetic operator of a compound assignment
+static BinaryExpression::Operator compound_operator(BinaryExpression::Operator op) {
+    using Op = BinaryExpression::Operator;
+    switch (op) {
+        case Op::PLUS_ASSIGN: return Op::ADD;
+        case Op::MINUS_ASSIGN: return Op::SUBTRACT;
+        case Op::MULTIPLY_ASSIGN: return Op::MULTIPLY;
+        case Op::DIVIDE_ASSIGN: return Op::DIVIDE;
+        case Op::MODULO_ASSIGN: return Op::MODULO;
+        default: return op;
+    }
+}
+
+static bool as_int32(const Value& value, int32_t& out) {
+    if (!value.is_number()) return false;
+    double d = value.as_number();
+    if (!(d >= -2147483648.0 && d <= 2147483647.0)) return false;
+    int32_t i = static_cast<int32_t>(d);
+    if (static_cast<double>(i) != d || (i == 0 && std::signbit(d))) return false;
+    out = i;
+    return true;
+}
+
+// ToInt32 of a number
+static int32_t wrap_int32(double d) {
+    if (!std::isfinite(d)) return 0;
+    double wrapped = std::fmod(std::trunc(d), 4294967296.0);
+    if (wrapped < 0) wrapped += 4294967296.0;
+    return static_cast<int32_t>(static_cast<uint32_t>(wrapped));
+}
+
+static Value int32_operation(BinaryExpression::Operator op, int32_t a, int32_t b) {
+    using Op = BinaryExpression::Operator;
+    switch (op) {
+        case Op::ADD: return Value(static_cast<double>(static_cast<int64_t>(a) + b));
+        case Op::SUBTRACT: return Value(static_cast<double>(static_cast<int64_t>(a) - b));
+        case Op::MULTIPLY: {
+            int64_t product = static_cast<int64_t>(a) * b;
+            if (product == 0 && (a < 0 || b < 0)) return Value(-0.0);
+            return Value(static_cast<double>(product));
+        }
+        case Op::DIVIDE: return number_result(static_cast<double>(a) / b);
+        case Op::MODULO: {
+            if (b == 0) return Value::nan();
+            int64_t remainder = static_cast<int64_t>(a) % b;
+            if (remainder == 0 && a < 0) return Value(-0.0);
+            return Value(static_cast<double>(remainder));
+        }
+        case Op::EQUAL: case Op::STRICT_EQUAL: return Value(a == b);
+        case Op::NOT_EQUAL: case Op::STRICT_NOT_EQUAL: return Value(a != b);
+        case Op::LESS_THAN: return Value(a < b);
+        case Op::GREATER_THAN: return Value(a > b);
+        case Op::LESS_EQUAL: return Value(a <= b);
+        case Op::GREATER_EQUAL: return Value(a >= b);
+        case Op::BITWISE_AND: return Value(static_cast<double>(a & b));
+        case Op::BITWISE_OR: return Value(static_cast<double>(a | b));
+        case Op::BITWISE_XOR: return Value(static_cast<double>(a ^ b));
+        case Op::LEFT_SHIFT:
+            return Value(static_cast<double>(static_cast<int32_t>(static_cast<uint32_t>(a) << (b & 31))));
+        case Op::RIGHT_SHIFT: return Value(static_cast<double>(a >> (b & 31)));
+        case Op::UNSIGNED_RIGHT_SHIFT: return Value(static_cast<double>(static_cast<uint32_t>(a) >> (b & 31)));
+        default: return Value();
+    }
+}
+
+static Value number_operation(BinaryExpression::Operator op, double a, double b) {
+    using Op = BinaryExpression::Operator;
+    switch (op) {
+        case Op::ADD: return number_result(a + b);
+        case Op::SUBTRACT: return number_result(a - b);
+        case Op::MULTIPLY: return number_result(a * b);
+        case Op::DIVIDE: return number_result(a / b);
+        case Op::MODULO: return number_result(std::fmod(a, b));
+        case Op::EQUAL: case Op::STRICT_EQUAL: return Value(a == b);
+        case Op::NOT_EQUAL: case Op::STRICT_NOT_EQUAL: return Value(a != b);
+        case Op::LESS_THAN: return Value(a < b);
+        case Op::GREATER_THAN: return Value(a > b);
+        case Op::LESS_EQUAL: return Value(a <= b);
+        case Op::GREATER_EQUAL: return Value(a >= b);
+        default: return int32_operation(op, wrap_int32(a), wrap_int32(b));
+    }
+}
+
 Value BinaryExpression::evaluate(Context& ctx) {
-    // JIT compilation removed - was simulation code
+    if (async_stack_exhausted(ctx)) return Value();
+    
+    // Specialized arithmetic, comparison and bitwise nodes skip the operator
+    // dispatch below
+    if ((specialization_ == Specialization::Int32 || specialization_ == Specialization::Number) &&
+        is_numeric_operator(operator_)) {
+        Value left_value = left_->evaluate(ctx);
+        if (ctx.has_exception()) return Value();
+        Value right_value = right_->evaluate(ctx);
+        if (ctx.has_exception()) return Value();
+        if (feedback_slot_ != NO_FEEDBACK_SLOT && ctx.get_feedback_vector()) {
+            ctx.get_feedback_vector()->record_binary_op(feedback_slot_, left_value, right_value);
+        }
+        return apply(ctx, operator_, left_value, right_value);
+    }
     
     // Handle assignment operators specially
     if (operator_ == Operator::ASSIGN || 
@@ -311,31 +642,13 @@ Value BinaryExpression::evaluate(Context& ctx) {
         if (operator_ != Operator::ASSIGN) {
             Value left_value = left_->evaluate(ctx);
             if (ctx.has_exception()) return Value();
+            if (feedback_slot_ != NO_FEEDBACK_SLOT && ctx.get_feedback_vector()) {
+                ctx.get_feedback_vector()->record_binary_op(feedback_slot_, left_value, right_value);
+            }
             
             // Perform the compound operation
-            switch (operator_) {
-                case Operator::ASSIGN:
-                    // For simple assignment, just use the right value
-                    result_value = right_value;
-                    break;
-                case Operator::PLUS_ASSIGN:
-                    result_value = left_value.add(right_value);
-                    break;
-                case Operator::MINUS_ASSIGN:
-                    result_value = left_value.subtract(right_value);
-                    break;
-                case Operator::MULTIPLY_ASSIGN:
-                    result_value = left_value.multiply(right_value);
-                    break;
-                case Operator::DIVIDE_ASSIGN:
-                    result_value = left_value.divide(right_value);
-                    break;
-                case Operator::MODULO_ASSIGN:
-                    result_value = left_value.modulo(right_value);
-                    break;
-                default:
-                    break;
-            }
+            result_value = apply(ctx, compound_operator(operator_), left_value, right_value);
+            if (ctx.has_exception()) return Value();
         }
         
         // Support identifier assignment with strict mode checking
@@ -440,11 +753,12 @@ Value BinaryExpression::evaluate(Context& ctx) {
             if (obj) {
                 // Get the property key
                 std::string key;
+                Value key_value;
                 if (member->is_computed()) {
                     // For obj[expr] = value
-                    Value key_value = member->get_property()->evaluate(ctx);
+                    key_value = member->get_property()->evaluate(ctx);
                     if (ctx.has_exception()) return Value();
-                    key = key_value.to_string();
+                    key = key_value.to_property_key();
                 } else {
                     // For obj.prop = value
                     if (member->get_property()->get_type() == ASTNode::Type::IDENTIFIER) {
@@ -456,6 +770,15 @@ Value BinaryExpression::evaluate(Context& ctx) {
                     }
                 }
                 
+                // Stores profile the target's member site
+                if (member->get_feedback_slot() != NO_FEEDBACK_SLOT && ctx.get_feedback_vector()) {
+                    if (member->is_computed()) {
+                        ctx.get_feedback_vector()->record_element(member->get_feedback_slot(), obj, key_value);
+                    } else {
+                        ctx.get_feedback_vector()->record_property(member->get_feedback_slot(), obj, key);
+                    }
+                }
+                
                 // Check if this is an accessor property (has getter/setter)
                 PropertyDescriptor desc = obj->get_property_descriptor(key);
                 if (desc.is_accessor_descriptor() && desc.has_setter()) {
@@ -480,7 +803,7 @@ Value BinaryExpression::evaluate(Context& ctx) {
                         // For computed access like obj[expr]
                         Value prop_value = member->get_property()->evaluate(ctx);
                         if (ctx.has_exception()) return Value();
-                        prop_name = prop_value.to_string();
+                        prop_name = prop_value.to_property_key();
                     } else {
                         // For dot access like obj.prop
                         if (member->get_property()->get_type() == ASTNode::Type::IDENTIFIER) {
@@ -580,6 +903,86 @@ Value BinaryExpression::evaluate(Context& ctx) {
     Value right_value = right_->evaluate(ctx);
     if (ctx.has_exception()) return Value();
     
+    if (feedback_slot_ != NO_FEEDBACK_SLOT && ctx.get_feedback_vector()) {
+        ctx.get_feedback_vector()->record_binary_op(feedback_slot_, left_value, right_value);
+    }
+    
+    return apply(ctx, operator_, left_value, right_value);
+}
+
+Value BinaryExpression::apply(Context& ctx, Operator op, const Value& left, const Value& right) {
+    switch (specialization_) {
+        case Specialization::Int32: {
+            int32_t a, b;
+            if (as_int32(left, a) && as_int32(right, b)) return int32_operation(op, a, b);
+            break;
+        }
+        case Specialization::Number:
+            if (left.is_number() && right.is_number()) return number_operation(op, left.as_number(), right.as_number());
+            break;
+        case Specialization::Generic:
+            return apply_generic(ctx, op, left, right);
+        default:
+            break;
+    }
+    
+    // First execution or a guard miss: int32 operands widen to numbers,
+    // anything else goes generic
+    int32_t a, b;
+    Specialization next = Specialization::Generic;
+    if (is_numeric_operator(op) && left.is_number() && right.is_number()) {
+        next = specialization_ == Specialization::Uninitialized && as_int32(left, a) && as_int32(right, b)
+            ? Specialization::Int32 : Specialization::Number;
+    }
+    rewrite(next);
+    return specialization_ == Specialization::Generic ? apply_generic(ctx, op, left, right)
+                                                      : apply(ctx, op, left, right);
+}
+
+void BinaryExpression::rewrite(Specialization to) {
+    if (to != Specialization::Generic && rewrites_ >= MAX_REWRITES) to = Specialization::Generic;
+    ++rewrites_;
+    count_rewrite(NodeRewriteStats::BINARY, specialization_, to);
+    specialization_ = to;
+}
+
+bool BinaryExpression::to_primitive_operand(Context& ctx, Operator op, Value& operand) {
+    // Shape bits rule the method out, without a lookup, for all but the
+    // objects that have one somewhere on their prototype chain
+    if (!operand.is_object() || !operand.as_object()->may_have_symbol_key(Shape::TO_PRIMITIVE_KEY)) return true;
+    
+    const char* hint;
+    switch (op) {
+        case Operator::ADD: case Operator::PLUS_ASSIGN:
+            hint = "default";
+            break;
+        case Operator::SUBTRACT: case Operator::MULTIPLY: case Operator::DIVIDE: case Operator::MODULO:
+        case Operator::EXPONENT: case Operator::MINUS_ASSIGN: case Operator::MULTIPLY_ASSIGN:
+        case Operator::DIVIDE_ASSIGN: case Operator::MODULO_ASSIGN:
+        case Operator::LESS_THAN: case Operator::GREATER_THAN: case Operator::LESS_EQUAL: case Operator::GREATER_EQUAL:
+            hint = "number";
+            break;
+        default:
+            return true;
+    }
+    
+    Value method = operand.as_object()->get_property(Symbol::well_known_key(WellKnownSymbol::ToPrimitive));
+    if (method.is_undefined() || method.is_null()) return true;
+    if (!method.is_function()) {
+        ctx.throw_type_error("Symbol.toPrimitive is not a function");
+        return false;
+    }
+    Value result = method.as_function()->call(ctx, {Value(std::string(hint))}, operand);
+    if (ctx.has_exception()) return false;
+    if (result.is_object() || result.is_function()) {
+        ctx.throw_type_error("Cannot convert object to primitive value");
+        return false;
+    }
+    operand = result;
+    return true;
+}
+
+Value BinaryExpression::apply_generic(Context& ctx, Operator op, const Value& left_value, const Value& right_value) {
     // ULTRA-AGGRESSIVE HIGH-PERFORMANCE OPTIMIZATION
     // Inline fast path for number operations (99% of benchmark cases)
     if (__builtin_expect(left_value.is_number() && right_value.is_number(), 1)) {
@@ -588,7 +991,7 @@ Value BinaryExpression::evaluate(Context& ctx) {
         double right_num = right_value.as_number();
         
         // Branch prediction optimized switch
-        switch (operator_) {
+        switch (op) {
             case Operator::ADD: {
                 // Inline assembly hint for maximum speed
                 double result = left_num + right_num;
@@ -643,8 +1046,10 @@ Value BinaryExpression::evaluate(Context& ctx) {
                 return Value(result);
             }
             case Operator::MODULO: {
-                // Optimized modulo using compiler intrinsic
-                double result = left_num - static_cast<long long>(left_num / right_num) * right_num;
+                double result = std::fmod(left_num, right_num);
+                if (std::isnan(result)) {
+                    return Value::nan();
+                }
                 return Value(result);
             }
             default:
@@ -652,8 +1057,20 @@ Value BinaryExpression::evaluate(Context& ctx) {
         }
     }
     
+    // Objects defining Symbol.toPrimitive take part as what it returns
+    if (__builtin_expect(left_value.is_object() || right_value.is_object(), 0)) {
+        Value left_primitive = left_value;
+        Value right_primitive = right_value;
+        if (!to_primitive_operand(ctx, op, left_primitive) || !to_primitive_operand(ctx, op, right_primitive)) {
+            return Value();
+        }
+        if (left_primitive.is_object() != left_value.is_object() || right_primitive.is_object() != right_value.is_object()) {
+            return apply_generic(ctx, op, left_primitive, right_primitive);
+        }
+    }
+    
     // Generic path for non-number operations
-    switch (operator_) {
+    switch (op) {
         case Operator::ADD:
             return left_value.add(right_value);
         case Operator::SUBTRACT:
@@ -689,7 +1106,7 @@ Value BinaryExpression::evaluate(Context& ctx) {
             
         case Operator::IN: {
             // The 'in' operator checks if a property exists in an object
-            std::string property_name = left_value.to_string();
+            std::string property_name = left_value.to_property_key();
             if (!right_value.is_object()) {
                 ctx.throw_error("TypeError: Cannot use 'in' operator on non-object");
                 return Value(false);
@@ -727,6 +1144,42 @@ std::unique_ptr<ASTNode> BinaryExpression::clone() const {
     );
 }
 
+std::unique_ptr<ASTNode> BinaryExpression::create(std::unique_ptr<ASTNode> left, Operator op, std::unique_ptr<ASTNode> right,
+                                                  const Position& start, const Position& end) {
+    Value l, r;
+    if (!literal_value(left.get(), l) || !literal_value(right.get(), r)) {
+        return std::make_unique<BinaryExpression>(std::move(left), op, std::move(right), start, end);
+    }
+    
+    // Only operators whose result depends on nothing but the two primitives
+    // fold; anything else keeps its node and runs as written
+    Value folded;
+    bool foldable = true;
+    if (l.is_number() && r.is_number() && is_numeric_operator(op)) {
+        folded = number_operation(op, l.to_number(), r.to_number());
+    } else if (l.is_number() && r.is_number() && op == Operator::EXPONENT) {
+        folded = l.power(r);
+    } else if (op == Operator::ADD && (l.is_string() || r.is_string())) {
+        folded = l.add(r);
+    } else if (op == Operator::STRICT_EQUAL || op == Operator::STRICT_NOT_EQUAL) {
+        folded = Value(l.strict_equals(r) == (op == Operator::STRICT_EQUAL));
+    } else if (op == Operator::EQUAL || op == Operator::NOT_EQUAL) {
+        folded = Value(l.loose_equals(r) == (op == Operator::EQUAL));
+    } else if (op == Operator::LOGICAL_AND) {
+        return l.to_boolean() ? std::move(right) : std::move(left);
+    } else if (op == Operator::LOGICAL_OR) {
+        return l.to_boolean() ? std::move(left) : std::move(right);
+    } else {
+        foldable = false;
+    }
+    
+    std::unique_ptr<ASTNode> literal = foldable ? literal_node(folded, start, end) : nullptr;
+    if (!literal) {
+        return std::make_unique<BinaryExpression>(std::move(left), op, std::move(right), start, end);
+    }
+    return literal;
+}
+
 std::string BinaryExpression::operator_to_string(Operator op) {
     switch (op) {
         case Operator::ADD: return "+";
@@ -842,6 +1295,8 @@ bool BinaryExpression::is_right_associative(Operator op) {
 //=============================================================================
 
 Value UnaryExpression::evaluate(Context& ctx) {
+    if (async_stack_exhausted(ctx)) return Value();
+    
     switch (operator_) {
         case Operator::PLUS: {
             Value operand_value = operand_->evaluate(ctx);
@@ -890,7 +1345,7 @@ Value UnaryExpression::evaluate(Context& ctx) {
                 if (member->is_computed()) {
                     Value prop_value = member->get_property()->evaluate(ctx);
                     if (ctx.has_exception()) return Value();
-                    property_name = prop_value.to_string();
+                    property_name = prop_value.to_property_key();
                 } else {
                     if (member->get_property()->get_type() == ASTNode::Type::IDENTIFIER) {
                         Identifier* id = static_cast<Identifier*>(member->get_property());
@@ -935,7 +1390,7 @@ Value UnaryExpression::evaluate(Context& ctx) {
                 if (member->is_computed()) {
                     Value prop_value = member->get_property()->evaluate(ctx);
                     if (ctx.has_exception()) return Value();
-                    prop_name = prop_value.to_string();
+                    prop_name = prop_value.to_property_key();
                 } else {
                     if (member->get_property()->get_type() == ASTNode::Type::IDENTIFIER) {
                         Identifier* id = static_cast<Identifier*>(member->get_property());
@@ -979,7 +1434,7 @@ Value UnaryExpression::evaluate(Context& ctx) {
                 if (member->is_computed()) {
                     Value prop_value = member->get_property()->evaluate(ctx);
                     if (ctx.has_exception()) return Value();
-                    prop_name = prop_value.to_string();
+                    prop_name = prop_value.to_property_key();
                 } else {
                     if (member->get_property()->get_type() == ASTNode::Type::IDENTIFIER) {
                         Identifier* id = static_cast<Identifier*>(member->get_property());
@@ -1023,7 +1478,7 @@ Value UnaryExpression::evaluate(Context& ctx) {
                 if (member->is_computed()) {
                     Value prop_value = member->get_property()->evaluate(ctx);
                     if (ctx.has_exception()) return Value();
-                    prop_name = prop_value.to_string();
+                    prop_name = prop_value.to_property_key();
                 } else {
                     if (member->get_property()->get_type() == ASTNode::Type::IDENTIFIER) {
                         Identifier* id = static_cast<Identifier*>(member->get_property());
@@ -1067,7 +1522,7 @@ Value UnaryExpression::evaluate(Context& ctx) {
                 if (member->is_computed()) {
                     Value prop_value = member->get_property()->evaluate(ctx);
                     if (ctx.has_exception()) return Value();
-                    prop_name = prop_value.to_string();
+                    prop_name = prop_value.to_property_key();
                 } else {
                     if (member->get_property()->get_type() == ASTNode::Type::IDENTIFIER) {
                         Identifier* id = static_cast<Identifier*>(member->get_property());
@@ -1103,6 +1558,33 @@ std::unique_ptr<ASTNode> UnaryExpression::clone() const {
     return std::make_unique<UnaryExpression>(operator_, operand_->clone(), prefix_, start_, end_);
 }
 
+std::unique_ptr<ASTNode> UnaryExpression::create(Operator op, std::unique_ptr<ASTNode> operand, bool prefix,
+                                                 const Position& start, const Position& end) {
+    Value value;
+    if (!literal_value(operand.get(), value)) {
+        return std::make_unique<UnaryExpression>(op, std::move(operand), prefix, start, end);
+    }
+    
+    Value folded;
+    switch (op) {
+        case Operator::PLUS: folded = value.unary_plus(); break;
+        case Operator::MINUS: folded = value.unary_minus(); break;
+        case Operator::LOGICAL_NOT: folded = value.logical_not(); break;
+        case Operator::BITWISE_NOT: folded = value.bitwise_not(); break;
+        case Operator::TYPEOF: folded = value.typeof_op(); break;
+        case Operator::VOID: folded = Value(); break;
+        default:
+            // Increments and delete need a reference, not a value
+            return std::make_unique<UnaryExpression>(op, std::move(operand), prefix, start, end);
+    }
+    
+    std::unique_ptr<ASTNode> literal = literal_node(folded, start, end);
+    if (!literal) {
+        return std::make_unique<UnaryExpression>(op, std::move(operand), prefix, start, end);
+    }
+    return literal;
+}
+
 std::string UnaryExpression::operator_to_string(Operator op) {
     switch (op) {
         case Operator::PLUS: return "+";
@@ -1278,7 +1760,7 @@ Value AssignmentExpression::evaluate(Context& ctx) {
             // For computed access like obj[expr]
             Value prop_value = member->get_property()->evaluate(ctx);
             if (ctx.has_exception()) return Value();
-            prop_name = prop_value.to_string();
+            prop_name = prop_value.to_property_key();
         } else {
             // For dot access like obj.prop
             if (member->get_property()->get_type() == ASTNode::Type::IDENTIFIER) {
@@ -1498,7 +1980,7 @@ Value DestructuringAssignment::evaluate(Context& ctx) {
                     std::string rest_name = var_name.substr(3); // Remove "..." prefix
                     
                     // Create new array for rest elements
-                    auto rest_array = std::make_unique<Object>(Object::ObjectType::Array);
+                    auto rest_array = ObjectFactory::create_array();
                     uint32_t rest_index = 0;
                     
                     // Collect remaining elements from current position
@@ -2297,7 +2779,7 @@ void DestructuringAssignment::handle_nested_object_destructuring_smart(Object* n
     // This maintains a registry of property mappings that can be accessed during evaluation
 
     // Global registry for property mappings (static to persist across calls)
-    static std::map<std::string, std::map<std::string, std::string>> global_property_mappings;
+    static thread_local std::map<std::string, std::map<std::string, std::string>> global_property_mappings;
 
     // STEP 1: Register property mappings from the source destructuring
     std::string source_key = "destructuring_" + std::to_string(reinterpret_cast<uintptr_t>(source));
@@ -2397,7 +2879,7 @@ void DestructuringAssignment::handle_nested_object_destructuring_enhanced(Object
     // we need to detect that the inner pattern has property renaming
 
     // Global registry to store detected property mappings
-    static std::map<std::string, std::string> runtime_property_mappings;
+    static thread_local std::map<std::string, std::string> runtime_property_mappings;
 
     // BREAKTHROUGH: Check if this destructuring context has property mappings
     // Look for patterns where property names differ from variable names
@@ -2468,7 +2950,7 @@ void DestructuringAssignment::handle_nested_object_destructuring_enhanced(Object
                 bool found_mapping = false;
 
                 // BREAKTHROUGH: Check if var_names contains a registry key
-                static std::map<std::string, std::vector<std::pair<std::string, std::string>>> global_nested_mappings;
+                static thread_local std::map<std::string, std::vector<std::pair<std::string, std::string>>> global_nested_mappings;
 
                 for (const std::string& check_var : var_names) {
                     if (check_var.find("REGISTRY:") == 0) {
@@ -2592,6 +3074,8 @@ std::vector<Value> process_arguments_with_spread(const std::vector<std::unique_p
 }
 
 Value CallExpression::evaluate(Context& ctx) {
+    if (async_stack_exhausted(ctx)) return Value();
+    
     // Handle member expressions (obj.method()) directly first
     if (callee_->get_type() == ASTNode::Type::MEMBER_EXPRESSION) {
         return handle_member_expression_call(ctx);
@@ -2680,8 +3164,9 @@ Value CallExpression::evaluate(Context& ctx) {
         
         // Call the function
         Function* function = callee_value.as_function();
-        
-        // JIT function recording removed - was simulation code
+        if (feedback_slot_ != NO_FEEDBACK_SLOT && ctx.get_feedback_vector()) {
+            ctx.get_feedback_vector()->record_call(feedback_slot_, function);
+        }
         
         return function->call(ctx, arg_values);
     }
@@ -2894,7 +3379,7 @@ Value CallExpression::handle_array_method_call(Object* array, const std::string&
             
             if (callback.is_function()) {
                 Function* callback_fn = callback.as_function();
-                auto result_array = std::make_unique<Object>(Object::ObjectType::Array);
+                auto result_array = ObjectFactory::create_array();
                 
                 uint32_t length = array->get_length();
                 for (uint32_t i = 0; i < length; ++i) {
@@ -2933,7 +3418,7 @@ Value CallExpression::handle_array_method_call(Object* array, const std::string&
             
             if (callback.is_function()) {
                 Function* callback_fn = callback.as_function();
-                auto result_array = std::make_unique<Object>(Object::ObjectType::Array);
+                auto result_array = ObjectFactory::create_array();
                 uint32_t result_index = 0;
                 
                 uint32_t length = array->get_length();
@@ -3061,7 +3546,7 @@ Value CallExpression::handle_array_method_call(Object* array, const std::string&
             if (end > static_cast<int32_t>(length)) end = length;
         }
         
-        auto result_array = std::make_unique<Object>(Object::ObjectType::Array);
+        auto result_array = ObjectFactory::create_array();
         uint32_t result_index = 0;
         
         for (int32_t i = start; i < end; ++i) {
@@ -3082,7 +3567,7 @@ Value CallExpression::handle_array_method_call(Object* array, const std::string&
         
     } else if (method_name == "concat") {
         // Array.concat() - concatenate arrays and elements
-        auto result_array = std::make_unique<Object>(Object::ObjectType::Array);
+        auto result_array = ObjectFactory::create_array();
         uint32_t result_index = 0;
         
         // Copy all elements from the original array
@@ -3226,7 +3711,7 @@ Value CallExpression::handle_array_method_call(Object* array, const std::string&
         }
         
         // Create result array with deleted elements
-        auto result_array = std::make_unique<Object>(Object::ObjectType::Array);
+        auto result_array = ObjectFactory::create_array();
         for (uint32_t i = 0; i < delete_count; ++i) {
             result_array->set_element(i, array->get_element(static_cast<uint32_t>(start) + i));
         }
@@ -3482,502 +3967,33 @@ Value CallExpression::handle_array_method_call(Object* array, const std::string&
     }
 }
 
-Value CallExpression::handle_string_method_call(const std::string& str, const std::string& method_name, Context& ctx) {
-    if (method_name == "charAt") {
-        // Get character at index
-        int index = 0;
-        if (arguments_.size() > 0) {
-            Value index_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            index = static_cast<int>(index_val.to_number());
-        }
-        
-        if (index < 0 || index >= static_cast<int>(str.length())) {
-            return Value(""); // Return empty string for out of bounds
-        }
-        
-        return Value(std::string(1, str[index]));
-        
-    } else if (method_name == "substring") {
-        // Extract substring
-        int start = 0;
-        int end = static_cast<int>(str.length());
-        
-        if (arguments_.size() > 0) {
-            Value start_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            start = static_cast<int>(start_val.to_number());
-            if (start < 0) start = 0;
-            if (start > static_cast<int>(str.length())) start = str.length();
-        }
-        
-        if (arguments_.size() > 1) {
-            Value end_val = arguments_[1]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            end = static_cast<int>(end_val.to_number());
-            if (end < 0) end = 0;
-            if (end > static_cast<int>(str.length())) end = str.length();
-        }
-        
-        if (start > end) {
-            std::swap(start, end);
-        }
+Value CallExpression::handle_bigint_method_call(BigInt* bigint, const std::string& method_name, Context& ctx) {
+    if (method_name == "toString") {
+        // Return string representation of the BigInt
+        return Value(bigint->to_string());
         
-        return Value(str.substr(start, end - start));
+    } else {
+        std::cout << "Calling BigInt method: " << method_name << "() -> [Method not fully implemented yet]" << std::endl;
+        return Value(); // Return undefined for unsupported methods
+    }
+}
+
+Value CallExpression::handle_member_expression_call(Context& ctx) {
+    MemberExpression* member = static_cast<MemberExpression*>(callee_.get());
+    
+    // Check if it's console.log
+    if (member->get_object()->get_type() == ASTNode::Type::IDENTIFIER &&
+        member->get_property()->get_type() == ASTNode::Type::IDENTIFIER) {
         
-    } else if (method_name == "indexOf") {
-        // Find first occurrence of substring
-        if (arguments_.size() > 0) {
-            Value search_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            std::string search_str = search_val.to_string();
-            
-            int start_pos = 0;
-            if (arguments_.size() > 1) {
-                Value start_val = arguments_[1]->evaluate(ctx);
-                if (ctx.has_exception()) return Value();
-                start_pos = static_cast<int>(start_val.to_number());
-                if (start_pos < 0) start_pos = 0;
-                if (start_pos >= static_cast<int>(str.length())) return Value(-1.0);
-            }
-            
-            size_t pos = str.find(search_str, start_pos);
-            if (pos == std::string::npos) {
-                return Value(-1.0);
-            }
-            return Value(static_cast<double>(pos));
-        }
-        return Value(-1.0);
+        Identifier* obj = static_cast<Identifier*>(member->get_object());
+        Identifier* prop = static_cast<Identifier*>(member->get_property());
         
-    } else if (method_name == "lastIndexOf") {
-        // Find last occurrence of substring
-        if (arguments_.size() > 0) {
-            Value search_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            std::string search_str = search_val.to_string();
+        if (obj->get_name() == "console") {
+            std::string method_name = prop->get_name();
             
-            size_t start_pos = str.length();
-            if (arguments_.size() > 1) {
-                Value start_val = arguments_[1]->evaluate(ctx);
-                if (ctx.has_exception()) return Value();
-                int start_int = static_cast<int>(start_val.to_number());
-                if (start_int < 0) return Value(-1.0);
-                start_pos = std::min(static_cast<size_t>(start_int), str.length());
-            }
-            
-            size_t pos = str.rfind(search_str, start_pos);
-            if (pos == std::string::npos) {
-                return Value(-1.0);
-            }
-            return Value(static_cast<double>(pos));
-        }
-        return Value(-1.0);
-        
-    } else if (method_name == "substr") {
-        // Extract substring using start and length
-        int start = 0;
-        int length = static_cast<int>(str.length());
-        
-        if (arguments_.size() > 0) {
-            Value start_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            start = static_cast<int>(start_val.to_number());
-            
-            // Handle negative start
-            if (start < 0) {
-                start = std::max(0, static_cast<int>(str.length()) + start);
-            }
-            if (start >= static_cast<int>(str.length())) {
-                return Value("");
-            }
-        }
-        
-        if (arguments_.size() > 1) {
-            Value length_val = arguments_[1]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            length = static_cast<int>(length_val.to_number());
-            if (length < 0) return Value("");
-        }
-        
-        return Value(str.substr(start, length));
-        
-    } else if (method_name == "slice") {
-        // Extract slice of string
-        int start = 0;
-        int end = static_cast<int>(str.length());
-        
-        if (arguments_.size() > 0) {
-            Value start_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            start = static_cast<int>(start_val.to_number());
-            
-            // Handle negative start
-            if (start < 0) {
-                start = std::max(0, static_cast<int>(str.length()) + start);
-            }
-            if (start >= static_cast<int>(str.length())) {
-                return Value("");
-            }
-        }
-        
-        if (arguments_.size() > 1) {
-            Value end_val = arguments_[1]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            end = static_cast<int>(end_val.to_number());
-            
-            // Handle negative end
-            if (end < 0) {
-                end = std::max(0, static_cast<int>(str.length()) + end);
-            }
-            if (end > static_cast<int>(str.length())) {
-                end = str.length();
-            }
-        }
-        
-        if (start >= end) {
-            return Value("");
-        }
-        
-        return Value(str.substr(start, end - start));
-        
-    } else if (method_name == "split") {
-        // Split string into array
-        auto result_array = std::make_unique<Object>(Object::ObjectType::Array);
-        
-        if (arguments_.size() == 0) {
-            // No separator, return array with single element
-            result_array->set_element(0, Value(str));
-            return Value(result_array.release());
-        }
-        
-        Value separator_val = arguments_[0]->evaluate(ctx);
-        if (ctx.has_exception()) return Value();
-        std::string separator = separator_val.to_string();
-        
-        if (separator.empty()) {
-            // Split into individual characters
-            for (size_t i = 0; i < str.length(); ++i) {
-                result_array->set_element(i, Value(std::string(1, str[i])));
-            }
-        } else {
-            // Split by separator
-            size_t start = 0;
-            size_t end = 0;
-            uint32_t index = 0;
-            
-            while ((end = str.find(separator, start)) != std::string::npos) {
-                result_array->set_element(index++, Value(str.substr(start, end - start)));
-                start = end + separator.length();
-            }
-            // Add the last part
-            result_array->set_element(index, Value(str.substr(start)));
-        }
-        
-        // Convert result array to ARRAY: string format to work with NaN-boxing workaround
-        std::string array_data = "ARRAY:[";
-        uint32_t result_length = result_array->get_length();
-        for (uint32_t i = 0; i < result_length; i++) {
-            if (i > 0) array_data += ",";
-            Value element = result_array->get_element(i);
-            array_data += element.to_string();
-        }
-        array_data += "]";
-        return Value(array_data);
-        
-    } else if (method_name == "replace") {
-        // Replace first occurrence
-        if (arguments_.size() >= 2) {
-            Value search_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            std::string search_str = search_val.to_string();
-            
-            Value replace_val = arguments_[1]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            std::string replace_str = replace_val.to_string();
-            
-            std::string result = str;
-            size_t pos = result.find(search_str);
-            if (pos != std::string::npos) {
-                result.replace(pos, search_str.length(), replace_str);
-            }
-            return Value(result);
-        }
-        return Value(str);
-        
-    } else if (method_name == "toLowerCase") {
-        // Convert to lowercase
-        std::string result = str;
-        std::transform(result.begin(), result.end(), result.begin(), ::tolower);
-        return Value(result);
-        
-    } else if (method_name == "toUpperCase") {
-        // Convert to uppercase
-        std::string result = str;
-        std::transform(result.begin(), result.end(), result.begin(), ::toupper);
-        return Value(result);
-        
-    } else if (method_name == "trim") {
-        // Remove whitespace from both ends
-        std::string result = str;
-        result.erase(result.begin(), std::find_if(result.begin(), result.end(), [](int ch) {
-            return !std::isspace(ch);
-        }));
-        result.erase(std::find_if(result.rbegin(), result.rend(), [](int ch) {
-            return !std::isspace(ch);
-        }).base(), result.end());
-        return Value(result);
-        
-    } else if (method_name == "length") {
-        // Return string length as property access
-        return Value(static_cast<double>(str.length()));
-        
-    } else if (method_name == "repeat") {
-        // Repeat string n times
-        if (arguments_.size() > 0) {
-            Value count_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-
-            int count = static_cast<int>(count_val.to_number());
-            if (count < 0) {
-                // RangeError: Invalid count value
-                ctx.throw_range_error("Invalid count value");
-                return Value();
-            }
-            if (count == 0) {
-                return Value(std::string(""));
-            }
-
-            std::string result;
-            result.reserve(str.length() * count);
-            for (int i = 0; i < count; i++) {
-                result += str;
-            }
-            return Value(result);
-        }
-        return Value(std::string("")); // No arguments means repeat 0 times
-        
-    } else if (method_name == "includes") {
-        // Check if string contains substring
-        if (arguments_.size() > 0) {
-            Value search_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            
-            std::string search_str = search_val.to_string();
-            bool found = str.find(search_str) != std::string::npos;
-            return Value(found);
-        }
-        return Value(false); // No search string provided
-        
-    } else if (method_name == "indexOf") {
-        // Find index of substring
-        if (arguments_.size() > 0) {
-            Value search_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            
-            std::string search_str = search_val.to_string();
-            size_t pos = str.find(search_str);
-            return Value(pos == std::string::npos ? -1.0 : static_cast<double>(pos));
-        }
-        return Value(-1.0); // No search string provided
-        
-    } else if (method_name == "charAt") {
-        // Get character at index
-        if (arguments_.size() > 0) {
-            Value index_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            
-            int index = static_cast<int>(index_val.to_number());
-            if (index >= 0 && index < static_cast<int>(str.length())) {
-                return Value(std::string(1, str[index]));
-            }
-        }
-        return Value(""); // Out of bounds or no index
-        
-    } else if (method_name == "charCodeAt") {
-        // Get character code at index
-        if (arguments_.size() > 0) {
-            Value index_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            
-            int index = static_cast<int>(index_val.to_number());
-            if (index >= 0 && index < static_cast<int>(str.length())) {
-                return Value(static_cast<double>(static_cast<unsigned char>(str[index])));
-            }
-        }
-        return Value(std::numeric_limits<double>::quiet_NaN()); // Out of bounds returns NaN
-        
-    } else if (method_name == "padStart") {
-        // Pad string at start
-        if (arguments_.size() > 0) {
-            Value length_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            
-            uint32_t target_length = static_cast<uint32_t>(length_val.to_number());
-            std::string pad_string = " ";
-            
-            if (arguments_.size() > 1) {
-                Value pad_val = arguments_[1]->evaluate(ctx);
-                if (ctx.has_exception()) return Value();
-                pad_string = pad_val.to_string();
-            }
-            
-            if (target_length <= str.length()) {
-                return Value(str);
-            }
-            
-            uint32_t pad_length = target_length - str.length();
-            std::string padding = "";
-            
-            if (!pad_string.empty()) {
-                while (padding.length() < pad_length) {
-                    padding += pad_string;
-                }
-                padding = padding.substr(0, pad_length);
-            }
-            
-            return Value(padding + str);
-        }
-        return Value(str);
-        
-    } else if (method_name == "padEnd") {
-        // Pad string at end
-        if (arguments_.size() > 0) {
-            Value length_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            
-            uint32_t target_length = static_cast<uint32_t>(length_val.to_number());
-            std::string pad_string = " ";
-            
-            if (arguments_.size() > 1) {
-                Value pad_val = arguments_[1]->evaluate(ctx);
-                if (ctx.has_exception()) return Value();
-                pad_string = pad_val.to_string();
-            }
-            
-            if (target_length <= str.length()) {
-                return Value(str);
-            }
-            
-            uint32_t pad_length = target_length - str.length();
-            std::string padding = "";
-            
-            if (!pad_string.empty()) {
-                while (padding.length() < pad_length) {
-                    padding += pad_string;
-                }
-                padding = padding.substr(0, pad_length);
-            }
-            
-            return Value(str + padding);
-        }
-        return Value(str);
-        
-    } else if (method_name == "replaceAll") {
-        // Replace all occurrences
-        if (arguments_.size() > 1) {
-            Value search_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            
-            Value replace_val = arguments_[1]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            
-            std::string search_str = search_val.to_string();
-            std::string replace_str = replace_val.to_string();
-            
-            if (search_str.empty()) return Value(str);
-            
-            std::string result = str;
-            size_t pos = 0;
-            while ((pos = result.find(search_str, pos)) != std::string::npos) {
-                result.replace(pos, search_str.length(), replace_str);
-                pos += replace_str.length();
-            }
-            
-            return Value(result);
-        }
-        return Value(str);
-        
-    } else if (method_name == "startsWith") {
-        // Check if string starts with substring
-        if (arguments_.size() > 0) {
-            Value search_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            std::string search_str = search_val.to_string();
-            
-            size_t start_pos = 0;
-            if (arguments_.size() > 1) {
-                Value pos_val = arguments_[1]->evaluate(ctx);
-                if (ctx.has_exception()) return Value();
-                start_pos = static_cast<size_t>(std::max(0.0, pos_val.to_number()));
-            }
-            
-            if (start_pos >= str.length()) return Value(false);
-            return Value(str.substr(start_pos).find(search_str) == 0);
-        }
-        return Value(false);
-        
-    } else if (method_name == "endsWith") {
-        // Check if string ends with substring
-        if (arguments_.size() > 0) {
-            Value search_val = arguments_[0]->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            std::string search_str = search_val.to_string();
-            
-            size_t end_pos = str.length();
-            if (arguments_.size() > 1) {
-                Value pos_val = arguments_[1]->evaluate(ctx);
-                if (ctx.has_exception()) return Value();
-                end_pos = static_cast<size_t>(std::max(0.0, std::min((double)str.length(), pos_val.to_number())));
-            }
-            
-            if (search_str.length() > end_pos) return Value(false);
-            return Value(str.substr(end_pos - search_str.length(), search_str.length()) == search_str);
-        }
-        return Value(false);
-
-    } else if (method_name == "concat") {
-        // Concatenate strings
-        std::string result = str;
-        for (const auto& arg : arguments_) {
-            Value arg_val = arg->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            result += arg_val.to_string();
-        }
-        return Value(result);
-
-    } else {
-        // Method not implemented - return undefined for unknown methods
-        return Value();
-    }
-}
-
-Value CallExpression::handle_bigint_method_call(BigInt* bigint, const std::string& method_name, Context& ctx) {
-    if (method_name == "toString") {
-        // Return string representation of the BigInt
-        return Value(bigint->to_string());
-        
-    } else {
-        std::cout << "Calling BigInt method: " << method_name << "() -> [Method not fully implemented yet]" << std::endl;
-        return Value(); // Return undefined for unsupported methods
-    }
-}
-
-Value CallExpression::handle_member_expression_call(Context& ctx) {
-    MemberExpression* member = static_cast<MemberExpression*>(callee_.get());
-    
-    // Check if it's console.log
-    if (member->get_object()->get_type() == ASTNode::Type::IDENTIFIER &&
-        member->get_property()->get_type() == ASTNode::Type::IDENTIFIER) {
-        
-        Identifier* obj = static_cast<Identifier*>(member->get_object());
-        Identifier* prop = static_cast<Identifier*>(member->get_property());
-        
-        if (obj->get_name() == "console") {
-            std::string method_name = prop->get_name();
-            
-            if (method_name == "log") {
-                // Evaluate arguments and print them
-                std::vector<Value> arg_values = process_arguments_with_spread(arguments_, ctx);
+            if (method_name == "log") {
+                // Evaluate arguments and print them
+                std::vector<Value> arg_values = process_arguments_with_spread(arguments_, ctx);
                 if (ctx.has_exception()) return Value();
                 
                 // Print arguments separated by spaces
@@ -4244,15 +4260,27 @@ Value CallExpression::handle_member_expression_call(Context& ctx) {
     }
     
     if (object_value.is_string()) {
-        // Handle string method calls or ARRAY: string format method calls
-        std::string str_value = object_value.to_string();
+        // Handle string method calls or ARRAY: string format method calls.
+        // Only the encoded formats need the text up front; ordinary string
+        // methods read the receiver in place
+        String* string_value = object_value.as_string();
+        std::string str_value;
+        if (string_value->starts_with("ARRAY:") || string_value->starts_with("OBJECT:")) {
+            str_value = string_value->str();
+        }
         
         // Get the method name
         std::string method_name;
+        Value symbol_method;
         if (member->is_computed()) {
             Value key_value = member->get_property()->evaluate(ctx);
             if (ctx.has_exception()) return Value();
-            method_name = key_value.to_string();
+            if (key_value.is_symbol()) {
+                // Symbol-keyed members (Symbol.iterator) are built by MemberExpression
+                symbol_method = member->evaluate(ctx);
+                if (ctx.has_exception()) return Value();
+            }
+            method_name = key_value.to_property_key();
         } else {
             if (member->get_property()->get_type() == ASTNode::Type::IDENTIFIER) {
                 Identifier* prop = static_cast<Identifier*>(member->get_property());
@@ -4266,7 +4294,7 @@ Value CallExpression::handle_member_expression_call(Context& ctx) {
         // Check if it's an ARRAY: string format for array methods
         if (str_value.length() >= 6 && str_value.substr(0, 6) == "ARRAY:") {
             // Create a temporary array object from the string format
-            auto temp_array = std::make_unique<Object>(Object::ObjectType::Array);
+            auto temp_array = ObjectFactory::create_array();
             
             // Parse the array elements from string format "ARRAY:[elem1,elem2,elem3]"
             size_t start = str_value.find('[');
@@ -4423,26 +4451,17 @@ Value CallExpression::handle_member_expression_call(Context& ctx) {
             return Value();
         }
 
-        // Handle String prototype methods (match, replace, etc.) using MemberExpression
-        Value method_value = member->evaluate(ctx);
-        if (ctx.has_exception()) return Value();
-
+        // String.prototype methods, found like any other property so that
+        // scripts can replace them
+        Value method_value = symbol_method.is_undefined() ? primitive_property(object_value, method_name) : symbol_method;
         if (method_value.is_function()) {
-            // Evaluate arguments
-            std::vector<Value> arg_values;
-            for (const auto& arg : arguments_) {
-                Value val = arg->evaluate(ctx);
-                if (ctx.has_exception()) return Value();
-                arg_values.push_back(val);
-            }
-
-            // Call the method with string as 'this' binding
-            Function* method = method_value.as_function();
-            return method->call(ctx, arg_values, object_value);
+            std::vector<Value> arg_values = process_arguments_with_spread(arguments_, ctx);
+            if (ctx.has_exception()) return Value();
+            return method_value.as_function()->call(ctx, arg_values, object_value);
         }
 
-        // Fallback to built-in string methods if prototype method not found
-        return handle_string_method_call(str_value, method_name, ctx);
+        ctx.throw_type_error(method_name + " is not a function");
+        return Value();
         
     } else if (object_value.is_bigint()) {
         // Handle BigInt method calls
@@ -4453,7 +4472,7 @@ Value CallExpression::handle_member_expression_call(Context& ctx) {
         if (member->is_computed()) {
             Value key_value = member->get_property()->evaluate(ctx);
             if (ctx.has_exception()) return Value();
-            method_name = key_value.to_string();
+            method_name = key_value.to_property_key();
         } else {
             if (member->get_property()->get_type() == ASTNode::Type::IDENTIFIER) {
                 Identifier* prop = static_cast<Identifier*>(member->get_property());
@@ -4467,9 +4486,16 @@ Value CallExpression::handle_member_expression_call(Context& ctx) {
         return handle_bigint_method_call(bigint_value, method_name, ctx);
         
     } else if (object_value.is_number()) {
-        // Handle number method calls using MemberExpression to get the function
-        Value method_value = member->evaluate(ctx);
-        if (ctx.has_exception()) return Value();
+        // Number.prototype methods, found like any other property
+        std::string method_name;
+        if (member->is_computed()) {
+            Value key_value = member->get_property()->evaluate(ctx);
+            if (ctx.has_exception()) return Value();
+            method_name = key_value.to_property_key();
+        } else if (member->get_property()->get_type() == ASTNode::Type::IDENTIFIER) {
+            method_name = static_cast<Identifier*>(member->get_property())->get_name();
+        }
+        Value method_value = primitive_property(object_value, method_name);
         
         if (method_value.is_function()) {
             // Evaluate arguments
@@ -4525,7 +4551,7 @@ Value CallExpression::handle_member_expression_call(Context& ctx) {
             // For obj[expr]()
             Value key_value = member->get_property()->evaluate(ctx);
             if (ctx.has_exception()) return Value();
-            method_name = key_value.to_string();
+            method_name = key_value.to_property_key();
         } else {
             // For obj.method()
             if (member->get_property()->get_type() == ASTNode::Type::IDENTIFIER) {
@@ -4540,6 +4566,19 @@ Value CallExpression::handle_member_expression_call(Context& ctx) {
         // Get the method function
         Value method_value = obj->get_property(method_name);
         if (method_value.is_function()) {
+            // DataView accessors run straight off the evaluated arguments
+            if (obj->is_data_view() && arguments_.size() <= 3) {
+                if (const DataView::Method* builtin = method_value.as_function()->get_native_target<DataView::Method>()) {
+                    Value arg_values[3];
+                    size_t argc = 0;
+                    for (const auto& arg : arguments_) {
+                        arg_values[argc++] = arg->evaluate(ctx);
+                        if (ctx.has_exception()) return Value();
+                    }
+                    return DataView::call_builtin(builtin->id, ctx, static_cast<DataView*>(obj), arg_values, argc);
+                }
+            }
+            
             // Evaluate arguments
             std::vector<Value> arg_values;
             for (const auto& arg : arguments_) {
@@ -4550,6 +4589,9 @@ Value CallExpression::handle_member_expression_call(Context& ctx) {
             
             // Call the method with 'this' bound to the object
             Function* method = method_value.as_function();
+            if (feedback_slot_ != NO_FEEDBACK_SLOT && ctx.get_feedback_vector()) {
+                ctx.get_feedback_vector()->record_call(feedback_slot_, method);
+            }
             return method->call(ctx, arg_values, object_value);
         } else {
             ctx.throw_exception(Value("Property is not a function"));
@@ -4576,42 +4618,62 @@ Value MemberExpression::evaluate(Context& ctx) {
         return Value();
     }
 
-    // PRIMITIVE WRAPPER: Handle String prototype access for string primitives
-    if (object_value.is_string() && !computed_) {
-        if (property_->get_type() == ASTNode::Type::IDENTIFIER) {
-            Identifier* prop = static_cast<Identifier*>(property_.get());
-            std::string prop_name = prop->get_name();
-
-            // Check for built-in string properties first
-            if (prop_name == "length") {
-                std::string str_value = object_value.to_string();
-                return Value(static_cast<double>(str_value.length()));
-            }
-
-            // Get String constructor from context
-            Value string_ctor = ctx.get_binding("String");
-            if (string_ctor.is_object()) {
-                Object* string_fn = string_ctor.as_object();
-                Value prototype = string_fn->get_property("prototype");
-                if (prototype.is_object()) {
-                    Object* string_prototype = prototype.as_object();
-                    Value method = string_prototype->get_property(prop_name);
-
-                    // If method found, return it (it will be bound during call)
-                    if (!method.is_undefined()) {
-                        return method;
-                    }
+    // String primitives: indexed reads come straight from the code units,
+    // named properties from String.prototype. Strings in the legacy ARRAY:
+    // and OBJECT: encodings fall through to their own handling below
+    if (object_value.is_string()) {
+        String* str = object_value.as_string();
+        bool encoded = str->starts_with("ARRAY:") || str->starts_with("OBJECT:");
+        if (computed_ && !encoded) {
+            Value prop_value = property_->evaluate(ctx);
+            if (ctx.has_exception()) return Value();
+            if (prop_value.is_number()) {
+                double index = prop_value.as_number();
+                if (index >= 0 && index < static_cast<double>(str->length()) && index == std::floor(index)) {
+                    return ValueFactory::string(str->char_at(static_cast<size_t>(index)));
+                }
+                return Value();
+            }
+            if (prop_value.is_symbol()) {
+                if (prop_value.as_symbol() == Symbol::get_well_known(WellKnownSymbol::Iterator)) {
+                    std::string str_value = str->str();
+                    auto string_iterator_fn = ObjectFactory::create_native_function("@@iterator",
+                        [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
+                            (void)ctx; // Suppress unused warning
+                            (void)args; // Suppress unused warning
+                            auto iterator = std::make_unique<StringIterator>(str_value);
+                            return Value(iterator.release());
+                        });
+                    return Value(string_iterator_fn.release());
                 }
+                return Value();
             }
+            return primitive_property(object_value, prop_value.to_property_key());
+        }
+        if (!computed_ && property_->get_type() == ASTNode::Type::IDENTIFIER) {
+            Value property = primitive_property(object_value, static_cast<Identifier*>(property_.get())->get_name());
+            if (!property.is_undefined() || !encoded) return property;
         }
     }
 
     // PRIORITY FIX: Handle regular object property access FIRST, before all the special cases
+    FeedbackVector* feedback = feedback_slot_ != NO_FEEDBACK_SLOT ? ctx.get_feedback_vector() : nullptr;
     if (object_value.is_object() && !computed_) {
         Object* obj = object_value.as_object();
         if (property_->get_type() == ASTNode::Type::IDENTIFIER) {
-            Identifier* prop = static_cast<Identifier*>(property_.get());
-            std::string prop_name = prop->get_name();
+            const std::string& prop_name = static_cast<Identifier*>(property_.get())->get_name();
+            if (feedback) feedback->record_property(feedback_slot_, obj, prop_name);
+            if (specialization_ == Specialization::ShapeLoad) {
+                if (obj->get_shape() == cached_shape_ && static_cast<uint8_t>(obj->get_type()) == cached_type_ &&
+                    cached_offset_ < obj->shape_slot_count() && !obj->has_descriptors()) {
+                    const Value& value = obj->get_shape_slot(cached_offset_);
+                    if (!value.is_undefined()) return value;
+                } else {
+                    specialize_named(obj, prop_name);
+                }
+            } else if (specialization_ == Specialization::Uninitialized) {
+                specialize_named(obj, prop_name);
+            }
             return obj->get_property(prop_name);
         }
     }
@@ -4621,9 +4683,23 @@ Value MemberExpression::evaluate(Context& ctx) {
         Object* obj = object_value.as_object();
         Value prop_value = property_->evaluate(ctx);
         if (ctx.has_exception()) return Value();
-        std::string prop_name = prop_value.to_string();
+        if (feedback) feedback->record_element(feedback_slot_, obj, prop_value);
+        if (specialization_ == Specialization::PackedElement) {
+            int32_t index;
+            if (obj->get_type() == Object::ObjectType::Array && as_int32(prop_value, index) &&
+                index >= 0 && static_cast<uint32_t>(index) < obj->element_count()) {
+                const Value& value = obj->get_element_slot(static_cast<uint32_t>(index));
+                if (!value.is_undefined()) return value;
+            }
+            specialize_indexed(obj, prop_value);
+        } else if (specialization_ == Specialization::Uninitialized) {
+            specialize_indexed(obj, prop_value);
+        }
+        std::string prop_name = prop_value.to_property_key();
         return obj->get_property(prop_name);
     }
+    if (feedback && computed_) feedback->record_element_generic(feedback_slot_);
+    if (specialization_ != Specialization::Generic) rewrite(Specialization::Generic);
     
     // Special handling for Math object properties
     if (object_->get_type() == ASTNode::Type::IDENTIFIER &&
@@ -4673,7 +4749,7 @@ Value MemberExpression::evaluate(Context& ctx) {
     if (computed_) {
         Value prop_value = property_->evaluate(ctx);
         if (ctx.has_exception()) return Value();
-        prop_name = prop_value.to_string();
+        prop_name = prop_value.to_property_key();
     } else {
         if (property_->get_type() == ASTNode::Type::IDENTIFIER) {
             Identifier* prop = static_cast<Identifier*>(property_.get());
@@ -4909,422 +4985,12 @@ Value MemberExpression::evaluate(Context& ctx) {
             return Value(static_cast<double>(str_value.length()));
         }
         
-        // Handle string methods - CREATE BOUND METHODS
-        if (!computed_ && prop_name == "charAt") {
-            auto char_at_fn = ObjectFactory::create_native_function("charAt",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    if (args.empty()) return Value("");
-                    int index = static_cast<int>(args[0].to_number());
-                    if (index >= 0 && index < static_cast<int>(str_value.length())) {
-                        return Value(std::string(1, str_value[index]));
-                    }
-                    return Value("");
-                });
-            return Value(char_at_fn.release());
-        }
-        
-        if (!computed_ && prop_name == "indexOf") {
-            auto index_of_fn = ObjectFactory::create_native_function("indexOf",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    if (args.empty()) return Value(-1.0);
-                    std::string search = args[0].to_string();
-                    size_t pos = str_value.find(search);
-                    return Value(pos != std::string::npos ? static_cast<double>(pos) : -1.0);
-                });
-            return Value(index_of_fn.release());
-        }
-        
-        if (prop_name == "toUpperCase") {
-            auto upper_fn = ObjectFactory::create_native_function("toUpperCase",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    std::string result = str_value;
-                    std::transform(result.begin(), result.end(), result.begin(), ::toupper);
-                    return Value(result);
-                });
-            return Value(upper_fn.release());
-        }
-        
-        if (prop_name == "toLowerCase") {
-            auto lower_fn = ObjectFactory::create_native_function("toLowerCase",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    std::string result = str_value;
-                    std::transform(result.begin(), result.end(), result.begin(), ::tolower);
-                    return Value(result);
-                });
-            return Value(lower_fn.release());
-        }
-        
-        if (prop_name == "substring") {
-            auto substring_fn = ObjectFactory::create_native_function("substring",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    if (args.empty()) return Value(str_value);
-                    int start = static_cast<int>(args[0].to_number());
-                    int end = args.size() > 1 ? static_cast<int>(args[1].to_number()) : str_value.length();
-                    start = std::max(0, std::min(start, static_cast<int>(str_value.length())));
-                    end = std::max(0, std::min(end, static_cast<int>(str_value.length())));
-                    if (start > end) std::swap(start, end);
-                    return Value(str_value.substr(start, end - start));
-                });
-            return Value(substring_fn.release());
-        }
-        
-        if (prop_name == "substr") {
-            auto substr_fn = ObjectFactory::create_native_function("substr",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    if (args.empty()) return Value(str_value);
-                    int start = static_cast<int>(args[0].to_number());
-                    int length = args.size() > 1 ? static_cast<int>(args[1].to_number()) : str_value.length();
-                    if (start < 0) start = std::max(0, static_cast<int>(str_value.length()) + start);
-                    start = std::min(start, static_cast<int>(str_value.length()));
-                    return Value(str_value.substr(start, length));
-                });
-            return Value(substr_fn.release());
-        }
-        
-        if (prop_name == "slice") {
-            auto slice_fn = ObjectFactory::create_native_function("slice",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    if (args.empty()) return Value(str_value);
-                    int start = static_cast<int>(args[0].to_number());
-                    int end = args.size() > 1 ? static_cast<int>(args[1].to_number()) : str_value.length();
-                    if (start < 0) start = std::max(0, static_cast<int>(str_value.length()) + start);
-                    if (end < 0) end = std::max(0, static_cast<int>(str_value.length()) + end);
-                    start = std::min(start, static_cast<int>(str_value.length()));
-                    end = std::min(end, static_cast<int>(str_value.length()));
-                    if (start >= end) return Value("");
-                    return Value(str_value.substr(start, end - start));
-                });
-            return Value(slice_fn.release());
-        }
-        
-        if (!computed_ && prop_name == "split") {
-            auto split_fn = ObjectFactory::create_native_function("split",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    std::string separator = args.empty() ? "" : args[0].to_string();
-                    
-                    auto array = ObjectFactory::create_array();
-                    
-                    if (separator.empty()) {
-                        // Split into individual characters
-                        for (size_t i = 0; i < str_value.length(); ++i) {
-                            array->set_element(static_cast<uint32_t>(i), Value(std::string(1, str_value[i])));
-                        }
-                        array->set_length(static_cast<uint32_t>(str_value.length()));
-                    } else {
-                        // Split by separator
-                        std::vector<std::string> parts;
-                        size_t start = 0;
-                        size_t pos = 0;
-                        
-                        while ((pos = str_value.find(separator, start)) != std::string::npos) {
-                            parts.push_back(str_value.substr(start, pos - start));
-                            start = pos + separator.length();
-                        }
-                        parts.push_back(str_value.substr(start)); // Last part
-                        
-                        for (size_t i = 0; i < parts.size(); ++i) {
-                            array->set_element(static_cast<uint32_t>(i), Value(parts[i]));
-                        }
-                        array->set_length(static_cast<uint32_t>(parts.size()));
-                    }
-                    
-                    return Value(array.release());
-                });
-            return Value(split_fn.release());
-        }
-        
-        if (prop_name == "replace") {
-            auto replace_fn = ObjectFactory::create_native_function("replace",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    if (args.size() < 2) return Value(str_value);
-                    
-                    std::string search = args[0].to_string();
-                    std::string replacement = args[1].to_string();
-                    
-                    std::string result = str_value;
-                    size_t pos = result.find(search);
-                    if (pos != std::string::npos) {
-                        result.replace(pos, search.length(), replacement);
-                    }
-                    
-                    return Value(result);
-                });
-            return Value(replace_fn.release());
-        }
-        
-        if (!computed_ && prop_name == "startsWith") {
-            auto starts_with_fn = ObjectFactory::create_native_function("startsWith",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    if (args.empty()) return Value(false);
-                    std::string search = args[0].to_string();
-                    bool result = (str_value.substr(0, search.length()) == search);
-                    return Value(result);
-                });
-            return Value(starts_with_fn.release());
-        }
-        
-        if (!computed_ && prop_name == "endsWith") {
-            auto ends_with_fn = ObjectFactory::create_native_function("endsWith",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    if (args.empty()) return Value(false);
-                    std::string search = args[0].to_string();
-                    if (search.length() > str_value.length()) return Value(false);
-                    bool result = (str_value.substr(str_value.length() - search.length()) == search);
-                    return Value(result);
-                });
-            return Value(ends_with_fn.release());
-        }
-        
-        if (prop_name == "includes") {
-            auto includes_fn = ObjectFactory::create_native_function("includes",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    if (args.empty()) return Value(false);
-                    std::string search = args[0].to_string();
-                    return Value(str_value.find(search) != std::string::npos);
-                });
-            return Value(includes_fn.release());
-        }
-        
-        if (prop_name == "repeat") {
-            auto repeat_fn = ObjectFactory::create_native_function("repeat",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    if (args.empty()) {
-                        return Value(std::string(""));
-                    }
-                    int count = static_cast<int>(args[0].to_number());
-                    if (count < 0) {
-                        ctx.throw_range_error("Invalid count value");
-                        return Value();
-                    }
-                    if (count == 0) {
-                        return Value(std::string(""));
-                    }
-
-                    std::string result;
-                    result.reserve(str_value.length() * count);
-                    for (int i = 0; i < count; ++i) {
-                        result += str_value;
-                    }
-                    return Value(result);
-                });
-            return Value(repeat_fn.release());
-        }
-        
-        if (prop_name == "trim") {
-            auto trim_fn = ObjectFactory::create_native_function("trim",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    (void)args; // Suppress unused warning
-                    std::string result = str_value;
-                    // Trim leading whitespace
-                    result.erase(0, result.find_first_not_of(" \t\n\r"));
-                    // Trim trailing whitespace
-                    result.erase(result.find_last_not_of(" \t\n\r") + 1);
-                    return Value(result);
-                });
-            return Value(trim_fn.release());
-        }
-
-        if (prop_name == "concat") {
-            auto concat_fn = ObjectFactory::create_native_function("concat",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    std::string result = str_value;
-                    for (const auto& arg : args) {
-                        result += arg.to_string();
-                    }
-                    return Value(result);
-                });
-            return Value(concat_fn.release());
-        }
-
-        if (prop_name == "padStart") {
-            auto pad_start_fn = ObjectFactory::create_native_function("padStart",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    if (args.empty()) return Value(str_value);
-                    
-                    int target_length = static_cast<int>(args[0].to_number());
-                    if (target_length <= static_cast<int>(str_value.length())) {
-                        return Value(str_value);
-                    }
-                    
-                    std::string pad_string = " ";
-                    if (args.size() > 1 && !args[1].is_undefined()) {
-                        pad_string = args[1].to_string();
-                    }
-                    if (pad_string.empty()) pad_string = " ";
-                    
-                    int pad_length = target_length - static_cast<int>(str_value.length());
-                    std::string result;
-                    
-                    while (static_cast<int>(result.length()) < pad_length) {
-                        if (static_cast<int>(result.length()) + static_cast<int>(pad_string.length()) <= pad_length) {
-                            result += pad_string;
-                        } else {
-                            result += pad_string.substr(0, pad_length - static_cast<int>(result.length()));
-                        }
-                    }
-                    
-                    return Value(result + str_value);
-                });
-            return Value(pad_start_fn.release());
-        }
-        
-        if (prop_name == "padEnd") {
-            auto pad_end_fn = ObjectFactory::create_native_function("padEnd",
-                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    if (args.empty()) return Value(str_value);
-                    
-                    int target_length = static_cast<int>(args[0].to_number());
-                    if (target_length <= static_cast<int>(str_value.length())) {
-                        return Value(str_value);
-                    }
-                    
-                    std::string pad_string = " ";
-                    if (args.size() > 1 && !args[1].is_undefined()) {
-                        pad_string = args[1].to_string();
-                    }
-                    if (pad_string.empty()) pad_string = " ";
-                    
-                    int pad_length = target_length - static_cast<int>(str_value.length());
-                    std::string result;
-                    
-                    while (static_cast<int>(result.length()) < pad_length) {
-                        if (static_cast<int>(result.length()) + static_cast<int>(pad_string.length()) <= pad_length) {
-                            result += pad_string;
-                        } else {
-                            result += pad_string.substr(0, pad_length - static_cast<int>(result.length()));
-                        }
-                    }
-                    
-                    return Value(str_value + result);
-                });
-            return Value(pad_end_fn.release());
-        }
-        
-        // Handle Symbol.iterator property access for strings
-        if (computed_) {
-            Value prop_value = property_->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            
-            if (prop_value.is_symbol()) {
-                Symbol* prop_symbol = prop_value.as_symbol();
-                Symbol* iterator_symbol = Symbol::get_well_known(Symbol::ITERATOR);
-                
-                if (iterator_symbol && prop_symbol->equals(iterator_symbol)) {
-                    // Return string iterator function
-                    auto string_iterator_fn = ObjectFactory::create_native_function("@@iterator",
-                        [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                            (void)ctx; // Suppress unused warning
-                            (void)args; // Suppress unused warning
-                            auto iterator = std::make_unique<StringIterator>(str_value);
-                            return Value(iterator.release());
-                        });
-                    return Value(string_iterator_fn.release());
-                }
-            }
-        }
-        
-        // Handle numeric indices
-        if (computed_) {
-            Value prop_value = property_->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            if (prop_value.is_number()) {
-                int index = static_cast<int>(prop_value.to_number());
-                if (index >= 0 && index < static_cast<int>(str_value.length())) {
-                    return Value(std::string(1, str_value[index]));
-                }
-            }
-        }
-        
         return Value(); // undefined for other properties
     }
     
     //  NUMBER PRIMITIVE BOXING
     else if (object_value.is_number()) {
-        double num_value = object_value.to_number();
-        
-        if (prop_name == "toString") {
-            auto to_string_fn = ObjectFactory::create_native_function("toString",
-                [num_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    // Format number properly - remove trailing zeros
-                    std::string result = std::to_string(num_value);
-                    if (result.find('.') != std::string::npos) {
-                        result.erase(result.find_last_not_of('0') + 1, std::string::npos);
-                        result.erase(result.find_last_not_of('.') + 1, std::string::npos);
-                    }
-                    return Value(result);
-                });
-            return Value(to_string_fn.release());
-        }
-        
-        if (prop_name == "valueOf") {
-            auto value_of_fn = ObjectFactory::create_native_function("valueOf",
-                [num_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    return Value(num_value);
-                });
-            return Value(value_of_fn.release());
-        }
-        
-        if (prop_name == "toFixed") {
-            auto to_fixed_fn = ObjectFactory::create_native_function("toFixed",
-                [num_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-                    int digits = args.empty() ? 0 : static_cast<int>(args[0].to_number());
-                    std::ostringstream oss;
-                    oss << std::fixed << std::setprecision(digits) << num_value;
-                    return Value(oss.str());
-                });
-            return Value(to_fixed_fn.release());
-        }
-        
-        if (prop_name == "toLocaleString") {
-            auto to_locale_string_fn = ObjectFactory::create_native_function("toLocaleString",
-                [num_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; (void)args; // Suppress unused warnings
-                    // Simple implementation: format with thousands separators
-                    std::ostringstream oss;
-                    
-                    if (num_value >= 1000 || num_value <= -1000) {
-                        // Format with thousands separators using comma
-                        std::string num_str = std::to_string(static_cast<long long>(num_value));
-                        std::string result;
-                        int count = 0;
-                        
-                        for (int i = num_str.length() - 1; i >= 0; --i) {
-                            if (count > 0 && count % 3 == 0 && num_str[i] != '-') {
-                                result = "," + result;
-                            }
-                            result = num_str[i] + result;
-                            if (num_str[i] != '-') count++;
-                        }
-                        return Value(result);
-                    } else {
-                        // Small numbers, no formatting needed
-                        return Value(std::to_string(static_cast<long long>(num_value)));
-                    }
-                });
-            return Value(to_locale_string_fn.release());
-        }
-        
-        return Value(); // undefined for other properties
+        return primitive_property(object_value, prop_name);
     }
     
     //  BOOLEAN PRIMITIVE BOXING
@@ -5346,191 +5012,7 @@ Value MemberExpression::evaluate(Context& ctx) {
                     (void)ctx; // Suppress unused warning
                     return Value(bool_value);
                 });
-            return Value(value_of_fn.release());
-        }
-        
-        return Value(); // undefined for other properties
-    }
-    
-    // TEMPORARY: Handle special object/array string formats FIRST
-    else if (object_value.is_string()) {
-        std::string str_val = object_value.to_string();
-        
-        // Check for ARRAY format first - MUST return early to prevent string indexing
-        if (str_val.length() >= 6 && str_val.substr(0, 6) == "ARRAY:") {
-            return Value("[object Array]");
-            if (computed_) {
-                Value prop_value = property_->evaluate(ctx);
-                if (ctx.has_exception()) return Value();
-                
-                if (prop_value.is_number()) {
-                    uint32_t index = static_cast<uint32_t>(prop_value.as_number());
-                    
-                    // Extract array content between '[' and ']'
-                    size_t start = str_val.find('[');
-                    size_t end = str_val.find(']');
-                    if (start != std::string::npos && end != std::string::npos) {
-                        std::string content = str_val.substr(start + 1, end - start - 1);
-                        if (content.empty()) return Value(); // Empty array
-                        
-                        // Split by comma and get the index-th element
-                        std::vector<std::string> elements;
-                        size_t pos = 0;
-                        while (pos < content.length()) {
-                            size_t comma = content.find(',', pos);
-                            if (comma == std::string::npos) comma = content.length();
-                            elements.push_back(content.substr(pos, comma - pos));
-                            pos = comma + 1;
-                        }
-                        
-                        if (index < elements.size()) {
-                            return Value(elements[index]);
-                        }
-                    }
-                }
-            }
-            // CRITICAL: Must return Value() for ANY ARRAY string to prevent fallthrough
-            return Value(); // Array property access not found or not computed
-        }
-        
-        // Check for OBJECT format
-        if (str_val.substr(0, 7) == "OBJECT:") {
-            // Parse the object data: "OBJECT:{prop1=val1,prop2=val2}"
-            std::string prop_name;
-            if (property_->get_type() == ASTNode::Type::IDENTIFIER) {
-                Identifier* prop = static_cast<Identifier*>(property_.get());
-                prop_name = prop->get_name();
-            }
-            
-            // Find the property in the string
-            std::string search = prop_name + "=";
-            size_t start = str_val.find(search);
-            if (start != std::string::npos) {
-                start += search.length();
-                size_t end = str_val.find(",", start);
-                if (end == std::string::npos) {
-                    end = str_val.find("}", start);
-                }
-                
-                if (end != std::string::npos) {
-                    std::string value = str_val.substr(start, end - start);
-                    return Value(value);
-                }
-            }
-            
-            return Value(); // Property not found
-        }
-        
-        // ONLY continue with normal string handling if not a special string
-        // For ARRAY: or OBJECT: formats, we should have already returned above
-        std::string str_value = object_value.to_string();
-        
-        // Handle string length property
-        if (!computed_ && property_->get_type() == ASTNode::Type::IDENTIFIER) {
-            Identifier* prop = static_cast<Identifier*>(property_.get());
-            std::string prop_name = prop->get_name();
-            
-            if (prop_name == "length") {
-                return Value(static_cast<double>(str_value.length()));
-            }
-            
-            // Handle string methods - CREATE BOUND METHODS
-            if (prop_name == "charAt") {
-                auto char_at_fn = ObjectFactory::create_native_function("charAt",
-                    [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                        (void)ctx;
-                        if (args.empty()) return Value("");
-                        int index = static_cast<int>(args[0].to_number());
-                        if (index >= 0 && index < static_cast<int>(str_value.length())) {
-                            return Value(std::string(1, str_value[index]));
-                        }
-                        return Value("");
-                    });
-                return Value(char_at_fn.release());
-            }
-            
-            if (prop_name == "indexOf") {
-                auto index_of_fn = ObjectFactory::create_native_function("indexOf",
-                    [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                        (void)ctx;
-                        if (args.empty()) return Value(-1.0);
-                        std::string search = args[0].to_string();
-                        size_t pos = str_value.find(search);
-                        return Value(pos == std::string::npos ? -1.0 : static_cast<double>(pos));
-                    });
-                return Value(index_of_fn.release());
-            }
-            
-            if (!computed_ && prop_name == "split") {
-                auto split_fn = ObjectFactory::create_native_function("split",
-                    [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                        (void)ctx;
-                        std::string separator = args.empty() ? "" : args[0].to_string();
-                        
-                        auto array = ObjectFactory::create_array();
-                        
-                        if (separator.empty()) {
-                            // Split into individual characters
-                            for (size_t i = 0; i < str_value.length(); ++i) {
-                                array->set_element(static_cast<uint32_t>(i), Value(std::string(1, str_value[i])));
-                            }
-                            array->set_length(static_cast<uint32_t>(str_value.length()));
-                        } else {
-                            // Split by separator
-                            std::vector<std::string> parts;
-                            size_t start = 0;
-                            size_t pos = 0;
-                            while ((pos = str_value.find(separator, start)) != std::string::npos) {
-                                parts.push_back(str_value.substr(start, pos - start));
-                                start = pos + separator.length();
-                            }
-                            parts.push_back(str_value.substr(start));
-                            
-                            for (size_t i = 0; i < parts.size(); ++i) {
-                                array->set_element(static_cast<uint32_t>(i), Value(parts[i]));
-                            }
-                            array->set_length(static_cast<uint32_t>(parts.size()));
-                        }
-                        
-                        return Value(array.release());
-                    });
-                return Value(split_fn.release());
-            }
-            
-            if (!computed_ && prop_name == "startsWith") {
-                auto starts_with_fn = ObjectFactory::create_native_function("startsWith",
-                    [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                        (void)ctx; (void)args;
-                        // Simple implementation - always returns true for compatibility
-                        return Value(true);
-                    });
-                return Value(starts_with_fn.release());
-            }
-            
-            if (!computed_ && prop_name == "endsWith") {
-                auto ends_with_fn = ObjectFactory::create_native_function("endsWith",
-                    [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                        (void)ctx;
-                        if (args.empty()) return Value(false);
-                        std::string search = args[0].to_string();
-                        if (search.length() > str_value.length()) return Value(false);
-                        bool result = (str_value.substr(str_value.length() - search.length()) == search);
-                        return Value(result);
-                    });
-                return Value(ends_with_fn.release());
-            }
-        }
-        
-        // Handle numeric indices for regular strings only
-        if (computed_) {
-            Value prop_value = property_->evaluate(ctx);
-            if (ctx.has_exception()) return Value();
-            if (prop_value.is_number()) {
-                int index = static_cast<int>(prop_value.to_number());
-                if (index >= 0 && index < static_cast<int>(str_value.length())) {
-                    return Value(std::string(1, str_value[index]));
-                }
-            }
+            return Value(value_of_fn.release());
         }
         
         return Value(); // undefined for other properties
@@ -5549,7 +5031,7 @@ Value MemberExpression::evaluate(Context& ctx) {
                 return obj->get_element(index);
             }
             
-            return obj->get_property(prop_value.to_string());
+            return obj->get_property(prop_value.to_property_key());
         } else {
             if (property_->get_type() == ASTNode::Type::IDENTIFIER) {
                 Identifier* prop = static_cast<Identifier*>(property_.get());
@@ -5575,6 +5057,49 @@ Value MemberExpression::evaluate(Context& ctx) {
     return Value(); // undefined
 }
 
+// A named load specializes on its receiver's shape when the property is a
+// writable data property in shape storage (as FeedbackVector::record_property
+// decides for the optimizing tier)
+void MemberExpression::specialize_named(Object* receiver, const std::string& key) {
+    Shape* shape = receiver->get_shape();
+    Object::ObjectType type = receiver->get_type();
+    bool cacheable = shape && !receiver->has_descriptors() &&
+                     (type == Object::ObjectType::Ordinary ||
+                      (type == Object::ObjectType::Array && key == "length")) &&
+                     shape->has_property(key);
+    if (cacheable) {
+        Shape::PropertyInfo info = shape->get_property_info(key);
+        cacheable = info.offset < receiver->shape_slot_count() &&
+                    (info.attributes & PropertyAttributes::Writable);
+        if (cacheable) {
+            cached_shape_ = shape;
+            cached_offset_ = info.offset;
+            cached_type_ = static_cast<uint8_t>(type);
+        }
+    }
+    rewrite(cacheable ? Specialization::ShapeLoad : Specialization::Generic);
+}
+
+// An indexed load specializes on packed arrays: an array receiver and an
+// in-bounds int32 index of a present element. Once specialized, a hole or an
+// out-of-bounds index takes the slow path without a rewrite; only another
+// kind of receiver or key makes the access generic
+void MemberExpression::specialize_indexed(Object* receiver, const Value& key) {
+    int32_t index;
+    bool array_index = receiver->get_type() == Object::ObjectType::Array && as_int32(key, index) && index >= 0;
+    if (array_index && specialization_ == Specialization::PackedElement) return;
+    bool packed = array_index && static_cast<uint32_t>(index) < receiver->element_count() &&
+                  !receiver->get_element_slot(static_cast<uint32_t>(index)).is_undefined();
+    rewrite(packed ? Specialization::PackedElement : Specialization::Generic);
+}
+
+void MemberExpression::rewrite(Specialization to) {
+    if (to != Specialization::Generic && rewrites_ >= MAX_REWRITES) to = Specialization::Generic;
+    ++rewrites_;
+    count_rewrite(NodeRewriteStats::MEMBER, specialization_, to);
+    specialization_ = to;
+}
+
 std::string MemberExpression::to_string() const {
     if (computed_) {
         return object_->to_string() + "[" + property_->to_string() + "]";
@@ -5677,9 +5202,12 @@ Value Program::evaluate(Context& ctx) {
     // VARIABLE HOISTING: Second pass - pre-declare all var variables with undefined
     hoist_var_declarations(ctx);
     
-    // Second pass - process all other statements
+    // Second pass - process all other statements, each under its own handle
+    // scope so the collector sees the temporaries it creates
+    GarbageCollector* gc = ctx.get_garbage_collector();
     for (const auto& statement : statements_) {
         if (statement->get_type() != ASTNode::Type::FUNCTION_DECLARATION) {
+            HandleScope statement_scope(gc);
             last_value = statement->evaluate(ctx);
             if (ctx.has_exception()) {
                 return Value();
@@ -5910,14 +5438,99 @@ std::unique_ptr<ASTNode> VariableDeclaration::clone() const {
 // BlockStatement Implementation
 //=============================================================================
 
+// Whether running node can bind a let/const name in the environment it
+// runs in. Nested blocks and for loops bring their own environment, and
+// function bodies run in their own activation, so neither is entered.
+static bool binds_lexical_names(const ASTNode* node) {
+    if (!node) return false;
+    switch (node->get_type()) {
+        case ASTNode::Type::VARIABLE_DECLARATION: {
+            const auto* declaration = static_cast<const VariableDeclaration*>(node);
+            for (const auto& declarator : declaration->get_declarations()) {
+                if (declarator->get_kind() != VariableDeclarator::Kind::VAR) return true;
+            }
+            return false;
+        }
+        case ASTNode::Type::IF_STATEMENT: {
+            const auto* if_stmt = static_cast<const IfStatement*>(node);
+            return binds_lexical_names(if_stmt->get_consequent()) ||
+                   binds_lexical_names(if_stmt->get_alternate());
+        }
+        case ASTNode::Type::WHILE_STATEMENT:
+            return binds_lexical_names(static_cast<const WhileStatement*>(node)->get_body());
+        case ASTNode::Type::DO_WHILE_STATEMENT:
+            return binds_lexical_names(static_cast<const DoWhileStatement*>(node)->get_body());
+        case ASTNode::Type::FOR_IN_STATEMENT:
+            return binds_lexical_names(static_cast<const ForInStatement*>(node)->get_body());
+        case ASTNode::Type::FOR_OF_STATEMENT:
+            return binds_lexical_names(static_cast<const ForOfStatement*>(node)->get_body());
+        case ASTNode::Type::SWITCH_STATEMENT:
+            // Cases run in the switch's environment
+            for (const auto& case_node : static_cast<const SwitchStatement*>(node)->get_cases()) {
+                if (case_node->get_type() != ASTNode::Type::CASE_CLAUSE) return true;
+                for (const auto& statement : static_cast<const CaseClause*>(case_node.get())->get_consequent()) {
+                    if (binds_lexical_names(statement.get())) return true;
+                }
+            }
+            return false;
+        case ASTNode::Type::EXPORT_STATEMENT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Enters a declarative environment under the current lexical one, reusing
+// the spare left by an earlier exit when there is one
+static Environment* enter_scope_environment(Context& ctx, Environment*& spare) {
+    Environment* env = spare;
+    if (env) {
+        spare = nullptr;
+        env->reset(ctx.get_lexical_environment());
+    } else {
+        env = new Environment(Environment::Type::Declarative, ctx.get_lexical_environment());
+    }
+    ctx.set_lexical_environment(env);
+    return env;
+}
+
+// Leaves env for outer. An environment that nothing else holds (no closure,
+// no inner scope still alive) is emptied and kept as the next spare
+static void leave_scope_environment(Context& ctx, Environment* env, Environment* outer, Environment*& spare) {
+    ctx.set_lexical_environment(outer);
+    if (!spare && !env->is_shared()) {
+        env->reset(nullptr);
+        spare = env;
+    } else {
+        env->release();
+    }
+}
+
+BlockStatement::~BlockStatement() {
+    if (spare_environment_) spare_environment_->release();
+}
+
 Value BlockStatement::evaluate(Context& ctx) {
+    if (async_stack_exhausted(ctx)) return Value();
+    
     Value last_value;
     
-    // Create new block scope for let/const declarations
+    // Only a block that declares let/const needs a scope of its own;
+    // anything else runs directly in the enclosing one
+    if (scope_ == Scope::Unknown) {
+        scope_ = Scope::None;
+        for (const auto& statement : statements_) {
+            if (binds_lexical_names(statement.get())) {
+                scope_ = Scope::Lexical;
+                break;
+            }
+        }
+    }
     Environment* old_lexical_env = ctx.get_lexical_environment();
-    auto block_env = std::make_unique<Environment>(Environment::Type::Declarative, old_lexical_env);
-    Environment* block_env_ptr = block_env.release();
-    ctx.set_lexical_environment(block_env_ptr);
+    Environment* block_env_ptr = nullptr;
+    if (scope_ == Scope::Lexical) {
+        block_env_ptr = enter_scope_environment(ctx, spare_environment_);
+    }
     
     // HOISTING: First pass - process function declarations
     for (const auto& statement : statements_) {
@@ -5925,43 +5538,41 @@ Value BlockStatement::evaluate(Context& ctx) {
             last_value = statement->evaluate(ctx);
             if (ctx.has_exception()) {
                 // Clean up environment before returning
-                ctx.set_lexical_environment(old_lexical_env);
-                delete block_env_ptr;
+                if (block_env_ptr) leave_scope_environment(ctx, block_env_ptr, old_lexical_env, spare_environment_);
                 return Value();
             }
         }
     }
     
     // Second pass - process all other statements
+    GarbageCollector* gc = ctx.get_garbage_collector();
     for (const auto& statement : statements_) {
         if (statement->get_type() != ASTNode::Type::FUNCTION_DECLARATION) {
+            HandleScope statement_scope(gc);
             last_value = statement->evaluate(ctx);
             if (ctx.has_exception()) {
                 // Clean up environment before returning
-                ctx.set_lexical_environment(old_lexical_env);
-                delete block_env_ptr;
+                if (block_env_ptr) leave_scope_environment(ctx, block_env_ptr, old_lexical_env, spare_environment_);
                 return Value();
             }
             // Check if a return statement was executed
             if (ctx.has_return_value()) {
                 // Clean up environment before returning
-                ctx.set_lexical_environment(old_lexical_env);
-                delete block_env_ptr;
+                if (block_env_ptr) leave_scope_environment(ctx, block_env_ptr, old_lexical_env, spare_environment_);
                 return ctx.get_return_value();
             }
             // Break and continue statements should propagate up
             if (ctx.has_break() || ctx.has_continue()) {
                 // Clean up environment before returning
-                ctx.set_lexical_environment(old_lexical_env);
-                delete block_env_ptr;
+                if (block_env_ptr) leave_scope_environment(ctx, block_env_ptr, old_lexical_env, spare_environment_);
                 return Value();
             }
         }
     }
     
-    // Restore original lexical environment
-    ctx.set_lexical_environment(old_lexical_env);
-    delete block_env_ptr; // Clean up the block environment
+    // Restore original lexical environment; closures created in the block
+    // may keep its environment alive
+    if (block_env_ptr) leave_scope_environment(ctx, block_env_ptr, old_lexical_env, spare_environment_);
     
     return last_value;
 }
@@ -6039,16 +5650,55 @@ std::unique_ptr<ASTNode> IfStatement::clone() const {
     );
 }
 
+//=============================================================================
+// On-stack replacement
+//=============================================================================
+
+// Counts a loop back edge; once the loop is hot, its remaining iterations
+// continue in the optimizing tier
+static OptimizingCompiler::OsrResult osr_back_edge(ASTNode* loop, std::unique_ptr<LoopOsrState>& state, Context& ctx) {
+    if (!state) {
+        state = std::make_unique<LoopOsrState>();
+    }
+    if (state->disabled || (++state->backedges < state->next_attempt && !state->code)) {
+        return OptimizingCompiler::OsrResult::NotEntered;
+    }
+    Engine* engine = ctx.get_engine();
+    OptimizingCompiler* compiler = engine ? engine->get_optimizing_compiler() : nullptr;
+    if (!compiler) {
+        return OptimizingCompiler::OsrResult::NotEntered;
+    }
+    return compiler->try_osr(loop, *state, ctx);
+}
+
 //=============================================================================
 // ForStatement Implementation
 //=============================================================================
 
+// Out of line: LoopOsrState is only complete here
+ForStatement::ForStatement(std::unique_ptr<ASTNode> init, std::unique_ptr<ASTNode> test,
+                           std::unique_ptr<ASTNode> update, std::unique_ptr<ASTNode> body,
+                           const Position& start, const Position& end)
+    : ASTNode(Type::FOR_STATEMENT, start, end),
+      init_(std::move(init)), test_(std::move(test)),
+      update_(std::move(update)), body_(std::move(body)) {}
+
+ForStatement::~ForStatement() {
+    if (spare_environment_) spare_environment_->release();
+}
+
 Value ForStatement::evaluate(Context& ctx) {
-    // JIT compilation removed - was simulation code
-    
-    // Create a new block scope for the for-loop to handle proper block scoping
-    // This prevents variable redeclaration issues with let/const
-    ctx.push_block_scope();
+    // let/const loop variables live in a scope of their own; a var or
+    // expression initializer needs none
+    Environment* old_lexical_env = ctx.get_lexical_environment();
+    Environment* loop_env = nullptr;
+    if (init_ && init_->get_type() == Type::VARIABLE_DECLARATION &&
+        static_cast<VariableDeclaration*>(init_.get())->get_kind() != VariableDeclarator::Kind::VAR) {
+        loop_env = enter_scope_environment(ctx, spare_environment_);
+    }
+    auto leave = [&]() {
+        if (loop_env) leave_scope_environment(ctx, loop_env, old_lexical_env, spare_environment_);
+    };
     
     Value result;
     try {
@@ -6056,27 +5706,19 @@ Value ForStatement::evaluate(Context& ctx) {
         if (init_) {
             init_->evaluate(ctx);
             if (ctx.has_exception()) {
-                ctx.pop_block_scope();
+                leave();
                 return Value();
             }
         }
     
-    // Loop optimization disabled - use standard loop execution for accuracy
-    // TODO: Fix mathematical optimization formulas
-    // if (can_optimize_as_simple_loop()) {
-    //     Value optimized_result = execute_optimized_loop(ctx);
-    //     if (optimized_result.is_boolean() && optimized_result.as_boolean()) {
-    //         // Optimization succeeded, return undefined like a normal loop
-    //         return Value();
-    //     }
-    //     // Fall through to standard loop if optimization failed
-    // }
-    
     // ULTRA-PERFORMANCE: Reduced overhead safety checking
     unsigned int safety_counter = 0;
     const unsigned int max_iterations = 1000000000U;  // 1B iterations
+    GarbageCollector* gc = ctx.get_garbage_collector();
     
     while (true) {
+        HandleScope iteration_scope(gc);
+        
         // Optimized safety check - only every 1M iterations to reduce overhead
         if (__builtin_expect((safety_counter & 0xFFFFF) == 0, 0)) {
             if (safety_counter > max_iterations) {
@@ -6090,7 +5732,7 @@ Value ForStatement::evaluate(Context& ctx) {
         if (test_) {
             Value test_value = test_->evaluate(ctx);
             if (ctx.has_exception()) {
-                ctx.pop_block_scope();
+                leave();
                 return Value();
             }
             if (!test_value.to_boolean()) {
@@ -6104,7 +5746,7 @@ Value ForStatement::evaluate(Context& ctx) {
             // This allows variable declarations inside the loop body
             Value body_result = body_->evaluate(ctx);
             if (ctx.has_exception()) {
-                ctx.pop_block_scope();
+                leave();
                 return Value();
             }
             
@@ -6119,28 +5761,54 @@ Value ForStatement::evaluate(Context& ctx) {
                 goto continue_loop;
             }
             if (ctx.has_return_value()) {
+                leave();
                 return ctx.get_return_value();
             }
         }
         
         continue_loop:
+        // Each iteration has its own loop variables, but they only need
+        // copying when this one's outlived it (captured by a closure)
+        if (loop_env && loop_env->is_shared()) {
+            Environment* next_env = new Environment(Environment::Type::Declarative, old_lexical_env);
+            for (const std::string& name : loop_env->get_binding_names()) {
+                next_env->create_binding(name, loop_env->get_binding(name), loop_env->is_mutable_binding(name));
+            }
+            ctx.set_lexical_environment(next_env);
+            loop_env->release();
+            loop_env = next_env;
+        }
+        
         // Execute update
         if (update_) {
             update_->evaluate(ctx);
             if (ctx.has_exception()) {
-                ctx.pop_block_scope();
+                leave();
+                return Value();
+            }
+        }
+        
+        // Back edge: a hot loop finishes in the optimizing tier
+        if (osr_back_edge(this, osr_state_, ctx) == OptimizingCompiler::OsrResult::Exited) {
+            if (ctx.has_exception()) {
+                leave();
                 return Value();
             }
+            if (ctx.has_return_value()) {
+                leave();
+                return ctx.get_return_value();
+            }
+            break;
         }
     }
     
         result = Value();
     } catch (...) {
-        ctx.pop_block_scope();
+        leave();
         throw;
     }
     
-    ctx.pop_block_scope();
+    leave();
     return result;
 }
 
@@ -6156,89 +5824,6 @@ std::string ForStatement::to_string() const {
     return oss.str();
 }
 
-// Loop optimization implementation
-bool ForStatement::can_optimize_as_simple_loop() const {
-    // Check if this is a simple counting loop pattern:
-    // for (let i = start; i < end; i += step) { simple_body }
-    
-    // Must have all components
-    if (!init_ || !test_ || !update_ || !body_) {
-        return false;
-    }
-    
-    // For now, optimize any loop with numeric bounds
-    // A full implementation would analyze the AST structure
-    return true; // Simple heuristic - try to optimize all loops
-}
-
-Value ForStatement::execute_optimized_loop(Context& ctx) const {
-    // High-performance loop optimization: Execute the loop body once to understand the pattern,
-    // then use mathematical formulas to compute the result instantly
-    
-    if (!init_ || !test_ || !update_ || !body_) {
-        return Value(); // Can't optimize without all components
-    }
-    
-    // Execute the loop normally but return immediately after calculating the mathematical result
-    // Pattern recognition and mathematical optimization
-    
-    std::string body_str = body_ ? body_->to_string() : "";
-    
-    // Pattern matching for optimization
-    
-    // Pattern recognition and mathematical optimization
-    if (body_str.find("sum") != std::string::npos && body_str.find("+=") != std::string::npos && body_str.find("i") != std::string::npos) {
-        // Pattern: sum += i (arithmetic progression)
-        // Auto-detect loop bounds by checking test condition patterns
-        double n = 40000000000.0; // Default loop bound
-        if (body_str.find("400000000") != std::string::npos) n = 400000000.0; // 400M case
-        if (body_str.find("200000000") != std::string::npos) n = 200000000.0; // 200M case
-        if (body_str.find("10000000") != std::string::npos) n = 10000000.0; // 10M case
-        
-        double mathematical_result = (n - 1.0) * n / 2.0;
-        
-        // Set the sum variable in context
-        ctx.set_binding("sum", Value(mathematical_result));
-        
-        // Sum optimization: O(1) arithmetic progression instead of O(n) loop
-        return Value(true); // Return success indicator
-    }
-    else if (body_str.find("result") != std::string::npos && body_str.find("add") != std::string::npos) {
-        // Pattern: result += add(i, i+1)
-        double n = 30000000000.0; // Default loop bound
-        if (body_str.find("300000000") != std::string::npos) n = 300000000.0; // 300M case
-        if (body_str.find("150000000") != std::string::npos) n = 150000000.0; // 150M case
-        if (body_str.find("5000000") != std::string::npos) n = 5000000.0; // 5M case
-        
-        double sum_i = (n - 1.0) * n / 2.0;
-        double mathematical_result = 2.0 * sum_i + n;
-        
-        // Set the result variable in context  
-        ctx.set_binding("result", Value(mathematical_result));
-        
-        // Function call optimization: O(1) mathematical formula instead of O(n) loop
-        return Value(true); // Return success indicator
-    }
-    else if (body_str.find("varTest") != std::string::npos && body_str.find("temp") != std::string::npos) {
-        // Pattern: varTest += temp where temp = i*2
-        double n = 30000000000.0; // Default loop bound
-        if (body_str.find("300000000") != std::string::npos) n = 300000000.0; // 300M case
-        if (body_str.find("150000000") != std::string::npos) n = 150000000.0; // 150M case
-        if (body_str.find("5000000") != std::string::npos) n = 5000000.0; // 5M case
-        
-        double mathematical_result = (n - 1.0) * n;
-        
-        // Set the varTest variable in context
-        ctx.set_binding("varTest", Value(mathematical_result));
-        
-        // Variable optimization: O(1) mathematical formula instead of O(n) loop
-        return Value(true); // Return success indicator
-    }
-    
-    // If we can't recognize the pattern, fall back to normal execution
-    return Value();
-}
-
 std::unique_ptr<ASTNode> ForStatement::clone() const {
     std::unique_ptr<ASTNode> cloned_init = init_ ? init_->clone() : nullptr;
     std::unique_ptr<ASTNode> cloned_test = test_ ? test_->clone() : nullptr;
@@ -6308,6 +5893,7 @@ Value ForInStatement::evaluate(Context& ctx) {
             }
             
             // Execute loop body
+            HandleScope iteration_scope(ctx.get_garbage_collector());
             Value result = body_->evaluate(ctx);
             if (ctx.has_exception()) return Value();
             
@@ -6359,27 +5945,25 @@ Value ForOfStatement::evaluate(Context& ctx) {
             boxed_string->set_property("length", Value(static_cast<double>(iterable.to_string().length())));
             
             // Add Symbol.iterator method for this string
-            Symbol* iterator_symbol = Symbol::get_well_known(Symbol::ITERATOR);
-            if (iterator_symbol) {
-                std::string str_value = iterable.to_string();
-                auto string_iterator_fn = ObjectFactory::create_native_function("@@iterator",
-                    [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
-                        (void)ctx; (void)args;
-                        auto iterator = std::make_unique<StringIterator>(str_value);
-                        return Value(iterator.release());
-                    });
-                boxed_string->set_property(iterator_symbol->to_string(), Value(string_iterator_fn.release()));
-            }
+            std::string str_value = iterable.to_string();
+            auto string_iterator_fn = ObjectFactory::create_native_function("@@iterator",
+                [str_value](Context& ctx, const std::vector<Value>& args) -> Value {
+                    (void)ctx; (void)args;
+                    auto iterator = std::make_unique<StringIterator>(str_value);
+                    return Value(iterator.release());
+                });
+            boxed_string->set_property(Symbol::well_known_key(WellKnownSymbol::Iterator), Value(string_iterator_fn.release()));
             obj = boxed_string.get();
         } else {
             obj = iterable.as_object();
         }
         
-        // Check for Symbol.iterator
-        Symbol* iterator_symbol = Symbol::get_well_known(Symbol::ITERATOR);
-        if (iterator_symbol && obj && obj->has_property(iterator_symbol->to_string())) {
+        // Check for Symbol.iterator; objects whose shapes hold no such key,
+        // plain arrays included, skip the lookup and iterate directly below
+        const std::string& iterator_key = Symbol::well_known_key(WellKnownSymbol::Iterator);
+        if (obj && obj->may_have_symbol_key(Shape::ITERATOR_KEY) && obj->has_property(iterator_key)) {
             // Get the iterator method
-            Value iterator_method = obj->get_property(iterator_symbol->to_string());
+            Value iterator_method = obj->get_property(iterator_key);
             if (iterator_method.is_function()) {
                 Function* iter_fn = iterator_method.as_function();
                 Value iterator_obj = iter_fn->call(ctx, {}, iterable);
@@ -6418,6 +6002,7 @@ Value ForOfStatement::evaluate(Context& ctx) {
                         
                         // Iterate using iterator protocol
                         while (iteration_count < MAX_ITERATIONS) {
+                            HandleScope iteration_scope(ctx.get_garbage_collector());
                             iteration_count++;
                             
                             // Call next method via function call - the iterator implementation is now fixed
@@ -6487,12 +6072,6 @@ Value ForOfStatement::evaluate(Context& ctx) {
         if (obj->get_type() == Object::ObjectType::Array) {
             uint32_t length = obj->get_length();
             
-            // Safety limit for arrays
-            if (length > 50) {
-                ctx.throw_exception(Value("For...of: Array too large (>50 elements)"));
-                return Value();
-            }
-            
             // Get variable name for loop iteration
             std::string var_name;
             VariableDeclarator::Kind var_kind = VariableDeclarator::Kind::LET;
@@ -6572,6 +6151,7 @@ Value ForOfStatement::evaluate(Context& ctx) {
                 
                 // Execute loop body
                 if (body_) {
+                    HandleScope iteration_scope(ctx.get_garbage_collector());
                     Value result = body_->evaluate(*loop_ctx);
                     if (loop_ctx->has_exception()) {
                         ctx.throw_exception(loop_ctx->get_exception());
@@ -6618,16 +6198,27 @@ std::unique_ptr<ASTNode> ForOfStatement::clone() const {
 // WhileStatement Implementation
 //=============================================================================
 
+WhileStatement::WhileStatement(std::unique_ptr<ASTNode> test, std::unique_ptr<ASTNode> body,
+                               const Position& start, const Position& end)
+    : ASTNode(Type::WHILE_STATEMENT, start, end),
+      test_(std::move(test)), body_(std::move(body)) {}
+
+WhileStatement::~WhileStatement() = default;
+
 Value WhileStatement::evaluate(Context& ctx) {
     // Safety counter to prevent infinite loops and memory issues
     int safety_counter = 0;
     const int max_iterations = 1000000000; // High-performance: 1B iterations
     
+    GarbageCollector* gc = ctx.get_garbage_collector();
+    
     try {
         while (true) {
+            HandleScope iteration_scope(gc);
+            
             // Safety check with warning instead of stopping
             if (++safety_counter > max_iterations) {
-                static bool warned = false;
+                static thread_local bool warned = false;
                 if (!warned) {
                     std::cout << " optimized: Loop exceeded " << max_iterations 
                              << " iterations, continuing..." << std::endl;
@@ -6656,15 +6247,29 @@ Value WhileStatement::evaluate(Context& ctx) {
                 Value body_result = body_->evaluate(ctx);
                 if (ctx.has_exception()) return Value();
                 
-                // Check for memory issues every 10 iterations
-                if (safety_counter % 10 == 0) {
-                    // Force a small delay to prevent memory issues
-                    // This is a safety mechanism
+                // Handle break, continue and return
+                if (ctx.has_break()) {
+                    ctx.clear_break_continue();
+                    break;
+                }
+                if (ctx.has_continue()) {
+                    ctx.clear_break_continue();
+                }
+                if (ctx.has_return_value()) {
+                    return ctx.get_return_value();
                 }
             } catch (...) {
                 ctx.throw_exception(Value("Error in while-loop body execution"));
                 return Value();
             }
+            
+            // Back edge: a hot loop finishes in the optimizing tier
+            if (osr_back_edge(this, osr_state_, ctx) == OptimizingCompiler::OsrResult::Exited) {
+                if (ctx.has_return_value() && !ctx.has_exception()) {
+                    return ctx.get_return_value();
+                }
+                return Value();
+            }
         }
     } catch (...) {
         ctx.throw_exception(Value("Fatal error in while-loop execution"));
@@ -6688,16 +6293,27 @@ std::unique_ptr<ASTNode> WhileStatement::clone() const {
 // DoWhileStatement Implementation
 //=============================================================================
 
+DoWhileStatement::DoWhileStatement(std::unique_ptr<ASTNode> body, std::unique_ptr<ASTNode> test,
+                                   const Position& start, const Position& end)
+    : ASTNode(Type::DO_WHILE_STATEMENT, start, end),
+      body_(std::move(body)), test_(std::move(test)) {}
+
+DoWhileStatement::~DoWhileStatement() = default;
+
 Value DoWhileStatement::evaluate(Context& ctx) {
     // Safety counter to prevent infinite loops and memory issues
     int safety_counter = 0;
     const int max_iterations = 1000000000; // High-performance: 1B iterations
     
+    GarbageCollector* gc = ctx.get_garbage_collector();
+    
     try {
         do {
+            HandleScope iteration_scope(gc);
+            
             // Safety check with warning instead of stopping
             if (++safety_counter > max_iterations) {
-                static bool warned = false;
+                static thread_local bool warned = false;
                 if (!warned) {
                     std::cout << " optimized: Loop exceeded " << max_iterations 
                              << " iterations, continuing..." << std::endl;
@@ -6720,6 +6336,9 @@ Value DoWhileStatement::evaluate(Context& ctx) {
                     ctx.clear_break_continue();
                     // Continue to condition check
                 }
+                if (ctx.has_return_value()) {
+                    return ctx.get_return_value();
+                }
                 
             } catch (...) {
                 ctx.throw_exception(Value("Error in do-while-loop body execution"));
@@ -6735,118 +6354,473 @@ Value DoWhileStatement::evaluate(Context& ctx) {
                 ctx.throw_exception(Value("Error evaluating do-while-loop condition"));
                 return Value();
             }
-            
-            // Check condition result - if false, exit loop
-            if (!test_value.to_boolean()) {
+            
+            // Check condition result - if false, exit loop
+            if (!test_value.to_boolean()) {
+                break;
+            }
+            
+            // Back edge: a hot loop finishes in the optimizing tier
+            if (osr_back_edge(this, osr_state_, ctx) == OptimizingCompiler::OsrResult::Exited) {
+                if (ctx.has_return_value() && !ctx.has_exception()) {
+                    return ctx.get_return_value();
+                }
+                return Value();
+            }
+            
+        } while (true); // The actual loop condition is checked inside
+        
+    } catch (...) {
+        ctx.throw_exception(Value("Fatal error in do-while-loop execution"));
+        return Value();
+    }
+    
+    return Value(); // undefined
+}
+
+std::string DoWhileStatement::to_string() const {
+    return "do " + body_->to_string() + " while (" + test_->to_string() + ")";
+}
+
+std::unique_ptr<ASTNode> DoWhileStatement::clone() const {
+    return std::make_unique<DoWhileStatement>(
+        body_->clone(), test_->clone(), start_, end_
+    );
+}
+
+//=============================================================================
+// FunctionDeclaration Implementation
+//=============================================================================
+
+// Scope analysis for closures. A function literal only needs the scope it
+// is created in when it names one of the enclosing function's bindings;
+// otherwise its closures resolve through the scope that function was itself
+// created in, and the enclosing activation can die when its call returns.
+// The analysis over-approximates: a name counts as a reference wherever it
+// appears in the literal, and constructs it does not model (destructuring
+// placeholders, modules, JSX) make every closure keep its scope.
+class ClosureScopeAnalysis {
+public:
+    void analyze(const std::vector<std::unique_ptr<Parameter>>& params, ASTNode* body) {
+        walk_params(params);
+        walk(body);
+        if (!complete_) return;
+
+        for (ASTNode* literal : literals_) {
+            ClosureScopeAnalysis inner;
+            inner.collect_references_ = true;
+            inner.walk_literal(literal);
+            // The literal's parameters are bound before any of its code runs
+            for (const auto& param : *params_of(literal)) {
+                inner.names_.erase(param->get_name()->get_name());
+            }
+            bool captures = !inner.complete_;
+            for (const auto& name : inner.names_) {
+                if (captures) break;
+                captures = names_.count(name) || name == "this" || name == "arguments" ||
+                           name == "eval" || name == "super";
+            }
+            set_captures_scope(literal, captures);
+        }
+    }
+
+private:
+    std::unordered_set<std::string> names_;     // declared, or referenced in a literal
+    std::vector<ASTNode*> literals_;            // literals directly in the analyzed function
+    bool collect_references_ = false;
+    bool complete_ = true;
+
+    void declare(const std::string& name) {
+        // Placeholders the parser binds destructured names under
+        if (name.compare(0, 2, "__") == 0) complete_ = false;
+        names_.insert(name);
+    }
+
+    void reference(ASTNode* node) {
+        if (collect_references_ && node && node->get_type() == ASTNode::Type::IDENTIFIER) {
+            declare(static_cast<Identifier*>(node)->get_name());
+        }
+    }
+
+    // Identifiers a function would bind if the name were undeclared
+    void target(ASTNode* node) {
+        if (node && node->get_type() == ASTNode::Type::IDENTIFIER) {
+            declare(static_cast<Identifier*>(node)->get_name());
+        } else {
+            walk(node);
+        }
+    }
+
+    static void set_captures_scope(ASTNode* literal, bool captures) {
+        switch (literal->get_type()) {
+            case ASTNode::Type::FUNCTION_DECLARATION:
+                static_cast<FunctionDeclaration*>(literal)->set_captures_scope(captures);
+                break;
+            case ASTNode::Type::FUNCTION_EXPRESSION:
+                static_cast<FunctionExpression*>(literal)->set_captures_scope(captures);
+                break;
+            case ASTNode::Type::ARROW_FUNCTION_EXPRESSION:
+                static_cast<ArrowFunctionExpression*>(literal)->set_captures_scope(captures);
+                break;
+            default:
+                break;
+        }
+    }
+
+    static const std::vector<std::unique_ptr<Parameter>>* params_of(ASTNode* literal) {
+        switch (literal->get_type()) {
+            case ASTNode::Type::FUNCTION_DECLARATION:
+                return &static_cast<FunctionDeclaration*>(literal)->get_params();
+            case ASTNode::Type::FUNCTION_EXPRESSION:
+                return &static_cast<FunctionExpression*>(literal)->get_params();
+            case ASTNode::Type::ARROW_FUNCTION_EXPRESSION:
+                return &static_cast<ArrowFunctionExpression*>(literal)->get_params();
+            default:
+                return &static_cast<AsyncFunctionExpression*>(literal)->get_params();
+        }
+    }
+
+    void walk_params(const std::vector<std::unique_ptr<Parameter>>& params) {
+        for (const auto& param : params) {
+            declare(param->get_name()->get_name());
+            walk(param->get_default_value());
+        }
+    }
+
+    // A literal met while collecting references is part of the references
+    void walk_literal(ASTNode* node) {
+        walk_params(*params_of(node));
+        switch (node->get_type()) {
+            case ASTNode::Type::FUNCTION_DECLARATION:
+                walk(static_cast<FunctionDeclaration*>(node)->get_body());
+                break;
+            case ASTNode::Type::FUNCTION_EXPRESSION:
+                walk(static_cast<FunctionExpression*>(node)->get_body());
+                break;
+            case ASTNode::Type::ARROW_FUNCTION_EXPRESSION:
+                walk(static_cast<ArrowFunctionExpression*>(node)->get_body());
+                break;
+            default:
+                walk(static_cast<AsyncFunctionExpression*>(node)->get_body());
+                break;
+        }
+    }
+
+    void walk(ASTNode* node) {
+        if (!node || !complete_) return;
+
+        switch (node->get_type()) {
+            case ASTNode::Type::NUMBER_LITERAL:
+            case ASTNode::Type::STRING_LITERAL:
+            case ASTNode::Type::BOOLEAN_LITERAL:
+            case ASTNode::Type::NULL_LITERAL:
+            case ASTNode::Type::BIGINT_LITERAL:
+            case ASTNode::Type::UNDEFINED_LITERAL:
+            case ASTNode::Type::REGEX_LITERAL:
+            case ASTNode::Type::BREAK_STATEMENT:
+            case ASTNode::Type::CONTINUE_STATEMENT:
+                break;
+            case ASTNode::Type::IDENTIFIER:
+                reference(node);
+                break;
+            case ASTNode::Type::PARAMETER: {
+                auto* param = static_cast<Parameter*>(node);
+                declare(param->get_name()->get_name());
+                walk(param->get_default_value());
+                break;
+            }
+            case ASTNode::Type::TEMPLATE_LITERAL:
+                for (const auto& element : static_cast<TemplateLiteral*>(node)->get_elements()) {
+                    walk(element.expression.get());
+                }
+                break;
+            case ASTNode::Type::BINARY_EXPRESSION: {
+                auto* binary = static_cast<BinaryExpression*>(node);
+                walk(binary->get_left());
+                walk(binary->get_right());
+                break;
+            }
+            case ASTNode::Type::UNARY_EXPRESSION: {
+                auto* unary = static_cast<UnaryExpression*>(node);
+                switch (unary->get_operator()) {
+                    case UnaryExpression::Operator::PRE_INCREMENT:
+                    case UnaryExpression::Operator::POST_INCREMENT:
+                    case UnaryExpression::Operator::PRE_DECREMENT:
+                    case UnaryExpression::Operator::POST_DECREMENT:
+                        target(unary->get_operand());
+                        break;
+                    default:
+                        walk(unary->get_operand());
+                        break;
+                }
+                break;
+            }
+            case ASTNode::Type::ASSIGNMENT_EXPRESSION: {
+                auto* assignment = static_cast<AssignmentExpression*>(node);
+                target(assignment->get_left());
+                walk(assignment->get_right());
+                break;
+            }
+            case ASTNode::Type::CONDITIONAL_EXPRESSION: {
+                auto* conditional = static_cast<ConditionalExpression*>(node);
+                walk(conditional->get_test());
+                walk(conditional->get_consequent());
+                walk(conditional->get_alternate());
+                break;
+            }
+            case ASTNode::Type::DESTRUCTURING_ASSIGNMENT: {
+                auto* destructuring = static_cast<DestructuringAssignment*>(node);
+                for (const auto& id : destructuring->get_targets()) {
+                    declare(id->get_name());
+                }
+                for (const auto& mapping : destructuring->get_property_mappings()) {
+                    if (mapping.variable_name.find(':') != std::string::npos) complete_ = false;
+                    declare(mapping.variable_name);
+                }
+                for (const auto& default_value : destructuring->get_default_values()) {
+                    walk(default_value.expr.get());
+                }
+                walk(destructuring->get_source());
+                break;
+            }
+            case ASTNode::Type::CALL_EXPRESSION: {
+                auto* call = static_cast<CallExpression*>(node);
+                walk(call->get_callee());
+                for (const auto& arg : call->get_arguments()) {
+                    walk(arg.get());
+                }
+                break;
+            }
+            case ASTNode::Type::MEMBER_EXPRESSION: {
+                auto* member = static_cast<MemberExpression*>(node);
+                walk(member->get_object());
+                if (member->is_computed()) walk(member->get_property());
+                break;
+            }
+            case ASTNode::Type::OPTIONAL_CHAINING_EXPRESSION: {
+                auto* chain = static_cast<OptionalChainingExpression*>(node);
+                walk(chain->get_object());
+                if (chain->is_computed()) walk(chain->get_property());
+                break;
+            }
+            case ASTNode::Type::NULLISH_COALESCING_EXPRESSION: {
+                auto* nullish = static_cast<NullishCoalescingExpression*>(node);
+                walk(nullish->get_left());
+                walk(nullish->get_right());
+                break;
+            }
+            case ASTNode::Type::NEW_EXPRESSION: {
+                auto* new_expr = static_cast<NewExpression*>(node);
+                walk(new_expr->get_constructor());
+                for (const auto& arg : new_expr->get_arguments()) {
+                    walk(arg.get());
+                }
+                break;
+            }
+            case ASTNode::Type::FUNCTION_DECLARATION:
+                declare(static_cast<FunctionDeclaration*>(node)->get_id()->get_name());
+                // fall through
+            case ASTNode::Type::FUNCTION_EXPRESSION:
+            case ASTNode::Type::ARROW_FUNCTION_EXPRESSION:
+            case ASTNode::Type::ASYNC_FUNCTION_EXPRESSION:
+                if (collect_references_) {
+                    walk_literal(node);
+                } else {
+                    literals_.push_back(node);
+                }
+                break;
+            case ASTNode::Type::AWAIT_EXPRESSION:
+                walk(static_cast<AwaitExpression*>(node)->get_argument());
+                break;
+            case ASTNode::Type::YIELD_EXPRESSION:
+                walk(static_cast<YieldExpression*>(node)->get_argument());
+                break;
+            case ASTNode::Type::OBJECT_LITERAL:
+                for (const auto& property : static_cast<ObjectLiteral*>(node)->get_properties()) {
+                    if (property->computed) walk(property->key.get());
+                    walk(property->value.get());
+                }
+                break;
+            case ASTNode::Type::ARRAY_LITERAL:
+                for (const auto& element : static_cast<ArrayLiteral*>(node)->get_elements()) {
+                    walk(element.get());
+                }
+                break;
+            case ASTNode::Type::SPREAD_ELEMENT:
+                walk(static_cast<SpreadElement*>(node)->get_argument());
+                break;
+            case ASTNode::Type::EXPRESSION_STATEMENT:
+                walk(static_cast<ExpressionStatement*>(node)->get_expression());
+                break;
+            case ASTNode::Type::VARIABLE_DECLARATION:
+                for (const auto& declarator : static_cast<VariableDeclaration*>(node)->get_declarations()) {
+                    walk(declarator.get());
+                }
+                break;
+            case ASTNode::Type::VARIABLE_DECLARATOR: {
+                auto* declarator = static_cast<VariableDeclarator*>(node);
+                declare(declarator->get_id()->get_name());
+                walk(declarator->get_init());
+                break;
+            }
+            case ASTNode::Type::BLOCK_STATEMENT:
+                for (const auto& statement : static_cast<BlockStatement*>(node)->get_statements()) {
+                    walk(statement.get());
+                }
+                break;
+            case ASTNode::Type::IF_STATEMENT: {
+                auto* if_stmt = static_cast<IfStatement*>(node);
+                walk(if_stmt->get_test());
+                walk(if_stmt->get_consequent());
+                walk(if_stmt->get_alternate());
+                break;
+            }
+            case ASTNode::Type::FOR_STATEMENT: {
+                auto* for_stmt = static_cast<ForStatement*>(node);
+                walk(for_stmt->get_init());
+                walk(for_stmt->get_test());
+                walk(for_stmt->get_update());
+                walk(for_stmt->get_body());
+                break;
+            }
+            case ASTNode::Type::FOR_IN_STATEMENT: {
+                auto* for_in = static_cast<ForInStatement*>(node);
+                target(for_in->get_left());
+                walk(for_in->get_right());
+                walk(for_in->get_body());
+                break;
+            }
+            case ASTNode::Type::FOR_OF_STATEMENT: {
+                auto* for_of = static_cast<ForOfStatement*>(node);
+                target(for_of->get_left());
+                walk(for_of->get_right());
+                walk(for_of->get_body());
+                break;
+            }
+            case ASTNode::Type::WHILE_STATEMENT: {
+                auto* while_stmt = static_cast<WhileStatement*>(node);
+                walk(while_stmt->get_test());
+                walk(while_stmt->get_body());
+                break;
+            }
+            case ASTNode::Type::DO_WHILE_STATEMENT: {
+                auto* do_while = static_cast<DoWhileStatement*>(node);
+                walk(do_while->get_body());
+                walk(do_while->get_test());
+                break;
+            }
+            case ASTNode::Type::CLASS_DECLARATION: {
+                auto* class_decl = static_cast<ClassDeclaration*>(node);
+                if (class_decl->get_id()) declare(class_decl->get_id()->get_name());
+                walk(class_decl->get_superclass());
+                walk(class_decl->get_body());
+                break;
+            }
+            case ASTNode::Type::METHOD_DEFINITION:
+                walk(static_cast<MethodDefinition*>(node)->get_value());
+                break;
+            case ASTNode::Type::RETURN_STATEMENT:
+                walk(static_cast<ReturnStatement*>(node)->get_argument());
+                break;
+            case ASTNode::Type::TRY_STATEMENT: {
+                auto* try_stmt = static_cast<TryStatement*>(node);
+                walk(try_stmt->get_try_block());
+                walk(try_stmt->get_catch_clause());
+                walk(try_stmt->get_finally_block());
+                break;
+            }
+            case ASTNode::Type::CATCH_CLAUSE: {
+                auto* catch_clause = static_cast<CatchClause*>(node);
+                if (!catch_clause->get_parameter_name().empty()) declare(catch_clause->get_parameter_name());
+                walk(catch_clause->get_body());
+                break;
+            }
+            case ASTNode::Type::THROW_STATEMENT:
+                walk(static_cast<ThrowStatement*>(node)->get_expression());
+                break;
+            case ASTNode::Type::SWITCH_STATEMENT: {
+                auto* switch_stmt = static_cast<SwitchStatement*>(node);
+                walk(switch_stmt->get_discriminant());
+                for (const auto& case_clause : switch_stmt->get_cases()) {
+                    walk(case_clause.get());
+                }
                 break;
             }
-            
-        } while (true); // The actual loop condition is checked inside
-        
-    } catch (...) {
-        ctx.throw_exception(Value("Fatal error in do-while-loop execution"));
-        return Value();
+            case ASTNode::Type::CASE_CLAUSE: {
+                auto* case_clause = static_cast<CaseClause*>(node);
+                walk(case_clause->get_test());
+                for (const auto& statement : case_clause->get_consequent()) {
+                    walk(statement.get());
+                }
+                break;
+            }
+            default:
+                complete_ = false;
+                break;
+        }
     }
-    
-    return Value(); // undefined
-}
+};
 
-std::string DoWhileStatement::to_string() const {
-    return "do " + body_->to_string() + " while (" + test_->to_string() + ")";
+// A function literal's shared info: a copy of its parameters and body, made
+// the first time the literal is evaluated and referenced by every closure
+// created from it after that. The copy belongs to the closures, not to the
+// script's tree, which may be destroyed while they live on
+static const std::shared_ptr<SharedFunctionInfo>& shared_info_for(std::shared_ptr<SharedFunctionInfo>& info,
+                                                                  const std::vector<std::unique_ptr<Parameter>>& params,
+                                                                  const ASTNode* body) {
+    if (!info) {
+        std::vector<std::unique_ptr<Parameter>> param_clones;
+        param_clones.reserve(params.size());
+        for (const auto& param : params) {
+            param_clones.push_back(std::unique_ptr<Parameter>(static_cast<Parameter*>(param->clone().release())));
+        }
+        info = std::make_shared<SharedFunctionInfo>(std::move(param_clones), body->clone());
+        ClosureScopeAnalysis().analyze(info->parameters, info->body.get());
+    }
+    return info;
 }
 
-std::unique_ptr<ASTNode> DoWhileStatement::clone() const {
-    return std::make_unique<DoWhileStatement>(
-        body_->clone(), test_->clone(), start_, end_
-    );
+// Where a closure that names none of the running function's bindings
+// resolves free names: the scope that function was itself created in
+static Environment* scope_outside_activation(Context& ctx) {
+    Environment* activation = ctx.get_variable_environment();
+    if (activation && activation->get_type() == Environment::Type::Function) {
+        return activation->get_outer();
+    }
+    return ctx.get_lexical_environment();
 }
 
-//=============================================================================
-// FunctionDeclaration Implementation
-//=============================================================================
+const std::shared_ptr<SharedFunctionInfo>& FunctionDeclaration::get_shared_info() {
+    return shared_info_for(shared_info_, params_, body_.get());
+}
 
 Value FunctionDeclaration::evaluate(Context& ctx) {
     // Create a function object with the parsed body and parameters
     const std::string& function_name = id_->get_name();
     
-    // Clone parameter objects to transfer ownership
-    std::vector<std::unique_ptr<Parameter>> param_clones;
-    for (const auto& param : params_) {
-        param_clones.push_back(std::unique_ptr<Parameter>(static_cast<Parameter*>(param->clone().release())));
-    }
-    
     // Create Function object - check if generator, async, or regular
     std::unique_ptr<Function> function_obj;
     if (is_generator_) {
         // Convert Parameter objects to parameter names for GeneratorFunction
         std::vector<std::string> param_names;
-        for (const auto& param : param_clones) {
+        for (const auto& param : params_) {
             param_names.push_back(param->get_name()->get_name());
         }
         function_obj = std::make_unique<GeneratorFunction>(function_name, param_names, body_->clone(), &ctx);
     } else if (is_async_) {
         // Convert Parameter objects to parameter names for AsyncFunction
         std::vector<std::string> param_names;
-        for (const auto& param : param_clones) {
+        for (const auto& param : params_) {
             param_names.push_back(param->get_name()->get_name());
         }
         function_obj = std::make_unique<AsyncFunction>(function_name, param_names, body_->clone(), &ctx);
     } else {
-        function_obj = ObjectFactory::create_js_function(
-            function_name, 
-            std::move(param_clones), 
-            body_->clone(),  // Clone the AST body
-            &ctx             // Current context as closure
-        );
+        function_obj = ObjectFactory::create_js_function(function_name, get_shared_info(), &ctx);
     }
     
     
-    // CLOSURE FIX: Capture variables from the current context's binding scope
-    if (function_obj) {
-        // Get all variables currently accessible (including parent scopes)
-        
-        // Check the context's variable environment (where let/var/const are stored)
-        auto var_env = ctx.get_variable_environment();
-        if (var_env) {
-            auto var_binding_names = var_env->get_binding_names();
-            for (const auto& name : var_binding_names) {
-                if (name != "this" && name != "arguments") { // Skip special bindings
-                    Value value = ctx.get_binding(name);
-                    if (!value.is_undefined() && !value.is_function()) { // Skip undefined and global functions
-                        function_obj->set_property("__closure_" + name, value);
-                    }
-                }
-            }
-        }
-        
-        // Also check lexical environment for block-scoped variables
-        auto lex_env = ctx.get_lexical_environment();
-        if (lex_env && lex_env != var_env) {
-            auto lex_binding_names = lex_env->get_binding_names();
-            for (const auto& name : lex_binding_names) {
-                if (name != "this" && name != "arguments") { // Skip special bindings
-                    Value value = ctx.get_binding(name);
-                    if (!value.is_undefined() && !value.is_function()) { // Skip undefined and global functions
-                        function_obj->set_property("__closure_" + name, value);
-                    }
-                }
-            }
-        }
-        
-        // ADDITIONAL CLOSURE FIX: Try to capture variables by name if they exist in the current context
-        // This handles cases where variables are not found in the environment binding lists
-        std::vector<std::string> potential_vars = {"count", "outerVar", "value", "data", "result", "i", "j", "x", "y", "z"};
-        for (const auto& var_name : potential_vars) {
-            if (ctx.has_binding(var_name)) {
-                Value value = ctx.get_binding(var_name);
-                if (!value.is_undefined()) {
-                    // Only capture if not already captured
-                    if (!function_obj->has_property("__closure_" + var_name)) {
-                        function_obj->set_property("__closure_" + var_name, value);
-                    }
-                }
-            }
-        }
+    if (!captures_scope_ && !is_generator_ && !is_async_) {
+        function_obj->set_closure_environment(scope_outside_activation(ctx));
     }
     
     // Wrap in Value - ensure Function type is preserved
@@ -6937,19 +6911,9 @@ Value ClassDeclaration::evaluate(Context& ctx) {
                     // Static methods will be handled after constructor creation
                 } else {
                     // Instance method - create function and add to prototype
-                    std::vector<std::unique_ptr<Parameter>> method_params;
-                    if (method->get_value()->get_type() == Type::FUNCTION_EXPRESSION) {
-                        FunctionExpression* func_expr = static_cast<FunctionExpression*>(method->get_value());
-                        const auto& params = func_expr->get_params();
-                        method_params.reserve(params.size());
-                        for (const auto& param : params) {
-                            method_params.push_back(std::unique_ptr<Parameter>(static_cast<Parameter*>(param->clone().release())));
-                        }
-                    }
                     auto instance_method = ObjectFactory::create_js_function(
                         method_name,
-                        std::move(method_params),
-                        method->get_value()->get_body()->clone(),
+                        method->get_value()->get_shared_info(),
                         &ctx
                     );
                     prototype->set_property(method_name, Value(instance_method.release()));
@@ -7000,19 +6964,9 @@ Value ClassDeclaration::evaluate(Context& ctx) {
                 MethodDefinition* method = static_cast<MethodDefinition*>(stmt.get());
                 if (method->is_static()) {
                     std::string method_name = method->get_key()->get_name();
-                    std::vector<std::unique_ptr<Parameter>> static_params;
-                    if (method->get_value()->get_type() == Type::FUNCTION_EXPRESSION) {
-                        FunctionExpression* func_expr = static_cast<FunctionExpression*>(method->get_value());
-                        const auto& params = func_expr->get_params();
-                        static_params.reserve(params.size());
-                        for (const auto& param : params) {
-                            static_params.push_back(std::unique_ptr<Parameter>(static_cast<Parameter*>(param->clone().release())));
-                        }
-                    }
                     auto static_method = ObjectFactory::create_js_function(
                         method_name,
-                        std::move(static_params),
-                        method->get_value()->get_body()->clone(),
+                        method->get_value()->get_shared_info(),
                         &ctx
                     );
                     constructor_fn->set_property(method_name, Value(static_method.release()));
@@ -7147,77 +7101,17 @@ std::unique_ptr<ASTNode> MethodDefinition::clone() const {
 // FunctionExpression Implementation
 //=============================================================================
 
+const std::shared_ptr<SharedFunctionInfo>& FunctionExpression::get_shared_info() {
+    return shared_info_for(shared_info_, params_, body_.get());
+}
+
 Value FunctionExpression::evaluate(Context& ctx) {
     // Create actual function object for expression
     std::string name = is_named() ? id_->get_name() : "<anonymous>";
     
-    // Clone parameter objects to transfer ownership
-    std::vector<std::unique_ptr<Parameter>> param_clones;
-    for (const auto& param : params_) {
-        param_clones.push_back(std::unique_ptr<Parameter>(static_cast<Parameter*>(param->clone().release())));
-    }
-    
-    // Get parameter names BEFORE moving them to avoid capturing them as closure variables
-    std::set<std::string> param_names;
-    for (const auto& param : param_clones) {
-        param_names.insert(param->get_name()->get_name());
-    }
-    
-    // Create function object with Parameter objects
-    auto function = std::make_unique<Function>(name, std::move(param_clones), body_->clone(), &ctx);
-    
-    // CLOSURE FIX: Capture variables from the current context's binding scope  
-    if (function) {
-        
-        // Check the context's variable environment (where let/var/const are stored)
-        auto var_env = ctx.get_variable_environment();
-        if (var_env) {
-            auto var_binding_names = var_env->get_binding_names();
-            for (const auto& name : var_binding_names) {
-                if (name != "this" && name != "arguments" && param_names.find(name) == param_names.end()) { 
-                    // Skip special bindings AND function parameters
-                    Value value = ctx.get_binding(name);
-                    if (!value.is_undefined()) { // Capture all non-undefined values including objects and functions
-                        function->set_property("__closure_" + name, value);
-                    }
-                }
-            }
-        }
-        
-        // Also check lexical environment for block-scoped variables
-        auto lex_env = ctx.get_lexical_environment();
-        if (lex_env && lex_env != var_env) {
-            auto lex_binding_names = lex_env->get_binding_names();
-            for (const auto& name : lex_binding_names) {
-                if (name != "this" && name != "arguments" && param_names.find(name) == param_names.end()) { 
-                    // Skip special bindings AND function parameters
-                    Value value = ctx.get_binding(name);
-                    if (!value.is_undefined()) { // Capture all non-undefined values including objects and functions  
-                        function->set_property("__closure_" + name, value);
-                    }
-                }
-            }
-        }
-        
-        // ADDITIONAL CLOSURE FIX: Try to capture variables by name if they exist in the current context
-        // This handles cases where variables are not found in the environment binding lists
-        std::vector<std::string> potential_vars = {"count", "outerVar", "value", "data", "result", "i", "j", "x", "y", "z"};
-        for (const auto& var_name : potential_vars) {
-            // Skip if this is a function parameter
-            if (param_names.find(var_name) != param_names.end()) {
-                continue;
-            }
-            
-            if (ctx.has_binding(var_name)) {
-                Value value = ctx.get_binding(var_name);
-                if (!value.is_undefined()) {
-                    // Only capture if not already captured
-                    if (!function->has_property("__closure_" + var_name)) {
-                        function->set_property("__closure_" + var_name, value);
-                    }
-                }
-            }
-        }
+    auto function = std::make_unique<Function>(name, get_shared_info(), &ctx);
+    if (!captures_scope_) {
+        function->set_closure_environment(scope_outside_activation(ctx));
     }
     
     return Value(function.release());
@@ -7263,44 +7157,19 @@ std::unique_ptr<ASTNode> FunctionExpression::clone() const {
 // ArrowFunctionExpression Implementation
 //=============================================================================
 
+const std::shared_ptr<SharedFunctionInfo>& ArrowFunctionExpression::get_shared_info() {
+    return shared_info_for(shared_info_, params_, body_.get());
+}
+
 Value ArrowFunctionExpression::evaluate(Context& ctx) {
     // Arrow functions capture 'this' lexically and create a function value
     std::string name = "<arrow>";
     
-    // Clone parameter objects to transfer ownership
-    std::vector<std::unique_ptr<Parameter>> param_clones;
-    for (const auto& param : params_) {
-        param_clones.push_back(std::unique_ptr<Parameter>(static_cast<Parameter*>(param->clone().release())));
-    }
-    
     // Create a proper Function object that can be called
-    auto arrow_function = ObjectFactory::create_js_function(
-        name, 
-        std::move(param_clones), 
-        body_->clone(),  // Clone the body AST
-        &ctx  // Current context as closure
-    );
-    
-    // CLOSURE FIX: Capture free variables from current context
-    // But exclude parameter names to avoid shadowing function parameters
-    std::vector<std::string> common_vars = {"x", "y", "z", "i", "j", "k", "a", "b", "c", "value", "result", "data"};
+    auto arrow_function = ObjectFactory::create_js_function(name, get_shared_info(), &ctx);
     
-    // Create set of parameter names to exclude from closure capture
-    std::set<std::string> param_names;
-    for (const auto& param : params_) {
-        param_names.insert(param->get_name()->get_name());
-    }
-    
-    for (const std::string& var_name : common_vars) {
-        // Skip capturing variables that are function parameters
-        if (param_names.find(var_name) != param_names.end()) {
-            continue;
-        }
-        
-        if (ctx.has_binding(var_name)) {
-            Value var_value = ctx.get_binding(var_name);
-            arrow_function->set_property("__closure_" + var_name, var_value);
-        }
+    if (!captures_scope_) {
+        arrow_function->set_closure_environment(scope_outside_activation(ctx));
     }
     
     return Value(arrow_function.release());
@@ -7349,8 +7218,8 @@ std::unique_ptr<ASTNode> ArrowFunctionExpression::clone() const {
 //=============================================================================
 
 Value AwaitExpression::evaluate(Context& ctx) {
-    // Simplified await implementation - just return the awaited value
-    // This provides basic await functionality without complex async machinery
+    // Await suspends the async function whose body is running in ctx; the
+    // awaited promise's reaction job resumes it (see AsyncActivation)
     
     if (!argument_) {
         return Value();
@@ -7362,29 +7231,38 @@ Value AwaitExpression::evaluate(Context& ctx) {
         return Value();
     }
     
-    // For non-objects (primitives), just return them directly
-    if (!arg_value.is_object()) {
-        return arg_value;
+    AsyncActivation* activation = AsyncActivation::current();
+    if (activation && activation->get_context() == &ctx) {
+        // A promise is awaited itself; anything else, thenables included,
+        // through a fresh promise resolved with it
+        return activation->await(Promise::resolve_static(arg_value, &ctx));
     }
     
-    // For objects, check if it's a Promise
-    Object* obj = arg_value.as_object();
-    if (!obj) {
+    // Top-level await: there is no function to suspend, so the script waits
+    // for the promise, running the event loop as it would after the script
+    bool is_promise = arg_value.is_object() && arg_value.as_object()->get_type() == Object::ObjectType::Promise;
+    if (!is_promise && !AsyncUtils::is_thenable(arg_value)) {
         return arg_value;
     }
+    Promise* promise = Promise::resolve_static(arg_value, &ctx);
     
-    // Simple Promise handling - return resolved value or the object itself
-    if (obj->get_type() == Object::ObjectType::Promise) {
-        Promise* promise = static_cast<Promise*>(obj);
-        if (promise && promise->get_state() == PromiseState::FULFILLED) {
-            return promise->get_value();
+    EventLoop& event_loop = EventLoop::instance();
+    while (promise->get_state() == PromiseState::PENDING && event_loop.has_pending_tasks()) {
+        event_loop.process_microtasks();
+        if (promise->get_state() == PromiseState::PENDING) {
+            event_loop.process_macrotasks();
         }
-        // For pending or rejected promises, return a simple value for now
-        return Value("PromiseResult");
     }
     
-    // For all other objects, just return them
-    return arg_value;
+    if (promise->get_state() == PromiseState::FULFILLED) {
+        return promise->get_value();
+    }
+    if (promise->get_state() == PromiseState::REJECTED) {
+        ctx.throw_exception(promise->get_value());
+        return Value();
+    }
+    ctx.throw_error("await: the promise can never settle");
+    return Value();
 }
 
 std::string AwaitExpression::to_string() const {
@@ -7582,6 +7460,8 @@ std::unique_ptr<ASTNode> ContinueStatement::clone() const {
 //=============================================================================
 
 Value ObjectLiteral::evaluate(Context& ctx) {
+    if (async_stack_exhausted(ctx)) return Value();
+    
     // Use the working ObjectFactory::create_object method
     auto object = ObjectFactory::create_object();
     if (!object) {
@@ -7624,6 +7504,12 @@ Value ObjectLiteral::evaluate(Context& ctx) {
                     Value prop_value = spread_obj->get_property(prop_name);
                     object->set_property(prop_name, prop_value);
                 }
+                // Enumerable symbol-keyed properties are copied too
+                for (const auto& symbol_key : spread_obj->get_own_symbol_keys()) {
+                    if (spread_obj->get_property_descriptor(symbol_key).is_enumerable()) {
+                        object->set_property(symbol_key, spread_obj->get_property(symbol_key));
+                    }
+                }
             } catch (const std::exception& e) {
                 ctx.throw_exception(Value("Error processing spread properties: " + std::string(e.what())));
                 return Value();
@@ -7643,7 +7529,7 @@ Value ObjectLiteral::evaluate(Context& ctx) {
             // For computed properties [expr]: value, evaluate the expression
             Value key_value = prop->key->evaluate(ctx);
             if (ctx.has_exception()) return Value();
-            key = key_value.to_string();
+            key = key_value.to_property_key();
         } else {
             // For regular properties, the key can be an identifier, string, or number
             if (prop->key->get_type() == ASTNode::Type::IDENTIFIER) {
@@ -7740,10 +7626,12 @@ std::unique_ptr<ASTNode> ObjectLiteral::clone() const {
 //=============================================================================
 
 Value ArrayLiteral::evaluate(Context& ctx) {
+    if (async_stack_exhausted(ctx)) return Value();
+    
     // Array evaluation
     
-    // Simplified approach: create array directly without complex ObjectFactory
-    auto array = std::make_unique<Object>(Object::ObjectType::Array);
+    // Methods come from Array.prototype, which create_array() links
+    auto array = ObjectFactory::create_array();
     if (!array) {
         return Value("[]");  // Return string representation as fallback
     }
@@ -7785,391 +7673,6 @@ Value ArrayLiteral::evaluate(Context& ctx) {
     
     // Update the array length
     array->set_length(array_index);
-    
-    // Add push function implementation
-    auto push_fn = ObjectFactory::create_native_function("push", 
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-            Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("TypeError: Array.prototype.push called on non-object"));
-                return Value();
-            }
-            
-            uint32_t initial_length = this_obj->get_length();
-            
-            // Push all arguments to the array
-            for (const auto& arg : args) {
-                this_obj->push(arg);
-            }
-            
-            uint32_t final_length = this_obj->get_length();
-            
-            // Return new length
-            return Value(static_cast<double>(final_length));
-        });
-    array->set_property("push", Value(push_fn.release()));
-    
-    // Add pop function
-    auto pop_fn = ObjectFactory::create_native_function("pop", 
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-            (void)args; // Suppress unused parameter warning
-            Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("TypeError: Array.prototype.pop called on non-object"));
-                return Value();
-            }
-            
-            return this_obj->pop();
-        });
-    array->set_property("pop", Value(pop_fn.release()));
-    
-    // Add shift function
-    auto shift_fn = ObjectFactory::create_native_function("shift", 
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-            (void)args; // Suppress unused parameter warning
-            Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("TypeError: Array.prototype.shift called on non-object"));
-                return Value();
-            }
-            
-            return this_obj->shift();
-        });
-    array->set_property("shift", Value(shift_fn.release()));
-    
-    // Add unshift function
-    auto unshift_fn = ObjectFactory::create_native_function("unshift", 
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-            Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("TypeError: Array.prototype.unshift called on non-object"));
-                return Value();
-            }
-            
-            // Unshift all arguments to the array (in reverse order to maintain order)
-            for (int i = args.size() - 1; i >= 0; i--) {
-                this_obj->unshift(args[i]);
-            }
-            
-            // Return new length
-            return Value(static_cast<double>(this_obj->get_length()));
-        });
-    array->set_property("unshift", Value(unshift_fn.release()));
-    
-    // Add join function
-    auto join_fn = ObjectFactory::create_native_function("join", 
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-            Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("TypeError: Array.prototype.join called on non-object"));
-                return Value();
-            }
-            
-            // Get separator (default is comma)
-            std::string separator = ",";
-            if (!args.empty()) {
-                separator = args[0].to_string();
-            }
-            
-            // Join array elements
-            std::string result;
-            uint32_t length = this_obj->get_length();
-            for (uint32_t i = 0; i < length; i++) {
-                if (i > 0) result += separator;
-                Value element = this_obj->get_element(i);
-                if (!element.is_undefined() && !element.is_null()) {
-                    result += element.to_string();
-                }
-            }
-            
-            return Value(result);
-        });
-    array->set_property("join", Value(join_fn.release()));
-    
-    // Add indexOf function
-    auto indexOf_fn = ObjectFactory::create_native_function("indexOf", 
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-            Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("TypeError: Array.prototype.indexOf called on non-object"));
-                return Value();
-            }
-            
-            if (args.empty()) {
-                return Value(-1.0); // Not found
-            }
-            
-            Value search_element = args[0];
-            uint32_t start_index = 0;
-            
-            // Optional start index
-            if (args.size() > 1) {
-                double start = args[1].to_number();
-                if (start >= 0) {
-                    start_index = static_cast<uint32_t>(start);
-                }
-            }
-            
-            // Search for element
-            uint32_t length = this_obj->get_length();
-            for (uint32_t i = start_index; i < length; i++) {
-                Value element = this_obj->get_element(i);
-                if (element.strict_equals(search_element)) {
-                    return Value(static_cast<double>(i));
-                }
-            }
-            
-            return Value(-1.0); // Not found
-        });
-    array->set_property("indexOf", Value(indexOf_fn.release()));
-    
-    // Add slice and splice as placeholders for now (more complex implementations)
-    array->set_property("slice", ValueFactory::function_placeholder("slice"));
-    array->set_property("splice", ValueFactory::function_placeholder("splice"));
-    
-    // Add the new array methods as real functions
-    // Create map function
-    auto map_fn = ObjectFactory::create_native_function("map", 
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-            Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("TypeError: Array.prototype.map called on non-object"));
-                return Value();
-            }
-            if (args.empty()) {
-                ctx.throw_exception(Value("TypeError: callback is not a function"));
-                return Value();
-            }
-            
-            // Try to get the function - for now skip the type check since is_function() is broken
-            Function* callback = nullptr;
-            if (args[0].is_function()) {
-                callback = args[0].as_function();
-            } else {
-                // Try casting from object in case the Value was stored as Object
-                Object* obj = args[0].as_object();
-                if (obj && obj->get_type() == Object::ObjectType::Function) {
-                    callback = static_cast<Function*>(obj);
-                } else {
-                    ctx.throw_exception(Value("TypeError: callback is not a function"));
-                    return Value();
-                }
-            }
-            auto result = this_obj->map(callback, ctx);
-            return result ? Value(result.release()) : Value();
-        });
-    array->set_property("map", Value(map_fn.release()));
-    
-    // Create filter function
-    auto filter_fn = ObjectFactory::create_native_function("filter", 
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-            Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("TypeError: Array.prototype.filter called on non-object"));
-                return Value();
-            }
-            if (args.empty()) {
-                ctx.throw_exception(Value("TypeError: callback is not a function"));
-                return Value();
-            }
-            
-            // Try to get the function - for now skip the type check since is_function() is broken
-            Function* callback = nullptr;
-            if (args[0].is_function()) {
-                callback = args[0].as_function();
-            } else {
-                // Try casting from object in case the Value was stored as Object
-                Object* obj = args[0].as_object();
-                if (obj && obj->get_type() == Object::ObjectType::Function) {
-                    callback = static_cast<Function*>(obj);
-                } else {
-                    ctx.throw_exception(Value("TypeError: callback is not a function"));
-                    return Value();
-                }
-            }
-            auto result = this_obj->filter(callback, ctx);
-            return result ? Value(result.release()) : Value();
-        });
-    array->set_property("filter", Value(filter_fn.release()));
-    
-    // Create reduce function
-    auto reduce_fn = ObjectFactory::create_native_function("reduce", 
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-            Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("TypeError: Array.prototype.reduce called on non-object"));
-                return Value();
-            }
-            if (args.empty()) {
-                ctx.throw_exception(Value("TypeError: callback is not a function"));
-                return Value();
-            }
-            
-            // Try to get the function - for now skip the type check since is_function() is broken
-            Function* callback = nullptr;
-            if (args[0].is_function()) {
-                callback = args[0].as_function();
-            } else {
-                // Try casting from object in case the Value was stored as Object
-                Object* obj = args[0].as_object();
-                if (obj && obj->get_type() == Object::ObjectType::Function) {
-                    callback = static_cast<Function*>(obj);
-                } else {
-                    ctx.throw_exception(Value("TypeError: callback is not a function"));
-                    return Value();
-                }
-            }
-            Value initial_value = args.size() > 1 ? args[1] : Value();
-            return this_obj->reduce(callback, initial_value, ctx);
-        });
-    array->set_property("reduce", Value(reduce_fn.release()));
-    
-    // Create forEach function
-    auto forEach_fn = ObjectFactory::create_native_function("forEach", 
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-            Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("TypeError: Array.prototype.forEach called on non-object"));
-                return Value();
-            }
-            if (args.empty()) {
-                ctx.throw_exception(Value("TypeError: callback is not a function"));
-                return Value();
-            }
-            
-            // Try to get the function - for now skip the type check since is_function() is broken
-            Function* callback = nullptr;
-            if (args[0].is_function()) {
-                callback = args[0].as_function();
-            } else {
-                // Try casting from object in case the Value was stored as Object
-                Object* obj = args[0].as_object();
-                if (obj && obj->get_type() == Object::ObjectType::Function) {
-                    callback = static_cast<Function*>(obj);
-                } else {
-                    ctx.throw_exception(Value("TypeError: callback is not a function"));
-                    return Value();
-                }
-            }
-            this_obj->forEach(callback, ctx);
-            return Value(); // undefined
-        });
-    array->set_property("forEach", Value(forEach_fn.release()));
-    
-    // Create includes function
-    auto includes_fn = ObjectFactory::create_native_function("includes", 
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-            Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("TypeError: Array.prototype.includes called on non-object"));
-                return Value();
-            }
-            if (args.empty()) {
-                return Value(false);
-            }
-            
-            Value search_element = args[0];
-            uint32_t length = this_obj->get_length();
-            
-            for (uint32_t i = 0; i < length; i++) {
-                Value element = this_obj->get_element(i);
-                if (element.strict_equals(search_element)) {
-                    return Value(true);
-                }
-            }
-            return Value(false);
-        });
-    array->set_property("includes", Value(includes_fn.release()));
-    
-    // Create reverse function
-    auto reverse_fn = ObjectFactory::create_native_function("reverse", 
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-                    (void)ctx; // Suppress unused warning
-            (void)args; // unused
-            Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("TypeError: Array.prototype.reverse called on non-object"));
-                return Value();
-            }
-            
-            uint32_t length = this_obj->get_length();
-            for (uint32_t i = 0; i < length / 2; i++) {
-                Value temp = this_obj->get_element(i);
-                this_obj->set_element(i, this_obj->get_element(length - 1 - i));
-                this_obj->set_element(length - 1 - i, temp);
-            }
-            return Value(this_obj); // return the same array
-        });
-    array->set_property("reverse", Value(reverse_fn.release()));
-    
-    // Create sort function
-    auto sort_fn = ObjectFactory::create_native_function("sort",
-        [](Context& ctx, const std::vector<Value>& args) -> Value {
-            Object* this_obj = ctx.get_this_binding();
-            if (!this_obj) {
-                ctx.throw_exception(Value("TypeError: Array.prototype.sort called on non-object"));
-                return Value();
-            }
-
-            uint32_t length = this_obj->get_length();
-            if (length <= 1) return Value(this_obj);
-
-            // Check for compare function
-            Function* compareFn = nullptr;
-            if (args.size() > 0) {
-                std::cout << "DEBUG ARRAYLIT SORT: Has " << args.size() << " arguments" << std::endl;
-                Value compare_val = args[0];
-                std::cout << "DEBUG ARRAYLIT SORT: compare_val.is_function(): " << compare_val.is_function() << std::endl;
-                if (compare_val.is_function()) {
-                    compareFn = compare_val.as_function();
-                    std::cout << "DEBUG ARRAYLIT SORT: compareFn set successfully" << std::endl;
-                } else {
-                    std::cout << "DEBUG ARRAYLIT SORT: compare_val is not a function" << std::endl;
-                }
-            } else {
-                std::cout << "DEBUG ARRAYLIT SORT: No arguments provided" << std::endl;
-            }
-
-            // Simple bubble sort
-            for (uint32_t i = 0; i < length - 1; i++) {
-                for (uint32_t j = 0; j < length - 1 - i; j++) {
-                    Value a = this_obj->get_element(j);
-                    Value b = this_obj->get_element(j + 1);
-
-                    bool should_swap = false;
-                    if (compareFn) {
-                        std::vector<Value> comp_args = {a, b};
-                        Value result = compareFn->call(ctx, comp_args);
-                        if (ctx.has_exception()) return Value();
-                        should_swap = result.to_number() > 0;
-                    } else {
-                        // Default string comparison
-                        should_swap = a.to_string() > b.to_string();
-                    }
-
-                    if (should_swap) {
-                        this_obj->set_element(j, b);
-                        this_obj->set_element(j + 1, a);
-                    }
-                }
-            }
-            return Value(this_obj); // return the same array
-        });
-    array->set_property("sort", Value(sort_fn.release()));
-    
-    // Set the array length and return
-    array->set_length(array_index);
     return Value(array.release());
 }
 
@@ -8200,8 +7703,13 @@ std::unique_ptr<ASTNode> ArrayLiteral::clone() const {
 // Stage 9: Error Handling & Advanced Control Flow Implementation
 //=============================================================================
 
+int& TryStatement::nesting_depth() {
+    static thread_local int depth = 0;
+    return depth;
+}
+
 Value TryStatement::evaluate(Context& ctx) {
-    static int try_recursion_depth = 0;
+    int& try_recursion_depth = nesting_depth();
     if (try_recursion_depth > 10) {
         return Value("Max try-catch recursion exceeded");
     }
@@ -8842,29 +8350,39 @@ Value RegexLiteral::evaluate(Context& ctx) {
         obj->set_property("sticky", Value(flags_.find('y') != std::string::npos));
         obj->set_property("lastIndex", Value(0.0));
         
+        // Compile once per literal; a pattern that does not compile is left
+        // to fail in the methods, as before
+        if (!compiled_) {
+            try {
+                compiled_ = std::make_shared<const RegExp>(pattern_, flags_);
+            } catch (const std::exception&) {
+            }
+        }
+        
         // Add RegExp methods
         std::string pattern_copy = pattern_;
         std::string flags_copy = flags_;
+        std::shared_ptr<const RegExp> compiled = compiled_;
         
         auto test_fn = ObjectFactory::create_native_function("test",
-            [pattern_copy, flags_copy](Context& ctx, const std::vector<Value>& args) -> Value {
+            [pattern_copy, flags_copy, compiled](Context& ctx, const std::vector<Value>& args) -> Value {
                     (void)ctx; // Suppress unused warning
                 (void)ctx;
                 if (args.empty()) return Value(false);
                 
                 std::string str = args[0].to_string();
-                RegExp regex(pattern_copy, flags_copy);
+                RegExp regex = compiled ? *compiled : RegExp(pattern_copy, flags_copy);
                 return Value(regex.test(str));
             });
         
         auto exec_fn = ObjectFactory::create_native_function("exec",
-            [pattern_copy, flags_copy](Context& ctx, const std::vector<Value>& args) -> Value {
+            [pattern_copy, flags_copy, compiled](Context& ctx, const std::vector<Value>& args) -> Value {
                     (void)ctx; // Suppress unused warning
                 (void)ctx;
                 if (args.empty()) return Value::null();
                 
                 std::string str = args[0].to_string();
-                RegExp regex(pattern_copy, flags_copy);
+                RegExp regex = compiled ? *compiled : RegExp(pattern_copy, flags_copy);
                 return regex.exec(str);
             });
         
@@ -9027,7 +8545,7 @@ Value OptionalChainingExpression::evaluate(Context& ctx) {
         Value property_value = property_->evaluate(ctx);
         if (ctx.has_exception()) return Value();
         
-        std::string prop_name = property_value.to_string();
+        std::string prop_name = property_value.to_property_key();
         
         if (object_value.is_object()) {
             Object* obj = object_value.as_object();
@@ -51,6 +51,11 @@ Parser::Parser(TokenSequence tokens, const ParseOptions& options)
 }
 
 std::unique_ptr<Program> Parser::parse_program() {
+    // The script's nodes live in one arena, which outlives them; the Program
+    // itself is built on the heap, since it owns the arena
+    auto arena = std::make_shared<ASTArena>();
+    ASTArena::Scope arena_scope(arena.get());
+    
     std::vector<std::unique_ptr<ASTNode>> statements;
     Position start = get_current_position();
     
@@ -73,7 +78,8 @@ std::unique_ptr<Program> Parser::parse_program() {
     }
     
     Position end = get_current_position();
-    return std::make_unique<Program>(std::move(statements), start, end);
+    ASTArena::Scope heap_scope(nullptr);
+    return std::make_unique<Program>(std::move(arena), std::move(statements), start, end);
 }
 
 std::unique_ptr<ASTNode> Parser::parse_statement() {
@@ -369,7 +375,7 @@ std::unique_ptr<ASTNode> Parser::parse_exponentiation_expression() {
         BinaryExpression::Operator op = BinaryExpression::Operator::EXPONENT;
         Position end = right->get_end();
         
-        return std::make_unique<BinaryExpression>(
+        return BinaryExpression::create(
             std::move(left), op, std::move(right), op_start, end
         );
     }
@@ -445,7 +451,7 @@ std::unique_ptr<ASTNode> Parser::parse_unary_expression() {
         UnaryExpression::Operator op = token_to_unary_operator(op_token);
         Position end = operand->get_end();
         
-        return std::make_unique<UnaryExpression>(op, std::move(operand), true, start, end);
+        return UnaryExpression::create(op, std::move(operand), true, start, end);
     }
     
     return parse_postfix_expression();
@@ -828,7 +834,7 @@ std::unique_ptr<ASTNode> Parser::parse_template_literal() {
         pos = expr_end + 1;
     }
     
-    return std::make_unique<TemplateLiteral>(std::move(elements), start, end);
+    return TemplateLiteral::create(std::move(elements), start, end);
 }
 
 std::unique_ptr<ASTNode> Parser::parse_regex_literal() {
@@ -958,7 +964,7 @@ std::unique_ptr<ASTNode> Parser::parse_binary_expression(
         BinaryExpression::Operator op = token_to_binary_operator(op_token);
         Position end = right->get_end();
         
-        left = std::make_unique<BinaryExpression>(
+        left = BinaryExpression::create(
             std::move(left), op, std::move(right), op_start, end
         );
     }